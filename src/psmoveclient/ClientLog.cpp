@@ -2,7 +2,7 @@
 #include "ClientLog.h"
 
 //-- globals -----
-e_log_severity_level g_min_log_level;
+static e_log_severity_level g_min_log_level;
 
 // Connect the normal logger to standard output
 std::ostream g_normal_logger(std::cout.rdbuf());
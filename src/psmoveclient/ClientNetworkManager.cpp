@@ -2,6 +2,7 @@
 #include "ClientNetworkManager.h"
 #include "ClientLog.h"
 #include "PackedMessage.h"
+#include "ProtocolMessagePool.h"
 #include "PSMoveProtocol.pb.h"
 #include <cassert>
 #include <iostream>
@@ -14,6 +15,10 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/cstdint.hpp>
 
+#ifdef PSM_EMBEDDED_SERVICE
+#include "EmbeddedService.h"
+#endif
+
 //-- pre-declarations -----
 using namespace std;
 namespace asio = boost::asio;
@@ -21,6 +26,12 @@ using asio::ip::tcp;
 using asio::ip::udp;
 using boost::uint8_t;
 
+//-- constants -----
+// Initial sizes of the outgoing message pool and buffers.
+// These only grow (and allocate) if the service falls behind.
+const size_t k_initial_pooled_data_frame_count = 8;
+const size_t k_initial_tcp_buffer_size = 1024;
+
 //-- implementation -----
 
 // -ClientNetworkManagerImpl-
@@ -44,6 +55,7 @@ public:
         , m_udp_socket(m_io_service, udp::endpoint(udp::v4(), 0))
         , m_udp_server_endpoint()
         , m_udp_remote_endpoint()
+        , m_allocation_count(0)
         , m_connection_stopped(false)
         , m_has_pending_tcp_read(false)
         , m_has_pending_tcp_write(false)
@@ -63,8 +75,13 @@ public:
         , m_response_listener(responseListener)
         , m_netEventListener(netEventListener)
         , m_pending_requests()
+        , m_data_frame_pool(k_initial_pooled_data_frame_count, m_allocation_count)
+        , m_pending_data_frames(k_initial_pooled_data_frame_count, m_allocation_count)
     {
         memset(m_output_data_frame_buffer, 0, sizeof(m_output_data_frame_buffer));
+        m_response_read_buffer.reserve(k_initial_tcp_buffer_size);
+        m_write_bufer.reserve(k_initial_tcp_buffer_size);
+        m_allocation_count+= 2;
     }
 
     bool start()
@@ -84,6 +101,16 @@ public:
         start_tcp_write_request();
     }
 
+    DeviceInputDataFramePtr allocate_device_data_frame()
+    {
+        return m_data_frame_pool.allocate();
+    }
+
+    int get_allocation_count() const
+    {
+        return m_allocation_count;
+    }
+
     void send_device_data_frame(DeviceInputDataFramePtr data_frame)
     {
         // Stamp the packet with the connection ID before it goes out
@@ -277,7 +304,7 @@ private:
             << "Sending connection id to server over UDP: " << m_tcp_connection_id << std::endl;
 
         // Package the connection ID in a device input data frame with an invalid device
-        DeviceInputDataFramePtr data_frame(new PSMoveProtocol::DeviceInputDataFrame);
+        DeviceInputDataFramePtr data_frame= allocate_device_data_frame();
         data_frame->set_connection_id(m_tcp_connection_id);
         data_frame->set_device_category(PSMoveProtocol::DeviceInputDataFrame_DeviceCategory_INVALID);
 
@@ -370,12 +397,23 @@ private:
         }
     }
 
+    // Resize the buffer, counting it as an allocation if the buffer had to grow
+    void resize_tcp_buffer(vector<uint8_t> &buffer, size_t size)
+    {
+        if (size > buffer.capacity())
+        {
+            ++m_allocation_count;
+        }
+
+        buffer.resize(size);
+    }
+
     void start_tcp_read_response_header()
     {
         if (!m_has_pending_tcp_read)
         {
             m_has_pending_tcp_read= true;
-            m_response_read_buffer.resize(HEADER_SIZE);
+            resize_tcp_buffer(m_response_read_buffer, HEADER_SIZE);
             asio::async_read(
                 m_tcp_socket, 
                 asio::buffer(m_response_read_buffer),
@@ -429,7 +467,7 @@ private:
 
         // m_read_buffer already contains the header in its first HEADER_SIZE bytes. 
         // Expand it to fit in the body as well, and start async read into the body.
-        m_response_read_buffer.resize(HEADER_SIZE + msg_len);
+        resize_tcp_buffer(m_response_read_buffer, HEADER_SIZE + msg_len);
         asio::mutable_buffers_1 buffer = asio::buffer(&m_response_read_buffer[HEADER_SIZE], msg_len);
         asio::async_read(
             m_tcp_socket, 
@@ -529,7 +567,12 @@ private:
             RequestPtr request= m_pending_requests[0];
 
             m_packed_request.set_msg(request);
+            const size_t old_capacity= m_write_bufer.capacity();
             m_packed_request.pack(m_write_bufer);
+            if (m_write_bufer.capacity() != old_capacity)
+            {
+                ++m_allocation_count;
+            }
 
             // The queue should prevent us from writing more than one request as once
             m_has_pending_tcp_write= true;
@@ -728,6 +771,9 @@ private:
     udp::endpoint m_udp_remote_endpoint;
     bool m_udp_connection_result_read_buffer;
 
+    // Heap allocations made by the message pool and buffers
+    int m_allocation_count;
+
     bool m_connection_stopped;
     bool m_has_pending_tcp_read;
     bool m_has_pending_tcp_write;
@@ -752,7 +798,142 @@ private:
     IClientNetworkEventListener *m_netEventListener;
 
     deque<RequestPtr> m_pending_requests;
-    deque<DeviceInputDataFramePtr> m_pending_data_frames;
+    ProtocolMessagePool<PSMoveProtocol::DeviceInputDataFrame> m_data_frame_pool;
+    ProtocolMessageQueue<DeviceInputDataFramePtr> m_pending_data_frames;
+};
+
+// -ClientEmbeddedConnection-
+// Connection to a service running in this process.
+// The service is ticked from poll(), so it runs on the thread calling PSM_Update().
+class ClientEmbeddedConnection
+{
+public:
+    ClientEmbeddedConnection(
+        IDataFrameListener *dataFrameListener,
+        INotificationListener *notificationListener,
+        IResponseListener *responseListener,
+        IClientNetworkEventListener *netEventListener)
+        : m_data_frame_listener(dataFrameListener)
+        , m_notification_listener(notificationListener)
+        , m_response_listener(responseListener)
+        , m_netEventListener(netEventListener)
+        , m_connection_started(false)
+    {
+    }
+
+    bool start()
+    {
+#ifdef PSM_EMBEDDED_SERVICE
+        CLIENT_LOG_INFO("ClientNetworkManager::start") << "Starting the embedded service..." << std::endl;
+
+        m_connection_started= 
+            m_service.startup(m_data_frame_listener, m_notification_listener, m_response_listener);
+
+        if (m_netEventListener)
+        {
+            if (m_connection_started)
+            {
+                m_netEventListener->handle_server_connection_opened();
+            }
+            else
+            {
+                m_netEventListener->handle_server_connection_open_failed(boost::asio::error::connection_refused);
+            }
+        }
+
+        return m_connection_started;
+#else
+        CLIENT_LOG_ERROR("ClientNetworkManager::start") 
+            << "This client was built without the embedded service (PSM_EMBEDDED_SERVICE)" << std::endl;
+
+        return false;
+#endif
+    }
+
+    void send_request(RequestPtr request)
+    {
+#ifdef PSM_EMBEDDED_SERVICE
+        if (m_connection_started)
+        {
+            m_service.send_request(request);
+        }
+        else
+        {
+            m_response_listener->handle_request_canceled(request);
+        }
+#else
+        m_response_listener->handle_request_canceled(request);
+#endif
+    }
+
+    DeviceInputDataFramePtr allocate_device_data_frame()
+    {
+#ifdef PSM_EMBEDDED_SERVICE
+        if (m_connection_started)
+        {
+            return m_service.allocate_device_data_frame();
+        }
+#endif
+        return DeviceInputDataFramePtr(new PSMoveProtocol::DeviceInputDataFrame);
+    }
+
+    int get_allocation_count() const
+    {
+#ifdef PSM_EMBEDDED_SERVICE
+        return m_service.get_allocation_count();
+#else
+        return 0;
+#endif
+    }
+
+    void send_device_data_frame(DeviceInputDataFramePtr data_frame)
+    {
+#ifdef PSM_EMBEDDED_SERVICE
+        if (m_connection_started)
+        {
+            m_service.send_device_data_frame(data_frame);
+        }
+#endif
+    }
+
+    void poll()
+    {
+#ifdef PSM_EMBEDDED_SERVICE
+        if (m_connection_started)
+        {
+            // Runs one service tick, which calls back into the listeners
+            m_service.update();
+        }
+#endif
+    }
+
+    void stop()
+    {
+#ifdef PSM_EMBEDDED_SERVICE
+        if (m_connection_started)
+        {
+            // Cancels any requests the service hasn't handled yet
+            m_service.shutdown();
+            m_connection_started= false;
+
+            if (m_netEventListener)
+            {
+                m_netEventListener->handle_server_connection_closed();
+            }
+        }
+#endif
+    }
+
+private:
+    IDataFrameListener *m_data_frame_listener;
+    INotificationListener *m_notification_listener;
+    IResponseListener *m_response_listener;
+    IClientNetworkEventListener *m_netEventListener;
+
+#ifdef PSM_EMBEDDED_SERVICE
+    EmbeddedService m_service;
+#endif
+    bool m_connection_started;
 };
 
 // -ClientNetworkManager-
@@ -766,47 +947,106 @@ ClientNetworkManager::ClientNetworkManager(
     INotificationListener *notificationListener,
     IResponseListener *responseListener,
     IClientNetworkEventListener *netEventListener)
-    : m_implementation_ptr(
-        new ClientNetworkManagerImpl(
-            host, 
-            port, 
-            dataFrameListener,
-            notificationListener,
-            responseListener,
-            netEventListener))
+    : m_implementation_ptr(nullptr)
+    , m_embedded_connection_ptr(nullptr)
 {
+    if (host == PSMOVESERVICE_EMBEDDED_ADDRESS)
+    {
+        m_embedded_connection_ptr=
+            new ClientEmbeddedConnection(
+                dataFrameListener,
+                notificationListener,
+                responseListener,
+                netEventListener);
+    }
+    else
+    {
+        m_implementation_ptr=
+            new ClientNetworkManagerImpl(
+                host, 
+                port, 
+                dataFrameListener,
+                notificationListener,
+                responseListener,
+                netEventListener);
+    }
 }
 
 ClientNetworkManager::~ClientNetworkManager()
 {
     assert(m_instance == NULL);
     delete m_implementation_ptr;
+    delete m_embedded_connection_ptr;
 }
 
 bool ClientNetworkManager::startup()
 {
     m_instance= this;
 
-    return m_implementation_ptr->start();
+    return (m_embedded_connection_ptr != nullptr)
+        ? m_embedded_connection_ptr->start()
+        : m_implementation_ptr->start();
 }
 
 void ClientNetworkManager::send_request(RequestPtr request)
 {
-    m_implementation_ptr->send_request(request);
+    if (m_embedded_connection_ptr != nullptr)
+    {
+        m_embedded_connection_ptr->send_request(request);
+    }
+    else
+    {
+        m_implementation_ptr->send_request(request);
+    }
+}
+
+DeviceInputDataFramePtr ClientNetworkManager::allocate_device_data_frame()
+{
+    return (m_embedded_connection_ptr != nullptr)
+        ? m_embedded_connection_ptr->allocate_device_data_frame()
+        : m_implementation_ptr->allocate_device_data_frame();
+}
+
+int ClientNetworkManager::get_allocation_count() const
+{
+    return (m_embedded_connection_ptr != nullptr)
+        ? m_embedded_connection_ptr->get_allocation_count()
+        : m_implementation_ptr->get_allocation_count();
 }
 
 void ClientNetworkManager::send_device_data_frame(DeviceInputDataFramePtr data_frame)
 {
-    m_implementation_ptr->send_device_data_frame(data_frame);
+    if (m_embedded_connection_ptr != nullptr)
+    {
+        m_embedded_connection_ptr->send_device_data_frame(data_frame);
+    }
+    else
+    {
+        m_implementation_ptr->send_device_data_frame(data_frame);
+    }
 }
 
 void ClientNetworkManager::update()
 {
-    m_implementation_ptr->poll();
+    if (m_embedded_connection_ptr != nullptr)
+    {
+        m_embedded_connection_ptr->poll();
+    }
+    else
+    {
+        m_implementation_ptr->poll();
+    }
 }
 
 void ClientNetworkManager::shutdown()
 {
-    m_implementation_ptr->stop();
+    if (m_embedded_connection_ptr != nullptr)
+    {
+        m_embedded_connection_ptr->stop();
+    }
+    else
+    {
+        m_implementation_ptr->stop();
+    }
     m_instance = NULL;
 }
@@ -10,6 +10,8 @@
 // -Server Network Manager-
 // Maintains TCP/UDP connection state with PSMoveService.
 // Routes requests to the given request handler.
+// When the host is PSMOVESERVICE_EMBEDDED_ADDRESS the service runs in this process instead
+// and is ticked by update().
 class PSM_CPP_PRIVATE_CLASS ClientNetworkManager 
 {
 public:
@@ -29,6 +31,13 @@ public:
     void update();
     void shutdown();
 
+    // Get a cleared data frame from the outgoing data frame pool
+    DeviceInputDataFramePtr allocate_device_data_frame();
+
+    // Number of heap allocations made for network messages and buffers so far.
+    // This stops increasing once streaming reaches a steady state.
+    int get_allocation_count() const;
+
 private:
     // Must use the overloaded constructor
     ClientNetworkManager();
@@ -36,6 +45,9 @@ private:
     // private implementation - same lifetime as the ClientNetworkManager
     class ClientNetworkManagerImpl *m_implementation_ptr;
 
+    // in-process service connection, used instead of m_implementation_ptr for the embedded address
+    class ClientEmbeddedConnection *m_embedded_connection_ptr;
+
     // Singleton instance of the class
     // Assigned in startup, cleared in teardown
     static ClientNetworkManager *m_instance;
@@ -3,18 +3,19 @@
 #include "ClientNetworkManager.h"
 #include "PSMoveProtocolInterface.h"
 #include "PSMoveProtocol.pb.h"
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <utility>
 
 //-- definitions -----
-struct RequestContext
+struct ClientRequestContext
 {
     RequestPtr request;  // std::shared_ptr<PSMoveProtocol::Request>
 };
-typedef std::map<int, RequestContext> t_request_context_map;
-typedef std::map<int, RequestContext>::iterator t_request_context_map_iterator;
-typedef std::pair<int, RequestContext> t_id_request_context_pair;
+typedef std::map<int, ClientRequestContext> t_request_context_map;
+typedef std::map<int, ClientRequestContext>::iterator t_request_context_map_iterator;
+typedef std::pair<int, ClientRequestContext> t_id_request_context_pair;
 typedef std::vector<ResponsePtr> t_response_reference_cache;
 typedef std::vector<RequestPtr> t_request_reference_cache;
 
@@ -44,7 +45,7 @@ public:
 
     void send_request(RequestPtr request)
     {
-        RequestContext context;
+        ClientRequestContext context;
 
         context.request = request;
 
@@ -79,7 +80,7 @@ public:
         assert(pending_request_entry != m_pending_requests.end());
 
         // The context holds everything a handler needs to evaluate a response
-        const RequestContext &context= pending_request_entry->second;
+        const ClientRequestContext &context= pending_request_entry->second;
 
         // Notify the callback of the response
         if (m_callback != nullptr)
@@ -178,6 +179,10 @@ public:
 				build_tracking_space_response_message(response, &out_response_message->payload.tracking_space);
 				out_response_message->payload_type = PSMResponseMessage::_responsePayloadType_TrackingSpace;
 				break;
+            case PSMoveProtocol::Response_ResponseType_SERVICE_STATISTICS:
+                ClientRequestManager::build_service_statistics(response, &out_response_message->payload.service_statistics);
+                out_response_message->payload_type = PSMResponseMessage::_responsePayloadType_ServiceStatistics;
+                break;
             default:
                 out_response_message->payload_type = PSMResponseMessage::_responsePayloadType_Empty;
                 break;
@@ -310,6 +315,9 @@ public:
             case PSMoveProtocol::TrackerDriver::GENERIC_WEBCAM:
                 TrackerInfo.tracker_driver = PSMDriver_GENERIC_WEBCAM;
                 break;
+            case PSMoveProtocol::TrackerDriver::REMOTE:
+                TrackerInfo.tracker_driver = PSMDriver_REMOTE;
+                break;
             default:
                 assert(0 && "unreachable");
             }
@@ -442,3 +450,81 @@ void ClientRequestManager::handle_response(ResponsePtr response)
 {
     m_implementation_ptr->handle_response(response);
 }
+
+void ClientRequestManager::build_service_statistics(
+    ResponsePtr response,
+    PSMServiceStatistics *out_statistics)
+{
+    const auto &StatisticsResponse = response->result_service_statistics();
+    const int statistic_count =
+        std::min(StatisticsResponse.statistics_size(), PSMOVESERVICE_MAX_STATISTIC_COUNT);
+
+    out_statistics->uptime_seconds = StatisticsResponse.uptime_seconds();
+
+    for (int statistic_index = 0; statistic_index < statistic_count; ++statistic_index)
+    {
+        const auto &Statistic = StatisticsResponse.statistics(statistic_index);
+        PSMServiceStatistic &statistic = out_statistics->statistics[statistic_index];
+
+        strncpy(statistic.name, Statistic.name().c_str(), PSMOVESERVICE_MAX_STATISTIC_NAME_LEN);
+        statistic.name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN - 1] = '\0';
+        statistic.value = Statistic.value();
+    }
+
+    out_statistics->count = statistic_count;
+}
+
+void ClientRequestManager::build_tracker_pose_calibration_progress(
+    ResponsePtr response,
+    PSMTrackerPoseCalibrationProgress *out_progress)
+{
+    const auto &ProgressResponse = response->result_tracker_pose_calibration_progress();
+    const int tracker_count =
+        std::min(ProgressResponse.trackers_size(), PSMOVESERVICE_MAX_TRACKER_COUNT);
+
+    switch (ProgressResponse.phase())
+    {
+    case PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_RECORDING:
+        out_progress->phase = PSMTrackerPoseCalibration_Recording;
+        break;
+    case PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_SOLVING:
+        out_progress->phase = PSMTrackerPoseCalibration_Solving;
+        break;
+    case PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_SUCCEEDED:
+        out_progress->phase = PSMTrackerPoseCalibration_Succeeded;
+        break;
+    case PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_CANCELED:
+        out_progress->phase = PSMTrackerPoseCalibration_Canceled;
+        break;
+    default:
+        out_progress->phase = PSMTrackerPoseCalibration_Failed;
+        break;
+    }
+
+    out_progress->controller_id = ProgressResponse.controller_id();
+    out_progress->sample_count = ProgressResponse.sample_count();
+    out_progress->target_sample_count = ProgressResponse.target_sample_count();
+    out_progress->iteration = ProgressResponse.iteration();
+    out_progress->rms_reprojection_error = ProgressResponse.rms_reprojection_error();
+
+    for (int tracker_index = 0; tracker_index < tracker_count; ++tracker_index)
+    {
+        const auto &TrackerResponse = ProgressResponse.trackers(tracker_index);
+        const PSMoveProtocol::Pose &Pose = TrackerResponse.pose();
+        PSMPosef &pose = out_progress->tracker_pose[tracker_index];
+
+        out_progress->tracker_id[tracker_index] = TrackerResponse.tracker_id();
+        out_progress->tracker_sample_count[tracker_index] = TrackerResponse.sample_count();
+
+        pose.Orientation.w = Pose.orientation().w();
+        pose.Orientation.x = Pose.orientation().x();
+        pose.Orientation.y = Pose.orientation().y();
+        pose.Orientation.z = Pose.orientation().z();
+
+        pose.Position.x = Pose.position().x();
+        pose.Position.y = Pose.position().y();
+        pose.Position.z = Pose.position().z();
+    }
+
+    out_progress->tracker_count = tracker_count;
+}
@@ -21,6 +21,12 @@ public:
 
     void flush_response_cache();
 
+    /// Copy a SERVICE_STATISTICS response or notification into the client api struct
+    static void build_service_statistics(ResponsePtr response, PSMServiceStatistics *out_statistics);
+
+    /// Copy a TRACKER_POSE_CALIBRATION_PROGRESS notification into the client api struct
+    static void build_tracker_pose_calibration_progress(ResponsePtr response, PSMTrackerPoseCalibrationProgress *out_progress);
+
 private:
     // private implementation - same lifetime as the ClientRequestManager
     class ClientRequestManagerImpl *m_implementation_ptr;
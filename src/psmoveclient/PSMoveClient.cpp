@@ -219,6 +219,9 @@ PSMoveClient::PSMoveClient(
 	, m_bHasControllerListChanged(false)
 	, m_bHasTrackerListChanged(false)
 	, m_bHasHMDListChanged(false)
+	, m_bWasSystemButtonPressed(false)
+	, m_bHasServiceStatistics(false)
+	, m_bHasTrackerPoseCalibrationProgress(false)
 {
 	m_request_manager=
 		new ClientRequestManager(
@@ -286,6 +289,26 @@ bool PSMoveClient::pollWasSystemButtonPressed()
 	return bWasSystemButtonPressed; 
 }
 
+bool PSMoveClient::get_latest_service_statistics(PSMServiceStatistics *out_statistics) const
+{
+	if (m_bHasServiceStatistics)
+	{
+		*out_statistics= m_latest_service_statistics;
+	}
+
+	return m_bHasServiceStatistics;
+}
+
+bool PSMoveClient::get_latest_tracker_pose_calibration_progress(PSMTrackerPoseCalibrationProgress *out_progress) const
+{
+	if (m_bHasTrackerPoseCalibrationProgress)
+	{
+		*out_progress= m_latest_tracker_pose_calibration_progress;
+	}
+
+	return m_bHasTrackerPoseCalibrationProgress;
+}
+
 // -- ClientPSMoveAPI System -----
 bool PSMoveClient::startup(e_log_severity_level log_level)
 {
@@ -300,6 +323,8 @@ bool PSMoveClient::startup(e_log_severity_level log_level)
 	m_bHasTrackerListChanged= false;
 	m_bHasHMDListChanged= false;
 	m_bWasSystemButtonPressed = false;
+	m_bHasServiceStatistics = false;
+	m_bHasTrackerPoseCalibrationProgress = false;
 
     // Attempt to connect to the server
     if (success)
@@ -323,10 +348,12 @@ bool PSMoveClient::startup(e_log_severity_level log_level)
 		}
 
 		memset(m_trackers, 0, sizeof(PSMTracker)*PSMOVESERVICE_MAX_TRACKER_COUNT);
+		memset(m_network_video_frames, 0, sizeof(PSMTrackerNetworkVideoFrame)*PSMOVESERVICE_MAX_TRACKER_COUNT);
 		for (PSMTrackerID tracker_id= 0; tracker_id < PSMOVESERVICE_MAX_TRACKER_COUNT; ++tracker_id)    
 		{
 			m_trackers[tracker_id].tracker_info.tracker_id= tracker_id;
 			m_trackers[tracker_id].tracker_info.tracker_type= PSMTracker_None;
+			m_network_video_frames[tracker_id].sequence_num= -1;
 		}
 
 		memset(m_HMDs, 0, sizeof(PSMHeadMountedDisplay)*PSMOVESERVICE_MAX_HMD_COUNT);
@@ -413,7 +440,7 @@ void PSMoveClient::publish()
 
 			if (bHasUnpublishedState)
 			{
-				DeviceInputDataFramePtr data_frame(new PSMoveProtocol::DeviceInputDataFrame);
+				DeviceInputDataFramePtr data_frame= m_network_manager->allocate_device_data_frame();
 				data_frame->set_device_category(PSMoveProtocol::DeviceInputDataFrame_DeviceCategory_CONTROLLER);
 
 				auto *controller_data_packet= data_frame->mutable_controller_data_packet();
@@ -644,6 +671,69 @@ PSMRequestID PSMoveClient::get_service_version()
     return request->request_id();
 }
 
+PSMRequestID PSMoveClient::get_service_statistics()
+{
+    CLIENT_LOG_INFO("get_service_statistics") << "requesting service statistics" << std::endl;
+
+    RequestPtr request(new PSMoveProtocol::Request());
+    request->set_type(PSMoveProtocol::Request_RequestType_GET_SERVICE_STATISTICS);
+
+    m_request_manager->send_request(request);
+
+    return request->request_id();
+}
+
+PSMRequestID PSMoveClient::start_service_statistics_stream(int interval_ms)
+{
+    CLIENT_LOG_INFO("start_service_statistics_stream") << "requesting service statistics every " << interval_ms << "ms" << std::endl;
+
+    RequestPtr request(new PSMoveProtocol::Request());
+    request->set_type(PSMoveProtocol::Request_RequestType_START_SERVICE_STATISTICS_STREAM);
+    request->mutable_request_start_service_statistics_stream()->set_interval_ms(interval_ms);
+
+    m_request_manager->send_request(request);
+
+    return request->request_id();
+}
+
+PSMRequestID PSMoveClient::stop_service_statistics_stream()
+{
+    CLIENT_LOG_INFO("stop_service_statistics_stream") << "requesting service statistics stream stop" << std::endl;
+
+    RequestPtr request(new PSMoveProtocol::Request());
+    request->set_type(PSMoveProtocol::Request_RequestType_STOP_SERVICE_STATISTICS_STREAM);
+
+    m_request_manager->send_request(request);
+
+    return request->request_id();
+}
+
+PSMRequestID PSMoveClient::start_tracker_pose_calibration(PSMControllerID controller_id, int sample_count)
+{
+    CLIENT_LOG_INFO("start_tracker_pose_calibration") << "requesting tracker pose calibration with controller " << controller_id << std::endl;
+
+    RequestPtr request(new PSMoveProtocol::Request());
+    request->set_type(PSMoveProtocol::Request_RequestType_START_TRACKER_POSE_CALIBRATION);
+    request->mutable_request_start_tracker_pose_calibration()->set_controller_id(controller_id);
+    request->mutable_request_start_tracker_pose_calibration()->set_sample_count(sample_count);
+
+    m_request_manager->send_request(request);
+
+    return request->request_id();
+}
+
+PSMRequestID PSMoveClient::stop_tracker_pose_calibration()
+{
+    CLIENT_LOG_INFO("stop_tracker_pose_calibration") << "requesting tracker pose calibration stop" << std::endl;
+
+    RequestPtr request(new PSMoveProtocol::Request());
+    request->set_type(PSMoveProtocol::Request_RequestType_STOP_TRACKER_POSE_CALIBRATION);
+
+    m_request_manager->send_request(request);
+
+    return request->request_id();
+}
+
 // -- ClientPSMoveAPI Requests -----
 bool PSMoveClient::allocate_controller_listener(PSMControllerID ControllerID)
 {
@@ -942,14 +1032,44 @@ PSMRequestID PSMoveClient::get_tracker_list()
     return request->request_id();
 }
 
-PSMRequestID PSMoveClient::start_tracker_data_stream(PSMTrackerID tracker_id)
+PSMRequestID PSMoveClient::start_tracker_data_stream(
+	PSMTrackerID tracker_id, 
+	const PSMTrackerNetworkVideoSettings *network_video_settings)
 {
     CLIENT_LOG_INFO("start_tracker_data_stream") << "requesting tracker stream start for TrackerID: " << tracker_id << std::endl;
 
     // Tell the psmove service that we are acquiring this tracker
     RequestPtr request(new PSMoveProtocol::Request());
     request->set_type(PSMoveProtocol::Request_RequestType_START_TRACKER_DATA_STREAM);
-    request->mutable_request_start_tracker_data_stream()->set_tracker_id(tracker_id);
+
+    PSMoveProtocol::Request_RequestStartTrackerDataStream *stream_request= request->mutable_request_start_tracker_data_stream();
+    stream_request->set_tracker_id(tracker_id);
+
+    // Have the video sent over the network instead of through shared memory
+    if (network_video_settings != nullptr)
+    {
+        switch (network_video_settings->mode)
+        {
+        case PSMTrackerNetworkVideo_JPEGFrame:
+            stream_request->set_network_video_mode(PSMoveProtocol::Request_RequestStartTrackerDataStream_NetworkVideoMode_JPEG_FRAME);
+            break;
+        case PSMTrackerNetworkVideo_JPEGROI:
+            stream_request->set_network_video_mode(PSMoveProtocol::Request_RequestStartTrackerDataStream_NetworkVideoMode_JPEG_ROI);
+            break;
+        case PSMTrackerNetworkVideo_Mask:
+            stream_request->set_network_video_mode(PSMoveProtocol::Request_RequestStartTrackerDataStream_NetworkVideoMode_MASK);
+            break;
+        }
+        stream_request->set_network_video_max_fps(network_video_settings->max_fps);
+        stream_request->set_network_video_max_kbps(network_video_settings->max_kbps);
+        stream_request->set_network_video_jpeg_quality(network_video_settings->jpeg_quality);
+
+        // Forget any frame from an earlier stream
+        if (IS_VALID_TRACKER_INDEX(tracker_id))
+        {
+            m_network_video_frames[tracker_id].sequence_num= -1;
+        }
+    }
 
     m_request_manager->send_request(request);
 
@@ -1073,6 +1193,20 @@ const unsigned char *PSMoveClient::get_video_frame_buffer(PSMTrackerID tracker_i
 
 	return buffer;
 }
+
+bool PSMoveClient::get_network_video_frame(PSMTrackerID tracker_id, PSMTrackerNetworkVideoFrame *out_frame) const
+{
+	bool bHasFrame= false;
+
+	if (IS_VALID_TRACKER_INDEX(tracker_id) && m_network_video_frames[tracker_id].sequence_num >= 0)
+	{
+		*out_frame= m_network_video_frames[tracker_id];
+		out_frame->image_data= m_network_video_frame_data[tracker_id].data();
+		bHasFrame= true;
+	}
+
+	return bHasFrame;
+}
     
 bool PSMoveClient::allocate_hmd_listener(PSMHmdID hmd_id)
 {
@@ -1882,6 +2016,20 @@ static void applyTrackerDataFrame(
     {
         tracker->sequence_num = tracker_packet.sequence_num();
         tracker->is_connected = tracker_packet.isconnected();
+
+        const PSMoveProtocol::DeviceOutputDataFrame_TrackerDataPacket_TrackerStatistics &statistics =
+            tracker_packet.statistics();
+        tracker->statistics.hsv_pixels_requested = statistics.hsv_pixels_requested();
+        tracker->statistics.hsv_pixels_converted = statistics.hsv_pixels_converted();
+        tracker->statistics.working_buffer_bytes = statistics.working_buffer_bytes();
+        tracker->statistics.shared_hsv_lut_bytes = statistics.shared_hsv_lut_bytes();
+        tracker->statistics.exposure_sample_count = statistics.exposure_sample_count();
+        tracker->statistics.bulb_value = statistics.bulb_value();
+        tracker->statistics.bulb_clipped_fraction = statistics.bulb_clipped_fraction();
+        tracker->statistics.background_value = statistics.background_value();
+        tracker->statistics.exposure_decision = static_cast<PSMTrackerExposureDecision>(statistics.exposure_decision());
+        tracker->statistics.exposure = statistics.exposure();
+        tracker->statistics.gain = statistics.gain();
     }
 }
 
@@ -2158,11 +2306,54 @@ void PSMoveClient::handle_notification(ResponsePtr notification)
 	case PSMoveProtocol::Response_ResponseType_SYSTEM_BUTTON_PRESSED:
 		specificEventType = PSMEventMessage::PSMEvent_systemButtonPressed;
 		break;
+    case PSMoveProtocol::Response_ResponseType_SERVICE_STATISTICS:
+        ClientRequestManager::build_service_statistics(notification, &m_latest_service_statistics);
+        m_bHasServiceStatistics= true;
+        specificEventType = PSMEventMessage::PSMEvent_serviceStatisticsUpdated;
+        break;
+    case PSMoveProtocol::Response_ResponseType_TRACKER_POSE_CALIBRATION_PROGRESS:
+        ClientRequestManager::build_tracker_pose_calibration_progress(notification, &m_latest_tracker_pose_calibration_progress);
+        m_bHasTrackerPoseCalibrationProgress= true;
+        specificEventType = PSMEventMessage::PSMEvent_trackerPoseCalibrationProgress;
+        break;
+    case PSMoveProtocol::Response_ResponseType_TRACKER_VIDEO_FRAME:
+        // Video frames arrive at the tracker frame rate, just keep the latest one per tracker
+        store_network_video_frame(notification->result_tracker_video_frame());
+        return;
     }
 
     enqueue_event_message(specificEventType, notification);
 }
 
+void PSMoveClient::store_network_video_frame(const PSMoveProtocol::Response_ResultTrackerVideoFrame &video_frame)
+{
+    const PSMTrackerID tracker_id= video_frame.tracker_id();
+
+    if (IS_VALID_TRACKER_INDEX(tracker_id))
+    {
+        PSMTrackerNetworkVideoFrame &frame= m_network_video_frames[tracker_id];
+        std::vector<unsigned char> &frame_data= m_network_video_frame_data[tracker_id];
+        const std::string &image_data= video_frame.image_data();
+
+        frame.sequence_num= video_frame.sequence_num();
+        frame.image_format= 
+            (video_frame.image_format() == PSMoveProtocol::Response_ResultTrackerVideoFrame_ImageFormat_PNG)
+            ? PSMTrackerNetworkVideoImage_PNG
+            : PSMTrackerNetworkVideoImage_JPEG;
+        frame.frame_width= video_frame.frame_width();
+        frame.frame_height= video_frame.frame_height();
+        frame.region_x= video_frame.region_x();
+        frame.region_y= video_frame.region_y();
+        frame.region_width= video_frame.region_width();
+        frame.region_height= video_frame.region_height();
+
+        // The notification is reused for the next message, keep our own copy of the image
+        frame_data.assign(image_data.begin(), image_data.end());
+        frame.image_data= nullptr;
+        frame.image_data_size= static_cast<int>(frame_data.size());
+    }
+}
+
 // IClientNetworkEventListener
 void PSMoveClient::handle_server_connection_opened()
 {
@@ -2253,6 +2444,10 @@ void PSMoveClient::process_event_message(
     case PSMEventMessage::PSMEvent_systemButtonPressed:
         m_bWasSystemButtonPressed= true;
         break;
+    case PSMEventMessage::PSMEvent_serviceStatisticsUpdated:
+    case PSMEventMessage::PSMEvent_trackerPoseCalibrationProgress:
+        // Snapshot already stored in handle_notification
+        break;
     default:
         assert(0 && "unreachable");
         break;
@@ -10,6 +10,12 @@
 #include <map>
 #include <vector>
 
+//-- pre-declarations -----
+namespace PSMoveProtocol
+{
+    class Response_ResultTrackerVideoFrame;
+};
+
 //-- typedefs -----
 typedef std::deque<PSMMessage> t_message_queue;
 typedef std::vector<ResponsePtr> t_event_reference_cache;
@@ -33,6 +39,8 @@ public:
 	bool pollHasTrackerListChanged();
 	bool pollHasHMDListChanged();
 	bool pollWasSystemButtonPressed();
+	bool get_latest_service_statistics(PSMServiceStatistics *out_statistics) const;
+	bool get_latest_tracker_pose_calibration_progress(PSMTrackerPoseCalibrationProgress *out_progress) const;
 
     // -- ClientPSMoveAPI System -----
     bool startup(e_log_severity_level log_level);
@@ -43,6 +51,11 @@ public:
 
 	// -- System Requests ----
     PSMRequestID get_service_version();
+    PSMRequestID get_service_statistics();
+    PSMRequestID start_service_statistics_stream(int interval_ms);
+    PSMRequestID stop_service_statistics_stream();
+    PSMRequestID start_tracker_pose_calibration(PSMControllerID controller_id, int sample_count);
+    PSMRequestID stop_tracker_pose_calibration();
 
     // -- ClientPSMoveAPI Requests -----
     bool allocate_controller_listener(PSMControllerID controller_id);
@@ -61,12 +74,13 @@ public:
     PSMTracker* get_tracker_view(PSMTrackerID tracker_id);
 	PSMRequestID get_tracking_space_settings();
     PSMRequestID get_tracker_list();
-    PSMRequestID start_tracker_data_stream(PSMTrackerID tracker_id);
+    PSMRequestID start_tracker_data_stream(PSMTrackerID tracker_id, const PSMTrackerNetworkVideoSettings *network_video_settings= nullptr);
     PSMRequestID stop_tracker_data_stream(PSMTrackerID tracker_id);
 	bool open_video_stream(PSMTrackerID tracker_id);
 	bool poll_video_stream(PSMTrackerID tracker_id);
 	void close_video_stream(PSMTrackerID tracker_id);
 	const unsigned char *get_video_frame_buffer(PSMTrackerID tracker_id) const;
+	bool get_network_video_frame(PSMTrackerID tracker_id, PSMTrackerNetworkVideoFrame *out_frame) const;
 
     bool allocate_hmd_listener(PSMHmdID HmdID);
     void free_hmd_listener(PSMHmdID HmdID);   
@@ -107,6 +121,7 @@ protected:
     void enqueue_event_message(PSMEventMessage::eEventType event_type, ResponsePtr event);
     bool execute_callback(const PSMResponseMessage *response_message);
     void enqueue_response_message(const PSMResponseMessage *response_message);
+    void store_network_video_frame(const PSMoveProtocol::Response_ResultTrackerVideoFrame &video_frame);
 
 private:
     //-- Pending requests -----
@@ -131,6 +146,22 @@ private:
 	bool m_bHasHMDListChanged;
 	bool m_bWasSystemButtonPressed;
 
+    //-- Service Statistics -----
+    // Most recent snapshot pushed by the statistics stream
+    PSMServiceStatistics m_latest_service_statistics;
+    bool m_bHasServiceStatistics;
+
+    //-- Tracker Pose Calibration -----
+    // Most recent progress pushed by a tracker pose calibration
+    PSMTrackerPoseCalibrationProgress m_latest_tracker_pose_calibration_progress;
+    bool m_bHasTrackerPoseCalibrationProgress;
+
+    //-- Tracker Network Video -----
+    // Latest compressed frame of each tracker network video stream.
+    // The image is copied out of the notification since the network manager reuses it.
+    PSMTrackerNetworkVideoFrame m_network_video_frames[PSMOVESERVICE_MAX_TRACKER_COUNT];
+    std::vector<unsigned char> m_network_video_frame_data[PSMOVESERVICE_MAX_TRACKER_COUNT];
+
     struct PendingRequest
     {
         PSMRequestID request_id;
@@ -264,6 +264,125 @@ PSMResult PSM_GetServiceVersionStringAsync(PSMRequestID *out_request_id)
     return result;
 }
 
+PSMResult PSM_GetServiceStatistics(PSMServiceStatistics *out_statistics, int timeout_ms)
+{
+    PSMResult result_code= PSMResult_Error;
+
+    if (g_psm_client != nullptr && out_statistics != nullptr)
+    {
+	    PSMBlockingRequest request(g_psm_client->get_service_statistics());
+        result_code= request.send(timeout_ms);
+
+        if (result_code == PSMResult_Success)
+        {
+            assert(request.get_response_payload_type() == PSMResponseMessage::_responsePayloadType_ServiceStatistics);
+
+            *out_statistics= request.get_response_message().payload.service_statistics;
+        }
+    }
+    
+    return result_code;
+}
+
+PSMResult PSM_GetServiceStatisticsAsync(PSMRequestID *out_request_id)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr)
+    {
+        PSMRequestID req_id = g_psm_client->get_service_statistics();
+
+        if (out_request_id != nullptr)
+        {
+            *out_request_id= req_id;
+        }
+
+        result= (req_id != PSM_INVALID_REQUEST_ID) ? PSMResult_RequestSent : PSMResult_Error;
+    }
+
+    return result;
+}
+
+PSMResult PSM_StartServiceStatisticsStream(int interval_ms, int timeout_ms)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr && interval_ms > 0)
+    {
+		PSMBlockingRequest request(g_psm_client->start_service_statistics_stream(interval_ms));
+
+		result= request.send(timeout_ms);
+    }
+
+    return result;
+}
+
+PSMResult PSM_StopServiceStatisticsStream(int timeout_ms)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr)
+    {
+		PSMBlockingRequest request(g_psm_client->stop_service_statistics_stream());
+
+		result= request.send(timeout_ms);
+    }
+
+    return result;
+}
+
+PSMResult PSM_GetLatestServiceStatistics(PSMServiceStatistics *out_statistics)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr && out_statistics != nullptr)
+    {
+        result= g_psm_client->get_latest_service_statistics(out_statistics) ? PSMResult_Success : PSMResult_NoData;
+    }
+
+    return result;
+}
+
+PSMResult PSM_StartTrackerPoseCalibration(PSMControllerID controller_id, int sample_count, int timeout_ms)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr && sample_count >= 0)
+    {
+		PSMBlockingRequest request(g_psm_client->start_tracker_pose_calibration(controller_id, sample_count));
+
+		result= request.send(timeout_ms);
+    }
+
+    return result;
+}
+
+PSMResult PSM_StopTrackerPoseCalibration(int timeout_ms)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr)
+    {
+		PSMBlockingRequest request(g_psm_client->stop_tracker_pose_calibration());
+
+		result= request.send(timeout_ms);
+    }
+
+    return result;
+}
+
+PSMResult PSM_GetLatestTrackerPoseCalibrationProgress(PSMTrackerPoseCalibrationProgress *out_progress)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr && out_progress != nullptr)
+    {
+        result= g_psm_client->get_latest_tracker_pose_calibration_progress(out_progress) ? PSMResult_Success : PSMResult_NoData;
+    }
+
+    return result;
+}
+
 PSMResult PSM_Shutdown()
 {
 	PSMResult result= PSMResult_Error;
@@ -1139,6 +1258,20 @@ PSMResult PSM_StartTrackerDataStream(PSMTrackerID tracker_id, int timeout_ms)
     return result;
 }
 
+PSMResult PSM_StartTrackerDataStreamWithNetworkVideo(PSMTrackerID tracker_id, const PSMTrackerNetworkVideoSettings *settings, int timeout_ms)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr && IS_VALID_TRACKER_INDEX(tracker_id) && settings != nullptr)
+    {
+		PSMBlockingRequest request(g_psm_client->start_tracker_data_stream(tracker_id, settings));
+
+		result= request.send(timeout_ms);
+    }
+
+    return result;
+}
+
 PSMResult PSM_StopTrackerDataStream(PSMTrackerID tracker_id, int timeout_ms)
 {
     PSMResult result= PSMResult_Error;
@@ -1229,6 +1362,18 @@ PSMResult PSM_GetTrackerVideoFrameBuffer(PSMTrackerID tracker_id, const unsigned
     return result;
 }
 
+PSMResult PSM_GetTrackerNetworkVideoFrame(PSMTrackerID tracker_id, PSMTrackerNetworkVideoFrame *out_frame)
+{
+    PSMResult result= PSMResult_Error;
+
+    if (g_psm_client != nullptr && IS_VALID_TRACKER_INDEX(tracker_id) && out_frame != nullptr)
+    {
+        result= g_psm_client->get_network_video_frame(tracker_id, out_frame) ? PSMResult_Success : PSMResult_NoData;
+    }
+
+    return result;
+}
+
 PSMResult PSM_GetTrackerFrustum(PSMTrackerID tracker_id, PSMFrustum *out_frustum)
 {
     PSMResult result= PSMResult_Error;
@@ -1291,6 +1436,25 @@ PSMResult PSM_StartTrackerDataStreamAsync(PSMTrackerID tracker_id, PSMRequestID
     return result_code;
 }
 
+PSMResult PSM_StartTrackerDataStreamWithNetworkVideoAsync(PSMTrackerID tracker_id, const PSMTrackerNetworkVideoSettings *settings, PSMRequestID *out_request_id)
+{
+    PSMResult result_code= PSMResult_Error;
+
+    if (g_psm_client != nullptr && IS_VALID_TRACKER_INDEX(tracker_id) && settings != nullptr)
+    {
+        PSMRequestID req_id = g_psm_client->start_tracker_data_stream(tracker_id, settings);
+
+        if (out_request_id != nullptr)
+        {
+            *out_request_id= req_id;
+        }
+
+        result_code= (req_id != PSM_INVALID_REQUEST_ID) ? PSMResult_RequestSent : PSMResult_Error;
+    }
+
+    return result_code;
+}
+
 PSMResult PSM_StopTrackerDataStreamAsync(PSMTrackerID tracker_id, PSMRequestID *out_request_id)
 {
     PSMResult result_code= PSMResult_Error;
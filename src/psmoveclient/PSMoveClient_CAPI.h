@@ -160,7 +160,8 @@ typedef enum
     PSMDriver_LIBUSB,
     PSMDriver_CL_EYE,
     PSMDriver_CL_EYE_MULTICAM,
-    PSMDriver_GENERIC_WEBCAM
+    PSMDriver_GENERIC_WEBCAM,
+    PSMDriver_REMOTE
 } PSMTrackerDriver;
 
 // Controller State
@@ -443,6 +444,33 @@ typedef struct
     PSMPosef tracker_pose; ///< World space location of tracker (relative to calibration mat)
 } PSMClientTrackerInfo;
 
+/// What a tracker's adaptive exposure control last decided
+typedef enum
+{
+    PSMTrackerExposureDecision_Disabled,  ///< No exposure control on this tracker
+    PSMTrackerExposureDecision_Waiting,   ///< Not enough measurements yet
+    PSMTrackerExposureDecision_Hold,      ///< The devices are exposed well
+    PSMTrackerExposureDecision_Darken,    ///< Lowered the gain and/or exposure
+    PSMTrackerExposureDecision_Brighten,  ///< Raised the exposure and/or gain
+    PSMTrackerExposureDecision_AtLimit    ///< Wanted to adjust but the settings are at their bounds
+} PSMTrackerExposureDecision;
+
+/// Video processing statistics for the last frame a tracker processed
+typedef struct
+{
+    int hsv_pixels_requested; ///< pixels covered by the tracked device ROIs (overlaps counted once per ROI)
+    int hsv_pixels_converted; ///< pixels actually converted to HSV (each pixel at most once per frame)
+    long long working_buffer_bytes; ///< bytes held by the tracker's HSV and mask buffers (sized to the ROIs)
+    long long shared_hsv_lut_bytes; ///< bytes held by the BGR->HSV lookup table shared by all trackers
+    int exposure_sample_count; ///< tracked devices measured for the exposure control (0 when it's off)
+    float bulb_value; ///< mean HSV value (0-255) of the devices' pixels in their color range
+    float bulb_clipped_fraction; ///< fraction of the devices' bounding boxes at full brightness
+    float background_value; ///< mean HSV value (0-255) of the rest of the ROIs the devices were found in
+    PSMTrackerExposureDecision exposure_decision; ///< what the adaptive exposure control last decided
+    float exposure; ///< current exposure setting of the tracker
+    float gain; ///< current gain setting of the tracker
+} PSMTrackerStatistics;
+
 /// Tracker Pool Entry
 typedef struct
 {
@@ -455,11 +483,51 @@ typedef struct
     int sequence_num;
     long long data_frame_last_received_time;
     float data_frame_average_fps;
+    PSMTrackerStatistics statistics;
 
     // SharedVideoFrameReadOnlyAccessor used by config tool
     void *opaque_shared_memory_accesor;
 } PSMTracker;
 
+/// How the tracker video is compressed when it's sent over the network
+typedef enum
+{
+    PSMTrackerNetworkVideo_JPEGFrame,   ///< Whole video frame as a JPEG
+    PSMTrackerNetworkVideo_JPEGROI,     ///< JPEG of the bounding box of the regions searched in the frame
+    PSMTrackerNetworkVideo_Mask         ///< PNG of the color filter mask in the regions searched in the frame
+} PSMTrackerNetworkVideoMode;
+
+/// Settings for a tracker video stream sent over the network
+typedef struct
+{
+    PSMTrackerNetworkVideoMode mode;
+    int max_fps;        ///< Frame rate cap, 0 for every tracker frame
+    int max_kbps;       ///< Bitrate cap in kilobits per second, 0 for no cap
+    int jpeg_quality;   ///< 1-100, 0 for the service default
+} PSMTrackerNetworkVideoSettings;
+
+/// Compressed image format of a network video frame
+typedef enum
+{
+    PSMTrackerNetworkVideoImage_JPEG,
+    PSMTrackerNetworkVideoImage_PNG
+} PSMTrackerNetworkVideoImageFormat;
+
+/// The latest compressed video frame received from a tracker network video stream
+typedef struct
+{
+    int sequence_num;                               ///< Tracker frame the image was taken from
+    PSMTrackerNetworkVideoImageFormat image_format;
+    int frame_width;                                ///< Size of the whole video frame in pixels
+    int frame_height;
+    int region_x;                                   ///< Part of the video frame the image covers in pixels
+    int region_y;
+    int region_width;
+    int region_height;
+    const unsigned char *image_data;                ///< Encoded image, valid until the next call to PSM_Update
+    int image_data_size;
+} PSMTrackerNetworkVideoFrame;
+
 // HMD State
 //----------
 
@@ -542,7 +610,9 @@ typedef struct
         PSMEvent_controllerListUpdated,
         PSMEvent_trackerListUpdated,
         PSMEvent_hmdListUpdated,
-        PSMEvent_systemButtonPressed
+        PSMEvent_systemButtonPressed,
+        PSMEvent_serviceStatisticsUpdated,
+        PSMEvent_trackerPoseCalibrationProgress
     } event_type;
 
     /// Opaque handle that can be converted to a <const PSMoveProtocol::Response *> pointer
@@ -592,6 +662,46 @@ typedef struct
     float global_forward_degrees;
 } PSMTrackingSpace;
 
+/// A single named counter, gauge or timer percentile reported by PSMoveService
+typedef struct
+{
+    char name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN];
+    double value;
+} PSMServiceStatistic;
+
+/// Snapshot of the PSMoveService statistics registry
+typedef struct
+{
+    double uptime_seconds;
+    PSMServiceStatistic statistics[PSMOVESERVICE_MAX_STATISTIC_COUNT];
+    int count;
+} PSMServiceStatistics;
+
+/// Stage of a tracker pose calibration
+typedef enum
+{
+    PSMTrackerPoseCalibration_Recording,    ///< Recording the controller bulb as it moves through the tracking volume
+    PSMTrackerPoseCalibration_Solving,      ///< Solving for all of the tracker poses at once
+    PSMTrackerPoseCalibration_Succeeded,    ///< The solved tracker poses were applied and saved
+    PSMTrackerPoseCalibration_Failed,
+    PSMTrackerPoseCalibration_Canceled
+} PSMTrackerPoseCalibrationPhase;
+
+/// Progress of a tracker pose calibration started with \ref PSM_StartTrackerPoseCalibration
+typedef struct
+{
+    PSMTrackerPoseCalibrationPhase phase;
+    PSMControllerID controller_id;
+    int sample_count;               ///< Bulb locations recorded so far
+    int target_sample_count;        ///< Bulb locations recorded before solving
+    int iteration;                  ///< Solver iteration
+    float rms_reprojection_error;   ///< Solver RMS reprojection error in pixels
+    PSMTrackerID tracker_id[PSMOVESERVICE_MAX_TRACKER_COUNT];
+    int tracker_sample_count[PSMOVESERVICE_MAX_TRACKER_COUNT]; ///< Recorded bulb locations each tracker saw
+    PSMPosef tracker_pose[PSMOVESERVICE_MAX_TRACKER_COUNT]; ///< Solved tracker poses once the calibration succeeds
+    int tracker_count;
+} PSMTrackerPoseCalibrationProgress;
+
 /// A contrainer for all possible responses to requests sent from PSMoveService
 typedef struct
 {
@@ -617,6 +727,7 @@ typedef struct
         PSMTrackerList tracker_list;		///< Response to tracker list request
 		PSMHmdList hmd_list;				///< Response to hmd list request
         PSMTrackingSpace tracking_space;	///< Response to tracking space request
+        PSMServiceStatistics service_statistics; ///< Response to service statistics request
     } payload;
 
 	/// Type of response sent from PSMoveService
@@ -628,6 +739,7 @@ typedef struct
         _responsePayloadType_TrackerList,
         _responsePayloadType_TrackingSpace,
 		_responsePayloadType_HmdList,
+        _responsePayloadType_ServiceStatistics,
 
         _responsePayloadType_Count
     } payload_type;
@@ -666,6 +778,9 @@ typedef struct
  Calling this function again after a connection is already started will return PSMResult_Success.
 
  \remark Blocking - Returns after either a connection is successfully established OR the timeout period is reached. 
+ \remark Passing PSMOVESERVICE_EMBEDDED_ADDRESS as the host starts the service inside this process instead
+ (only if the client was built with PSM_BUILD_EMBEDDED_SERVICE). The embedded service runs during \ref PSM_Update(),
+ so PSM_Update() must be called regularly to keep the devices polled.
  \param host The address that PSMoveService is running at, usually PSMOVESERVICE_DEFAULT_ADDRESS
  \param port The port that PSMoveSerive is running at, usually PSMOVESERVICE_DEFAULT_PORT
  \param timeout The conection timeout period in milliseconds, usually PSM_DEFAULT_TIMEOUT
@@ -816,6 +931,74 @@ PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetServiceVersionString(char *out_version_str
  */
 PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetServiceVersionStringAsync(PSMRequestID *out_request_id);
 
+// Service Statistics
+/** \brief Get a snapshot of the PSMoveService statistics (packet rates, queue depths, tick times, ...)
+	\remark Blocking - Returns after either the statistics are returned OR the timeout period is reached. 
+	\param[out] out_statistics The statistics snapshot to fill in
+	\param timeout_ms The request timeout period in milliseconds, usually PSM_DEFAULT_TIMEOUT
+	\return PSMResult_Success upon receiving result, PSMResult_Timeoout, or PSMResult_Error on request error.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetServiceStatistics(PSMServiceStatistics *out_statistics, int timeout_ms);
+
+/** \brief Get a snapshot of the PSMoveService statistics
+	\remark Async - Starts a request for the statistics. Result obtained in one of two ways:
+	  - Register callback for request id with \ref PSM_RegisterCallback and the poll with \ref PSM_Update()
+	  - Poll with \ref PSM_UpdateNoPollMessages() and then call \ref PSM_PollNextMessage() to see if 
+	  \ref PSMServiceStatistics result has been received.
+	\param[out] out_request_id The id of the request sent to PSMoveService. Can be used to register callback with \ref PSM_RegisterCallback.
+	\return PSMResult_RequestSent on success or PSMResult_Error if there is no valid connection.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetServiceStatisticsAsync(PSMRequestID *out_request_id);
+
+/** \brief Have PSMoveService push a statistics snapshot at a fixed interval.
+	Each snapshot raises a \ref PSMEvent_serviceStatisticsUpdated event and can be read with \ref PSM_GetLatestServiceStatistics.
+	\remark Blocking - Returns after either the stream start response comes back OR the timeout period is reached. 
+	\param interval_ms Time between snapshots in milliseconds
+	\param timeout_ms The request timeout period in milliseconds, usually PSM_DEFAULT_TIMEOUT
+	\return PSMResult_Success upon receiving result, PSMResult_Timeoout, or PSMResult_Error on request error.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_StartServiceStatisticsStream(int interval_ms, int timeout_ms);
+
+/** \brief Stop the statistics snapshots started by \ref PSM_StartServiceStatisticsStream
+	\remark Blocking - Returns after either the stream stop response comes back OR the timeout period is reached. 
+	\param timeout_ms The request timeout period in milliseconds, usually PSM_DEFAULT_TIMEOUT
+	\return PSMResult_Success upon receiving result, PSMResult_Timeoout, or PSMResult_Error on request error.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_StopServiceStatisticsStream(int timeout_ms);
+
+/** \brief Get the most recent statistics snapshot pushed by the statistics stream
+	\param[out] out_statistics The statistics snapshot to fill in
+	\return PSMResult_Success or PSMResult_NoData if no snapshot has been received yet.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetLatestServiceStatistics(PSMServiceStatistics *out_statistics);
+
+// Tracker Pose Calibration
+/** \brief Calibrate the poses of all open trackers at once.
+	PSMoveService records the controller's bulb while it's moved slowly through the tracking volume,
+	then jointly solves all of the tracker poses. The lowest numbered tracker keeps its current pose.
+	Progress raises \ref PSMEvent_trackerPoseCalibrationProgress events and can be read with
+	\ref PSM_GetLatestTrackerPoseCalibrationProgress.
+	\remark Blocking - Returns after either the start response comes back OR the timeout period is reached. 
+	\param controller_id The id of the optically tracked controller to record
+	\param sample_count Bulb locations to record before solving, 0 for the service default
+	\param timeout_ms The request timeout period in milliseconds, usually PSM_DEFAULT_TIMEOUT
+	\return PSMResult_Success upon receiving result, PSMResult_Timeoout, or PSMResult_Error on request error.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_StartTrackerPoseCalibration(PSMControllerID controller_id, int sample_count, int timeout_ms);
+
+/** \brief Cancel the tracker pose calibration started by \ref PSM_StartTrackerPoseCalibration
+	\remark Blocking - Returns after either the stop response comes back OR the timeout period is reached. 
+	\param timeout_ms The request timeout period in milliseconds, usually PSM_DEFAULT_TIMEOUT
+	\return PSMResult_Success upon receiving result, PSMResult_Timeoout, or PSMResult_Error on request error.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_StopTrackerPoseCalibration(int timeout_ms);
+
+/** \brief Get the most recent tracker pose calibration progress pushed by PSMoveService
+	\param[out] out_progress The progress to fill in
+	\return PSMResult_Success or PSMResult_NoData if no progress has been received yet.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetLatestTrackerPoseCalibrationProgress(PSMTrackerPoseCalibrationProgress *out_progress);
+
 // Async Message Handling API
 /** \brief Retrieve the next message from the message queue.
 	A call to \ref PSM_UpdateNoPollMessages will queue messages received from PSMoveService.
@@ -1272,6 +1455,21 @@ PSM_PUBLIC_FUNCTION(PSMResult) PSM_StartTrackerDataStream(PSMTrackerID tracker_i
  */
 PSM_PUBLIC_FUNCTION(PSMResult) PSM_StopTrackerDataStream(PSMTrackerID tracker_id, int timeout_ms);
 
+/** \brief Requests start of a tracker data stream with the video sent compressed over the network
+	Like \ref PSM_StartTrackerDataStream, but instead of writing the video to shared memory
+	PSMoveService encodes the frames on a background thread and sends them to this client.
+	The latest frame can be read with \ref PSM_GetTrackerNetworkVideoFrame after calls to \ref PSM_Update.
+	Frames are skipped to stay under the frame rate and bitrate caps in the settings.
+	Stop the stream with \ref PSM_StopTrackerDataStream.
+	\remark Works for clients on any machine, the client decodes the JPEG or PNG images itself.
+	\remark Blocking - Returns after either stream start response comes back OR the timeout period is reached. 
+	\param tracker_id The id of the tracker to start the stream for.
+	\param settings The video mode, frame rate and bitrate caps of the stream.
+	\param timeout_ms The conection timeout period in milliseconds, usually PSM_DEFAULT_TIMEOUT
+	\return PSMResult_Success upon receiving result, PSMResult_Timeoout, or PSMResult_Error on request error.
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_StartTrackerDataStreamWithNetworkVideo(PSMTrackerID tracker_id, const PSMTrackerNetworkVideoSettings *settings, int timeout_ms);
+
 /** \brief Request the tracking space settings
 	Sends a request to PSMoveService to get the tracking space settings for PSMoveService.
 	The settings contain the direction of global forward (usually the -Z axis)
@@ -1313,6 +1511,15 @@ PSM_PUBLIC_FUNCTION(PSMResult) PSM_CloseTrackerVideoStream(PSMTrackerID tracker_
  */
 PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetTrackerVideoFrameBuffer(PSMTrackerID tracker_id, const unsigned char **out_buffer); 
 
+/** \brief Fetch the latest compressed frame received from a tracker network video stream
+	A call to \ref PSM_StartTrackerDataStreamWithNetworkVideo must be done first.
+	Compare the sequence_num with the previous frame to see if a new frame arrived.
+	\param tracker_id The tracker to get the latest network video frame of
+	\param[out] out_frame The frame properties and a pointer to the encoded image
+	\return PSMResult_Success if a frame was received, PSMResult_NoData otherwise
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetTrackerNetworkVideoFrame(PSMTrackerID tracker_id, PSMTrackerNetworkVideoFrame *out_frame);
+
 /** \brief Helper function to fetch tracking frustum properties from a tracker
 	\param The id of the tracker we wish to get the tracking frustum properties for
 	\param out_frustum The tracking frustum properties to write the result into
@@ -1347,6 +1554,19 @@ PSM_PUBLIC_FUNCTION(PSMResult) PSM_GetTrackerFrustum(PSMTrackerID tracker_id, PS
  */
 PSM_PUBLIC_FUNCTION(PSMResult) PSM_StartTrackerDataStreamAsync(PSMTrackerID tracker_id, PSMRequestID *out_request_id);
 
+/** \brief Requests start of a tracker data stream with the video sent compressed over the network
+	See \ref PSM_StartTrackerDataStreamWithNetworkVideo.
+	\remark Async - Result obtained in one of two ways:
+	  - Register callback for request id with \ref PSM_RegisterCallback and the poll with \ref PSM_Update()
+	  - Poll with \ref PSM_UpdateNoPollMessages() and then call \ref PSM_PollNextMessage() to see if 
+	  generic \ref PSMResponseMessage result has been received.
+	\param tracker_id The tracker id we wish to start the stream for
+	\param settings The video mode, frame rate and bitrate caps of the stream.
+	\param[out] out_request_id The id of the request sent to PSMoveService. Can be used to register callback with \ref PSM_RegisterCallback.
+	\return PSMResult_RequestSent on success or PSMResult_Error if there was no valid connection
+ */
+PSM_PUBLIC_FUNCTION(PSMResult) PSM_StartTrackerDataStreamWithNetworkVideoAsync(PSMTrackerID tracker_id, const PSMTrackerNetworkVideoSettings *settings, PSMRequestID *out_request_id);
+
 /** \brief Requests stop shared memory video stream for a given tracker
 	Asks PSMoveService to stop video data for the given tracker.
 	\remark Async - Result obtained in one of two ways:
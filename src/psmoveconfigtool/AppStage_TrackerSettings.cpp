@@ -255,6 +255,10 @@ void AppStage_TrackerSettings::renderUI()
                 {
                     ImGui::BulletText("Controller Type: Generic Webcam");
                 } break;
+            case PSMDriver_REMOTE:
+                {
+                    ImGui::BulletText("Controller Type: Remote Tracker Node");
+                } break;
             default:
                 assert(0 && "Unreachable");
             }
@@ -0,0 +1,658 @@
+//-- includes -----
+#include "MathBundleAdjustment.h"
+#include "Eigen/Dense"
+#include "Eigen/SVD"
+
+#include <algorithm>
+#include <vector>
+
+//-- constants -----
+static const double k_min_camera_depth = 1e-3;
+static const double k_initial_damping = 1e-3;
+static const double k_max_damping = 1e10;
+static const double k_min_damping = 1e-12;
+
+//-- private definitions -----
+typedef Eigen::Matrix<double, 6, 6> t_pose_block;
+typedef Eigen::Matrix<double, 6, 3> t_pose_point_block;
+typedef Eigen::Matrix<double, 6, 1> t_pose_vector;
+
+struct CameraState
+{
+    Eigen::Quaterniond orientation; // camera -> world
+    Eigen::Vector3d position;
+    Eigen::Matrix3d world_to_camera; // transpose of the orientation matrix
+    int free_index; // -1 for fixed cameras
+
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+struct ObservationTerm
+{
+    Eigen::Vector3d residual; // pixel x, pixel y, weighted distance
+    Eigen::Matrix<double, 3, 6> pose_jacobian;
+    Eigen::Matrix3d point_jacobian;
+    double pixel_weight; // robust loss weights
+    double distance_weight;
+    double squared_pixel_error;
+    double cost;
+    bool bValid;
+
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+typedef std::vector<CameraState, Eigen::aligned_allocator<CameraState> > t_camera_state_list;
+typedef std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d> > t_point_list;
+
+//-- prototypes -----
+static void fit_rigid_transform(
+    const t_point_list &from, const t_point_list &to,
+    Eigen::Quaterniond &out_orientation, Eigen::Vector3d &out_position);
+static Eigen::Matrix3d skew_symmetric(const Eigen::Vector3d &v);
+static double robust_cost(const double error, const double threshold, double *out_weight);
+static void compute_observation_term(
+    const EigenBundleAdjustmentCamera &camera, const CameraState &camera_state,
+    const Eigen::Vector3d &point, const EigenBundleAdjustmentObservation &observation,
+    const EigenBundleAdjustmentSettings &settings, const bool bWantJacobians,
+    ObservationTerm &out_term);
+static double compute_total_cost(
+    const EigenBundleAdjustmentCamera *cameras, const t_camera_state_list &camera_states,
+    const t_point_list &points,
+    const EigenBundleAdjustmentObservation *observations, const int observation_count,
+    const EigenBundleAdjustmentSettings &settings,
+    double *out_rms_reprojection_error, int *out_valid_count);
+
+//-- public methods -----
+bool
+eigen_bundle_adjustment_initialize(
+    EigenBundleAdjustmentCamera *cameras, const int camera_count,
+    const EigenBundleAdjustmentObservation *observations, const int observation_count,
+    Eigen::Vector3f *out_points, const int point_count,
+    const int min_shared_points)
+{
+    std::vector<bool> placed_cameras(camera_count, false);
+    std::vector<int> point_sample_counts(point_count, 0);
+    t_point_list point_sums(point_count, Eigen::Vector3d::Zero());
+    int unplaced_camera_count = 0;
+
+    for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+    {
+        placed_cameras[camera_index] = cameras[camera_index].bFixed;
+        unplaced_camera_count += cameras[camera_index].bFixed ? 0 : 1;
+    }
+
+    // Every placed camera contributes its view of a point to the point's world position estimate
+    auto add_camera_observations = [&](const int camera_index) {
+        const EigenBundleAdjustmentCamera &camera = cameras[camera_index];
+        const Eigen::Quaterniond orientation = camera.orientation.cast<double>();
+        const Eigen::Vector3d position = camera.position.cast<double>();
+
+        for (int observation_index = 0; observation_index < observation_count; ++observation_index)
+        {
+            const EigenBundleAdjustmentObservation &observation = observations[observation_index];
+
+            if (observation.camera_index == camera_index &&
+                observation.point_index >= 0 && observation.point_index < point_count)
+            {
+                point_sums[observation.point_index] +=
+                    orientation*observation.camera_relative_position.cast<double>() + position;
+                ++point_sample_counts[observation.point_index];
+            }
+        }
+    };
+
+    for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+    {
+        if (placed_cameras[camera_index])
+        {
+            add_camera_observations(camera_index);
+        }
+    }
+
+    while (unplaced_camera_count > 0)
+    {
+        // Place the camera that sees the most of the points placed so far
+        int best_camera_index = -1;
+        t_point_list best_from, best_to;
+
+        for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+        {
+            if (placed_cameras[camera_index])
+                continue;
+
+            t_point_list from, to;
+            for (int observation_index = 0; observation_index < observation_count; ++observation_index)
+            {
+                const EigenBundleAdjustmentObservation &observation = observations[observation_index];
+
+                if (observation.camera_index == camera_index &&
+                    observation.point_index >= 0 && observation.point_index < point_count &&
+                    point_sample_counts[observation.point_index] > 0)
+                {
+                    from.push_back(observation.camera_relative_position.cast<double>());
+                    to.push_back(
+                        point_sums[observation.point_index] / static_cast<double>(point_sample_counts[observation.point_index]));
+                }
+            }
+
+            if (static_cast<int>(from.size()) >= std::max(min_shared_points, 3) && from.size() > best_from.size())
+            {
+                best_camera_index = camera_index;
+                best_from.swap(from);
+                best_to.swap(to);
+            }
+        }
+
+        if (best_camera_index == -1)
+        {
+            break;
+        }
+
+        Eigen::Quaterniond orientation;
+        Eigen::Vector3d position;
+        fit_rigid_transform(best_from, best_to, orientation, position);
+
+        cameras[best_camera_index].orientation = orientation.cast<float>();
+        cameras[best_camera_index].position = position.cast<float>();
+        placed_cameras[best_camera_index] = true;
+        --unplaced_camera_count;
+
+        add_camera_observations(best_camera_index);
+    }
+
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        if (point_sample_counts[point_index] > 0)
+        {
+            out_points[point_index] =
+                (point_sums[point_index] / static_cast<double>(point_sample_counts[point_index])).cast<float>();
+        }
+        else
+        {
+            out_points[point_index] = Eigen::Vector3f::Zero();
+        }
+    }
+
+    return unplaced_camera_count == 0;
+}
+
+bool
+eigen_bundle_adjustment_solve(
+    EigenBundleAdjustmentCamera *cameras, const int camera_count,
+    Eigen::Vector3f *out_points, const int point_count,
+    const EigenBundleAdjustmentObservation *observations, const int observation_count,
+    const EigenBundleAdjustmentSettings &settings,
+    EigenBundleAdjustmentResult *out_result)
+{
+    out_result->clear();
+
+    // Validate the problem and index the free cameras
+    t_camera_state_list camera_states(camera_count);
+    int free_camera_count = 0;
+
+    for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+    {
+        const EigenBundleAdjustmentCamera &camera = cameras[camera_index];
+        CameraState &state = camera_states[camera_index];
+
+        state.orientation = camera.orientation.cast<double>().normalized();
+        state.position = camera.position.cast<double>();
+        state.world_to_camera = state.orientation.toRotationMatrix().transpose();
+        state.free_index = camera.bFixed ? -1 : free_camera_count++;
+    }
+
+    if (free_camera_count == camera_count)
+    {
+        // Nothing anchors the world frame
+        return false;
+    }
+
+    std::vector<std::vector<int> > point_observations(point_count);
+    for (int observation_index = 0; observation_index < observation_count; ++observation_index)
+    {
+        const EigenBundleAdjustmentObservation &observation = observations[observation_index];
+
+        if (observation.camera_index < 0 || observation.camera_index >= camera_count ||
+            observation.point_index < 0 || observation.point_index >= point_count)
+        {
+            return false;
+        }
+
+        point_observations[observation.point_index].push_back(observation_index);
+    }
+
+    t_point_list points(point_count);
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        points[point_index] = out_points[point_index].cast<double>();
+    }
+
+    double rms_reprojection_error = 0.0;
+    int valid_count = 0;
+    double cost = compute_total_cost(
+        cameras, camera_states, points, observations, observation_count, settings,
+        &rms_reprojection_error, &valid_count);
+    out_result->initial_rms_reprojection_error = static_cast<float>(rms_reprojection_error);
+    out_result->final_rms_reprojection_error = static_cast<float>(rms_reprojection_error);
+
+    const int reduced_size = 6 * free_camera_count;
+    std::vector<ObservationTerm, Eigen::aligned_allocator<ObservationTerm> > terms(observation_count);
+    std::vector<t_pose_block, Eigen::aligned_allocator<t_pose_block> > pose_blocks(free_camera_count);
+    std::vector<t_pose_vector, Eigen::aligned_allocator<t_pose_vector> > pose_gradients(free_camera_count);
+    std::vector<t_pose_point_block, Eigen::aligned_allocator<t_pose_point_block> > pose_point_blocks(observation_count);
+    std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> > point_blocks(point_count);
+    t_point_list point_gradients(point_count);
+    std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> > inv_point_blocks(point_count);
+    std::vector<bool> point_constrained(point_count);
+    Eigen::MatrixXd reduced_system(reduced_size, reduced_size);
+    Eigen::VectorXd reduced_rhs(reduced_size);
+    Eigen::VectorXd pose_step(reduced_size);
+    t_point_list point_steps(point_count);
+    double damping = k_initial_damping;
+
+    while (out_result->iterations < settings.max_iterations && !out_result->bConverged)
+    {
+        ++out_result->iterations;
+
+        // Linearize every observation and accumulate the normal equation blocks
+        std::fill(pose_blocks.begin(), pose_blocks.end(), t_pose_block::Zero());
+        std::fill(pose_gradients.begin(), pose_gradients.end(), t_pose_vector::Zero());
+        std::fill(point_blocks.begin(), point_blocks.end(), Eigen::Matrix3d::Zero());
+        std::fill(point_gradients.begin(), point_gradients.end(), Eigen::Vector3d::Zero());
+
+        for (int observation_index = 0; observation_index < observation_count; ++observation_index)
+        {
+            const EigenBundleAdjustmentObservation &observation = observations[observation_index];
+            const CameraState &camera_state = camera_states[observation.camera_index];
+            ObservationTerm &term = terms[observation_index];
+
+            compute_observation_term(
+                cameras[observation.camera_index], camera_state,
+                points[observation.point_index], observation, settings, true, term);
+
+            if (!term.bValid)
+                continue;
+
+            const Eigen::Vector3d weights(term.pixel_weight, term.pixel_weight, term.distance_weight);
+            const Eigen::Matrix<double, 3, 6> weighted_pose_jacobian = weights.asDiagonal() * term.pose_jacobian;
+            const Eigen::Matrix3d weighted_point_jacobian = weights.asDiagonal() * term.point_jacobian;
+
+            point_blocks[observation.point_index] += term.point_jacobian.transpose() * weighted_point_jacobian;
+            point_gradients[observation.point_index] += weighted_point_jacobian.transpose() * term.residual;
+
+            if (camera_state.free_index != -1)
+            {
+                pose_blocks[camera_state.free_index] += term.pose_jacobian.transpose() * weighted_pose_jacobian;
+                pose_gradients[camera_state.free_index] += weighted_pose_jacobian.transpose() * term.residual;
+                pose_point_blocks[observation_index] = weighted_pose_jacobian.transpose() * term.point_jacobian;
+            }
+        }
+
+        // Retry the step with more damping until it lowers the cost
+        bool bStepAccepted = false;
+        while (!bStepAccepted && damping < k_max_damping)
+        {
+            // Eliminate the points: S = U - W V^-1 W^T, b = -g_c + W V^-1 g_p
+            reduced_system.setZero();
+            reduced_rhs.setZero();
+
+            for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+            {
+                const int free_index = camera_states[camera_index].free_index;
+
+                if (free_index != -1)
+                {
+                    t_pose_block damped_block = pose_blocks[free_index];
+                    damped_block.diagonal() += damping * (pose_blocks[free_index].diagonal().array() + 1e-6).matrix();
+
+                    reduced_system.block<6, 6>(6 * free_index, 6 * free_index) = damped_block;
+                    reduced_rhs.segment<6>(6 * free_index) = -pose_gradients[free_index];
+                }
+            }
+
+            for (int point_index = 0; point_index < point_count; ++point_index)
+            {
+                Eigen::Matrix3d damped_block = point_blocks[point_index];
+                damped_block.diagonal() += damping * (point_blocks[point_index].diagonal().array() + 1e-6).matrix();
+
+                point_constrained[point_index] = point_blocks[point_index].trace() > 0.0;
+                if (!point_constrained[point_index])
+                {
+                    inv_point_blocks[point_index].setZero();
+                    continue;
+                }
+
+                inv_point_blocks[point_index] = damped_block.inverse();
+
+                const std::vector<int> &observation_indices = point_observations[point_index];
+                const Eigen::Vector3d inv_point_gradient = inv_point_blocks[point_index] * point_gradients[point_index];
+
+                for (int observation_index : observation_indices)
+                {
+                    const int free_index = camera_states[observations[observation_index].camera_index].free_index;
+
+                    if (free_index == -1 || !terms[observation_index].bValid)
+                        continue;
+
+                    const t_pose_point_block &pose_point_block = pose_point_blocks[observation_index];
+                    const t_pose_point_block scaled_block = pose_point_block * inv_point_blocks[point_index];
+
+                    reduced_rhs.segment<6>(6 * free_index) += pose_point_block * inv_point_gradient;
+
+                    for (int other_observation_index : observation_indices)
+                    {
+                        const int other_free_index =
+                            camera_states[observations[other_observation_index].camera_index].free_index;
+
+                        if (other_free_index == -1 || !terms[other_observation_index].bValid)
+                            continue;
+
+                        reduced_system.block<6, 6>(6 * free_index, 6 * other_free_index) -=
+                            scaled_block * pose_point_blocks[other_observation_index].transpose();
+                    }
+                }
+            }
+
+            pose_step = reduced_system.ldlt().solve(reduced_rhs);
+
+            // Back substitute the point steps: dp = V^-1 (-g_p - W^T dc)
+            for (int point_index = 0; point_index < point_count; ++point_index)
+            {
+                Eigen::Vector3d rhs = -point_gradients[point_index];
+
+                if (point_constrained[point_index])
+                {
+                    for (int observation_index : point_observations[point_index])
+                    {
+                        const int free_index = camera_states[observations[observation_index].camera_index].free_index;
+
+                        if (free_index != -1 && terms[observation_index].bValid)
+                        {
+                            rhs -= pose_point_blocks[observation_index].transpose() * pose_step.segment<6>(6 * free_index);
+                        }
+                    }
+                }
+
+                point_steps[point_index] = inv_point_blocks[point_index] * rhs;
+            }
+
+            // Apply the step to a copy of the parameters
+            t_camera_state_list new_camera_states = camera_states;
+            t_point_list new_points = points;
+
+            for (CameraState &state : new_camera_states)
+            {
+                if (state.free_index == -1)
+                    continue;
+
+                const Eigen::Vector3d rotation_step = pose_step.segment<3>(6 * state.free_index);
+                const double angle = rotation_step.norm();
+
+                if (angle > 0.0)
+                {
+                    state.orientation = (state.orientation * Eigen::Quaterniond(Eigen::AngleAxisd(angle, rotation_step / angle))).normalized();
+                    state.world_to_camera = state.orientation.toRotationMatrix().transpose();
+                }
+                state.position += pose_step.segment<3>(6 * state.free_index + 3);
+            }
+
+            for (int point_index = 0; point_index < point_count; ++point_index)
+            {
+                new_points[point_index] += point_steps[point_index];
+            }
+
+            double new_rms_reprojection_error = 0.0;
+            int new_valid_count = 0;
+            const double new_cost = compute_total_cost(
+                cameras, new_camera_states, new_points, observations, observation_count, settings,
+                &new_rms_reprojection_error, &new_valid_count);
+
+            // Moving points behind a camera would drop their residuals, which isn't an improvement
+            if (new_cost < cost && new_valid_count >= valid_count)
+            {
+                out_result->bConverged = (cost - new_cost) <= static_cast<double>(settings.convergence_tolerance) * cost;
+
+                camera_states.swap(new_camera_states);
+                points.swap(new_points);
+                cost = new_cost;
+                valid_count = new_valid_count;
+                rms_reprojection_error = new_rms_reprojection_error;
+                damping = std::max(damping * 0.1, k_min_damping);
+                bStepAccepted = true;
+            }
+            else
+            {
+                damping *= 10.0;
+            }
+        }
+
+        if (!bStepAccepted)
+        {
+            // No step lowers the cost, we're at a minimum
+            out_result->bConverged = true;
+        }
+
+        out_result->final_rms_reprojection_error = static_cast<float>(rms_reprojection_error);
+
+        if (settings.progress_callback &&
+            !settings.progress_callback(out_result->iterations, out_result->final_rms_reprojection_error))
+        {
+            out_result->bCanceled = true;
+            break;
+        }
+    }
+
+    for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+    {
+        if (!cameras[camera_index].bFixed)
+        {
+            cameras[camera_index].orientation = camera_states[camera_index].orientation.cast<float>();
+            cameras[camera_index].position = camera_states[camera_index].position.cast<float>();
+        }
+    }
+
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        out_points[point_index] = points[point_index].cast<float>();
+    }
+
+    return !out_result->bCanceled;
+}
+
+float
+eigen_bundle_adjustment_compute_rms_reprojection_error(
+    const EigenBundleAdjustmentCamera *cameras, const int camera_count,
+    const Eigen::Vector3f *points, const int point_count,
+    const EigenBundleAdjustmentObservation *observations, const int observation_count)
+{
+    t_camera_state_list camera_states(camera_count);
+    for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+    {
+        CameraState &state = camera_states[camera_index];
+
+        state.orientation = cameras[camera_index].orientation.cast<double>().normalized();
+        state.position = cameras[camera_index].position.cast<double>();
+        state.world_to_camera = state.orientation.toRotationMatrix().transpose();
+        state.free_index = -1;
+    }
+
+    t_point_list point_list(point_count);
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        point_list[point_index] = points[point_index].cast<double>();
+    }
+
+    EigenBundleAdjustmentSettings settings;
+    settings.distance_weight = 0.f;
+
+    double rms_reprojection_error = 0.0;
+    int valid_count = 0;
+    compute_total_cost(
+        cameras, camera_states, point_list, observations, observation_count, settings,
+        &rms_reprojection_error, &valid_count);
+
+    return static_cast<float>(rms_reprojection_error);
+}
+
+//-- private methods -----
+// Least squares rotation and translation mapping the from points onto the to points (Kabsch)
+static void fit_rigid_transform(
+    const t_point_list &from, const t_point_list &to,
+    Eigen::Quaterniond &out_orientation, Eigen::Vector3d &out_position)
+{
+    const double count = static_cast<double>(from.size());
+    Eigen::Vector3d from_centroid = Eigen::Vector3d::Zero();
+    Eigen::Vector3d to_centroid = Eigen::Vector3d::Zero();
+
+    for (size_t index = 0; index < from.size(); ++index)
+    {
+        from_centroid += from[index];
+        to_centroid += to[index];
+    }
+    from_centroid /= count;
+    to_centroid /= count;
+
+    Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+    for (size_t index = 0; index < from.size(); ++index)
+    {
+        covariance += (from[index] - from_centroid) * (to[index] - to_centroid).transpose();
+    }
+
+    Eigen::JacobiSVD<Eigen::Matrix3d> svd(covariance, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Eigen::Matrix3d correction = Eigen::Matrix3d::Identity();
+    correction(2, 2) = (svd.matrixV() * svd.matrixU().transpose()).determinant() < 0.0 ? -1.0 : 1.0;
+
+    const Eigen::Matrix3d rotation = svd.matrixV() * correction * svd.matrixU().transpose();
+
+    out_orientation = Eigen::Quaterniond(rotation).normalized();
+    out_position = to_centroid - rotation * from_centroid;
+}
+
+static Eigen::Matrix3d skew_symmetric(const Eigen::Vector3d &v)
+{
+    Eigen::Matrix3d result;
+    result <<
+        0.0, -v.z(), v.y(),
+        v.z(), 0.0, -v.x(),
+        -v.y(), v.x(), 0.0;
+
+    return result;
+}
+
+// Huber loss of an error, along with the weight that turns it into a least squares term
+static double robust_cost(const double error, const double threshold, double *out_weight)
+{
+    if (threshold <= 0.0 || error <= threshold)
+    {
+        *out_weight = 1.0;
+        return error * error;
+    }
+    else
+    {
+        *out_weight = threshold / error;
+        return 2.0 * threshold * error - threshold * threshold;
+    }
+}
+
+static void compute_observation_term(
+    const EigenBundleAdjustmentCamera &camera, const CameraState &camera_state,
+    const Eigen::Vector3d &point, const EigenBundleAdjustmentObservation &observation,
+    const EigenBundleAdjustmentSettings &settings, const bool bWantJacobians,
+    ObservationTerm &out_term)
+{
+    const Eigen::Vector3d camera_point = camera_state.world_to_camera * (point - camera_state.position);
+    const double fx = camera.focal_length_x;
+    const double fy = camera.focal_length_y;
+    const double x = camera_point.x();
+    const double y = camera_point.y();
+    const double z = camera_point.z();
+
+    out_term.bValid = z > k_min_camera_depth;
+    if (!out_term.bValid)
+    {
+        return;
+    }
+
+    // Pixel residual
+    out_term.residual.x() = fx * x / z + camera.principal_x - observation.pixel.x();
+    out_term.residual.y() = -fy * y / z + camera.principal_y - observation.pixel.y();
+    out_term.squared_pixel_error = out_term.residual.head<2>().squaredNorm();
+    out_term.cost = robust_cost(
+        sqrt(out_term.squared_pixel_error), settings.robust_threshold, &out_term.pixel_weight);
+
+    // Distance residual
+    const double observed_distance = observation.camera_relative_position.cast<double>().norm();
+    const double distance = camera_point.norm();
+    const bool bHasDistance = settings.distance_weight > 0.f && observed_distance > 0.0;
+
+    if (bHasDistance)
+    {
+        out_term.residual.z() = settings.distance_weight * (distance - observed_distance);
+        out_term.cost += robust_cost(fabs(out_term.residual.z()), settings.robust_threshold, &out_term.distance_weight);
+    }
+    else
+    {
+        out_term.residual.z() = 0.0;
+        out_term.distance_weight = 0.0;
+    }
+
+    if (!bWantJacobians)
+    {
+        return;
+    }
+
+    // d(residual)/d(camera point)
+    Eigen::Matrix3d projection_jacobian;
+    projection_jacobian.row(0) << fx / z, 0.0, -fx * x / (z * z);
+    projection_jacobian.row(1) << 0.0, -fy / z, fy * y / (z * z);
+    if (bHasDistance)
+    {
+        projection_jacobian.row(2) = settings.distance_weight * camera_point.transpose() / distance;
+    }
+    else
+    {
+        projection_jacobian.row(2).setZero();
+    }
+
+    // The camera orientation is perturbed in camera space: R' = R * exp(dtheta)
+    out_term.pose_jacobian.block<3, 3>(0, 0) = projection_jacobian * skew_symmetric(camera_point);
+    out_term.pose_jacobian.block<3, 3>(0, 3) = -projection_jacobian * camera_state.world_to_camera;
+    out_term.point_jacobian = projection_jacobian * camera_state.world_to_camera;
+}
+
+static double compute_total_cost(
+    const EigenBundleAdjustmentCamera *cameras, const t_camera_state_list &camera_states,
+    const t_point_list &points,
+    const EigenBundleAdjustmentObservation *observations, const int observation_count,
+    const EigenBundleAdjustmentSettings &settings,
+    double *out_rms_reprojection_error, int *out_valid_count)
+{
+    double total_cost = 0.0;
+    double total_squared_pixel_error = 0.0;
+    int valid_count = 0;
+    ObservationTerm term;
+
+    for (int observation_index = 0; observation_index < observation_count; ++observation_index)
+    {
+        const EigenBundleAdjustmentObservation &observation = observations[observation_index];
+
+        compute_observation_term(
+            cameras[observation.camera_index], camera_states[observation.camera_index],
+            points[observation.point_index], observation, settings, false, term);
+
+        if (term.bValid)
+        {
+            total_cost += term.cost;
+            total_squared_pixel_error += term.squared_pixel_error;
+            ++valid_count;
+        }
+    }
+
+    *out_valid_count = valid_count;
+    *out_rms_reprojection_error =
+        (valid_count > 0) ? sqrt(total_squared_pixel_error / static_cast<double>(valid_count)) : 0.0;
+
+    return total_cost;
+}
@@ -0,0 +1,110 @@
+#ifndef MATH_BUNDLE_ADJUSTMENT_H
+#define MATH_BUNDLE_ADJUSTMENT_H
+
+//-- includes -----
+#include "MathEigen.h"
+#include <functional>
+
+//-- structs -----
+// A pinhole camera in the tracker conventions:
+// camera relative +X is right, +Y is up, +Z is into the view and screen +Y is down.
+// Undistorted pixel locations project as (fx*x/z + px, -fy*y/z + py).
+struct EigenBundleAdjustmentCamera
+{
+    Eigen::Quaternionf orientation; // camera -> world rotation
+    Eigen::Vector3f position; // camera center in world space
+    float focal_length_x, focal_length_y;
+    float principal_x, principal_y;
+    bool bFixed; // held at its initial pose, anchors the world frame
+
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+// One sighting of a point by a camera
+struct EigenBundleAdjustmentObservation
+{
+    int camera_index;
+    int point_index;
+    Eigen::Vector2f pixel; // undistorted pixel location
+    Eigen::Vector3f camera_relative_position; // e.g. from a sphere fit, its length constrains the scale
+
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+struct EigenBundleAdjustmentSettings
+{
+    int max_iterations;
+    // Pixels of residual per unit of error in the camera relative distance of a point
+    float distance_weight;
+    // Residuals (in pixels) larger than this are down weighted (Huber loss)
+    float robust_threshold;
+    // Stop once an iteration reduces the cost by less than this fraction
+    float convergence_tolerance;
+    // Called after every iteration with the current RMS reprojection error in pixels.
+    // Return false to cancel the solve.
+    std::function<bool(int iteration, float rms_reprojection_error)> progress_callback;
+
+    EigenBundleAdjustmentSettings()
+        : max_iterations(100)
+        , distance_weight(1.f)
+        , robust_threshold(4.f)
+        , convergence_tolerance(1e-6f)
+        , progress_callback()
+    {}
+};
+
+struct EigenBundleAdjustmentResult
+{
+    int iterations;
+    float initial_rms_reprojection_error;
+    float final_rms_reprojection_error;
+    bool bConverged;
+    bool bCanceled;
+
+    void clear()
+    {
+        iterations = 0;
+        initial_rms_reprojection_error = 0.f;
+        final_rms_reprojection_error = 0.f;
+        bConverged = false;
+        bCanceled = false;
+    }
+};
+
+//-- interface -----
+// Computes an initial pose for every camera that isn't fixed and a world position for every point.
+// Starting from the fixed cameras, each remaining camera is rigidly aligned to the points
+// already placed by the cameras it shares the most observations with.
+// Returns false if some camera can't be reached from a fixed camera
+// through at least min_shared_points shared observations.
+bool
+eigen_bundle_adjustment_initialize(
+    EigenBundleAdjustmentCamera *cameras, const int camera_count,
+    const EigenBundleAdjustmentObservation *observations, const int observation_count,
+    Eigen::Vector3f *out_points, const int point_count,
+    const int min_shared_points);
+
+// Jointly refines the camera poses and point positions with Levenberg-Marquardt,
+// minimizing the reprojection error (plus the weighted camera relative distance error).
+// The point blocks are eliminated with the Schur complement, so each iteration only
+// factors a dense system of 6 unknowns per camera.
+// Returns false if the problem is badly posed (no fixed camera, invalid indices)
+// or the solve was canceled.
+bool
+eigen_bundle_adjustment_solve(
+    EigenBundleAdjustmentCamera *cameras, const int camera_count,
+    Eigen::Vector3f *points, const int point_count,
+    const EigenBundleAdjustmentObservation *observations, const int observation_count,
+    const EigenBundleAdjustmentSettings &settings,
+    EigenBundleAdjustmentResult *out_result);
+
+// RMS of the pixel reprojection error over all observations in front of their camera
+float
+eigen_bundle_adjustment_compute_rms_reprojection_error(
+    const EigenBundleAdjustmentCamera *cameras, const int camera_count,
+    const Eigen::Vector3f *points, const int point_count,
+    const EigenBundleAdjustmentObservation *observations, const int observation_count);
+
+#endif // MATH_BUNDLE_ADJUSTMENT_H
@@ -0,0 +1,325 @@
+//-- includes -----
+#include "MathPlanarPose.h"
+#include "MathUtility.h"
+#include "Eigen/Dense"
+#include "Eigen/SVD"
+
+#include <algorithm>
+#include <vector>
+
+//-- constants -----
+static const double k_min_homography_scale = 1e-9;
+static const double k_min_point_depth = 1e-6;
+
+//-- prototypes -----
+static bool compute_homography(
+    const Eigen::Vector2d *model_points, const Eigen::Vector2d *image_points, const int point_count,
+    Eigen::Matrix3d &out_homography);
+static void compute_rotations(
+    const Eigen::Matrix2d &J, const Eigen::Vector2d &v,
+    Eigen::Matrix3d &out_rotation_1, Eigen::Matrix3d &out_rotation_2);
+static bool compute_translation(
+    const Eigen::Matrix3d &rotation,
+    const Eigen::Vector2d *model_points, const Eigen::Vector2d *image_points, const int point_count,
+    Eigen::Vector3d &out_translation);
+
+//-- public interface -----
+bool
+eigen_planar_pose_solve_ippe(
+    const Eigen::Vector2f *model_points,
+    const Eigen::Vector2f *image_points,
+    const int point_count,
+    EigenPlanarPoseSolution out_solutions[2])
+{
+    if (point_count < 4)
+    {
+        return false;
+    }
+
+    // Work relative to the model centroid, IPPE solves for the pose at the model origin
+    Eigen::Vector2d model_center = Eigen::Vector2d::Zero();
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        model_center += model_points[point_index].cast<double>();
+    }
+    model_center /= static_cast<double>(point_count);
+
+    std::vector<Eigen::Vector2d> centered_model_points(point_count);
+    std::vector<Eigen::Vector2d> image_points_d(point_count);
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        centered_model_points[point_index] = model_points[point_index].cast<double>() - model_center;
+        image_points_d[point_index] = image_points[point_index].cast<double>();
+    }
+
+    // Homography from the centered model plane to the image, scaled so that H(2,2) = 1.
+    // The model origin then projects to (H(0,2), H(1,2)) in front of the camera.
+    Eigen::Matrix3d H;
+    if (!compute_homography(centered_model_points.data(), image_points_d.data(), point_count, H))
+    {
+        return false;
+    }
+
+    // Jacobian of the homography at the model origin
+    const Eigen::Vector2d v(H(0, 2), H(1, 2));
+    Eigen::Matrix2d J;
+    J(0, 0) = H(0, 0) - H(2, 0)*H(0, 2);
+    J(0, 1) = H(0, 1) - H(2, 1)*H(0, 2);
+    J(1, 0) = H(1, 0) - H(2, 0)*H(1, 2);
+    J(1, 1) = H(1, 1) - H(2, 1)*H(1, 2);
+
+    Eigen::Matrix3d rotations[2];
+    compute_rotations(J, v, rotations[0], rotations[1]);
+
+    int valid_count = 0;
+    for (int solution_index = 0; solution_index < 2; ++solution_index)
+    {
+        Eigen::Vector3d translation;
+
+        if (compute_translation(
+                rotations[solution_index],
+                centered_model_points.data(), image_points_d.data(), point_count,
+                translation))
+        {
+            // Move the translation from the model centroid back to the model origin
+            const Eigen::Vector3d model_center_3d(model_center.x(), model_center.y(), 0.0);
+            EigenPlanarPoseSolution &solution = out_solutions[valid_count];
+
+            solution.rotation = rotations[solution_index].cast<float>();
+            solution.translation = (translation - rotations[solution_index] * model_center_3d).cast<float>();
+            solution.reprojection_error =
+                eigen_planar_pose_compute_reprojection_error(
+                    solution.rotation, solution.translation, model_points, image_points, point_count);
+
+            if (solution.reprojection_error < k_real_max)
+            {
+                ++valid_count;
+            }
+        }
+    }
+
+    if (valid_count == 0)
+    {
+        return false;
+    }
+
+    if (valid_count == 1)
+    {
+        // The other pose puts the target behind the camera, report the valid one twice
+        out_solutions[1] = out_solutions[0];
+    }
+    else if (out_solutions[1].reprojection_error < out_solutions[0].reprojection_error)
+    {
+        std::swap(out_solutions[0], out_solutions[1]);
+    }
+
+    return true;
+}
+
+float
+eigen_planar_pose_compute_reprojection_error(
+    const Eigen::Matrix3f &rotation,
+    const Eigen::Vector3f &translation,
+    const Eigen::Vector2f *model_points,
+    const Eigen::Vector2f *image_points,
+    const int point_count)
+{
+    double squared_error_sum = 0.0;
+
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        const Eigen::Vector2f &model_point = model_points[point_index];
+        const Eigen::Vector3f camera_point =
+            rotation.col(0)*model_point.x() + rotation.col(1)*model_point.y() + translation;
+
+        if (camera_point.z() <= k_min_point_depth)
+        {
+            return k_real_max;
+        }
+
+        const Eigen::Vector2f projection(camera_point.x() / camera_point.z(), camera_point.y() / camera_point.z());
+
+        squared_error_sum += (projection - image_points[point_index]).squaredNorm();
+    }
+
+    return (point_count > 0) ? static_cast<float>(sqrt(squared_error_sum / static_cast<double>(point_count))) : 0.f;
+}
+
+//-- private functions -----
+static bool compute_homography(
+    const Eigen::Vector2d *model_points, const Eigen::Vector2d *image_points, const int point_count,
+    Eigen::Matrix3d &out_homography)
+{
+    // Normalize both point sets (Hartley) so the DLT is well conditioned
+    Eigen::Vector2d model_center = Eigen::Vector2d::Zero();
+    Eigen::Vector2d image_center = Eigen::Vector2d::Zero();
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        model_center += model_points[point_index];
+        image_center += image_points[point_index];
+    }
+    model_center /= static_cast<double>(point_count);
+    image_center /= static_cast<double>(point_count);
+
+    double model_spread = 0.0;
+    double image_spread = 0.0;
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        model_spread += (model_points[point_index] - model_center).norm();
+        image_spread += (image_points[point_index] - image_center).norm();
+    }
+    model_spread /= static_cast<double>(point_count);
+    image_spread /= static_cast<double>(point_count);
+
+    if (model_spread < k_min_homography_scale || image_spread < k_min_homography_scale)
+    {
+        return false;
+    }
+
+    const double model_scale = sqrt(2.0) / model_spread;
+    const double image_scale = sqrt(2.0) / image_spread;
+
+    // Each correspondence adds two rows to the DLT system A*h = 0.
+    // Accumulate A^T*A directly, its smallest eigenvector is the least squares h.
+    Eigen::Matrix<double, 9, 9> AtA = Eigen::Matrix<double, 9, 9>::Zero();
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        const Eigen::Vector2d m = (model_points[point_index] - model_center) * model_scale;
+        const Eigen::Vector2d p = (image_points[point_index] - image_center) * image_scale;
+
+        Eigen::Matrix<double, 9, 1> row_u, row_v;
+        row_u << m.x(), m.y(), 1.0, 0.0, 0.0, 0.0, -p.x()*m.x(), -p.x()*m.y(), -p.x();
+        row_v << 0.0, 0.0, 0.0, m.x(), m.y(), 1.0, -p.y()*m.x(), -p.y()*m.y(), -p.y();
+
+        AtA.noalias() += row_u * row_u.transpose();
+        AtA.noalias() += row_v * row_v.transpose();
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 9, 9> > eigen_solver(AtA);
+    if (eigen_solver.info() != Eigen::Success)
+    {
+        return false;
+    }
+
+    // Eigenvalues are sorted in increasing order
+    const Eigen::Matrix<double, 9, 1> h = eigen_solver.eigenvectors().col(0);
+    Eigen::Matrix3d H_normalized;
+    H_normalized << h(0), h(1), h(2), h(3), h(4), h(5), h(6), h(7), h(8);
+
+    // Undo the normalization: H = T_image^-1 * H_normalized * T_model
+    Eigen::Matrix3d T_model = Eigen::Matrix3d::Identity();
+    T_model(0, 0) = model_scale;
+    T_model(1, 1) = model_scale;
+    T_model(0, 2) = -model_scale * model_center.x();
+    T_model(1, 2) = -model_scale * model_center.y();
+
+    Eigen::Matrix3d T_image_inverse = Eigen::Matrix3d::Identity();
+    T_image_inverse(0, 0) = 1.0 / image_scale;
+    T_image_inverse(1, 1) = 1.0 / image_scale;
+    T_image_inverse(0, 2) = image_center.x();
+    T_image_inverse(1, 2) = image_center.y();
+
+    out_homography = T_image_inverse * H_normalized * T_model;
+
+    if (fabs(out_homography(2, 2)) < k_min_homography_scale)
+    {
+        // The model origin maps to infinity
+        return false;
+    }
+
+    out_homography /= out_homography(2, 2);
+
+    return true;
+}
+
+static void compute_rotations(
+    const Eigen::Matrix2d &J, const Eigen::Vector2d &v,
+    Eigen::Matrix3d &out_rotation_1, Eigen::Matrix3d &out_rotation_2)
+{
+    // Rotation taking the camera's +Z axis onto the ray through the projected model origin
+    const Eigen::Vector3d ray(v.x(), v.y(), 1.0);
+    const Eigen::Matrix3d Rv =
+        Eigen::Quaterniond::FromTwoVectors(Eigen::Vector3d::UnitZ(), ray).toRotationMatrix();
+
+    // Jacobian of the projection in the frame of that ray
+    Eigen::Matrix<double, 2, 3> projection_at_v;
+    projection_at_v << 1.0, 0.0, -v.x(), 0.0, 1.0, -v.y();
+    const Eigen::Matrix2d B = projection_at_v * Rv.leftCols<2>();
+    const Eigen::Matrix2d A = B.inverse() * J;
+
+    // The upper left 2x2 block of the rotation (in the ray's frame) is A scaled down
+    // by its largest singular value
+    const Eigen::Matrix2d AAt = A * A.transpose();
+    const double trace = AAt.trace();
+    const double discriminant = std::max(trace*trace - 4.0*AAt.determinant(), 0.0);
+    const double gamma = sqrt(0.5*(trace + sqrt(discriminant)));
+    const Eigen::Matrix2d R22 = A / gamma;
+
+    // Complete the first two rows to unit length, the sign of the second entry keeps them orthogonal
+    const double row_dot = R22(0, 0)*R22(1, 0) + R22(0, 1)*R22(1, 1);
+    const double b0 = sqrt(std::max(1.0 - R22(0, 0)*R22(0, 0) - R22(0, 1)*R22(0, 1), 0.0));
+    const double b1 = ((row_dot >= 0.0) ? -1.0 : 1.0) * sqrt(std::max(1.0 - R22(1, 0)*R22(1, 0) - R22(1, 1)*R22(1, 1), 0.0));
+
+    // The two solutions only differ by the sign of the third column's upper entries
+    for (int solution_index = 0; solution_index < 2; ++solution_index)
+    {
+        const double sign = (solution_index == 0) ? 1.0 : -1.0;
+        const Eigen::Vector3d row0(R22(0, 0), R22(0, 1), sign*b0);
+        const Eigen::Vector3d row1(R22(1, 0), R22(1, 1), sign*b1);
+
+        Eigen::Matrix3d R_tilde;
+        R_tilde.row(0) = row0.transpose();
+        R_tilde.row(1) = row1.transpose();
+        R_tilde.row(2) = row0.cross(row1).transpose();
+
+        // Snap to the nearest rotation to remove the noise in the block scaling
+        Eigen::JacobiSVD<Eigen::Matrix3d> svd(R_tilde, Eigen::ComputeFullU | Eigen::ComputeFullV);
+        Eigen::Matrix3d R_tilde_orthonormal = svd.matrixU() * svd.matrixV().transpose();
+        if (R_tilde_orthonormal.determinant() < 0.0)
+        {
+            Eigen::Matrix3d U = svd.matrixU();
+            U.col(2) = -U.col(2);
+            R_tilde_orthonormal = U * svd.matrixV().transpose();
+        }
+
+        Eigen::Matrix3d &out_rotation = (solution_index == 0) ? out_rotation_1 : out_rotation_2;
+        out_rotation = Rv * R_tilde_orthonormal;
+    }
+}
+
+static bool compute_translation(
+    const Eigen::Matrix3d &rotation,
+    const Eigen::Vector2d *model_points, const Eigen::Vector2d *image_points, const int point_count,
+    Eigen::Vector3d &out_translation)
+{
+    // Each point gives two linear constraints on t (cross multiplying the projection):
+    // (X + t).x - u*(X + t).z = 0
+    // (X + t).y - v*(X + t).z = 0
+    Eigen::Matrix3d AtA = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d Atb = Eigen::Vector3d::Zero();
+
+    for (int point_index = 0; point_index < point_count; ++point_index)
+    {
+        const Eigen::Vector2d &m = model_points[point_index];
+        const Eigen::Vector2d &p = image_points[point_index];
+        const Eigen::Vector3d X = rotation.col(0)*m.x() + rotation.col(1)*m.y();
+
+        const Eigen::Vector3d row_u(1.0, 0.0, -p.x());
+        const Eigen::Vector3d row_v(0.0, 1.0, -p.y());
+        const double b_u = p.x()*X.z() - X.x();
+        const double b_v = p.y()*X.z() - X.y();
+
+        AtA.noalias() += row_u * row_u.transpose() + row_v * row_v.transpose();
+        Atb += row_u*b_u + row_v*b_v;
+    }
+
+    Eigen::LDLT<Eigen::Matrix3d> ldlt(AtA);
+    if (ldlt.info() != Eigen::Success)
+    {
+        return false;
+    }
+
+    out_translation = ldlt.solve(Atb);
+
+    return out_translation.z() > k_min_point_depth;
+}
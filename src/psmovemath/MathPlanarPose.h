@@ -0,0 +1,49 @@
+#ifndef MATH_PLANAR_POSE_H
+#define MATH_PLANAR_POSE_H
+
+//-- includes -----
+#include "MathEigen.h"
+
+//-- structs -----
+// A pose of a planar target in the OpenCV camera conventions:
+// camera relative +X is right, +Y is down and +Z is into the view.
+struct EigenPlanarPoseSolution
+{
+    Eigen::Matrix3f rotation; // model -> camera rotation
+    Eigen::Vector3f translation; // model origin in camera space
+    float reprojection_error; // RMS, in normalized image units
+
+    void clear()
+    {
+        rotation = Eigen::Matrix3f::Identity();
+        translation = Eigen::Vector3f::Zero();
+        reprojection_error = 0.f;
+    }
+};
+
+//-- interface -----
+// Closed form pose of a planar target with Infinitesimal Plane-based Pose Estimation
+// (Collins and Bartoli, "Infinitesimal Plane-Based Pose Estimation", IJCV 2014).
+// The model points lie on the model's z=0 plane. The image points are normalized
+// (undistorted, principal point removed and divided by the focal length).
+// A planar target seen by a pinhole camera has two candidate poses (a mirrored tilt),
+// both are returned with the lowest reprojection error first.
+// Returns false if the points are degenerate (fewer than 4, collinear, or behind the camera).
+bool
+eigen_planar_pose_solve_ippe(
+    const Eigen::Vector2f *model_points,
+    const Eigen::Vector2f *image_points,
+    const int point_count,
+    EigenPlanarPoseSolution out_solutions[2]);
+
+// RMS reprojection error of the model points for the given pose, in normalized image units.
+// Returns k_real_max if any point lands behind the camera.
+float
+eigen_planar_pose_compute_reprojection_error(
+    const Eigen::Matrix3f &rotation,
+    const Eigen::Vector3f &translation,
+    const Eigen::Vector2f *model_points,
+    const Eigen::Vector2f *image_points,
+    const int point_count);
+
+#endif // MATH_PLANAR_POSE_H
@@ -9,14 +9,14 @@
 #define MAX_OUTPUT_DATA_FRAME_MESSAGE_SIZE 500
 #define MAX_INPUT_DATA_FRAME_MESSAGE_SIZE 64
 
-// See ControllerManager.h in PSMoveService
-#define PSMOVESERVICE_MAX_CONTROLLER_COUNT  5
+// Upper bound on the controller table size, see ControllerManager.h in PSMoveService
+#define PSMOVESERVICE_MAX_CONTROLLER_COUNT  32
 
-// See TrackerManager.h in PSMoveService
-#define PSMOVESERVICE_MAX_TRACKER_COUNT  8
+// Upper bound on the tracker table size, see TrackerManager.h in PSMoveService
+#define PSMOVESERVICE_MAX_TRACKER_COUNT  16
 
-// See HMDManager.h in PSMoveService
-#define PSMOVESERVICE_MAX_HMD_COUNT  4
+// Upper bound on the HMD table size, see HMDManager.h in PSMoveService
+#define PSMOVESERVICE_MAX_HMD_COUNT  8
  
 //-- pre-declarations -----
 namespace PSMoveProtocol
@@ -39,7 +39,7 @@ std::string show_hex(const CharContainer& c)
     return hex;
 }
 
-std::string show_hex(const uint8_t * c, unsigned length)
+inline std::string show_hex(const uint8_t * c, unsigned length)
 {
     std::string hex;
     char buf[16];
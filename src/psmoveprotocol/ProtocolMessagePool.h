@@ -0,0 +1,122 @@
+#ifndef PROTOCOL_MESSAGE_POOL_H
+#define PROTOCOL_MESSAGE_POOL_H
+
+//-- includes -----
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <boost/circular_buffer.hpp>
+
+//-- definitions -----
+/**
+ \brief A pool of reusable protocol buffer messages handed out as shared pointers.
+
+ \details A message is free again once the pool holds the only reference to it.
+ Free messages are Clear()ed before they are handed out again. Clear() keeps the
+ memory already allocated for sub-messages and strings. Once the pool has grown to
+ the number of messages in flight, allocating a message doesn't touch the heap.
+ Every heap allocation the pool makes is added to the given allocation counter.
+ Not thread safe.
+ */
+template <class MessageType>
+class ProtocolMessagePool
+{
+public:
+    typedef std::shared_ptr<MessageType> MessagePointer;
+
+    ProtocolMessagePool(size_t initial_message_count, int &allocation_count)
+        : m_messages()
+        , m_next_message_index(0)
+        , m_allocation_count(allocation_count)
+    {
+        m_messages.reserve(initial_message_count);
+        ++m_allocation_count;
+
+        for (size_t message_index = 0; message_index < initial_message_count; ++message_index)
+        {
+            m_messages.push_back(create_message());
+        }
+    }
+
+    /// Get a cleared message that nobody else references
+    MessagePointer allocate()
+    {
+        const size_t message_count = m_messages.size();
+
+        for (size_t attempt = 0; attempt < message_count; ++attempt)
+        {
+            MessagePointer &message = m_messages[m_next_message_index];
+
+            m_next_message_index = (m_next_message_index + 1) % message_count;
+
+            if (message.use_count() == 1)
+            {
+                message->Clear();
+                return message;
+            }
+        }
+
+        // Every message is still in flight, so grow the pool
+        if (m_messages.size() == m_messages.capacity())
+        {
+            ++m_allocation_count;
+        }
+        m_messages.push_back(create_message());
+
+        return m_messages.back();
+    }
+
+private:
+    MessagePointer create_message()
+    {
+        // One allocation for the message and one for the shared pointer control block
+        m_allocation_count += 2;
+
+        return MessagePointer(new MessageType);
+    }
+
+    std::vector<MessagePointer> m_messages;
+    size_t m_next_message_index;
+    int &m_allocation_count;
+};
+
+/**
+ \brief A FIFO queue of messages waiting to be sent.
+
+ \details Unlike std::deque, which allocates and frees blocks as elements are
+ pushed and popped, this queue only allocates when it has to grow.
+ Each time it grows the allocation counter is incremented.
+ */
+template <class MessagePointerType>
+class ProtocolMessageQueue
+{
+public:
+    ProtocolMessageQueue(size_t initial_capacity, int &allocation_count)
+        : m_queue(initial_capacity)
+        , m_allocation_count(allocation_count)
+    {
+        ++m_allocation_count;
+    }
+
+    void push_back(const MessagePointerType &message)
+    {
+        if (m_queue.full())
+        {
+            m_queue.set_capacity(std::max<size_t>(2 * m_queue.capacity(), 1));
+            ++m_allocation_count;
+        }
+
+        m_queue.push_back(message);
+    }
+
+    MessagePointerType &front() { return m_queue.front(); }
+    void pop_front() { m_queue.pop_front(); }
+    size_t size() const { return m_queue.size(); }
+    void clear() { m_queue.clear(); }
+
+private:
+    boost::circular_buffer<MessagePointerType> m_queue;
+    int &m_allocation_count;
+};
+
+#endif // PROTOCOL_MESSAGE_POOL_H
@@ -4,17 +4,20 @@
 #define PSMOVESERVICE_DEFAULT_ADDRESS   "localhost"
 #define PSMOVESERVICE_DEFAULT_PORT      "9512"
 
+// Pass as the host to run the service inside the client process (clients built with PSM_EMBEDDED_SERVICE)
+#define PSMOVESERVICE_EMBEDDED_ADDRESS  "embedded"
+
 #define MAX_OUTPUT_DATA_FRAME_MESSAGE_SIZE 500
 #define MAX_INPUT_DATA_FRAME_MESSAGE_SIZE 64
 
-// See ControllerManager.h in PSMoveService
-#define PSMOVESERVICE_MAX_CONTROLLER_COUNT  5
+// Upper bound on the controller table size, see ControllerManager.h in PSMoveService
+#define PSMOVESERVICE_MAX_CONTROLLER_COUNT  32
 
-// See TrackerManager.h in PSMoveService
-#define PSMOVESERVICE_MAX_TRACKER_COUNT  8
+// Upper bound on the tracker table size, see TrackerManager.h in PSMoveService
+#define PSMOVESERVICE_MAX_TRACKER_COUNT  16
 
-// See HMDManager.h in PSMoveService
-#define PSMOVESERVICE_MAX_HMD_COUNT  4
+// Upper bound on the HMD table size, see HMDManager.h in PSMoveService
+#define PSMOVESERVICE_MAX_HMD_COUNT  8
 
 // The max number of axes allowed on a virtual controller
 #define PSM_MAX_VIRTUAL_CONTROLLER_AXES  32
@@ -22,5 +25,11 @@
 // The max number of buttons allowed on a virtual controller
 #define PSM_MAX_VIRTUAL_CONTROLLER_BUTTONS  32
 
+// Upper bound on the number of service statistics sent to a client, see ServiceStatistics.h in PSMoveService
+#define PSMOVESERVICE_MAX_STATISTIC_COUNT  128
+
+// The max length of a service statistic name (including the terminator)
+#define PSMOVESERVICE_MAX_STATISTIC_NAME_LEN  48
+
  
 #endif  // SHARED_CONSTANTS_H
@@ -6,8 +6,6 @@
 #include "assert.h"
 #include "string.h"
 
-#include "gamepad/Gamepad.h"
-
 // -- private definitions -----
 #ifdef _MSC_VER
 #pragma warning (disable: 4996) // 'This function or variable may be unsafe': snprintf
@@ -36,7 +34,10 @@ GamepadAPIDeviceFilter g_supported_gamepad_infos[MAX_CONTROLLER_TYPE_INDEX] = {
 static bool is_gamepad_supported(
 	int gamepad_index, 
 	CommonDeviceState::eDeviceType device_type_filter,
+	GamepadSnapshot &out_snapshot,
 	CommonDeviceState::eDeviceType &out_device_type);
+static int get_gamepad_count();
+static void request_detect_devices();
 
 // -- ControllerGamepadEnumerator -----
 ControllerGamepadEnumerator::ControllerGamepadEnumerator()
@@ -46,7 +47,9 @@ ControllerGamepadEnumerator::ControllerGamepadEnumerator()
 	m_deviceType= CommonDeviceState::PSMove;
 	assert(m_deviceType >= 0 && GET_DEVICE_TYPE_INDEX(m_deviceType) < MAX_CONTROLLER_TYPE_INDEX);
 
-	Gamepad_detectDevices();
+	m_currentSnapshot.clear();
+
+	request_detect_devices();
 	next();
 }
 
@@ -59,18 +62,20 @@ ControllerGamepadEnumerator::ControllerGamepadEnumerator(
 	m_deviceTypeFilter= deviceTypeFilter;
 	assert(m_deviceType >= 0 && GET_DEVICE_TYPE_INDEX(m_deviceType) < MAX_CONTROLLER_TYPE_INDEX);
 
-	Gamepad_detectDevices();
+	m_currentSnapshot.clear();
+
+	request_detect_devices();
 	next();
 }
 
 int ControllerGamepadEnumerator::get_vendor_id() const
 {
-	return is_valid() ? Gamepad_deviceAtIndex(static_cast<unsigned int>(m_controllerIndex))->vendorID : -1;
+	return is_valid() ? m_currentSnapshot.vendorID : -1;
 }
 
 int ControllerGamepadEnumerator::get_product_id() const
 {
-	return is_valid() ? Gamepad_deviceAtIndex(static_cast<unsigned int>(m_controllerIndex))->productID : -1;
+	return is_valid() ? m_currentSnapshot.productID : -1;
 }
 
 const char *ControllerGamepadEnumerator::get_path() const
@@ -80,19 +85,19 @@ const char *ControllerGamepadEnumerator::get_path() const
 
 bool ControllerGamepadEnumerator::is_valid() const
 {
-	return m_controllerIndex < static_cast<int>(Gamepad_numDevices());
+	return m_controllerIndex < get_gamepad_count();
 }
 
 bool ControllerGamepadEnumerator::next()
 {
 	bool foundValid = false;
 
-	while (m_controllerIndex < static_cast<int>(Gamepad_numDevices()) && !foundValid)
+	while (m_controllerIndex < get_gamepad_count() && !foundValid)
 	{
 		++m_controllerIndex;
 
-		if (m_controllerIndex < static_cast<int>(Gamepad_numDevices()) && 
-			is_gamepad_supported(m_controllerIndex, m_deviceTypeFilter, m_deviceType))
+		if (m_controllerIndex < get_gamepad_count() && 
+			is_gamepad_supported(m_controllerIndex, m_deviceTypeFilter, m_currentSnapshot, m_deviceType))
 		{
 			ServerUtility::format_string(m_currentUSBPath, sizeof(m_currentUSBPath), "gamepad_%d", m_controllerIndex);		
 			foundValid = true;
@@ -106,14 +111,17 @@ bool ControllerGamepadEnumerator::next()
 static bool is_gamepad_supported(
 	int gamepad_index, 
 	CommonDeviceState::eDeviceType device_type_filter,
+	GamepadSnapshot &out_snapshot,
 	CommonDeviceState::eDeviceType &out_device_type)
 {
 	bool bIsValidDevice = false;
 
-	const Gamepad_device *devInfo= Gamepad_deviceAtIndex(static_cast<unsigned int>(gamepad_index));
+	GamepadPoller *gamepad_poller = GamepadPoller::getInstance();
 
-	if (devInfo != nullptr)
+	if (gamepad_poller != nullptr && gamepad_poller->fetchGamepadSnapshot(gamepad_index, out_snapshot))
 	{
+		const GamepadSnapshot *devInfo = &out_snapshot;
+
 		// See if the next filtered device is a controller type that we care about
 		for (int gamepad_type_index = 0; gamepad_type_index < MAX_CONTROLLER_TYPE_INDEX; ++gamepad_type_index)
 		{
@@ -144,3 +152,22 @@ static bool is_gamepad_supported(
 
 	return bIsValidDevice;
 }
+
+static int get_gamepad_count()
+{
+	GamepadPoller *gamepad_poller = GamepadPoller::getInstance();
+
+	return (gamepad_poller != nullptr) ? gamepad_poller->getGamepadCount() : 0;
+}
+
+static void request_detect_devices()
+{
+	GamepadPoller *gamepad_poller = GamepadPoller::getInstance();
+
+	// Detection runs on the gamepad poller thread,
+	// new gamepads show up in the snapshots by the next enumeration
+	if (gamepad_poller != nullptr)
+	{
+		gamepad_poller->requestDetectDevices();
+	}
+}
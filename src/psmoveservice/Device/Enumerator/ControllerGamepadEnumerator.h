@@ -3,6 +3,7 @@
 
 //-- includes -----
 #include "DeviceEnumerator.h"
+#include "GamepadPoller.h"
 #include "USBApiInterface.h"
 
 //-- definitions -----
@@ -25,6 +26,7 @@ public:
 private:
 	char m_currentUSBPath[256];
 	int m_controllerIndex;
+	GamepadSnapshot m_currentSnapshot;
 };
 
 #endif // CONTROLLER_GAMEPAD_DEVICE_ENUMERATOR_H
@@ -1,6 +1,8 @@
 // -- includes -----
 #include "TrackerDeviceEnumerator.h"
+#include "RemoteTracker.h"
 #include "ServerUtility.h"
+#include "TrackerNodeManager.h"
 #include "USBDeviceManager.h"
 #include "ServerLog.h"
 #include "assert.h"
@@ -26,16 +28,20 @@ USBDeviceFilter k_supported_tracker_infos[MAX_CAMERA_TYPE_INDEX] = {
 static bool is_tracker_supported(USBDeviceEnumerator* enumerator, CommonDeviceState::eDeviceType device_type_filter, CommonDeviceState::eDeviceType &out_device_type);
 
 // -- methods -----
-TrackerDeviceEnumerator::TrackerDeviceEnumerator()
+TrackerDeviceEnumerator::TrackerDeviceEnumerator(eAPIType api_type)
 	: DeviceEnumerator()
+	, m_api_type(api_type)
 	, m_usb_enumerator(nullptr)
     , m_cameraIndex(-1)
+	, m_remoteCameraListIndex(-1)
 {
-	USBDeviceManager *usbRequestMgr = USBDeviceManager::getInstance();
-
 	m_deviceType= CommonDeviceState::PS3EYE;
 	assert(m_deviceType >= 0 && GET_DEVICE_TYPE_INDEX(m_deviceType) < MAX_CAMERA_TYPE_INDEX);
-	m_usb_enumerator = usb_device_enumerator_allocate();
+
+	if (api_type == CommunicationType_USB || api_type == CommunicationType_ALL)
+	{
+		m_usb_enumerator = usb_device_enumerator_allocate();
+	}
 
 	// If the first USB device handle isn't a tracker, move on to the next device
 	if (testUSBEnumerator())
@@ -61,7 +67,7 @@ int TrackerDeviceEnumerator::get_vendor_id() const
 	USBDeviceFilter devInfo;
 	int vendor_id = -1;
 
-	if (is_valid() && usb_device_enumerator_get_filter(m_usb_enumerator, devInfo))
+	if (is_usb_valid() && usb_device_enumerator_get_filter(m_usb_enumerator, devInfo))
 	{
 		vendor_id = devInfo.vendor_id;
 	}
@@ -74,7 +80,7 @@ int TrackerDeviceEnumerator::get_product_id() const
 	USBDeviceFilter devInfo;
 	int product_id = -1;
 
-	if (is_valid() && usb_device_enumerator_get_filter(m_usb_enumerator, devInfo))
+	if (is_usb_valid() && usb_device_enumerator_get_filter(m_usb_enumerator, devInfo))
 	{
 		product_id = devInfo.product_id;
 	}
@@ -86,38 +92,115 @@ const char *TrackerDeviceEnumerator::get_path() const
 {
     const char *result = nullptr;
 
-    if (is_valid())
+    if (is_usb_valid())
     {
         // Return a pointer to our member variable that has the path cached
         result= m_currentUSBPath;
     }
+	else if (is_remote_valid())
+	{
+		result= get_remote_camera()->device_path.c_str();
+	}
 
     return result;
 }
 
+TrackerDeviceEnumerator::eAPIType TrackerDeviceEnumerator::get_api_type() const
+{
+	eAPIType result= CommunicationType_INVALID;
+
+	if (is_usb_valid())
+	{
+		result= CommunicationType_USB;
+	}
+	else if (is_remote_valid())
+	{
+		result= CommunicationType_REMOTE;
+	}
+
+	return result;
+}
+
+const RemoteTrackerCamera *TrackerDeviceEnumerator::get_remote_camera() const
+{
+	return 
+		(!is_usb_valid() && is_remote_valid()) 
+		? TrackerNodeManager::get_instance()->getRemoteCamera(m_remoteCameraListIndex) 
+		: nullptr;
+}
+
 bool TrackerDeviceEnumerator::is_valid() const
+{
+	return is_usb_valid() || is_remote_valid();
+}
+
+bool TrackerDeviceEnumerator::is_usb_valid() const
 {
 	return m_usb_enumerator != nullptr && usb_device_enumerator_is_valid(m_usb_enumerator);
 }
 
+bool TrackerDeviceEnumerator::is_remote_valid() const
+{
+	const TrackerNodeManager *node_manager= TrackerNodeManager::get_instance();
+
+	return 
+		node_manager != nullptr && 
+		m_remoteCameraListIndex >= 0 && 
+		m_remoteCameraListIndex < node_manager->getRemoteCameraCount();
+}
+
 bool TrackerDeviceEnumerator::next()
 {
-	USBDeviceManager *usbRequestMgr = USBDeviceManager::getInstance();
 	bool foundValid = false;
 
-	while (is_valid() && !foundValid)
+	// Local USB cameras come first ...
+	if (is_usb_valid())
 	{
-		usb_device_enumerator_next(m_usb_enumerator);
+		while (is_usb_valid() && !foundValid)
+		{
+			usb_device_enumerator_next(m_usb_enumerator);
 
-		if (testUSBEnumerator())
+			if (testUSBEnumerator())
+			{
+				foundValid= true;
+			}
+		}
+
+		if (foundValid)
 		{
-			foundValid= true;
+			++m_cameraIndex;
 		}
 	}
 
-	if (foundValid)
+	// ... followed by the cameras announced by tracker nodes
+	if (!foundValid && (m_api_type == CommunicationType_REMOTE || m_api_type == CommunicationType_ALL))
+	{
+		foundValid= nextRemoteCamera();
+	}
+
+	return foundValid;
+}
+
+bool TrackerDeviceEnumerator::nextRemoteCamera()
+{
+	const TrackerNodeManager *node_manager= TrackerNodeManager::get_instance();
+	bool foundValid = false;
+
+	if (node_manager != nullptr)
 	{
-		++m_cameraIndex;
+		const int camera_count= node_manager->getRemoteCameraCount();
+
+		while (!foundValid && m_remoteCameraListIndex < camera_count)
+		{
+			++m_remoteCameraListIndex;
+
+			// Skip the cameras of nodes that went away
+			if (m_remoteCameraListIndex < camera_count &&
+				node_manager->getRemoteCamera(m_remoteCameraListIndex)->bIsConnected)
+			{
+				foundValid= true;
+			}
+		}
 	}
 
 	return foundValid;
@@ -127,7 +210,7 @@ bool TrackerDeviceEnumerator::testUSBEnumerator()
 {
 	bool foundValid= false;
 
-	if (is_valid() && is_tracker_supported(m_usb_enumerator, m_deviceTypeFilter, m_deviceType))
+	if (is_usb_valid() && is_tracker_supported(m_usb_enumerator, m_deviceTypeFilter, m_deviceType))
 	{
 		char USBPath[256];
 
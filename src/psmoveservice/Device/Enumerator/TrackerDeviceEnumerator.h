@@ -9,7 +9,15 @@
 class TrackerDeviceEnumerator : public DeviceEnumerator
 {
 public:
-    TrackerDeviceEnumerator();
+	enum eAPIType
+	{
+		CommunicationType_INVALID= -1,
+		CommunicationType_USB,
+		CommunicationType_REMOTE,
+		CommunicationType_ALL
+	};
+
+    TrackerDeviceEnumerator(eAPIType api_type = CommunicationType_ALL);
 	~TrackerDeviceEnumerator();
 
     bool is_valid() const override;
@@ -19,14 +27,23 @@ public:
     const char *get_path() const override;
     inline int get_camera_index() const { return m_cameraIndex; }
 	inline struct USBDeviceEnumerator* get_usb_device_enumerator() const { return m_usb_enumerator; }
+	eAPIType get_api_type() const;
+
+	// The tracker node camera at the current position (null for USB cameras)
+	const struct RemoteTrackerCamera *get_remote_camera() const;
 
 protected: 
 	bool testUSBEnumerator();
+	bool is_usb_valid() const;
+	bool is_remote_valid() const;
+	bool nextRemoteCamera();
 
 private:
+	eAPIType m_api_type;
     char m_currentUSBPath[256];
 	struct USBDeviceEnumerator* m_usb_enumerator;
     int m_cameraIndex;
+	int m_remoteCameraListIndex;
 };
 
 #endif // TRACKER_DEVICE_ENUMERATOR_H
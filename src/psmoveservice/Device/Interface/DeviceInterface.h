@@ -2,6 +2,7 @@
 #define DEVICE_INTERFACE_H
 
 // -- includes -----
+#include <functional>
 #include <string>
 #include <tuple>
 
@@ -12,6 +13,8 @@ namespace PSMoveProtocol
     class TrackingColorPreset;
 };
 
+class VideoFrameRef;
+
 // -- constants -----
 enum eCommonTrackingColorID {
     INVALID_COLOR= -1,
@@ -447,7 +450,28 @@ public:
     
     // Fetch the device state at the given sample index.
     // A lookBack of 0 corresponds to the most recent data.
+    // Devices that keep a lock free state history hand out a copy per lookBack,
+    // which the next call with the same lookBack overwrites. Don't hold onto it.
     virtual const CommonDeviceState * getState(int lookBack = 0) const = 0;   
+
+    // Calls the visitor on each state with a poll sequence number newer than the given one, oldest first.
+    // Devices that keep a state history hand out copies, so this is safe while another thread polls them.
+    // By default only the most recent state is visited.
+    // Returns the number of states visited.
+    virtual int visitStatesNewerThan(
+        int poll_sequence_number,
+        const std::function<void(const CommonDeviceState *)> &visitor) const
+    {
+        const CommonDeviceState *state = getState();
+
+        if (state != nullptr && state->PollSequenceNumber > poll_sequence_number)
+        {
+            visitor(state);
+            return 1;
+        }
+
+        return 0;
+    }
 };
 
 /// Interface class for HMD events. Implemented HMD Server View
@@ -456,6 +480,9 @@ class IControllerListener
 public:
 	// Called when new sensor state has been read from the controller
 	virtual void notifySensorDataReceived(const CommonDeviceState *sensor_state) = 0;
+
+	// Prefix for the statistics published by the controller's own threads
+	virtual std::string getStatisticPrefix() const = 0;
 };
 
 /// Abstract class for controller interface. Implemented in PSMoveController.cpp
@@ -524,6 +551,7 @@ public:
         CL,
         CLMulti,
         Generic_Webcam,
+        Remote,
 
         SUPPORTED_DRIVER_TYPE_COUNT,
     };
@@ -538,8 +566,12 @@ public:
     // Returns the video frame size (used to compute frame buffer size)
     virtual bool getVideoFrameDimensions(int *out_width, int *out_height, int *out_stride) const = 0;
 
-    // Returns a pointer to the last video frame buffer captured
-    virtual const unsigned char *getVideoFrameBuffer() const = 0;
+    // Returns a reference to the last video frame buffer captured.
+    // The buffer is recycled by the tracker once every reference to it is released.
+    virtual VideoFrameRef getVideoFrame() const = 0;
+
+    // Returns how many captured video frames were dropped before they could be handed out
+    virtual int getDroppedFrameCount() const = 0;
 
     static const char *getDriverTypeString(eDriverType device_type)
     {
@@ -559,6 +591,9 @@ public:
         case Generic_Webcam:
             result = "Generic_Webcam";
             break;
+        case Remote:
+            result = "Remote";
+            break;
         default:
             result = "UNKNOWN";
         }
@@ -13,7 +13,7 @@
 #include "VirtualControllerEnumerator.h"
 
 #include "hidapi.h"
-#include "gamepad/Gamepad.h"
+#include "GamepadPoller.h"
 
 //-- methods -----
 //-- Tracker Manager Config -----
@@ -22,6 +22,9 @@ const int ControllerManagerConfig::CONFIG_VERSION = 1;
 ControllerManagerConfig::ControllerManagerConfig(const std::string &fnamebase)
     : PSMoveConfig(fnamebase)
     , virtual_controller_count(0)
+    , max_controller_count(PSMOVESERVICE_MAX_CONTROLLER_COUNT)
+    , filter_on_device_thread(false)
+    , gamepad_poll_interval_ms(2)
 {
 
 };
@@ -33,6 +36,9 @@ ControllerManagerConfig::config2ptree()
 
     pt.put("version", ControllerManagerConfig::CONFIG_VERSION);
     pt.put("virtual_controller_count", virtual_controller_count);
+    pt.put("max_controller_count", max_controller_count);
+    pt.put("filter_on_device_thread", filter_on_device_thread);
+    pt.put("gamepad_poll_interval_ms", gamepad_poll_interval_ms);
 
     return pt;
 }
@@ -45,6 +51,9 @@ ControllerManagerConfig::ptree2config(const boost::property_tree::ptree &pt)
     if (version == ControllerManagerConfig::CONFIG_VERSION)
     {
         virtual_controller_count = pt.get<int>("virtual_controller_count", 0);
+        max_controller_count = pt.get<int>("max_controller_count", max_controller_count);
+        filter_on_device_thread = pt.get<bool>("filter_on_device_thread", filter_on_device_thread);
+        gamepad_poll_interval_ms = pt.get<int>("gamepad_poll_interval_ms", gamepad_poll_interval_ms);
     }
     else
     {
@@ -57,6 +66,8 @@ ControllerManagerConfig::ptree2config(const boost::property_tree::ptree &pt)
 //-- Controller Manager ----
 ControllerManager::ControllerManager()
     : DeviceTypeManager(1000, 2)
+    , m_max_devices(k_max_devices)
+    , m_gamepad_poller(nullptr)
 {
 }
 
@@ -65,6 +76,24 @@ ControllerManager::startup()
 {
     bool success = true;
 
+	// Load any config from disk
+	cfg.load();
+
+    // Save back out the config in case there were updated defaults
+    cfg.save();
+
+    // Size the controller table before the device views get allocated
+    if (cfg.max_controller_count > 0 && cfg.max_controller_count <= k_max_devices)
+    {
+        m_max_devices = cfg.max_controller_count;
+    }
+    else
+    {
+        SERVER_LOG_WARNING("ControllerManager::startup") <<
+            "max_controller_count " << cfg.max_controller_count << " out of range, using " << k_max_devices;
+        m_max_devices = k_max_devices;
+    }
+
     if (!DeviceTypeManager::startup())
     {
         success = false;
@@ -72,12 +101,6 @@ ControllerManager::startup()
 
     if (success)
     {
-		// Load any config from disk
-		cfg.load();
-
-        // Save back out the config in case there were updated defaults
-        cfg.save();
-
         // Copy the virtual controller count into the Virtual and Gamepad controller enumerator's static variable.
         // This breaks the dependency between the Controller Manager and the enumerator.
         VirtualControllerEnumerator::virtual_controller_count= cfg.virtual_controller_count;
@@ -93,7 +116,9 @@ ControllerManager::startup()
 
 	if (success && gamepad_api_enabled)
 	{
-		Gamepad_init();
+		// Gamepad events are processed on the poller's worker thread
+		m_gamepad_poller = new GamepadPoller(cfg.gamepad_poll_interval_ms);
+		success = m_gamepad_poller->startup();
 	}
 
     if (success)
@@ -116,16 +141,18 @@ ControllerManager::shutdown()
 	hid_exit();
 
 	// Shutdown the gamepad api
-	if (gamepad_api_enabled)
+	if (m_gamepad_poller != nullptr)
 	{
-		Gamepad_shutdown();
+		m_gamepad_poller->shutdown();
+		delete m_gamepad_poller;
+		m_gamepad_poller = nullptr;
 	}
 }
 
 void
 ControllerManager::updateStateAndPredict(TrackerManager* tracker_manager)
 {
-	for (int device_id = 0; device_id < getMaxDevices(); ++device_id)
+	for (int device_id : m_openDeviceIds)
 	{
 		ServerControllerViewPtr controllerView = getControllerViewPtr(device_id);
 
@@ -144,7 +171,7 @@ void ControllerManager::publish()
     DeviceTypeManager::publish();
 
     bool bWasSystemButtonPressed= false;
-    for (int device_id = 0; device_id < getMaxDevices(); ++device_id)
+    for (int device_id : m_openDeviceIds)
 	{
 		ServerControllerViewPtr controllerView = getControllerViewPtr(device_id);
 
@@ -168,12 +195,6 @@ void ControllerManager::publish()
 void
 ControllerManager::poll_devices()
 {
-	// Poll all gamepads before updating the individual controllers
-	if (gamepad_api_enabled && can_poll_connected_devices())
-	{
-		Gamepad_processEvents();
-	}
-
 	DeviceTypeManager::poll_devices();
 }
 
@@ -203,7 +224,7 @@ int ControllerManager::getListUpdatedResponseType()
 int
 ControllerManager::getGamepadCount() const
 {
-    return gamepad_api_enabled ? Gamepad_numDevices() : 0;
+    return m_gamepad_poller != nullptr ? m_gamepad_poller->getGamepadCount() : 0;
 }
 
 void
@@ -223,7 +244,7 @@ ControllerManager::setControllerRumble(
 ServerControllerViewPtr
 ControllerManager::getControllerViewPtr(int device_id)
 {
-    assert(m_deviceViews != nullptr);
+    assert(ServerUtility::is_index_valid(device_id, static_cast<int>(m_deviceViews.size())));
 
     return std::static_pointer_cast<ServerControllerView>(m_deviceViews[device_id]);
 }
\ No newline at end of file
@@ -27,6 +27,14 @@ public:
 
     int version;
     int virtual_controller_count;
+    int max_controller_count;
+
+    // Run the pose filter of bluetooth PSMove/DS4 controllers on their HID worker thread
+    // as each IMU sample arrives, rather than once per main loop tick
+    bool filter_on_device_thread;
+
+    // How often the gamepad poller thread processes gamepad events
+    int gamepad_poll_interval_ms;
 };
 
 class ControllerManager : public DeviceTypeManager
@@ -51,7 +59,7 @@ public:
     static const int k_max_devices = PSMOVESERVICE_MAX_CONTROLLER_COUNT;
     int getMaxDevices() const override
     {
-        return ControllerManager::k_max_devices;
+        return m_max_devices;
     }
 
     int getGamepadCount() const;
@@ -82,6 +90,8 @@ private:
     static const PSMoveProtocol::Response_ResponseType k_list_udpated_response_type = PSMoveProtocol::Response_ResponseType_CONTROLLER_LIST_UPDATED;
     std::string m_bluetooth_host_address;
     ControllerManagerConfig cfg;
+    int m_max_devices;
+    class GamepadPoller *m_gamepad_poller;
 };
 
 #endif // CONTROLLER_MANAGER_H
\ No newline at end of file
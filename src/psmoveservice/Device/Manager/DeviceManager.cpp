@@ -19,6 +19,7 @@
 #include "PSMoveProtocol.pb.h"
 #include "PSMoveConfig.h"
 #include "TrackerManager.h"
+#include "TrackerNodeManager.h"
 
 #include <chrono>
 
@@ -199,10 +200,23 @@ DeviceManager::update()
 		m_platform_api->poll(); // Send device hotplug events
 	}
 
+    // A tracker node only runs its cameras and sends what it found to the central service
+    TrackerNodeManager *tracker_node_manager = TrackerNodeManager::get_instance();
+    if (tracker_node_manager != nullptr && tracker_node_manager->getIsNodeMode())
+    {
+        m_tracker_manager->poll(); // Update tracker count and poll video frames
+        tracker_node_manager->sendNodeProjections(m_tracker_manager); // Find the requested targets in the new video frames
+        m_tracker_manager->publish(); // publish tracker state to any listening clients (i.e. the ConfigTool on the node)
+        return;
+    }
+
     m_controller_manager->poll(); // Update controller counts and poll button/IMU state
     m_tracker_manager->poll(); // Update tracker count and poll video frames
     m_hmd_manager->poll(); // Update HMD count and poll IMU state
 
+    m_tracker_manager->updateOpticalProjections(m_controller_manager, m_hmd_manager); // Find tracking blobs in the new video frames
+    m_tracker_manager->updateTrackerPoseCalibration(m_controller_manager); // Record the new blobs for a running tracker pose calibration
+
     m_controller_manager->updateStateAndPredict(m_tracker_manager); // Compute pose/prediction of tracking blob+IMU state
     m_hmd_manager->updateStateAndPredict(m_tracker_manager); // Compute pose/prediction of tracking blobs+IMU state
 
@@ -13,31 +13,33 @@
 DeviceTypeManager::DeviceTypeManager(const int recon_int, const int poll_int)
     : reconnect_interval(recon_int)
     , poll_interval(poll_int)
-    , m_deviceViews(nullptr)
+    , m_deviceViews()
+    , m_openDeviceIds()
 	, m_bIsDeviceListDirty(false)
 {
 }
 
 DeviceTypeManager::~DeviceTypeManager()
 {
-    assert(m_deviceViews == nullptr);
+    assert(m_deviceViews.empty());
 }
 
 /// Override if the device type needs to initialize any services (e.g., hid_init)
 bool
 DeviceTypeManager::startup()
 {
-    assert(m_deviceViews == nullptr);
+    assert(m_deviceViews.empty());
 
     const int maxDeviceCount = getMaxDevices();
-    m_deviceViews = new ServerDeviceViewPtr[maxDeviceCount];
+    m_deviceViews.reserve(maxDeviceCount);
+    m_openDeviceIds.reserve(maxDeviceCount);
 
     // Allocate all of the device views
     for (int device_id = 0; device_id < maxDeviceCount; ++device_id)
     {
         ServerDeviceViewPtr deviceView = ServerDeviceViewPtr(allocate_device_view(device_id));
 
-        m_deviceViews[device_id] = deviceView;
+        m_deviceViews.push_back(deviceView);
     }
 
 	// Rebuild the device list the first chance we get
@@ -50,25 +52,15 @@ DeviceTypeManager::startup()
 void
 DeviceTypeManager::shutdown()
 {
-	if (m_deviceViews != nullptr)
+	// Close any controllers that were opened
+	for (int device_id : m_openDeviceIds)
 	{
-		// Close any controllers that were opened
-		for (int device_id = 0; device_id < getMaxDevices(); ++device_id)
-		{
-			ServerDeviceViewPtr device = m_deviceViews[device_id];
-
-			if (device->getIsOpen())
-			{
-				device->close();
-			}
-
-			m_deviceViews[device_id] = ServerDeviceViewPtr();
-		}
-
-		// Free the device view pointer list
-		delete[] m_deviceViews;
-		m_deviceViews = nullptr;
+		m_deviceViews[device_id]->close();
 	}
+
+	// Free the device view pointer list
+	m_openDeviceIds.clear();
+	m_deviceViews.clear();
 }
 
 /// Calls poll_devices and update_connected_devices if poll_interval and reconnect_interval has elapsed, respectively.
@@ -116,13 +108,11 @@ DeviceTypeManager::update_connected_devices()
     if (can_update_connected_devices())
     {
         const int maxDeviceCount = getMaxDevices();
-        bool exists_in_enumerator[64];
         bool bSendControllerUpdatedNotification = false;
 
         // Initialize temp table used to keep track of open devices
         // still found in the enumerator
-        assert(maxDeviceCount <= 64);
-        memset(exists_in_enumerator, 0, sizeof(exists_in_enumerator));
+        std::vector<bool> exists_in_enumerator(maxDeviceCount, false);
 
         // Step 1
         // Mark any open devices that still show up in the enumerator.
@@ -162,6 +152,7 @@ DeviceTypeManager::update_connected_devices()
 
                             // Mark the device as having showed up in the enumerator
                             exists_in_enumerator[device_id_] = true;
+                            m_openDeviceIds.push_back(device_id_);
 
                             // Send notificiation to clients that a new device was added
                             bSendControllerUpdatedNotification = true;
@@ -206,6 +197,9 @@ DeviceTypeManager::update_connected_devices()
             }
         }
 
+        // Devices can also get closed outside of the manager (e.g. bluetooth requests)
+        rebuild_open_device_list();
+
         // List of open devices changed, tell the clients
         if (bSendControllerUpdatedNotification)
         {
@@ -222,11 +216,9 @@ void
 DeviceTypeManager::publish()
 {
     // Publish any new data to client connections
-    for (int device_id = 0; device_id < getMaxDevices(); ++device_id)
+    for (int device_id : m_openDeviceIds)
     {
-        ServerDeviceViewPtr device = getDeviceViewPtr(device_id);
-
-        device->publish();
+        m_deviceViews[device_id]->publish();
     }
 }
 
@@ -260,14 +252,15 @@ DeviceTypeManager::poll_devices()
     {
         bool bAllUpdatedOk = true;
 
-        for (int device_id = 0; device_id < getMaxDevices(); ++device_id)
+        for (int device_id : m_openDeviceIds)
         {
-            ServerDeviceViewPtr device = getDeviceViewPtr(device_id);
-            bAllUpdatedOk &= device->poll();
+            bAllUpdatedOk &= m_deviceViews[device_id]->poll();
         }
 
+        // A device that failed to poll got closed
         if (!bAllUpdatedOk)
         {
+            rebuild_open_device_list();
             send_device_list_changed_notification();
         }
     }
@@ -279,11 +272,9 @@ DeviceTypeManager::find_open_device_device_id(const DeviceEnumerator *enumerator
 {
     int result_device_id = -1;
 
-    for (int device_id = 0; device_id < getMaxDevices(); ++device_id)
+    for (int device_id : m_openDeviceIds)
     {
-        ServerDeviceViewPtr device = getDeviceViewPtr(device_id);
-
-        if (device && device->matchesDeviceEnumerator(enumerator))
+        if (m_deviceViews[device_id]->matchesDeviceEnumerator(enumerator))
         {
             result_device_id = device_id;
             break;
@@ -293,6 +284,20 @@ DeviceTypeManager::find_open_device_device_id(const DeviceEnumerator *enumerator
     return result_device_id;
 }
 
+void
+DeviceTypeManager::rebuild_open_device_list()
+{
+    m_openDeviceIds.clear();
+
+    for (int device_id = 0; device_id < static_cast<int>(m_deviceViews.size()); ++device_id)
+    {
+        if (m_deviceViews[device_id]->getIsOpen())
+        {
+            m_openDeviceIds.push_back(device_id);
+        }
+    }
+}
+
 int
 DeviceTypeManager::find_first_closed_device_device_id()
 {
@@ -313,7 +318,7 @@ DeviceTypeManager::find_first_closed_device_device_id()
 ServerDeviceViewPtr
 DeviceTypeManager::getDeviceViewPtr(int device_id)
 {
-    assert(m_deviceViews != nullptr);
+    assert(device_id >= 0 && device_id < static_cast<int>(m_deviceViews.size()));
 
     return m_deviceViews[device_id];
 }
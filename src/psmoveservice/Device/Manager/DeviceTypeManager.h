@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <chrono>
+#include <vector>
 
 //-- typedefs -----
 class ServerDeviceView;
@@ -26,8 +27,17 @@ public:
     void poll();
     virtual void publish();
 
+    /// Number of slots in the device table.
+    /// Sized once at startup from the manager config, bounded by the protocol max device count.
     virtual int getMaxDevices() const = 0;
 
+    /// Dense list of the device ids of all currently open devices.
+    /// Per-tick loops should iterate this instead of the whole device table.
+    inline const std::vector<int> &getOpenDeviceIds() const
+    {
+        return m_openDeviceIds;
+    }
+
     /**
     Returns an upcast device view ptr. Useful for generic functions that are
     simple wrappers around the device functions:
@@ -67,10 +77,14 @@ protected:
     int find_first_closed_device_device_id();
     int find_open_device_device_id(const class DeviceEnumerator *enumerator);
 
+    /// Rebuild m_openDeviceIds after any device was opened or closed
+    void rebuild_open_device_list();
+
     std::chrono::time_point<std::chrono::high_resolution_clock> m_last_reconnect_time;
     std::chrono::time_point<std::chrono::high_resolution_clock> m_last_poll_time;
 
-    ServerDeviceViewPtr *m_deviceViews;
+    std::vector<ServerDeviceViewPtr> m_deviceViews;
+    std::vector<int> m_openDeviceIds;
 
 	bool m_bIsDeviceListDirty;
 };
@@ -0,0 +1,225 @@
+//-- includes -----
+#include "GamepadPoller.h"
+#include "ServerLog.h"
+
+#include "gamepad/Gamepad.h"
+
+#include <algorithm>
+#include <string.h>
+#include <thread>
+
+//-- statics -----
+GamepadPoller *GamepadPoller::m_instance = nullptr;
+
+//-- prototypes -----
+static bool copy_gamepad_state(const Gamepad_device *gamepad, GamepadSnapshot &out_snapshot);
+
+//-- GamepadSnapshot -----
+void GamepadSnapshot::clear()
+{
+    bIsConnected = false;
+    vendorID = -1;
+    productID = -1;
+    description[0] = '\0';
+    numButtons = 0;
+    memset(buttonStates, 0, sizeof(buttonStates));
+    numAxes = 0;
+    memset(axisStates, 0, sizeof(axisStates));
+    sequence = 0;
+}
+
+//-- GamepadPoller -----
+GamepadPoller::GamepadPoller(int poll_interval_ms)
+    : WorkerThread("GamepadPoller")
+    , m_gamepadCount(0)
+    , m_bDetectDevicesRequested(false)
+    , m_bIsGamepadApiInitialized(false)
+    , m_pollInterval(std::max(poll_interval_ms, 1))
+    , m_nextPollTime()
+{
+    for (int gamepad_index = 0; gamepad_index < GAMEPAD_POLLER_MAX_GAMEPADS; ++gamepad_index)
+    {
+        m_publishedSnapshots[gamepad_index].clear();
+        m_snapshots[gamepad_index].storeValue(m_publishedSnapshots[gamepad_index]);
+    }
+}
+
+GamepadPoller::~GamepadPoller()
+{
+    shutdown();
+}
+
+bool GamepadPoller::startup()
+{
+    if (m_instance != nullptr)
+    {
+        SERVER_LOG_ERROR("GamepadPoller::startup") << "Gamepad poller already started";
+        return false;
+    }
+
+    m_instance = this;
+
+    WorkerThread::startThread();
+
+    // Wait for the devices found by Gamepad_init to be published before anything gets enumerated
+    while (!m_bIsGamepadApiInitialized.load() && !WorkerThread::hasThreadEnded())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+void GamepadPoller::shutdown()
+{
+    // The gamepad api is shutdown on the worker thread before it exits
+    WorkerThread::stopThread();
+
+    if (m_instance == this)
+    {
+        m_instance = nullptr;
+    }
+}
+
+void GamepadPoller::requestDetectDevices()
+{
+    m_bDetectDevicesRequested.store(true);
+}
+
+bool GamepadPoller::fetchGamepadSnapshot(int gamepad_index, GamepadSnapshot &out_snapshot)
+{
+    if (gamepad_index >= 0 && gamepad_index < GAMEPAD_POLLER_MAX_GAMEPADS)
+    {
+        m_snapshots[gamepad_index].fetchValue(out_snapshot);
+    }
+    else
+    {
+        out_snapshot.clear();
+    }
+
+    return out_snapshot.bIsConnected;
+}
+
+void GamepadPoller::onThreadStarted()
+{
+    Gamepad_init();
+
+    // Publish the devices found by Gamepad_init right away
+    publishSnapshots();
+
+    m_nextPollTime = std::chrono::high_resolution_clock::now();
+    m_bIsGamepadApiInitialized.store(true);
+}
+
+void GamepadPoller::onThreadHaltComplete()
+{
+    if (m_bIsGamepadApiInitialized.load())
+    {
+        Gamepad_shutdown();
+        m_bIsGamepadApiInitialized.store(false);
+    }
+}
+
+bool GamepadPoller::doWork()
+{
+    if (m_bDetectDevicesRequested.exchange(false))
+    {
+        Gamepad_detectDevices();
+    }
+
+    Gamepad_processEvents();
+    publishSnapshots();
+
+    // Keep a fixed poll rate regardless of how long the poll took
+    m_nextPollTime += m_pollInterval;
+
+    const auto now = std::chrono::high_resolution_clock::now();
+    if (m_nextPollTime > now)
+    {
+        std::this_thread::sleep_until(m_nextPollTime);
+    }
+    else
+    {
+        // Fell behind (e.g. a slow device detection), don't try to catch up
+        m_nextPollTime = now;
+    }
+
+    return true;
+}
+
+void GamepadPoller::publishSnapshots()
+{
+    const int gamepad_count = static_cast<int>(Gamepad_numDevices());
+
+    for (int gamepad_index = 0; gamepad_index < GAMEPAD_POLLER_MAX_GAMEPADS; ++gamepad_index)
+    {
+        const Gamepad_device *gamepad =
+            (gamepad_index < gamepad_count)
+            ? Gamepad_deviceAtIndex(static_cast<unsigned int>(gamepad_index))
+            : nullptr;
+
+        GamepadSnapshot &published_snapshot = m_publishedSnapshots[gamepad_index];
+
+        // Only hand off a new snapshot when something changed
+        if (copy_gamepad_state(gamepad, published_snapshot))
+        {
+            ++published_snapshot.sequence;
+            m_snapshots[gamepad_index].storeValue(published_snapshot);
+        }
+    }
+
+    m_gamepadCount.store(std::min(gamepad_count, GAMEPAD_POLLER_MAX_GAMEPADS));
+}
+
+//-- private methods -----
+static bool copy_gamepad_state(const Gamepad_device *gamepad, GamepadSnapshot &out_snapshot)
+{
+    bool bChanged = false;
+
+    if (gamepad != nullptr)
+    {
+        const unsigned int num_buttons = std::min(gamepad->numButtons, (unsigned int)GAMEPAD_POLLER_MAX_BUTTONS);
+        const unsigned int num_axes = std::min(gamepad->numAxes, (unsigned int)GAMEPAD_POLLER_MAX_AXES);
+
+        if (!out_snapshot.bIsConnected ||
+            out_snapshot.vendorID != gamepad->vendorID ||
+            out_snapshot.productID != gamepad->productID ||
+            out_snapshot.numButtons != num_buttons ||
+            out_snapshot.numAxes != num_axes)
+        {
+            // A new device (or a different one at this index)
+            out_snapshot.bIsConnected = true;
+            out_snapshot.vendorID = gamepad->vendorID;
+            out_snapshot.productID = gamepad->productID;
+            out_snapshot.numButtons = num_buttons;
+            out_snapshot.numAxes = num_axes;
+            strncpy(out_snapshot.description,
+                    gamepad->description != nullptr ? gamepad->description : "",
+                    sizeof(out_snapshot.description) - 1);
+            out_snapshot.description[sizeof(out_snapshot.description) - 1] = '\0';
+            bChanged = true;
+        }
+
+        if (memcmp(out_snapshot.buttonStates, gamepad->buttonStates, num_buttons * sizeof(bool)) != 0)
+        {
+            memcpy(out_snapshot.buttonStates, gamepad->buttonStates, num_buttons * sizeof(bool));
+            bChanged = true;
+        }
+
+        if (memcmp(out_snapshot.axisStates, gamepad->axisStates, num_axes * sizeof(float)) != 0)
+        {
+            memcpy(out_snapshot.axisStates, gamepad->axisStates, num_axes * sizeof(float));
+            bChanged = true;
+        }
+    }
+    else if (out_snapshot.bIsConnected)
+    {
+        const int sequence = out_snapshot.sequence;
+
+        out_snapshot.clear();
+        out_snapshot.sequence = sequence;
+        bChanged = true;
+    }
+
+    return bChanged;
+}
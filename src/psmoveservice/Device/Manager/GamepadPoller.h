@@ -0,0 +1,93 @@
+#ifndef GAMEPAD_POLLER_H
+#define GAMEPAD_POLLER_H
+
+//-- includes -----
+#include "AtomicPrimitives.h"
+#include "WorkerThread.h"
+
+#include <atomic>
+#include <chrono>
+
+//-- constants -----
+#define GAMEPAD_POLLER_MAX_GAMEPADS 8
+#define GAMEPAD_POLLER_MAX_BUTTONS 32
+#define GAMEPAD_POLLER_MAX_AXES 32
+#define GAMEPAD_POLLER_MAX_DESCRIPTION_LENGTH 128
+
+//-- definitions -----
+/// Copy of a Gamepad_device taken on the gamepad poller thread
+struct GamepadSnapshot
+{
+    bool bIsConnected;
+    int vendorID;
+    int productID;
+    char description[GAMEPAD_POLLER_MAX_DESCRIPTION_LENGTH];
+    unsigned int numButtons;
+    bool buttonStates[GAMEPAD_POLLER_MAX_BUTTONS];
+    unsigned int numAxes;
+    float axisStates[GAMEPAD_POLLER_MAX_AXES];
+    int sequence; // incremented every time the gamepad's state changes
+
+    void clear();
+};
+
+/// Owns the gamepad api.
+/// Every gamepad api call (init, event processing, detection and shutdown) is made on a worker thread,
+/// and the state of each gamepad is published as a lock free snapshot every poll interval.
+/// Device detection (Gamepad_detectDevices) also runs on the worker when requested by an enumerator.
+/// Snapshots must only be fetched from the main thread (AtomicObject supports a single reader).
+class GamepadPoller : public WorkerThread
+{
+public:
+    GamepadPoller(int poll_interval_ms);
+    virtual ~GamepadPoller();
+
+    static inline GamepadPoller *getInstance()
+    {
+        return m_instance;
+    }
+
+    /// Initialize the gamepad api and start polling
+    bool startup();
+
+    /// Stop polling and shutdown the gamepad api
+    void shutdown();
+
+    /// Any thread: run device detection on the next poll
+    void requestDetectDevices();
+
+    /// Any thread: number of gamepads found by the last poll
+    inline int getGamepadCount() const
+    {
+        return m_gamepadCount.load();
+    }
+
+    /// Main thread: latest state of the gamepad at the given index.
+    /// Returns false if there is no gamepad connected at that index.
+    bool fetchGamepadSnapshot(int gamepad_index, GamepadSnapshot &out_snapshot);
+
+protected:
+    void onThreadStarted() override;
+    void onThreadHaltComplete() override;
+    bool doWork() override;
+
+private:
+    void publishSnapshots();
+
+    // Multithreaded state
+    AtomicObject<GamepadSnapshot> m_snapshots[GAMEPAD_POLLER_MAX_GAMEPADS];
+    std::atomic_int m_gamepadCount;
+    std::atomic_bool m_bDetectDevicesRequested;
+    std::atomic_bool m_bIsGamepadApiInitialized;
+
+    // Worker thread state (main thread state before the thread starts)
+    GamepadSnapshot m_publishedSnapshots[GAMEPAD_POLLER_MAX_GAMEPADS];
+    std::chrono::milliseconds m_pollInterval;
+    std::chrono::time_point<std::chrono::high_resolution_clock> m_nextPollTime;
+
+    /// Singleton instance of the class
+    /// Assigned in startup, cleared in shutdown
+    static GamepadPoller *m_instance;
+};
+
+#endif // GAMEPAD_POLLER_H
@@ -4,6 +4,7 @@
 #include "ServerLog.h"
 #include "ServerHMDView.h"
 #include "ServerDeviceView.h"
+#include "ServerUtility.h"
 #include "PSMoveProtocol.pb.h"
 #include <boost/foreach.hpp>
 #include "VirtualHMDDeviceEnumerator.h"
@@ -15,6 +16,7 @@ const int HMDManagerConfig::CONFIG_VERSION = 1;
 HMDManagerConfig::HMDManagerConfig(const std::string &fnamebase)
     : PSMoveConfig(fnamebase)
     , virtual_hmd_count(0)
+    , max_hmd_count(PSMOVESERVICE_MAX_HMD_COUNT)
 {
 
 };
@@ -26,6 +28,7 @@ HMDManagerConfig::config2ptree()
 
     pt.put("version", HMDManagerConfig::CONFIG_VERSION);
     pt.put("virtual_hmd_count", virtual_hmd_count);
+    pt.put("max_hmd_count", max_hmd_count);
 
     return pt;
 }
@@ -38,6 +41,7 @@ HMDManagerConfig::ptree2config(const boost::property_tree::ptree &pt)
     if (version == HMDManagerConfig::CONFIG_VERSION)
     {
         virtual_hmd_count = pt.get<int>("virtual_hmd_count", 0);
+        max_hmd_count = pt.get<int>("max_hmd_count", max_hmd_count);
     }
     else
     {
@@ -50,6 +54,7 @@ HMDManagerConfig::ptree2config(const boost::property_tree::ptree &pt)
 //-- HMD Manager -----
 HMDManager::HMDManager()
     : DeviceTypeManager(1000, 2)
+    , m_max_devices(k_max_devices)
 {
 }
 
@@ -58,14 +63,26 @@ HMDManager::startup()
 {
     bool success = false;
 
-    if (DeviceTypeManager::startup())
-    {
-		// Load any config from disk
-		cfg.load();
+	// Load any config from disk
+	cfg.load();
+
+    // Save back out the config in case there were updated defaults
+    cfg.save();
 
-        // Save back out the config in case there were updated defaults
-        cfg.save();
+    // Size the HMD table before the device views get allocated
+    if (cfg.max_hmd_count > 0 && cfg.max_hmd_count <= k_max_devices)
+    {
+        m_max_devices = cfg.max_hmd_count;
+    }
+    else
+    {
+        SERVER_LOG_WARNING("HMDManager::startup") <<
+            "max_hmd_count " << cfg.max_hmd_count << " out of range, using " << k_max_devices;
+        m_max_devices = k_max_devices;
+    }
 
+    if (DeviceTypeManager::startup())
+    {
         // Copy the virtual controller count into the Virtual controller enumerator static variable.
         // This breaks the dependency between the Controller Manager and the enumerator.
         VirtualHMDDeviceEnumerator::virtual_hmd_count= cfg.virtual_hmd_count;
@@ -85,7 +102,7 @@ HMDManager::shutdown()
 void
 HMDManager::updateStateAndPredict(TrackerManager* tracker_manager)
 {
-	for (int device_id = 0; device_id < getMaxDevices(); ++device_id)
+	for (int device_id : m_openDeviceIds)
 	{
 		ServerHMDViewPtr hmdView = getHMDViewPtr(device_id);
 
@@ -100,7 +117,7 @@ HMDManager::updateStateAndPredict(TrackerManager* tracker_manager)
 ServerHMDViewPtr
 HMDManager::getHMDViewPtr(int device_id)
 {
-    assert(m_deviceViews != nullptr);
+    assert(ServerUtility::is_index_valid(device_id, static_cast<int>(m_deviceViews.size())));
 
     return std::static_pointer_cast<ServerHMDView>(m_deviceViews[device_id]);
 }
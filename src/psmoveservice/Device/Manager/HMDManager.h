@@ -28,6 +28,7 @@ public:
 
     int version;
     int virtual_hmd_count;
+    int max_hmd_count;
 };
 
 class HMDManager : public DeviceTypeManager
@@ -43,7 +44,7 @@ public:
     static const int k_max_devices = PSMOVESERVICE_MAX_HMD_COUNT;
     int getMaxDevices() const override
     {
-        return HMDManager::k_max_devices;
+        return m_max_devices;
     }
 
     ServerHMDViewPtr getHMDViewPtr(int device_id);
@@ -62,6 +63,7 @@ protected:
 
 private:
     HMDManagerConfig cfg;
+    int m_max_devices;
 };
 
 #endif // HMD_MANAGER_H
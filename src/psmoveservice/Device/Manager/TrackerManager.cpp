@@ -9,6 +9,9 @@
 #include "ServerHMDView.h"
 #include "ServerTrackerView.h"
 #include "ServerDeviceView.h"
+#include "ServerUtility.h"
+#include "TrackerNodeManager.h"
+#include "TrackerPoseCalibrator.h"
 #include "MathUtility.h"
 #include "PSMoveProtocol.pb.h"
 
@@ -29,6 +32,25 @@ TrackerManagerConfig::TrackerManagerConfig(const std::string &fnamebase)
 	exclude_opposed_cameras = false;
 	min_valid_projection_area= 16;
 	disable_roi = false;
+	use_optical_pipeline = false;
+	optical_pipeline_queue_depth = 2;
+	use_lightbar_fast_path = true;
+	use_occlusion_recovery = true;
+	recovery_pixel_budget = 320*240;
+	recovery_full_scan_interval = 8;
+	recovery_full_scan_decimation = 4;
+	recovery_max_dead_reckoning_time = 1.5f;
+	recovery_drift_cm_per_second = 25.f;
+	use_auto_exposure = false;
+	auto_exposure_min = 8.f;
+	auto_exposure_max = 160.f;
+	auto_gain_min = 0.f;
+	auto_gain_max = 64.f;
+	auto_exposure_interval_ms = 500;
+	auto_exposure_target_bulb_value = 200.f;
+	auto_exposure_max_clipped_fraction = 0.25f;
+	auto_exposure_max_background_value = 60.f;
+	max_tracker_count = PSMOVESERVICE_MAX_TRACKER_COUNT;
 	default_tracker_profile.frame_width = 640;
 	//default_tracker_profile.frame_height = 480;
 	default_tracker_profile.frame_rate = 40;
@@ -61,6 +83,29 @@ TrackerManagerConfig::config2ptree()
 
 	pt.put("disable_roi", disable_roi);
 
+	pt.put("use_optical_pipeline", use_optical_pipeline);
+	pt.put("optical_pipeline_queue_depth", optical_pipeline_queue_depth);
+	pt.put("use_lightbar_fast_path", use_lightbar_fast_path);
+
+	pt.put("use_occlusion_recovery", use_occlusion_recovery);
+	pt.put("recovery_pixel_budget", recovery_pixel_budget);
+	pt.put("recovery_full_scan_interval", recovery_full_scan_interval);
+	pt.put("recovery_full_scan_decimation", recovery_full_scan_decimation);
+	pt.put("recovery_max_dead_reckoning_time", recovery_max_dead_reckoning_time);
+	pt.put("recovery_drift_cm_per_second", recovery_drift_cm_per_second);
+
+	pt.put("use_auto_exposure", use_auto_exposure);
+	pt.put("auto_exposure_min", auto_exposure_min);
+	pt.put("auto_exposure_max", auto_exposure_max);
+	pt.put("auto_gain_min", auto_gain_min);
+	pt.put("auto_gain_max", auto_gain_max);
+	pt.put("auto_exposure_interval_ms", auto_exposure_interval_ms);
+	pt.put("auto_exposure_target_bulb_value", auto_exposure_target_bulb_value);
+	pt.put("auto_exposure_max_clipped_fraction", auto_exposure_max_clipped_fraction);
+	pt.put("auto_exposure_max_background_value", auto_exposure_max_background_value);
+
+	pt.put("max_tracker_count", max_tracker_count);
+
 	pt.put("default_tracker_profile.frame_width", default_tracker_profile.frame_width);
 	//pt.put("default_tracker_profile.frame_height", default_tracker_profile.frame_height);
 	pt.put("default_tracker_profile.frame_rate", default_tracker_profile.frame_rate);
@@ -89,6 +134,25 @@ TrackerManagerConfig::ptree2config(const boost::property_tree::ptree &pt)
 		exclude_opposed_cameras = pt.get<bool>("excluded_opposed_cameras", exclude_opposed_cameras);
 		min_valid_projection_area = pt.get<float>("min_valid_projection_area", min_valid_projection_area);	
 		disable_roi = pt.get<bool>("disable_roi", disable_roi);
+		use_optical_pipeline = pt.get<bool>("use_optical_pipeline", use_optical_pipeline);
+		optical_pipeline_queue_depth = pt.get<int>("optical_pipeline_queue_depth", optical_pipeline_queue_depth);
+		use_lightbar_fast_path = pt.get<bool>("use_lightbar_fast_path", use_lightbar_fast_path);
+		use_occlusion_recovery = pt.get<bool>("use_occlusion_recovery", use_occlusion_recovery);
+		recovery_pixel_budget = pt.get<int>("recovery_pixel_budget", recovery_pixel_budget);
+		recovery_full_scan_interval = pt.get<int>("recovery_full_scan_interval", recovery_full_scan_interval);
+		recovery_full_scan_decimation = pt.get<int>("recovery_full_scan_decimation", recovery_full_scan_decimation);
+		recovery_max_dead_reckoning_time = pt.get<float>("recovery_max_dead_reckoning_time", recovery_max_dead_reckoning_time);
+		recovery_drift_cm_per_second = pt.get<float>("recovery_drift_cm_per_second", recovery_drift_cm_per_second);
+		use_auto_exposure = pt.get<bool>("use_auto_exposure", use_auto_exposure);
+		auto_exposure_min = pt.get<float>("auto_exposure_min", auto_exposure_min);
+		auto_exposure_max = pt.get<float>("auto_exposure_max", auto_exposure_max);
+		auto_gain_min = pt.get<float>("auto_gain_min", auto_gain_min);
+		auto_gain_max = pt.get<float>("auto_gain_max", auto_gain_max);
+		auto_exposure_interval_ms = pt.get<int>("auto_exposure_interval_ms", auto_exposure_interval_ms);
+		auto_exposure_target_bulb_value = pt.get<float>("auto_exposure_target_bulb_value", auto_exposure_target_bulb_value);
+		auto_exposure_max_clipped_fraction = pt.get<float>("auto_exposure_max_clipped_fraction", auto_exposure_max_clipped_fraction);
+		auto_exposure_max_background_value = pt.get<float>("auto_exposure_max_background_value", auto_exposure_max_background_value);
+		max_tracker_count = pt.get<int>("max_tracker_count", max_tracker_count);
 		default_tracker_profile.frame_width = pt.get<float>("default_tracker_profile.frame_width", 640);
 		//default_tracker_profile.frame_height = pt.get<float>("default_tracker_profile.frame_height", 480);
 		default_tracker_profile.frame_rate = pt.get<float>("default_tracker_profile.frame_rate", 40);
@@ -147,22 +211,37 @@ TrackerManagerConfig::get_global_down_axis() const
 TrackerManager::TrackerManager()
     : DeviceTypeManager(10000, 13)
     , m_tracker_list_dirty(false)
+    , m_remote_camera_list_revision(0)
+    , m_max_devices(k_max_devices)
+    , m_pose_calibrator(nullptr)
 {
 }
 
 bool 
 TrackerManager::startup()
 {
-    bool bSuccess = DeviceTypeManager::startup();
+	// Load any config from disk
+	cfg.load();
 
-    if (bSuccess)
+    // Save back out the config in case there were updated defaults
+    cfg.save();
+
+    // Size the tracker table before the device views get allocated
+    if (cfg.max_tracker_count > 0 && cfg.max_tracker_count <= k_max_devices)
     {
-		// Load any config from disk
-		cfg.load();
+        m_max_devices = cfg.max_tracker_count;
+    }
+    else
+    {
+        SERVER_LOG_WARNING("TrackerManager::startup") <<
+            "max_tracker_count " << cfg.max_tracker_count << " out of range, using " << k_max_devices;
+        m_max_devices = k_max_devices;
+    }
 
-        // Save back out the config in case there were updated defaults
-        cfg.save();
+    bool bSuccess = DeviceTypeManager::startup();
 
+    if (bSuccess)
+    {
         // Refresh the tracker list
         mark_tracker_list_dirty();
 
@@ -171,23 +250,34 @@ TrackerManager::startup()
         {
             m_available_color_ids.push_back(static_cast<eCommonTrackingColorID>(color_index));
         }
+
+        m_pose_calibrator = new TrackerPoseCalibrator;
     }
 
     return bSuccess;
 }
 
 void
-TrackerManager::closeAllTrackers()
+TrackerManager::shutdown()
 {
-    for (int tracker_id = 0; tracker_id < k_max_devices; ++tracker_id)
+    // Stop any pose solve before the trackers go away
+    if (m_pose_calibrator != nullptr)
     {
-        ServerTrackerViewPtr tracker_view = getTrackerViewPtr(tracker_id);
+        delete m_pose_calibrator;
+        m_pose_calibrator = nullptr;
+    }
 
-        if (tracker_view->getIsOpen())
-        {
-            tracker_view->close();
-        }
+    DeviceTypeManager::shutdown();
+}
+
+void
+TrackerManager::closeAllTrackers()
+{
+    for (int tracker_id : m_openDeviceIds)
+    {
+        getTrackerViewPtr(tracker_id)->close();
     }
+    m_openDeviceIds.clear();
 
     // Refresh the tracker list once we're allowed to
     mark_tracker_list_dirty();
@@ -196,6 +286,85 @@ TrackerManager::closeAllTrackers()
     send_device_list_changed_notification();
 }
 
+void
+TrackerManager::updateOpticalProjections(
+    ControllerManager *controller_manager,
+    HMDManager *hmd_manager)
+{
+    std::vector<ServerControllerView *> tracked_controllers;
+    std::vector<ServerHMDView *> tracked_hmds;
+
+    // Gather the devices that want optical tracking this frame
+    for (int controller_id : controller_manager->getOpenDeviceIds())
+    {
+        ServerControllerViewPtr controller_view = controller_manager->getControllerViewPtr(controller_id);
+
+        if (controller_view->getIsTrackingEnabled() &&
+            (controller_view->getIsBluetooth() || controller_view->getIsVirtualController()) &&
+            controller_view->getTrackingColorID() != eCommonTrackingColorID::INVALID_COLOR)
+        {
+            tracked_controllers.push_back(controller_view.get());
+        }
+    }
+
+    for (int hmd_id : hmd_manager->getOpenDeviceIds())
+    {
+        ServerHMDViewPtr hmd_view = hmd_manager->getHMDViewPtr(hmd_id);
+
+        if (hmd_view->getIsTrackingEnabled() &&
+            hmd_view->getTrackingColorID() != eCommonTrackingColorID::INVALID_COLOR)
+        {
+            tracked_hmds.push_back(hmd_view.get());
+        }
+    }
+
+    if (tracked_controllers.empty() && tracked_hmds.empty())
+    {
+        return;
+    }
+
+    // Visit each new video frame once for all of the tracked devices.
+    // Pipelined trackers also finish frames in between, so they are visited every update.
+    for (int tracker_id : m_openDeviceIds)
+    {
+        ServerTrackerViewPtr tracker_view = getTrackerViewPtr(tracker_id);
+
+        if (tracker_view->getHasUnpublishedState() || tracker_view->getHasOpticalPipeline())
+        {
+            tracker_view->computeProjectionsForTrackedDevices(tracked_controllers, tracked_hmds);
+        }
+    }
+}
+
+void
+TrackerManager::updateTrackerPoseCalibration(ControllerManager *controller_manager)
+{
+    if (m_pose_calibrator != nullptr)
+    {
+        m_pose_calibrator->update(this, controller_manager);
+    }
+}
+
+void
+TrackerManager::poll_devices()
+{
+    DeviceTypeManager::poll_devices();
+
+    // Refresh the tracker list as soon as a tracker node camera comes or goes
+    const TrackerNodeManager *tracker_node_manager = TrackerNodeManager::get_instance();
+    if (tracker_node_manager != nullptr)
+    {
+        const int revision = tracker_node_manager->getRemoteCameraListRevision();
+
+        if (revision != m_remote_camera_list_revision)
+        {
+            m_remote_camera_list_revision = revision;
+            mark_tracker_list_dirty();
+            m_bIsDeviceListDirty = true;
+        }
+    }
+}
+
 bool
 TrackerManager::can_update_connected_devices()
 {
@@ -232,7 +401,7 @@ TrackerManager::allocate_device_view(int device_id)
 ServerTrackerViewPtr
 TrackerManager::getTrackerViewPtr(int device_id) const
 {
-    assert(m_deviceViews != nullptr);
+    assert(ServerUtility::is_index_valid(device_id, static_cast<int>(m_deviceViews.size())));
 
     return std::static_pointer_cast<ServerTrackerView>(m_deviceViews[device_id]);
 }
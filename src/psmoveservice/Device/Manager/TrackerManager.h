@@ -14,6 +14,8 @@
 class ServerTrackerView;
 typedef std::shared_ptr<ServerTrackerView> ServerTrackerViewPtr;
 
+class TrackerPoseCalibrator;
+
 //-- definitions -----
 struct TrackerProfile
 {
@@ -58,6 +60,25 @@ public:
 	bool exclude_opposed_cameras;
 	float min_valid_projection_area;
 	bool disable_roi;
+	bool use_optical_pipeline; // search video frames on a per-tracker worker thread
+	int optical_pipeline_queue_depth; // video frames waiting on the worker thread (1 or 2)
+	bool use_lightbar_fast_path; // warm started closed form lightbar fit, full fit only on failure
+	bool use_occlusion_recovery; // search lost devices where they are expected to reappear instead of the whole frame
+	int recovery_pixel_budget; // pixels of recovery windows searched per tracker per frame
+	int recovery_full_scan_interval; // frames between full frame scans for devices a tracker lost
+	int recovery_full_scan_decimation; // full frame scans look at every Nth pixel in each direction
+	float recovery_max_dead_reckoning_time; // seconds after which the dead reckoned position is too stale to search around
+	float recovery_drift_cm_per_second; // growth of the recovery windows while the device is out of sight
+	bool use_auto_exposure; // adapt each tracker's exposure and gain to the brightness of the devices it finds
+	float auto_exposure_min; // exposure bounds of the adaptive control (tracker units)
+	float auto_exposure_max;
+	float auto_gain_min; // gain bounds of the adaptive control (tracker units)
+	float auto_gain_max;
+	int auto_exposure_interval_ms; // least time between adjustments, so the camera settles first
+	float auto_exposure_target_bulb_value; // mean HSV value (0-255) to aim for inside the found blobs
+	float auto_exposure_max_clipped_fraction; // darken once more of a blob than this is blown out
+	float auto_exposure_max_background_value; // darken once the rest of the ROIs are brighter than this (HSV value)
+	int max_tracker_count;
     TrackerProfile default_tracker_profile;
 	float global_forward_degrees;
 
@@ -75,13 +96,23 @@ public:
     TrackerManager();
 
     bool startup() override;
+    void shutdown() override;
 
     void closeAllTrackers();
 
+    /// Tracker-major optical pass.
+    /// Each tracker with a new video frame finds the projections of all tracked controllers and HMDs
+    /// in one sweep over the frame, then hands them to the device views.
+    void updateOpticalProjections(class ControllerManager *controller_manager, class HMDManager *hmd_manager);
+
+    /// Record samples for, or apply the result of, a running tracker pose calibration
+    void updateTrackerPoseCalibration(class ControllerManager *controller_manager);
+
     static const int k_max_devices = PSMOVESERVICE_MAX_TRACKER_COUNT;
+    static_assert(k_max_devices <= 32, "valid_tracker_bitmask in the data frames is a uint32");
     int getMaxDevices() const override
     {
-        return TrackerManager::k_max_devices;
+        return m_max_devices;
     }
 
     ServerTrackerViewPtr getTrackerViewPtr(int device_id) const;
@@ -102,12 +133,18 @@ public:
         return cfg;
     }
 
+    inline TrackerPoseCalibrator *getTrackerPoseCalibrator() const
+    {
+        return m_pose_calibrator;
+    }
+
     eCommonTrackingColorID allocateTrackingColorID();
     bool claimTrackingColorID(const class ServerControllerView *controller_view, eCommonTrackingColorID color_id);
     bool claimTrackingColorID(const class ServerHMDView *hmd_view, eCommonTrackingColorID color_id);
     void freeTrackingColorID(eCommonTrackingColorID color_id);
 
 protected:
+    void poll_devices() override;
     bool can_update_connected_devices() override;
     void mark_tracker_list_dirty();
 
@@ -120,6 +157,9 @@ private:
     std::deque<eCommonTrackingColorID> m_available_color_ids;
     TrackerManagerConfig cfg;
     bool m_tracker_list_dirty;
+    int m_remote_camera_list_revision;
+    int m_max_devices;
+    TrackerPoseCalibrator *m_pose_calibrator;
 };
 
 #endif // TRACKER_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,427 @@
+//-- includes -----
+#include "TrackerPoseCalibrator.h"
+#include "ControllerManager.h"
+#include "ServerControllerView.h"
+#include "ServerLog.h"
+#include "ServerTrackerView.h"
+#include "ServerUtility.h"
+#include "TrackerManager.h"
+
+#include <algorithm>
+
+//-- constants -----
+static const int k_default_sample_count = 300;
+static const int k_min_sample_count = 50;
+static const int k_max_sample_count = 2000;
+
+// Trackers aren't frame synchronized, so only sightings this close together in time
+// are treated as the same bulb location
+static const std::chrono::milliseconds k_max_sample_skew(10);
+// The bulb has to move at least this far between samples
+static const float k_min_sample_spacing_cm = 3.f;
+// Trackers are placed off of the samples they share with trackers that are already placed
+static const int k_min_shared_samples = 20;
+
+static const int k_max_solve_iterations = 100;
+// Sphere fit distances are only good to a few percent, so a centimeter of distance error
+// is weighted like a quarter pixel of reprojection error
+static const float k_distance_weight = 0.25f;
+static const float k_robust_threshold_pixels = 3.f;
+static const float k_max_rms_reprojection_error = 3.f;
+
+//-- public implementation -----
+TrackerPoseCalibrator::TrackerPoseCalibrator()
+    : WorkerThread("TrackerPoseCalibrator")
+    , m_bCancelRequested(false)
+    , m_bSolveSucceeded(false)
+    , m_phase(TrackerPoseCalibration_Idle)
+{
+    m_progress.clear();
+    m_progress.revision = 0;
+}
+
+TrackerPoseCalibrator::~TrackerPoseCalibrator()
+{
+    m_bCancelRequested = true;
+    stopThread();
+}
+
+bool TrackerPoseCalibrator::start(
+    TrackerManager *tracker_manager,
+    ControllerManager *controller_manager,
+    int controller_id,
+    int target_sample_count)
+{
+    if (getIsActive())
+    {
+        SERVER_LOG_WARNING("TrackerPoseCalibrator::start") << "Tracker pose calibration already running";
+        return false;
+    }
+
+    if (!ServerUtility::is_index_valid(controller_id, controller_manager->getMaxDevices()))
+    {
+        SERVER_LOG_ERROR("TrackerPoseCalibrator::start") << "Invalid controller id " << controller_id;
+        return false;
+    }
+
+    ServerControllerViewPtr controller_view = controller_manager->getControllerViewPtr(controller_id);
+    if (!controller_view->getIsOpen() || !controller_view->getIsTrackingEnabled())
+    {
+        SERVER_LOG_ERROR("TrackerPoseCalibrator::start") << "Controller " << controller_id << " isn't optically tracked";
+        return false;
+    }
+
+    const std::vector<int> &tracker_ids = tracker_manager->getOpenDeviceIds();
+    if (tracker_ids.size() < 2)
+    {
+        SERVER_LOG_ERROR("TrackerPoseCalibrator::start") << "Need at least two open trackers";
+        return false;
+    }
+
+    // Join the worker from a previous solve
+    stopThread();
+
+    TrackerPoseCalibrationProgress progress;
+    progress.clear();
+    progress.controller_id = controller_id;
+    progress.target_sample_count =
+        (target_sample_count > 0)
+        ? std::min(std::max(target_sample_count, k_min_sample_count), k_max_sample_count)
+        : k_default_sample_count;
+
+    // The lowest numbered tracker keeps its pose and anchors the world frame
+    std::vector<int> sorted_tracker_ids(tracker_ids);
+    std::sort(sorted_tracker_ids.begin(), sorted_tracker_ids.end());
+
+    m_cameras.clear();
+    for (int tracker_id : sorted_tracker_ids)
+    {
+        ServerTrackerViewPtr tracker_view = tracker_manager->getTrackerViewPtr(tracker_id);
+        const CommonDevicePose pose = tracker_view->getTrackerPose();
+        float k1, k2, k3, p1, p2;
+
+        EigenBundleAdjustmentCamera camera;
+        tracker_view->getCameraIntrinsics(
+            camera.focal_length_x, camera.focal_length_y,
+            camera.principal_x, camera.principal_y,
+            k1, k2, k3, p1, p2);
+        camera.orientation = Eigen::Quaternionf(pose.Orientation.w, pose.Orientation.x, pose.Orientation.y, pose.Orientation.z);
+        camera.position = Eigen::Vector3f(pose.PositionCm.x, pose.PositionCm.y, pose.PositionCm.z);
+        camera.bFixed = m_cameras.empty();
+
+        progress.tracker_ids[progress.tracker_count] = tracker_id;
+        progress.tracker_poses[progress.tracker_count] = pose;
+        ++progress.tracker_count;
+
+        m_cameras.push_back(camera);
+    }
+
+    m_observations.clear();
+    m_points.clear();
+    m_last_sample_positions.assign(m_cameras.size(), Eigen::Vector3f::Zero());
+    m_has_last_sample_position.assign(m_cameras.size(), false);
+    m_phase = TrackerPoseCalibration_Recording;
+    progress.phase = TrackerPoseCalibration_Recording;
+
+    {
+        std::lock_guard<std::mutex> lock(m_progress_mutex);
+
+        progress.revision = m_progress.revision + 1;
+        m_progress = progress;
+    }
+
+    SERVER_LOG_INFO("TrackerPoseCalibrator::start") <<
+        "Recording " << progress.target_sample_count << " samples of controller " << controller_id <<
+        " across " << progress.tracker_count << " trackers";
+
+    return true;
+}
+
+void TrackerPoseCalibrator::cancel()
+{
+    if (getIsActive())
+    {
+        m_bCancelRequested = true;
+        stopThread();
+
+        SERVER_LOG_INFO("TrackerPoseCalibrator::cancel") << "Tracker pose calibration canceled";
+        finish(TrackerPoseCalibration_Canceled);
+    }
+}
+
+void TrackerPoseCalibrator::update(
+    TrackerManager *tracker_manager,
+    ControllerManager *controller_manager)
+{
+    if (m_phase == TrackerPoseCalibration_Recording)
+    {
+        // The progress is only written on the main thread while recording
+        ServerControllerViewPtr controller_view = controller_manager->getControllerViewPtr(m_progress.controller_id);
+
+        if (!controller_view->getIsOpen() || !controller_view->getIsTrackingEnabled())
+        {
+            SERVER_LOG_ERROR("TrackerPoseCalibrator::update") << "Lost the controller while recording";
+            finish(TrackerPoseCalibration_Failed);
+            return;
+        }
+
+        recordSample(tracker_manager, controller_view.get());
+
+        if (static_cast<int>(m_points.size()) >= m_progress.target_sample_count)
+        {
+            beginSolve();
+        }
+    }
+    else if (m_phase == TrackerPoseCalibration_Solving && hasThreadEnded())
+    {
+        stopThread();
+
+        const float solve_seconds =
+            std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - m_solve_start_time).count();
+
+        if (m_bSolveSucceeded)
+        {
+            applySolution(tracker_manager);
+
+            SERVER_LOG_INFO("TrackerPoseCalibrator::update") <<
+                "Tracker poses solved in " << solve_seconds << "s";
+            finish(TrackerPoseCalibration_Succeeded);
+        }
+        else
+        {
+            SERVER_LOG_ERROR("TrackerPoseCalibrator::update") <<
+                "Tracker pose solve failed after " << solve_seconds << "s";
+            finish(TrackerPoseCalibration_Failed);
+        }
+    }
+}
+
+bool TrackerPoseCalibrator::getIsActive() const
+{
+    return m_phase == TrackerPoseCalibration_Recording || m_phase == TrackerPoseCalibration_Solving;
+}
+
+void TrackerPoseCalibrator::getProgress(TrackerPoseCalibrationProgress &out_progress) const
+{
+    std::lock_guard<std::mutex> lock(m_progress_mutex);
+
+    out_progress = m_progress;
+}
+
+//-- protected implementation -----
+bool TrackerPoseCalibrator::doWork()
+{
+    const int camera_count = static_cast<int>(m_cameras.size());
+    const int point_count = static_cast<int>(m_points.size());
+    const int observation_count = static_cast<int>(m_observations.size());
+
+    if (!eigen_bundle_adjustment_initialize(
+            m_cameras.data(), camera_count,
+            m_observations.data(), observation_count,
+            m_points.data(), point_count,
+            k_min_shared_samples))
+    {
+        SERVER_MT_LOG_ERROR("TrackerPoseCalibrator::doWork") <<
+            "Some trackers don't share enough samples with the others, move the controller where they overlap";
+        return false;
+    }
+
+    EigenBundleAdjustmentSettings settings;
+    settings.max_iterations = k_max_solve_iterations;
+    settings.distance_weight = k_distance_weight;
+    settings.robust_threshold = k_robust_threshold_pixels;
+    settings.progress_callback = [this](int iteration, float rms_reprojection_error) {
+        std::lock_guard<std::mutex> lock(m_progress_mutex);
+
+        m_progress.iteration = iteration;
+        m_progress.rms_reprojection_error = rms_reprojection_error;
+        ++m_progress.revision;
+
+        return !m_bCancelRequested.load();
+    };
+
+    EigenBundleAdjustmentResult result;
+    if (!eigen_bundle_adjustment_solve(
+            m_cameras.data(), camera_count,
+            m_points.data(), point_count,
+            m_observations.data(), observation_count,
+            settings, &result))
+    {
+        return false;
+    }
+
+    SERVER_MT_LOG_INFO("TrackerPoseCalibrator::doWork") <<
+        "Bundle adjustment took " << result.iterations << " iterations, RMS reprojection error " <<
+        result.initial_rms_reprojection_error << "px -> " << result.final_rms_reprojection_error << "px";
+
+    if (result.final_rms_reprojection_error > k_max_rms_reprojection_error)
+    {
+        SERVER_MT_LOG_ERROR("TrackerPoseCalibrator::doWork") <<
+            "RMS reprojection error above " << k_max_rms_reprojection_error << "px, not applying the solution";
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_progress_mutex);
+
+        for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+        {
+            const EigenBundleAdjustmentCamera &camera = m_cameras[camera_index];
+            CommonDevicePose &pose = m_progress.tracker_poses[camera_index];
+
+            pose.Orientation.w = camera.orientation.w();
+            pose.Orientation.x = camera.orientation.x();
+            pose.Orientation.y = camera.orientation.y();
+            pose.Orientation.z = camera.orientation.z();
+            pose.PositionCm.set(camera.position.x(), camera.position.y(), camera.position.z());
+        }
+        ++m_progress.revision;
+    }
+
+    m_bSolveSucceeded = true;
+
+    // The solve is done, let the thread end
+    return false;
+}
+
+//-- private implementation -----
+void TrackerPoseCalibrator::recordSample(
+    TrackerManager *tracker_manager,
+    ServerControllerView *controller_view)
+{
+    struct Sighting
+    {
+        int camera_index;
+        const ControllerOpticalPoseEstimation *estimate;
+    };
+
+    const int camera_count = static_cast<int>(m_cameras.size());
+    std::vector<Sighting> sightings;
+    std::chrono::time_point<std::chrono::high_resolution_clock> newest_timestamp;
+
+    for (int camera_index = 0; camera_index < camera_count; ++camera_index)
+    {
+        const int tracker_id = m_progress.tracker_ids[camera_index];
+        const ControllerOpticalPoseEstimation *estimate = controller_view->getTrackerPoseEstimate(tracker_id);
+
+        if (estimate != nullptr && estimate->bCurrentlyTracking && estimate->bValidTimestamps &&
+            estimate->position_cm.z > 0.f && tracker_manager->getTrackerViewPtr(tracker_id)->getIsOpen())
+        {
+            sightings.push_back({ camera_index, estimate });
+            newest_timestamp = std::max(newest_timestamp, estimate->last_visible_timestamp);
+        }
+    }
+
+    // Drop sightings of where the bulb was a frame or more ago
+    sightings.erase(
+        std::remove_if(sightings.begin(), sightings.end(), [newest_timestamp](const Sighting &sighting) {
+            return newest_timestamp - sighting.estimate->last_visible_timestamp > k_max_sample_skew;
+        }),
+        sightings.end());
+
+    if (sightings.size() < 2)
+    {
+        return;
+    }
+
+    // Skip samples bunched up where the bulb sat still
+    for (const Sighting &sighting : sightings)
+    {
+        const CommonDevicePosition &position = sighting.estimate->position_cm;
+
+        if (m_has_last_sample_position[sighting.camera_index] &&
+            (Eigen::Vector3f(position.x, position.y, position.z) - m_last_sample_positions[sighting.camera_index]).norm() <
+                k_min_sample_spacing_cm)
+        {
+            return;
+        }
+    }
+
+    const int point_index = static_cast<int>(m_points.size());
+    m_points.push_back(Eigen::Vector3f::Zero());
+
+    std::lock_guard<std::mutex> lock(m_progress_mutex);
+
+    for (const Sighting &sighting : sightings)
+    {
+        const EigenBundleAdjustmentCamera &camera = m_cameras[sighting.camera_index];
+        const CommonDevicePosition &position = sighting.estimate->position_cm;
+        const Eigen::Vector3f camera_relative_position(position.x, position.y, position.z);
+
+        // Use the projection of the sphere center rather than the ellipse center,
+        // which is off center whenever the bulb isn't in the middle of the view
+        EigenBundleAdjustmentObservation observation;
+        observation.camera_index = sighting.camera_index;
+        observation.point_index = point_index;
+        observation.pixel = Eigen::Vector2f(
+            camera.focal_length_x * position.x / position.z + camera.principal_x,
+            -camera.focal_length_y * position.y / position.z + camera.principal_y);
+        observation.camera_relative_position = camera_relative_position;
+        m_observations.push_back(observation);
+
+        m_last_sample_positions[sighting.camera_index] = camera_relative_position;
+        m_has_last_sample_position[sighting.camera_index] = true;
+        ++m_progress.tracker_sample_counts[sighting.camera_index];
+    }
+
+    m_progress.sample_count = static_cast<int>(m_points.size());
+    ++m_progress.revision;
+}
+
+void TrackerPoseCalibrator::beginSolve()
+{
+    SERVER_LOG_INFO("TrackerPoseCalibrator::beginSolve") <<
+        "Solving tracker poses from " << m_points.size() << " samples (" << m_observations.size() << " sightings)";
+
+    m_phase = TrackerPoseCalibration_Solving;
+    m_bCancelRequested = false;
+    m_bSolveSucceeded = false;
+    m_solve_start_time = std::chrono::high_resolution_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(m_progress_mutex);
+
+        m_progress.phase = TrackerPoseCalibration_Solving;
+        ++m_progress.revision;
+    }
+
+    startThread();
+}
+
+void TrackerPoseCalibrator::applySolution(TrackerManager *tracker_manager)
+{
+    TrackerPoseCalibrationProgress progress;
+    getProgress(progress);
+
+    for (int camera_index = 0; camera_index < progress.tracker_count; ++camera_index)
+    {
+        const int tracker_id = progress.tracker_ids[camera_index];
+        ServerTrackerViewPtr tracker_view = tracker_manager->getTrackerViewPtr(tracker_id);
+
+        if (m_cameras[camera_index].bFixed)
+        {
+            continue;
+        }
+
+        if (tracker_view->getIsOpen())
+        {
+            tracker_view->setTrackerPose(&progress.tracker_poses[camera_index]);
+            tracker_view->saveSettings();
+        }
+        else
+        {
+            SERVER_LOG_WARNING("TrackerPoseCalibrator::applySolution") <<
+                "Tracker " << tracker_id << " closed during calibration, its pose wasn't updated";
+        }
+    }
+}
+
+void TrackerPoseCalibrator::finish(eTrackerPoseCalibrationPhase phase)
+{
+    m_phase = phase;
+
+    std::lock_guard<std::mutex> lock(m_progress_mutex);
+
+    m_progress.phase = phase;
+    ++m_progress.revision;
+}
@@ -0,0 +1,115 @@
+#ifndef TRACKER_POSE_CALIBRATOR_H
+#define TRACKER_POSE_CALIBRATOR_H
+
+//-- includes -----
+#include "DeviceInterface.h"
+#include "MathBundleAdjustment.h"
+#include "PSMoveProtocolInterface.h"
+#include "WorkerThread.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+//-- definitions -----
+enum eTrackerPoseCalibrationPhase
+{
+    TrackerPoseCalibration_Idle,
+    TrackerPoseCalibration_Recording,
+    TrackerPoseCalibration_Solving,
+    TrackerPoseCalibration_Succeeded,
+    TrackerPoseCalibration_Failed,
+    TrackerPoseCalibration_Canceled
+};
+
+struct TrackerPoseCalibrationProgress
+{
+    eTrackerPoseCalibrationPhase phase;
+    int controller_id;
+    int sample_count;
+    int target_sample_count;
+    int iteration;
+    float rms_reprojection_error; // pixels
+    int tracker_count;
+    int tracker_ids[PSMOVESERVICE_MAX_TRACKER_COUNT];
+    int tracker_sample_counts[PSMOVESERVICE_MAX_TRACKER_COUNT];
+    CommonDevicePose tracker_poses[PSMOVESERVICE_MAX_TRACKER_COUNT];
+    int revision; // incremented on every change
+
+    inline void clear()
+    {
+        phase = TrackerPoseCalibration_Idle;
+        controller_id = -1;
+        sample_count = 0;
+        target_sample_count = 0;
+        iteration = 0;
+        rms_reprojection_error = 0.f;
+        tracker_count = 0;
+        for (int index = 0; index < PSMOVESERVICE_MAX_TRACKER_COUNT; ++index)
+        {
+            tracker_ids[index] = -1;
+            tracker_sample_counts[index] = 0;
+            tracker_poses[index].clear();
+        }
+    }
+};
+
+/// Solves for the poses of all open trackers in one pass.
+/// While recording, each update where at least two trackers saw the controller's bulb
+/// at about the same time (and the bulb moved far enough since the last one) becomes a sample.
+/// Once enough samples are recorded a worker thread jointly refines all of the tracker poses
+/// and bulb locations with a bundle adjustment. The lowest numbered tracker keeps its current
+/// pose and anchors the world frame, the sphere fit distances of the bulb fix the scale.
+/// The solved poses are applied and saved on the main thread.
+class TrackerPoseCalibrator : public WorkerThread
+{
+public:
+    TrackerPoseCalibrator();
+    virtual ~TrackerPoseCalibrator();
+
+    /// Main thread: begin recording the given controller. Fails if a calibration is already running.
+    bool start(
+        class TrackerManager *tracker_manager, class ControllerManager *controller_manager,
+        int controller_id, int target_sample_count);
+
+    /// Main thread: abandon a calibration that hasn't finished yet
+    void cancel();
+
+    /// Main thread: record samples or apply a finished solve
+    void update(class TrackerManager *tracker_manager, class ControllerManager *controller_manager);
+
+    /// True while recording or solving
+    bool getIsActive() const;
+
+    /// Any thread: copy of the current progress
+    void getProgress(TrackerPoseCalibrationProgress &out_progress) const;
+
+protected:
+    bool doWork() override;
+
+private:
+    void recordSample(class TrackerManager *tracker_manager, class ServerControllerView *controller_view);
+    void beginSolve();
+    void applySolution(class TrackerManager *tracker_manager);
+    void finish(eTrackerPoseCalibrationPhase phase);
+
+    // Multi-threaded state
+    mutable std::mutex m_progress_mutex;
+    TrackerPoseCalibrationProgress m_progress;
+    std::atomic_bool m_bCancelRequested;
+    std::atomic_bool m_bSolveSucceeded;
+
+    // Main thread state while recording, worker thread state while solving
+    std::vector<EigenBundleAdjustmentCamera, Eigen::aligned_allocator<EigenBundleAdjustmentCamera> > m_cameras;
+    std::vector<EigenBundleAdjustmentObservation, Eigen::aligned_allocator<EigenBundleAdjustmentObservation> > m_observations;
+    std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > m_points;
+
+    // Main thread state
+    eTrackerPoseCalibrationPhase m_phase;
+    std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > m_last_sample_positions; // per camera
+    std::vector<bool> m_has_last_sample_position;
+    std::chrono::time_point<std::chrono::high_resolution_clock> m_solve_start_time;
+};
+
+#endif // TRACKER_POSE_CALIBRATOR_H
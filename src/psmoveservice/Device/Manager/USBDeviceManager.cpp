@@ -5,6 +5,7 @@
 #include "LibUSBBulkTransferBundle.h"
 #include "LibUSBApi.h"
 #include "NullUSBApi.h"
+#include "SimulatedUSBApi.h"
 #include "ServerLog.h"
 #include "ServerUtility.h"
 
@@ -24,6 +25,7 @@ typedef std::pair<t_usb_device_handle, USBDeviceState *> t_handle_usb_device_pai
 const char * k_nullusb_api_name= "nullusb_api";
 const char * k_libusb_api_name= "libusb_api";
 const char * k_winusb_api_name= "winusb_api";
+const char * k_simulatedusb_api_name= "simulatedusb_api";
 
 //-- private implementation -----
 
@@ -72,9 +74,10 @@ USBManagerConfig::ptree2config(const boost::property_tree::ptree &pt)
 class USBDeviceManagerImpl
 {
 public:
-    USBDeviceManagerImpl()
+    USBDeviceManagerImpl(IUSBApi *usb_api_override)
         : m_api_type(_USBApiType_INVALID)
-		, m_usb_api(nullptr)
+		, m_usb_api(usb_api_override)
+		, m_usb_api_started(false)
         , m_exit_signaled({ false })
         , m_active_control_transfers(0)
 		, m_active_interrupt_transfers(0)
@@ -96,7 +99,11 @@ public:
 
 		m_transfers_enabled= cfg.enable_usb_transfers;
 
-		if (m_usb_api == nullptr)
+		if (m_usb_api != nullptr && !m_usb_api_started)
+		{
+			SERVER_LOG_INFO("USBAsyncRequestManager::startup") << "Using USB API provided by the caller";
+		}
+		else if (m_usb_api == nullptr)
 		{
 			if (cfg.usb_api_name == k_nullusb_api_name)
 			{
@@ -113,6 +120,11 @@ public:
 				SERVER_LOG_INFO("USBAsyncRequestManager::startup") << "Requested WinUSBApi";
 				m_api_type= _USBApiType_WinUSB;
 			}
+			else if (cfg.usb_api_name == k_simulatedusb_api_name)
+			{
+				SERVER_LOG_INFO("USBAsyncRequestManager::startup") << "Requested SimulatedUSBApi";
+				m_api_type= _USBApiType_SimulatedUSB;
+			}
 			else
 			{
 				SERVER_LOG_WARNING("USBAsyncRequestManager::startup") << "Requested unknown usb_api: \'" << cfg.usb_api_name << "\'. Defaulting to " << k_libusb_api_name;
@@ -136,11 +148,22 @@ public:
 				SERVER_LOG_INFO("USBAsyncRequestManager::startup") << "Creating LibUSBApi (WinUSBApi not yet implemented)";
 				m_usb_api = new LibUSBApi;
 				break;
+			case _USBApiType_SimulatedUSB:
+				SERVER_LOG_INFO("USBAsyncRequestManager::startup") << "Creating SimulatedUSBApi";
+				m_usb_api = new SimulatedUSBApi;
+				break;
 			default:
 				assert(0 && "unreachable");
 				break;
 			}
+		}
+		else
+		{
+			SERVER_LOG_WARNING("USBAsyncRequestManager::startup") << "USB API aready initialized";
+		}
 
+		if (m_usb_api != nullptr && !m_usb_api_started)
+		{
 			if (m_usb_api->startup())
 			{
 				SERVER_LOG_INFO("USBAsyncRequestManager::startup") << "Initialized USB API";
@@ -149,10 +172,8 @@ public:
 			{
 				SERVER_LOG_ERROR("USBAsyncRequestManager::startup") << "Failed to initialize USB API";
 			}
-		}
-		else
-		{
-			SERVER_LOG_WARNING("USBAsyncRequestManager::startup") << "USB API aready initialized";
+
+			m_usb_api_started= true;
 		}
 
         return bSuccess;
@@ -163,6 +184,12 @@ public:
         // If the thread terminated, reset the started and exited flags
         if (m_exit_signaled)
         {
+            // The thread exits on its own once its bulk transfers are gone
+            if (m_worker_thread.joinable())
+            {
+                m_worker_thread.join();
+            }
+
             m_thread_started= false;
             m_exit_signaled= false;
         }
@@ -177,6 +204,9 @@ public:
 					processResults();
 				}
 
+				// Pick up any results the worker thread posted right before it exited
+				processResults();
+
 				// If there are bulk transfers now active, start up the worker thread to manage them
 				if (m_active_bulk_transfer_bundles.size() > 0)
 				{
@@ -213,6 +243,7 @@ public:
             // Free the usb context
 			delete m_usb_api;
             m_usb_api= nullptr;
+			m_usb_api_started= false;
 			m_api_type = _USBApiType_INVALID;
         }
     }
@@ -511,15 +542,19 @@ protected:
 
     void cleanupCanceledRequests(bool bForceCleanup)
     {
-        for (auto it = m_canceled_bulk_transfer_bundles.begin(); it != m_canceled_bulk_transfer_bundles.end(); ++it)
+        for (auto it = m_canceled_bulk_transfer_bundles.begin(); it != m_canceled_bulk_transfer_bundles.end(); )
         {
             IUSBBulkTransferBundle *bundle = *it;
 
             if (bundle->getActiveTransferCount() == 0 || bForceCleanup)
             {
-                m_canceled_bulk_transfer_bundles.erase(it);
+                it = m_canceled_bulk_transfer_bundles.erase(it);
                 delete bundle;
             }
+            else
+            {
+                ++it;
+            }
         }
     }
 
@@ -811,6 +846,7 @@ private:
     // Multithreaded state
 	eUSBApiType m_api_type;
 	IUSBApi *m_usb_api;
+	bool m_usb_api_started;
     bool m_bUseMultithreading;
     std::atomic_bool m_exit_signaled;
     boost::lockfree::spsc_queue<USBTransferRequestState, boost::lockfree::capacity<128> > request_queue;
@@ -834,9 +870,9 @@ private:
 //-- public interface -----
 USBDeviceManager *USBDeviceManager::m_instance = NULL;
 
-USBDeviceManager::USBDeviceManager()
+USBDeviceManager::USBDeviceManager(IUSBApi *usb_api_override)
     : m_cfg()
-	, m_implementation_ptr(new USBDeviceManagerImpl())
+	, m_implementation_ptr(new USBDeviceManagerImpl(usb_api_override))
 {
 	m_cfg.load();
 
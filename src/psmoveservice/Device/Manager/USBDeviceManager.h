@@ -14,6 +14,7 @@ enum eUSBApiType
 	_USBApiType_NullUSB,
 	_USBApiType_LibUSB,
 	_USBApiType_WinUSB,
+	_USBApiType_SimulatedUSB,
 };
 
 //-- definitions -----
@@ -36,7 +37,8 @@ public:
 class USBDeviceManager
 {
 public:
-    USBDeviceManager();
+    /// Uses the usb api named in the config unless an api is given (takes ownership of it)
+    USBDeviceManager(class IUSBApi *usb_api_override = nullptr);
     virtual ~USBDeviceManager();
 
     static inline USBDeviceManager *getInstance()
@@ -0,0 +1,597 @@
+//-- includes -----
+#include "SimulatedUSBApi.h"
+#include "ServerLog.h"
+#include "USBDeviceManager.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+#include <thread>
+
+//-- constants -----
+#define USB_ENDPOINT_DIR_MASK 0x80
+#define USB_ENDPOINT_IN 0x80
+
+// Same as the libusb event timeout used by LibUSBApi::poll()
+static const std::chrono::milliseconds k_max_poll_wait(50);
+
+//-- definitions -----
+struct SimulatedUSBDeviceState : USBDeviceState
+{
+	int device_index;
+};
+
+//-- SimulatedUSBDeviceDesc -----
+SimulatedUSBDeviceDesc::SimulatedUSBDeviceDesc()
+	: path()
+	, interrupt_latency_us(1000)
+	, control_latency_us(500)
+	, bulk_latency_us(1000)
+	, bulk_transfer_rate(0)
+{
+	filter.vendor_id = 0;
+	filter.product_id = 0;
+}
+
+//-- SimulatedUSBApiConfig -----
+const int SimulatedUSBApiConfig::CONFIG_VERSION = 1;
+
+SimulatedUSBApiConfig::SimulatedUSBApiConfig(const std::string &fnamebase)
+	: PSMoveConfig(fnamebase)
+	, version(CONFIG_VERSION)
+{
+	// Default to a single PS3Eye streaming 640x480 Bayer frames at 60fps in 64KB bulk transfers
+	SimulatedUSBDeviceDesc ps3eye;
+	ps3eye.filter.vendor_id = 0x1415;
+	ps3eye.filter.product_id = 0x2000;
+	ps3eye.path = "simulated_ps3eye_0";
+	ps3eye.bulk_transfer_rate = (640 * 480 * 60) / 65536;
+	devices.push_back(ps3eye);
+}
+
+const boost::property_tree::ptree
+SimulatedUSBApiConfig::config2ptree()
+{
+	boost::property_tree::ptree pt;
+
+	pt.put("version", SimulatedUSBApiConfig::CONFIG_VERSION);
+	pt.put("device_count", devices.size());
+
+	for (size_t device_index = 0; device_index < devices.size(); ++device_index)
+	{
+		const SimulatedUSBDeviceDesc &device = devices[device_index];
+		const std::string prefix = "device_" + std::to_string(device_index) + ".";
+
+		pt.put(prefix + "vendor_id", device.filter.vendor_id);
+		pt.put(prefix + "product_id", device.filter.product_id);
+		pt.put(prefix + "path", device.path);
+		pt.put(prefix + "interrupt_latency_us", device.interrupt_latency_us);
+		pt.put(prefix + "control_latency_us", device.control_latency_us);
+		pt.put(prefix + "bulk_latency_us", device.bulk_latency_us);
+		pt.put(prefix + "bulk_transfer_rate", device.bulk_transfer_rate);
+	}
+
+	return pt;
+}
+
+void
+SimulatedUSBApiConfig::ptree2config(const boost::property_tree::ptree &pt)
+{
+	version = pt.get<int>("version", 0);
+
+	if (version == SimulatedUSBApiConfig::CONFIG_VERSION)
+	{
+		const int device_count = pt.get<int>("device_count", 0);
+
+		devices.clear();
+		for (int device_index = 0; device_index < device_count; ++device_index)
+		{
+			const std::string prefix = "device_" + std::to_string(device_index) + ".";
+			SimulatedUSBDeviceDesc device;
+
+			device.filter.vendor_id = pt.get<unsigned short>(prefix + "vendor_id", device.filter.vendor_id);
+			device.filter.product_id = pt.get<unsigned short>(prefix + "product_id", device.filter.product_id);
+			device.path = pt.get<std::string>(prefix + "path", "simulated_" + std::to_string(device_index));
+			device.interrupt_latency_us = pt.get<int>(prefix + "interrupt_latency_us", device.interrupt_latency_us);
+			device.control_latency_us = pt.get<int>(prefix + "control_latency_us", device.control_latency_us);
+			device.bulk_latency_us = pt.get<int>(prefix + "bulk_latency_us", device.bulk_latency_us);
+			device.bulk_transfer_rate = pt.get<int>(prefix + "bulk_transfer_rate", device.bulk_transfer_rate);
+
+			devices.push_back(device);
+		}
+	}
+	else
+	{
+		SERVER_LOG_WARNING("SimulatedUSBApiConfig") <<
+			"Config version " << version << " does not match expected version " <<
+			SimulatedUSBApiConfig::CONFIG_VERSION << ", Using defaults.";
+	}
+}
+
+//-- SimulatedUSBApi -----
+SimulatedUSBApi::SimulatedUSBApi()
+	: IUSBApi()
+	, m_nextDataByte(0)
+{
+	SimulatedUSBApiConfig cfg;
+
+	cfg.load();
+
+	// Save the config back out in case it doesn't exist
+	cfg.save();
+
+	m_deviceTable = cfg.devices;
+}
+
+SimulatedUSBApi::SimulatedUSBApi(const std::vector<SimulatedUSBDeviceDesc> &device_table)
+	: IUSBApi()
+	, m_deviceTable(device_table)
+	, m_nextDataByte(0)
+{
+}
+
+SimulatedUSBApi::~SimulatedUSBApi()
+{
+	// Bundles are owned by the USBDeviceManager, which cleans them up before the api
+	assert(m_bulkTransferBundles.size() == 0);
+
+	for (PendingTransfer &transfer : m_pendingTransfers)
+	{
+		delete transfer.requestStateOnHeap;
+	}
+	m_pendingTransfers.clear();
+}
+
+bool SimulatedUSBApi::startup()
+{
+	SERVER_LOG_INFO("SimulatedUSBApi::startup") << "Simulating " << m_deviceTable.size() << " USB device(s)";
+
+	return true;
+}
+
+void SimulatedUSBApi::poll()
+{
+	t_sim_time now = std::chrono::steady_clock::now();
+	t_sim_time next_event_time;
+
+	// Like libusb, block until something completes or the poll times out
+	if (getNextEventTime(next_event_time))
+	{
+		if (next_event_time > now)
+		{
+			std::this_thread::sleep_until(std::min(next_event_time, now + k_max_poll_wait));
+			now = std::chrono::steady_clock::now();
+		}
+	}
+	else
+	{
+		return;
+	}
+
+	// Complete every interrupt and control transfer that's due
+	auto first_pending = std::partition(
+		m_pendingTransfers.begin(), m_pendingTransfers.end(),
+		[&now](const PendingTransfer &transfer) { return transfer.completion_time <= now; });
+	std::vector<PendingTransfer> completed_transfers(m_pendingTransfers.begin(), first_pending);
+	m_pendingTransfers.erase(m_pendingTransfers.begin(), first_pending);
+
+	std::sort(completed_transfers.begin(), completed_transfers.end(),
+		[](const PendingTransfer &a, const PendingTransfer &b) { return a.completion_time < b.completion_time; });
+	for (PendingTransfer &transfer : completed_transfers)
+	{
+		completeTransfer(transfer.requestStateOnHeap);
+
+		// Free request state stored in the heap now that the result is posted
+		delete transfer.requestStateOnHeap;
+	}
+
+	// Hand out bulk data (a data callback may not destroy bundles, so iterating is safe)
+	for (SimulatedUSBBulkTransferBundle *bundle : m_bulkTransferBundles)
+	{
+		bundle->processEvents(now);
+	}
+}
+
+void SimulatedUSBApi::shutdown()
+{
+}
+
+USBDeviceEnumerator* SimulatedUSBApi::device_enumerator_create()
+{
+	USBDeviceEnumerator *enumerator = new USBDeviceEnumerator;
+	memset(enumerator, 0, sizeof(USBDeviceEnumerator));
+
+	return enumerator;
+}
+
+bool SimulatedUSBApi::device_enumerator_is_valid(USBDeviceEnumerator* enumerator)
+{
+	return enumerator != nullptr && enumerator->device_index < static_cast<int>(m_deviceTable.size());
+}
+
+bool SimulatedUSBApi::device_enumerator_get_filter(const USBDeviceEnumerator* enumerator, USBDeviceFilter *outDeviceInfo) const
+{
+	bool bSuccess = false;
+
+	if (enumerator->device_index < static_cast<int>(m_deviceTable.size()))
+	{
+		*outDeviceInfo = m_deviceTable[enumerator->device_index].filter;
+		bSuccess = true;
+	}
+
+	return bSuccess;
+}
+
+bool SimulatedUSBApi::device_enumerator_get_path(const USBDeviceEnumerator* enumerator, char *outBuffer, size_t bufferSize) const
+{
+	bool bSuccess = false;
+
+	if (enumerator->device_index < static_cast<int>(m_deviceTable.size()))
+	{
+		strncpy(outBuffer, m_deviceTable[enumerator->device_index].path.c_str(), bufferSize);
+		outBuffer[bufferSize - 1] = '\0';
+		bSuccess = true;
+	}
+
+	return bSuccess;
+}
+
+void SimulatedUSBApi::device_enumerator_next(USBDeviceEnumerator* enumerator)
+{
+	if (device_enumerator_is_valid(enumerator))
+	{
+		++enumerator->device_index;
+	}
+}
+
+void SimulatedUSBApi::device_enumerator_dispose(USBDeviceEnumerator* enumerator)
+{
+	delete enumerator;
+}
+
+USBDeviceState *SimulatedUSBApi::open_usb_device(USBDeviceEnumerator* enumerator)
+{
+	SimulatedUSBDeviceState *device_state = nullptr;
+
+	if (device_enumerator_is_valid(enumerator))
+	{
+		device_state = new SimulatedUSBDeviceState;
+		device_state->clear();
+		device_state->device_index = enumerator->device_index;
+	}
+
+	return device_state;
+}
+
+void SimulatedUSBApi::close_usb_device(USBDeviceState* device_state)
+{
+	delete static_cast<SimulatedUSBDeviceState *>(device_state);
+}
+
+bool SimulatedUSBApi::can_usb_device_be_opened(USBDeviceEnumerator* enumerator, char *outReason, size_t bufferSize)
+{
+	const bool bCanOpen = device_enumerator_is_valid(enumerator);
+
+	strncpy(outReason, bCanOpen ? "SUCCESS(simulated device)" : "FAILED(no such simulated device)", bufferSize);
+
+	return bCanOpen;
+}
+
+eUSBResultCode SimulatedUSBApi::submit_interrupt_transfer(
+	const USBDeviceState* device_state,
+	const USBTransferRequestState *requestState)
+{
+	const SimulatedUSBDeviceDesc *device_desc = getDeviceDesc(device_state);
+
+	if (device_desc == nullptr)
+	{
+		return _USBResultCode_BadHandle;
+	}
+
+	PendingTransfer transfer;
+	transfer.completion_time = std::chrono::steady_clock::now() + std::chrono::microseconds(device_desc->interrupt_latency_us);
+	transfer.requestStateOnHeap = new USBTransferRequestState(*requestState);
+	m_pendingTransfers.push_back(transfer);
+
+	return _USBResultCode_Started;
+}
+
+eUSBResultCode SimulatedUSBApi::submit_control_transfer(
+	const USBDeviceState* device_state,
+	const USBTransferRequestState *requestState)
+{
+	const SimulatedUSBDeviceDesc *device_desc = getDeviceDesc(device_state);
+
+	if (device_desc == nullptr)
+	{
+		return _USBResultCode_BadHandle;
+	}
+
+	PendingTransfer transfer;
+	transfer.completion_time = std::chrono::steady_clock::now() + std::chrono::microseconds(device_desc->control_latency_us);
+	transfer.requestStateOnHeap = new USBTransferRequestState(*requestState);
+	m_pendingTransfers.push_back(transfer);
+
+	return _USBResultCode_Started;
+}
+
+IUSBBulkTransferBundle *SimulatedUSBApi::allocate_bulk_transfer_bundle(const USBDeviceState *device_state, const USBRequestPayload_BulkTransfer *request)
+{
+	const SimulatedUSBDeviceDesc *device_desc = getDeviceDesc(device_state);
+	assert(device_desc != nullptr);
+
+	return new SimulatedUSBBulkTransferBundle(this, *device_desc, device_state, request);
+}
+
+bool SimulatedUSBApi::get_usb_device_filter(const USBDeviceState* device_state, struct USBDeviceFilter *outDeviceInfo) const
+{
+	const SimulatedUSBDeviceDesc *device_desc = getDeviceDesc(device_state);
+	bool bSuccess = false;
+
+	if (device_desc != nullptr)
+	{
+		*outDeviceInfo = device_desc->filter;
+		bSuccess = true;
+	}
+
+	return bSuccess;
+}
+
+bool SimulatedUSBApi::get_usb_device_path(USBDeviceState* device_state, char *outBuffer, size_t bufferSize) const
+{
+	const SimulatedUSBDeviceDesc *device_desc = getDeviceDesc(device_state);
+	bool bSuccess = false;
+
+	if (device_desc != nullptr)
+	{
+		strncpy(outBuffer, device_desc->path.c_str(), bufferSize);
+		outBuffer[bufferSize - 1] = '\0';
+		bSuccess = true;
+	}
+
+	return bSuccess;
+}
+
+bool SimulatedUSBApi::get_usb_device_port_path(USBDeviceState* device_state, char *outBuffer, size_t bufferSize) const
+{
+	bool bSuccess = false;
+
+	if (device_state != nullptr)
+	{
+		// Every simulated device sits on its own port of a fake root hub
+		const SimulatedUSBDeviceState *simulated_device_state = static_cast<const SimulatedUSBDeviceState *>(device_state);
+
+		snprintf(outBuffer, bufferSize, "sim:%d", simulated_device_state->device_index + 1);
+		bSuccess = true;
+	}
+
+	return bSuccess;
+}
+
+//-- SimulatedUSBApi private methods -----
+const SimulatedUSBDeviceDesc *SimulatedUSBApi::getDeviceDesc(const USBDeviceState* device_state) const
+{
+	const SimulatedUSBDeviceDesc *device_desc = nullptr;
+
+	if (device_state != nullptr)
+	{
+		const int device_index = static_cast<const SimulatedUSBDeviceState *>(device_state)->device_index;
+
+		if (device_index >= 0 && device_index < static_cast<int>(m_deviceTable.size()))
+		{
+			device_desc = &m_deviceTable[device_index];
+		}
+	}
+
+	return device_desc;
+}
+
+bool SimulatedUSBApi::getNextEventTime(t_sim_time &out_time) const
+{
+	bool bHasEvent = false;
+
+	for (const PendingTransfer &transfer : m_pendingTransfers)
+	{
+		if (!bHasEvent || transfer.completion_time < out_time)
+		{
+			out_time = transfer.completion_time;
+			bHasEvent = true;
+		}
+	}
+
+	for (const SimulatedUSBBulkTransferBundle *bundle : m_bulkTransferBundles)
+	{
+		t_sim_time bundle_event_time;
+
+		if (bundle->getNextEventTime(bundle_event_time) &&
+			(!bHasEvent || bundle_event_time < out_time))
+		{
+			out_time = bundle_event_time;
+			bHasEvent = true;
+		}
+	}
+
+	return bHasEvent;
+}
+
+void SimulatedUSBApi::completeTransfer(const USBTransferRequestState *requestState)
+{
+	USBTransferResult result;
+
+	memset(&result, 0, sizeof(USBTransferResult));
+
+	if (requestState->request.request_type == _USBRequestType_InterruptTransfer)
+	{
+		const USBRequestPayload_InterruptTransfer &request = requestState->request.payload.interrupt_transfer;
+		const int length = std::min(static_cast<int>(request.length), MAX_INTERRUPT_TRANSFER_PAYLOAD);
+
+		result.result_type = _USBResultType_InterrupTransfer;
+		result.payload.interrupt_transfer.usb_device_handle = request.usb_device_handle;
+		result.payload.interrupt_transfer.result_code = _USBResultCode_Completed;
+		result.payload.interrupt_transfer.dataLength = length;
+
+		// Reads get a running byte pattern so consumers can tell reports apart
+		if ((request.endpoint & USB_ENDPOINT_DIR_MASK) == USB_ENDPOINT_IN)
+		{
+			for (int byte_index = 0; byte_index < length; ++byte_index)
+			{
+				result.payload.interrupt_transfer.data[byte_index] = m_nextDataByte++;
+			}
+		}
+	}
+	else
+	{
+		const USBRequestPayload_ControlTransfer &request = requestState->request.payload.control_transfer;
+		const int length = std::min(static_cast<int>(request.wLength), MAX_CONTROL_TRANSFER_PAYLOAD);
+
+		result.result_type = _USBResultType_ControlTransfer;
+		result.payload.control_transfer.usb_device_handle = request.usb_device_handle;
+		result.payload.control_transfer.result_code = _USBResultCode_Completed;
+		result.payload.control_transfer.dataLength = length;
+
+		// Reads return zeroed registers
+	}
+
+	// Add the result to the outgoing result queue
+	usb_device_post_transfer_result(result, requestState->callback);
+}
+
+//-- SimulatedUSBBulkTransferBundle -----
+SimulatedUSBBulkTransferBundle::SimulatedUSBBulkTransferBundle(
+	SimulatedUSBApi *api,
+	const SimulatedUSBDeviceDesc &device_desc,
+	const USBDeviceState *device_state,
+	const struct USBRequestPayload_BulkTransfer *request)
+	: IUSBBulkTransferBundle(device_state, request)
+	, m_api(api)
+	, m_deviceDesc(device_desc)
+	, m_request(*request)
+	, m_packetBuffer()
+	, m_inFlightSubmitTimes()
+	, m_lastCompletionTime()
+	, m_packetSequence(0)
+	, m_bCanceled(false)
+{
+	m_api->m_bulkTransferBundles.push_back(this);
+}
+
+SimulatedUSBBulkTransferBundle::~SimulatedUSBBulkTransferBundle()
+{
+	std::vector<SimulatedUSBBulkTransferBundle *> &bundles = m_api->m_bulkTransferBundles;
+
+	bundles.erase(std::remove(bundles.begin(), bundles.end(), this), bundles.end());
+}
+
+bool SimulatedUSBBulkTransferBundle::initialize()
+{
+	if (m_request.transfer_packet_size <= 0 || m_request.in_flight_transfer_packet_count <= 0)
+	{
+		return false;
+	}
+
+	m_packetBuffer.resize(m_request.transfer_packet_size);
+
+	return true;
+}
+
+bool SimulatedUSBBulkTransferBundle::startTransfers()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	m_bCanceled = false;
+	while (static_cast<int>(m_inFlightSubmitTimes.size()) < m_request.in_flight_transfer_packet_count)
+	{
+		m_inFlightSubmitTimes.push_back(now);
+	}
+
+	return true;
+}
+
+void SimulatedUSBBulkTransferBundle::cancelTransfers()
+{
+	// The in-flight transfers report back as canceled on the next poll
+	m_bCanceled = true;
+}
+
+const USBRequestPayload_BulkTransfer &SimulatedUSBBulkTransferBundle::getTransferRequest() const
+{
+	return m_request;
+}
+
+t_usb_device_handle SimulatedUSBBulkTransferBundle::getUSBDeviceHandle() const
+{
+	return m_request.usb_device_handle;
+}
+
+int SimulatedUSBBulkTransferBundle::getActiveTransferCount() const
+{
+	return static_cast<int>(m_inFlightSubmitTimes.size());
+}
+
+bool SimulatedUSBBulkTransferBundle::getNextEventTime(std::chrono::steady_clock::time_point &out_time) const
+{
+	if (m_inFlightSubmitTimes.empty())
+	{
+		return false;
+	}
+
+	// Cancellations complete right away
+	out_time = m_bCanceled ? m_inFlightSubmitTimes.front() : getNextCompletionTime();
+
+	return true;
+}
+
+void SimulatedUSBBulkTransferBundle::processEvents(const std::chrono::steady_clock::time_point &now)
+{
+	if (m_bCanceled)
+	{
+		m_inFlightSubmitTimes.clear();
+		return;
+	}
+
+	while (!m_inFlightSubmitTimes.empty())
+	{
+		const std::chrono::steady_clock::time_point completion_time = getNextCompletionTime();
+
+		if (completion_time > now)
+		{
+			break;
+		}
+
+		m_inFlightSubmitTimes.pop_front();
+		m_lastCompletionTime = completion_time;
+
+		// Stamp the packet with a sequence number so consumers can check for gaps
+		memcpy(m_packetBuffer.data(), &m_packetSequence, std::min(sizeof(m_packetSequence), m_packetBuffer.size()));
+		++m_packetSequence;
+
+		// NOTE: This callback is getting executed on the worker thread, same as with libusb
+		m_request.on_data_callback(
+			m_packetBuffer.data(),
+			static_cast<int>(m_packetBuffer.size()),
+			m_request.transfer_callback_userdata);
+
+		if (m_request.bAutoResubmit)
+		{
+			m_inFlightSubmitTimes.push_back(completion_time);
+		}
+	}
+}
+
+std::chrono::steady_clock::time_point SimulatedUSBBulkTransferBundle::getNextCompletionTime() const
+{
+	assert(!m_inFlightSubmitTimes.empty());
+	std::chrono::steady_clock::time_point completion_time =
+		m_inFlightSubmitTimes.front() + std::chrono::microseconds(m_deviceDesc.bulk_latency_us);
+
+	// The device can only fill so many transfers per second
+	if (m_deviceDesc.bulk_transfer_rate > 0)
+	{
+		const std::chrono::steady_clock::time_point earliest_time =
+			m_lastCompletionTime + std::chrono::microseconds(1000000 / m_deviceDesc.bulk_transfer_rate);
+
+		completion_time = std::max(completion_time, earliest_time);
+	}
+
+	return completion_time;
+}
@@ -0,0 +1,136 @@
+#ifndef SIMULATED_USB_API_H
+#define SIMULATED_USB_API_H
+
+//-- includes -----
+#include "PSMoveConfig.h"
+#include "USBApiInterface.h"
+#include "USBDeviceInfo.h"
+#include "USBDeviceRequest.h"
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+//-- definitions -----
+/// A fake device the SimulatedUSBApi enumerates, along with how fast it answers transfers
+struct SimulatedUSBDeviceDesc
+{
+	USBDeviceFilter filter;
+	std::string path;
+	int interrupt_latency_us; // submit -> completion of an interrupt transfer
+	int control_latency_us; // submit -> completion of a control transfer
+	int bulk_latency_us; // submit -> earliest completion of a bulk transfer
+	int bulk_transfer_rate; // bulk transfers the device can fill per second (0 = only limited by latency)
+
+	SimulatedUSBDeviceDesc();
+};
+
+/// Device table for the SimulatedUSBApi, used when the USBManagerConfig asks for "simulatedusb_api"
+class SimulatedUSBApiConfig : public PSMoveConfig
+{
+public:
+	static const int CONFIG_VERSION;
+
+	SimulatedUSBApiConfig(const std::string &fnamebase = "SimulatedUSBApiConfig");
+
+	virtual const boost::property_tree::ptree config2ptree();
+	virtual void ptree2config(const boost::property_tree::ptree &pt);
+
+	long version;
+	std::vector<SimulatedUSBDeviceDesc> devices;
+};
+
+/// A scriptable stand-in for real USB hardware.
+/// Enumerates a table of fake devices and completes their interrupt, control and bulk transfers
+/// at the latencies and rates given in the table. Completions are generated in poll(),
+/// so they happen on whichever thread the USBDeviceManager polls the api from, same as libusb.
+class SimulatedUSBApi : public IUSBApi
+{
+public:
+	SimulatedUSBApi(); // device table from the SimulatedUSBApiConfig
+	SimulatedUSBApi(const std::vector<SimulatedUSBDeviceDesc> &device_table);
+	virtual ~SimulatedUSBApi();
+
+	bool startup() override;
+	void poll() override;
+	void shutdown() override;
+
+	USBDeviceEnumerator* device_enumerator_create() override;
+	bool device_enumerator_get_filter(const USBDeviceEnumerator* enumerator, struct USBDeviceFilter *outDeviceInfo) const override;
+	bool device_enumerator_get_path(const USBDeviceEnumerator* enumerator, char *outBuffer, size_t bufferSize) const override;
+	bool device_enumerator_is_valid(USBDeviceEnumerator* enumerator) override;
+	void device_enumerator_next(USBDeviceEnumerator* enumerator) override;
+	void device_enumerator_dispose(USBDeviceEnumerator* enumerator) override;
+
+	USBDeviceState *open_usb_device(USBDeviceEnumerator* enumerator) override;
+	void close_usb_device(USBDeviceState* device_state) override;
+	bool can_usb_device_be_opened(struct USBDeviceEnumerator* enumerator, char *outReason, size_t bufferSize) override;
+
+	eUSBResultCode submit_interrupt_transfer(const USBDeviceState* device_state, const struct USBTransferRequestState *requestState) override;
+	eUSBResultCode submit_control_transfer(const USBDeviceState* device_state, const struct USBTransferRequestState *requestState) override;
+	IUSBBulkTransferBundle *allocate_bulk_transfer_bundle(const USBDeviceState *device_state, const struct USBRequestPayload_BulkTransfer *request) override;
+
+	bool get_usb_device_filter(const USBDeviceState* device_state, struct USBDeviceFilter *outDeviceInfo) const override;
+	bool get_usb_device_path(USBDeviceState* device_state, char *outBuffer, size_t bufferSize) const override;
+	bool get_usb_device_port_path(USBDeviceState* device_state, char *outBuffer, size_t bufferSize) const override;
+
+private:
+	friend class SimulatedUSBBulkTransferBundle;
+
+	typedef std::chrono::steady_clock::time_point t_sim_time;
+
+	struct PendingTransfer
+	{
+		t_sim_time completion_time;
+		USBTransferRequestState *requestStateOnHeap;
+	};
+
+	const SimulatedUSBDeviceDesc *getDeviceDesc(const USBDeviceState* device_state) const;
+	bool getNextEventTime(t_sim_time &out_time) const;
+	void completeTransfer(const USBTransferRequestState *requestState);
+
+	std::vector<SimulatedUSBDeviceDesc> m_deviceTable;
+	std::vector<PendingTransfer> m_pendingTransfers;
+	std::vector<class SimulatedUSBBulkTransferBundle *> m_bulkTransferBundles;
+	unsigned char m_nextDataByte;
+};
+
+class SimulatedUSBBulkTransferBundle : public IUSBBulkTransferBundle
+{
+public:
+	SimulatedUSBBulkTransferBundle(
+		SimulatedUSBApi *api,
+		const SimulatedUSBDeviceDesc &device_desc,
+		const USBDeviceState *device_state,
+		const struct USBRequestPayload_BulkTransfer *request);
+	virtual ~SimulatedUSBBulkTransferBundle();
+
+	// Interface
+	bool initialize() override;
+	bool startTransfers() override;
+	void cancelTransfers() override;
+
+	// Accessors
+	const USBRequestPayload_BulkTransfer &getTransferRequest() const override;
+	t_usb_device_handle getUSBDeviceHandle() const override;
+	int getActiveTransferCount() const override;
+
+	// Called from SimulatedUSBApi::poll()
+	bool getNextEventTime(std::chrono::steady_clock::time_point &out_time) const;
+	void processEvents(const std::chrono::steady_clock::time_point &now);
+
+private:
+	std::chrono::steady_clock::time_point getNextCompletionTime() const;
+
+	SimulatedUSBApi *m_api;
+	SimulatedUSBDeviceDesc m_deviceDesc;
+	USBRequestPayload_BulkTransfer m_request;
+	std::vector<unsigned char> m_packetBuffer;
+	std::deque<std::chrono::steady_clock::time_point> m_inFlightSubmitTimes;
+	std::chrono::steady_clock::time_point m_lastCompletionTime;
+	unsigned int m_packetSequence;
+	bool m_bCanceled;
+};
+
+#endif // SIMULATED_USB_API_H
@@ -0,0 +1,179 @@
+//-- includes -----
+#include "LightBarContourFit.h"
+#include "MathUtility.h"
+
+#include "opencv2/imgproc/imgproc.hpp"
+
+//-- constants -----
+const float k_lightbar_fast_path_max_reprojection_error= 3.f;
+const float k_lightbar_fast_path_max_guess_angle= 25.f*k_degrees_to_radians;
+
+// How far the long axis of the quad can turn between frames before the prior can't orient it
+static const double k_min_prior_axis_cos_angle= cos(30.0*k_degrees_to_radians);
+
+static const int k_quad_vertex_count= 4;
+
+//-- public interface -----
+bool computeBestFitQuadForContour(
+    const std::vector<cv::Point2f> &opencv_contour,
+    const cv::Point2f &up_hint,
+    const cv::Point2f &right_hint,
+    cv::Point2f &top_right,
+    cv::Point2f &top_left,
+    cv::Point2f &bottom_left,
+    cv::Point2f &bottom_right)
+{
+    // Compute the tightest possible bounding box for the given contour
+    cv::RotatedRect cv_min_box= cv::minAreaRect(opencv_contour);
+
+    if (cv_min_box.size.width <= k_real_epsilon || cv_min_box.size.height <= k_real_epsilon)
+    {
+        return false;
+    }
+
+    float half_width, half_height;
+    float radians;
+    if (cv_min_box.size.width > cv_min_box.size.height)
+    {
+        half_width= cv_min_box.size.width / 2.f;
+        half_height= cv_min_box.size.height / 2.f;
+        radians= cv_min_box.angle*k_degrees_to_radians;
+    }
+    else
+    {
+        half_width= cv_min_box.size.height / 2.f;
+        half_height= cv_min_box.size.width / 2.f;
+        radians= (cv_min_box.angle + 90.f)*k_degrees_to_radians;
+    }
+
+    cv::Point2f quad_half_right, quad_half_up;
+    {
+        const float cos_angle= cosf(radians);
+        const float sin_angle= sinf(radians);
+
+        quad_half_right.x= half_width*cos_angle;
+        quad_half_right.y= half_width*sin_angle;
+
+        quad_half_up.x= -half_height*sin_angle;
+        quad_half_up.y= half_height*cos_angle;
+    }
+
+    if (quad_half_up.dot(up_hint) < 0)
+    {
+        // up axis is flipped
+        // flip the box vertically
+        quad_half_up= -quad_half_up;
+    }
+
+    if (quad_half_right.dot(right_hint) < 0)
+    {
+        // right axis is flipped
+        // flip the box horizontally
+        quad_half_right= -quad_half_right;
+    }
+
+    top_right= cv_min_box.center + quad_half_up + quad_half_right;
+    top_left= cv_min_box.center + quad_half_up - quad_half_right;
+    bottom_right= cv_min_box.center - quad_half_up + quad_half_right;
+    bottom_left= cv_min_box.center - quad_half_up - quad_half_right;
+
+    return true;
+}
+
+bool computeBestFitQuadForContourFromPrior(
+    const std::vector<cv::Point2f> &opencv_contour,
+    const cv::Point2f &prior_top_right,
+    const cv::Point2f &prior_top_left,
+    const cv::Point2f &prior_bottom_left,
+    const cv::Point2f &prior_bottom_right,
+    cv::Point2f &out_top_right,
+    cv::Point2f &out_top_left,
+    cv::Point2f &out_bottom_left,
+    cv::Point2f &out_bottom_right)
+{
+    // Use last frame's quad to define an up and a right direction
+    const cv::Point2f up_hint= (prior_top_right + prior_top_left) - (prior_bottom_left + prior_bottom_right);
+    const cv::Point2f right_hint= (prior_top_right + prior_bottom_right) - (prior_top_left + prior_bottom_left);
+    const double right_hint_length= cv::norm(right_hint);
+
+    if (cv::norm(up_hint) <= k_real_epsilon || right_hint_length <= k_real_epsilon)
+    {
+        return false;
+    }
+
+    if (!computeBestFitQuadForContour(
+            opencv_contour,
+            up_hint, right_hint,
+            out_top_right, out_top_left, out_bottom_left, out_bottom_right))
+    {
+        return false;
+    }
+
+    // The hints only pick which way the box axes face.
+    // If the box's long axis turned too far (or the box is nearly square) they can't be trusted.
+    const cv::Point2f quad_right= out_top_right - out_top_left;
+    const double quad_right_length= cv::norm(quad_right);
+
+    if (quad_right_length <= k_real_epsilon ||
+        quad_right.dot(right_hint) < k_min_prior_axis_cos_angle*quad_right_length*right_hint_length)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool computeLightBarPoseFromGuess(
+    const cv::Matx33f &camera_matrix,
+    const cv::Point2f model_quad[4],
+    const cv::Point2f image_quad[4],
+    const Eigen::Matrix3f &guess_rotation,
+    EigenPlanarPoseSolution &out_solution)
+{
+    const float focal_length_x= camera_matrix(0, 0);
+    const float focal_length_y= camera_matrix(1, 1);
+    const float principal_x= camera_matrix(0, 2);
+    const float principal_y= camera_matrix(1, 2);
+
+    // The quad was fit to the undistorted contour so only the pinhole model applies.
+    // The quad corners alone fix the plane, the triangle vertices lie on the same plane.
+    Eigen::Vector2f model_points[k_quad_vertex_count];
+    Eigen::Vector2f image_points[k_quad_vertex_count];
+    for (int corner_index= 0; corner_index < k_quad_vertex_count; ++corner_index)
+    {
+        model_points[corner_index]= Eigen::Vector2f(model_quad[corner_index].x, model_quad[corner_index].y);
+        image_points[corner_index]=
+            Eigen::Vector2f(
+                (image_quad[corner_index].x - principal_x) / focal_length_x,
+                (image_quad[corner_index].y - principal_y) / focal_length_y);
+    }
+
+    EigenPlanarPoseSolution solutions[2];
+    if (!eigen_planar_pose_solve_ippe(model_points, image_points, k_quad_vertex_count, solutions))
+    {
+        return false;
+    }
+
+    // The two solutions mirror the tilt of the lightbar.
+    // The reprojection error of a target this small can't tell them apart, the guess can.
+    float guess_angles[2];
+    for (int solution_index= 0; solution_index < 2; ++solution_index)
+    {
+        guess_angles[solution_index]=
+            Eigen::AngleAxisf(guess_rotation.transpose() * solutions[solution_index].rotation).angle();
+    }
+
+    const int best_index= (guess_angles[1] < guess_angles[0]) ? 1 : 0;
+    const float reprojection_error_px=
+        solutions[best_index].reprojection_error * 0.5f*(focal_length_x + focal_length_y);
+
+    if (reprojection_error_px > k_lightbar_fast_path_max_reprojection_error ||
+        guess_angles[best_index] > k_lightbar_fast_path_max_guess_angle)
+    {
+        return false;
+    }
+
+    out_solution= solutions[best_index];
+
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef LIGHTBAR_CONTOUR_FIT_H
+#define LIGHTBAR_CONTOUR_FIT_H
+
+//-- includes -----
+#include "MathPlanarPose.h"
+#include "opencv2/core/core.hpp"
+#include <vector>
+
+//-- constants -----
+// Reject the closed form lightbar pose if it fits this poorly or jumped this far from the guess
+extern const float k_lightbar_fast_path_max_reprojection_error; // pixels
+extern const float k_lightbar_fast_path_max_guess_angle; // radians
+
+//-- interface -----
+// Best fit quad around a lightbar contour, with its axes facing the given up and right directions
+bool computeBestFitQuadForContour(
+    const std::vector<cv::Point2f> &opencv_contour,
+    const cv::Point2f &up_hint,
+    const cv::Point2f &right_hint,
+    cv::Point2f &top_right,
+    cv::Point2f &top_left,
+    cv::Point2f &bottom_left,
+    cv::Point2f &bottom_right);
+
+// Warm start: best fit quad around a lightbar contour, oriented by last frame's quad.
+// Returns false if the new quad's long axis turned too far from the prior quad's to trust the orientation.
+bool computeBestFitQuadForContourFromPrior(
+    const std::vector<cv::Point2f> &opencv_contour,
+    const cv::Point2f &prior_top_right,
+    const cv::Point2f &prior_top_left,
+    const cv::Point2f &prior_bottom_left,
+    const cv::Point2f &prior_bottom_right,
+    cv::Point2f &out_top_right,
+    cv::Point2f &out_top_left,
+    cv::Point2f &out_bottom_left,
+    cv::Point2f &out_bottom_right);
+
+// Closed form (IPPE) pose of the lightbar quad, disambiguated by a guessed rotation.
+// Quad corners are ordered upper right, upper left, lower left, lower right.
+// The model corners are on the lightbar's z=0 plane (cm), the image corners are undistorted pixels.
+// Returns false if the fit is degenerate or breaks the fast path thresholds above.
+bool computeLightBarPoseFromGuess(
+    const cv::Matx33f &camera_matrix,
+    const cv::Point2f model_quad[4],
+    const cv::Point2f image_quad[4],
+    const Eigen::Matrix3f &guess_rotation,
+    EigenPlanarPoseSolution &out_solution);
+
+#endif // LIGHTBAR_CONTOUR_FIT_H
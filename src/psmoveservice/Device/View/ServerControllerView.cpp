@@ -4,12 +4,14 @@
 #include "AtomicPrimitives.h"
 #include "BluetoothRequests.h"
 #include "ControllerManager.h"
+#include "DeviceClockModel.h"
 #include "DeviceManager.h"
 #include "MathAlignment.h"
 #include "ServerLog.h"
 #include "ServerRequestHandler.h"
 #include "CompoundPoseFilter.h"
 #include "KalmanPoseFilter.h"
+#include "PoseFilterSnapshot.h"
 #include "PSDualShock4Controller.h"
 #include "PSMoveController.h"
 #include "PSNaviController.h"
@@ -18,6 +20,7 @@
 #include "PSMoveProtocol.pb.h"
 #include "ServerUtility.h"
 #include "ServerTrackerView.h"
+#include "ServiceStatistics.h"
 
 #include <glm/glm.hpp>
 
@@ -29,6 +32,21 @@ using t_high_resolution_duration= t_high_resolution_timepoint::duration;
 static const float k_min_time_delta_seconds = 1 / 2500.f;
 static const float k_max_time_delta_seconds = 1 / 30.f;
 
+// A single controller state holds at most this many IMU readings (the PSMove sends two)
+static const int k_max_imu_packets_per_state = 2;
+
+// Past this many IMU packets per update the backlog is downsampled
+static const size_t k_max_imu_process_count = 100;
+
+// Number of IMU packets the IMU thread can queue up before they get folded together
+static const size_t k_imu_packet_queue_capacity = 1024;
+
+// Number of optical corrections the main thread can queue up for the IMU thread
+static const size_t k_optical_correction_queue_capacity = 64;
+
+// Number of recenters and filter resets the main thread can queue up for the IMU thread before the queue grows
+static const size_t k_pose_filter_command_queue_capacity = 16;
+
 //-- macros -----
 #define SET_BUTTON_BIT(bitmask, bit_index, button_state) \
     bitmask|= (button_state == CommonControllerState::Button_DOWN || button_state == CommonControllerState::Button_PRESSED) ? (0x1 << (bit_index)) : 0x0;
@@ -53,12 +71,14 @@ static void init_filters_for_virtual_controller(
     PoseFilterSpace **out_pose_filter_space,
     IPoseFilter **out_pose_filter);
 
+static unsigned int get_sensor_state_raw_timestamp(const CommonDeviceState *sensor_state);
 static void post_imu_filter_packets_for_psmove(
     const PSMoveController *psmove,
 	const PSMoveControllerInputState *psmoveState,
     const t_high_resolution_timepoint now, 
 	const t_high_resolution_duration secondsSinceLastUpdate,
-	t_controller_pose_sensor_queue *pose_filter_queue);
+	PoseSensorPacket out_sensor_packets[k_max_imu_packets_per_state],
+	int *out_sensor_packet_count);
 static void post_optical_filter_packet_for_psmove(
     const PSMoveController *psmove,
     const t_high_resolution_timepoint now,
@@ -70,7 +90,8 @@ static void post_imu_filter_packets_for_ds4(
 	const DualShock4ControllerInputState *psmoveState,
     const t_high_resolution_timepoint now, 
 	const t_high_resolution_duration secondsSinceLastUpdate,
-	t_controller_pose_sensor_queue *pose_filter_queue);
+	PoseSensorPacket out_sensor_packets[k_max_imu_packets_per_state],
+	int *out_sensor_packet_count);
 static void post_optical_filter_packet_for_ds4(
     const PSDualShock4Controller *ds4,
     const t_high_resolution_timepoint now,
@@ -125,20 +146,48 @@ ServerControllerView::ServerControllerView(const int device_id)
     , m_roi_disable_count(0)
     , m_LED_override_active(false)
     , m_device(nullptr)
+    , m_PoseSensorIMUPacketQueue(k_imu_packet_queue_capacity)
+    , m_PoseSensorOpticalCorrectionQueue(k_optical_correction_queue_capacity)
+    , m_PoseFilterCommandQueue(k_pose_filter_command_queue_capacity)
+    , m_RetiredPoseFilterQueue(k_pose_filter_command_queue_capacity)
     , m_tracker_pose_estimations(nullptr)
+    , m_tracker_projections(nullptr)
+    , m_new_tracker_projection_bitmask(0)
     , m_multicam_pose_estimation(nullptr)
     , m_pose_filter(nullptr)
     , m_pose_filter_space(nullptr)
     , m_lastPollSeqNumProcessed(-1)
     , m_last_filter_update_timestamp()
     , m_last_filter_update_timestamp_valid(false)
+    , m_imu_packet_statistic(nullptr)
+    , m_downsampled_imu_packet_statistic(nullptr)
+    , m_imu_queue_overflow_statistic(nullptr)
 {
     m_tracking_color = std::make_tuple(0x00, 0x00, 0x00);
     m_LED_override_color = std::make_tuple(0x00, 0x00, 0x00);
+
+    m_bFilterOnDeviceThread = false;
+    m_bHasDeviceThreadPoseUpdate = false;
+    m_pose_filter_snapshot = new PoseFilterSnapshot;
+    m_device_thread_packets.reserve(k_max_imu_packets_per_state + k_optical_correction_queue_capacity);
+    m_device_thread_time_deltas.reserve(m_device_thread_packets.capacity());
+
+    m_bIsLastSensorDataTimestampValid = false;
+    m_device_clock = new DeviceClockModel;
+
+    m_bIsLastEnqueuedIMUPacketTimestampValid = false;
+    m_imu_overflow_accumulator = new PoseSensorPacketAccumulator;
+    m_imu_overflow_accumulator->clear();
+    m_imu_backlog_accumulator = new PoseSensorPacketAccumulator;
+    m_imu_backlog_accumulator->clear();
 }
 
 ServerControllerView::~ServerControllerView()
 {
+    delete m_device_clock;
+    delete m_imu_overflow_accumulator;
+    delete m_imu_backlog_accumulator;
+    delete m_pose_filter_snapshot;
 }
 
 bool ServerControllerView::allocate_device_interface(
@@ -151,10 +200,12 @@ bool ServerControllerView::allocate_device_interface(
             m_device = new PSMoveController();
 			m_device->setControllerListener(this); // Listen for IMU packets
 
-            m_tracker_pose_estimations = new ControllerOpticalPoseEstimation[TrackerManager::k_max_devices];
+            m_tracker_pose_estimations = new ControllerOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+            m_tracker_projections = new ControllerOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+            m_new_tracker_projection_bitmask = 0;
             m_pose_filter= nullptr; // no pose filter until the device is opened
 
-            for (int tracker_index = 0; tracker_index < TrackerManager::k_max_devices; ++tracker_index)
+            for (int tracker_index = 0; tracker_index < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++tracker_index)
             {
                 m_tracker_pose_estimations[tracker_index].clear();
             }
@@ -173,10 +224,12 @@ bool ServerControllerView::allocate_device_interface(
             m_device = new PSDualShock4Controller();
 			m_device->setControllerListener(this); // Listen for IMU packets
 
-            m_tracker_pose_estimations = new ControllerOpticalPoseEstimation[TrackerManager::k_max_devices];
+            m_tracker_pose_estimations = new ControllerOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+            m_tracker_projections = new ControllerOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+            m_new_tracker_projection_bitmask = 0;
             m_pose_filter = nullptr; // no pose filter until the device is opened
 
-            for (int tracker_index = 0; tracker_index < TrackerManager::k_max_devices; ++tracker_index)
+            for (int tracker_index = 0; tracker_index < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++tracker_index)
             {
                 m_tracker_pose_estimations[tracker_index].clear();
             }
@@ -187,10 +240,12 @@ bool ServerControllerView::allocate_device_interface(
     case CommonDeviceState::VirtualController:
         {
             m_device = new VirtualController();
-            m_tracker_pose_estimations = new ControllerOpticalPoseEstimation[TrackerManager::k_max_devices];
+            m_tracker_pose_estimations = new ControllerOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+            m_tracker_projections = new ControllerOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+            m_new_tracker_projection_bitmask = 0;
             m_pose_filter = nullptr; // no pose filter until the device is opened
 
-            for (int tracker_index = 0; tracker_index < TrackerManager::k_max_devices; ++tracker_index)
+            for (int tracker_index = 0; tracker_index < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++tracker_index)
             {
                 m_tracker_pose_estimations[tracker_index].clear();
             }
@@ -219,6 +274,14 @@ void ServerControllerView::free_device_interface()
         m_tracker_pose_estimations = nullptr;
     }
 
+    if (m_tracker_projections != nullptr)
+    {
+        delete[] m_tracker_projections;
+        m_tracker_projections = nullptr;
+    }
+
+    discardPoseFilterCommands();
+
     if (m_pose_filter != nullptr)
     {
         delete m_pose_filter;
@@ -246,6 +309,9 @@ bool ServerControllerView::open(const class DeviceEnumerator *enumerator)
     {
         IDeviceInterface *device= getDevice();
 
+        // Drop any recenter or reset the IMU thread didn't get to before the controller was last closed
+        discardPoseFilterCommands();
+
         switch (device->getDeviceType())
         {
         case CommonDeviceState::PSMove:
@@ -298,6 +364,18 @@ bool ServerControllerView::open(const class DeviceEnumerator *enumerator)
 
         // Reset the poll sequence number high water mark
         m_lastPollSeqNumProcessed= -1;
+
+        // Only the bluetooth PSMove and DS4 get their IMU samples on a worker thread
+        const CommonDeviceState::eDeviceType device_type= device->getDeviceType();
+        m_bFilterOnDeviceThread=
+            DeviceManager::getInstance()->m_controller_manager->getConfig().filter_on_device_thread &&
+            m_pose_filter != nullptr &&
+            (device_type == CommonDeviceState::PSMove || device_type == CommonDeviceState::PSDualShock4);
+
+        const std::string statistic_prefix= getStatisticPrefix();
+        m_imu_packet_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".imu_packets");
+        m_downsampled_imu_packet_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".downsampled_imu_packets");
+        m_imu_queue_overflow_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".imu_queue_overflows");
     }
 
     // If needed for this kind of controller, assign a tracking color id
@@ -330,6 +408,26 @@ bool ServerControllerView::open(const class DeviceEnumerator *enumerator)
     m_last_filter_update_timestamp = std::chrono::time_point<std::chrono::high_resolution_clock>();
     m_last_filter_update_timestamp_valid= false;
 
+    // Forget any IMU packets still waiting for room in the queue
+    m_bIsLastEnqueuedIMUPacketTimestampValid= false;
+    m_imu_overflow_accumulator->clear();
+
+    // Start timing IMU samples by the controller's report timestamp
+    m_bIsLastSensorDataTimestampValid= false;
+    switch (getControllerDeviceType())
+    {
+    case CommonDeviceState::PSMove:
+        m_device_clock->reset(PSMOVE_IMU_TIMESTAMP_BITS, PSMOVE_IMU_TIMESTAMP_TICK_SECONDS);
+        break;
+    case CommonDeviceState::PSDualShock4:
+        m_device_clock->reset(PSDS4_IMU_TIMESTAMP_BITS, PSDS4_IMU_TIMESTAMP_TICK_SECONDS);
+        break;
+    default:
+        // No sensor timestamp, samples keep their arrival time
+        m_device_clock->reset(0, 0.0);
+        break;
+    }
+
     return bSuccess;
 }
 
@@ -337,6 +435,9 @@ void ServerControllerView::close()
 {
     set_tracking_enabled_internal(false);
 
+    m_bFilterOnDeviceThread= false;
+    m_bHasDeviceThreadPoseUpdate= false;
+
     eCommonTrackingColorID tracking_color_id= eCommonTrackingColorID::INVALID_COLOR;
     if (m_device != nullptr && m_device->getTrackingColorID(tracking_color_id))
     {
@@ -346,15 +447,22 @@ void ServerControllerView::close()
         }
     }
 
+    ServiceStatistics::releaseStatistic(m_imu_packet_statistic);
+    ServiceStatistics::releaseStatistic(m_downsampled_imu_packet_statistic);
+    ServiceStatistics::releaseStatistic(m_imu_queue_overflow_statistic);
+    m_imu_packet_statistic= nullptr;
+    m_downsampled_imu_packet_statistic= nullptr;
+    m_imu_queue_overflow_statistic= nullptr;
+
     ServerDeviceView::close();
 }
 
 bool ServerControllerView::recenterOrientation(const CommonDeviceQuaternion& q_pose_relative_to_identity_pose)
 {
     bool bSuccess = false;
-    IPoseFilter *filter = getPoseFilterMutable();
 
-    if (filter != nullptr)
+    // When the IMU thread owns the filter it always has one
+    if (m_bFilterOnDeviceThread || m_pose_filter != nullptr)
     {
         // Get the pose that we expect the controller to be in (relative to the pose it's in by default).
         // For example, the psmove controller's default mesh has it laying flat,
@@ -389,7 +497,24 @@ bool ServerControllerView::recenterOrientation(const CommonDeviceQuaternion& q_p
             eigen_quaternion_concatenate(q_pose, identity_pose_relative_to_global_forward);
 
         // Tell the pose filter that the orientation state should now be relative to controller_pose_relative_to_global_forward
-        filter->recenterOrientation(controller_pose_relative_to_global_forward);
+        if (m_bFilterOnDeviceThread)
+        {
+            ControllerPoseFilterCommand command;
+            command.command_type= ControllerPoseFilterCommand::RecenterOrientation;
+            command.recenter_pose.w= controller_pose_relative_to_global_forward.w();
+            command.recenter_pose.x= controller_pose_relative_to_global_forward.x();
+            command.recenter_pose.y= controller_pose_relative_to_global_forward.y();
+            command.recenter_pose.z= controller_pose_relative_to_global_forward.z();
+            command.pose_filter= nullptr;
+            command.pose_filter_space= nullptr;
+
+            // Applied by the IMU thread ahead of its next filter update
+            m_PoseFilterCommandQueue.enqueue(command);
+        }
+        else
+        {
+            m_pose_filter->recenterOrientation(controller_pose_relative_to_global_forward);
+        }
         bSuccess = true;
     }
 
@@ -400,17 +525,8 @@ void ServerControllerView::resetPoseFilter()
 {
     assert(m_device != nullptr);
 
-    if (m_pose_filter != nullptr)
-    {
-        delete m_pose_filter;
-        m_pose_filter = nullptr;
-    }
-
-    if (m_pose_filter_space != nullptr)
-    {
-        delete m_pose_filter_space;
-        m_pose_filter_space = nullptr;
-    }
+    IPoseFilter *pose_filter= nullptr;
+    PoseFilterSpace *pose_filter_space= nullptr;
 
     switch (m_device->getDeviceType())
     {
@@ -418,19 +534,19 @@ void ServerControllerView::resetPoseFilter()
         {
             init_filters_for_psmove(
                 static_cast<PSMoveController *>(m_device),
-                &m_pose_filter_space, &m_pose_filter);
+                &pose_filter_space, &pose_filter);
         } break;
     case CommonDeviceState::PSDualShock4:
         {
             init_filters_for_psdualshock4(
                 static_cast<PSDualShock4Controller *>(m_device),
-                &m_pose_filter_space, &m_pose_filter);
+                &pose_filter_space, &pose_filter);
         } break;
     case CommonDeviceState::VirtualController:
         {
             init_filters_for_virtual_controller(
                 static_cast<VirtualController *>(m_device),
-                &m_pose_filter_space, &m_pose_filter);
+                &pose_filter_space, &pose_filter);
         } break;
 	case CommonDeviceState::PSNavi:
 		// No pose filter
@@ -438,6 +554,34 @@ void ServerControllerView::resetPoseFilter()
     default:
         assert(false && "unreachable");
     }
+
+    if (m_bFilterOnDeviceThread)
+    {
+        ControllerPoseFilterCommand command;
+        command.command_type= ControllerPoseFilterCommand::ReplaceFilter;
+        command.recenter_pose.clear();
+        command.pose_filter= pose_filter;
+        command.pose_filter_space= pose_filter_space;
+
+        // The IMU thread swaps the new filter in ahead of its next update,
+        // publishes its pose and hands the old filter back to be freed
+        m_PoseFilterCommandQueue.enqueue(command);
+    }
+    else
+    {
+        if (m_pose_filter != nullptr)
+        {
+            delete m_pose_filter;
+        }
+
+        if (m_pose_filter_space != nullptr)
+        {
+            delete m_pose_filter_space;
+        }
+
+        m_pose_filter= pose_filter;
+        m_pose_filter_space= pose_filter_space;
+    }
 }
 
 void ServerControllerView::updateOpticalPoseEstimation(TrackerManager* tracker_manager)
@@ -485,26 +629,16 @@ void ServerControllerView::updateOpticalPoseEstimation(TrackerManager* tracker_m
                     // Initially the newTrackerPoseEstimate is a copy of the existing pose
                     bool bIsVisibleThisUpdate= false;
 
-                    // If a new video frame is available this tick, 
-                    // attempt to update the tracking location
-                    if (tracker->getHasUnpublishedState())
+                    // If the tracker handed over a projection since the last update, use it.
+                    // Pipelined trackers hand one over whenever their worker finishes a frame,
+                    // which usually isn't an update that polled a new video frame.
+                    if ((m_new_tracker_projection_bitmask & (1 << tracker_id)) != 0)
                     {
-                        // Create a copy of the pose estimate state so that in event of a 
-                        // failure part way through computing the projection we don't
-                        // set partially valid state
-                        ControllerOpticalPoseEstimation newTrackerPoseEstimate= trackerPoseEstimateRef;
-
-                        if (tracker->computeProjectionForController(
-                                this, 
-                                &trackingShape,
-                                &newTrackerPoseEstimate))
-                        {
-                            bIsVisibleThisUpdate= true;
+                        bIsVisibleThisUpdate= true;
 
-                            // Actually apply the pose estimate state
-                            trackerPoseEstimateRef= newTrackerPoseEstimate;
-                            trackerPoseEstimateRef.last_visible_timestamp = now;
-                        }
+                        // Actually apply the pose estimate state
+                        trackerPoseEstimateRef= m_tracker_projections[tracker_id];
+                        trackerPoseEstimateRef.last_visible_timestamp = now;
                     }
 
                     // If the projection isn't too old (or updated this tick), 
@@ -534,6 +668,9 @@ void ServerControllerView::updateOpticalPoseEstimation(TrackerManager* tracker_m
             trackerPoseEstimateRef.bCurrentlyTracking = bCurrentlyTracking;
         }
 
+        // All of the new tracker projections have been consumed
+        m_new_tracker_projection_bitmask = 0;
+
         // How we compute the final world pose estimate varies based on
         // * Number of trackers that currently have a valid projections of the controller
         // * The kind of projection shape (psmove sphere or ds4 lightbar)
@@ -651,11 +788,22 @@ void ServerControllerView::updateOpticalPoseEstimation(TrackerManager* tracker_m
 	}
 }
 
+std::string
+ServerControllerView::getStatisticPrefix() const
+{
+    // Serial numbers are too long for the statistic names, and would collide once truncated
+    return "controller." + std::to_string(getDeviceID());
+}
+
 void 
 ServerControllerView::notifySensorDataReceived(const CommonDeviceState *sensor_state)
 {
+    // Time the samples by the controller's timestamp counter (mapped onto the host clock)
+    // rather than when the report happened to be read
+    const t_high_resolution_timepoint now =
+        m_device_clock->update(get_sensor_state_raw_timestamp(sensor_state), std::chrono::high_resolution_clock::now());
+
     // Compute the time in seconds since the last update
-    const t_high_resolution_timepoint now = std::chrono::high_resolution_clock::now();
 	t_high_resolution_duration durationSinceLastUpdate= t_high_resolution_duration::zero();
 
 	if (m_bIsLastSensorDataTimestampValid)
@@ -665,6 +813,9 @@ ServerControllerView::notifySensorDataReceived(const CommonDeviceState *sensor_s
 	m_lastSensorDataTimestamp= now;
 	m_bIsLastSensorDataTimestampValid= true;
 
+	PoseSensorPacket sensor_packets[k_max_imu_packets_per_state];
+	int sensor_packet_count= 0;
+
 	// Apply device specific filtering
     switch (sensor_state->DeviceType)
     {
@@ -678,7 +829,7 @@ ServerControllerView::notifySensorDataReceived(const CommonDeviceState *sensor_s
             post_imu_filter_packets_for_psmove(
                 psmove, psmoveState,
                 now, durationSinceLastUpdate,
-				&m_PoseSensorIMUPacketQueue);
+				sensor_packets, &sensor_packet_count);
         } break;
     case CommonDeviceState::PSDualShock4:
         {
@@ -690,18 +841,228 @@ ServerControllerView::notifySensorDataReceived(const CommonDeviceState *sensor_s
             post_imu_filter_packets_for_ds4(
                 ds4, ds4State,
                 now, durationSinceLastUpdate,
-				&m_PoseSensorIMUPacketQueue);
+				sensor_packets, &sensor_packet_count);
         } break;
     default:
         assert(0 && "Unhandled Controller Type");
     }
 
+	if (m_bFilterOnDeviceThread)
+	{
+		updatePoseFilterOnDeviceThread(sensor_packets, sensor_packet_count);
+	}
+	else
+	{
+		for (int packet_index = 0; packet_index < sensor_packet_count; ++packet_index)
+		{
+			enqueueIMUSensorPacket(sensor_packets[packet_index]);
+		}
+	}
+
     // Consider this HMD state sequence num processed
     m_lastPollSeqNumProcessed = sensor_state->PollSequenceNumber;
 }
 
+void ServerControllerView::updatePoseFilterOnDeviceThread(
+	const PoseSensorPacket *sensor_packets,
+	int sensor_packet_count)
+{
+	// Recenters and resets come through the command queue, so the IMU thread never waits on the main thread
+	const bool bFilterChanged= applyPoseFilterCommands();
+
+	if (m_pose_filter == nullptr)
+	{
+		return;
+	}
+
+	// Apply any optical corrections the main thread posted since the last IMU sample
+	m_device_thread_packets.clear();
+	PoseSensorPacket optical_packet;
+	while (m_PoseSensorOpticalCorrectionQueue.try_dequeue(optical_packet))
+	{
+		m_device_thread_packets.push_back(optical_packet);
+	}
+	m_device_thread_packets.insert(m_device_thread_packets.end(), sensor_packets, sensor_packets + sensor_packet_count);
+
+	if (m_device_thread_packets.size() > 1)
+	{
+		std::sort(
+			m_device_thread_packets.begin(), m_device_thread_packets.end(), 
+			[](const PoseSensorPacket & a, const PoseSensorPacket & b) -> bool
+			{
+				return a.timestamp < b.timestamp; 
+			});
+	}
+
+	computeFilterTimeDeltas(m_device_thread_packets, m_device_thread_time_deltas);
+
+	if (m_device_thread_packets.size() > 0)
+	{
+		PoseSensorPacketSpan sensorPackets;
+		sensorPackets.packets= m_device_thread_packets.data();
+		sensorPackets.time_deltas= m_device_thread_time_deltas.data();
+		sensorPackets.count= m_device_thread_packets.size();
+
+		m_pose_filter->updateBatch(m_pose_filter_space, sensorPackets);
+	}
+
+	if (m_device_thread_packets.size() > 0 || bFilterChanged)
+	{
+		// Hand the new pose to the main thread
+		m_pose_filter_snapshot->publish(m_pose_filter);
+		m_bHasDeviceThreadPoseUpdate= true;
+	}
+
+	if (m_imu_packet_statistic != nullptr)
+	{
+		m_imu_packet_statistic->increment(sensor_packet_count);
+	}
+}
+
+bool ServerControllerView::applyPoseFilterCommands()
+{
+	bool bFilterChanged= false;
+
+	ControllerPoseFilterCommand command;
+	while (m_PoseFilterCommandQueue.try_dequeue(command))
+	{
+		switch (command.command_type)
+		{
+		case ControllerPoseFilterCommand::RecenterOrientation:
+			if (m_pose_filter != nullptr)
+			{
+				const Eigen::Quaternionf q_pose(
+					command.recenter_pose.w,
+					command.recenter_pose.x,
+					command.recenter_pose.y,
+					command.recenter_pose.z);
+
+				m_pose_filter->recenterOrientation(q_pose);
+			}
+			break;
+		case ControllerPoseFilterCommand::ReplaceFilter:
+			{
+				std::swap(m_pose_filter, command.pose_filter);
+				std::swap(m_pose_filter_space, command.pose_filter_space);
+
+				// Freeing the old filter is left to the main thread
+				m_RetiredPoseFilterQueue.enqueue(command);
+			} break;
+		default:
+			assert(0 && "Unhandled pose filter command");
+		}
+
+		bFilterChanged= true;
+	}
+
+	return bFilterChanged;
+}
+
+void ServerControllerView::freeRetiredPoseFilters()
+{
+	ControllerPoseFilterCommand command;
+	while (m_RetiredPoseFilterQueue.try_dequeue(command))
+	{
+		if (command.pose_filter != nullptr)
+		{
+			delete command.pose_filter;
+		}
+
+		if (command.pose_filter_space != nullptr)
+		{
+			delete command.pose_filter_space;
+		}
+	}
+}
+
+void ServerControllerView::discardPoseFilterCommands()
+{
+	// Only safe while the IMU thread isn't filtering for this controller
+	assert(!m_bFilterOnDeviceThread);
+
+	ControllerPoseFilterCommand command;
+	while (m_PoseFilterCommandQueue.try_dequeue(command))
+	{
+		if (command.pose_filter != nullptr)
+		{
+			delete command.pose_filter;
+		}
+
+		if (command.pose_filter_space != nullptr)
+		{
+			delete command.pose_filter_space;
+		}
+	}
+
+	freeRetiredPoseFilters();
+}
+
+void ServerControllerView::enqueueIMUSensorPacket(const PoseSensorPacket &sensor_packet)
+{
+	float time_delta_seconds= 0.f;
+	if (m_bIsLastEnqueuedIMUPacketTimestampValid)
+	{
+		const std::chrono::duration<float> time_delta= sensor_packet.timestamp - m_lastEnqueuedIMUPacketTimestamp;
+
+		time_delta_seconds= std::max(time_delta.count(), 0.f);
+	}
+	m_lastEnqueuedIMUPacketTimestamp= sensor_packet.timestamp;
+	m_bIsLastEnqueuedIMUPacketTimestampValid= true;
+
+	// Packets that didn't fit last time have to go ahead of this one to keep the queue in time order
+	if (!m_imu_overflow_accumulator->empty())
+	{
+		if (m_PoseSensorIMUPacketQueue.try_enqueue(m_imu_overflow_accumulator->getMergedPacket()))
+		{
+			m_imu_overflow_accumulator->clear();
+		}
+	}
+
+	if (m_imu_overflow_accumulator->empty() &&
+		m_PoseSensorIMUPacketQueue.try_enqueue(sensor_packet))
+	{
+		return;
+	}
+
+	// The main thread has fallen so far behind that the queue is full.
+	// Rather than growing the queue from this thread, or dropping the reading and
+	// losing its rotation, fold it into the packet waiting for room in the queue.
+	m_imu_overflow_accumulator->accumulate(sensor_packet, time_delta_seconds);
+
+	if (m_imu_queue_overflow_statistic != nullptr)
+	{
+		m_imu_queue_overflow_statistic->increment();
+	}
+}
+
 void ServerControllerView::updateStateAndPredict()
 {
+	if (m_bFilterOnDeviceThread)
+	{
+		// Pass the optical estimates on to the IMU thread that owns the filter
+		while (m_PoseSensorOpticalPacketQueue.size() > 0)
+		{
+			if (!m_PoseSensorOpticalCorrectionQueue.try_enqueue(m_PoseSensorOpticalPacketQueue.front()))
+			{
+				// The IMU thread isn't receiving samples, so the correction is stale anyway
+				SERVER_LOG_DEBUG("updateStateAndPredict()") << "Optical correction queue full, dropping correction";
+			}
+			m_PoseSensorOpticalPacketQueue.pop_front();
+		}
+
+		freeRetiredPoseFilters();
+
+		if (m_bHasDeviceThreadPoseUpdate.exchange(false))
+		{
+			m_pose_filter_snapshot->refresh();
+
+			// Flag the state as unpublished, which will trigger an update to the client
+			markStateAsUnpublished();
+		}
+
+		return;
+	}
+
 	std::vector<PoseSensorPacket> timeSortedPackets;
 
 	// Drain the packet queues filled by the threads
@@ -710,6 +1071,11 @@ void ServerControllerView::updateStateAndPredict()
 	{
 		timeSortedPackets.push_back(packet);
 	}
+
+	if (m_imu_packet_statistic != nullptr)
+	{
+		m_imu_packet_statistic->increment(timeSortedPackets.size());
+	}
 	//TODO: m_PoseSensorOpticalPacketQueue is currently getting filled on the main thread by
 	// updateOpticalPoseEstimation() when triangulating the optical pose estimates.
 	// Eventually this work will move to it's own camera processing thread 
@@ -729,29 +1095,40 @@ void ServerControllerView::updateStateAndPredict()
 			{
 				return a.timestamp < b.timestamp; 
 			});
+	}
 
-		t_high_resolution_duration duration= 
-			timeSortedPackets[timeSortedPackets.size()-1].timestamp - timeSortedPackets[0].timestamp;
-		std::chrono::duration<float, std::milli> milli_duration= duration;
+	// Compute the time since the previous packet for each sensor packet
+	std::vector<float> timeDeltas;
+	computeFilterTimeDeltas(timeSortedPackets, timeDeltas);
 
-		const size_t k_max_process_count= 100;
-		if (timeSortedPackets.size() > k_max_process_count)
-		{
-			const size_t excess= timeSortedPackets.size() - k_max_process_count;
+	// If the main loop stalled, merge the backlog rather than dropping it
+	if (timeSortedPackets.size() > k_max_imu_process_count)
+	{
+		downsampleIMUBacklog(timeSortedPackets, timeDeltas);
+	}
 
-			SERVER_LOG_WARNING("updatePoseFilter()") << "Incoming packet count: " << timeSortedPackets.size() << " (" << milli_duration.count() << "ms)" << ", trimming: " << excess;
-			timeSortedPackets.erase(timeSortedPackets.begin(), timeSortedPackets.begin()+excess);
-		}
-		else
-		{
-			//SERVER_LOG_DEBUG("updatePoseFilter()") << "Incoming packet count: " << timeSortedPackets.size() << " (" << milli_duration.count() << "ms)";
-		}
+	// Process the sensor packets from oldest to newest in a single filter update
+	if (timeSortedPackets.size() > 0)
+	{
+		PoseSensorPacketSpan sensorPackets;
+		sensorPackets.packets= timeSortedPackets.data();
+		sensorPackets.time_deltas= timeDeltas.data();
+		sensorPackets.count= timeSortedPackets.size();
+
+		m_pose_filter->updateBatch(m_pose_filter_space, sensorPackets);
+
+		// Flag the state as unpublished, which will trigger an update to the client
+		markStateAsUnpublished();
 	}
+}
 
-	// Process the sensor packets from oldest to newest
-	for (const PoseSensorPacket &sensorPacket : timeSortedPackets)
+void ServerControllerView::computeFilterTimeDeltas(
+	const std::vector<PoseSensorPacket> &time_sorted_packets,
+	std::vector<float> &out_time_deltas)
+{
+	out_time_deltas.clear();
+	for (const PoseSensorPacket &sensorPacket : time_sorted_packets)
     {
-		// Compute the time since the last packet
 		float time_delta_seconds;
 		if (m_last_filter_update_timestamp_valid)
 		{
@@ -766,26 +1143,75 @@ void ServerControllerView::updateStateAndPredict()
 			time_delta_seconds = k_max_time_delta_seconds;
 		}
 
-		m_last_filter_update_timestamp = sensorPacket.timestamp;
+		// Late (stale) optical data is applied with the minimum delta but never moves the filter clock back
+		if (!m_last_filter_update_timestamp_valid || sensorPacket.timestamp > m_last_filter_update_timestamp)
+		{
+			m_last_filter_update_timestamp = sensorPacket.timestamp;
+		}
 		m_last_filter_update_timestamp_valid = true;
 
+		out_time_deltas.push_back(time_delta_seconds);
+	}
+}
+
+void ServerControllerView::downsampleIMUBacklog(
+	std::vector<PoseSensorPacket> &time_sorted_packets,
+	std::vector<float> &time_deltas)
+{
+	const size_t incoming_count= time_sorted_packets.size();
+
+	// Merge just enough IMU packets together to get back under the process budget.
+	// A merged packet never spans more time than the filter accepts in one step.
+	const int packets_per_merge= static_cast<int>((incoming_count + k_max_imu_process_count - 1) / k_max_imu_process_count);
+	size_t write_index= 0;
+
+	auto flush_accumulator= [&]() {
+		if (!m_imu_backlog_accumulator->empty())
 		{
-			PoseFilterPacket filter_packet;
-			filter_packet.clear();
-
-			// Create a filter input packet from the sensor data 
-			// and the filter's previous orientation and position
-			m_pose_filter_space->createFilterPacket(
-				sensorPacket,
-				m_pose_filter,
-				filter_packet);
-			// Process the filter packet
-			m_pose_filter->update(time_delta_seconds, filter_packet);
+			time_sorted_packets[write_index]= m_imu_backlog_accumulator->getMergedPacket();
+			time_deltas[write_index]= std::min(m_imu_backlog_accumulator->duration_seconds, k_max_time_delta_seconds);
+			++write_index;
+
+			m_imu_backlog_accumulator->clear();
 		}
+	};
 
-		// Flag the state as unpublished, which will trigger an update to the client
-		markStateAsUnpublished();
+	m_imu_backlog_accumulator->clear();
+	for (size_t read_index= 0; read_index < incoming_count; ++read_index)
+	{
+		const PoseSensorPacket &packet= time_sorted_packets[read_index];
+		const float time_delta= time_deltas[read_index];
+
+		if (packet.has_optical_measurement() || !packet.has_imu_measurements())
+		{
+			// Optical packets are never merged, they pass through in time order
+			flush_accumulator();
+			time_sorted_packets[write_index]= packet;
+			time_deltas[write_index]= time_delta;
+			++write_index;
+			continue;
+		}
+
+		if (m_imu_backlog_accumulator->packet_count >= packets_per_merge ||
+			m_imu_backlog_accumulator->duration_seconds + time_delta > k_max_time_delta_seconds)
+		{
+			flush_accumulator();
+		}
+
+		m_imu_backlog_accumulator->accumulate(packet, time_delta);
 	}
+	flush_accumulator();
+
+	time_sorted_packets.resize(write_index);
+	time_deltas.resize(write_index);
+
+	const size_t merged_count= incoming_count - write_index;
+	if (m_downsampled_imu_packet_statistic != nullptr)
+	{
+		m_downsampled_imu_packet_statistic->increment(merged_count);
+	}
+
+	SERVER_LOG_WARNING("updatePoseFilter()") << "Incoming packet count: " << incoming_count << ", downsampled to: " << write_index;
 }
 
 bool ServerControllerView::setHostBluetoothAddress(
@@ -794,17 +1220,24 @@ bool ServerControllerView::setHostBluetoothAddress(
     return m_device->setHostBluetoothAddress(address);
 }
 
+const IPoseFilter *
+ServerControllerView::getPoseFilter() const
+{
+    return m_bFilterOnDeviceThread ? m_pose_filter_snapshot : m_pose_filter;
+}
+
 CommonDevicePose
 ServerControllerView::getFilteredPose(float time) const
 {
+    const IPoseFilter *pose_filter= getPoseFilter();
     CommonDevicePose pose;
 
     pose.clear();
 
-    if (m_pose_filter != nullptr)
+    if (pose_filter != nullptr)
     {
-        const Eigen::Quaternionf orientation= m_pose_filter->getOrientation(time);
-        const Eigen::Vector3f position_cm= m_pose_filter->getPositionCm(time);
+        const Eigen::Quaternionf orientation= pose_filter->getOrientation(time);
+        const Eigen::Vector3f position_cm= pose_filter->getPositionCm(time);
 
         pose.Orientation.w= orientation.w();
         pose.Orientation.x= orientation.x();
@@ -822,14 +1255,15 @@ ServerControllerView::getFilteredPose(float time) const
 CommonDevicePhysics 
 ServerControllerView::getFilteredPhysics() const
 {
+    const IPoseFilter *pose_filter= getPoseFilter();
     CommonDevicePhysics physics;
 
-    if (m_pose_filter != nullptr)
+    if (pose_filter != nullptr)
     {
-        const Eigen::Vector3f first_derivative= m_pose_filter->getAngularVelocityRadPerSec();
-        const Eigen::Vector3f second_derivative= m_pose_filter->getAngularAccelerationRadPerSecSqr();
-        const Eigen::Vector3f velocity(m_pose_filter->getVelocityCmPerSec());
-        const Eigen::Vector3f acceleration(m_pose_filter->getAccelerationCmPerSecSqr());
+        const Eigen::Vector3f first_derivative= pose_filter->getAngularVelocityRadPerSec();
+        const Eigen::Vector3f second_derivative= pose_filter->getAngularAccelerationRadPerSecSqr();
+        const Eigen::Vector3f velocity(pose_filter->getVelocityCmPerSec());
+        const Eigen::Vector3f acceleration(pose_filter->getAccelerationCmPerSecSqr());
 
         physics.AngularVelocityRadPerSec.i = first_derivative.x();
         physics.AngularVelocityRadPerSec.j = first_derivative.y();
@@ -1376,7 +1810,7 @@ static void generate_psmove_data_frame_for_stream(
             int selectedTrackerId= stream_info->selected_tracker_index;
             unsigned int validTrackerBitmask= 0;
 
-            for (int trackerId = 0; trackerId < TrackerManager::k_max_devices; ++trackerId)
+            for (int trackerId = 0; trackerId < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++trackerId)
             {
                 const ControllerOpticalPoseEstimation *positionEstimate= 
                     controller_view->getTrackerPoseEstimate(trackerId);
@@ -1622,7 +2056,7 @@ static void generate_psdualshock4_data_frame_for_stream(
             int selectedTrackerId= stream_info->selected_tracker_index;
             unsigned int validTrackerBitmask= 0;
 
-            for (int trackerId = 0; trackerId < TrackerManager::k_max_devices; ++trackerId)
+            for (int trackerId = 0; trackerId < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++trackerId)
             {
                 const ControllerOpticalPoseEstimation *positionEstimate= 
                     controller_view->getTrackerPoseEstimate(trackerId);
@@ -1808,7 +2242,7 @@ static void generate_virtual_controller_data_frame_for_stream(
             int selectedTrackerId= stream_info->selected_tracker_index;
             unsigned int validTrackerBitmask= 0;
 
-            for (int trackerId = 0; trackerId < TrackerManager::k_max_devices; ++trackerId)
+            for (int trackerId = 0; trackerId < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++trackerId)
             {
                 const ControllerOpticalPoseEstimation *positionEstimate= 
                     controller_view->getTrackerPoseEstimate(trackerId);
@@ -2215,12 +2649,26 @@ static void init_filters_for_virtual_controller(
 		constants);
 }
 
+static unsigned int get_sensor_state_raw_timestamp(const CommonDeviceState *sensor_state)
+{
+    switch (sensor_state->DeviceType)
+    {
+    case CommonDeviceState::PSMove:
+        return static_cast<const PSMoveControllerInputState *>(sensor_state)->RawTimeStamp;
+    case CommonDeviceState::PSDualShock4:
+        return static_cast<const DualShock4ControllerInputState *>(sensor_state)->RawTimeStamp;
+    default:
+        return 0;
+    }
+}
+
 static void post_imu_filter_packets_for_psmove(
 	const PSMoveController *psmove, 
 	const PSMoveControllerInputState *psmoveState,
 	const t_high_resolution_timepoint now,
 	const t_high_resolution_duration duration_since_last_update,
-	t_controller_pose_sensor_queue *pose_filter_queue)
+	PoseSensorPacket out_sensor_packets[k_max_imu_packets_per_state],
+	int *out_sensor_packet_count)
 {
     const PSMoveControllerConfig *config = psmove->getConfig();
 
@@ -2266,7 +2714,8 @@ static void post_imu_filter_packets_for_psmove(
 				psmoveState->CalibratedGyro[frame][2]);
 		sensor_packet.has_gyroscope_measurement= true;
 
-		pose_filter_queue->enqueue(sensor_packet);
+		out_sensor_packets[0]= sensor_packet;
+		*out_sensor_packet_count= 1;
 	}
 	else
 	{
@@ -2281,6 +2730,8 @@ static void post_imu_filter_packets_for_psmove(
 		const t_high_resolution_timepoint prev_timestamp= now - (duration_since_last_update / 2);
 		t_high_resolution_timepoint timestamps[2] = {prev_timestamp, now};
 
+		*out_sensor_packet_count= 0;
+
 		// Each state update contains two readings (one earlier and one later) of accelerometer and gyro data
 		for (int frame = start_frame_index; frame < 2; ++frame)
 		{
@@ -2308,7 +2759,7 @@ static void post_imu_filter_packets_for_psmove(
 					psmoveState->CalibratedGyro[frame][2]);
 			sensor_packet.has_gyroscope_measurement= true;
 
-			pose_filter_queue->enqueue(sensor_packet);
+			out_sensor_packets[(*out_sensor_packet_count)++]= sensor_packet;
 		}
 	}
 }
@@ -2347,7 +2798,8 @@ static void post_imu_filter_packets_for_ds4(
 	const DualShock4ControllerInputState *ds4State,
     const t_high_resolution_timepoint now, 
 	const t_high_resolution_duration duration_since_last_update,
-	t_controller_pose_sensor_queue *pose_filter_queue)
+	PoseSensorPacket out_sensor_packets[k_max_imu_packets_per_state],
+	int *out_sensor_packet_count)
 {
     const PSDualShock4ControllerConfig *config = ds4->getConfig();
 
@@ -2379,7 +2831,8 @@ static void post_imu_filter_packets_for_ds4(
             ds4State->CalibratedGyro.k);
 	sensor_packet.has_gyroscope_measurement= true;
 
-    pose_filter_queue->enqueue(sensor_packet);
+    out_sensor_packets[0]= sensor_packet;
+    *out_sensor_packet_count= 1;
 }
 
 static void post_optical_filter_packet_for_ds4(
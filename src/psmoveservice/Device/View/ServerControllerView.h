@@ -20,6 +20,7 @@ class TrackerManager;
 
 using t_controller_pose_sensor_queue= moodycamel::ReaderWriterQueue<PoseSensorPacket, 1024>;
 using t_controller_pose_optical_queue= std::deque<PoseSensorPacket>;
+using t_controller_pose_correction_queue= moodycamel::ReaderWriterQueue<PoseSensorPacket>;
 
 template<typename t_object_type>
 class AtomicObject;
@@ -57,6 +58,23 @@ struct ControllerOpticalPoseEstimation
     }
 };
 
+// A recenter or filter reset the main thread hands to the IMU thread that owns the filter
+struct ControllerPoseFilterCommand
+{
+    enum eCommandType
+    {
+        RecenterOrientation,
+        ReplaceFilter
+    };
+
+    eCommandType command_type;
+    CommonDeviceQuaternion recenter_pose; // RecenterOrientation
+    class IPoseFilter *pose_filter; // ReplaceFilter
+    class PoseFilterSpace *pose_filter_space; // ReplaceFilter
+};
+
+using t_controller_pose_filter_command_queue= moodycamel::ReaderWriterQueue<ControllerPoseFilterCommand>;
+
 class ServerControllerView : public ServerDeviceView, public IControllerListener
 {
 public:
@@ -83,7 +101,12 @@ public:
     
     IDeviceInterface* getDevice() const override {return m_device;}
     inline class IPoseFilter * getPoseFilterMutable() { return m_pose_filter; }
-    inline const class IPoseFilter * getPoseFilter() const { return m_pose_filter; }
+
+    // When the filter runs on the device thread this is a snapshot of its state at the last refresh
+    const class IPoseFilter * getPoseFilter() const;
+
+    // True if the pose filter is updated on the HID worker thread as IMU samples arrive
+    inline bool getIsFilteringOnDeviceThread() const { return m_bFilterOnDeviceThread; }
 
     // Estimate the given pose if the controller at some point into the future
     CommonDevicePose getFilteredPose(float time= 0.f) const;
@@ -179,6 +202,13 @@ public:
         return (m_tracker_pose_estimations != nullptr) ? &m_tracker_pose_estimations[trackerId] : nullptr;
     }
 
+    // Hand over the projection a tracker found in its latest video frame.
+    // Applied by the next updateOpticalPoseEstimation().
+    inline void setTrackerProjection(int trackerId, const ControllerOpticalPoseEstimation &pose_estimate) {
+        m_tracker_projections[trackerId] = pose_estimate;
+        m_new_tracker_projection_bitmask |= (1 << trackerId);
+    }
+
     // Get the pose estimate derived from multicam pose tracking
     inline const ControllerOpticalPoseEstimation *getMulticamPoseEstimate() const { 
         return m_multicam_pose_estimation; 
@@ -200,6 +230,7 @@ public:
 
 	// Incoming device data callbacks
 	void notifySensorDataReceived(const CommonDeviceState *sensor_state) override;
+	std::string getStatisticPrefix() const override;
 
 protected:
     void set_tracking_enabled_internal(bool bEnabled);
@@ -208,6 +239,21 @@ protected:
     void free_device_interface() override;
     void publish_device_data_frame() override;
 
+    // Called on the IMU thread
+    void enqueueIMUSensorPacket(const PoseSensorPacket &sensor_packet);
+    void updatePoseFilterOnDeviceThread(const PoseSensorPacket *sensor_packets, int sensor_packet_count);
+    bool applyPoseFilterCommands();
+
+    // Free any filters the IMU thread swapped out, or that never reached it
+    void freeRetiredPoseFilters();
+    void discardPoseFilterCommands();
+
+    // Compute the time since the previous filter update for each time sorted packet
+    void computeFilterTimeDeltas(const std::vector<PoseSensorPacket> &time_sorted_packets, std::vector<float> &out_time_deltas);
+
+    // Fold runs of IMU packets together when there are more than the filter should process in one update
+    void downsampleIMUBacklog(std::vector<PoseSensorPacket> &time_sorted_packets, std::vector<float> &time_deltas);
+
 private:
     // Tracking color state
     std::tuple<unsigned char, unsigned char, unsigned char> m_tracking_color;
@@ -227,19 +273,39 @@ private:
 	// Filter State (IMU Thread)
 	std::chrono::time_point<std::chrono::high_resolution_clock> m_lastSensorDataTimestamp;
 	bool m_bIsLastSensorDataTimestampValid;
+	class DeviceClockModel *m_device_clock; // Maps the report timestamp counter onto the host clock
+	std::chrono::time_point<std::chrono::high_resolution_clock> m_lastEnqueuedIMUPacketTimestamp;
+	bool m_bIsLastEnqueuedIMUPacketTimestampValid;
+	struct PoseSensorPacketAccumulator *m_imu_overflow_accumulator; // IMU packets that didn't fit in the queue
+	std::vector<PoseSensorPacket> m_device_thread_packets;
+	std::vector<float> m_device_thread_time_deltas;
 
 	// Filter State (Shared)
 	t_controller_pose_sensor_queue m_PoseSensorIMUPacketQueue;
 	t_controller_pose_optical_queue m_PoseSensorOpticalPacketQueue; // TODO: Currently on main thread
+	t_controller_pose_correction_queue m_PoseSensorOpticalCorrectionQueue; // main thread -> IMU thread
+	std::atomic_bool m_bFilterOnDeviceThread;
+	std::atomic_bool m_bHasDeviceThreadPoseUpdate;
+	t_controller_pose_filter_command_queue m_PoseFilterCommandQueue; // main thread -> IMU thread
+	t_controller_pose_filter_command_queue m_RetiredPoseFilterQueue; // IMU thread -> main thread
+	class PoseFilterSnapshot *m_pose_filter_snapshot; // published by the IMU thread
     
     // Filter state
-    ControllerOpticalPoseEstimation *m_tracker_pose_estimations; // array of size TrackerManager::k_max_devices
+    ControllerOpticalPoseEstimation *m_tracker_pose_estimations; // array of size TrackerManager::getMaxDevices()
+    ControllerOpticalPoseEstimation *m_tracker_projections; // new projections handed over by the trackers this frame
+    unsigned int m_new_tracker_projection_bitmask; // which trackers have an entry in m_tracker_projections
     ControllerOpticalPoseEstimation *m_multicam_pose_estimation;
     class IPoseFilter *m_pose_filter;
     class PoseFilterSpace *m_pose_filter_space;
     int m_lastPollSeqNumProcessed;
     std::chrono::time_point<std::chrono::high_resolution_clock> m_last_filter_update_timestamp;
     bool m_last_filter_update_timestamp_valid;
+    struct PoseSensorPacketAccumulator *m_imu_backlog_accumulator;
+
+    // Service statistics, registered while the controller is open
+    class ServiceStatistic *m_imu_packet_statistic;
+    class ServiceStatistic *m_downsampled_imu_packet_statistic;
+    class ServiceStatistic *m_imu_queue_overflow_statistic;
 };
 
 #endif // SERVER_CONTROLLER_VIEW_H
@@ -1,4 +1,5 @@
 //-- includes -----
+#include "DeviceClockModel.h"
 #include "DeviceManager.h"
 #include "ServerHMDView.h"
 #include "MathAlignment.h"
@@ -10,11 +11,15 @@
 #include "ServerLog.h"
 #include "ServerRequestHandler.h"
 #include "ServerTrackerView.h"
+#include "ServiceStatistics.h"
 #include "TrackerManager.h"
 
+#include <vector>
+
 //-- constants -----
 static const float k_min_time_delta_seconds = 1 / 120.f;
 static const float k_max_time_delta_seconds = 1 / 30.f;
+static const float k_min_imu_sample_time_delta_seconds = 1 / 2500.f;
 
 //-- private methods -----
 static void init_filters_for_morpheus_hmd(
@@ -25,14 +30,20 @@ static IPoseFilter *pose_filter_factory(
 	const CommonDeviceState::eDeviceType deviceType,
 	const std::string &position_filter_type, const std::string &orientation_filter_type,
 	const PoseFilterConstants &constants);
-static void update_filters_for_morpheus_hmd(
+template <typename t_hmd_state>
+static void copy_hmd_states_newer_than(
+    const IDeviceInterface *device, int poll_sequence_number, std::vector<t_hmd_state> &out_states);
+static void append_sensor_packets_for_morpheus_hmd(
 	const MorpheusHMD *morpheusHMD, const MorpheusHMDState *morpheusHMDState,
-	const float delta_time,
-	const HMDOpticalPoseEstimation *poseEstimation, const PoseFilterSpace *poseFilterSpace, IPoseFilter *poseFilter);
-static void update_filters_for_virtual_hmd(
+	const std::chrono::time_point<std::chrono::high_resolution_clock> sample_timestamps[2],
+	const float sample_time_deltas[2],
+	const HMDOpticalPoseEstimation *poseEstimation,
+	std::vector<PoseSensorPacket> &outSensorPackets, std::vector<float> &outTimeDeltas);
+static void append_sensor_packets_for_virtual_hmd(
 	const VirtualHMD *virtualHMD, const VirtualHMDState *virtualHMDState,
 	const float delta_time,
-	const HMDOpticalPoseEstimation *poseEstimation, const PoseFilterSpace *poseFilterSpace, IPoseFilter *poseFilter);
+	const HMDOpticalPoseEstimation *poseEstimation,
+	std::vector<PoseSensorPacket> &outSensorPackets, std::vector<float> &outTimeDeltas);
 static void generate_morpheus_hmd_data_frame_for_stream(
     const ServerHMDView *hmd_view, const HMDStreamInfo *stream_info,
     DeviceOutputDataFramePtr &data_frame);
@@ -80,17 +91,25 @@ ServerHMDView::ServerHMDView(const int device_id)
 	, m_roi_disable_count(0)
 	, m_device(nullptr)
 	, m_tracker_pose_estimations(nullptr)
+	, m_tracker_projections(nullptr)
+	, m_new_tracker_projection_bitmask(0)
 	, m_multicam_pose_estimation(nullptr)
 	, m_pose_filter(nullptr)
 	, m_pose_filter_space(nullptr)
 	, m_lastPollSeqNumProcessed(-1)
 	, m_last_filter_update_timestamp()
 	, m_last_filter_update_timestamp_valid(false)
+	, m_device_clock(new DeviceClockModel)
+	, m_last_imu_sample_timestamp()
+	, m_last_imu_sample_timestamp_valid(false)
+	, m_imu_packet_statistic(nullptr)
+	, m_dropped_imu_packet_statistic(nullptr)
 {
 }
 
 ServerHMDView::~ServerHMDView()
 {
+	delete m_device_clock;
 }
 
 bool ServerHMDView::allocate_device_interface(const class DeviceEnumerator *enumerator)
@@ -102,8 +121,10 @@ bool ServerHMDView::allocate_device_interface(const class DeviceEnumerator *enum
             m_device = new MorpheusHMD();
 			m_pose_filter = nullptr; // no pose filter until the device is opened
 
-			m_tracker_pose_estimations = new HMDOpticalPoseEstimation[TrackerManager::k_max_devices];
-			for (int tracker_index = 0; tracker_index < TrackerManager::k_max_devices; ++tracker_index)
+			m_tracker_pose_estimations = new HMDOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+			m_tracker_projections = new HMDOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+			m_new_tracker_projection_bitmask = 0;
+			for (int tracker_index = 0; tracker_index < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++tracker_index)
 			{
 				m_tracker_pose_estimations[tracker_index].clear();
 			}
@@ -116,8 +137,10 @@ bool ServerHMDView::allocate_device_interface(const class DeviceEnumerator *enum
             m_device = new VirtualHMD();
 			m_pose_filter = nullptr; // no pose filter until the device is opened
 
-			m_tracker_pose_estimations = new HMDOpticalPoseEstimation[TrackerManager::k_max_devices];
-			for (int tracker_index = 0; tracker_index < TrackerManager::k_max_devices; ++tracker_index)
+			m_tracker_pose_estimations = new HMDOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+			m_tracker_projections = new HMDOpticalPoseEstimation[DeviceManager::getInstance()->getTrackerViewMaxCount()];
+			m_new_tracker_projection_bitmask = 0;
+			for (int tracker_index = 0; tracker_index < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++tracker_index)
 			{
 				m_tracker_pose_estimations[tracker_index].clear();
 			}
@@ -146,6 +169,12 @@ void ServerHMDView::free_device_interface()
 		m_tracker_pose_estimations = nullptr;
 	}
 
+	if (m_tracker_projections != nullptr)
+	{
+		delete[] m_tracker_projections;
+		m_tracker_projections = nullptr;
+	}
+
 	if (m_pose_filter_space != nullptr)
 	{
 		delete m_pose_filter_space;
@@ -179,17 +208,31 @@ bool ServerHMDView::open(const class DeviceEnumerator *enumerator)
 		switch (device->getDeviceType())
 		{
 		case CommonDeviceState::Morpheus:
+			{
+				// Create a pose filter based on the HMD type
+				resetPoseFilter();
+				m_multicam_pose_estimation->clear();
+                bAllocateTrackingColor= true;
+
+				// IMU samples are timed by the headset's own clock
+				m_device_clock->reset(MORPHEUS_IMU_TIMESTAMP_BITS, MORPHEUS_IMU_TIMESTAMP_TICK_SECONDS);
+			} break;
         case CommonDeviceState::VirtualHMD:
 			{
 				// Create a pose filter based on the HMD type
 				resetPoseFilter();
 				m_multicam_pose_estimation->clear();
                 bAllocateTrackingColor= true;
+
+				// No IMU
+				m_device_clock->reset(0, 0.0);
 			} break;
 		default:
 			break;
 		}
 
+		m_last_imu_sample_timestamp_valid= false;
+
         // If needed for this kind of HMD, assign a tracking color id
         if (bAllocateTrackingColor)
         {
@@ -218,6 +261,10 @@ bool ServerHMDView::open(const class DeviceEnumerator *enumerator)
 
         // Reset the poll sequence number high water mark
         m_lastPollSeqNumProcessed = -1;
+
+        const std::string statistic_prefix= "hmd." + std::to_string(getDeviceID());
+        m_imu_packet_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".imu_packets");
+        m_dropped_imu_packet_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".dropped_imu_packets");
     }
 
     return bSuccess;
@@ -236,6 +283,11 @@ void ServerHMDView::close()
         }
     }
 
+    ServiceStatistics::releaseStatistic(m_imu_packet_statistic);
+    ServiceStatistics::releaseStatistic(m_dropped_imu_packet_statistic);
+    m_imu_packet_statistic= nullptr;
+    m_dropped_imu_packet_statistic= nullptr;
+
     ServerDeviceView::close();
 }
 
@@ -319,26 +371,16 @@ void ServerHMDView::updateOpticalPoseEstimation(TrackerManager* tracker_manager)
                     // Initially the newTrackerPoseEstimate is a copy of the existing pose
                     bool bIsVisibleThisUpdate= false;
 
-                    // If a new video frame is available this tick, 
-                    // attempt to update the tracking location
-                    if (tracker->getHasUnpublishedState())
+                    // If the tracker handed over a projection since the last update, use it.
+                    // Pipelined trackers hand one over whenever their worker finishes a frame,
+                    // which usually isn't an update that polled a new video frame.
+                    if ((m_new_tracker_projection_bitmask & (1 << tracker_id)) != 0)
                     {
-                        // Create a copy of the pose estimate state so that in event of a 
-                        // failure part way through computing the projection we don't
-                        // set partially valid state
-                        HMDOpticalPoseEstimation newTrackerPoseEstimate= trackerPoseEstimateRef;
-
-                        if (tracker->computeProjectionForHMD(
-                                this, 
-                                &trackingShape,
-                                &newTrackerPoseEstimate))
-                        {
-                            bIsVisibleThisUpdate= true;
+                        bIsVisibleThisUpdate= true;
 
-                            // Actually apply the pose estimate state
-                            trackerPoseEstimateRef= newTrackerPoseEstimate;
-                            trackerPoseEstimateRef.last_visible_timestamp = now;
-                        }
+                        // Actually apply the pose estimate state
+                        trackerPoseEstimateRef= m_tracker_projections[tracker_id];
+                        trackerPoseEstimateRef.last_visible_timestamp = now;
                     }
 
                     // If the projection isn't too old (or updated this tick), 
@@ -368,6 +410,9 @@ void ServerHMDView::updateOpticalPoseEstimation(TrackerManager* tracker_manager)
             trackerPoseEstimateRef.bCurrentlyTracking = bCurrentlyTracking;
         }
 
+        // All of the new tracker projections have been consumed
+        m_new_tracker_projection_bitmask = 0;
+
         // How we compute the final world pose estimate varies based on
         // * Number of trackers that currently have a valid projections of the controller
         // * The kind of projection shape (psmove sphere or ds4 lightbar)
@@ -449,18 +494,30 @@ void ServerHMDView::updateStateAndPredict()
 		return;
 	}
 
-	// Look backward in time to find the first HMD update state with a poll sequence number 
-	// newer than the last sequence number we've processed.
-	int firstLookBackIndex = -1;
-	int testLookBack = 0;
-	const CommonHMDState *state = getState(testLookBack);
-	while (state != nullptr && state->PollSequenceNumber > m_lastPollSeqNumProcessed)
+	// Copy out the HMD states polled since the last sequence number we've processed in a single pass.
+	// The device keeps polling meanwhile, so only the states copied here are counted and processed.
+	std::vector<MorpheusHMDState> morpheusStates;
+	std::vector<VirtualHMDState> virtualStates;
+	std::vector<const CommonHMDState *> newStates;
+	switch (m_device->getDeviceType())
 	{
-		firstLookBackIndex = testLookBack;
-		testLookBack++;
-		state = getState(testLookBack);
+	case CommonDeviceState::Morpheus:
+		copy_hmd_states_newer_than(m_device, m_lastPollSeqNumProcessed, morpheusStates);
+		for (const MorpheusHMDState &state : morpheusStates) newStates.push_back(&state);
+		break;
+	case CommonDeviceState::VirtualHMD:
+		copy_hmd_states_newer_than(m_device, m_lastPollSeqNumProcessed, virtualStates);
+		for (const VirtualHMDState &state : virtualStates) newStates.push_back(&state);
+		break;
+	default:
+		assert(0 && "Unhandled HMD type");
+	}
+
+	const int newStateCount = static_cast<int>(newStates.size());
+	if (newStateCount == 0)
+	{
+		return;
 	}
-	assert(firstLookBackIndex >= 0);
 
 	// Compute the time in seconds since the last update
 	const std::chrono::time_point<std::chrono::high_resolution_clock> now = std::chrono::high_resolution_clock::now();
@@ -481,13 +538,22 @@ void ServerHMDView::updateStateAndPredict()
 	m_last_filter_update_timestamp_valid = true;
 
 	// Evenly apply the list of hmd state updates over the time since last filter update
-	float per_state_time_delta_seconds = time_delta_seconds / static_cast<float>(firstLookBackIndex + 1);
+	float per_state_time_delta_seconds = time_delta_seconds / static_cast<float>(newStateCount);
+
+	// Gather the sensor packets for the polled hmd states forward in time
+	std::vector<PoseSensorPacket> sensorPackets;
+	std::vector<float> timeDeltas;
+	sensorPackets.reserve(2*newStateCount);
+	timeDeltas.reserve(2*newStateCount);
 
-	// Process the polled hmd states forward in time
-	// computing the new orientation along the way.
-	for (int lookBackIndex = firstLookBackIndex; lookBackIndex >= 0; --lookBackIndex)
+	for (const CommonHMDState *hmdState : newStates)
 	{
-		const CommonHMDState *hmdState = getState(lookBackIndex);
+		// States that fell out of the state history before we got to them
+		if (m_dropped_imu_packet_statistic != nullptr &&
+			m_lastPollSeqNumProcessed >= 0 && hmdState->PollSequenceNumber > m_lastPollSeqNumProcessed + 1)
+		{
+			m_dropped_imu_packet_statistic->increment(hmdState->PollSequenceNumber - m_lastPollSeqNumProcessed - 1);
+		}
 
 		switch (hmdState->DeviceType)
 		{
@@ -496,26 +562,36 @@ void ServerHMDView::updateStateAndPredict()
 			    const MorpheusHMD *morpheusHMD = this->castCheckedConst<MorpheusHMD>();
 			    const MorpheusHMDState *morpheusHMDState = static_cast<const MorpheusHMDState *>(hmdState);
 
-			    // Only update the position filter when tracking is enabled
-			    update_filters_for_morpheus_hmd(
+				// Time each IMU sample by the headset clock rather than spreading the
+				// backlog of states over the time since the last update
+				std::chrono::time_point<std::chrono::high_resolution_clock> sample_timestamps[2];
+				float sample_time_deltas[2];
+				for (int frame = 0; frame < 2; ++frame)
+				{
+					sample_timestamps[frame]= 
+						m_device_clock->update(
+							morpheusHMDState->SensorFrames[frame].RawTimeStamp, 
+							morpheusHMDState->HostArrivalTime);
+					sample_time_deltas[frame]= 
+						computeIMUSampleTimeDelta(sample_timestamps[frame], per_state_time_delta_seconds / 2.f);
+				}
+
+			    append_sensor_packets_for_morpheus_hmd(
 				    morpheusHMD, morpheusHMDState,
-				    per_state_time_delta_seconds,
+				    sample_timestamps, sample_time_deltas,
 				    m_multicam_pose_estimation,
-				    m_pose_filter_space,
-				    m_pose_filter);
+				    sensorPackets, timeDeltas);
 		    } break;
 		case CommonHMDState::VirtualHMD:
 		    {
 			    const VirtualHMD *virtualHMD = this->castCheckedConst<VirtualHMD>();
 			    const VirtualHMDState *virtualHMDState = static_cast<const VirtualHMDState *>(hmdState);
 
-			    // Only update the position filter when tracking is enabled
-			    update_filters_for_virtual_hmd(
+			    append_sensor_packets_for_virtual_hmd(
 				    virtualHMD, virtualHMDState,
 				    per_state_time_delta_seconds,
 				    m_multicam_pose_estimation,
-				    m_pose_filter_space,
-				    m_pose_filter);
+				    sensorPackets, timeDeltas);
 		    } break;
 		default:
 			assert(0 && "Unhandled HMD type");
@@ -524,6 +600,41 @@ void ServerHMDView::updateStateAndPredict()
 		// Consider this hmd state sequence num processed
 		m_lastPollSeqNumProcessed = hmdState->PollSequenceNumber;
 	}
+
+	if (m_imu_packet_statistic != nullptr)
+	{
+		m_imu_packet_statistic->increment(newStateCount);
+	}
+
+	// Process the sensor packets from oldest to newest in a single filter update
+	if (m_pose_filter != nullptr && sensorPackets.size() > 0)
+	{
+		PoseSensorPacketSpan sensorPacketSpan;
+		sensorPacketSpan.packets= sensorPackets.data();
+		sensorPacketSpan.time_deltas= timeDeltas.data();
+		sensorPacketSpan.count= sensorPackets.size();
+
+		m_pose_filter->updateBatch(m_pose_filter_space, sensorPacketSpan);
+	}
+}
+
+float ServerHMDView::computeIMUSampleTimeDelta(
+	const std::chrono::time_point<std::chrono::high_resolution_clock> &sample_timestamp,
+	float fallback_time_delta_seconds)
+{
+	float time_delta_seconds= fallback_time_delta_seconds;
+
+	if (m_last_imu_sample_timestamp_valid)
+	{
+		const std::chrono::duration<float> time_delta= sample_timestamp - m_last_imu_sample_timestamp;
+
+		time_delta_seconds= clampf(time_delta.count(), k_min_imu_sample_time_delta_seconds, k_max_time_delta_seconds);
+	}
+
+	m_last_imu_sample_timestamp= sample_timestamp;
+	m_last_imu_sample_timestamp_valid= true;
+
+	return time_delta_seconds;
 }
 
 CommonDevicePose
@@ -966,134 +1077,123 @@ pose_filter_factory(
 	return filter;
 }
 
+template <typename t_hmd_state>
+static void
+copy_hmd_states_newer_than(
+    const IDeviceInterface *device, 
+    int poll_sequence_number, 
+    std::vector<t_hmd_state> &out_states)
+{
+    device->visitStatesNewerThan(
+        poll_sequence_number,
+        [&out_states](const CommonDeviceState *device_state)
+    {
+        out_states.push_back(*static_cast<const t_hmd_state *>(device_state));
+    });
+}
+
 static void
-update_filters_for_morpheus_hmd(
+append_sensor_packets_for_morpheus_hmd(
     const MorpheusHMD *morpheusHMD,
     const MorpheusHMDState *morpheusHMDState,
-	const float delta_time,
+	const std::chrono::time_point<std::chrono::high_resolution_clock> sample_timestamps[2],
+	const float sample_time_deltas[2],
 	const HMDOpticalPoseEstimation *poseEstimation,
-	const PoseFilterSpace *poseFilterSpace,
-	IPoseFilter *poseFilter)
+	std::vector<PoseSensorPacket> &outSensorPackets,
+	std::vector<float> &outTimeDeltas)
 {
-    const MorpheusHMDConfig *config = morpheusHMD->getConfig();
+	PoseSensorPacket sensorPacket;
 
-	// Update the orientation filter
-	if (poseFilter != nullptr)
+	sensorPacket.clear();
+
+	if (poseEstimation->bOrientationValid)
 	{
-		PoseSensorPacket sensorPacket;
+		sensorPacket.optical_orientation =
+			Eigen::Quaternionf(
+				poseEstimation->orientation.w,
+				poseEstimation->orientation.x,
+				poseEstimation->orientation.y,
+				poseEstimation->orientation.z);
+	}
+	else
+	{
+		sensorPacket.optical_orientation = Eigen::Quaternionf::Identity();
+	}
 
-		sensorPacket.imu_magnetometer_unit = Eigen::Vector3f::Zero();
+	if (poseEstimation->bCurrentlyTracking)
+	{
+		sensorPacket.optical_position_cm =
+			Eigen::Vector3f(
+				poseEstimation->position_cm.x,
+				poseEstimation->position_cm.y,
+				poseEstimation->position_cm.z);
+		sensorPacket.tracking_projection_area_px_sqr = poseEstimation->projection.screen_area;
+	}
+	else
+	{
+		sensorPacket.optical_position_cm = Eigen::Vector3f::Zero();
+		sensorPacket.tracking_projection_area_px_sqr = 0.f;
+	}
 
-		if (poseEstimation->bOrientationValid)
-		{
-			sensorPacket.optical_orientation =
-				Eigen::Quaternionf(
-					poseEstimation->orientation.w,
-					poseEstimation->orientation.x,
-					poseEstimation->orientation.y,
-					poseEstimation->orientation.z);
-		}
-		else
-		{
-			sensorPacket.optical_orientation = Eigen::Quaternionf::Identity();
-		}
+	// Each state update contains two readings (one earlier and one later) of accelerometer and gyro data
+	for (int frame = 0; frame < 2; ++frame)
+	{
+		const MorpheusHMDSensorFrame &sensorFrame= morpheusHMDState->SensorFrames[frame];
 
-		if (poseEstimation->bCurrentlyTracking)
-		{
-			sensorPacket.optical_position_cm =
-				Eigen::Vector3f(
-					poseEstimation->position_cm.x,
-					poseEstimation->position_cm.y,
-					poseEstimation->position_cm.z);
-			sensorPacket.tracking_projection_area_px_sqr = poseEstimation->projection.screen_area;
-		}
-		else
-		{
-			sensorPacket.optical_position_cm = Eigen::Vector3f::Zero();
-			sensorPacket.tracking_projection_area_px_sqr = 0.f;
-		}
+		sensorPacket.timestamp = sample_timestamps[frame];
 
-		// Each state update contains two readings (one earlier and one later) of accelerometer and gyro data
-		for (int frame = 0; frame < 2; ++frame)
-		{
-			const MorpheusHMDSensorFrame &sensorFrame= morpheusHMDState->SensorFrames[frame];
-
-			sensorPacket.imu_accelerometer_g_units =
-				Eigen::Vector3f(
-					sensorFrame.CalibratedAccel.i,
-					sensorFrame.CalibratedAccel.j,
-					sensorFrame.CalibratedAccel.k);
-			sensorPacket.imu_gyroscope_rad_per_sec =
-				Eigen::Vector3f(
-					sensorFrame.CalibratedGyro.i,
-					sensorFrame.CalibratedGyro.j,
-					sensorFrame.CalibratedGyro.k);
-			sensorPacket.imu_magnetometer_unit = Eigen::Vector3f::Zero();
+		sensorPacket.imu_accelerometer_g_units =
+			Eigen::Vector3f(
+				sensorFrame.CalibratedAccel.i,
+				sensorFrame.CalibratedAccel.j,
+				sensorFrame.CalibratedAccel.k);
+		sensorPacket.has_accelerometer_measurement = true;
 
-			{
-				PoseFilterPacket filterPacket;
+		sensorPacket.imu_gyroscope_rad_per_sec =
+			Eigen::Vector3f(
+				sensorFrame.CalibratedGyro.i,
+				sensorFrame.CalibratedGyro.j,
+				sensorFrame.CalibratedGyro.k);
+		sensorPacket.has_gyroscope_measurement = true;
 
-				// Create a filter input packet from the sensor data 
-				// and the filter's previous orientation and position
-				poseFilterSpace->createFilterPacket(
-					sensorPacket,
-					poseFilter,
-					filterPacket);
+		sensorPacket.imu_magnetometer_unit = Eigen::Vector3f::Zero();
 
-				poseFilter->update(delta_time / 2.f, filterPacket);
-			}
-		}
+		outSensorPackets.push_back(sensorPacket);
+		outTimeDeltas.push_back(sample_time_deltas[frame]);
 	}
 }
 
 static void
-update_filters_for_virtual_hmd(
+append_sensor_packets_for_virtual_hmd(
     const VirtualHMD *virtualHMD,
     const VirtualHMDState *virtualHMDState,
 	const float delta_time,
 	const HMDOpticalPoseEstimation *poseEstimation,
-	const PoseFilterSpace *poseFilterSpace,
-	IPoseFilter *poseFilter)
+	std::vector<PoseSensorPacket> &outSensorPackets,
+	std::vector<float> &outTimeDeltas)
 {
-    const VirtualHMDConfig *config = virtualHMD->getConfig();
-
-	// Update the orientation filter
-	if (poseFilter != nullptr)
-	{
-		PoseSensorPacket sensorPacket;
-
-		sensorPacket.imu_magnetometer_unit = Eigen::Vector3f::Zero();
-		sensorPacket.optical_orientation = Eigen::Quaternionf::Identity();
+	PoseSensorPacket sensorPacket;
 
-		if (poseEstimation->bCurrentlyTracking)
-		{
-			sensorPacket.optical_position_cm =
-				Eigen::Vector3f(
-					poseEstimation->position_cm.x,
-					poseEstimation->position_cm.y,
-					poseEstimation->position_cm.z);
-			sensorPacket.tracking_projection_area_px_sqr = poseEstimation->projection.screen_area;
-		}
-		else
-		{
-			sensorPacket.optical_position_cm = Eigen::Vector3f::Zero();
-			sensorPacket.tracking_projection_area_px_sqr = 0.f;
-		}
-
-		sensorPacket.imu_accelerometer_g_units = Eigen::Vector3f::Zero();
-		sensorPacket.imu_gyroscope_rad_per_sec = Eigen::Vector3f::Zero();
-		sensorPacket.imu_magnetometer_unit = Eigen::Vector3f::Zero();
+	sensorPacket.clear();
+	sensorPacket.optical_orientation = Eigen::Quaternionf::Identity();
 
-		{
-			PoseFilterPacket filterPacket;
-
-			// Create a filter input packet from the sensor data 
-			// and the filter's previous orientation and position
-			poseFilterSpace->createFilterPacket(sensorPacket, poseFilter, filterPacket);
-
-			poseFilter->update(delta_time, filterPacket);
-		}
+	if (poseEstimation->bCurrentlyTracking)
+	{
+		sensorPacket.optical_position_cm =
+			Eigen::Vector3f(
+				poseEstimation->position_cm.x,
+				poseEstimation->position_cm.y,
+				poseEstimation->position_cm.z);
+		sensorPacket.tracking_projection_area_px_sqr = poseEstimation->projection.screen_area;
 	}
+	else
+	{
+		sensorPacket.optical_position_cm = Eigen::Vector3f::Zero();
+		sensorPacket.tracking_projection_area_px_sqr = 0.f;
+	}
+
+	outSensorPackets.push_back(sensorPacket);
+	outTimeDeltas.push_back(delta_time);
 }
 
 static void generate_morpheus_hmd_data_frame_for_stream(
@@ -1104,16 +1204,17 @@ static void generate_morpheus_hmd_data_frame_for_stream(
     const MorpheusHMD *morpheus_hmd = hmd_view->castCheckedConst<MorpheusHMD>();
     const MorpheusHMDConfig *morpheus_config = morpheus_hmd->getConfig();
 	const IPoseFilter *pose_filter = hmd_view->getPoseFilter();
-    const CommonHMDState *hmd_state = hmd_view->getState();
     const CommonDevicePose hmd_pose = hmd_view->getFilteredPose();
 
+    // Work from our own copy of the newest state, the device keeps polling meanwhile
+    MorpheusHMDState morpheus_hmd_state_copy;
+    const MorpheusHMDState * morpheus_hmd_state = 
+        morpheus_hmd->fetchState(0, morpheus_hmd_state_copy) ? &morpheus_hmd_state_copy : nullptr;
+
     PSMoveProtocol::DeviceOutputDataFrame_HMDDataPacket *hmd_data_frame = data_frame->mutable_hmd_data_packet();
 
-    if (hmd_state != nullptr)
+    if (morpheus_hmd_state != nullptr)
     {
-        assert(hmd_state->DeviceType == CommonDeviceState::Morpheus);
-        const MorpheusHMDState * morpheus_hmd_state = static_cast<const MorpheusHMDState *>(hmd_state);
-
         PSMoveProtocol::DeviceOutputDataFrame_HMDDataPacket_MorpheusState* morpheus_data_frame = 
             hmd_data_frame->mutable_morpheus_state();
 
@@ -1208,7 +1309,7 @@ static void generate_morpheus_hmd_data_frame_for_stream(
             int selectedTrackerId= stream_info->selected_tracker_index;
             unsigned int validTrackerBitmask= 0;
 
-            for (int trackerId = 0; trackerId < TrackerManager::k_max_devices; ++trackerId)
+            for (int trackerId = 0; trackerId < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++trackerId)
             {
 			    const HMDOpticalPoseEstimation *positionEstimate = hmd_view->getTrackerPoseEstimate(trackerId);
 
@@ -1276,16 +1377,17 @@ static void generate_virtual_hmd_data_frame_for_stream(
     const VirtualHMD *virtual_hmd = hmd_view->castCheckedConst<VirtualHMD>();
     const VirtualHMDConfig *virtual_hmd_config = virtual_hmd->getConfig();
 	const IPoseFilter *pose_filter = hmd_view->getPoseFilter();
-    const CommonHMDState *hmd_state = hmd_view->getState();
     const CommonDevicePose hmd_pose = hmd_view->getFilteredPose();
 
+    // Work from our own copy of the newest state, the device keeps polling meanwhile
+    VirtualHMDState virtual_hmd_state_copy;
+    const VirtualHMDState * virtual_hmd_state = 
+        virtual_hmd->fetchState(0, virtual_hmd_state_copy) ? &virtual_hmd_state_copy : nullptr;
+
     PSMoveProtocol::DeviceOutputDataFrame_HMDDataPacket *hmd_data_frame = data_frame->mutable_hmd_data_packet();
 
-    if (hmd_state != nullptr)
+    if (virtual_hmd_state != nullptr)
     {
-        assert(hmd_state->DeviceType == CommonDeviceState::VirtualHMD);
-        const VirtualHMDState * virtual_hmd_state = static_cast<const VirtualHMDState *>(hmd_state);
-
         auto * virtual_hmd_data_frame = hmd_data_frame->mutable_virtual_hmd_state();
 
 		virtual_hmd_data_frame->set_iscurrentlytracking(hmd_view->getIsCurrentlyTracking());
@@ -1327,7 +1429,7 @@ static void generate_virtual_hmd_data_frame_for_stream(
 			int selectedTrackerId= stream_info->selected_tracker_index;
             unsigned int validTrackerBitmask= 0;
 
-            for (int trackerId = 0; trackerId < TrackerManager::k_max_devices; ++trackerId)
+            for (int trackerId = 0; trackerId < DeviceManager::getInstance()->getTrackerViewMaxCount(); ++trackerId)
             {
 			    const HMDOpticalPoseEstimation *positionEstimate = hmd_view->getTrackerPoseEstimate(trackerId);
 
@@ -116,6 +116,13 @@ public:
 		return (m_tracker_pose_estimations != nullptr) ? &m_tracker_pose_estimations[trackerId] : nullptr;
 	}
 
+	// Hand over the projection a tracker found in its latest video frame.
+	// Applied by the next updateOpticalPoseEstimation().
+	inline void setTrackerProjection(int trackerId, const HMDOpticalPoseEstimation &pose_estimate) {
+		m_tracker_projections[trackerId] = pose_estimate;
+		m_new_tracker_projection_bitmask |= (1 << trackerId);
+	}
+
 	// Get the pose estimate derived from multicam pose tracking
 	inline const HMDOpticalPoseEstimation *getMulticamPoseEstimate() const {
 		return m_multicam_pose_estimation;
@@ -136,6 +143,11 @@ protected:
         const struct HMDStreamInfo *stream_info,
         DeviceOutputDataFramePtr &data_frame);
 
+	// Time since the previous IMU sample (or the fallback for the first sample)
+	float computeIMUSampleTimeDelta(
+		const std::chrono::time_point<std::chrono::high_resolution_clock> &sample_timestamp,
+		float fallback_time_delta_seconds);
+
 private:
 	// Tracking color state
 	int m_tracking_listener_count;
@@ -148,13 +160,22 @@ private:
     IHMDInterface *m_device;
 
 	// Filter state
-	HMDOpticalPoseEstimation *m_tracker_pose_estimations; // array of size TrackerManager::k_max_devices
+	HMDOpticalPoseEstimation *m_tracker_pose_estimations; // array of size TrackerManager::getMaxDevices()
+	HMDOpticalPoseEstimation *m_tracker_projections; // new projections handed over by the trackers this frame
+	unsigned int m_new_tracker_projection_bitmask; // which trackers have an entry in m_tracker_projections
 	HMDOpticalPoseEstimation *m_multicam_pose_estimation;
 	class IPoseFilter *m_pose_filter;
 	class PoseFilterSpace *m_pose_filter_space;
     int m_lastPollSeqNumProcessed;
 	std::chrono::time_point<std::chrono::high_resolution_clock> m_last_filter_update_timestamp;
 	bool m_last_filter_update_timestamp_valid;
+	class DeviceClockModel *m_device_clock; // maps the IMU sample timestamps onto the host clock
+	std::chrono::time_point<std::chrono::high_resolution_clock> m_last_imu_sample_timestamp;
+	bool m_last_imu_sample_timestamp_valid;
+
+	// Service statistics, registered while the HMD is open
+	class ServiceStatistic *m_imu_packet_statistic;
+	class ServiceStatistic *m_dropped_imu_packet_statistic;
 };
 
 #endif // SERVER_HMD_VIEW_H
\ No newline at end of file
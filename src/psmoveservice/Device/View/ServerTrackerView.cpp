@@ -1,6 +1,7 @@
 //-- includes -----
 #include "DeviceEnumerator.h"
 #include "DeviceManager.h"
+#include "LightBarContourFit.h"
 #include "ServerTrackerView.h"
 #include "ServerControllerView.h"
 #include "ServerHMDView.h"
@@ -8,19 +9,29 @@
 #include "MathEigen.h"
 #include "MathGLM.h"
 #include "MathAlignment.h"
+#include "MathPlanarPose.h"
 #include "PS3EyeTracker.h"
+#include "RemoteTracker.h"
 #include "PSMoveProtocol.pb.h"
 #include "ServerUtility.h"
 #include "ServerLog.h"
+#include "ServerNetworkManager.h"
 #include "ServerRequestHandler.h"
+#include "ServiceStatistics.h"
 #include "SharedTrackerState.h"
+#include "TrackerDeviceEnumerator.h"
 #include "TrackerManager.h"
+#include "TrackerNodeManager.h"
+#include "TrackerOpticalPipeline.h"
+#include "TrackerVideoEncoder.h"
 #include "PoseFilterInterface.h"
+#include "VideoFramePool.h"
 
 #include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include <memory>
+#include <mutex>
 
 #include "opencv2/opencv.hpp"
 #include "opencv2/calib3d/calib3d.hpp"
@@ -31,6 +42,13 @@
 
 //-- constants ----
 static const int k_min_roi_size= 32;
+static const int k_hsv_tile_size= 16;
+static const int k_working_buffer_shrink_frames= 120;
+static const int k_exposure_clipped_value= 250; // HSV value at which a pixel counts as blown out
+static const float k_exposure_bulb_value_tolerance= 20.f;
+static const float k_exposure_max_step_fraction= 0.25f;
+static const double k_exposure_min_setting_step= 4.0; // the PS3 Eye's 64 gain levels are spread over 0-255
+static const int k_exposure_min_sample_count= 5; // frames with a device in view between adjustments
 
 //-- typedefs ----
 typedef std::vector<cv::Point> t_opencv_int_contour;
@@ -253,8 +271,11 @@ class OpenCVBGRToHSVMapper
 public:
     typedef cv::Point3_<uint8_t> ColorTuple;
 
+    // Trackers running the optical pipeline allocate and free their buffers on their worker thread
     static OpenCVBGRToHSVMapper *allocate()
     {
+        std::lock_guard<std::mutex> lock(m_instanceMutex);
+
         if (m_refCount == 0)
         {
             assert(m_instance == nullptr);
@@ -268,6 +289,8 @@ public:
 
     static void dispose(OpenCVBGRToHSVMapper *instance)
     {
+        std::lock_guard<std::mutex> lock(m_instanceMutex);
+
         assert(m_instance != nullptr);
         assert(m_instance == instance);
         assert(m_refCount > 0);
@@ -280,6 +303,14 @@ public:
         }
     }
 
+    // Size of the lookup table shared by all trackers, 0 if no tracker uses it
+    static size_t getAllocatedBytes()
+    {
+        std::lock_guard<std::mutex> lock(m_instanceMutex);
+
+        return (m_instance != nullptr) ? m_instance->bgr2hsv->total()*m_instance->bgr2hsv->elemSize() : 0;
+    }
+
     void cvtColor(const cv::Mat &bgrBuffer, cv::Mat &hsvBuffer)
     {
         hsvBuffer.forEach<ColorTuple>([&bgrBuffer, this](ColorTuple &hsvColor, const int position[]) -> void {
@@ -296,6 +327,7 @@ public:
 private:
     static OpenCVBGRToHSVMapper *m_instance;
     static int m_refCount;
+    static std::mutex m_instanceMutex;
 
     OpenCVBGRToHSVMapper()
     {
@@ -331,29 +363,52 @@ private:
 };
 OpenCVBGRToHSVMapper *OpenCVBGRToHSVMapper::m_instance = nullptr;
 int OpenCVBGRToHSVMapper::m_refCount= 0;
+std::mutex OpenCVBGRToHSVMapper::m_instanceMutex;
 
 class OpenCVBufferState
 {
 public:
     OpenCVBufferState(ITrackerInterface *device)
-        : bgrBuffer(nullptr)
-        , bgrShmemBuffer(nullptr)
-        , hsvBuffer(nullptr)
-        , gsLowerBuffer(nullptr)
-        , gsUpperBuffer(nullptr)
-        , maskedBuffer(nullptr)
-    {
-        device->getVideoFrameDimensions(&frameWidth, &frameHeight, nullptr);
-
-        bgrBuffer = new cv::Mat(frameHeight, frameWidth, CV_8UC3);
-        bgrShmemBuffer = new cv::Mat(frameHeight, frameWidth, CV_8UC3);
-        hsvBuffer = new cv::Mat(frameHeight, frameWidth, CV_8UC3);
-        gsLowerBuffer = new cv::Mat(frameHeight, frameWidth, CV_8UC1);
-        gsUpperBuffer = new cv::Mat(frameHeight, frameWidth, CV_8UC1);
-        maskedBuffer = new cv::Mat(frameHeight, frameWidth, CV_8UC3);
+        : OpenCVBufferState(
+            getVideoFrameWidth(device), getVideoFrameHeight(device),
+            DeviceManager::getInstance()->m_tracker_manager->getConfig().use_bgr_to_hsv_lookup_table)
+    {
+    }
+
+    OpenCVBufferState(int frame_width, int frame_height, bool bUseBGRToHSVLookupTable)
+        : frameWidth(frame_width)
+        , frameHeight(frame_height)
+        , videoFrame()
+        , bgrBuffer()
+        , bgrShmemBuffer()
+        , hsvStorage()
+        , gsLowerStorage()
+        , gsUpperStorage()
+        , workingWindow(0, 0, 0, 0)
+        , workingWindowFrameSequenceNumber(-1)
+        , undersizedFrameCount(0)
+        , currentROI(0, 0, 0, 0)
+        , hsvTileColumns(0)
+        , hsvTileRows(0)
+        , frameSequenceNumber(-1)
+        , hsvPixelsRequested(0)
+        , hsvPixelsConverted(0)
+        , decimatedFrameSequenceNumber(-1)
+        , exposureSampleCount(0)
+        , bulbValueSum(0.f)
+        , bulbClippedFractionSum(0.f)
+        , backgroundValueSum(0.f)
+        , debugOverlayFrameSequenceNumber(-1)
+        , bDrawDebugOverlay(true)
+    {
+        // The HSV and mask buffers are allocated on demand to fit the ROIs, see setWorkingWindow()
+
+        // No tile of the HSV buffer is valid until the first frame is converted
+        hsvTileColumns = (frameWidth + k_hsv_tile_size - 1) / k_hsv_tile_size;
+        hsvTileRows = (frameHeight + k_hsv_tile_size - 1) / k_hsv_tile_size;
+        hsvTileFrameSequenceNumbers.assign(hsvTileColumns*hsvTileRows, -1);
         
-        const TrackerManagerConfig &cfg= DeviceManager::getInstance()->m_tracker_manager->getConfig();
-        if (cfg.use_bgr_to_hsv_lookup_table)
+        if (bUseBGRToHSVLookupTable)
         {
             bgr2hsv = OpenCVBGRToHSVMapper::allocate();
         }
@@ -361,71 +416,279 @@ public:
         {
             bgr2hsv = nullptr;
         }
-        
-        //Apply default ROI (full frame).
-        applyROI(cv::Rect2i(cv::Point(0,0), cv::Size(frameWidth, frameHeight)));
+    }
+
+    static int getVideoFrameWidth(const ITrackerInterface *device)
+    {
+        int width = 0, height = 0;
+        device->getVideoFrameDimensions(&width, &height, nullptr);
+        return width;
+    }
+
+    static int getVideoFrameHeight(const ITrackerInterface *device)
+    {
+        int width = 0, height = 0;
+        device->getVideoFrameDimensions(&width, &height, nullptr);
+        return height;
     }
 
     virtual ~OpenCVBufferState()
     {
-        if (maskedBuffer != nullptr)
+        if (bgr2hsv != nullptr)
         {
-            delete maskedBuffer;
+            OpenCVBGRToHSVMapper::dispose(bgr2hsv);
         }
-        
-        if (gsLowerBuffer != nullptr)
+    }
+
+    // Point bgrBuffer at the given video frame (no copy).
+    // Returns false if the frame doesn't match the buffer dimensions.
+    bool setVideoFrame(const VideoFrameRef &video_frame, int sequence_number)
+    {
+        if (video_frame->getSize() != static_cast<size_t>(frameWidth*frameHeight*3))
         {
-            delete gsLowerBuffer;
+            return false;
         }
-        
-        if (gsUpperBuffer != nullptr)
+
+        videoFrame = video_frame;
+        bgrBuffer = cv::Mat(frameHeight, frameWidth, CV_8UC3, videoFrame->getData());
+        frameROIs.clear();
+
+        // Every HSV tile stamped with an older sequence number is now stale
+        frameSequenceNumber = sequence_number;
+        hsvPixelsRequested = 0;
+        hsvPixelsConverted = 0;
+
+        exposureSampleCount = 0;
+        bulbValueSum = 0.f;
+        bulbClippedFractionSum = 0.f;
+        backgroundValueSum = 0.f;
+
+        return true;
+    }
+
+    inline bool hasVideoFrame() const { return videoFrame.isValid(); }
+
+    // Hand the video frame back to the tracker's frame pool
+    void releaseVideoFrame()
+    {
+        bgrBuffer = cv::Mat();
+        bgrROI = cv::Mat();
+        videoFrame = VideoFrameRef();
+        debugOverlayFrameSequenceNumber = -1;
+    }
+
+    // Start this search's debug lines on a fresh copy of the frame.
+    // The search only reads bgrBuffer, so the lines never reach the HSV conversion or the masks.
+    // The copy is only made while a client is watching the video.
+    void beginDebugOverlay(bool bHasVideoClients)
+    {
+        if (bDrawDebugOverlay && bHasVideoClients && hasVideoFrame())
         {
-            delete gsUpperBuffer;
+            bgrBuffer.copyTo(bgrShmemBuffer);
+            debugOverlayFrameSequenceNumber = frameSequenceNumber;
         }
-        
-        if (hsvBuffer != nullptr)
+        else
         {
-            delete hsvBuffer;
+            debugOverlayFrameSequenceNumber = -1;
         }
-        
-        if (bgrShmemBuffer != nullptr)
+    }
+
+    inline bool hasDebugOverlay() const
+    {
+        return bDrawDebugOverlay && debugOverlayFrameSequenceNumber == frameSequenceNumber && hasVideoFrame();
+    }
+
+    // The frame to show to clients watching the video
+    inline const cv::Mat &getDisplayFrame() const
+    {
+        return hasDebugOverlay() ? bgrShmemBuffer : bgrBuffer;
+    }
+    
+    // Bytes held by this tracker's HSV and mask buffers
+    size_t getWorkingBufferBytes() const
+    {
+        return 
+            hsvStorage.total()*hsvStorage.elemSize() +
+            gsLowerStorage.total()*gsLowerStorage.elemSize() +
+            gsUpperStorage.total()*gsUpperStorage.elemSize();
+    }
+
+    // Point the HSV and mask buffers at the given tile aligned window of the frame.
+    // The window only grows within a frame, keeping anything already converted this frame.
+    // The storage behind the buffers grows right away (e.g. for a full-frame reacquire)
+    // but is only given back once the window has stayed well under it for a while.
+    void setWorkingWindow(const cv::Rect2i &window)
+    {
+        const bool bKeepContents = 
+            workingWindowFrameSequenceNumber == frameSequenceNumber && workingWindow.area() > 0;
+        const cv::Rect2i newWindow = bKeepContents ? (window | workingWindow) : window;
+        const cv::Size capacity = hsvStorage.size();
+        const bool bFits = newWindow.width <= capacity.width && newWindow.height <= capacity.height;
+
+        if (!bKeepContents)
         {
-            delete bgrShmemBuffer;
+            undersizedFrameCount = (bFits && newWindow.area()*2 < capacity.area()) ? undersizedFrameCount + 1 : 0;
         }
-        
-        if (bgrBuffer != nullptr)
+
+        const bool bShrink = !bKeepContents && undersizedFrameCount >= k_working_buffer_shrink_frames;
+        if (newWindow == workingWindow && bFits && !bShrink)
         {
-            delete bgrBuffer;
+            // Still claim the unchanged window for this frame, so later ROIs in it keep what gets converted
+            workingWindowFrameSequenceNumber = frameSequenceNumber;
+            return;
         }
-        
-        if (bgr2hsv != nullptr)
+
+        // Move aside whatever was already converted this frame
+        cv::Mat oldHsv, oldGsLower, oldGsUpper;
+        const cv::Rect2i oldWindow = workingWindow;
+        if (bKeepContents)
         {
-            OpenCVBGRToHSVMapper::dispose(bgr2hsv);
+            oldHsv = hsvBuffer.clone();
+            oldGsLower = gsLowerBuffer.clone();
+            oldGsUpper = gsUpperBuffer.clone();
+        }
+
+        if (!bFits || bShrink)
+        {
+            // Leave some slack so the ROIs following a moving device don't keep reallocating
+            const cv::Size newCapacity = bShrink
+                ? cv::Size(
+                    std::min(newWindow.width + newWindow.width/4, frameWidth),
+                    std::min(newWindow.height + newWindow.height/4, frameHeight))
+                : cv::Size(
+                    std::max(newWindow.width, capacity.width),
+                    std::max(newWindow.height, capacity.height));
+
+            hsvStorage.create(newCapacity, CV_8UC3);
+            gsLowerStorage.create(newCapacity, CV_8UC1);
+            if (!gsUpperStorage.empty())
+            {
+                gsUpperStorage.create(newCapacity, CV_8UC1);
+            }
+            undersizedFrameCount = 0;
+        }
+
+        workingWindow = newWindow;
+        workingWindowFrameSequenceNumber = frameSequenceNumber;
+
+        const cv::Rect2i storageRect(0, 0, newWindow.width, newWindow.height);
+        hsvBuffer = cv::Mat(hsvStorage, storageRect);
+        gsLowerBuffer = cv::Mat(gsLowerStorage, storageRect);
+        gsUpperBuffer = gsUpperStorage.empty() ? cv::Mat() : cv::Mat(gsUpperStorage, storageRect);
+
+        if (bKeepContents)
+        {
+            const cv::Rect2i oldRect(oldWindow.tl() - newWindow.tl(), oldWindow.size());
+
+            oldHsv.copyTo(hsvBuffer(oldRect));
+            oldGsLower.copyTo(gsLowerBuffer(oldRect));
+            if (!oldGsUpper.empty() && !gsUpperBuffer.empty())
+            {
+                oldGsUpper.copyTo(gsUpperBuffer(oldRect));
+            }
         }
     }
 
-    void writeVideoFrame(const unsigned char *video_buffer)
+    // The upper hue mask is only needed for color ranges that wrap around hue 0
+    void ensureUpperMaskBuffer()
     {
-        const cv::Mat videoBufferMat(frameHeight, frameWidth, CV_8UC3, const_cast<unsigned char *>(video_buffer));
-
-        videoBufferMat.copyTo(*bgrBuffer);
-        videoBufferMat.copyTo(*bgrShmemBuffer);
+        if (gsUpperStorage.empty())
+        {
+            gsUpperStorage.create(hsvStorage.size(), CV_8UC1);
+            gsUpperBuffer = cv::Mat(gsUpperStorage, cv::Rect2i(0, 0, workingWindow.width, workingWindow.height));
+            gsUpperROI = cv::Mat(gsUpperBuffer, currentROI - workingWindow.tl());
+        }
     }
-    
-    void updateHsvBuffer()
+
+    void updateHsvBuffer(const cv::Rect2i &ROI)
     {
+        const cv::Mat bgrRegion(bgrBuffer, ROI);
+        cv::Mat hsvRegion(hsvBuffer, ROI - workingWindow.tl());
+
         // Convert the video buffer to the HSV color space
         if (bgr2hsv != nullptr)
         {
-            bgr2hsv->cvtColor(bgrROI, hsvROI);
+            bgr2hsv->cvtColor(bgrRegion, hsvRegion);
         }
         else
         {
-            cv::cvtColor(bgrROI, hsvROI, cv::COLOR_BGR2HSV);
+            cv::cvtColor(bgrRegion, hsvRegion, cv::COLOR_BGR2HSV);
         }
     }
-    
-    void applyROI(cv::Rect2i ROI)
+
+    // Convert the union of the given ROIs to HSV.
+    // The HSV buffer is tracked in k_hsv_tile_size square tiles stamped with the sequence number
+    // of the frame they were last converted in, so each tile is converted at most once per frame
+    // no matter how many ROIs touch it (even across calls).
+    void updateHsvBufferForROIs(const std::vector<cv::Rect2i> &ROIs)
+    {
+        // Fit the working buffers to the tile aligned bounding box of the ROIs
+        cv::Rect2i ROIBounds(0, 0, 0, 0);
+        for (const cv::Rect2i &ROI : ROIs)
+        {
+            if (ROI.area() > 0)
+            {
+                ROIBounds = (ROIBounds.area() > 0) ? (ROIBounds | ROI) : ROI;
+            }
+        }
+
+        if (ROIBounds.area() <= 0)
+            return;
+
+        const int window_x0 = (ROIBounds.x / k_hsv_tile_size)*k_hsv_tile_size;
+        const int window_y0 = (ROIBounds.y / k_hsv_tile_size)*k_hsv_tile_size;
+        const int window_x1 = std::min(((ROIBounds.br().x + k_hsv_tile_size - 1) / k_hsv_tile_size)*k_hsv_tile_size, frameWidth);
+        const int window_y1 = std::min(((ROIBounds.br().y + k_hsv_tile_size - 1) / k_hsv_tile_size)*k_hsv_tile_size, frameHeight);
+        setWorkingWindow(cv::Rect2i(window_x0, window_y0, window_x1 - window_x0, window_y1 - window_y0));
+
+        for (const cv::Rect2i &ROI : ROIs)
+        {
+            if (ROI.area() <= 0)
+                continue;
+
+            hsvPixelsRequested += ROI.area();
+
+            const int tile_x0 = ROI.x / k_hsv_tile_size;
+            const int tile_y0 = ROI.y / k_hsv_tile_size;
+            const int tile_x1 = std::min((ROI.x + ROI.width - 1) / k_hsv_tile_size, hsvTileColumns - 1);
+            const int tile_y1 = std::min((ROI.y + ROI.height - 1) / k_hsv_tile_size, hsvTileRows - 1);
+
+            for (int tile_y = tile_y0; tile_y <= tile_y1; ++tile_y)
+            {
+                int *tile_row = &hsvTileFrameSequenceNumbers[tile_y*hsvTileColumns];
+                int tile_x = tile_x0;
+
+                while (tile_x <= tile_x1)
+                {
+                    // Skip over the tiles already converted this frame
+                    if (tile_row[tile_x] == frameSequenceNumber)
+                    {
+                        ++tile_x;
+                        continue;
+                    }
+
+                    // Convert the run of stale tiles in one call
+                    const int run_start = tile_x;
+                    while (tile_x <= tile_x1 && tile_row[tile_x] != frameSequenceNumber)
+                    {
+                        tile_row[tile_x] = frameSequenceNumber;
+                        ++tile_x;
+                    }
+
+                    const cv::Rect2i run_rect = 
+                        cv::Rect2i(
+                            run_start*k_hsv_tile_size, tile_y*k_hsv_tile_size,
+                            (tile_x - run_start)*k_hsv_tile_size, k_hsv_tile_size)
+                        & cv::Rect2i(0, 0, frameWidth, frameHeight);
+
+                    updateHsvBuffer(run_rect);
+                    hsvPixelsConverted += run_rect.area();
+                }
+            }
+        }
+    }
+
+    cv::Rect2i clampROI(cv::Rect2i ROI) const
     {
         // Make sure the ROI box is always clamped in bounds of the frame buffer
         int x0= std::min(std::max(ROI.tl().x, 0), frameWidth-1);
@@ -451,19 +714,212 @@ public:
             ROI.width = frameWidth;
             ROI.height = frameHeight;
         }
-       
+
+        return ROI;
+    }
+
+    // Point the ROI matrices at the given (clamped) ROI.
+    // The HSV buffer for the ROI should already be up to date, see updateHsvBufferForROIs().
+    void applyROI(const cv::Rect2i &ROI)
+    {
+        if ((ROI & workingWindow) != ROI)
+        {
+            updateHsvBufferForROIs(std::vector<cv::Rect2i>(1, ROI));
+        }
+
         //Create the ROI matrices.
         //It's not a full copy, so this isn't too slow.
         //adjustROI is probably slightly faster but I ran into trouble with it.
-        bgrROI = cv::Mat(*bgrBuffer, ROI);
-        hsvROI = cv::Mat(*hsvBuffer, ROI);
-        gsLowerROI = cv::Mat(*gsLowerBuffer, ROI);
-        gsUpperROI = cv::Mat(*gsUpperBuffer, ROI);
-        
-        updateHsvBuffer();
+        const cv::Rect2i windowROI = ROI - workingWindow.tl();
+        currentROI = ROI;
+        bgrROI = cv::Mat(bgrBuffer, ROI);
+        hsvROI = cv::Mat(hsvBuffer, windowROI);
+        gsLowerROI = cv::Mat(gsLowerBuffer, windowROI);
+        gsUpperROI = gsUpperBuffer.empty() ? cv::Mat() : cv::Mat(gsUpperBuffer, windowROI);
+        frameROIs.push_back(ROI);
         
         //Draw ROI.
-        cv::rectangle(*bgrShmemBuffer, ROI, cv::Scalar(255, 0, 0));
+        if (hasDebugOverlay())
+        {
+            cv::rectangle(bgrShmemBuffer, ROI, cv::Scalar(255, 0, 0));
+        }
+    }
+
+    // Find the biggest blob of the color range in a copy of the whole frame decimated by the given factor
+    // and return the full resolution region around it worth searching (empty if there is no such blob).
+    // The decimated copy is made once per frame and shared by every device scanned for in it.
+    cv::Rect2i locateColorRangeInDecimatedFrame(const CommonHSVColorRange &hsvColorRange, int decimation)
+    {
+        const cv::Size decimatedSize(frameWidth / decimation, frameHeight / decimation);
+        if (decimation <= 1 || decimatedSize.area() <= 0)
+        {
+            return cv::Rect2i(0, 0, frameWidth, frameHeight);
+        }
+
+        if (decimatedFrameSequenceNumber != frameSequenceNumber || decimatedHsvBuffer.size() != decimatedSize)
+        {
+            // Nearest neighbor keeps the saturated color of a small blob instead of blending it into the background
+            cv::resize(bgrBuffer, decimatedBgrBuffer, decimatedSize, 0, 0, cv::INTER_NEAREST);
+            decimatedHsvBuffer.create(decimatedSize, CV_8UC3);
+            if (bgr2hsv != nullptr)
+            {
+                bgr2hsv->cvtColor(decimatedBgrBuffer, decimatedHsvBuffer);
+            }
+            else
+            {
+                cv::cvtColor(decimatedBgrBuffer, decimatedHsvBuffer, cv::COLOR_BGR2HSV);
+            }
+
+            decimatedFrameSequenceNumber = frameSequenceNumber;
+            hsvPixelsRequested += decimatedSize.area();
+            hsvPixelsConverted += decimatedSize.area();
+        }
+
+        computeColorRangeMask(hsvColorRange, decimatedHsvBuffer, decimatedLowerMask, decimatedUpperMask);
+
+        // A distant blob may be only a pixel or two across once decimated, so go by its bounding box
+        t_opencv_int_contour_list contours;
+        cv::findContours(decimatedLowerMask, contours, CV_RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE);
+
+        cv::Rect2i biggestBounds(0, 0, 0, 0);
+        for (const t_opencv_int_contour &contour : contours)
+        {
+            const cv::Rect2i bounds = cv::boundingRect(contour);
+
+            if (bounds.area() > biggestBounds.area())
+            {
+                biggestBounds = bounds;
+            }
+        }
+
+        if (biggestBounds.area() <= 0)
+        {
+            return cv::Rect2i(0, 0, 0, 0);
+        }
+
+        // Pad the blob by its own size (and the decimation lost at its edges) in the full resolution frame
+        const cv::Rect2i blobBounds(biggestBounds.tl()*decimation, biggestBounds.size()*decimation);
+        const int padding_x = std::max(blobBounds.width, k_min_roi_size / 2) + decimation;
+        const int padding_y = std::max(blobBounds.height, k_min_roi_size / 2) + decimation;
+        const cv::Rect2i window(
+            blobBounds.x - padding_x, blobBounds.y - padding_y,
+            blobBounds.width + 2*padding_x, blobBounds.height + 2*padding_y);
+
+        return window & cv::Rect2i(0, 0, frameWidth, frameHeight);
+    }
+
+    // True if the hue range of the color range wraps around hue 0 and so needs a second mask
+    static bool getHueRangeWraps(const CommonHSVColorRange &hsvColorRange)
+    {
+        const float hue_min = hsvColorRange.hue_range.center - hsvColorRange.hue_range.range;
+        const float hue_max = hsvColorRange.hue_range.center + hsvColorRange.hue_range.range;
+
+        return hue_min < 0 || hue_max > 180;
+    }
+
+    // Mask the pixels of the HSV image in the color range, taking into account wrapping the hue angle.
+    // The upper mask is scratch space only used when the hue range wraps.
+    static void computeColorRangeMask(
+        const CommonHSVColorRange &hsvColorRange,
+        const cv::Mat &hsv,
+        cv::Mat &out_mask,
+        cv::Mat &upper_mask)
+    {
+        const float hue_min = hsvColorRange.hue_range.center - hsvColorRange.hue_range.range;
+        const float hue_max = hsvColorRange.hue_range.center + hsvColorRange.hue_range.range;
+        const float saturation_min = clampf(hsvColorRange.saturation_range.center - hsvColorRange.saturation_range.range, 0, 255);
+        const float saturation_max = clampf(hsvColorRange.saturation_range.center + hsvColorRange.saturation_range.range, 0, 255);
+        const float value_min = clampf(hsvColorRange.value_range.center - hsvColorRange.value_range.range, 0, 255);
+        const float value_max = clampf(hsvColorRange.value_range.center + hsvColorRange.value_range.range, 0, 255);
+
+        if (hue_min < 0)
+        {
+            cv::inRange(
+                hsv,
+                cv::Scalar(0, saturation_min, value_min),
+                cv::Scalar(clampf(hue_max, 0, 180), saturation_max, value_max),
+                out_mask);
+            cv::inRange(
+                hsv,
+                cv::Scalar(clampf(180 + hue_min, 0, 180), saturation_min, value_min),
+                cv::Scalar(180, saturation_max, value_max),
+                upper_mask);
+            cv::bitwise_or(out_mask, upper_mask, out_mask);
+        }
+        else if (hue_max > 180)
+        {
+            cv::inRange(
+                hsv,
+                cv::Scalar(0, saturation_min, value_min),
+                cv::Scalar(clampf(hue_max - 180, 0, 180), saturation_max, value_max),
+                out_mask);
+            cv::inRange(
+                hsv,
+                cv::Scalar(clampf(hue_min, 0, 180), saturation_min, value_min),
+                cv::Scalar(180, saturation_max, value_max),
+                upper_mask);
+            cv::bitwise_or(out_mask, upper_mask, out_mask);
+        }
+        else
+        {
+            cv::inRange(
+                hsv,
+                cv::Scalar(hue_min, saturation_min, value_min),
+                cv::Scalar(hue_max, saturation_max, value_max),
+                out_mask);
+        }
+    }
+
+    // Measure how bright a blob found in the currently applied ROI is, and how bright the ROI around it is,
+    // for the exposure control. The contour is in frame space.
+    // The color range mask is made again rather than reusing the one the contour came from,
+    // since older OpenCV versions have findContours() scribble over its input.
+    void measureBlobExposure(const CommonHSVColorRange &hsvColorRange, const t_opencv_int_contour &contour)
+    {
+        const cv::Rect2i blobBounds = cv::boundingRect(contour) & currentROI;
+        if (blobBounds.area() <= 0 || hsvROI.empty())
+        {
+            return;
+        }
+
+        cv::extractChannel(hsvROI, exposureValueROI, 2);
+        computeColorRangeMask(hsvColorRange, hsvROI, exposureBulbMask, exposureUpperMask);
+
+        const int bulbPixelCount = cv::countNonZero(exposureBulbMask);
+        const int backgroundPixelCount = static_cast<int>(exposureBulbMask.total()) - bulbPixelCount;
+        if (bulbPixelCount <= 0)
+        {
+            return;
+        }
+
+        bulbValueSum += static_cast<float>(cv::mean(exposureValueROI, exposureBulbMask)[0]);
+
+        if (backgroundPixelCount > 0)
+        {
+            cv::bitwise_not(exposureBulbMask, exposureBackgroundMask);
+            backgroundValueSum += static_cast<float>(cv::mean(exposureValueROI, exposureBackgroundMask)[0]);
+        }
+
+        // A blown out bulb washes out to white and drops out of the color range mask,
+        // so look for clipped pixels across the blob's bounding box instead
+        const cv::Mat blobValue(exposureValueROI, blobBounds - currentROI.tl());
+        cv::compare(blobValue, cv::Scalar(k_exposure_clipped_value), exposureClippedMask, cv::CMP_GE);
+        bulbClippedFractionSum += static_cast<float>(cv::countNonZero(exposureClippedMask)) / blobBounds.area();
+
+        ++exposureSampleCount;
+    }
+
+    // Average of the blobs measured in this frame, see measureBlobExposure()
+    void getExposureStatistics(TrackerStatistics &out_statistics) const
+    {
+        out_statistics.exposure_sample_count = exposureSampleCount;
+
+        if (exposureSampleCount > 0)
+        {
+            out_statistics.bulb_value = bulbValueSum / exposureSampleCount;
+            out_statistics.bulb_clipped_fraction = bulbClippedFractionSum / exposureSampleCount;
+            out_statistics.background_value = backgroundValueSum / exposureSampleCount;
+        }
     }
 
     // Return points in raw image space:
@@ -479,51 +935,11 @@ public:
         out_contour_areas.clear();
         
         // Clamp the HSV image, taking into account wrapping the hue angle
+        if (getHueRangeWraps(hsvColorRange))
         {
-            const float hue_min = hsvColorRange.hue_range.center - hsvColorRange.hue_range.range;
-            const float hue_max = hsvColorRange.hue_range.center + hsvColorRange.hue_range.range;
-            const float saturation_min = clampf(hsvColorRange.saturation_range.center - hsvColorRange.saturation_range.range, 0, 255);
-            const float saturation_max = clampf(hsvColorRange.saturation_range.center + hsvColorRange.saturation_range.range, 0, 255);
-            const float value_min = clampf(hsvColorRange.value_range.center - hsvColorRange.value_range.range, 0, 255);
-            const float value_max = clampf(hsvColorRange.value_range.center + hsvColorRange.value_range.range, 0, 255);
-
-            if (hue_min < 0)
-            {
-                cv::inRange(
-                    hsvROI,
-                    cv::Scalar(0, saturation_min, value_min),
-                    cv::Scalar(clampf(hue_max, 0, 180), saturation_max, value_max),
-                    gsLowerROI);
-                cv::inRange(
-                    hsvROI,
-                    cv::Scalar(clampf(180 + hue_min, 0, 180), saturation_min, value_min),
-                    cv::Scalar(180, saturation_max, value_max),
-                    gsUpperROI);
-                cv::bitwise_or(gsLowerROI, gsUpperROI, gsLowerROI);
-            }
-            else if (hue_max > 180)
-            {
-                cv::inRange(
-                    hsvROI,
-                    cv::Scalar(0, saturation_min, value_min),
-                    cv::Scalar(clampf(hue_max - 180, 0, 180), saturation_max, value_max),
-                    gsLowerROI);
-                cv::inRange(
-                    hsvROI,
-                    cv::Scalar(clampf(hue_min, 0, 180), saturation_min, value_min),
-                    cv::Scalar(180, saturation_max, value_max),
-                    gsUpperROI);
-                cv::bitwise_or(gsLowerROI, gsUpperROI, gsLowerROI);
-            }
-            else
-            {
-                cv::inRange(
-                    hsvROI,
-                    cv::Scalar(hue_min, saturation_min, value_min),
-                    cv::Scalar(hue_max, saturation_max, value_max),
-                    gsLowerROI);
-            }
+            ensureUpperMaskBuffer();
         }
+        computeColorRangeMask(hsvColorRange, hsvROI, gsLowerROI, gsUpperROI);
         
         //TODO: Why no blurring of the gsLowerBuffer?
 
@@ -536,15 +952,13 @@ public:
             };
             std::vector<ContourInfo> sorted_contour_list;
 
-            // Find all counters in the image buffer
-            cv::Size size; cv::Point ofs;
-            gsLowerROI.locateROI(size, ofs);
+            // Find all counters in the image buffer (offset back into frame space)
             t_opencv_int_contour_list contours;
             cv::findContours(gsLowerROI,
                              contours,
                              CV_RETR_EXTERNAL,
                              CV_CHAIN_APPROX_SIMPLE,  //CV_CHAIN_APPROX_NONE?
-                             ofs);
+                             currentROI.tl());
 
             // Compute the area of each contour
             int contour_index = 0;
@@ -609,11 +1023,16 @@ public:
     {
         // Draws the contour directly onto the shared mem buffer.
         // This is useful for debugging
+        if (!hasDebugOverlay())
+        {
+            return;
+        }
+
         std::vector<t_opencv_int_contour> contours = {contour};
         const cv::Point2f massCenter = computeSafeCenterOfMassForContour<t_opencv_int_contour>(contour);
-        cv::drawContours(*bgrShmemBuffer, contours, 0, cv::Scalar(255, 255, 255));
-        cv::rectangle(*bgrShmemBuffer, cv::boundingRect(contour), cv::Scalar(255, 255, 255));
-        cv::drawMarker(*bgrShmemBuffer, massCenter, cv::Scalar(255, 255, 255), 0,
+        cv::drawContours(bgrShmemBuffer, contours, 0, cv::Scalar(255, 255, 255));
+        cv::rectangle(bgrShmemBuffer, cv::boundingRect(contour), cv::Scalar(255, 255, 255));
+        cv::drawMarker(bgrShmemBuffer, massCenter, cv::Scalar(255, 255, 255), 0,
             (cv::boundingRect(contour).height < cv::boundingRect(contour).width) ?
             cv::boundingRect(contour).height : cv::boundingRect(contour).width);
     }
@@ -622,6 +1041,11 @@ public:
     draw_pose_projection(const CommonDeviceTrackingProjection &pose_projection)
     {
         // Draw the projection of the pose onto the shared mem buffer.
+        if (!hasDebugOverlay())
+        {
+            return;
+        }
+
         switch (pose_projection.shape_type)
         {
         case eCommonTrackingProjectionType::ProjectionType_Ellipse:
@@ -638,12 +1062,12 @@ public:
                     static_cast<int>(pose_projection.shape.ellipse.half_y_extent));
 
                 //Draw ellipse on bgrShmemBuffer
-                cv::ellipse(*bgrShmemBuffer,
+                cv::ellipse(bgrShmemBuffer,
                     ell_center,
                     ell_size,
                     pose_projection.shape.ellipse.angle,
                     0, 360, cv::Scalar(0, 0, 255));
-                cv::drawMarker(*bgrShmemBuffer, ell_center, cv::Scalar(0, 0, 255), 0,
+                cv::drawMarker(bgrShmemBuffer, ell_center, cv::Scalar(0, 0, 255), 0,
                     (ell_size.height < ell_size.width) ? ell_size.height * 2 : ell_size.width * 2);
             } break;
         case eCommonTrackingProjectionType::ProjectionType_LightBar:
@@ -659,7 +1083,7 @@ public:
                     cv::Point pt2(
                         static_cast<int>(pose_projection.shape.lightbar.quad[point_index].x),
                         static_cast<int>(pose_projection.shape.lightbar.quad[point_index].y));
-                    cv::line(*bgrShmemBuffer, pt1, pt2, cv::Scalar(0, 0, 255));
+                    cv::line(bgrShmemBuffer, pt1, pt2, cv::Scalar(0, 0, 255));
 
                     prev_point_index = point_index;
                 }
@@ -673,7 +1097,7 @@ public:
                     cv::Point pt2(
                         static_cast<int>(pose_projection.shape.lightbar.triangle[point_index].x),
                         static_cast<int>(pose_projection.shape.lightbar.triangle[point_index].y));
-                    cv::line(*bgrShmemBuffer, pt1, pt2, cv::Scalar(0, 0, 255));
+                    cv::line(bgrShmemBuffer, pt1, pt2, cv::Scalar(0, 0, 255));
 
                     prev_point_index = point_index;
                 }
@@ -686,7 +1110,7 @@ public:
                     cv::Point pt(
                         static_cast<int>(pose_projection.shape.points.point[point_index].x),
                         static_cast<int>(pose_projection.shape.points.point[point_index].y));
-                    cv::drawMarker(*bgrShmemBuffer, pt, cv::Scalar(0, 0, 255));
+                    cv::drawMarker(bgrShmemBuffer, pt, cv::Scalar(0, 0, 255));
                 }
             } break;
         default:
@@ -698,18 +1122,78 @@ public:
     int frameWidth;
     int frameHeight;
 
-    cv::Mat *bgrBuffer; // source video frame
-    cv::Mat *bgrShmemBuffer; //Frame onto which we draw debug lines, and transmit via shared mem.
+    VideoFrameRef videoFrame; // pooled video frame from the tracker, shared without copying
+    cv::Mat bgrBuffer; // source video frame, only ever read
+    cv::Mat bgrShmemBuffer; // copy of the frame onto which we draw debug lines, see beginDebugOverlay()
     cv::Mat bgrROI;
-    cv::Mat *hsvBuffer; // source frame converted to HSV color space
+    cv::Mat hsvStorage; // backing store of hsvBuffer, at least as big as the working window
+    cv::Mat gsLowerStorage;
+    cv::Mat gsUpperStorage; // empty until a hue range wraps around 0
+    cv::Rect2i workingWindow; // region of the frame the HSV and mask buffers currently cover
+    int workingWindowFrameSequenceNumber; // frame the working window was last placed in
+    int undersizedFrameCount; // consecutive frames the working window used under half of the storage
+    cv::Mat hsvBuffer; // working window of the frame converted to HSV color space
     cv::Mat hsvROI;
-    cv::Mat *gsLowerBuffer; // HSV image clamped by HSV range into grayscale mask
+    cv::Mat gsLowerBuffer; // HSV image clamped by HSV range into grayscale mask (working window)
     cv::Mat gsLowerROI;
-    cv::Mat *gsUpperBuffer; // HSV image clamped by HSV range into grayscale mask
+    cv::Mat gsUpperBuffer; // HSV image clamped by HSV range into grayscale mask (working window)
     cv::Mat gsUpperROI;
-    cv::Mat *maskedBuffer; // bgr image ANDed together with grayscale mask
+    cv::Rect2i currentROI; // ROI the ROI matrices point at, in frame space
     OpenCVBGRToHSVMapper *bgr2hsv; // Used to convert an rgb image to an hsv image
+
+    // HSV conversion cache
+    int hsvTileColumns;
+    int hsvTileRows;
+    std::vector<int> hsvTileFrameSequenceNumbers; // sequence number of the frame each tile was last converted in
+    int frameSequenceNumber; // sequence number of the frame in bgrBuffer
+    std::vector<cv::Rect2i> frameROIs; // ROIs searched in the frame so far
+    int hsvPixelsRequested; // pixels covered by the ROIs this frame, overlaps counted once per ROI
+    int hsvPixelsConverted; // pixels actually converted to HSV this frame
+
+    // Decimated copy of the frame for full frame recovery scans, see locateColorRangeInDecimatedFrame()
+    cv::Mat decimatedBgrBuffer;
+    cv::Mat decimatedHsvBuffer;
+    cv::Mat decimatedLowerMask;
+    cv::Mat decimatedUpperMask;
+    int decimatedFrameSequenceNumber; // frame the decimated HSV buffer was made from
+
+    // Exposure of the blobs found this frame, see measureBlobExposure()
+    cv::Mat exposureValueROI; // value channel of the ROI
+    cv::Mat exposureBulbMask;
+    cv::Mat exposureUpperMask;
+    cv::Mat exposureBackgroundMask;
+    cv::Mat exposureClippedMask;
+    int exposureSampleCount;
+    float bulbValueSum;
+    float bulbClippedFractionSum;
+    float backgroundValueSum;
+
+    int debugOverlayFrameSequenceNumber; // frame copied into bgrShmemBuffer for this search, -1 if none
+
+    // Off when another thread may be reading the frame's pixels while we search it
+    bool bDrawDebugOverlay;
+};
+
+// A region of the video frame to search for a device in.
+// Each device gets a list of these in priority order and is searched for in them until it's found.
+struct TrackerSearchWindow
+{
+    cv::Rect2i ROI;
+    int scan_decimation; // > 1: a full frame recovery scan, see OpenCVBufferState::locateColorRangeInDecimatedFrame()
+    bool bRecoveryHypothesis; // where a lost device is expected to reappear, counts against the recovery pixel budget
+
+    static TrackerSearchWindow create(const cv::Rect2i &ROI, int scan_decimation = 1, bool bRecoveryHypothesis = false)
+    {
+        TrackerSearchWindow window;
+
+        window.ROI = ROI;
+        window.scan_decimation = scan_decimation;
+        window.bRecoveryHypothesis = bRecoveryHypothesis;
+
+        return window;
+    }
 };
+typedef std::vector<TrackerSearchWindow> t_tracker_search_window_list;
 
 // -- Utility Methods -----
 static glm::quat computeGLMCameraTransformQuaternion(const ITrackerInterface *tracker_device);
@@ -720,16 +1204,51 @@ cv::Mat cvDistCoeffs = cv::Mat(4, 1, cv::DataType<float>::type, 0.f);
 static void computeOpenCVCameraIntrinsicMatrix(const ITrackerInterface *tracker_device,
                                                cv::Matx33f &intrinsicOut,
                                                cv::Matx<float, 5, 1> &distortionOut);
+static void computeOpenCVCameraIntrinsicMatrix(const TrackerPipelineCameraParams &camera_params,
+                                               cv::Matx33f &intrinsicOut,
+                                               cv::Matx<float, 5, 1> &distortionOut);
 static cv::Matx34f computeOpenCVCameraPinholeMatrix(const ITrackerInterface *tracker_device);
+static bool computeProjectionForColorRangeInBuffer(
+    OpenCVBufferState *buffer_state,
+    const TrackerPipelineCameraParams &camera_params,
+    const CommonHSVColorRange &hsvColorRange,
+    const CommonDeviceTrackingShape *tracking_shape,
+    bool bRoiDisabled,
+    ControllerOpticalPoseEstimation *out_pose_estimate);
+static void computeProjectionsForTargetsInBuffer(
+    OpenCVBufferState *buffer_state,
+    const TrackerPipelineCameraParams &camera_params,
+    const std::vector<RemoteTrackerTarget> &targets,
+    ServiceStatistic *roi_search_statistic,
+    ServiceStatistic *roi_hit_statistic,
+    std::vector<RemoteTrackerProjection> &out_projections,
+    TrackerStatistics &out_statistics);
+template <typename t_pose_estimate>
+static void applyPipelinedProjectionToPoseEstimate(
+    const RemoteTrackerProjection &projection,
+    t_pose_estimate &pose_estimate);
 static bool computeTrackerRelativeLightBarProjection(
     const CommonDeviceTrackingShape *tracking_shape,
     const t_opencv_float_contour &opencv_contour,
+    const CommonDeviceTrackingProjection *prior_projection,
     CommonDeviceTrackingProjection *out_projection);
 static bool computeTrackerRelativeLightBarPose(
     const ITrackerInterface *tracker_device,
     const CommonDeviceTrackingShape *tracking_shape,
     const CommonDeviceTrackingProjection *projection,
     const CommonDevicePose *tracker_relative_pose_guess,
+    bool bUseFastPath,
+    ControllerOpticalPoseEstimation *out_pose_estimate,
+    bool *out_used_fast_path);
+static bool computeTrackerRelativeLightBarPoseFromGuess(
+    const cv::Matx33f &camera_matrix,
+    const CommonDeviceTrackingShape *tracking_shape,
+    const CommonDeviceTrackingProjection *projection,
+    const CommonDevicePose *tracker_relative_pose_guess,
+    ControllerOpticalPoseEstimation *out_pose_estimate);
+static void applyTrackerRelativeLightBarPose(
+    float axis_x, float axis_y, float axis_z, float axis_theta,
+    float position_x, float position_y, float position_z,
     ControllerOpticalPoseEstimation *out_pose_estimate);
 static bool computeTrackerRelativePointCloudContourPose(
     const ITrackerInterface *tracker_device,
@@ -743,19 +1262,56 @@ static cv::Rect2i computeTrackerROIForPoseProjection(
     const IPoseFilter* pose_filter,
     const CommonDeviceTrackingProjection *prior_tracking_projection,
     const CommonDeviceTrackingShape *tracking_shape);
+static float computeTrackingShapeBoundingRadiusCm(const CommonDeviceTrackingShape *tracking_shape);
+static CommonDeviceScreenLocation computeTrackingProjectionPixelCenter(
+    const CommonDeviceTrackingProjection *tracking_projection);
+static void computeTrackerSearchWindowsForDevices(
+    const ServerTrackerView *tracker,
+    const std::vector<ServerControllerView *> &tracked_controllers,
+    const std::vector<ServerHMDView *> &tracked_hmds,
+    const int frame_sequence_num,
+    ServiceStatistic *recovery_window_statistic,
+    ServiceStatistic *recovery_full_scan_statistic,
+    std::vector<CommonDeviceTrackingShape> &out_tracking_shapes,
+    std::vector<t_tracker_search_window_list> &out_device_windows);
+template <typename t_pose_estimate>
+static void computeTrackerSearchWindowsForDevice(
+    const ServerTrackerView *tracker,
+    const bool device_roi_disabled,
+    const IPoseFilter* pose_filter,
+    const t_pose_estimate *multicam_pose_estimate,
+    const t_pose_estimate *tracker_pose_estimate,
+    const CommonDeviceTrackingShape *tracking_shape,
+    const bool bFullScanFrame,
+    t_tracker_search_window_list &out_windows);
+static void computeTrackerRecoveryWindows(
+    const ServerTrackerView *tracker,
+    const IPoseFilter* pose_filter,
+    const std::chrono::time_point<std::chrono::high_resolution_clock> &last_visible_timestamp,
+    const std::chrono::time_point<std::chrono::high_resolution_clock> &tracker_last_visible_timestamp,
+    const CommonDeviceTrackingProjection *tracker_last_projection,
+    const CommonDeviceTrackingShape *tracking_shape,
+    const bool bFullScanFrame,
+    t_tracker_search_window_list &out_windows);
+static void applyTrackerRecoveryPixelBudget(
+    const int pixel_budget,
+    std::vector<t_tracker_search_window_list> &device_windows);
 static bool computeBestFitTriangleForContour(
     const t_opencv_float_contour &opencv_contour,
     cv::Point2f &out_triangle_top,
     cv::Point2f &out_triangle_bottom_left,
     cv::Point2f &out_triangle_bottom_right);
-static bool computeBestFitQuadForContour(
+static bool computeBestFitLightBarForContourFromPrior(
     const t_opencv_float_contour &opencv_contour,
-    const cv::Point2f &up_hint, 
-    const cv::Point2f &right_hint,
-    cv::Point2f &top_right,
-    cv::Point2f &top_left,
-    cv::Point2f &bottom_left,
-    cv::Point2f &bottom_right);
+    const CommonDeviceTrackingShape *tracking_shape,
+    const CommonDeviceTrackingProjection *prior_projection,
+    cv::Point2f &out_triangle_top,
+    cv::Point2f &out_triangle_bottom_left,
+    cv::Point2f &out_triangle_bottom_right,
+    cv::Point2f &out_quad_top_right,
+    cv::Point2f &out_quad_top_left,
+    cv::Point2f &out_quad_bottom_left,
+    cv::Point2f &out_quad_bottom_right);
 static void commonDeviceOrientationToOpenCVRodrigues(
     const CommonDeviceQuaternion &orientation,
     cv::Mat &rvec);
@@ -774,10 +1330,30 @@ ServerTrackerView::ServerTrackerView(const int device_id)
     : ServerDeviceView(device_id)
     , m_shared_memory_accesor(nullptr)
     , m_shared_memory_video_stream_count(0)
+    , m_video_encoder(nullptr)
+    , m_network_video_sequence_number(-1)
     , m_opencv_buffer_state(nullptr)
+    , m_optical_pipeline(nullptr)
+    , m_optical_pipeline_sequence_number(-1)
+    , m_exposure_controller(nullptr)
+    , m_exposure_sequence_number(-1)
     , m_device(nullptr)
+    , m_frame_statistic(nullptr)
+    , m_dropped_frame_statistic(nullptr)
+    , m_roi_search_statistic(nullptr)
+    , m_roi_hit_statistic(nullptr)
+    , m_remote_frame_age_statistic(nullptr)
+    , m_network_video_bytes_statistic(nullptr)
+    , m_lightbar_fast_pose_statistic(nullptr)
+    , m_lightbar_full_pose_statistic(nullptr)
+    , m_recovery_window_statistic(nullptr)
+    , m_recovery_full_scan_statistic(nullptr)
+    , m_reacquisition_statistic(nullptr)
+    , m_exposure_adjustment_statistic(nullptr)
+    , m_last_device_dropped_frame_count(0)
 {
     ServerUtility::format_string(m_shared_memory_name, sizeof(m_shared_memory_name), "tracker_view_%d", device_id);
+    m_statistics.clear();
 }
 
 ServerTrackerView::~ServerTrackerView()
@@ -787,11 +1363,26 @@ ServerTrackerView::~ServerTrackerView()
         delete m_shared_memory_accesor;
     }
 
+    if (m_video_encoder != nullptr)
+    {
+        delete m_video_encoder;
+    }
+
+    if (m_optical_pipeline != nullptr)
+    {
+        delete m_optical_pipeline;
+    }
+
     if (m_opencv_buffer_state != nullptr)
     {
         delete m_opencv_buffer_state;
     }
 
+    if (m_exposure_controller != nullptr)
+    {
+        delete m_exposure_controller;
+    }
+
     if (m_device != nullptr)
     {
         delete m_device;
@@ -826,10 +1417,22 @@ bool ServerTrackerView::open(const class DeviceEnumerator *enumerator)
 {
     bool bSuccess = ServerDeviceView::open(enumerator);
 
-    if (bSuccess)
+    // Remote trackers don't receive any video, only the projections the tracker node found
+    const bool bIsRemote = bSuccess && m_device->getDriverType() == ITrackerInterface::Remote;
+
+    if (bSuccess && !bIsRemote)
     {
         int width, height, stride;
 
+        // Don't take over the shared memory of a central service running on the same host
+        TrackerNodeManager *tracker_node_manager = TrackerNodeManager::get_instance();
+        if (tracker_node_manager != nullptr && tracker_node_manager->getIsNodeMode())
+        {
+            ServerUtility::format_string(
+                m_shared_memory_name, sizeof(m_shared_memory_name),
+                "tracker_node_%s_view_%d", tracker_node_manager->getNodeName().c_str(), getDeviceID());
+        }
+
         // Make sure the shared memory block has been removed first
         boost::interprocess::shared_memory_object::remove(m_shared_memory_name);
 
@@ -849,6 +1452,30 @@ bool ServerTrackerView::open(const class DeviceEnumerator *enumerator)
 
             // Allocate the OpenCV scratch buffers used for finding tracking blobs
             m_opencv_buffer_state = new OpenCVBufferState(m_device);
+
+            // Adapt the exposure and gain to the devices found in the video frames
+            const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
+            if (trackerMgrConfig.use_auto_exposure)
+            {
+                TrackerExposureSettings exposure_settings;
+                exposure_settings.min_exposure = trackerMgrConfig.auto_exposure_min;
+                exposure_settings.max_exposure = trackerMgrConfig.auto_exposure_max;
+                exposure_settings.min_gain = trackerMgrConfig.auto_gain_min;
+                exposure_settings.max_gain = trackerMgrConfig.auto_gain_max;
+                exposure_settings.target_bulb_value = trackerMgrConfig.auto_exposure_target_bulb_value;
+                exposure_settings.bulb_value_tolerance = k_exposure_bulb_value_tolerance;
+                exposure_settings.max_bulb_clipped_fraction = trackerMgrConfig.auto_exposure_max_clipped_fraction;
+                exposure_settings.max_background_value = trackerMgrConfig.auto_exposure_max_background_value;
+                exposure_settings.max_step_fraction = k_exposure_max_step_fraction;
+                exposure_settings.min_setting_step = k_exposure_min_setting_step;
+                exposure_settings.adjust_interval_seconds = static_cast<float>(trackerMgrConfig.auto_exposure_interval_ms) / 1000.f;
+                exposure_settings.min_sample_count = k_exposure_min_sample_count;
+
+                assert(m_exposure_controller == nullptr);
+                m_exposure_controller = new TrackerExposureController();
+                m_exposure_controller->reset(exposure_settings);
+                m_exposure_sequence_number = -1;
+            }
         }
         else
         {
@@ -856,6 +1483,73 @@ bool ServerTrackerView::open(const class DeviceEnumerator *enumerator)
         }
     }
 
+    if (bSuccess)
+    {
+        // The frame rate is reported as the rate of the frame counter,
+        // the ROI hit rate as roi_hits / roi_searches
+        const std::string statistic_prefix= "tracker." + std::to_string(getDeviceID());
+        m_frame_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".frames");
+        m_dropped_frame_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".dropped_frames");
+        m_roi_search_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".roi_searches");
+        m_roi_hit_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".roi_hits");
+        m_network_video_bytes_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".network_video_bytes");
+        m_lightbar_fast_pose_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".lightbar_fast_poses");
+        m_lightbar_full_pose_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".lightbar_full_poses");
+        m_recovery_window_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".recovery_windows");
+        m_recovery_full_scan_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".recovery_full_scans");
+        m_reacquisition_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".reacquisitions");
+        m_exposure_adjustment_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".exposure_adjustments");
+        m_last_device_dropped_frame_count= m_device->getDroppedFrameCount();
+
+        if (bIsRemote)
+        {
+            m_remote_frame_age_statistic= ServiceStatistics::registerGauge(statistic_prefix + ".remote_frame_age_us");
+        }
+    }
+
+    const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
+    if (bSuccess && m_opencv_buffer_state != nullptr && trackerMgrConfig.use_optical_pipeline)
+    {
+        // Every queued job holds a video frame from the tracker's frame pool, so keep the queue short
+        const int queue_depth = std::min(std::max(trackerMgrConfig.optical_pipeline_queue_depth, 1), 2);
+
+        // The pipeline thread searches frames in its own buffers,
+        // recreated whenever the frame size or the HSV lookup table setting changes.
+        // It can't draw on frames the main thread may be reading for the point cloud HMD search.
+        std::shared_ptr<OpenCVBufferState> buffer_state;
+        ServiceStatistic *roi_search_statistic= m_roi_search_statistic;
+        ServiceStatistic *roi_hit_statistic= m_roi_hit_statistic;
+
+        m_optical_pipeline_sequence_number= -1;
+        m_optical_pipeline= new TrackerOpticalPipeline(
+            getDeviceID(), 
+            queue_depth,
+            [buffer_state, roi_search_statistic, roi_hit_statistic](
+                const TrackerPipelineJob &job, 
+                TrackerPipelineResult &out_result) mutable
+            {
+                if (!buffer_state ||
+                    buffer_state->frameWidth != job.frame_width ||
+                    buffer_state->frameHeight != job.frame_height ||
+                    (buffer_state->bgr2hsv != nullptr) != job.camera_params.bUseBGRToHSVLookupTable)
+                {
+                    buffer_state = 
+                        std::make_shared<OpenCVBufferState>(
+                            job.frame_width, job.frame_height, job.camera_params.bUseBGRToHSVLookupTable);
+                    buffer_state->bDrawDebugOverlay = false;
+                }
+
+                if (buffer_state->setVideoFrame(job.video_frame, job.frame_sequence_num))
+                {
+                    computeProjectionsForTargetsInBuffer(
+                        buffer_state.get(), job.camera_params, job.targets,
+                        roi_search_statistic, roi_hit_statistic,
+                        out_result.projections, out_result.statistics);
+                    buffer_state->releaseVideoFrame();
+                }
+            });
+    }
+
     return bSuccess;
 }
 
@@ -867,9 +1561,55 @@ void ServerTrackerView::close()
         m_shared_memory_accesor = nullptr;
     }
 
-    ServerDeviceView::close();
-}
-
+    // Stops the encoder thread, the connections' streams end with the tracker
+    if (m_video_encoder != nullptr)
+    {
+        delete m_video_encoder;
+        m_video_encoder = nullptr;
+    }
+
+    // Stops the pipeline thread, which counts ROI searches in the statistics below
+    if (m_optical_pipeline != nullptr)
+    {
+        delete m_optical_pipeline;
+        m_optical_pipeline = nullptr;
+    }
+
+    ServiceStatistics::releaseStatistic(m_frame_statistic);
+    ServiceStatistics::releaseStatistic(m_dropped_frame_statistic);
+    ServiceStatistics::releaseStatistic(m_roi_search_statistic);
+    ServiceStatistics::releaseStatistic(m_roi_hit_statistic);
+    ServiceStatistics::releaseStatistic(m_remote_frame_age_statistic);
+    ServiceStatistics::releaseStatistic(m_network_video_bytes_statistic);
+    ServiceStatistics::releaseStatistic(m_lightbar_fast_pose_statistic);
+    ServiceStatistics::releaseStatistic(m_lightbar_full_pose_statistic);
+    ServiceStatistics::releaseStatistic(m_recovery_window_statistic);
+    ServiceStatistics::releaseStatistic(m_recovery_full_scan_statistic);
+    ServiceStatistics::releaseStatistic(m_reacquisition_statistic);
+    ServiceStatistics::releaseStatistic(m_exposure_adjustment_statistic);
+    m_frame_statistic= nullptr;
+    m_dropped_frame_statistic= nullptr;
+    m_roi_search_statistic= nullptr;
+    m_roi_hit_statistic= nullptr;
+    m_remote_frame_age_statistic= nullptr;
+    m_network_video_bytes_statistic= nullptr;
+    m_lightbar_fast_pose_statistic= nullptr;
+    m_lightbar_full_pose_statistic= nullptr;
+    m_recovery_window_statistic= nullptr;
+    m_recovery_full_scan_statistic= nullptr;
+    m_reacquisition_statistic= nullptr;
+    m_exposure_adjustment_statistic= nullptr;
+
+    // The settings the exposure control left the camera at are not saved
+    if (m_exposure_controller != nullptr)
+    {
+        delete m_exposure_controller;
+        m_exposure_controller = nullptr;
+    }
+
+    ServerDeviceView::close();
+}
+
 void ServerTrackerView::startSharedMemoryVideoStream()
 {
     ++m_shared_memory_video_stream_count;
@@ -881,21 +1621,67 @@ void ServerTrackerView::stopSharedMemoryVideoStream()
     --m_shared_memory_video_stream_count;
 }
 
+void ServerTrackerView::startNetworkVideoStream(int connection_id, const TrackerVideoStreamSettings &settings)
+{
+    // Remote trackers have no video to send
+    if (m_opencv_buffer_state == nullptr)
+    {
+        SERVER_LOG_WARNING("ServerTrackerView::startNetworkVideoStream") << "Tracker " << getDeviceID() << " has no video feed";
+        return;
+    }
+
+    if (m_video_encoder == nullptr)
+    {
+        m_video_encoder = new TrackerVideoEncoder(getDeviceID());
+    }
+
+    m_video_encoder->addStream(connection_id, settings);
+}
+
+void ServerTrackerView::stopNetworkVideoStream(int connection_id)
+{
+    if (m_video_encoder != nullptr)
+    {
+        m_video_encoder->removeStream(connection_id);
+    }
+}
+
 bool ServerTrackerView::poll()
 {
     bool bSuccess = ServerDeviceView::poll();
 
     if (bSuccess && m_device != nullptr)
     {
-        const unsigned char *buffer = m_device->getVideoFrameBuffer();
+        const VideoFrameRef video_frame = m_device->getVideoFrame();
+        const bool bHasStatistics = m_frame_statistic != nullptr;
+
+        // Count the frames the tracker dropped before handing them out
+        if (bHasStatistics)
+        {
+            const int device_dropped_frame_count = m_device->getDroppedFrameCount();
 
-        if (buffer != nullptr)
+            m_dropped_frame_statistic->increment(device_dropped_frame_count - m_last_device_dropped_frame_count);
+            m_last_device_dropped_frame_count = device_dropped_frame_count;
+        }
+
+        // Only take new frames. The tracker hands out the same frame until the next one arrives.
+        if (video_frame.isValid() && 
+            m_opencv_buffer_state != nullptr && 
+            m_opencv_buffer_state->videoFrame.get() != video_frame.get())
         {
-            // Cache the raw video frame
-            if (m_opencv_buffer_state != nullptr)
+            // Hold onto the video frame until the next one arrives
+            if (m_opencv_buffer_state->setVideoFrame(video_frame, m_sequence_number))
+            {
+                if (bHasStatistics) m_frame_statistic->increment();
+            }
+            else
             {
-                m_opencv_buffer_state->writeVideoFrame(buffer);
+                SERVER_LOG_WARNING("ServerTrackerView::poll") << "Video frame size doesn't match tracker buffers. Ignoring frame.";
+                if (bHasStatistics) m_dropped_frame_statistic->increment();
             }
+
+            // Statistics are per-frame
+            m_statistics.clear();
         }
     }
 
@@ -908,7 +1694,16 @@ bool ServerTrackerView::allocate_device_interface(const class DeviceEnumerator *
     {
     case CommonDeviceState::PS3EYE:
     {
-        m_device = new PS3EyeTracker();
+        const TrackerDeviceEnumerator *tracker_enumerator = static_cast<const TrackerDeviceEnumerator *>(enumerator);
+
+        if (tracker_enumerator->get_api_type() == TrackerDeviceEnumerator::CommunicationType_REMOTE)
+        {
+            m_device = new RemoteTracker();
+        }
+        else
+        {
+            m_device = new PS3EyeTracker();
+        }
     } break;
     default:
         break;
@@ -932,9 +1727,16 @@ void ServerTrackerView::free_device_interface()
 void ServerTrackerView::publish_device_data_frame()
 {
     // Copy the video frame to shared memory (if requested)
-    if (m_shared_memory_accesor != nullptr && m_shared_memory_video_stream_count > 0)
+    if (m_shared_memory_accesor != nullptr && m_shared_memory_video_stream_count > 0 &&
+        m_opencv_buffer_state != nullptr && m_opencv_buffer_state->hasVideoFrame())
     {
-        m_shared_memory_accesor->writeVideoFrame(m_opencv_buffer_state->bgrShmemBuffer->data);
+        m_shared_memory_accesor->writeVideoFrame(m_opencv_buffer_state->getDisplayFrame().data);
+    }
+
+    // Compress the video frame for any connections watching over the network
+    if (m_video_encoder != nullptr && m_video_encoder->hasStreams())
+    {
+        publish_network_video_frames();
     }
     
     // Tell the server request handler we want to send out tracker updates.
@@ -943,6 +1745,58 @@ void ServerTrackerView::publish_device_data_frame()
         this, &ServerTrackerView::generate_tracker_data_frame_for_stream);
 }
 
+void ServerTrackerView::publish_network_video_frames()
+{
+    // Hand each new frame to the encoder once
+    if (m_opencv_buffer_state->hasVideoFrame() &&
+        m_opencv_buffer_state->frameSequenceNumber != m_network_video_sequence_number)
+    {
+        m_video_encoder->submitFrame(
+            m_opencv_buffer_state->frameSequenceNumber,
+            m_opencv_buffer_state->getDisplayFrame(),
+            m_opencv_buffer_state->gsLowerBuffer,
+            m_opencv_buffer_state->workingWindow.tl(),
+            m_opencv_buffer_state->frameROIs);
+        m_network_video_sequence_number = m_opencv_buffer_state->frameSequenceNumber;
+    }
+
+    // Send out the frames the encoder finished since the last update.
+    // The frames are too big for the UDP data frames so they go out as TCP notifications.
+    ServerNetworkManager *network_manager = ServerNetworkManager::get_instance();
+    const int tracker_id = getDeviceID();
+
+    m_video_encoder->pollEncodedFrames(
+        [this, network_manager, tracker_id](const TrackerVideoEncodedFrame &frame)
+    {
+        ResponsePtr notification = network_manager->allocate_response(frame.connection_id);
+        PSMoveProtocol::Response_ResultTrackerVideoFrame *video_frame = notification->mutable_result_tracker_video_frame();
+
+        notification->set_type(PSMoveProtocol::Response_ResponseType_TRACKER_VIDEO_FRAME);
+        notification->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
+
+        video_frame->set_tracker_id(tracker_id);
+        video_frame->set_sequence_num(frame.sequence_num);
+        video_frame->set_image_format(
+            (frame.image_format == _TrackerVideoImageFormat_PNG)
+            ? PSMoveProtocol::Response_ResultTrackerVideoFrame_ImageFormat_PNG
+            : PSMoveProtocol::Response_ResultTrackerVideoFrame_ImageFormat_JPEG);
+        video_frame->set_frame_width(frame.frame_width);
+        video_frame->set_frame_height(frame.frame_height);
+        video_frame->set_region_x(frame.region.x);
+        video_frame->set_region_y(frame.region.y);
+        video_frame->set_region_width(frame.region.width);
+        video_frame->set_region_height(frame.region.height);
+        video_frame->set_image_data(frame.image_data.data(), frame.image_data.size());
+
+        network_manager->send_notification(frame.connection_id, notification);
+
+        if (m_network_video_bytes_statistic != nullptr)
+        {
+            m_network_video_bytes_statistic->increment(static_cast<long long>(frame.image_data.size()));
+        }
+    });
+}
+
 void ServerTrackerView::generate_tracker_data_frame_for_stream(
     const ServerTrackerView *tracker_view,
     const struct TrackerStreamInfo *stream_info,
@@ -955,6 +1809,26 @@ void ServerTrackerView::generate_tracker_data_frame_for_stream(
     tracker_data_frame->set_sequence_num(tracker_view->m_sequence_number);
     tracker_data_frame->set_isconnected(tracker_view->getIsOpen());
 
+    {
+        const TrackerStatistics &statistics = tracker_view->getStatistics();
+        PSMoveProtocol::DeviceOutputDataFrame_TrackerDataPacket_TrackerStatistics *statistics_packet =
+            tracker_data_frame->mutable_statistics();
+
+        statistics_packet->set_hsv_pixels_requested(statistics.hsv_pixels_requested);
+        statistics_packet->set_hsv_pixels_converted(statistics.hsv_pixels_converted);
+        statistics_packet->set_working_buffer_bytes(static_cast<int64_t>(statistics.working_buffer_bytes));
+        statistics_packet->set_shared_hsv_lut_bytes(static_cast<int64_t>(statistics.shared_hsv_lut_bytes));
+        statistics_packet->set_exposure_sample_count(statistics.exposure_sample_count);
+        statistics_packet->set_bulb_value(statistics.bulb_value);
+        statistics_packet->set_bulb_clipped_fraction(statistics.bulb_clipped_fraction);
+        statistics_packet->set_background_value(statistics.background_value);
+        statistics_packet->set_exposure_decision(
+            static_cast<PSMoveProtocol::DeviceOutputDataFrame_TrackerDataPacket_TrackerStatistics_ExposureDecision>(
+                statistics.exposure_decision));
+        statistics_packet->set_exposure(statistics.exposure);
+        statistics_packet->set_gain(statistics.gain);
+    }
+
     switch (tracker_view->getTrackerDeviceType())
     {
     case CommonDeviceState::PS3EYE:
@@ -987,6 +1861,13 @@ void ServerTrackerView::setFrameWidth(double value, bool bUpdateConfig)
 {
     if (value == m_device->getFrameWidth()) return;
 
+    // Remote cameras are configured on their tracker node
+    if (m_device->getDriverType() == ITrackerInterface::Remote)
+    {
+        m_device->setFrameWidth(value, bUpdateConfig);
+        return;
+    }
+
     // close buffer
     if (m_shared_memory_accesor != nullptr)
     {
@@ -1035,6 +1916,13 @@ void ServerTrackerView::setFrameHeight(double value, bool bUpdateConfig)
 {
     if (value == m_device->getFrameHeight()) return;
 
+    // Remote cameras are configured on their tracker node
+    if (m_device->getDriverType() == ITrackerInterface::Remote)
+    {
+        m_device->setFrameHeight(value, bUpdateConfig);
+        return;
+    }
+
     // close buffer
     if (m_shared_memory_accesor != nullptr)
     {
@@ -1234,229 +2122,799 @@ void ServerTrackerView::getHMDTrackingColorPreset(
     return m_device->getTrackingColorPreset(hmd_id, color, out_preset);
 }
 
-bool
-ServerTrackerView::computeProjectionForController(
-    const ServerControllerView* tracked_controller,
-    const CommonDeviceTrackingShape *tracking_shape,
-    ControllerOpticalPoseEstimation *out_pose_estimate)
+void
+ServerTrackerView::computeProjectionsForTrackedDevices(
+    const std::vector<ServerControllerView *> &tracked_controllers,
+    const std::vector<ServerHMDView *> &tracked_hmds)
 {
-    bool bSuccess = true;
-
-    // Get the HSV filter used to find the tracking blob
-    CommonHSVColorRange hsvColorRange;
-    if (bSuccess)
+    // The tracker node already searched the video frame
+    if (m_device->getDriverType() == ITrackerInterface::Remote)
     {
-        eCommonTrackingColorID tracked_color_id = tracked_controller->getTrackingColorID();
-
-        if (tracked_color_id != eCommonTrackingColorID::INVALID_COLOR)
-        {
-            getControllerTrackingColorPreset(tracked_controller, tracked_color_id, &hsvColorRange);
-        }
-        else
-        {
-            bSuccess = false;
-        }
+        computeRemoteProjectionsForTrackedDevices(tracked_controllers, tracked_hmds);
+    }
+    else if (m_optical_pipeline != nullptr)
+    {
+        computePipelinedProjectionsForTrackedDevices(tracked_controllers, tracked_hmds);
+    }
+    else
+    {
+        computeLocalProjectionsForTrackedDevices(tracked_controllers, tracked_hmds);
     }
 
-    // Compute a region of interest in the tracker buffer around where we expect to find the tracking shape
-    const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
-    const bool bRoiDisabled = tracked_controller->getIsROIDisabled() || trackerMgrConfig.disable_roi;
+    if (m_device->getDriverType() != ITrackerInterface::Remote)
+    {
+        updateExposureControl();
+    }
+}
 
-    const ControllerOpticalPoseEstimation *priorPoseEst= 
-        tracked_controller->getTrackerPoseEstimate(this->getDeviceID());
-    const bool bIsTracking = priorPoseEst->bCurrentlyTracking;
+void
+ServerTrackerView::computeLocalProjectionsForTrackedDevices(
+    const std::vector<ServerControllerView *> &tracked_controllers,
+    const std::vector<ServerHMDView *> &tracked_hmds)
+{
+    // Nothing to search until the first video frame arrives
+    if (m_opencv_buffer_state == nullptr || !m_opencv_buffer_state->hasVideoFrame())
+    {
+        return;
+    }
 
-    cv::Rect2i ROI= computeTrackerROIForPoseProjection(
-        bRoiDisabled,
-        this,		
-        bIsTracking ? tracked_controller->getPoseFilter() : nullptr,
-        bIsTracking ? &priorPoseEst->projection : nullptr,
-        tracking_shape);
+    const int tracker_id = getDeviceID();
+    const size_t device_count = tracked_controllers.size() + tracked_hmds.size();
 
-    m_opencv_buffer_state->applyROI(ROI);
+    // Where to look for every tracked device in this frame, best first
+    std::vector<CommonDeviceTrackingShape> tracking_shapes;
+    std::vector<t_tracker_search_window_list> device_windows;
+    computeTrackerSearchWindowsForDevices(
+        this, tracked_controllers, tracked_hmds, m_opencv_buffer_state->frameSequenceNumber,
+        m_recovery_window_statistic, m_recovery_full_scan_statistic,
+        tracking_shapes, device_windows);
 
-    // Find the contour associated with the controller
-    t_opencv_int_contour_list biggest_contours;
-    std::vector<double> contour_areas;
-    if (bSuccess)
-    {
-        bSuccess = m_opencv_buffer_state->computeBiggestNContours(hsvColorRange, biggest_contours, contour_areas, 1);
-    }
-    
-    // Process the contour for its 2D and 3D pose.
-    if (bSuccess)
+    // Narrow the full frame recovery scans down to the blob found in a decimated copy of the frame
+    std::vector<cv::Rect2i> ROIs;
+    for (size_t device_index = 0; device_index < device_count; ++device_index)
     {
-        // Get camera parameters.
-        // Needed for undistortion.
-        cv::Matx33f camera_matrix;
-        cv::Matx<float, 5, 1> distortions;
-        computeOpenCVCameraIntrinsicMatrix(m_device, camera_matrix, distortions);
-                
-        // Compute the tracker relative 3d position of the controller from the contour
-        switch (tracking_shape->shape_type)
+        for (TrackerSearchWindow &window : device_windows[device_index])
         {
-        // For the sphere projection we can go ahead and compute the full pose estimation now
-        case eCommonTrackingShapeType::Sphere:
+            if (window.scan_decimation > 1)
             {
-                // Compute the convex hull of the contour
-                t_opencv_int_contour convex_contour;
-                cv::convexHull(biggest_contours[0], convex_contour);
-                m_opencv_buffer_state->draw_contour(convex_contour);
-
-                // Convert integer to float
-                t_opencv_float_contour convex_contour_f;
-                cv::Mat(convex_contour).convertTo(convex_contour_f, cv::Mat(convex_contour_f).type());
-
-                // Undistort points
-                t_opencv_float_contour undistort_contour;  //destination for undistorted contour
-                cv::undistortPoints(convex_contour_f, undistort_contour,
-                                    camera_matrix,
-                                    distortions);//,
-                                    //cv::noArray(),
-                                    //camera_matrix);
-                // Note: if we omit the last two arguments, then
-                // undistort_contour points are in 'normalized' space.
-                // i.e., they are relative to their F_PX,F_PY
-                
-                // Compute the sphere center AND the projected ellipse
-                Eigen::Vector3f sphere_center;
-                EigenFitEllipse ellipse_projection;
+                CommonHSVColorRange hsvColorRange;
+                bool bHasColorRange = false;
 
-                std::vector<Eigen::Vector2f> eigen_contour;
-                std::for_each(undistort_contour.begin(),
-                              undistort_contour.end(),
-                              [&eigen_contour](cv::Point2f& p) {
-                                  eigen_contour.push_back(Eigen::Vector2f(p.x, p.y));
-                              });
-                eigen_alignment_fit_focal_cone_to_sphere(eigen_contour.data(),
-                                                         static_cast<int>(eigen_contour.size()),
-                                                         tracking_shape->shape.sphere.radius_cm,
-                                                         1, //I was expecting this to be -1. Is it +1 because we're using -F_PY?
-                                                         &sphere_center,
-                                                         &ellipse_projection);
-                
-                if (ellipse_projection.area > k_real_epsilon)
+                if (device_index < tracked_controllers.size())
                 {
-                    //Save the optically-estimate 3D pose.
-                    out_pose_estimate->position_cm.set(sphere_center.x(), sphere_center.y(), sphere_center.z());
-                    out_pose_estimate->bCurrentlyTracking = true;
-                    // Not possible to get an orientation off of a sphere
-                    out_pose_estimate->orientation.clear();
-                    out_pose_estimate->bOrientationValid = false;
+                    const ServerControllerView *controller_view = tracked_controllers[device_index];
 
-                    // Save off the projection of the sphere (an ellipse)
-                    out_pose_estimate->projection.shape.ellipse.angle = ellipse_projection.angle;
-                    out_pose_estimate->projection.screen_area= ellipse_projection.area;
-                    //The ellipse projection is still in normalized space.
-                    //i.e., it is a 2-dimensional ellipse floating somewhere.
-                    //We must reproject it onto the camera.
-                    //TODO: Use opencv's project points instead of manual way below
-                    //because it will account for distortion, at least for the center point.
-                    out_pose_estimate->projection.shape_type = eCommonTrackingProjectionType::ProjectionType_Ellipse;
-                    out_pose_estimate->projection.shape.ellipse.center.set(
-                        ellipse_projection.center.x()*camera_matrix.val[0] + camera_matrix.val[2],
-                        ellipse_projection.center.y()*camera_matrix.val[4] + camera_matrix.val[5]);
-                    out_pose_estimate->projection.shape.ellipse.half_x_extent = ellipse_projection.extents.x()*camera_matrix.val[0];
-                    out_pose_estimate->projection.shape.ellipse.half_y_extent = ellipse_projection.extents.y()*camera_matrix.val[0];
-                    out_pose_estimate->projection.screen_area=
-                        k_real_pi*out_pose_estimate->projection.shape.ellipse.half_x_extent*out_pose_estimate->projection.shape.ellipse.half_y_extent;
-                
-                    //Draw results onto m_opencv_buffer_state
-                    m_opencv_buffer_state->draw_pose_projection(out_pose_estimate->projection);
+                    bHasColorRange = controller_view->getTrackingColorID() != eCommonTrackingColorID::INVALID_COLOR;
+                    if (bHasColorRange)
+                    {
+                        getControllerTrackingColorPreset(controller_view, controller_view->getTrackingColorID(), &hsvColorRange);
+                    }
+                }
+                else
+                {
+                    const ServerHMDView *hmd_view = tracked_hmds[device_index - tracked_controllers.size()];
 
-                    bSuccess = true;
+                    bHasColorRange = hmd_view->getTrackingColorID() != eCommonTrackingColorID::INVALID_COLOR;
+                    if (bHasColorRange)
+                    {
+                        getHMDTrackingColorPreset(hmd_view, hmd_view->getTrackingColorID(), &hsvColorRange);
+                    }
                 }
-            } break;
-        // For the LightBar projection we only want to compute the projection shape.
-        // The pose estimation is deferred until we know if we can leverage triangulation or not.
-        case eCommonTrackingShapeType::LightBar:
+
+                window.ROI = 
+                    bHasColorRange
+                    ? m_opencv_buffer_state->locateColorRangeInDecimatedFrame(hsvColorRange, window.scan_decimation)
+                    : cv::Rect2i(0, 0, 0, 0);
+            }
+
+            // An empty window is a full frame scan that came up empty
+            if (window.ROI.area() > 0)
             {
-                // Draw the raw source contour
-                m_opencv_buffer_state->draw_contour(biggest_contours[0]);
+                window.ROI = m_opencv_buffer_state->clampROI(window.ROI);
+                ROIs.push_back(window.ROI);
+            }
+        }
+    }
 
-                // Convert integer contour to float
-                t_opencv_float_contour biggest_contour_f;
-                cv::Mat(biggest_contours[0]).convertTo(biggest_contour_f, cv::Mat(biggest_contour_f).type());
+    // Convert all of the ROIs to HSV, converting each pixel at most once
+    m_opencv_buffer_state->updateHsvBufferForROIs(ROIs);
 
-                // Compute an undistorted version of the contour
-                t_opencv_float_contour undistort_contour;
-                cv::undistortPoints(biggest_contour_f, undistort_contour,
-                                    camera_matrix,
-                                    distortions,
-                                    cv::noArray(),
-                                    camera_matrix);
+    // Debug lines for this search go on a copy of the frame, for the clients watching the video
+    m_opencv_buffer_state->beginDebugOverlay(
+        m_shared_memory_video_stream_count > 0 ||
+        (m_video_encoder != nullptr && m_video_encoder->hasStreams()));
 
-                // Compute the lightbar tracking projection from the undistored contour
-                bSuccess=
-                    computeTrackerRelativeLightBarProjection(
-                        tracking_shape,
-                        undistort_contour,
-                        &out_pose_estimate->projection);
+    m_statistics.hsv_pixels_requested = m_opencv_buffer_state->hsvPixelsRequested;
+    m_statistics.hsv_pixels_converted = m_opencv_buffer_state->hsvPixelsConverted;
+    m_statistics.working_buffer_bytes = m_opencv_buffer_state->getWorkingBufferBytes();
+    m_statistics.shared_hsv_lut_bytes = OpenCVBGRToHSVMapper::getAllocatedBytes();
 
-                //Draw results onto m_opencv_buffer_state
-                m_opencv_buffer_state->draw_pose_projection(out_pose_estimate->projection);
-            } break;
-        default:
-            assert(0 && "Unreachable");
-            break;
+    // Searches in an ROI smaller than the frame count towards the ROI hit rate
+    const int frame_area = m_opencv_buffer_state->frameWidth * m_opencv_buffer_state->frameHeight;
+    auto record_roi_search = [this, frame_area](const cv::Rect2i &ROI, bool bFound)
+    {
+        if (m_roi_search_statistic != nullptr && ROI.area() < frame_area)
+        {
+            m_roi_search_statistic->increment();
+            if (bFound)
+            {
+                m_roi_hit_statistic->increment();
+            }
+        }
+    };
+
+    // Find each device's projection in its search windows, in order, and hand the first one found to the device
+    for (size_t controller_index = 0; controller_index < tracked_controllers.size(); ++controller_index)
+    {
+        ServerControllerView *controller_view = tracked_controllers[controller_index];
+
+        for (const TrackerSearchWindow &window : device_windows[controller_index])
+        {
+            if (window.ROI.area() <= 0)
+            {
+                continue;
+            }
+
+            // Work on a copy of the pose estimate so that in event of a failure 
+            // part way through computing the projection we don't set partially valid state
+            ControllerOpticalPoseEstimation newTrackerPoseEstimate= 
+                *controller_view->getTrackerPoseEstimate(tracker_id);
+            const bool bWasTracking = newTrackerPoseEstimate.bCurrentlyTracking;
+
+            m_opencv_buffer_state->applyROI(window.ROI);
+
+            const bool bFound = 
+                computeProjectionForController(
+                    controller_view, 
+                    &tracking_shapes[controller_index], 
+                    &newTrackerPoseEstimate);
+
+            record_roi_search(window.ROI, bFound);
+
+            if (bFound)
+            {
+                controller_view->setTrackerProjection(tracker_id, newTrackerPoseEstimate);
+                recordReacquisition(bWasTracking);
+                break;
+            }
         }
     }
 
-    // Throw out the result if the contour we found was too small and 
-    // we were using an ROI less that the size of the full screen
-    if (bSuccess && !bRoiDisabled)
+    for (size_t hmd_index = 0; hmd_index < tracked_hmds.size(); ++hmd_index)
     {
-        float screenWidth, screenHeight;
-        getPixelDimensions(screenWidth, screenHeight);
+        const size_t device_index = tracked_controllers.size() + hmd_index;
+        ServerHMDView *hmd_view = tracked_hmds[hmd_index];
 
-        if (ROI.width < screenWidth || ROI.height < screenHeight)
+        for (const TrackerSearchWindow &window : device_windows[device_index])
         {
-            bSuccess= out_pose_estimate->projection.screen_area >= trackerMgrConfig.min_valid_projection_area;
+            if (window.ROI.area() <= 0)
+            {
+                continue;
+            }
+
+            HMDOpticalPoseEstimation newTrackerPoseEstimate= 
+                *hmd_view->getTrackerPoseEstimate(tracker_id);
+            const bool bWasTracking = newTrackerPoseEstimate.bCurrentlyTracking;
+
+            m_opencv_buffer_state->applyROI(window.ROI);
+
+            const bool bFound = 
+                computeProjectionForHMD(
+                    hmd_view, 
+                    &tracking_shapes[device_index], 
+                    &newTrackerPoseEstimate);
+
+            record_roi_search(window.ROI, bFound);
+
+            if (bFound)
+            {
+                hmd_view->setTrackerProjection(tracker_id, newTrackerPoseEstimate);
+                recordReacquisition(bWasTracking);
+                break;
+            }
         }
     }
 
-    return bSuccess;
+    m_opencv_buffer_state->getExposureStatistics(m_statistics);
+    addExposureSample(m_opencv_buffer_state->frameSequenceNumber);
 }
 
-bool ServerTrackerView::computeProjectionForHMD(
-    const class ServerHMDView* tracked_hmd,
-    const struct CommonDeviceTrackingShape *tracking_shape,
-    struct HMDOpticalPoseEstimation *out_pose_estimate)
+void
+ServerTrackerView::computePipelinedProjectionsForTrackedDevices(
+    const std::vector<ServerControllerView *> &tracked_controllers,
+    const std::vector<ServerHMDView *> &tracked_hmds)
 {
-    bool bSuccess = true;
+    const int tracker_id = getDeviceID();
 
-    // Get the HSV filter used to find the tracking blob
-    CommonHSVColorRange hsvColorRange;
-    if (bSuccess)
+    // Fuse: hand the projections the pipeline found in its newest finished frame to the devices.
+    // Their pose filters and the triangulation in the device managers take it from there.
+    TrackerPipelineResult result;
+    if (m_optical_pipeline->fetchLatestResult(result))
     {
-        eCommonTrackingColorID tracked_color_id = tracked_hmd->getTrackingColorID();
+        for (const RemoteTrackerProjection &projection : result.projections)
+        {
+            if (projection.device_category == PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_CONTROLLER)
+            {
+                for (ServerControllerView *controller_view : tracked_controllers)
+                {
+                    if (controller_view->getDeviceID() == projection.device_id)
+                    {
+                        ControllerOpticalPoseEstimation newTrackerPoseEstimate= 
+                            *controller_view->getTrackerPoseEstimate(tracker_id);
+                        const bool bWasTracking = newTrackerPoseEstimate.bCurrentlyTracking;
+
+                        applyPipelinedProjectionToPoseEstimate(projection, newTrackerPoseEstimate);
+                        controller_view->setTrackerProjection(tracker_id, newTrackerPoseEstimate);
+                        recordReacquisition(bWasTracking);
+                        break;
+                    }
+                }
+            }
+            else if (projection.device_category == PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_HMD)
+            {
+                for (ServerHMDView *hmd_view : tracked_hmds)
+                {
+                    if (hmd_view->getDeviceID() == projection.device_id)
+                    {
+                        HMDOpticalPoseEstimation newTrackerPoseEstimate= 
+                            *hmd_view->getTrackerPoseEstimate(tracker_id);
+                        const bool bWasTracking = newTrackerPoseEstimate.bCurrentlyTracking;
+
+                        applyPipelinedProjectionToPoseEstimate(projection, newTrackerPoseEstimate);
+                        hmd_view->setTrackerProjection(tracker_id, newTrackerPoseEstimate);
+                        recordReacquisition(bWasTracking);
+                        break;
+                    }
+                }
+            }
+        }
+
+        m_statistics = result.statistics;
+        addExposureSample(result.frame_sequence_num);
+        m_optical_pipeline->notifyResultFused(result);
+    }
+
+    // Process: queue each new video frame once, with ROIs from the devices' latest fused poses
+    if (m_opencv_buffer_state == nullptr || 
+        !m_opencv_buffer_state->hasVideoFrame() ||
+        m_opencv_buffer_state->frameSequenceNumber == m_optical_pipeline_sequence_number)
+    {
+        return;
+    }
+
+    TrackerPipelineJob job;
+    job.video_frame = m_opencv_buffer_state->videoFrame;
+    job.frame_sequence_num = m_opencv_buffer_state->frameSequenceNumber;
+    job.frame_width = m_opencv_buffer_state->frameWidth;
+    job.frame_height = m_opencv_buffer_state->frameHeight;
+    getPipelineCameraParams(job.camera_params);
+    computeTargetsForTrackedDevices(tracked_controllers, tracked_hmds, job.frame_sequence_num, job.targets);
+
+    m_optical_pipeline->submitJob(job);
+    m_optical_pipeline_sequence_number = m_opencv_buffer_state->frameSequenceNumber;
+
+    // Point cloud HMDs fit against their prior pose, so they are still searched here
+    std::vector<ServerHMDView *> point_cloud_hmds;
+    for (ServerHMDView *hmd_view : tracked_hmds)
+    {
+        CommonDeviceTrackingShape tracking_shape;
+        hmd_view->getTrackingShape(tracking_shape);
+
+        if (tracking_shape.shape_type == eCommonTrackingShapeType::PointCloud)
+        {
+            point_cloud_hmds.push_back(hmd_view);
+        }
+    }
+
+    if (!point_cloud_hmds.empty())
+    {
+        computeLocalProjectionsForTrackedDevices(std::vector<ServerControllerView *>(), point_cloud_hmds);
+    }
+}
+
+void
+ServerTrackerView::computeRemoteProjectionsForTrackedDevices(
+    const std::vector<ServerControllerView *> &tracked_controllers,
+    const std::vector<ServerHMDView *> &tracked_hmds)
+{
+    RemoteTracker *remote_tracker = static_cast<RemoteTracker *>(m_device);
+    const RemoteTrackerFrame &frame = remote_tracker->getLatestFrame();
+    const int tracker_id = getDeviceID();
+
+    if (m_remote_frame_age_statistic != nullptr)
+    {
+        const std::chrono::microseconds frame_age =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - frame.capture_timestamp);
+
+        m_remote_frame_age_statistic->set(frame_age.count());
+    }
+
+    // Hand the projections the node found in its latest frame to the devices
+    for (const RemoteTrackerProjection &remote_projection : frame.projections)
+    {
+        if (remote_projection.device_category == PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_CONTROLLER)
+        {
+            for (ServerControllerView *controller_view : tracked_controllers)
+            {
+                if (controller_view->getDeviceID() == remote_projection.device_id)
+                {
+                    ControllerOpticalPoseEstimation newTrackerPoseEstimate= 
+                        *controller_view->getTrackerPoseEstimate(tracker_id);
+                    const bool bWasTracking = newTrackerPoseEstimate.bCurrentlyTracking;
+
+                    newTrackerPoseEstimate.projection = remote_projection.projection;
+                    newTrackerPoseEstimate.position_cm = remote_projection.position_cm;
+                    newTrackerPoseEstimate.bCurrentlyTracking = remote_projection.bPositionValid;
+                    newTrackerPoseEstimate.orientation.clear();
+                    newTrackerPoseEstimate.bOrientationValid = false;
+
+                    controller_view->setTrackerProjection(tracker_id, newTrackerPoseEstimate);
+                    recordReacquisition(bWasTracking);
+                    break;
+                }
+            }
+        }
+        else if (remote_projection.device_category == PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_HMD)
+        {
+            for (ServerHMDView *hmd_view : tracked_hmds)
+            {
+                if (hmd_view->getDeviceID() == remote_projection.device_id)
+                {
+                    HMDOpticalPoseEstimation newTrackerPoseEstimate= 
+                        *hmd_view->getTrackerPoseEstimate(tracker_id);
+                    const bool bWasTracking = newTrackerPoseEstimate.bCurrentlyTracking;
+
+                    newTrackerPoseEstimate.projection = remote_projection.projection;
+                    newTrackerPoseEstimate.position_cm = remote_projection.position_cm;
+                    newTrackerPoseEstimate.bCurrentlyTracking = remote_projection.bPositionValid;
+                    newTrackerPoseEstimate.orientation.clear();
+                    newTrackerPoseEstimate.bOrientationValid = false;
+
+                    hmd_view->setTrackerProjection(tracker_id, newTrackerPoseEstimate);
+                    recordReacquisition(bWasTracking);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Tell the node what to look for in its next frames
+    std::vector<RemoteTrackerTarget> targets;
+    computeTargetsForTrackedDevices(tracked_controllers, tracked_hmds, frame.frame_sequence_num, targets);
+
+    remote_tracker->sendTargets(targets);
+}
+
+void
+ServerTrackerView::computeTargetsForTrackedDevices(
+    const std::vector<ServerControllerView *> &tracked_controllers,
+    const std::vector<ServerHMDView *> &tracked_hmds,
+    const int frame_sequence_num,
+    std::vector<RemoteTrackerTarget> &out_targets) const
+{
+    float screenWidth, screenHeight;
+    getPixelDimensions(screenWidth, screenHeight);
+    const cv::Rect2i frame_rect(0, 0, static_cast<int>(screenWidth), static_cast<int>(screenHeight));
+
+    out_targets.clear();
+
+    // Where to look for every tracked device in the frame, best first
+    std::vector<CommonDeviceTrackingShape> tracking_shapes;
+    std::vector<t_tracker_search_window_list> device_windows;
+    computeTrackerSearchWindowsForDevices(
+        this, tracked_controllers, tracked_hmds, frame_sequence_num,
+        m_recovery_window_statistic, m_recovery_full_scan_statistic,
+        tracking_shapes, device_windows);
+
+    // A device gets a target per search window, in priority order
+    auto add_targets = [&out_targets, &frame_rect](
+        int device_category, int device_id,
+        const CommonHSVColorRange &hsv_color_range,
+        const CommonDeviceTrackingShape &tracking_shape,
+        const t_tracker_search_window_list &windows)
+    {
+        for (const TrackerSearchWindow &window : windows)
+        {
+            // An empty ROI means search the whole frame
+            const cv::Rect2i clamped_ROI = window.ROI & frame_rect;
+            RemoteTrackerTarget target;
+
+            target.device_category = device_category;
+            target.device_id = device_id;
+            target.hsv_color_range = hsv_color_range;
+            target.tracking_shape = tracking_shape;
+            target.roi_x = clamped_ROI.x;
+            target.roi_y = clamped_ROI.y;
+            target.roi_width = clamped_ROI.width;
+            target.roi_height = clamped_ROI.height;
+            target.scan_decimation = window.scan_decimation;
+
+            out_targets.push_back(target);
+        }
+    };
+
+    for (size_t controller_index = 0; controller_index < tracked_controllers.size(); ++controller_index)
+    {
+        const ServerControllerView *controller_view = tracked_controllers[controller_index];
+        CommonHSVColorRange hsvColorRange;
+
+        if (controller_view->getTrackingColorID() == eCommonTrackingColorID::INVALID_COLOR)
+        {
+            continue;
+        }
+
+        getControllerTrackingColorPreset(controller_view, controller_view->getTrackingColorID(), &hsvColorRange);
+
+        add_targets(
+            PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_CONTROLLER, controller_view->getDeviceID(),
+            hsvColorRange, tracking_shapes[controller_index], device_windows[controller_index]);
+    }
+
+    for (size_t hmd_index = 0; hmd_index < tracked_hmds.size(); ++hmd_index)
+    {
+        const size_t device_index = tracked_controllers.size() + hmd_index;
+        const ServerHMDView *hmd_view = tracked_hmds[hmd_index];
+        const CommonDeviceTrackingShape &tracking_shape = tracking_shapes[device_index];
+        CommonHSVColorRange hsvColorRange;
+
+        // Point clouds need the prior pose of the HMD
+        if (tracking_shape.shape_type == eCommonTrackingShapeType::PointCloud ||
+            hmd_view->getTrackingColorID() == eCommonTrackingColorID::INVALID_COLOR)
+        {
+            continue;
+        }
+
+        getHMDTrackingColorPreset(hmd_view, hmd_view->getTrackingColorID(), &hsvColorRange);
+
+        add_targets(
+            PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_HMD, hmd_view->getDeviceID(),
+            hsvColorRange, tracking_shape, device_windows[device_index]);
+    }
+}
+
+void
+ServerTrackerView::recordReacquisition(bool bWasTracking)
+{
+    // The device was lost by this tracker until now
+    if (!bWasTracking && m_reacquisition_statistic != nullptr)
+    {
+        m_reacquisition_statistic->increment();
+    }
+}
+
+void
+ServerTrackerView::addExposureSample(int frame_sequence_num)
+{
+    // Only the devices found in the frame say anything about how it's exposed
+    if (m_exposure_controller == nullptr || 
+        frame_sequence_num == m_exposure_sequence_number ||
+        m_statistics.exposure_sample_count <= 0)
+    {
+        return;
+    }
+
+    TrackerExposureSample sample;
+    sample.bulb_value = m_statistics.bulb_value;
+    sample.bulb_clipped_fraction = m_statistics.bulb_clipped_fraction;
+    sample.background_value = m_statistics.background_value;
+
+    m_exposure_controller->addSample(sample);
+    m_exposure_sequence_number = frame_sequence_num;
+}
+
+void
+ServerTrackerView::updateExposureControl()
+{
+    if (m_exposure_controller != nullptr)
+    {
+        const TrackerExposureController::t_timepoint now = std::chrono::high_resolution_clock::now();
+
+        // Rate limited by the controller. Adjustments aren't saved to the tracker's config,
+        // so the next session starts from the hand tuned settings the color presets were made with.
+        if (m_exposure_controller->update(now, getExposure(), getGain()))
+        {
+            setExposure(m_exposure_controller->getExposure(), false);
+            setGain(m_exposure_controller->getGain(), false);
+
+            if (m_exposure_adjustment_statistic != nullptr)
+            {
+                m_exposure_adjustment_statistic->increment();
+            }
+        }
+
+        m_statistics.exposure_decision = m_exposure_controller->getDecision();
+    }
+    else
+    {
+        m_statistics.exposure_decision = _TrackerExposureDecision_Disabled;
+    }
+
+    m_statistics.exposure = static_cast<float>(getExposure());
+    m_statistics.gain = static_cast<float>(getGain());
+}
+
+void
+ServerTrackerView::getPipelineCameraParams(TrackerPipelineCameraParams &out_params) const
+{
+    const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
+
+    getCameraIntrinsics(
+        out_params.focal_length_x, out_params.focal_length_y,
+        out_params.principal_x, out_params.principal_y,
+        out_params.distortion_k1, out_params.distortion_k2, out_params.distortion_k3,
+        out_params.distortion_p1, out_params.distortion_p2);
+    getPixelDimensions(out_params.pixel_width, out_params.pixel_height);
+    out_params.min_valid_projection_area = trackerMgrConfig.min_valid_projection_area;
+    out_params.bRoiDisabled = trackerMgrConfig.disable_roi;
+    out_params.bUseBGRToHSVLookupTable = trackerMgrConfig.use_bgr_to_hsv_lookup_table;
+    out_params.bUseLightBarFastPath = trackerMgrConfig.use_lightbar_fast_path;
+    out_params.bMeasureExposure = m_exposure_controller != nullptr;
+}
+
+void
+ServerTrackerView::computeProjectionsForRemoteTargets(
+    const std::vector<RemoteTrackerTarget> &targets,
+    std::vector<RemoteTrackerProjection> &out_projections)
+{
+    out_projections.clear();
+
+    // Nothing to search until the first video frame arrives
+    if (m_opencv_buffer_state == nullptr || !m_opencv_buffer_state->hasVideoFrame() || targets.empty())
+    {
+        return;
+    }
+
+    TrackerPipelineCameraParams camera_params;
+    getPipelineCameraParams(camera_params);
+
+    // The central service computed the ROIs from its pose filters
+    computeProjectionsForTargetsInBuffer(
+        m_opencv_buffer_state, camera_params, targets, 
+        nullptr, nullptr,
+        out_projections, m_statistics);
+
+    // The camera is attached to this node, so its exposure is adapted here too
+    addExposureSample(m_opencv_buffer_state->frameSequenceNumber);
+    updateExposureControl();
+}
+
+bool
+ServerTrackerView::computeProjectionForController(
+    const ServerControllerView* tracked_controller,
+    const CommonDeviceTrackingShape *tracking_shape,
+    ControllerOpticalPoseEstimation *out_pose_estimate)
+{
+    bool bSuccess = true;
+
+    // Get the HSV filter used to find the tracking blob
+    CommonHSVColorRange hsvColorRange;
+    if (bSuccess)
+    {
+        eCommonTrackingColorID tracked_color_id = tracked_controller->getTrackingColorID();
 
         if (tracked_color_id != eCommonTrackingColorID::INVALID_COLOR)
         {
-            getHMDTrackingColorPreset(tracked_hmd, tracked_color_id, &hsvColorRange);
+            getControllerTrackingColorPreset(tracked_controller, tracked_color_id, &hsvColorRange);
         }
         else
         {
             bSuccess = false;
         }
     }
+
+    if (bSuccess)
+    {
+        const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
+        const bool bRoiDisabled = tracked_controller->getIsROIDisabled() || trackerMgrConfig.disable_roi;
+
+        bSuccess = computeProjectionForColorRange(hsvColorRange, tracking_shape, bRoiDisabled, out_pose_estimate);
+    }
+
+    return bSuccess;
+}
+
+bool
+ServerTrackerView::computeProjectionForColorRange(
+    const CommonHSVColorRange &hsvColorRange,
+    const CommonDeviceTrackingShape *tracking_shape,
+    bool bRoiDisabled,
+    ControllerOpticalPoseEstimation *out_pose_estimate)
+{
+    TrackerPipelineCameraParams camera_params;
+    getPipelineCameraParams(camera_params);
+
+    return computeProjectionForColorRangeInBuffer(
+        m_opencv_buffer_state, camera_params, hsvColorRange, tracking_shape, bRoiDisabled, out_pose_estimate);
+}
+
+static bool computeProjectionForColorRangeInBuffer(
+    OpenCVBufferState *buffer_state,
+    const TrackerPipelineCameraParams &camera_params,
+    const CommonHSVColorRange &hsvColorRange,
+    const CommonDeviceTrackingShape *tracking_shape,
+    bool bRoiDisabled,
+    ControllerOpticalPoseEstimation *out_pose_estimate)
+{
+    bool bSuccess = true;
+
+    // Find the contour associated with the device
+    t_opencv_int_contour_list biggest_contours;
+    std::vector<double> contour_areas;
+    if (bSuccess)
+    {
+        bSuccess = buffer_state->computeBiggestNContours(hsvColorRange, biggest_contours, contour_areas, 1);
+    }
+
+    if (bSuccess && camera_params.bMeasureExposure)
+    {
+        buffer_state->measureBlobExposure(hsvColorRange, biggest_contours[0]);
+    }
     
-    // Compute a region of interest in the tracker buffer around where we expect to find the tracking shape
-    const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
-    const bool bRoiDisabled = tracked_hmd->getIsROIDisabled() || trackerMgrConfig.disable_roi;
+    // Process the contour for its 2D and 3D pose.
+    if (bSuccess)
+    {
+        // Get camera parameters.
+        // Needed for undistortion.
+        cv::Matx33f camera_matrix;
+        cv::Matx<float, 5, 1> distortions;
+        computeOpenCVCameraIntrinsicMatrix(camera_params, camera_matrix, distortions);
+                
+        // Compute the tracker relative 3d position of the controller from the contour
+        switch (tracking_shape->shape_type)
+        {
+        // For the sphere projection we can go ahead and compute the full pose estimation now
+        case eCommonTrackingShapeType::Sphere:
+            {
+                // Compute the convex hull of the contour
+                t_opencv_int_contour convex_contour;
+                cv::convexHull(biggest_contours[0], convex_contour);
+                buffer_state->draw_contour(convex_contour);
+
+                // Convert integer to float
+                t_opencv_float_contour convex_contour_f;
+                cv::Mat(convex_contour).convertTo(convex_contour_f, cv::Mat(convex_contour_f).type());
+
+                // Undistort points
+                t_opencv_float_contour undistort_contour;  //destination for undistorted contour
+                cv::undistortPoints(convex_contour_f, undistort_contour,
+                                    camera_matrix,
+                                    distortions);//,
+                                    //cv::noArray(),
+                                    //camera_matrix);
+                // Note: if we omit the last two arguments, then
+                // undistort_contour points are in 'normalized' space.
+                // i.e., they are relative to their F_PX,F_PY
+                
+                // Compute the sphere center AND the projected ellipse
+                Eigen::Vector3f sphere_center;
+                EigenFitEllipse ellipse_projection;
+
+                std::vector<Eigen::Vector2f> eigen_contour;
+                std::for_each(undistort_contour.begin(),
+                              undistort_contour.end(),
+                              [&eigen_contour](cv::Point2f& p) {
+                                  eigen_contour.push_back(Eigen::Vector2f(p.x, p.y));
+                              });
+                eigen_alignment_fit_focal_cone_to_sphere(eigen_contour.data(),
+                                                         static_cast<int>(eigen_contour.size()),
+                                                         tracking_shape->shape.sphere.radius_cm,
+                                                         1, //I was expecting this to be -1. Is it +1 because we're using -F_PY?
+                                                         &sphere_center,
+                                                         &ellipse_projection);
+                
+                if (ellipse_projection.area > k_real_epsilon)
+                {
+                    //Save the optically-estimate 3D pose.
+                    out_pose_estimate->position_cm.set(sphere_center.x(), sphere_center.y(), sphere_center.z());
+                    out_pose_estimate->bCurrentlyTracking = true;
+                    // Not possible to get an orientation off of a sphere
+                    out_pose_estimate->orientation.clear();
+                    out_pose_estimate->bOrientationValid = false;
+
+                    // Save off the projection of the sphere (an ellipse)
+                    out_pose_estimate->projection.shape.ellipse.angle = ellipse_projection.angle;
+                    out_pose_estimate->projection.screen_area= ellipse_projection.area;
+                    //The ellipse projection is still in normalized space.
+                    //i.e., it is a 2-dimensional ellipse floating somewhere.
+                    //We must reproject it onto the camera.
+                    //TODO: Use opencv's project points instead of manual way below
+                    //because it will account for distortion, at least for the center point.
+                    out_pose_estimate->projection.shape_type = eCommonTrackingProjectionType::ProjectionType_Ellipse;
+                    out_pose_estimate->projection.shape.ellipse.center.set(
+                        ellipse_projection.center.x()*camera_matrix.val[0] + camera_matrix.val[2],
+                        ellipse_projection.center.y()*camera_matrix.val[4] + camera_matrix.val[5]);
+                    out_pose_estimate->projection.shape.ellipse.half_x_extent = ellipse_projection.extents.x()*camera_matrix.val[0];
+                    out_pose_estimate->projection.shape.ellipse.half_y_extent = ellipse_projection.extents.y()*camera_matrix.val[0];
+                    out_pose_estimate->projection.screen_area=
+                        k_real_pi*out_pose_estimate->projection.shape.ellipse.half_x_extent*out_pose_estimate->projection.shape.ellipse.half_y_extent;
+                
+                    //Draw results onto buffer_state
+                    buffer_state->draw_pose_projection(out_pose_estimate->projection);
+
+                    bSuccess = true;
+                }
+            } break;
+        // For the LightBar projection we only want to compute the projection shape.
+        // The pose estimation is deferred until we know if we can leverage triangulation or not.
+        case eCommonTrackingShapeType::LightBar:
+            {
+                // Draw the raw source contour
+                buffer_state->draw_contour(biggest_contours[0]);
+
+                // Convert integer contour to float
+                t_opencv_float_contour biggest_contour_f;
+                cv::Mat(biggest_contours[0]).convertTo(biggest_contour_f, cv::Mat(biggest_contour_f).type());
+
+                // Compute an undistorted version of the contour
+                t_opencv_float_contour undistort_contour;
+                cv::undistortPoints(biggest_contour_f, undistort_contour,
+                                    camera_matrix,
+                                    distortions,
+                                    cv::noArray(),
+                                    camera_matrix);
+
+                // Last frame's projection (when still tracking) orients the fit of this one
+                const bool bHasPriorProjection =
+                    camera_params.bUseLightBarFastPath &&
+                    out_pose_estimate->bCurrentlyTracking &&
+                    out_pose_estimate->projection.shape_type == eCommonTrackingProjectionType::ProjectionType_LightBar;
+                const CommonDeviceTrackingProjection prior_projection = out_pose_estimate->projection;
+
+                // Compute the lightbar tracking projection from the undistored contour
+                bSuccess=
+                    computeTrackerRelativeLightBarProjection(
+                        tracking_shape,
+                        undistort_contour,
+                        bHasPriorProjection ? &prior_projection : nullptr,
+                        &out_pose_estimate->projection);
 
-    const HMDOpticalPoseEstimation *priorPoseEst= 
-        tracked_hmd->getTrackerPoseEstimate(this->getDeviceID());
-    const bool bIsTracking = priorPoseEst->bCurrentlyTracking;
+                //Draw results onto buffer_state
+                buffer_state->draw_pose_projection(out_pose_estimate->projection);
+            } break;
+        default:
+            assert(0 && "Unreachable");
+            break;
+        }
+    }
+
+    // Throw out the result if the contour we found was too small and 
+    // we were using an ROI less that the size of the full screen
+    if (bSuccess && !bRoiDisabled)
+    {
+        const cv::Mat &bgrROI = buffer_state->bgrROI;
+        if (bgrROI.cols < camera_params.pixel_width || bgrROI.rows < camera_params.pixel_height)
+        {
+            bSuccess= out_pose_estimate->projection.screen_area >= camera_params.min_valid_projection_area;
+        }
+    }
+
+    return bSuccess;
+}
+
+bool ServerTrackerView::computeProjectionForHMD(
+    const class ServerHMDView* tracked_hmd,
+    const struct CommonDeviceTrackingShape *tracking_shape,
+    struct HMDOpticalPoseEstimation *out_pose_estimate)
+{
+    bool bSuccess = true;
 
-    cv::Rect2i ROI = computeTrackerROIForPoseProjection(
-        bRoiDisabled,
-        this, 
-        bIsTracking ? tracked_hmd->getPoseFilter() : nullptr,
-        bIsTracking ? &priorPoseEst->projection : nullptr,
-        tracking_shape);
-    m_opencv_buffer_state->applyROI(ROI);
+    // Get the HSV filter used to find the tracking blob
+    CommonHSVColorRange hsvColorRange;
+    if (bSuccess)
+    {
+        eCommonTrackingColorID tracked_color_id = tracked_hmd->getTrackingColorID();
 
+        if (tracked_color_id != eCommonTrackingColorID::INVALID_COLOR)
+        {
+            getHMDTrackingColorPreset(tracked_hmd, tracked_color_id, &hsvColorRange);
+        }
+        else
+        {
+            bSuccess = false;
+        }
+    }
+    
     // Find the N best contours associated with the HMD
     t_opencv_int_contour_list biggest_contours;
     std::vector<double> contour_areas;
@@ -1467,6 +2925,11 @@ bool ServerTrackerView::computeProjectionForHMD(
                 hsvColorRange, biggest_contours, contour_areas, CommonDeviceTrackingProjection::MAX_POINT_CLOUD_POINT_COUNT);
     }
 
+    if (bSuccess && m_exposure_controller != nullptr)
+    {
+        m_opencv_buffer_state->measureBlobExposure(hsvColorRange, biggest_contours[0]);
+    }
+
     // Compute the tracker relative 3d position of the controller from the contour
     if (bSuccess)
     {
@@ -1613,13 +3076,26 @@ ServerTrackerView::computePoseForProjection(
         } break;
     case eCommonTrackingShapeType::LightBar:
         {
+            const bool bUseFastPath= 
+                DeviceManager::getInstance()->m_tracker_manager->getConfig().use_lightbar_fast_path;
+            bool bUsedFastPath= false;
+
             bSuccess =
                 computeTrackerRelativeLightBarPose(
                     m_device,
                     tracking_shape,
                     projection,
                     pose_guess,
-                    out_pose_estimate);
+                    bUseFastPath,
+                    out_pose_estimate,
+                    &bUsedFastPath);
+
+            ServiceStatistic *pose_statistic= 
+                bUsedFastPath ? m_lightbar_fast_pose_statistic : m_lightbar_full_pose_statistic;
+            if (bSuccess && pose_statistic != nullptr)
+            {
+                pose_statistic->increment();
+            }
         } break;
     default:
         assert(0 && "Unreachable");
@@ -2033,6 +3509,155 @@ static void computeOpenCVCameraIntrinsicMatrix(const ITrackerInterface *tracker_
     intrinsicOut(2, 0) = 0.f;   intrinsicOut(2, 1) = 0.f;   intrinsicOut(2, 2) = 1.f;
 }
 
+static void computeOpenCVCameraIntrinsicMatrix(const TrackerPipelineCameraParams &camera_params,
+                                               cv::Matx33f &intrinsicOut,
+                                               cv::Matx<float, 5, 1> &distortionOut)
+{
+    intrinsicOut = cv::Matx33f(
+        camera_params.focal_length_x, 0.f, camera_params.principal_x,
+        0.f, -camera_params.focal_length_y, camera_params.principal_y, //Negate F_PY because the screen coordinate system has +Y down.
+        0.f, 0.f, 1.f);
+    distortionOut = cv::Matx<float, 5, 1>(
+        camera_params.distortion_k1, camera_params.distortion_k2,
+        camera_params.distortion_p1, camera_params.distortion_p2,
+        camera_params.distortion_k3);
+}
+
+static void computeProjectionsForTargetsInBuffer(
+    OpenCVBufferState *buffer_state,
+    const TrackerPipelineCameraParams &camera_params,
+    const std::vector<RemoteTrackerTarget> &targets,
+    ServiceStatistic *roi_search_statistic,
+    ServiceStatistic *roi_hit_statistic,
+    std::vector<RemoteTrackerProjection> &out_projections,
+    TrackerStatistics &out_statistics)
+{
+    out_projections.clear();
+
+    if (targets.empty())
+    {
+        return;
+    }
+
+    std::vector<cv::Rect2i> ROIs(targets.size());
+    for (size_t target_index = 0; target_index < targets.size(); ++target_index)
+    {
+        const RemoteTrackerTarget &target = targets[target_index];
+
+        if (target.scan_decimation > 1)
+        {
+            // Full frame recovery scan: only search around the blob found in a decimated copy of the frame.
+            // This has to happen before any debug overlay is drawn on the frame.
+            const cv::Rect2i located_ROI = 
+                buffer_state->locateColorRangeInDecimatedFrame(target.hsv_color_range, target.scan_decimation);
+
+            ROIs[target_index] = (located_ROI.area() > 0) ? buffer_state->clampROI(located_ROI) : located_ROI;
+        }
+        else
+        {
+            ROIs[target_index] =
+                buffer_state->clampROI(
+                    cv::Rect2i(target.roi_x, target.roi_y, target.roi_width, target.roi_height));
+        }
+    }
+
+    // Convert all of the ROIs to HSV, converting each pixel at most once
+    buffer_state->updateHsvBufferForROIs(ROIs);
+
+    out_statistics.hsv_pixels_requested = buffer_state->hsvPixelsRequested;
+    out_statistics.hsv_pixels_converted = buffer_state->hsvPixelsConverted;
+    out_statistics.working_buffer_bytes = buffer_state->getWorkingBufferBytes();
+    out_statistics.shared_hsv_lut_bytes = OpenCVBGRToHSVMapper::getAllocatedBytes();
+
+    // Searches in an ROI smaller than the frame count towards the ROI hit rate
+    const int frame_area = buffer_state->frameWidth * buffer_state->frameHeight;
+
+    for (size_t target_index = 0; target_index < targets.size(); ++target_index)
+    {
+        const RemoteTrackerTarget &target = targets[target_index];
+
+        if (target.tracking_shape.shape_type != eCommonTrackingShapeType::Sphere &&
+            target.tracking_shape.shape_type != eCommonTrackingShapeType::LightBar)
+        {
+            continue;
+        }
+
+        // A full frame scan that came up empty
+        if (ROIs[target_index].area() <= 0)
+        {
+            continue;
+        }
+
+        // A device's targets are in priority order, it's only searched for until it's found
+        const bool bAlreadyFound = 
+            std::any_of(
+                out_projections.begin(), out_projections.end(),
+                [&target](const RemoteTrackerProjection &projection) {
+                    return projection.device_category == target.device_category && projection.device_id == target.device_id;
+                });
+        if (bAlreadyFound)
+        {
+            continue;
+        }
+
+        ControllerOpticalPoseEstimation poseEstimate;
+        poseEstimate.clear();
+
+        buffer_state->applyROI(ROIs[target_index]);
+
+        const bool bFound =
+            computeProjectionForColorRangeInBuffer(
+                buffer_state,
+                camera_params,
+                target.hsv_color_range, 
+                &target.tracking_shape, 
+                camera_params.bRoiDisabled, 
+                &poseEstimate);
+
+        if (roi_search_statistic != nullptr && ROIs[target_index].area() < frame_area)
+        {
+            roi_search_statistic->increment();
+            if (bFound)
+            {
+                roi_hit_statistic->increment();
+            }
+        }
+
+        if (bFound)
+        {
+            RemoteTrackerProjection projection;
+
+            projection.device_category = target.device_category;
+            projection.device_id = target.device_id;
+            projection.projection = poseEstimate.projection;
+            projection.position_cm = poseEstimate.position_cm;
+            projection.bPositionValid = poseEstimate.bCurrentlyTracking;
+
+            out_projections.push_back(projection);
+        }
+    }
+
+    buffer_state->getExposureStatistics(out_statistics);
+}
+
+template <typename t_pose_estimate>
+static void applyPipelinedProjectionToPoseEstimate(
+    const RemoteTrackerProjection &projection,
+    t_pose_estimate &pose_estimate)
+{
+    // Same fields computeProjectionForColorRangeInBuffer() fills in,
+    // a lightbar only has its projection until its pose is computed from it
+    pose_estimate.projection = projection.projection;
+
+    if (projection.bPositionValid)
+    {
+        pose_estimate.position_cm = projection.position_cm;
+        pose_estimate.bCurrentlyTracking = true;
+        pose_estimate.orientation.clear();
+        pose_estimate.bOrientationValid = false;
+    }
+}
+
 static cv::Matx34f computeOpenCVCameraPinholeMatrix(const ITrackerInterface *tracker_device)
 {
     cv::Matx34f extrinsic_matrix;
@@ -2048,42 +3673,61 @@ static cv::Matx34f computeOpenCVCameraPinholeMatrix(const ITrackerInterface *tra
 static bool computeTrackerRelativeLightBarProjection(
     const CommonDeviceTrackingShape *tracking_shape,
     const t_opencv_float_contour &opencv_contour,
+    const CommonDeviceTrackingProjection *prior_projection,
     CommonDeviceTrackingProjection *out_projection)
 {
     assert(tracking_shape->shape_type == eCommonTrackingShapeType::LightBar);
 
-    bool bValidTrackerProjection= true;
+    bool bValidTrackerProjection= false;
     float projectionArea= 0.f;
     std::vector<cv::Point2f> cvImagePoints;
     {
         cv::Point2f tri_top, tri_bottom_left, tri_bottom_right;
         cv::Point2f quad_top_right, quad_top_left, quad_bottom_left, quad_bottom_right;
 
-        // Create a best fit triangle around the contour
-        bValidTrackerProjection= computeBestFitTriangleForContour(
-            opencv_contour, 
-            tri_top, tri_bottom_left, tri_bottom_right);
-
-        // Also create a best fit quad around the contour
-        // Use the best fit triangle to define the orientation
-        if (bValidTrackerProjection)
+        // Fast path: let last frame's quad orient the best fit quad,
+        // which skips the comparatively expensive best fit triangle
+        if (prior_projection != nullptr)
         {
-            // Use the triangle to define an up and a right direction
-            const cv::Point2f up_hint= tri_top - 0.5f*(tri_bottom_left + tri_bottom_right);
-            const cv::Point2f right_hint= tri_bottom_right - tri_bottom_left;
+            bValidTrackerProjection= computeBestFitLightBarForContourFromPrior(
+                opencv_contour,
+                tracking_shape,
+                prior_projection,
+                tri_top, tri_bottom_left, tri_bottom_right,
+                quad_top_right, quad_top_left, quad_bottom_left, quad_bottom_right);
+        }
 
-            bValidTrackerProjection= computeBestFitQuadForContour(
+        if (!bValidTrackerProjection)
+        {
+            // Create a best fit triangle around the contour
+            bValidTrackerProjection= computeBestFitTriangleForContour(
                 opencv_contour, 
-                up_hint, right_hint, 
-                quad_top_right, quad_top_left, quad_bottom_left, quad_bottom_right);
+                tri_top, tri_bottom_left, tri_bottom_right);
+
+            // Also create a best fit quad around the contour
+            // Use the best fit triangle to define the orientation
+            if (bValidTrackerProjection)
+            {
+                // Use the triangle to define an up and a right direction
+                const cv::Point2f up_hint= tri_top - 0.5f*(tri_bottom_left + tri_bottom_right);
+                const cv::Point2f right_hint= tri_bottom_right - tri_bottom_left;
+
+                bValidTrackerProjection= computeBestFitQuadForContour(
+                    opencv_contour, 
+                    up_hint, right_hint, 
+                    quad_top_right, quad_top_left, quad_bottom_left, quad_bottom_right);
+            }
+
+            if (bValidTrackerProjection)
+            {
+                // In practice the best fit triangle top is a bit noisy.
+                // Since it should be at the midpoint of the top of the quad we use that instead.
+                tri_top= 0.5f*(quad_top_right + quad_top_left);
+            }
         }
 
         if (bValidTrackerProjection)
         {
-            // In practice the best fit triangle top is a bit noisy.
-            // Since it should be at the midpoint of the top of the quad we use that instead.
-            tri_top= 0.5f*(quad_top_right + quad_top_left);
-
             // Put the image points in corresponding order with cvObjectPoints
             cvImagePoints.push_back(tri_bottom_right);
             cvImagePoints.push_back(tri_bottom_left);
@@ -2131,11 +3775,50 @@ static bool computeTrackerRelativeLightBarPose(
     const CommonDeviceTrackingShape *tracking_shape,
     const CommonDeviceTrackingProjection *projection,
     const CommonDevicePose *tracker_relative_pose_guess,
-    ControllerOpticalPoseEstimation *out_pose_estimate)
+    bool bUseFastPath,
+    ControllerOpticalPoseEstimation *out_pose_estimate,
+    bool *out_used_fast_path)
 {
     assert(tracking_shape->shape_type == eCommonTrackingShapeType::LightBar);
     assert(projection->shape_type == eCommonTrackingProjectionType::ProjectionType_LightBar);
 
+    // Get the tracker "intrinsic" matrix that encodes the camera FOV
+    cv::Matx33f cvCameraMatrix;
+    cv::Matx<float, 5, 1> cvDistCoeffs;
+    computeOpenCVCameraIntrinsicMatrix(tracker_device, cvCameraMatrix, cvDistCoeffs);
+
+    // Only trust a guess pose that is within the tracking volume
+    bool bValidPoseGuess= false;
+    if (tracker_relative_pose_guess != nullptr)
+    {
+        const float k_max_valid_guess_distance= 300.f; // cm
+        float guess_position_distance_sqrd= 
+            tracker_relative_pose_guess->PositionCm.x*tracker_relative_pose_guess->PositionCm.x
+            + tracker_relative_pose_guess->PositionCm.y*tracker_relative_pose_guess->PositionCm.y
+            + tracker_relative_pose_guess->PositionCm.z*tracker_relative_pose_guess->PositionCm.z;
+
+        bValidPoseGuess= guess_position_distance_sqrd < k_max_valid_guess_distance*k_max_valid_guess_distance;
+    }
+
+    if (out_used_fast_path != nullptr)
+    {
+        *out_used_fast_path= false;
+    }
+
+    // Fast path: closed form planar pose, disambiguated by the guess.
+    // Falls through to the iterative solve if the closed form fit doesn't hold up.
+    if (bUseFastPath && bValidPoseGuess &&
+        computeTrackerRelativeLightBarPoseFromGuess(
+            cvCameraMatrix, tracking_shape, projection, tracker_relative_pose_guess, out_pose_estimate))
+    {
+        if (out_used_fast_path != nullptr)
+        {
+            *out_used_fast_path= true;
+        }
+
+        return true;
+    }
+
     bool bValidTrackerPose= true;
     std::vector<cv::Point2f> cvImagePoints;
 
@@ -2176,36 +3859,22 @@ static bool computeTrackerRelativeLightBarPose(
             cvObjectPoints.push_back(cv::Point3f(corner.x, corner.y, corner.z));
         }
 
-        // Get the tracker "intrinsic" matrix that encodes the camera FOV
-        cv::Matx33f cvCameraMatrix;
-        cv::Matx<float, 5, 1> cvDistCoeffs;
-        computeOpenCVCameraIntrinsicMatrix(tracker_device, cvCameraMatrix, cvDistCoeffs);
-
         // Fill out the initial guess in OpenCV format for the contour pose
         // if a guess pose was provided
         cv::Mat rvec(3, 1, cv::DataType<double>::type);
         cv::Mat tvec(3, 1, cv::DataType<double>::type);
 
         bool bUseExtrinsicGuess= false;
-        if (tracker_relative_pose_guess != nullptr)
+        if (bValidPoseGuess)
         {
-            const float k_max_valid_guess_distance= 300.f; // cm
-            float guess_position_distance_sqrd= 
-                tracker_relative_pose_guess->PositionCm.x*tracker_relative_pose_guess->PositionCm.x
-                + tracker_relative_pose_guess->PositionCm.y*tracker_relative_pose_guess->PositionCm.y
-                + tracker_relative_pose_guess->PositionCm.z*tracker_relative_pose_guess->PositionCm.z;
-
-            if (guess_position_distance_sqrd < k_max_valid_guess_distance*k_max_valid_guess_distance)
-            {
-                // solvePnP expects a rotation as a Rodrigues (AngleAxis) vector
-                commonDeviceOrientationToOpenCVRodrigues(tracker_relative_pose_guess->Orientation, rvec);
+            // solvePnP expects a rotation as a Rodrigues (AngleAxis) vector
+            commonDeviceOrientationToOpenCVRodrigues(tracker_relative_pose_guess->Orientation, rvec);
 
-                tvec.at<double>(0)= tracker_relative_pose_guess->PositionCm.x;
-                tvec.at<double>(1)= tracker_relative_pose_guess->PositionCm.y;
-                tvec.at<double>(2)= tracker_relative_pose_guess->PositionCm.z;
+            tvec.at<double>(0)= tracker_relative_pose_guess->PositionCm.x;
+            tvec.at<double>(1)= tracker_relative_pose_guess->PositionCm.y;
+            tvec.at<double>(2)= tracker_relative_pose_guess->PositionCm.z;
 
-                bUseExtrinsicGuess= true;
-            }
+            bUseExtrinsicGuess= true;
         }
 
         // Solve the Perspective-N-Point problem:
@@ -2219,40 +3888,16 @@ static bool computeTrackerRelativeLightBarPose(
                 bUseExtrinsicGuess, cv::SOLVEPNP_ITERATIVE))
         {
             float axis_x, axis_y, axis_z, axis_theta;
-            float yaw, pitch, roll;
 
             // Extract the angle-axis components from the solution OpenCV Rodrigues vector
             openCVRodriguesToAngleAxis(rvec, axis_x, axis_y, axis_z, axis_theta);
 
-            // Convert the angle-axis rotation into Euler angles (yaw-pitch-roll)
-            angleAxisVectorToEulerAngles(axis_x, axis_y, axis_z, axis_theta, yaw, pitch, roll);
-           
-            //###HipsterSloth $TODO This should be a property of the lightbar tracking shape
-            static const float k_max_valid_tracking_pitch= 30.f*k_degrees_to_radians;
-            static const float k_max_valid_tracking_yaw= 30.f*k_degrees_to_radians;
-
-            // Due to ambiguity of the off the yaw and pitch solution from solvePnP (two possible solutions)
-            // we can't trust anything more than close to straightforward.
-            // Any roll angle is fine though.
-            if (fabsf(yaw) < k_max_valid_tracking_yaw && fabsf(pitch) < k_max_valid_tracking_pitch)
-            {           
-                // Convert the solution angle-axis into a CommonDeviceOrientation
-                angleAxisVectorToCommonDeviceOrientation(axis_x, axis_y, axis_z, axis_theta, out_pose_estimate->orientation);
-                out_pose_estimate->bOrientationValid= true;
-            }
-            else
-            {
-                out_pose_estimate->bOrientationValid= false;
-            }
-
-            // Return the position in the pose
-            {
-                CommonDevicePosition &position= out_pose_estimate->position_cm;
-
-                position.x = static_cast<float>(tvec.at<double>(0));
-                position.y = static_cast<float>(tvec.at<double>(1));
-                position.z = static_cast<float>(tvec.at<double>(2));
-            }
+            applyTrackerRelativeLightBarPose(
+                axis_x, axis_y, axis_z, axis_theta,
+                static_cast<float>(tvec.at<double>(0)),
+                static_cast<float>(tvec.at<double>(1)),
+                static_cast<float>(tvec.at<double>(2)),
+                out_pose_estimate);
 
             bValidTrackerPose= true;
         }
@@ -2261,6 +3906,83 @@ static bool computeTrackerRelativeLightBarPose(
     return bValidTrackerPose;
 }
 
+static bool computeTrackerRelativeLightBarPoseFromGuess(
+    const cv::Matx33f &camera_matrix,
+    const CommonDeviceTrackingShape *tracking_shape,
+    const CommonDeviceTrackingProjection *projection,
+    const CommonDevicePose *tracker_relative_pose_guess,
+    ControllerOpticalPoseEstimation *out_pose_estimate)
+{
+    cv::Point2f model_quad[CommonDeviceTrackingShape::QuadVertexCount];
+    cv::Point2f image_quad[CommonDeviceTrackingShape::QuadVertexCount];
+    for (int corner_index= 0; corner_index < CommonDeviceTrackingShape::QuadVertexCount; ++corner_index)
+    {
+        const CommonDevicePosition &corner= tracking_shape->shape.light_bar.quad[corner_index];
+        const CommonDeviceScreenLocation &screenLocation= projection->shape.lightbar.quad[corner_index];
+
+        model_quad[corner_index]= cv::Point2f(corner.x, corner.y);
+        image_quad[corner_index]= cv::Point2f(screenLocation.x, screenLocation.y);
+    }
+
+    const CommonDeviceQuaternion &guess_orientation= tracker_relative_pose_guess->Orientation;
+    const Eigen::Matrix3f guess_rotation= 
+        Eigen::Quaternionf(guess_orientation.w, guess_orientation.x, guess_orientation.y, guess_orientation.z)
+        .normalized().toRotationMatrix();
+
+    EigenPlanarPoseSolution solution;
+    if (!computeLightBarPoseFromGuess(camera_matrix, model_quad, image_quad, guess_rotation, solution))
+    {
+        return false;
+    }
+
+    const Eigen::AngleAxisf angle_axis(solution.rotation);
+
+    applyTrackerRelativeLightBarPose(
+        angle_axis.axis().x(), angle_axis.axis().y(), angle_axis.axis().z(), angle_axis.angle(),
+        solution.translation.x(), solution.translation.y(), solution.translation.z(),
+        out_pose_estimate);
+
+    return true;
+}
+
+static void applyTrackerRelativeLightBarPose(
+    float axis_x, float axis_y, float axis_z, float axis_theta,
+    float position_x, float position_y, float position_z,
+    ControllerOpticalPoseEstimation *out_pose_estimate)
+{
+    float yaw, pitch, roll;
+
+    // Convert the angle-axis rotation into Euler angles (yaw-pitch-roll)
+    angleAxisVectorToEulerAngles(axis_x, axis_y, axis_z, axis_theta, yaw, pitch, roll);
+   
+    //###HipsterSloth $TODO This should be a property of the lightbar tracking shape
+    static const float k_max_valid_tracking_pitch= 30.f*k_degrees_to_radians;
+    static const float k_max_valid_tracking_yaw= 30.f*k_degrees_to_radians;
+
+    // Due to ambiguity of the off the yaw and pitch solution from solvePnP (two possible solutions)
+    // we can't trust anything more than close to straightforward.
+    // Any roll angle is fine though.
+    if (fabsf(yaw) < k_max_valid_tracking_yaw && fabsf(pitch) < k_max_valid_tracking_pitch)
+    {           
+        // Convert the solution angle-axis into a CommonDeviceOrientation
+        angleAxisVectorToCommonDeviceOrientation(axis_x, axis_y, axis_z, axis_theta, out_pose_estimate->orientation);
+        out_pose_estimate->bOrientationValid= true;
+    }
+    else
+    {
+        out_pose_estimate->bOrientationValid= false;
+    }
+
+    // Return the position in the pose
+    {
+        CommonDevicePosition &position= out_pose_estimate->position_cm;
+
+        position.x = position_x;
+        position.y = position_y;
+        position.z = position_z;
+    }
+}
+
 static bool computeTrackerRelativePointCloudContourPose(
     const ITrackerInterface *tracker_device,
     const CommonDeviceTrackingShape *tracking_shape,
@@ -2340,107 +4062,18 @@ static cv::Rect2i computeTrackerROIForPoseProjection(
         CommonDevicePosition tracker_position_cm = tracker->computeTrackerPosition(&world_position_cm);
 
         // Project the state computed position +/- object extents onto the image.
+        const float shape_radius_cm = computeTrackingShapeBoundingRadiusCm(tracking_shape);
         CommonDevicePosition tl, br;
-        switch (tracking_shape->shape_type)
-        {
-        case eCommonTrackingShapeType::Sphere:
-            {
-                // Simply: center - radius, center + radius.
-                tl.set(tracker_position_cm.x - tracking_shape->shape.sphere.radius_cm,
-                    tracker_position_cm.y + tracking_shape->shape.sphere.radius_cm,
-                    tracker_position_cm.z);
-                br.set(tracker_position_cm.x + tracking_shape->shape.sphere.radius_cm,
-                    tracker_position_cm.y - tracking_shape->shape.sphere.radius_cm,
-                    tracker_position_cm.z);
-            } break;
-
-        case eCommonTrackingShapeType::LightBar:
-            {
-                // Compute the bounding radius of the lightbar tracking shape
-                const auto &shape_tl = tracking_shape->shape.light_bar.quad[CommonDeviceTrackingShape::QuadVertexUpperLeft];
-                const auto &shape_br = tracking_shape->shape.light_bar.quad[CommonDeviceTrackingShape::QuadVertexLowerRight];
-                const CommonDeviceVector half_vec = { (shape_tl.x - shape_br.x)*0.5f, (shape_tl.y - shape_br.y)*0.5f, (shape_tl.z - shape_br.z)*0.5f };
-                const auto shape_radius = fmaxf(sqrtf(half_vec.i*half_vec.i + half_vec.j*half_vec.j + half_vec.k*half_vec.k), 1.f);
-
-                // Simply: center - shape_radius, center + shape_radius.
-                tl.set(tracker_position_cm.x - shape_radius,
-                    tracker_position_cm.y + shape_radius,
-                    tracker_position_cm.z);
-                br.set(tracker_position_cm.x + shape_radius,
-                    tracker_position_cm.y - shape_radius,
-                    tracker_position_cm.z);
-            } break;
-
-        case eCommonTrackingShapeType::PointCloud:
-            {
-                // Compute the bounding radius of the point cloud
-                CommonDevicePosition shape_tl = tracking_shape->shape.point_cloud.point[0];
-                CommonDevicePosition shape_br = tracking_shape->shape.point_cloud.point[0];
-                for (int point_index = 1; point_index < tracking_shape->shape.point_cloud.point_count; ++point_index)
-                {
-                    const CommonDevicePosition &point = tracking_shape->shape.point_cloud.point[point_index];
-                    shape_tl.set(fmaxf(shape_tl.x, point.x), fmaxf(shape_tl.y, point.y), fmaxf(shape_tl.z, point.z));
-                    shape_br.set(fminf(shape_br.x, point.x), fminf(shape_br.y, point.y), fminf(shape_br.z, point.z));
-                }
-                const CommonDeviceVector half_vec = { (shape_tl.x - shape_br.x)*0.5f, (shape_tl.y - shape_br.y)*0.5f, (shape_tl.z - shape_br.z)*0.5f };
-                const auto shape_radius = fmaxf(sqrtf(half_vec.i*half_vec.i + half_vec.j*half_vec.j + half_vec.k*half_vec.k), 1.f);
-
-                // Simply: center - shape_radius, center + shape_radius.
-                tl.set(tracker_position_cm.x - shape_radius,
-                    tracker_position_cm.y + shape_radius,
-                    tracker_position_cm.z);
-                br.set(tracker_position_cm.x + shape_radius,
-                    tracker_position_cm.y - shape_radius,
-                    tracker_position_cm.z);
-            } break;
-
-        default:
-            {
-                assert(false && "unreachable");
-            } break;
-        }
+        tl.set(tracker_position_cm.x - shape_radius_cm,
+            tracker_position_cm.y + shape_radius_cm,
+            tracker_position_cm.z);
+        br.set(tracker_position_cm.x + shape_radius_cm,
+            tracker_position_cm.y - shape_radius_cm,
+            tracker_position_cm.z);
 
         // Extract the pixel projection center from the previous frame's projection.
-        CommonDeviceScreenLocation projection_pixel_center;
-        projection_pixel_center.clear();
-
-        switch (prior_tracking_projection->shape_type)
-        {
-        case eCommonTrackingProjectionType::ProjectionType_Ellipse:
-            {
-                // Use the center of the ellipsoid projection for the ROI area
-                projection_pixel_center = prior_tracking_projection->shape.ellipse.center;
-            } break;
-
-        case eCommonTrackingProjectionType::ProjectionType_LightBar:
-            {
-                // Use the center of the quad projection for the ROI area
-                const auto proj_tl = prior_tracking_projection->shape.lightbar.quad[CommonDeviceTrackingShape::QuadVertexUpperLeft];
-                const auto proj_br = prior_tracking_projection->shape.lightbar.quad[CommonDeviceTrackingShape::QuadVertexLowerRight];
-
-                projection_pixel_center.set(0.5f * (proj_tl.x + proj_br.x), 0.5f * (proj_tl.y + proj_br.y));
-            } break;
-
-        case eCommonTrackingProjectionType::ProjectionType_Points:
-            {
-                // Compute the centroid of the projection pixels
-                for (int point_index = 0; point_index < prior_tracking_projection->shape.points.point_count; ++point_index)
-                {
-                    const auto &pixel = prior_tracking_projection->shape.points.point[point_index];
-
-                    projection_pixel_center.x += pixel.x;
-                    projection_pixel_center.y += pixel.y;
-                }
-                const float N = static_cast<float>(prior_tracking_projection->shape.points.point_count);
-                projection_pixel_center.x /= N;
-                projection_pixel_center.y /= N;
-            } break;
-
-        default:
-            {
-                assert(false && "unreachable");
-            } break;
-        }
+        const CommonDeviceScreenLocation projection_pixel_center = 
+            computeTrackingProjectionPixelCenter(prior_tracking_projection);
 
         // The center of the ROI is the pixel projection center from last frame
         // The size of the ROI computed by projecting the bounding box 
@@ -2471,6 +4104,372 @@ static cv::Rect2i computeTrackerROIForPoseProjection(
     return ROI;
 }
 
+static float computeTrackingShapeBoundingRadiusCm(const CommonDeviceTrackingShape *tracking_shape)
+{
+    float shape_radius_cm = 0.f;
+
+    switch (tracking_shape->shape_type)
+    {
+    case eCommonTrackingShapeType::Sphere:
+        {
+            shape_radius_cm = tracking_shape->shape.sphere.radius_cm;
+        } break;
+
+    case eCommonTrackingShapeType::LightBar:
+        {
+            // Compute the bounding radius of the lightbar tracking shape
+            const auto &shape_tl = tracking_shape->shape.light_bar.quad[CommonDeviceTrackingShape::QuadVertexUpperLeft];
+            const auto &shape_br = tracking_shape->shape.light_bar.quad[CommonDeviceTrackingShape::QuadVertexLowerRight];
+            const CommonDeviceVector half_vec = { (shape_tl.x - shape_br.x)*0.5f, (shape_tl.y - shape_br.y)*0.5f, (shape_tl.z - shape_br.z)*0.5f };
+
+            shape_radius_cm = fmaxf(sqrtf(half_vec.i*half_vec.i + half_vec.j*half_vec.j + half_vec.k*half_vec.k), 1.f);
+        } break;
+
+    case eCommonTrackingShapeType::PointCloud:
+        {
+            // Compute the bounding radius of the point cloud
+            CommonDevicePosition shape_tl = tracking_shape->shape.point_cloud.point[0];
+            CommonDevicePosition shape_br = tracking_shape->shape.point_cloud.point[0];
+            for (int point_index = 1; point_index < tracking_shape->shape.point_cloud.point_count; ++point_index)
+            {
+                const CommonDevicePosition &point = tracking_shape->shape.point_cloud.point[point_index];
+                shape_tl.set(fmaxf(shape_tl.x, point.x), fmaxf(shape_tl.y, point.y), fmaxf(shape_tl.z, point.z));
+                shape_br.set(fminf(shape_br.x, point.x), fminf(shape_br.y, point.y), fminf(shape_br.z, point.z));
+            }
+            const CommonDeviceVector half_vec = { (shape_tl.x - shape_br.x)*0.5f, (shape_tl.y - shape_br.y)*0.5f, (shape_tl.z - shape_br.z)*0.5f };
+
+            shape_radius_cm = fmaxf(sqrtf(half_vec.i*half_vec.i + half_vec.j*half_vec.j + half_vec.k*half_vec.k), 1.f);
+        } break;
+
+    default:
+        {
+            assert(false && "unreachable");
+        } break;
+    }
+
+    return shape_radius_cm;
+}
+
+static CommonDeviceScreenLocation computeTrackingProjectionPixelCenter(
+    const CommonDeviceTrackingProjection *tracking_projection)
+{
+    CommonDeviceScreenLocation projection_pixel_center;
+    projection_pixel_center.clear();
+
+    switch (tracking_projection->shape_type)
+    {
+    case eCommonTrackingProjectionType::ProjectionType_Ellipse:
+        {
+            // Use the center of the ellipsoid projection for the ROI area
+            projection_pixel_center = tracking_projection->shape.ellipse.center;
+        } break;
+
+    case eCommonTrackingProjectionType::ProjectionType_LightBar:
+        {
+            // Use the center of the quad projection for the ROI area
+            const auto proj_tl = tracking_projection->shape.lightbar.quad[CommonDeviceTrackingShape::QuadVertexUpperLeft];
+            const auto proj_br = tracking_projection->shape.lightbar.quad[CommonDeviceTrackingShape::QuadVertexLowerRight];
+
+            projection_pixel_center.set(0.5f * (proj_tl.x + proj_br.x), 0.5f * (proj_tl.y + proj_br.y));
+        } break;
+
+    case eCommonTrackingProjectionType::ProjectionType_Points:
+        {
+            // Compute the centroid of the projection pixels
+            for (int point_index = 0; point_index < tracking_projection->shape.points.point_count; ++point_index)
+            {
+                const auto &pixel = tracking_projection->shape.points.point[point_index];
+
+                projection_pixel_center.x += pixel.x;
+                projection_pixel_center.y += pixel.y;
+            }
+            const float N = static_cast<float>(tracking_projection->shape.points.point_count);
+            projection_pixel_center.x /= N;
+            projection_pixel_center.y /= N;
+        } break;
+
+    default:
+        {
+            assert(false && "unreachable");
+        } break;
+    }
+
+    return projection_pixel_center;
+}
+
+static void computeTrackerSearchWindowsForDevices(
+    const ServerTrackerView *tracker,
+    const std::vector<ServerControllerView *> &tracked_controllers,
+    const std::vector<ServerHMDView *> &tracked_hmds,
+    const int frame_sequence_num,
+    ServiceStatistic *recovery_window_statistic,
+    ServiceStatistic *recovery_full_scan_statistic,
+    std::vector<CommonDeviceTrackingShape> &out_tracking_shapes,
+    std::vector<t_tracker_search_window_list> &out_device_windows)
+{
+    const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
+    const int tracker_id = tracker->getDeviceID();
+    const size_t device_count = tracked_controllers.size() + tracked_hmds.size();
+
+    // Devices this tracker lost only get a full frame scan every few frames
+    const bool bFullScanFrame = 
+        trackerMgrConfig.recovery_full_scan_interval <= 1 ||
+        (frame_sequence_num % trackerMgrConfig.recovery_full_scan_interval) == 0;
+
+    out_tracking_shapes.resize(device_count);
+    out_device_windows.resize(device_count);
+
+    for (size_t controller_index = 0; controller_index < tracked_controllers.size(); ++controller_index)
+    {
+        const ServerControllerView *controller_view = tracked_controllers[controller_index];
+        CommonDeviceTrackingShape &tracking_shape = out_tracking_shapes[controller_index];
+
+        controller_view->getTrackingShape(tracking_shape);
+        computeTrackerSearchWindowsForDevice(
+            tracker,
+            controller_view->getIsROIDisabled(),
+            controller_view->getPoseFilter(),
+            controller_view->getMulticamPoseEstimate(),
+            controller_view->getTrackerPoseEstimate(tracker_id),
+            &tracking_shape,
+            bFullScanFrame,
+            out_device_windows[controller_index]);
+    }
+
+    for (size_t hmd_index = 0; hmd_index < tracked_hmds.size(); ++hmd_index)
+    {
+        const size_t device_index = tracked_controllers.size() + hmd_index;
+        const ServerHMDView *hmd_view = tracked_hmds[hmd_index];
+        CommonDeviceTrackingShape &tracking_shape = out_tracking_shapes[device_index];
+
+        hmd_view->getTrackingShape(tracking_shape);
+        computeTrackerSearchWindowsForDevice(
+            tracker,
+            hmd_view->getIsROIDisabled(),
+            hmd_view->getPoseFilter(),
+            hmd_view->getMulticamPoseEstimate(),
+            hmd_view->getTrackerPoseEstimate(tracker_id),
+            &tracking_shape,
+            bFullScanFrame,
+            out_device_windows[device_index]);
+    }
+
+    applyTrackerRecoveryPixelBudget(trackerMgrConfig.recovery_pixel_budget, out_device_windows);
+
+    // The recovery hit rate is reported as reacquisitions / (recovery_windows + recovery_full_scans)
+    for (const t_tracker_search_window_list &windows : out_device_windows)
+    {
+        for (const TrackerSearchWindow &window : windows)
+        {
+            if (window.bRecoveryHypothesis && recovery_window_statistic != nullptr)
+            {
+                recovery_window_statistic->increment();
+            }
+            else if (window.scan_decimation > 1 && recovery_full_scan_statistic != nullptr)
+            {
+                recovery_full_scan_statistic->increment();
+            }
+        }
+    }
+}
+
+template <typename t_pose_estimate>
+static void computeTrackerSearchWindowsForDevice(
+    const ServerTrackerView *tracker,
+    const bool device_roi_disabled,
+    const IPoseFilter* pose_filter,
+    const t_pose_estimate *multicam_pose_estimate,
+    const t_pose_estimate *tracker_pose_estimate,
+    const CommonDeviceTrackingShape *tracking_shape,
+    const bool bFullScanFrame,
+    t_tracker_search_window_list &out_windows)
+{
+    const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
+    const bool bRoiDisabled = device_roi_disabled || trackerMgrConfig.disable_roi;
+    const bool bIsTracking = tracker_pose_estimate->bCurrentlyTracking;
+
+    out_windows.clear();
+
+    if (bIsTracking || bRoiDisabled || !trackerMgrConfig.use_occlusion_recovery)
+    {
+        // Compute a region of interest in the tracker buffer around where we expect to find the tracking shape
+        out_windows.push_back(
+            TrackerSearchWindow::create(
+                computeTrackerROIForPoseProjection(
+                    bRoiDisabled,
+                    tracker,
+                    bIsTracking ? pose_filter : nullptr,
+                    bIsTracking ? &tracker_pose_estimate->projection : nullptr,
+                    tracking_shape)));
+    }
+    else
+    {
+        // Lost by this tracker: search where it's likely to reappear instead of the whole frame
+        computeTrackerRecoveryWindows(
+            tracker,
+            pose_filter,
+            multicam_pose_estimate->last_visible_timestamp,
+            tracker_pose_estimate->last_visible_timestamp,
+            &tracker_pose_estimate->projection,
+            tracking_shape,
+            bFullScanFrame,
+            out_windows);
+    }
+}
+
+static void computeTrackerRecoveryWindows(
+    const ServerTrackerView *tracker,
+    const IPoseFilter* pose_filter,
+    const std::chrono::time_point<std::chrono::high_resolution_clock> &last_visible_timestamp,
+    const std::chrono::time_point<std::chrono::high_resolution_clock> &tracker_last_visible_timestamp,
+    const CommonDeviceTrackingProjection *tracker_last_projection,
+    const CommonDeviceTrackingShape *tracking_shape,
+    const bool bFullScanFrame,
+    t_tracker_search_window_list &out_windows)
+{
+    const TrackerManagerConfig &trackerMgrConfig= DeviceManager::getInstance()->m_tracker_manager->getConfig();
+    const std::chrono::time_point<std::chrono::high_resolution_clock> never_visible;
+    const std::chrono::time_point<std::chrono::high_resolution_clock> now= std::chrono::high_resolution_clock::now();
+    const float shape_radius_cm = computeTrackingShapeBoundingRadiusCm(tracking_shape);
+
+    float screenWidth, screenHeight;
+    tracker->getPixelDimensions(screenWidth, screenHeight);
+    const cv::Rect2i frame_rect(0, 0, static_cast<int>(screenWidth), static_cast<int>(screenHeight));
+
+    // The hypotheses grow with the distance the device could have drifted from them since it was last seen,
+    // until they are too stale to be worth searching
+    if (pose_filter != nullptr && last_visible_timestamp != never_visible)
+    {
+        const std::chrono::duration<float> time_lost = now - last_visible_timestamp;
+
+        if (time_lost.count() < trackerMgrConfig.recovery_max_dead_reckoning_time)
+        {
+            // 1) Around the position the pose filter dead reckons from the IMU (or the trackers that can still see it).
+            // When that projects off screen, the part of the window left on screen is where the device would re-enter.
+            const float uncertainty_cm = shape_radius_cm + trackerMgrConfig.recovery_drift_cm_per_second*time_lost.count();
+            const Eigen::Vector3f position_cm = pose_filter->getPositionCm(0.f);
+            CommonDevicePosition world_position_cm;
+            world_position_cm.set(position_cm.x(), position_cm.y(), position_cm.z());
+
+            const CommonDevicePosition tracker_position_cm = tracker->computeTrackerPosition(&world_position_cm);
+
+            // Nothing to project if the device could be behind the camera
+            if (tracker_position_cm.z > uncertainty_cm)
+            {
+                std::vector<CommonDevicePosition> trps(2);
+                trps[0].set(tracker_position_cm.x - uncertainty_cm, tracker_position_cm.y + uncertainty_cm, tracker_position_cm.z);
+                trps[1].set(tracker_position_cm.x + uncertainty_cm, tracker_position_cm.y - uncertainty_cm, tracker_position_cm.z);
+                const std::vector<CommonDeviceScreenLocation> screen_locs = tracker->projectTrackerRelativePositions(trps);
+
+                const cv::Point2i roi_center(
+                    static_cast<int>(0.5f*(screen_locs[0].x + screen_locs[1].x)),
+                    static_cast<int>(0.5f*(screen_locs[0].y + screen_locs[1].y)));
+                const int half_width = std::max(static_cast<int>(0.5f*fabsf(screen_locs[1].x - screen_locs[0].x)), k_min_roi_size);
+                const int half_height = std::max(static_cast<int>(0.5f*fabsf(screen_locs[1].y - screen_locs[0].y)), k_min_roi_size);
+                const cv::Rect2i ROI = 
+                    cv::Rect2i(roi_center - cv::Point2i(half_width, half_height), cv::Size(2*half_width, 2*half_height))
+                    & frame_rect;
+
+                if (ROI.area() > 0)
+                {
+                    out_windows.push_back(TrackerSearchWindow::create(ROI, 1, true));
+                }
+            }
+
+            // 2) Around where this tracker last saw the device, it often comes back the way it left
+            const std::chrono::duration<float> time_lost_here = now - tracker_last_visible_timestamp;
+
+            if (tracker_last_visible_timestamp != never_visible &&
+                time_lost_here.count() < trackerMgrConfig.recovery_max_dead_reckoning_time &&
+                tracker_last_projection->shape_type != eCommonTrackingProjectionType::INVALID_PROJECTION &&
+                tracker_last_projection->screen_area > 0.f)
+            {
+                // Scale the drift by the size the shape had on screen when it was last seen
+                const CommonDeviceScreenLocation last_center = computeTrackingProjectionPixelCenter(tracker_last_projection);
+                const float pixels_per_cm = 0.5f*sqrtf(tracker_last_projection->screen_area) / shape_radius_cm;
+                const float uncertainty_px =
+                    pixels_per_cm*(shape_radius_cm + trackerMgrConfig.recovery_drift_cm_per_second*time_lost_here.count());
+                const int half_size = std::max(static_cast<int>(uncertainty_px), k_min_roi_size);
+                const cv::Rect2i ROI = 
+                    cv::Rect2i(
+                        static_cast<int>(last_center.x) - half_size, static_cast<int>(last_center.y) - half_size,
+                        2*half_size, 2*half_size)
+                    & frame_rect;
+
+                // Skip it if the first hypothesis already covers it
+                if (ROI.area() > 0 && (out_windows.empty() || (ROI & out_windows.back().ROI) != ROI))
+                {
+                    out_windows.push_back(TrackerSearchWindow::create(ROI, 1, true));
+                }
+            }
+        }
+    }
+
+    // 3) Every so often look over the whole frame, in case the device came back somewhere unexpected
+    if (bFullScanFrame)
+    {
+        out_windows.push_back(
+            TrackerSearchWindow::create(frame_rect, std::max(trackerMgrConfig.recovery_full_scan_decimation, 1)));
+    }
+}
+
+static void applyTrackerRecoveryPixelBudget(
+    const int pixel_budget,
+    std::vector<t_tracker_search_window_list> &device_windows)
+{
+    // Hand out the budget a rank at a time, so every lost device gets its best hypothesis searched first
+    size_t rank_count = 0;
+    for (const t_tracker_search_window_list &windows : device_windows)
+    {
+        rank_count = std::max(rank_count, windows.size());
+    }
+
+    int remaining_budget = std::max(pixel_budget, 0);
+    for (size_t rank = 0; rank < rank_count; ++rank)
+    {
+        for (t_tracker_search_window_list &windows : device_windows)
+        {
+            if (rank >= windows.size() || !windows[rank].bRecoveryHypothesis)
+            {
+                continue;
+            }
+
+            cv::Rect2i &ROI = windows[rank].ROI;
+            if (ROI.area() > remaining_budget)
+            {
+                // Shrink the window around its center to what's left of the budget
+                const float scale = sqrtf(static_cast<float>(remaining_budget) / static_cast<float>(ROI.area()));
+                const cv::Size shrunk_size(
+                    static_cast<int>(static_cast<float>(ROI.width)*scale),
+                    static_cast<int>(static_cast<float>(ROI.height)*scale));
+
+                if (shrunk_size.width >= k_min_roi_size && shrunk_size.height >= k_min_roi_size)
+                {
+                    ROI = cv::Rect2i(
+                        ROI.x + (ROI.width - shrunk_size.width)/2, ROI.y + (ROI.height - shrunk_size.height)/2,
+                        shrunk_size.width, shrunk_size.height);
+                }
+                else
+                {
+                    ROI = cv::Rect2i(0, 0, 0, 0);
+                }
+            }
+
+            remaining_budget -= ROI.area();
+        }
+    }
+
+    // Drop the hypotheses the budget didn't stretch to
+    for (t_tracker_search_window_list &windows : device_windows)
+    {
+        windows.erase(
+            std::remove_if(
+                windows.begin(), windows.end(),
+                [](const TrackerSearchWindow &window) { return window.ROI.area() <= 0; }),
+            windows.end());
+    }
+}
+
 static bool computeBestFitTriangleForContour(
     const t_opencv_float_contour &opencv_contour,
     cv::Point2f &out_triangle_top,
@@ -2563,68 +4562,66 @@ static bool computeBestFitTriangleForContour(
     return true;
 }
 
-static bool computeBestFitQuadForContour(
+static bool computeBestFitLightBarForContourFromPrior(
     const t_opencv_float_contour &opencv_contour,
-    const cv::Point2f &up_hint, 
-    const cv::Point2f &right_hint,
-    cv::Point2f &top_right,
-    cv::Point2f &top_left,
-    cv::Point2f &bottom_left,
-    cv::Point2f &bottom_right)
+    const CommonDeviceTrackingShape *tracking_shape,
+    const CommonDeviceTrackingProjection *prior_projection,
+    cv::Point2f &out_triangle_top,
+    cv::Point2f &out_triangle_bottom_left,
+    cv::Point2f &out_triangle_bottom_right,
+    cv::Point2f &out_quad_top_right,
+    cv::Point2f &out_quad_top_left,
+    cv::Point2f &out_quad_bottom_left,
+    cv::Point2f &out_quad_bottom_right)
 {
-    // Compute the tightest possible bounding triangle for the given contour
-    cv::RotatedRect cv_min_box= cv::minAreaRect(opencv_contour);
-
-    if (cv_min_box.size.width <= k_real_epsilon || cv_min_box.size.height <= k_real_epsilon)
+    const CommonDeviceScreenLocation *prior_quad= prior_projection->shape.lightbar.quad;
+    const cv::Point2f prior_top_right(
+        prior_quad[CommonDeviceTrackingShape::QuadVertexUpperRight].x, prior_quad[CommonDeviceTrackingShape::QuadVertexUpperRight].y);
+    const cv::Point2f prior_top_left(
+        prior_quad[CommonDeviceTrackingShape::QuadVertexUpperLeft].x, prior_quad[CommonDeviceTrackingShape::QuadVertexUpperLeft].y);
+    const cv::Point2f prior_bottom_left(
+        prior_quad[CommonDeviceTrackingShape::QuadVertexLowerLeft].x, prior_quad[CommonDeviceTrackingShape::QuadVertexLowerLeft].y);
+    const cv::Point2f prior_bottom_right(
+        prior_quad[CommonDeviceTrackingShape::QuadVertexLowerRight].x, prior_quad[CommonDeviceTrackingShape::QuadVertexLowerRight].y);
+
+    if (!computeBestFitQuadForContourFromPrior(
+            opencv_contour,
+            prior_top_right, prior_top_left, prior_bottom_left, prior_bottom_right,
+            out_quad_top_right, out_quad_top_left, out_quad_bottom_left, out_quad_bottom_right))
     {
         return false;
     }
 
-    float half_width, half_height;
-    float radians;
-    if (cv_min_box.size.width > cv_min_box.size.height)
-    {
-        half_width= cv_min_box.size.width / 2.f;
-        half_height= cv_min_box.size.height / 2.f;
-        radians= cv_min_box.angle*k_degrees_to_radians;
-    }
-    else
-    {
-        half_width= cv_min_box.size.height / 2.f;
-        half_height= cv_min_box.size.width / 2.f;
-        radians= (cv_min_box.angle + 90.f)*k_degrees_to_radians;
-    }
-
-    cv::Point2f quad_half_right, quad_half_up;
+    // The triangle isn't fit on this path.
+    // Map the model triangle into the image through the homography of the quad instead.
+    cv::Point2f model_quad[CommonDeviceTrackingShape::QuadVertexCount];
+    for (int corner_index= 0; corner_index < CommonDeviceTrackingShape::QuadVertexCount; ++corner_index)
     {
-        const float cos_angle= cosf(radians);
-        const float sin_angle= sinf(radians);
-
-        quad_half_right.x= half_width*cos_angle;
-        quad_half_right.y= half_width*sin_angle;
+        const CommonDevicePosition &corner= tracking_shape->shape.light_bar.quad[corner_index];
 
-        quad_half_up.x= -half_height*sin_angle;
-        quad_half_up.y= half_height*cos_angle;
+        model_quad[corner_index]= cv::Point2f(corner.x, corner.y);
     }
 
-    if (quad_half_up.dot(up_hint) < 0)
-    {
-        // up axis is flipped
-        // flip the box vertically
-        quad_half_up= -quad_half_up;
-    }
+    cv::Point2f image_quad[CommonDeviceTrackingShape::QuadVertexCount];
+    image_quad[CommonDeviceTrackingShape::QuadVertexUpperRight]= out_quad_top_right;
+    image_quad[CommonDeviceTrackingShape::QuadVertexUpperLeft]= out_quad_top_left;
+    image_quad[CommonDeviceTrackingShape::QuadVertexLowerLeft]= out_quad_bottom_left;
+    image_quad[CommonDeviceTrackingShape::QuadVertexLowerRight]= out_quad_bottom_right;
 
-    if (quad_half_right.dot(right_hint) < 0)
+    std::vector<cv::Point2f> model_triangle;
+    for (int corner_index= 0; corner_index < CommonDeviceTrackingShape::TriVertexCount; ++corner_index)
     {
-        // right axis is flipped
-        // flip the box horizontally
-        quad_half_right= -quad_half_right;
+        const CommonDevicePosition &corner= tracking_shape->shape.light_bar.triangle[corner_index];
+
+        model_triangle.push_back(cv::Point2f(corner.x, corner.y));
     }
 
-    top_right= cv_min_box.center + quad_half_up + quad_half_right;
-    top_left= cv_min_box.center + quad_half_up - quad_half_right;
-    bottom_right= cv_min_box.center - quad_half_up + quad_half_right;
-    bottom_left= cv_min_box.center - quad_half_up - quad_half_right;
+    std::vector<cv::Point2f> image_triangle;
+    cv::perspectiveTransform(model_triangle, image_triangle, cv::getPerspectiveTransform(model_quad, image_quad));
+
+    out_triangle_top= image_triangle[CommonDeviceTrackingShape::TriVertexUpperMiddle];
+    out_triangle_bottom_left= image_triangle[CommonDeviceTrackingShape::TriVertexLowerLeft];
+    out_triangle_bottom_right= image_triangle[CommonDeviceTrackingShape::TriVertexLowerRight];
 
     return true;
 }
@@ -4,6 +4,7 @@
 //-- includes -----
 #include "ServerDeviceView.h"
 #include "PSMoveProtocolInterface.h"
+#include "TrackerExposureController.h"
 #include <vector>
 
 // -- pre-declarations -----
@@ -13,7 +14,65 @@ namespace PSMoveProtocol
     class TrackingColorPreset;
 };
 
+struct RemoteTrackerTarget;
+struct RemoteTrackerProjection;
+struct TrackerPipelineCameraParams;
+
 // -- declarations -----
+struct TrackerStatistics
+{
+    // HSV conversion of the last video frame
+    int hsv_pixels_requested; // pixels covered by the device ROIs, overlaps counted once per ROI
+    int hsv_pixels_converted; // pixels actually converted (tile granularity, each at most once)
+
+    // Image processing memory
+    size_t working_buffer_bytes; // this tracker's HSV and mask buffers (sized to the ROIs)
+    size_t shared_hsv_lut_bytes; // BGR->HSV lookup table shared by all trackers (0 when disabled)
+
+    // Brightness of the devices found in the last video frame (HSV value, 0-255).
+    // Only measured with TrackerManagerConfig::use_auto_exposure on.
+    int exposure_sample_count; // devices measured
+    float bulb_value; // mean value of the pixels in the devices' color ranges
+    float bulb_clipped_fraction; // fraction of the devices' bounding boxes at full brightness
+    float background_value; // mean value of the rest of the ROIs the devices were found in
+
+    // Adaptive exposure control
+    eTrackerExposureDecision exposure_decision; // what the control last decided
+    float exposure; // current camera settings
+    float gain;
+
+    inline void clear()
+    {
+        hsv_pixels_requested = 0;
+        hsv_pixels_converted = 0;
+        working_buffer_bytes = 0;
+        shared_hsv_lut_bytes = 0;
+        exposure_sample_count = 0;
+        bulb_value = 0.f;
+        bulb_clipped_fraction = 0.f;
+        background_value = 0.f;
+        exposure_decision = _TrackerExposureDecision_Disabled;
+        exposure = 0.f;
+        gain = 0.f;
+    }
+};
+
+// Video sent compressed to a client watching the tracker over the network
+enum eTrackerVideoStreamMode
+{
+    _TrackerVideoStreamMode_JPEGFrame, // whole frame as a JPEG
+    _TrackerVideoStreamMode_JPEGROI,   // JPEG of the bounding box of the regions searched this frame
+    _TrackerVideoStreamMode_Mask,      // PNG of the color filter mask in the regions searched this frame
+};
+
+struct TrackerVideoStreamSettings
+{
+    eTrackerVideoStreamMode mode;
+    int max_fps;      // <= 0 to send every frame
+    int max_kbps;     // <= 0 for no bitrate cap
+    int jpeg_quality; // 1-100
+};
+
 class ServerTrackerView : public ServerDeviceView
 {
 public:
@@ -28,11 +87,23 @@ public:
     void startSharedMemoryVideoStream();
     void stopSharedMemoryVideoStream();
 
+    // Starts or stops sending the video feed to a connection as compressed TRACKER_VIDEO_FRAME notifications.
+    // Starting again replaces the connection's stream settings.
+    void startNetworkVideoStream(int connection_id, const TrackerVideoStreamSettings &settings);
+    void stopNetworkVideoStream(int connection_id);
+
     // Fetch the next video frame and copy to shared memory
     bool poll() override;
 
     IDeviceInterface* getDevice() const override {return m_device;}
 
+    // Get the processing statistics for the last video frame
+    inline const TrackerStatistics &getStatistics() const { return m_statistics; }
+
+    // True if video frames are searched on the tracker's optical pipeline thread,
+    // in which case projections can become available between video frames
+    inline bool getHasOpticalPipeline() const { return m_optical_pipeline != nullptr; }
+
     // Returns what type of tracker this tracker view represents
     CommonDeviceState::eDeviceType getTrackerDeviceType() const;
 
@@ -63,14 +134,19 @@ public:
     double getGain() const;
     void setGain(double value, bool bUpdateConfig);
     
-    bool computeProjectionForController(
-        const class ServerControllerView* tracked_controller, 
-		const struct CommonDeviceTrackingShape *tracking_shape,
-        struct ControllerOpticalPoseEstimation *out_pose_estimate);
-    bool computeProjectionForHMD(
-		const class ServerHMDView* tracked_hmd,
-		const struct CommonDeviceTrackingShape *tracking_shape,
-		struct HMDOpticalPoseEstimation *out_pose_estimate);
+    /// Find the projections of all of the tracked devices in the latest video frame.
+    /// The ROIs of all devices are converted to HSV together (overlapping ROIs only once)
+    /// and each projection found is handed to its device with setTrackerProjection().
+    /// With the optical pipeline enabled the search runs on the pipeline thread and the projections
+    /// handed to the devices are the ones it finished since the last call.
+    void computeProjectionsForTrackedDevices(
+        const std::vector<class ServerControllerView *> &tracked_controllers,
+        const std::vector<class ServerHMDView *> &tracked_hmds);
+    /// Tracker node mode: find the targets the central service asked for in the latest video frame.
+    /// Only sphere and lightbar targets are searched for.
+    void computeProjectionsForRemoteTargets(
+        const std::vector<RemoteTrackerTarget> &targets,
+        std::vector<RemoteTrackerProjection> &out_projections);
     bool computePoseForProjection(
 		const struct CommonDeviceTrackingProjection *projection,
 		const struct CommonDeviceTrackingShape *tracking_shape,
@@ -139,19 +215,90 @@ public:
 	void getHMDTrackingColorPreset(const class ServerHMDView *controller, eCommonTrackingColorID color, CommonHSVColorRange *out_preset) const;
 
 protected:
+    // Find the device's projection in the currently applied ROI
+    bool computeProjectionForController(
+        const class ServerControllerView* tracked_controller, 
+		const struct CommonDeviceTrackingShape *tracking_shape,
+        struct ControllerOpticalPoseEstimation *out_pose_estimate);
+    bool computeProjectionForHMD(
+		const class ServerHMDView* tracked_hmd,
+		const struct CommonDeviceTrackingShape *tracking_shape,
+		struct HMDOpticalPoseEstimation *out_pose_estimate);
+    // Find the biggest blob of the given color in the currently applied ROI
+    // and compute its sphere or lightbar projection
+    bool computeProjectionForColorRange(
+        const CommonHSVColorRange &hsvColorRange,
+        const struct CommonDeviceTrackingShape *tracking_shape,
+        bool bRoiDisabled,
+        struct ControllerOpticalPoseEstimation *out_pose_estimate);
+    // Search the latest video frame for the tracked devices on the calling thread
+    void computeLocalProjectionsForTrackedDevices(
+        const std::vector<class ServerControllerView *> &tracked_controllers,
+        const std::vector<class ServerHMDView *> &tracked_hmds);
+    // Optical pipeline: hand the projections the pipeline finished to the tracked devices
+    // and queue the latest video frame for it
+    void computePipelinedProjectionsForTrackedDevices(
+        const std::vector<class ServerControllerView *> &tracked_controllers,
+        const std::vector<class ServerHMDView *> &tracked_hmds);
+    // Remote trackers: hand the projections the tracker node found in its latest frame
+    // to the tracked devices and tell the node where to look next
+    void computeRemoteProjectionsForTrackedDevices(
+        const std::vector<class ServerControllerView *> &tracked_controllers,
+        const std::vector<class ServerHMDView *> &tracked_hmds);
+    // What to search for on behalf of the tracked devices (a tracker node or the optical pipeline).
+    // Devices this tracker lost get several targets, best first, see TrackerManagerConfig::use_occlusion_recovery.
+    // Point cloud HMDs need their prior pose and are left out.
+    void computeTargetsForTrackedDevices(
+        const std::vector<class ServerControllerView *> &tracked_controllers,
+        const std::vector<class ServerHMDView *> &tracked_hmds,
+        const int frame_sequence_num,
+        std::vector<RemoteTrackerTarget> &out_targets) const;
+    // Count a device found by this tracker after it lost it
+    void recordReacquisition(bool bWasTracking);
+    // Hand the exposure measured in the given video frame (now in the statistics) to the exposure control, once per frame
+    void addExposureSample(int frame_sequence_num);
+    // Apply any adjustment the exposure control makes and report it in the statistics,
+    // see TrackerManagerConfig::use_auto_exposure
+    void updateExposureControl();
+    // Snapshot of the camera state needed to search a video frame off of the main thread
+    void getPipelineCameraParams(TrackerPipelineCameraParams &out_params) const;
+
     bool allocate_device_interface(const class DeviceEnumerator *enumerator) override;
     void free_device_interface() override;
     void publish_device_data_frame() override;
     static void generate_tracker_data_frame_for_stream(
         const ServerTrackerView *tracker_view, const struct TrackerStreamInfo *stream_info,
         DeviceOutputDataFramePtr &data_frame);
+    void publish_network_video_frames();
 
 private:
     char m_shared_memory_name[256];
     class SharedVideoFrameReadWriteAccessor *m_shared_memory_accesor;
     int m_shared_memory_video_stream_count;
+    class TrackerVideoEncoder *m_video_encoder;
+    int m_network_video_sequence_number; // last frame handed to the video encoder
     class OpenCVBufferState *m_opencv_buffer_state;
+    class TrackerOpticalPipeline *m_optical_pipeline; // only when enabled in the TrackerManagerConfig
+    int m_optical_pipeline_sequence_number; // last frame queued on the optical pipeline
+    TrackerStatistics m_statistics;
+    TrackerExposureController *m_exposure_controller; // only when enabled in the TrackerManagerConfig
+    int m_exposure_sequence_number; // last frame measured for the exposure control
     ITrackerInterface *m_device;
+
+    // Service statistics, registered while the tracker is open
+    class ServiceStatistic *m_frame_statistic;
+    class ServiceStatistic *m_dropped_frame_statistic;
+    class ServiceStatistic *m_roi_search_statistic;
+    class ServiceStatistic *m_roi_hit_statistic;
+    class ServiceStatistic *m_remote_frame_age_statistic;
+    class ServiceStatistic *m_network_video_bytes_statistic;
+    class ServiceStatistic *m_lightbar_fast_pose_statistic; // lightbar poses solved by the warm started fast path
+    class ServiceStatistic *m_lightbar_full_pose_statistic; // lightbar poses solved by the full solvePnP fit
+    class ServiceStatistic *m_recovery_window_statistic; // windows searched where a lost device was expected to reappear
+    class ServiceStatistic *m_recovery_full_scan_statistic; // decimated full frame scans for lost devices
+    class ServiceStatistic *m_reacquisition_statistic; // lost devices found again
+    class ServiceStatistic *m_exposure_adjustment_statistic; // exposure or gain changes made by the exposure control
+    int m_last_device_dropped_frame_count;
 };
 
 #endif // SERVER_TRACKER_VIEW_H
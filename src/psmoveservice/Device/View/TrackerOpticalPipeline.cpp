@@ -0,0 +1,195 @@
+//-- includes -----
+#include "TrackerOpticalPipeline.h"
+#include "ServerLog.h"
+#include "ServiceStatistics.h"
+
+#include <algorithm>
+#include <string>
+
+//-- constants -----
+static const std::chrono::milliseconds k_worker_idle_timeout(100);
+
+// -- helper functions -----
+static long long microseconds_between(const t_tracker_pipeline_time &start, const t_tracker_pipeline_time &end)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+//-- public implementation -----
+TrackerOpticalPipeline::TrackerOpticalPipeline(
+    int tracker_id,
+    int queue_depth,
+    const t_process_function &process_function)
+    : WorkerThread("TrackerPipeline" + std::to_string(tracker_id))
+    , m_process_function(process_function)
+    , m_job_queue(static_cast<size_t>(std::max(queue_depth, 1)))
+    , m_result_queue(static_cast<size_t>(std::max(queue_depth, 1)))
+    , m_overflow_job()
+    , m_bHasOverflowJob(false)
+    , m_result()
+    , m_bHasOverflowResult(false)
+{
+    const std::string statistic_prefix = "tracker." + std::to_string(tracker_id) + ".pipeline";
+
+    m_queue_latency_statistic = ServiceStatistics::registerGauge(statistic_prefix + ".queue_us");
+    m_process_latency_statistic = ServiceStatistics::registerGauge(statistic_prefix + ".process_us");
+    m_fuse_latency_statistic = ServiceStatistics::registerGauge(statistic_prefix + ".fuse_us");
+    m_total_latency_statistic = ServiceStatistics::registerGauge(statistic_prefix + ".total_us");
+    m_dropped_job_statistic = ServiceStatistics::registerCounter(statistic_prefix + ".dropped_jobs");
+    m_dropped_result_statistic = ServiceStatistics::registerCounter(statistic_prefix + ".dropped_results");
+    m_backpressure_statistic = ServiceStatistics::registerCounter(statistic_prefix + ".backpressure");
+
+    startThread();
+}
+
+TrackerOpticalPipeline::~TrackerOpticalPipeline()
+{
+    stopThread();
+
+    ServiceStatistics::releaseStatistic(m_queue_latency_statistic);
+    ServiceStatistics::releaseStatistic(m_process_latency_statistic);
+    ServiceStatistics::releaseStatistic(m_fuse_latency_statistic);
+    ServiceStatistics::releaseStatistic(m_total_latency_statistic);
+    ServiceStatistics::releaseStatistic(m_dropped_job_statistic);
+    ServiceStatistics::releaseStatistic(m_dropped_result_statistic);
+    ServiceStatistics::releaseStatistic(m_backpressure_statistic);
+}
+
+void TrackerOpticalPipeline::submitJob(TrackerPipelineJob &job)
+{
+    job.submit_time = std::chrono::high_resolution_clock::now();
+
+    // The newest job always takes the overflow slot, dropping the job that was waiting there
+    if (m_bHasOverflowJob)
+    {
+        m_dropped_job_statistic->increment();
+    }
+    m_overflow_job = std::move(job);
+    m_bHasOverflowJob = true;
+
+    if (!flushOverflowJob())
+    {
+        // The process stage is behind and its queue is full
+        m_backpressure_statistic->increment();
+    }
+}
+
+bool TrackerOpticalPipeline::fetchLatestResult(TrackerPipelineResult &out_result)
+{
+    // Retry a job held back by a full queue now that the worker may have caught up
+    if (m_bHasOverflowJob)
+    {
+        flushOverflowJob();
+    }
+
+    if (!m_result_queue.try_dequeue(out_result))
+    {
+        return false;
+    }
+
+    // Only the newest result is fused
+    while (m_result_queue.try_dequeue(out_result))
+    {
+        m_dropped_result_statistic->increment();
+    }
+
+    return true;
+}
+
+void TrackerOpticalPipeline::notifyResultFused(const TrackerPipelineResult &result)
+{
+    const t_tracker_pipeline_time now = std::chrono::high_resolution_clock::now();
+
+    m_fuse_latency_statistic->set(microseconds_between(result.process_end_time, now));
+    m_total_latency_statistic->set(microseconds_between(result.submit_time, now));
+}
+
+//-- protected implementation -----
+bool TrackerOpticalPipeline::doWork()
+{
+    TrackerPipelineJob job;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_work_available.wait_for(
+            lock, k_worker_idle_timeout,
+            [this]() { return m_exitSignaled.load() || m_job_queue.peek() != nullptr; });
+
+        if (m_exitSignaled)
+        {
+            return false;
+        }
+    }
+
+    // Retry a result held back by a full queue now that the main thread may have caught up
+    if (m_bHasOverflowResult && m_result_queue.try_enqueue(m_result))
+    {
+        m_bHasOverflowResult = false;
+    }
+
+    if (!m_job_queue.try_dequeue(job))
+    {
+        return true;
+    }
+
+    // Drop the oldest jobs if the main thread got ahead of us
+    while (m_job_queue.try_dequeue(job))
+    {
+        m_dropped_job_statistic->increment();
+    }
+
+    // The newer result replaces one still waiting for room in the queue
+    if (m_bHasOverflowResult)
+    {
+        m_dropped_result_statistic->increment();
+        m_bHasOverflowResult = false;
+    }
+
+    m_result.frame_sequence_num = job.frame_sequence_num;
+    m_result.projections.clear();
+    m_result.statistics.clear();
+    m_result.submit_time = job.submit_time;
+    m_result.process_start_time = std::chrono::high_resolution_clock::now();
+
+    m_process_function(job, m_result);
+
+    m_result.process_end_time = std::chrono::high_resolution_clock::now();
+
+    m_queue_latency_statistic->set(microseconds_between(m_result.submit_time, m_result.process_start_time));
+    m_process_latency_statistic->set(microseconds_between(m_result.process_start_time, m_result.process_end_time));
+
+    // The main thread drains the queue every update, so it's only full when the main thread stalls.
+    // Hold onto the result until there is room rather than blocking the process stage.
+    if (!m_result_queue.try_enqueue(m_result))
+    {
+        m_bHasOverflowResult = true;
+    }
+
+    return true;
+}
+
+void TrackerOpticalPipeline::onThreadHaltBegin()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_work_available.notify_all();
+}
+
+//-- private implementation -----
+bool TrackerOpticalPipeline::flushOverflowJob()
+{
+    if (!m_job_queue.try_enqueue(m_overflow_job))
+    {
+        return false;
+    }
+
+    m_overflow_job = TrackerPipelineJob();
+    m_bHasOverflowJob = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_work_available.notify_one();
+    }
+
+    return true;
+}
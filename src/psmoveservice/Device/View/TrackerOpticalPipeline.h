@@ -0,0 +1,118 @@
+#ifndef TRACKER_OPTICAL_PIPELINE_H
+#define TRACKER_OPTICAL_PIPELINE_H
+
+//-- includes -----
+#include "RemoteTracker.h"
+#include "ServerTrackerView.h"
+#include "VideoFramePool.h"
+#include "WorkerThread.h"
+#include "readerwriterqueue.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+//-- definitions -----
+typedef std::chrono::time_point<std::chrono::high_resolution_clock> t_tracker_pipeline_time;
+
+/// Camera state the process stage needs.
+/// Copied on the main thread so the worker never reads the tracker while it's being reconfigured.
+struct TrackerPipelineCameraParams
+{
+    float focal_length_x, focal_length_y;
+    float principal_x, principal_y;
+    float distortion_k1, distortion_k2, distortion_k3;
+    float distortion_p1, distortion_p2;
+    float pixel_width, pixel_height;
+    float min_valid_projection_area;
+    bool bRoiDisabled;
+    bool bUseBGRToHSVLookupTable;
+    bool bUseLightBarFastPath;
+    bool bMeasureExposure; // measure the found blobs for the tracker's exposure control
+};
+
+/// A video frame and the devices to look for in it (main thread -> process stage)
+struct TrackerPipelineJob
+{
+    VideoFrameRef video_frame;
+    int frame_sequence_num;
+    int frame_width;
+    int frame_height;
+    TrackerPipelineCameraParams camera_params;
+    std::vector<RemoteTrackerTarget> targets;
+    t_tracker_pipeline_time submit_time;
+};
+
+/// The projections found in one video frame (process stage -> main thread)
+struct TrackerPipelineResult
+{
+    int frame_sequence_num;
+    std::vector<RemoteTrackerProjection> projections;
+    TrackerStatistics statistics;
+    t_tracker_pipeline_time submit_time;
+    t_tracker_pipeline_time process_start_time;
+    t_tracker_pipeline_time process_end_time;
+};
+
+/// Runs the image processing (HSV, contours, shape fit) of a tracker's video frames on a worker thread
+/// so that frame N is processed while frame N+1 is being captured and frame N-1 is fused.
+///   capture: the tracker device's own thread, hands frames to ServerTrackerView::poll()
+///   process: this worker thread, fed by a bounded SPSC queue of jobs
+///   fuse: the main thread, which applies results to the devices' pose filters and publishes them
+/// Both queues drop the oldest entries: a stage that falls behind only works on the newest frame.
+/// When a queue is full its producer holds the newest entry in a single overflow slot (back-pressure),
+/// replacing any older entry already waiting there, and retries on its next update.
+/// Per-stage latencies are published as "tracker.<id>.pipeline.*" gauges.
+class TrackerOpticalPipeline : public WorkerThread
+{
+public:
+    typedef std::function<void(const TrackerPipelineJob &job, TrackerPipelineResult &out_result)> t_process_function;
+
+    TrackerOpticalPipeline(int tracker_id, int queue_depth, const t_process_function &process_function);
+    virtual ~TrackerOpticalPipeline();
+
+    /// Main thread: queue a video frame for the process stage
+    void submitJob(TrackerPipelineJob &job);
+
+    /// Main thread: get the newest result the process stage finished, older unfetched results are dropped.
+    /// Returns false if nothing finished since the last call.
+    bool fetchLatestResult(TrackerPipelineResult &out_result);
+
+    /// Main thread: the fuse stage is done with a result, records the end to end latency
+    void notifyResultFused(const TrackerPipelineResult &result);
+
+protected:
+    bool doWork() override;
+    void onThreadHaltBegin() override;
+
+private:
+    bool flushOverflowJob();
+
+    t_process_function m_process_function;
+
+    // Multi-threaded state
+    moodycamel::ReaderWriterQueue<TrackerPipelineJob> m_job_queue; // main -> worker
+    moodycamel::ReaderWriterQueue<TrackerPipelineResult> m_result_queue; // worker -> main
+    std::mutex m_mutex;
+    std::condition_variable m_work_available;
+
+    // Main thread state
+    TrackerPipelineJob m_overflow_job;
+    bool m_bHasOverflowJob;
+
+    // Worker thread state
+    TrackerPipelineResult m_result;
+    bool m_bHasOverflowResult;
+
+    // Service statistics
+    class ServiceStatistic *m_queue_latency_statistic;   // submit -> process start
+    class ServiceStatistic *m_process_latency_statistic; // process start -> process end
+    class ServiceStatistic *m_fuse_latency_statistic;    // process end -> fused on the main thread
+    class ServiceStatistic *m_total_latency_statistic;   // submit -> fused
+    class ServiceStatistic *m_dropped_job_statistic;
+    class ServiceStatistic *m_dropped_result_statistic;
+    class ServiceStatistic *m_backpressure_statistic;
+};
+
+#endif // TRACKER_OPTICAL_PIPELINE_H
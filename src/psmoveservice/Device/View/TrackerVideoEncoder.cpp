@@ -0,0 +1,318 @@
+//-- includes -----
+#include "TrackerVideoEncoder.h"
+#include "ServerLog.h"
+
+#include "opencv2/opencv.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+//-- constants -----
+static const int k_min_adaptive_jpeg_quality = 20;
+static const int k_png_compression_level = 3;
+
+//-- private definitions -----
+struct TrackerVideoEncoder::TrackerVideoStream
+{
+    int connection_id;
+    TrackerVideoStreamSettings settings;
+
+    // Main thread state
+    std::chrono::steady_clock::time_point next_frame_time;
+    std::chrono::steady_clock::time_point last_budget_time;
+    double byte_budget; // bytes that can be sent before hitting the bitrate cap (at most one second worth)
+    int jpeg_quality; // lowered below the requested quality while the frames don't fit in the bitrate cap
+    bool bBusy; // a frame was submitted and hasn't been collected yet
+
+    // Written by the main thread before the stream is queued, by the worker thread while encoding
+    cv::Mat input_image;
+    int input_jpeg_quality;
+    TrackerVideoEncodedFrame output;
+    std::atomic_bool bEncoded;
+
+    TrackerVideoStream(int in_connection_id)
+        : connection_id(in_connection_id)
+        , next_frame_time()
+        , last_budget_time(std::chrono::steady_clock::now())
+        , byte_budget(0.0)
+        , jpeg_quality(0)
+        , bBusy(false)
+        , input_image()
+        , input_jpeg_quality(0)
+        , output()
+        , bEncoded({ false })
+    {
+    }
+
+    void setSettings(const TrackerVideoStreamSettings &new_settings)
+    {
+        settings = new_settings;
+        jpeg_quality = settings.jpeg_quality;
+        byte_budget = getBytesPerSecond();
+    }
+
+    inline double getBytesPerSecond() const
+    {
+        return static_cast<double>(settings.max_kbps) * 1000.0 / 8.0;
+    }
+};
+
+// -- helper functions -----
+static cv::Rect2i computeROIBounds(const std::vector<cv::Rect2i> &rois, const cv::Size &frame_size)
+{
+    const cv::Rect2i frame_rect(0, 0, frame_size.width, frame_size.height);
+    cv::Rect2i bounds;
+
+    for (const cv::Rect2i &roi : rois)
+    {
+        bounds = (bounds.area() > 0) ? (bounds | roi) : roi;
+    }
+    bounds &= frame_rect;
+
+    // Nothing was searched this frame, show the whole frame
+    return (bounds.area() > 0) ? bounds : frame_rect;
+}
+
+//-- public implementation -----
+TrackerVideoEncoder::TrackerVideoEncoder(int tracker_id)
+    : WorkerThread("TrackerVideoEncoder" + std::to_string(tracker_id))
+{
+}
+
+TrackerVideoEncoder::~TrackerVideoEncoder()
+{
+    stopThread();
+}
+
+void TrackerVideoEncoder::addStream(int connection_id, const TrackerVideoStreamSettings &settings)
+{
+    auto iter = std::find_if(m_streams.begin(), m_streams.end(),
+        [connection_id](const TrackerVideoStreamPtr &stream) { return stream->connection_id == connection_id; });
+
+    if (iter != m_streams.end())
+    {
+        (*iter)->setSettings(settings);
+    }
+    else
+    {
+        TrackerVideoStreamPtr stream = std::make_shared<TrackerVideoStream>(connection_id);
+
+        stream->setSettings(settings);
+        m_streams.push_back(stream);
+    }
+
+    if (!hasThreadStarted())
+    {
+        startThread();
+    }
+}
+
+void TrackerVideoEncoder::removeStream(int connection_id)
+{
+    // Any frame still being encoded for the stream is dropped when the worker is done with it
+    m_streams.erase(
+        std::remove_if(m_streams.begin(), m_streams.end(),
+            [connection_id](const TrackerVideoStreamPtr &stream) { return stream->connection_id == connection_id; }),
+        m_streams.end());
+}
+
+void TrackerVideoEncoder::submitFrame(
+    int sequence_num,
+    const cv::Mat &bgr_frame,
+    const cv::Mat &mask_window,
+    const cv::Point2i &mask_window_origin,
+    const std::vector<cv::Rect2i> &rois)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const cv::Rect2i roi_bounds = computeROIBounds(rois, bgr_frame.size());
+    bool bAnyQueued = false;
+
+    for (TrackerVideoStreamPtr &stream : m_streams)
+    {
+        if (stream->bBusy)
+            continue;
+
+        // Frame rate cap
+        if (stream->settings.max_fps > 0)
+        {
+            if (now < stream->next_frame_time)
+                continue;
+
+            const std::chrono::microseconds frame_period(1000000 / stream->settings.max_fps);
+            const std::chrono::steady_clock::time_point next_frame_time = stream->next_frame_time + frame_period;
+
+            // Don't let the schedule fall behind while frames are skipped for other reasons
+            stream->next_frame_time = (next_frame_time > now) ? next_frame_time : now;
+        }
+
+        // Bitrate cap: refill the byte budget, skip frames until the last frames are paid off
+        if (stream->settings.max_kbps > 0)
+        {
+            const std::chrono::duration<double> elapsed = now - stream->last_budget_time;
+            const double bytes_per_second = stream->getBytesPerSecond();
+
+            stream->byte_budget = std::min(stream->byte_budget + elapsed.count()*bytes_per_second, bytes_per_second);
+            stream->last_budget_time = now;
+
+            if (stream->byte_budget < 0.0)
+                continue;
+        }
+
+        // Copy the pixels this stream needs, the video frame will be reused once we return
+        TrackerVideoEncodedFrame &output = stream->output;
+
+        output.connection_id = stream->connection_id;
+        output.sequence_num = sequence_num;
+        output.frame_width = bgr_frame.cols;
+        output.frame_height = bgr_frame.rows;
+
+        switch (stream->settings.mode)
+        {
+        case _TrackerVideoStreamMode_JPEGFrame:
+            output.image_format = _TrackerVideoImageFormat_JPEG;
+            output.region = cv::Rect2i(0, 0, bgr_frame.cols, bgr_frame.rows);
+            bgr_frame.copyTo(stream->input_image);
+            break;
+        case _TrackerVideoStreamMode_JPEGROI:
+            output.image_format = _TrackerVideoImageFormat_JPEG;
+            output.region = roi_bounds;
+            bgr_frame(roi_bounds).copyTo(stream->input_image);
+            break;
+        case _TrackerVideoStreamMode_Mask:
+            {
+                output.image_format = _TrackerVideoImageFormat_PNG;
+                output.region = roi_bounds;
+
+                // The mask is only valid inside the ROIs searched this frame
+                stream->input_image.create(roi_bounds.size(), CV_8UC1);
+                stream->input_image.setTo(cv::Scalar(0));
+                for (const cv::Rect2i &roi : rois)
+                {
+                    const cv::Rect2i clipped_roi = 
+                        roi & roi_bounds & cv::Rect2i(mask_window_origin, mask_window.size());
+
+                    if (clipped_roi.area() > 0)
+                    {
+                        cv::Mat target(stream->input_image, clipped_roi - roi_bounds.tl());
+
+                        mask_window(clipped_roi - mask_window_origin).copyTo(target);
+                    }
+                }
+            } break;
+        }
+
+        stream->input_jpeg_quality = stream->jpeg_quality;
+        stream->bBusy = true;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_pending_streams.push_back(stream);
+        }
+        bAnyQueued = true;
+    }
+
+    if (bAnyQueued)
+    {
+        m_work_available.notify_one();
+    }
+}
+
+void TrackerVideoEncoder::pollEncodedFrames(const t_encoded_frame_callback &callback)
+{
+    for (TrackerVideoStreamPtr &stream : m_streams)
+    {
+        if (!stream->bBusy || !stream->bEncoded.load(std::memory_order_acquire))
+            continue;
+
+        const TrackerVideoEncodedFrame &output = stream->output;
+
+        if (output.image_data.size() > 0)
+        {
+            callback(output);
+
+            if (stream->settings.max_kbps > 0)
+            {
+                const double bytes_per_second = stream->getBytesPerSecond();
+
+                stream->byte_budget -= static_cast<double>(output.image_data.size());
+
+                // Trade image quality for frame rate when the frames don't fit in the cap
+                if (stream->byte_budget < 0.0)
+                {
+                    stream->jpeg_quality = std::max(stream->jpeg_quality - 10, k_min_adaptive_jpeg_quality);
+                }
+                else if (stream->byte_budget > 0.5*bytes_per_second)
+                {
+                    stream->jpeg_quality = std::min(stream->jpeg_quality + 5, stream->settings.jpeg_quality);
+                }
+            }
+        }
+
+        stream->bEncoded.store(false);
+        stream->bBusy = false;
+    }
+}
+
+//-- protected implementation -----
+bool TrackerVideoEncoder::doWork()
+{
+    TrackerVideoStreamPtr stream;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_work_available.wait(lock, [this]() { return m_exitSignaled.load() || !m_pending_streams.empty(); });
+
+        if (m_exitSignaled)
+        {
+            return false;
+        }
+
+        stream = m_pending_streams.front();
+        m_pending_streams.erase(m_pending_streams.begin());
+    }
+
+    TrackerVideoEncodedFrame &output = stream->output;
+    bool bSuccess = false;
+
+    try
+    {
+        if (output.image_format == _TrackerVideoImageFormat_JPEG)
+        {
+            const std::vector<int> params = { cv::IMWRITE_JPEG_QUALITY, stream->input_jpeg_quality };
+
+            bSuccess = cv::imencode(".jpg", stream->input_image, output.image_data, params);
+        }
+        else
+        {
+            const std::vector<int> params = { cv::IMWRITE_PNG_COMPRESSION, k_png_compression_level };
+
+            bSuccess = cv::imencode(".png", stream->input_image, output.image_data, params);
+        }
+    }
+    catch (const cv::Exception &e)
+    {
+        SERVER_MT_LOG_ERROR("TrackerVideoEncoder::doWork") << "Failed to encode video frame: " << e.what();
+    }
+
+    // An empty image tells the main thread to skip the frame
+    if (!bSuccess)
+    {
+        output.image_data.clear();
+    }
+
+    stream->bEncoded.store(true, std::memory_order_release);
+
+    return true;
+}
+
+void TrackerVideoEncoder::onThreadHaltBegin()
+{
+    // Wake the worker up so it sees the exit flag
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_work_available.notify_all();
+}
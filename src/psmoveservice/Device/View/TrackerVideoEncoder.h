@@ -0,0 +1,84 @@
+#ifndef TRACKER_VIDEO_ENCODER_H
+#define TRACKER_VIDEO_ENCODER_H
+
+//-- includes -----
+#include "ServerTrackerView.h"
+#include "WorkerThread.h"
+#include "opencv2/core/core.hpp"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//-- definitions -----
+enum eTrackerVideoImageFormat
+{
+    _TrackerVideoImageFormat_JPEG,
+    _TrackerVideoImageFormat_PNG,
+};
+
+struct TrackerVideoEncodedFrame
+{
+    int connection_id;
+    int sequence_num;
+    eTrackerVideoImageFormat image_format;
+    int frame_width;
+    int frame_height;
+    cv::Rect2i region; // part of the video frame the image covers
+    std::vector<unsigned char> image_data;
+};
+
+/// Compresses tracker video frames for the clients watching a tracker over the network.
+/// The main thread only copies the pixels a stream needs, the encoding happens on the worker thread.
+/// Each stream (one per connection) has at most one frame being encoded at a time.
+/// Frames arriving while it's busy or over the stream's frame rate and bitrate caps are skipped,
+/// and the JPEG quality is lowered when the frames don't fit in the bitrate cap.
+class TrackerVideoEncoder : public WorkerThread
+{
+public:
+    TrackerVideoEncoder(int tracker_id);
+    virtual ~TrackerVideoEncoder();
+
+    /// Add a stream for the connection (or replace its settings)
+    void addStream(int connection_id, const TrackerVideoStreamSettings &settings);
+    void removeStream(int connection_id);
+    inline bool hasStreams() const { return !m_streams.empty(); }
+
+    /// Offer the latest video frame to every stream that's ready for one.
+    /**
+     \param bgr_frame The whole video frame
+     \param mask_window The color filter mask, only valid inside the ROIs
+     \param mask_window_origin Where the mask window sits in the frame (it covers at least the ROIs)
+     \param rois The regions searched in this frame
+     */
+    void submitFrame(
+        int sequence_num,
+        const cv::Mat &bgr_frame,
+        const cv::Mat &mask_window,
+        const cv::Point2i &mask_window_origin,
+        const std::vector<cv::Rect2i> &rois);
+
+    /// Hand every frame the worker thread finished encoding to the callback
+    typedef std::function<void(const TrackerVideoEncodedFrame &frame)> t_encoded_frame_callback;
+    void pollEncodedFrames(const t_encoded_frame_callback &callback);
+
+protected:
+    bool doWork() override;
+    void onThreadHaltBegin() override;
+
+private:
+    struct TrackerVideoStream;
+    typedef std::shared_ptr<TrackerVideoStream> TrackerVideoStreamPtr;
+
+    // Main thread state
+    std::vector<TrackerVideoStreamPtr> m_streams;
+
+    // Streams with a frame waiting to be encoded, guarded by m_mutex.
+    // A removed stream stays alive until the worker is done with it.
+    std::vector<TrackerVideoStreamPtr> m_pending_streams;
+    std::mutex m_mutex;
+    std::condition_variable m_work_available;
+};
+
+#endif // TRACKER_VIDEO_ENCODER_H
@@ -167,6 +167,84 @@ void CompoundPoseFilter::update(
     }
 }
 
+void CompoundPoseFilter::updateBatch(
+	const PoseFilterSpace *filter_space,
+	const PoseSensorPacketSpan &sensor_packets)
+{
+	if (m_orientation_filter == nullptr && m_position_filter == nullptr)
+	{
+		return;
+	}
+
+	// Same update order as update(), but the filter state is read straight from the
+	// child filters and only re-read after the child filter that owns it has changed.
+	const bool bUpdateOrientation= m_orientation_filter != nullptr && m_position_filter != nullptr;
+	const bool bFoldIMUOnlyPackets= m_position_filter != nullptr && m_position_filter->getIsOpticalOnly();
+
+	Eigen::Quaternionf current_orientation= getOrientation();
+	Eigen::Vector3f current_position_cm= getPositionCm();
+	Eigen::Vector3f current_velocity_cm_s= getVelocityCmPerSec();
+	Eigen::Vector3f current_acceleration_cm_s2= getAccelerationCmPerSecSqr();
+
+	// IMU-only packets only advance time in an optical-only position filter,
+	// so consecutive ones are folded into a single position update
+	PoseFilterPacket folded_position_packet;
+	float folded_position_delta_time= 0.f;
+
+	PoseFilterPacket filter_packet;
+	for (size_t packet_index = 0; packet_index < sensor_packets.count; ++packet_index)
+	{
+		const PoseSensorPacket &sensor_packet= sensor_packets.packets[packet_index];
+		const float delta_time= sensor_packets.time_deltas[packet_index];
+
+		filter_packet.clear();
+		filter_space->createFilterPacket(
+			sensor_packet,
+			current_orientation, current_position_cm, current_velocity_cm_s, current_acceleration_cm_s2,
+			filter_packet);
+
+		Eigen::Quaternionf filtered_orientation= Eigen::Quaternionf::Identity();
+		if (bUpdateOrientation)
+		{
+			m_orientation_filter->update(delta_time, filter_packet);
+			filtered_orientation= m_orientation_filter->getOrientation();
+			current_orientation= filtered_orientation;
+		}
+
+		if (m_position_filter != nullptr)
+		{
+			if (bFoldIMUOnlyPackets && !filter_packet.has_optical_measurement())
+			{
+				folded_position_packet= filter_packet;
+				folded_position_delta_time+= delta_time;
+			}
+			else
+			{
+				if (folded_position_delta_time > 0.f)
+				{
+					m_position_filter->update(folded_position_delta_time, folded_position_packet);
+					folded_position_delta_time= 0.f;
+				}
+
+				filter_packet.current_orientation= filtered_orientation;
+				m_position_filter->update(delta_time, filter_packet);
+
+				current_position_cm= m_position_filter->getPositionCm();
+				current_velocity_cm_s= m_position_filter->getVelocityCmPerSec();
+				current_acceleration_cm_s2= m_position_filter->getAccelerationCmPerSecSqr();
+			}
+		}
+
+		m_time+= static_cast<double>(delta_time);
+	}
+
+	// Flush any time still pending in the position filter
+	if (folded_position_delta_time > 0.f)
+	{
+		m_position_filter->update(folded_position_delta_time, folded_position_packet);
+	}
+}
+
 void CompoundPoseFilter::resetState()
 {
 	if (m_orientation_filter != nullptr && m_position_filter != nullptr)
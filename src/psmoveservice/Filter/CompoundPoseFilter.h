@@ -66,6 +66,7 @@ public:
     Eigen::Vector3f getPositionCm(float time = 0.f) const override;
     Eigen::Vector3f getVelocityCmPerSec() const override;
     Eigen::Vector3f getAccelerationCmPerSecSqr() const override;
+    void updateBatch(const PoseFilterSpace *filter_space, const PoseSensorPacketSpan &sensor_packets) override;
 
 protected:
 	void allocate_filters(
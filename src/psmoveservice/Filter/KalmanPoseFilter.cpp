@@ -1136,6 +1136,30 @@ Eigen::Vector3f KalmanPoseFilter::getAccelerationCmPerSecSqr() const
 	return accel.cast<float>();
 }
 
+void KalmanPoseFilter::updateBatch(
+	const PoseFilterSpace *filter_space,
+	const PoseSensorPacketSpan &sensor_packets)
+{
+	// The UKF carries its own pose state and the update functions never read the 
+	// current_* fields of the filter packet, so don't bother querying them for every packet.
+	// Every IMU packet carries an accelerometer measurement update, 
+	// so consecutive IMU packets can't be folded into a single predict step.
+	PoseFilterPacket filter_packet;
+	for (size_t packet_index = 0; packet_index < sensor_packets.count; ++packet_index)
+	{
+		filter_packet.clear();
+		filter_space->createFilterPacket(
+			sensor_packets.packets[packet_index],
+			Eigen::Quaternionf::Identity(), 
+			Eigen::Vector3f::Zero(), 
+			Eigen::Vector3f::Zero(), 
+			Eigen::Vector3f::Zero(),
+			filter_packet);
+
+		update(sensor_packets.time_deltas[packet_index], filter_packet);
+	}
+}
+
 //-- KalmanPoseFilterPointCloud --
 bool KalmanPoseFilterPointCloud::init(const PoseFilterConstants &constants)
 {
@@ -46,6 +46,9 @@ public:
     /// Get the current velocity of the filter state (cm/s^2)
     Eigen::Vector3f getAccelerationCmPerSecSqr() const override;
 
+    /// Update the filter with a run of sensor packets without re-querying the filter state per packet
+    void updateBatch(const PoseFilterSpace *filter_space, const PoseSensorPacketSpan &sensor_packets) override;
+
 protected:
 	PoseFilterConstants m_constants;
 	class KalmanPoseFilterImpl *m_filter;
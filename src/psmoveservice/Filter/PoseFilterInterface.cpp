@@ -17,6 +17,55 @@ const Eigen::Matrix3f g_eigen_sensor_transform_opengl((Eigen::Matrix3f() << 1,0,
 const Eigen::Matrix3f *k_eigen_sensor_transform_opengl= &g_eigen_sensor_transform_opengl;
 
 // -- public interface -----
+//-- Pose Sensor Packet Accumulator -----
+void PoseSensorPacketAccumulator::accumulate(
+	const PoseSensorPacket &sensorPacket,
+	float time_delta_seconds)
+{
+	if (sensorPacket.has_gyroscope_measurement)
+	{
+		gyroscope_rad_sum+= sensorPacket.imu_gyroscope_rad_per_sec * time_delta_seconds;
+		merged_packet.raw_imu_gyroscope= sensorPacket.raw_imu_gyroscope;
+		merged_packet.imu_gyroscope_rad_per_sec= sensorPacket.imu_gyroscope_rad_per_sec;
+		merged_packet.has_gyroscope_measurement= true;
+	}
+
+	if (sensorPacket.has_accelerometer_measurement)
+	{
+		accelerometer_g_units_sum+= sensorPacket.imu_accelerometer_g_units;
+		++accelerometer_count;
+		merged_packet.raw_imu_accelerometer= sensorPacket.raw_imu_accelerometer;
+		merged_packet.has_accelerometer_measurement= true;
+	}
+
+	if (sensorPacket.has_magnetometer_measurement)
+	{
+		merged_packet.raw_imu_magnetometer= sensorPacket.raw_imu_magnetometer;
+		merged_packet.imu_magnetometer_unit= sensorPacket.imu_magnetometer_unit;
+		merged_packet.has_magnetometer_measurement= true;
+	}
+
+	merged_packet.timestamp= sensorPacket.timestamp;
+	duration_seconds+= time_delta_seconds;
+	++packet_count;
+}
+
+const PoseSensorPacket &PoseSensorPacketAccumulator::getMergedPacket()
+{
+	// A run without any elapsed time just keeps the newest gyro reading
+	if (merged_packet.has_gyroscope_measurement && duration_seconds > 0.f)
+	{
+		merged_packet.imu_gyroscope_rad_per_sec= gyroscope_rad_sum / duration_seconds;
+	}
+
+	if (accelerometer_count > 0)
+	{
+		merged_packet.imu_accelerometer_g_units= accelerometer_g_units_sum / static_cast<float>(accelerometer_count);
+	}
+
+	return merged_packet;
+}
+
 //-- Orientation Filter Space -----
 PoseFilterSpace::PoseFilterSpace()
     : m_IdentityGravity(Eigen::Vector3f(0.f, 1.f, 0.f))
@@ -56,13 +105,30 @@ void PoseFilterSpace::createFilterPacket(
     const PoseSensorPacket &sensorPacket,
 	const IPoseFilter *poseFilter,
     PoseFilterPacket &outFilterPacket) const
+{
+	createFilterPacket(
+		sensorPacket,
+		poseFilter->getOrientation(),
+		poseFilter->getPositionCm(),
+		poseFilter->getVelocityCmPerSec(),
+		poseFilter->getAccelerationCmPerSecSqr(),
+		outFilterPacket);
+}
+
+void PoseFilterSpace::createFilterPacket(
+    const PoseSensorPacket &sensorPacket,
+    const Eigen::Quaternionf &current_orientation,
+    const Eigen::Vector3f &current_position_cm,
+    const Eigen::Vector3f &current_linear_velocity_cm_s,
+    const Eigen::Vector3f &current_linear_acceleration_cm_s2,
+    PoseFilterPacket &outFilterPacket) const
 {
 	outFilterPacket.timestamp= sensorPacket.timestamp;
 
-	outFilterPacket.current_orientation= poseFilter->getOrientation();
-	outFilterPacket.current_position_cm= poseFilter->getPositionCm();
-	outFilterPacket.current_linear_velocity_cm_s = poseFilter->getVelocityCmPerSec();
-	outFilterPacket.current_linear_acceleration_cm_s2 = poseFilter->getAccelerationCmPerSecSqr();
+	outFilterPacket.current_orientation= current_orientation;
+	outFilterPacket.current_position_cm= current_position_cm;
+	outFilterPacket.current_linear_velocity_cm_s = current_linear_velocity_cm_s;
+	outFilterPacket.current_linear_acceleration_cm_s2 = current_linear_acceleration_cm_s2;
 
     outFilterPacket.optical_orientation = sensorPacket.optical_orientation;
     outFilterPacket.optical_position_cm = sensorPacket.optical_position_cm;
@@ -88,4 +154,23 @@ void PoseFilterSpace::createFilterPacket(
         
 	outFilterPacket.world_accelerometer=
 		eigen_vector3f_clockwise_rotate(outFilterPacket.current_orientation, outFilterPacket.imu_accelerometer_g_units);
+}
+
+//-- Pose Filter -----
+void IPoseFilter::updateBatch(
+	const PoseFilterSpace *filter_space,
+	const PoseSensorPacketSpan &sensor_packets)
+{
+	for (size_t packet_index = 0; packet_index < sensor_packets.count; ++packet_index)
+	{
+		PoseFilterPacket filter_packet;
+		filter_packet.clear();
+
+		// Create a filter input packet from the sensor data 
+		// and the filter's previous orientation and position
+		filter_space->createFilterPacket(sensor_packets.packets[packet_index], this, filter_packet);
+
+		// Process the filter packet
+		update(sensor_packets.time_deltas[packet_index], filter_packet);
+	}
 }
\ No newline at end of file
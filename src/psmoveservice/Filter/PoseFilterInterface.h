@@ -144,6 +144,57 @@ struct PoseFilterPacket : PoseSensorPacket
 	}
 };
 
+/// A time ordered run of sensor packets (oldest first) handed to a filter in one call.
+/// time_deltas[i] is the time in seconds between packets[i] and the packet before it
+/// (or the last filter update for the first packet in the run).
+struct PoseSensorPacketSpan
+{
+	const PoseSensorPacket *packets;
+	const float *time_deltas;
+	size_t count;
+
+	inline bool empty() const
+	{
+		return count == 0;
+	}
+};
+
+/// Folds a run of consecutive IMU packets into a single packet covering the same time span.
+/// Used when a device falls behind: the gyro readings are integrated over the run so the
+/// total rotation is preserved, the accelerometer readings are averaged and the most
+/// recent magnetometer reading is kept.
+struct PoseSensorPacketAccumulator
+{
+	PoseSensorPacket merged_packet;
+	Eigen::Vector3f gyroscope_rad_sum; // integral of the gyro rate over the run
+	Eigen::Vector3f accelerometer_g_units_sum;
+	float duration_seconds;
+	int accelerometer_count;
+	int packet_count;
+
+	inline void clear()
+	{
+		merged_packet.clear();
+		gyroscope_rad_sum= Eigen::Vector3f::Zero();
+		accelerometer_g_units_sum= Eigen::Vector3f::Zero();
+		duration_seconds= 0.f;
+		accelerometer_count= 0;
+		packet_count= 0;
+	}
+
+	inline bool empty() const
+	{
+		return packet_count == 0;
+	}
+
+	/// Add the next (newer) packet of the run.
+	/// time_delta_seconds is the time since the packet before it.
+	void accumulate(const PoseSensorPacket &sensorPacket, float time_delta_seconds);
+
+	/// Get the packet for the run, stamped with the time of the newest packet
+	const PoseSensorPacket &getMergedPacket();
+};
+
 /// Used to transform sensor data from a controller into an arbitrary space
 class PoseFilterSpace
 {
@@ -170,6 +221,15 @@ public:
 		const class IPoseFilter *poseFilter,
         PoseFilterPacket &outFilterPacket) const;
 
+    /// Same as above, but takes the filter state directly rather than querying a pose filter for it
+    void createFilterPacket(
+        const PoseSensorPacket &sensorPacket,
+        const Eigen::Quaternionf &current_orientation,
+        const Eigen::Vector3f &current_position_cm,
+        const Eigen::Vector3f &current_linear_velocity_cm_s,
+        const Eigen::Vector3f &current_linear_acceleration_cm_s2,
+        PoseFilterPacket &outFilterPacket) const;
+
 private:
     Eigen::Vector3f m_IdentityGravity;
     Eigen::Vector3f m_IdentityMagnetometer;
@@ -335,6 +395,11 @@ public:
     /// Estimate the current position of the filter state given a time offset into the future (meters)
     virtual Eigen::Vector3f getPositionCm(float time = 0.f) const = 0;
 
+    /// True if update() only consumes optical measurements.
+    /// For these filters an IMU-only packet just advances time, 
+    /// so a run of IMU-only packets can be folded into a single update.
+    virtual bool getIsOpticalOnly() const { return false; }
+
     /// Get the current velocity of the filter state (cm/s)
     virtual Eigen::Vector3f getVelocityCmPerSec() const = 0;
 
@@ -369,6 +434,10 @@ public:
 
     /// Get the current velocity of the filter state (cm/s^2)
     virtual Eigen::Vector3f getAccelerationCmPerSecSqr() const = 0;
+
+    /// Update the filter with a run of sensor packets transformed through the given filter space.
+    /// The default implementation creates a filter packet and calls update() once per sensor packet.
+    virtual void updateBatch(const PoseFilterSpace *filter_space, const PoseSensorPacketSpan &sensor_packets);
 };
 
 #endif // POSE_FILTER_INTERFACE_H
\ No newline at end of file
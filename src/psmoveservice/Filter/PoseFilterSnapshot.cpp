@@ -0,0 +1,141 @@
+// -- includes -----
+#include "PoseFilterSnapshot.h"
+#include "AtomicPrimitives.h"
+#include "MathUtility.h"
+
+// -- public methods -----
+void PoseFilterSnapshotState::clear()
+{
+    orientation= Eigen::Quaternionf::Identity();
+    angular_velocity_rad_per_sec= Eigen::Vector3f::Zero();
+    angular_acceleration_rad_per_sec_sqr= Eigen::Vector3f::Zero();
+    position_cm= Eigen::Vector3f::Zero();
+    velocity_cm_per_sec= Eigen::Vector3f::Zero();
+    acceleration_cm_per_sec_sqr= Eigen::Vector3f::Zero();
+    time_in_seconds= 0.0;
+    bIsStateValid= false;
+    bIsPositionStateValid= false;
+    bIsOrientationStateValid= false;
+}
+
+PoseFilterSnapshot::PoseFilterSnapshot()
+    : m_published_state(new AtomicObject<PoseFilterSnapshotState>)
+    , m_publish_scratch(new PoseFilterSnapshotState)
+    , m_state(new PoseFilterSnapshotState)
+{
+    m_publish_scratch->clear();
+    m_state->clear();
+    m_published_state->storeValue(*m_state);
+}
+
+PoseFilterSnapshot::~PoseFilterSnapshot()
+{
+    delete m_published_state;
+    delete m_publish_scratch;
+    delete m_state;
+}
+
+void PoseFilterSnapshot::publish(const IPoseFilter *filter)
+{
+    PoseFilterSnapshotState &state= *m_publish_scratch;
+
+    state.orientation= filter->getOrientation();
+    state.angular_velocity_rad_per_sec= filter->getAngularVelocityRadPerSec();
+    state.angular_acceleration_rad_per_sec_sqr= filter->getAngularAccelerationRadPerSecSqr();
+    state.position_cm= filter->getPositionCm();
+    state.velocity_cm_per_sec= filter->getVelocityCmPerSec();
+    state.acceleration_cm_per_sec_sqr= filter->getAccelerationCmPerSecSqr();
+    state.time_in_seconds= filter->getTimeInSeconds();
+    state.bIsStateValid= filter->getIsStateValid();
+    state.bIsPositionStateValid= filter->getIsPositionStateValid();
+    state.bIsOrientationStateValid= filter->getIsOrientationStateValid();
+
+    m_published_state->storeValue(state);
+}
+
+void PoseFilterSnapshot::refresh()
+{
+    m_published_state->fetchValue(*m_state);
+}
+
+// -- IStateFilter --
+bool PoseFilterSnapshot::getIsStateValid() const
+{
+    return m_state->bIsStateValid;
+}
+
+double PoseFilterSnapshot::getTimeInSeconds() const
+{
+    return m_state->time_in_seconds;
+}
+
+void PoseFilterSnapshot::update(const float delta_time, const PoseFilterPacket &packet)
+{
+    assert(false && "PoseFilterSnapshot is read-only");
+}
+
+void PoseFilterSnapshot::resetState()
+{
+    assert(false && "PoseFilterSnapshot is read-only");
+}
+
+void PoseFilterSnapshot::recenterOrientation(const Eigen::Quaternionf& q_pose)
+{
+    assert(false && "PoseFilterSnapshot is read-only");
+}
+
+// -- IPoseFilter ---
+bool PoseFilterSnapshot::getIsPositionStateValid() const
+{
+    return m_state->bIsPositionStateValid;
+}
+
+bool PoseFilterSnapshot::getIsOrientationStateValid() const
+{
+    return m_state->bIsOrientationStateValid;
+}
+
+Eigen::Quaternionf PoseFilterSnapshot::getOrientation(float time) const
+{
+    Eigen::Quaternionf predicted_orientation= m_state->orientation;
+
+    // Same first order prediction the orientation filters use
+    if (m_state->bIsOrientationStateValid && fabsf(time) > k_real_epsilon)
+    {
+        const Eigen::Quaternionf &quaternion_derivative=
+            eigen_angular_velocity_to_quaternion_derivative(m_state->orientation, m_state->angular_velocity_rad_per_sec);
+
+        predicted_orientation= Eigen::Quaternionf(
+            m_state->orientation.coeffs()
+            + quaternion_derivative.coeffs()*time).normalized();
+    }
+
+    return predicted_orientation;
+}
+
+Eigen::Vector3f PoseFilterSnapshot::getAngularVelocityRadPerSec() const
+{
+    return m_state->angular_velocity_rad_per_sec;
+}
+
+Eigen::Vector3f PoseFilterSnapshot::getAngularAccelerationRadPerSecSqr() const
+{
+    return m_state->angular_acceleration_rad_per_sec_sqr;
+}
+
+Eigen::Vector3f PoseFilterSnapshot::getPositionCm(float time) const
+{
+    return is_nearly_zero(time)
+        ? m_state->position_cm
+        : Eigen::Vector3f(m_state->position_cm + m_state->velocity_cm_per_sec * time);
+}
+
+Eigen::Vector3f PoseFilterSnapshot::getVelocityCmPerSec() const
+{
+    return m_state->velocity_cm_per_sec;
+}
+
+Eigen::Vector3f PoseFilterSnapshot::getAccelerationCmPerSecSqr() const
+{
+    return m_state->acceleration_cm_per_sec_sqr;
+}
@@ -0,0 +1,71 @@
+#ifndef POSE_FILTER_SNAPSHOT_H
+#define POSE_FILTER_SNAPSHOT_H
+
+//-- includes -----
+#include "PoseFilterInterface.h"
+
+//-- pre-declarations -----
+template<typename t_object_type>
+class AtomicObject;
+
+// -- definitions --
+/// The output of a pose filter at the end of an update
+struct PoseFilterSnapshotState
+{
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    Eigen::Quaternionf orientation;
+    Eigen::Vector3f angular_velocity_rad_per_sec;
+    Eigen::Vector3f angular_acceleration_rad_per_sec_sqr;
+    Eigen::Vector3f position_cm;
+    Eigen::Vector3f velocity_cm_per_sec;
+    Eigen::Vector3f acceleration_cm_per_sec_sqr;
+    double time_in_seconds;
+    bool bIsStateValid;
+    bool bIsPositionStateValid;
+    bool bIsOrientationStateValid;
+
+    void clear();
+};
+
+/// Read-only view of a pose filter that is being updated on another thread.
+/// The filter thread publishes its state with publish() after every update.
+/// The reading thread calls refresh() to pick up the most recently published state,
+/// and then uses this like any other pose filter.
+/// Calls that would modify the filter must be made on the real filter instead.
+class PoseFilterSnapshot : public IPoseFilter
+{
+public:
+    PoseFilterSnapshot();
+    virtual ~PoseFilterSnapshot();
+
+    /// Filter thread: publish the current state of the given filter
+    void publish(const IPoseFilter *filter);
+
+    /// Reading thread: pick up the latest published state
+    void refresh();
+
+    // -- IStateFilter --
+    bool getIsStateValid() const override;
+    double getTimeInSeconds() const override;
+    void update(const float delta_time, const PoseFilterPacket &packet) override;
+    void resetState() override;
+    void recenterOrientation(const Eigen::Quaternionf& q_pose) override;
+
+    // -- IPoseFilter ---
+    bool getIsPositionStateValid() const override;
+    bool getIsOrientationStateValid() const override;
+    Eigen::Quaternionf getOrientation(float time = 0.f) const override;
+    Eigen::Vector3f getAngularVelocityRadPerSec() const override;
+    Eigen::Vector3f getAngularAccelerationRadPerSecSqr() const override;
+    Eigen::Vector3f getPositionCm(float time = 0.f) const override;
+    Eigen::Vector3f getVelocityCmPerSec() const override;
+    Eigen::Vector3f getAccelerationCmPerSecSqr() const override;
+
+private:
+    AtomicObject<PoseFilterSnapshotState> *m_published_state;
+    PoseFilterSnapshotState *m_publish_scratch; // filter thread only
+    PoseFilterSnapshotState *m_state; // reading thread only
+};
+
+#endif // POSE_FILTER_SNAPSHOT_H
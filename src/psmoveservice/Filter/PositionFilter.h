@@ -37,12 +37,14 @@ class PositionFilterPassThru : public PositionFilter
 {
 public:
     void update(const float delta_time, const PoseFilterPacket &packet) override;
+    bool getIsOpticalOnly() const override { return true; }
 };
 
 class PositionFilterLowPassOptical : public PositionFilter
 {
 public:
     void update(const float delta_time, const PoseFilterPacket &packet) override;
+    bool getIsOpticalOnly() const override { return true; }
 };
 
 class PositionFilterLowPassIMU : public PositionFilter
@@ -55,6 +57,7 @@ class PositionFilterLowPassExponential : public PositionFilter
 {
 public:
 	void update(const float delta_time, const PoseFilterPacket &packet) override;
+	bool getIsOpticalOnly() const override { return true; }
 	std::list<float> deltaTimeHistory;
 	std::list<Eigen::Vector3f> blendedPositionHistory;
 };
@@ -33,7 +33,6 @@
 #define MORPHEUS_COMMAND_MAGIC 0xAA
 #define MORPHEUS_COMMAND_MAX_PAYLOAD_LEN 60
 
-#define MORPHEUS_HMD_STATE_BUFFER_MAX 4
 #define METERS_TO_CENTIMETERS 100
 
 enum eMorpheusRequestType
@@ -103,7 +102,7 @@ enum eMorpheusButton : unsigned char
 
 struct MorpheusRawSensorFrame
 {
-	unsigned char seq_frame[2];
+	unsigned char timestamp[4]; // little endian, microseconds
 	unsigned char gyro_yaw[2];
 	unsigned char gyro_pitch[2];
 	unsigned char gyro_roll[2];
@@ -137,11 +136,10 @@ struct MorpheusSensorData
 	} headsetFlags;								// byte 8
 
 	unsigned char unkFlags;     				// byte 9
-	unsigned char unk2[8];						// byte 10-17
+	unsigned char unk2[6];						// byte 10-15
 
-	MorpheusRawSensorFrame imu_frame_0;         // byte 18-31
-	unsigned char unk3[2];						// byte 32-33
-	MorpheusRawSensorFrame imu_frame_1;         // byte 34-47
+	MorpheusRawSensorFrame imu_frame_0;         // byte 16-31
+	MorpheusRawSensorFrame imu_frame_1;         // byte 32-47
 
 	unsigned char calibration_status;           // byte 48: 255 = boot, 0 - 3 calibrating ? 4 = calibrated, maybe a bit mask with sensor status ? (0 bad, 1 good) ?
 	unsigned char sensors_ready;                // byte 49 
@@ -310,7 +308,11 @@ void MorpheusHMDSensorFrame::parse_data_input(
 	const MorpheusHMDConfig *config,
 	const MorpheusRawSensorFrame *data_input)
 {
-	short raw_seq = static_cast<short>((data_input->seq_frame[1] << 8) | data_input->seq_frame[0]);
+	unsigned int raw_timestamp = 
+		static_cast<unsigned int>(data_input->timestamp[0]) |
+		(static_cast<unsigned int>(data_input->timestamp[1]) << 8) |
+		(static_cast<unsigned int>(data_input->timestamp[2]) << 16) |
+		(static_cast<unsigned int>(data_input->timestamp[3]) << 24);
 
 	// Piece together the 12-bit accelerometer data 
 	// rotate data 90degrees about Z so that sensor Y is up, flip X and Z)
@@ -326,8 +328,8 @@ void MorpheusHMDSensorFrame::parse_data_input(
 	short raw_gyroPitch = static_cast<short>((data_input->gyro_pitch[1] << 8) | data_input->gyro_pitch[0]);
 	short raw_gyroRoll = -static_cast<short>((data_input->gyro_roll[1] << 8) | data_input->gyro_roll[0]);
 
-	// Save the sequence number
-	SequenceNumber = static_cast<int>(raw_seq);
+	// Save the timestamp of the sample
+	RawTimeStamp = raw_timestamp;
 
 	// Save the raw accelerometer values
 	RawAccel.i = static_cast<int>(raw_accelX);
@@ -366,6 +368,7 @@ MorpheusHMD::MorpheusHMD()
     , NextPollSequenceNumber(0)
     , InData(nullptr)
     , HMDStates()
+    , CachedStates()
 	, bIsTracking(false)
 {
     USBContext = new MorpheusUSBContext;
@@ -460,6 +463,7 @@ bool MorpheusHMD::open(
 
             // Reset the polling sequence counter
             NextPollSequenceNumber = 0;
+            HMDStates.clear();
 
 			success = true;
         }
@@ -596,14 +600,10 @@ MorpheusHMD::poll()
 
 			// Processes the IMU data
 			newState.parse_data_input(&cfg, InData);
+			newState.HostArrivalTime = std::chrono::high_resolution_clock::now();
 
-			// Make room for new entry if at the max queue size
-			if (HMDStates.size() >= MORPHEUS_HMD_STATE_BUFFER_MAX)
-			{
-				HMDStates.erase(HMDStates.begin(), HMDStates.begin() + HMDStates.size() - MORPHEUS_HMD_STATE_BUFFER_MAX);
-			}
-
-			HMDStates.push_back(newState);
+			// Overwrites the oldest entry once the history is full
+			HMDStates.push(newState.PollSequenceNumber, newState);
 		}
 	}
 
@@ -651,11 +651,34 @@ const CommonDeviceState *
 MorpheusHMD::getState(
     int lookBack) const
 {
-    const int queueSize = static_cast<int>(HMDStates.size());
-    const CommonDeviceState * result =
-        (lookBack < queueSize) ? &HMDStates.at(queueSize - lookBack - 1) : nullptr;
+    // The ring may be written while we copy out of it, so hand out a copy.
+    // Each lookBack has its own copy, only refreshed by the next getState() with the same lookBack.
+    MorpheusHMDState state;
+    if (lookBack < 0 || lookBack >= MORPHEUS_HMD_STATE_BUFFER_MAX || !HMDStates.fetchState(lookBack, state))
+    {
+        return nullptr;
+    }
+
+    CachedStates[lookBack] = state;
+    return &CachedStates[lookBack];
+}
+
+bool
+MorpheusHMD::fetchState(
+    int lookBack,
+    MorpheusHMDState &out_state) const
+{
+    return HMDStates.fetchState(lookBack, out_state);
+}
 
-    return result;
+int
+MorpheusHMD::visitStatesNewerThan(
+    int poll_sequence_number,
+    const std::function<void(const CommonDeviceState *)> &visitor) const
+{
+    return HMDStates.visitNewerThan(
+        poll_sequence_number,
+        [&visitor](const MorpheusHMDState &state) { visitor(&state); });
 }
 
 long MorpheusHMD::getMaxPollFailureCount() const
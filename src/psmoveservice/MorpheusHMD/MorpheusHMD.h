@@ -2,12 +2,13 @@
 #define MORPHEUS_HMD_H
 
 #include "PSMoveConfig.h"
+#include "AtomicPrimitives.h"
 #include "DeviceEnumerator.h"
 #include "DeviceInterface.h"
 #include "MathUtility.h"
+#include <chrono>
 #include <string>
 #include <vector>
-#include <deque>
 #include <array>
 
 // The angle the accelerometer reading will be pitched by
@@ -15,6 +16,13 @@
 // i.e. where what we consider the "identity" pose
 #define MORPHEUS_ACCELEROMETER_IDENTITY_PITCH_DEGREES 0.0f
 
+// Number of polled sensor reports kept until the HMD view gets to them
+#define MORPHEUS_HMD_STATE_BUFFER_MAX 4
+
+// Each IMU sample in a sensor report is stamped with a 32-bit microsecond counter
+#define MORPHEUS_IMU_TIMESTAMP_BITS 32
+#define MORPHEUS_IMU_TIMESTAMP_TICK_SECONDS 1e-6
+
 class MorpheusHMDConfig : public PSMoveConfig
 {
 public:
@@ -164,7 +172,7 @@ public:
 
 struct MorpheusHMDSensorFrame
 {
-	int SequenceNumber;
+	unsigned int RawTimeStamp; // 32-bit, microseconds on the headset's clock
 
 	CommonRawDeviceVector RawAccel;
 	CommonRawDeviceVector RawGyro;
@@ -174,7 +182,7 @@ struct MorpheusHMDSensorFrame
 
 	void clear()
 	{
-		SequenceNumber = 0;
+		RawTimeStamp = 0;
 		RawAccel.clear();
 		RawGyro.clear();
 		CalibratedAccel.clear();
@@ -187,6 +195,7 @@ struct MorpheusHMDSensorFrame
 struct MorpheusHMDState : public CommonHMDState
 {
 	std::array< MorpheusHMDSensorFrame, 2> SensorFrames;
+	std::chrono::time_point<std::chrono::high_resolution_clock> HostArrivalTime; // when the report was read
 
     MorpheusHMDState()
     {
@@ -200,6 +209,7 @@ struct MorpheusHMDState : public CommonHMDState
 
 		SensorFrames[0].clear();
 		SensorFrames[1].clear();
+		HostArrivalTime = std::chrono::time_point<std::chrono::high_resolution_clock>();
     }
 
 	void parse_data_input(const MorpheusHMDConfig *config, const struct MorpheusSensorData *data_input);
@@ -231,6 +241,9 @@ public:
         return CommonDeviceState::Morpheus;
     }
     const CommonDeviceState * getState(int lookBack = 0) const override;
+    int visitStatesNewerThan(
+        int poll_sequence_number,
+        const std::function<void(const CommonDeviceState *)> &visitor) const override;
 
     // -- IHMDInterface
     std::string getUSBDevicePath() const override;
@@ -240,6 +253,9 @@ public:
 	float getPredictionTime() const override;
 
     // -- Getters
+    // Copy out the HMD state at the given sample index.
+    // Unlike getState() the copy belongs to the caller, so prefer this for anything held onto.
+    bool fetchState(int lookBack, MorpheusHMDState &out_state) const;
     inline const MorpheusHMDConfig *getConfig() const
     {
         return &cfg;
@@ -260,7 +276,8 @@ private:
     // Read HMD State
     int NextPollSequenceNumber;
     struct MorpheusSensorData *InData;                        // Buffer to hold most recent MorpheusAPI tracking state
-    std::deque<MorpheusHMDState> HMDStates;
+    AtomicStateRing<MorpheusHMDState, MORPHEUS_HMD_STATE_BUFFER_MAX> HMDStates;
+    mutable MorpheusHMDState CachedStates[MORPHEUS_HMD_STATE_BUFFER_MAX]; // Last state handed out by getState(), per lookBack
 
 	bool bIsTracking;
 };
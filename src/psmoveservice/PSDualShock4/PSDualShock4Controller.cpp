@@ -2,6 +2,7 @@
 #include "AtomicPrimitives.h"
 #include "PSDualShock4Controller.h"
 #include "ControllerDeviceEnumerator.h"
+#include "ControllerOutputScheduler.h"
 #include "MathUtility.h"
 #include "ServerLog.h"
 #include "ServerUtility.h"
@@ -254,6 +255,98 @@ struct DualShock4DataOutput
     unsigned char crc32[4];                 // byte 74-77, CRC-32 of the first 75 bytes
 };
 
+// -- DualShock4OutputScheduler --
+class DualShock4OutputScheduler : public ControllerOutputScheduler<DualShock4ControllerOutputState>
+{
+public:
+	DualShock4OutputScheduler()
+		// The DS4 holds its lightbar and rumble state, so there is no keep alive
+		: ControllerOutputScheduler<DualShock4ControllerOutputState>("DualShock4OutputScheduler", PSDS4_WRITE_DATA_INTERVAL_MS, 0)
+		, m_hidDevice(nullptr)
+	{
+	}
+
+	void start(hid_device *in_hid_device, const std::string &statistic_prefix)
+	{
+		m_hidDevice= in_hid_device;
+		ControllerOutputScheduler<DualShock4ControllerOutputState>::start(statistic_prefix);
+	}
+
+protected:
+	virtual void onThreadStarted() override 
+	{
+		DualShock4DataOutput data_out;
+		memset(&data_out, 0, sizeof(DualShock4DataOutput));
+		data_out.hid_protocol_code= DualShock4_BTReport_Output;
+		data_out._unknown1[0]= 0x80; // Unknown why this this is needed, copied from DS4Windows
+		data_out._unknown1[1] = 0x00;
+		data_out.rumbleFlags = PSDS4_RUMBLE_ENABLED;
+
+		writeOutputHidPacket(data_out);
+	}
+
+	virtual bool writeOutputState(const DualShock4ControllerOutputState &output_state) override
+	{
+		DualShock4DataOutput data_out;
+		memset(&data_out, 0, sizeof(DualShock4DataOutput));
+		data_out.hid_protocol_code= DualShock4_BTReport_Output;
+		data_out._unknown1[0]= 0x80; // Unknown why this this is needed, copied from DS4Windows
+		data_out._unknown1[1] = 0x00;
+		data_out.rumbleFlags = PSDS4_RUMBLE_ENABLED;
+		data_out.led_r = output_state.r;
+		data_out.led_g = output_state.g;
+		data_out.led_b = output_state.b;
+		// a.k.a Soft Rumble Motor
+		data_out.rumble_right = output_state.rumble_right;
+		// a.k.a Hard Rumble Motor
+		data_out.rumble_left = output_state.rumble_left;
+		// Set off interval to 0% and the on interval to 100%. 
+		// There are no discos in PSMoveService.
+		data_out.led_flash_on = (output_state.r != 0 || output_state.g != 0 || output_state.b != 0) ? 0xff : 0x00;
+		data_out.led_flash_off = 0x00; 
+
+		int res= writeOutputHidPacket(data_out);
+		if (res <= 0)
+		{
+			char hidapi_err_mbs[256];
+			bool valid_error_mesg = 
+				ServerUtility::convert_wcs_to_mbs(hid_error(m_hidDevice), hidapi_err_mbs, sizeof(hidapi_err_mbs));
+
+			// Device no longer in valid state.
+			if (valid_error_mesg)
+			{
+				SERVER_MT_LOG_ERROR("DualShock4OutputScheduler::writeOutputState") << "HID ERROR: " << hidapi_err_mbs;
+			}
+		}
+
+		return res > 0;
+	}
+
+	virtual bool isSameOutputState(const DualShock4ControllerOutputState &a, const DualShock4ControllerOutputState &b) const override
+	{
+		return 
+			a.r == b.r && a.g == b.g && a.b == b.b && 
+			a.rumble_left == b.rumble_left && a.rumble_right == b.rumble_right;
+	}
+
+	int writeOutputHidPacket(const DualShock4DataOutput &data_out)
+	{
+		// Unfortunately in windows simply writing to the HID device, via WriteFile() internally, 
+		// doesn't appear to actually set the data on the controller (despite returning successfully).
+		// In the DS4 implementation they use the HidD_SetOutputReport() Win32 API call instead. 
+		// Unfortunately HIDAPI doesn't have any equivalent call, so we have to make our own.
+		#ifdef _WIN32
+		int res = hid_set_output_report(m_hidDevice, (unsigned char*)&data_out, sizeof(DualShock4DataOutput));
+		#else
+		int res = hid_write(m_hidDevice, (unsigned char*)&data_out, sizeof(DualShock4DataOutput));
+		#endif
+
+		return res;
+	}
+
+	hid_device *m_hidDevice;
+};
+
 // -- Dualshock4HidPacketProcessor --
 class DualShock4HidPacketProcessor : public WorkerThread
 {
@@ -270,8 +363,6 @@ public:
 		memset(&m_currentHIDInputPacket, 0, sizeof(DualShock4DataInput));
 		m_previousHIDInputPacket.hid_protocol_code = DualShock4_BTReport_Input;
 		m_currentHIDInputPacket.hid_protocol_code = DualShock4_BTReport_Input;
-
-		memset(&m_previousOutputState, 0, sizeof(DualShock4ControllerOutputState));
 	}
 
 	void setConfig(const PSDualShock4ControllerConfig &cfg)
@@ -286,7 +377,7 @@ public:
 
 	void postOutputState(const DualShock4ControllerOutputState &output_state)
 	{
-		m_currentOutputState.storeValue(output_state);
+		m_outputScheduler.postOutputState(output_state);
 	}
 
     void start(hid_device *in_hid_device, IControllerListener *controller_listener)
@@ -301,26 +392,21 @@ public:
 
 			// Fire up the worker thread
 			WorkerThread::startThread();
+
+			// LED and rumble writes happen on their own thread so they don't wait on a read
+			m_outputScheduler.start(
+				m_hidDevice,
+				m_controllerListener != nullptr ? m_controllerListener->getStatisticPrefix() : "controller");
 		}
     }
 
 	void stop()
 	{
+		m_outputScheduler.stop();
 		WorkerThread::stopThread();
 	}
 
 protected:
-	virtual void onThreadStarted() override 
-	{
-		DualShock4DataOutput data_out;
-		memset(&data_out, 0, sizeof(DualShock4DataOutput));
-		data_out.hid_protocol_code= DualShock4_BTReport_Output;
-		data_out._unknown1[0]= 0x80; // Unknown why this this is needed, copied from DS4Windows
-		data_out._unknown1[1] = 0x00;
-		data_out.rumbleFlags = PSDS4_RUMBLE_ENABLED;
-
-		writeOutputHidPacket(data_out);
-	}
 
 	virtual bool doWork() override
     {
@@ -369,95 +455,21 @@ protected:
 			return false;
 		}
 
-        // Don't send output writes too frequently
-        {
-            std::chrono::time_point<std::chrono::high_resolution_clock> now = std::chrono::high_resolution_clock::now();
-
-            // See if it's time to update the LED/rumble state
-            std::chrono::duration<double, std::milli> led_update_diff = now - m_lastHIDOutputTimestamp;
-            if (led_update_diff.count() >= PSDS4_WRITE_DATA_INTERVAL_MS)
-            {
-				DualShock4ControllerOutputState output_state;
-				m_currentOutputState.fetchValue(output_state);
-
-				if (output_state.r != m_previousOutputState.r ||
-					output_state.g != m_previousOutputState.g ||
-					output_state.b != m_previousOutputState.b ||
-					output_state.rumble_left != m_previousOutputState.rumble_left ||
-					output_state.rumble_right != m_previousOutputState.rumble_right)
-				{
-					DualShock4DataOutput data_out;
-					memset(&data_out, 0, sizeof(DualShock4DataOutput));
-					data_out.hid_protocol_code= DualShock4_BTReport_Output;
-					data_out._unknown1[0]= 0x80; // Unknown why this this is needed, copied from DS4Windows
-					data_out._unknown1[1] = 0x00;
-					data_out.rumbleFlags = PSDS4_RUMBLE_ENABLED;
-					data_out.led_r = output_state.r;
-					data_out.led_g = output_state.g;
-					data_out.led_b = output_state.b;
-					// a.k.a Soft Rumble Motor
-					data_out.rumble_right = output_state.rumble_right;
-					// a.k.a Hard Rumble Motor
-					data_out.rumble_left = output_state.rumble_left;
-					// Set off interval to 0% and the on interval to 100%. 
-					// There are no discos in PSMoveService.
-					data_out.led_flash_on = (output_state.r != 0 || output_state.g != 0 || output_state.b != 0) ? 0xff : 0x00;
-					data_out.led_flash_off = 0x00; 
-
-					int res= writeOutputHidPacket(data_out);
-					if (res > 0)
-					{
-						m_previousOutputState= output_state;
-						m_lastHIDOutputTimestamp = now;
-					}
-					else
-					{
-						char hidapi_err_mbs[256];
-						bool valid_error_mesg = 
-							ServerUtility::convert_wcs_to_mbs(hid_error(m_hidDevice), hidapi_err_mbs, sizeof(hidapi_err_mbs));
-
-						// Device no longer in valid state.
-						if (valid_error_mesg)
-						{
-							SERVER_MT_LOG_ERROR("PSMoveSensorProcessor::doWork") << "HID ERROR: " << hidapi_err_mbs;
-						}
-					}
-				}
-            }
-        }
-
 		return true;
     }
 
-	int writeOutputHidPacket(const DualShock4DataOutput &data_out)
-	{
-		// Unfortunately in windows simply writing to the HID device, via WriteFile() internally, 
-		// doesn't appear to actually set the data on the controller (despite returning successfully).
-		// In the DS4 implementation they use the HidD_SetOutputReport() Win32 API call instead. 
-		// Unfortunately HIDAPI doesn't have any equivalent call, so we have to make our own.
-		#ifdef _WIN32
-		int res = hid_set_output_report(m_hidDevice, (unsigned char*)&data_out, sizeof(DualShock4DataOutput));
-		#else
-		int res = hid_write(m_hidDevice, (unsigned char*)&data_out, sizeof(DualShock4DataOutput));
-		#endif
-
-		return res;
-	}
-
     // Multi-threaded state
 	hid_device *m_hidDevice;
 	IControllerListener *m_controllerListener;
 	bool m_bSupportsMagnetometer;
 	AtomicObject<DualShock4ControllerInputState> m_currentInputState;
-	AtomicObject<DualShock4ControllerOutputState> m_currentOutputState;
 	AtomicObject<PSDualShock4ControllerConfig> m_cfg;
+	DualShock4OutputScheduler m_outputScheduler;
 
     // Worker thread state
     int m_nextPollSequenceNumber;
 	DualShock4DataInput m_previousHIDInputPacket;
     DualShock4DataInput m_currentHIDInputPacket;
-	std::chrono::time_point<std::chrono::high_resolution_clock> m_lastHIDOutputTimestamp;
-	DualShock4ControllerOutputState m_previousOutputState;
 };
 
 // -- public methods
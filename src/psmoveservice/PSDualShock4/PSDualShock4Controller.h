@@ -22,6 +22,10 @@
 // i.e. where what we consider the "identity" pose
 #define ACCELEROMETER_IDENTITY_PITCH_DEGREES 22.667f
 
+// The 16-bit timestamp in every input report counts in 16/3 microsecond ticks
+#define PSDS4_IMU_TIMESTAMP_BITS 16
+#define PSDS4_IMU_TIMESTAMP_TICK_SECONDS (16.0 / 3.0 * 1e-6)
+
 struct DualShock4HIDDetails {
 	int vendor_id;
 	int product_id;
@@ -182,7 +186,7 @@ struct DualShock4ControllerInputState : public CommonControllerState
 {
     int RawSequence;                               // 6-bit  (counts up by 1 per report)
 
-    unsigned int RawTimeStamp;                     // 16-bit (time since ?, units?)
+    unsigned int RawTimeStamp;                     // 16-bit (free running, 16/3 microsecond ticks)
 
     float LeftAnalogX;  // [-1.f, 1.f]
     float LeftAnalogY;  // [-1.f, 1.f]
@@ -21,14 +21,38 @@ const CommonHSVColorRange g_default_color_presets[] = {
 };
 const CommonHSVColorRange *k_default_color_presets = g_default_color_presets;
 
+// Overrides the default config directory when not empty
+static std::string g_config_directory;
+
 PSMoveConfig::PSMoveConfig(const std::string &fnamebase)
 : ConfigFileBase(fnamebase)
 {
 }
 
+void
+PSMoveConfig::setConfigDirectory(const std::string &directory)
+{
+    g_config_directory = directory;
+}
+
+const std::string &
+PSMoveConfig::getConfigDirectory()
+{
+    return g_config_directory;
+}
+
 const std::string
 PSMoveConfig::getConfigPath()
 {
+    if (!g_config_directory.empty())
+    {
+        boost::filesystem::path configpath(g_config_directory);
+        boost::filesystem::create_directories(configpath);
+        configpath /= ConfigFileBase + ".json";
+        std::cout << "Config file name: " << configpath << std::endl;
+        return configpath.string();
+    }
+
     const char *homedir;
 #ifdef _WIN32
     size_t homedir_buffer_req_size;
@@ -14,6 +14,11 @@ public:
     PSMoveConfig(const std::string &fnamebase = std::string("PSMoveConfig"));
     void save();
     bool load();
+
+    /// Directory every config file is read from and written to.
+    /// Empty (the default) for the PSMoveService folder in the user's home/app data directory.
+    static void setConfigDirectory(const std::string &directory);
+    static const std::string &getConfigDirectory();
     
     std::string ConfigFileBase;
 
@@ -37,6 +37,7 @@ POSSIBILITY OF SUCH DAMAGE.
 #include "AtomicPrimitives.h"
 #include "PSMoveController.h"
 #include "ControllerDeviceEnumerator.h"
+#include "ControllerOutputScheduler.h"
 #include "ServerLog.h"
 #include "ServerUtility.h"
 #include "BluetoothQueries.h"
@@ -76,6 +77,9 @@ POSSIBILITY OF SUCH DAMAGE.
 /* Minimum time (in milliseconds) psmove write updates */
 #define PSMOVE_WRITE_DATA_INTERVAL_MS 120
 
+/* Time (in milliseconds) between rewrites of a lit LED or running rumble, which the controller otherwise times out */
+#define PSMOVE_KEEPALIVE_WRITE_INTERVAL_MS 1000
+
 /* Decode 12-bit signed value (assuming two's complement) */
 #define TWELVE_BIT_SIGNED(x) (((x) & 0x800)?(-(((~(x)) & 0xFFF) + 1)):(x))
 
@@ -241,6 +245,65 @@ struct PSMoveDataInput
 	} data;
 };
 
+class PSMoveOutputScheduler : public ControllerOutputScheduler<PSMoveControllerOutputState>
+{
+public:
+	PSMoveOutputScheduler()
+		: ControllerOutputScheduler<PSMoveControllerOutputState>(
+			"PSMoveOutputScheduler", PSMOVE_WRITE_DATA_INTERVAL_MS, PSMOVE_KEEPALIVE_WRITE_INTERVAL_MS)
+		, m_hidDevice(nullptr)
+	{
+	}
+
+	void start(hid_device *in_hid_device, const std::string &statistic_prefix)
+	{
+		m_hidDevice= in_hid_device;
+		ControllerOutputScheduler<PSMoveControllerOutputState>::start(statistic_prefix);
+	}
+
+protected:
+	virtual bool writeOutputState(const PSMoveControllerOutputState &output_state) override
+	{
+		PSMoveDataOutput data_out;
+		memset(&data_out, 0, sizeof(PSMoveDataOutput));
+		data_out.type = PSMove_Req_SetLEDs;
+		data_out.r = output_state.r;
+		data_out.g = output_state.g;
+		data_out.b = output_state.b;
+		data_out.rumble = output_state.rumble;
+		data_out.rumble2 = 0x00;
+
+		int res = hid_write(m_hidDevice, (unsigned char*)(&data_out), sizeof(data_out));
+		if (res <= 0)
+		{
+			char hidapi_err_mbs[256];
+			bool valid_error_mesg = 
+				ServerUtility::convert_wcs_to_mbs(hid_error(m_hidDevice), hidapi_err_mbs, sizeof(hidapi_err_mbs));
+
+			// Device no longer in valid state.
+			if (valid_error_mesg)
+			{
+				SERVER_MT_LOG_ERROR("PSMoveOutputScheduler::writeOutputState") << "HID ERROR: " << hidapi_err_mbs;
+			}
+		}
+
+		return res > 0;
+	}
+
+	virtual bool isSameOutputState(const PSMoveControllerOutputState &a, const PSMoveControllerOutputState &b) const override
+	{
+		return a.r == b.r && a.g == b.g && a.b == b.b && a.rumble == b.rumble;
+	}
+
+	virtual bool needsKeepAlive(const PSMoveControllerOutputState &output_state) const override
+	{
+		// The bulb and rumble motor switch off a few seconds after the last write
+		return output_state.r != 0 || output_state.g != 0 || output_state.b != 0 || output_state.rumble != 0;
+	}
+
+	hid_device *m_hidDevice;
+};
+
 class PSMoveHidPacketProcessor : public WorkerThread
 {
 public:
@@ -268,8 +331,6 @@ public:
 			m_currentHIDInputPacket.data.zcm1.type = PSMove_Req_GetInput;
 
 		}
-
-		memset(&m_previousOutputState, 0, sizeof(PSMoveControllerOutputState));
 	}
 
 	void setConfig(const PSMoveControllerConfig &cfg)
@@ -289,7 +350,7 @@ public:
 
 	void postOutputState(const PSMoveControllerOutputState &output_state)
 	{
-		m_currentOutputState.storeValue(output_state);
+		m_outputScheduler.postOutputState(output_state);
 	}
 
     void start(hid_device *in_hid_device, IControllerListener *controller_listener)
@@ -310,11 +371,17 @@ public:
 
 			// Fire up the worker thread
 			WorkerThread::startThread();
+
+			// LED and rumble writes happen on their own thread so they don't wait on a read
+			m_outputScheduler.start(
+				m_hidDevice,
+				m_controllerListener != nullptr ? m_controllerListener->getStatisticPrefix() : "controller");
 		}
     }
 
 	void stop()
 	{
+		m_outputScheduler.stop();
 		WorkerThread::stopThread();
 	}
 
@@ -418,61 +485,6 @@ protected:
 			return false;
 		}
 
-        // Don't send output writes too frequently
-        {
-            std::chrono::time_point<std::chrono::high_resolution_clock> now = std::chrono::high_resolution_clock::now();
-
-            // See if it's time to update the LED/rumble state
-            std::chrono::duration<double, std::milli> led_update_diff = now - m_lastHIDOutputTimestamp;
-            if (led_update_diff.count() >= PSMOVE_WRITE_DATA_INTERVAL_MS)
-            {
-				PSMoveControllerOutputState output_state;
-				m_currentOutputState.fetchValue(output_state);
-
-				const bool bWriteStateChanged=
-					output_state.r != m_previousOutputState.r ||
-					output_state.g != m_previousOutputState.g ||
-					output_state.b != m_previousOutputState.b ||
-					output_state.rumble != m_previousOutputState.rumble;
-				const bool bWriteStateNonZero=
-					output_state.r != 0 ||
-					output_state.g != 0 ||
-					output_state.b != 0 ||
-					output_state.rumble != 0;
-
-				if (bWriteStateChanged || bWriteStateNonZero)
-				{
-					PSMoveDataOutput data_out;
-					memset(&data_out, 0, sizeof(PSMoveDataOutput));
-					data_out.type = PSMove_Req_SetLEDs;
-					data_out.r = output_state.r;
-					data_out.g = output_state.g;
-					data_out.b = output_state.b;
-					data_out.rumble = output_state.rumble;
-					data_out.rumble2 = 0x00;
-
-					res = hid_write(m_hidDevice, (unsigned char*)(&data_out), sizeof(data_out));
-					if (res > 0)
-					{
-						m_previousOutputState= output_state;
-						m_lastHIDOutputTimestamp = now;
-					}
-					else
-					{
-						char hidapi_err_mbs[256];
-						bool valid_error_mesg = 
-							ServerUtility::convert_wcs_to_mbs(hid_error(m_hidDevice), hidapi_err_mbs, sizeof(hidapi_err_mbs));
-
-						// Device no longer in valid state.
-						if (valid_error_mesg)
-						{
-							SERVER_MT_LOG_ERROR("PSMoveSensorProcessor::doWork") << "HID ERROR: " << hidapi_err_mbs;
-						}
-					}
-				}
-            }
-        }
-
 		return true;
     }
 
@@ -482,15 +494,13 @@ protected:
 	IControllerListener *m_controllerListener;
 	bool m_bSupportsMagnetometer;
 	AtomicObject<PSMoveControllerInputState> m_currentInputState;
-	AtomicObject<PSMoveControllerOutputState> m_currentOutputState;
 	AtomicObject<PSMoveControllerConfig> m_cfg;
+	PSMoveOutputScheduler m_outputScheduler;
 
     // Worker thread state
     int m_nextPollSequenceNumber;
 	PSMoveDataInput m_previousHIDInputPacket;
     PSMoveDataInput m_currentHIDInputPacket;
-	std::chrono::time_point<std::chrono::high_resolution_clock> m_lastHIDOutputTimestamp;
-	PSMoveControllerOutputState m_previousOutputState;
 };
 
 // -- private prototypes -----
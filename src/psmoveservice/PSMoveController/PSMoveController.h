@@ -11,6 +11,11 @@
 #include <deque>
 #include <chrono>
 
+// The 16-bit timestamp in every input report.
+// Its units aren't documented, so the tick period is only measured against the host clock.
+#define PSMOVE_IMU_TIMESTAMP_BITS 16
+#define PSMOVE_IMU_TIMESTAMP_TICK_SECONDS 0.0
+
 enum PSMoveControllerModelPID
 {
 	_psmove_controller_ZCM1= 0x03d5,
@@ -182,7 +187,7 @@ struct PSMoveControllerInputState : public CommonControllerState
     int RawSequence;                            // 4-bit (1..16).
                                                 // Sometimes frames are dropped.
     
-    unsigned int RawTimeStamp;                  // 16-bit (time since ?, units?)
+    unsigned int RawTimeStamp;                  // 16-bit (free running, units?)
                                                 // About 1150 between in-order frames.
 
     ButtonState Triangle;
@@ -6,10 +6,13 @@
 #include "PSMoveProtocol.pb.h"
 #include "TrackerDeviceEnumerator.h"
 #include "TrackerManager.h"
+#include "VideoFramePool.h"
 #include "opencv2/opencv.hpp"
 
 // -- constants -----
-#define PS3EYE_STATE_BUFFER_MAX 16
+// One frame held by the tracker, one held by the tracker view, one being captured, one spare,
+// plus up to four held by the optical pipeline (two queued, one waiting on the queue, one being searched)
+#define PS3EYE_VIDEO_FRAME_POOL_SIZE 8
 
 static const char *OPTION_FOV_SETTING = "FOV Setting";
 static const char *OPTION_FOV_RED_DOT = "Red Dot";
@@ -21,11 +24,43 @@ class PSEyeCaptureData
 public:
     PSEyeCaptureData()
         : frame()
+        , framePool(nullptr)
     {
 
     }
 
-    cv::Mat frame;
+    ~PSEyeCaptureData()
+    {
+        frame.reset();
+
+        if (framePool != nullptr)
+        {
+            VideoFramePool::dispose(framePool);
+        }
+    }
+
+    // Get a free BGR frame buffer for the current frame dimensions.
+    // The pool is only (re)allocated when the frame dimensions change.
+    VideoFrameRef acquireFrameBuffer(int width, int height)
+    {
+        const size_t buffer_size = static_cast<size_t>(width*height*3);
+
+        if (framePool != nullptr && framePool->getBufferSize() != buffer_size)
+        {
+            VideoFramePool::dispose(framePool);
+            framePool = nullptr;
+        }
+
+        if (framePool == nullptr)
+        {
+            framePool = VideoFramePool::allocate(buffer_size, PS3EYE_VIDEO_FRAME_POOL_SIZE);
+        }
+
+        return framePool->acquireBuffer();
+    }
+
+    VideoFrameRef frame; // Last captured frame
+    VideoFramePool *framePool;
 };
 
 // -- public methods
@@ -217,7 +252,7 @@ PS3EyeTrackerConfig::getColorRangeTable(const std::string &table_name) const
 	return table;
 }
 
-inline CommonHSVColorRangeTable *
+CommonHSVColorRangeTable *
 PS3EyeTrackerConfig::getOrAddColorRangeTable(const std::string &table_name)
 {
 	CommonHSVColorRangeTable *table= nullptr;	
@@ -262,7 +297,9 @@ PS3EyeTracker::PS3EyeTracker()
     , CaptureData(nullptr)
     , DriverType(PS3EyeTracker::Libusb)
     , NextPollSequenceNumber(0)
+    , DroppedFrameCount(0)
     , TrackerStates()
+    , CachedStates()
 {
 }
 
@@ -277,7 +314,7 @@ PS3EyeTracker::~PS3EyeTracker()
 // PSMoveTracker
 bool PS3EyeTracker::open() // Opens the first HID device for the tracker
 {
-    TrackerDeviceEnumerator enumerator;
+    TrackerDeviceEnumerator enumerator(TrackerDeviceEnumerator::CommunicationType_USB);
     bool success = false;
 
     // Skip over everything that isn't a PS3EYE
@@ -384,16 +421,38 @@ IDeviceInterface::ePollResult PS3EyeTracker::poll()
 
     if (getIsOpen())
     {
-        if (!VideoCapture->grab() || 
-            !VideoCapture->retrieve(CaptureData->frame, cv::CAP_OPENNI_BGR_IMAGE))
-        {
-            // Device still in valid state
-            result = IControllerInterface::_PollResultSuccessNoData;
-        }
-        else
+        // Device still in valid state
+        result = IControllerInterface::_PollResultSuccessNoData;
+
+        if (VideoCapture->grab())
         {
-            // New data available. Keep iterating.
-            result = IControllerInterface::_PollResultSuccessNewData;
+            const int width = static_cast<int>(VideoCapture->get(cv::CAP_PROP_FRAME_WIDTH));
+            const int height = static_cast<int>(VideoCapture->get(cv::CAP_PROP_FRAME_HEIGHT));
+
+            // Demosaic straight into a pooled frame buffer.
+            // If every buffer is still in use downstream this frame gets dropped.
+            VideoFrameRef frame_buffer = CaptureData->acquireFrameBuffer(width, height);
+
+            if (frame_buffer.isValid())
+            {
+                cv::Mat frame(height, width, CV_8UC3, frame_buffer->getData());
+
+                // A capture that doesn't output a frame of the expected size/format 
+                // reallocates the mat rather than writing into the frame buffer
+                if (VideoCapture->retrieve(frame, cv::CAP_OPENNI_BGR_IMAGE) &&
+                    frame.data == frame_buffer->getData())
+                {
+                    CaptureData->frame = frame_buffer;
+
+                    // New data available. Keep iterating.
+                    result = IControllerInterface::_PollResultSuccessNewData;
+                }
+            }
+
+            if (result != IControllerInterface::_PollResultSuccessNewData)
+            {
+                ++DroppedFrameCount;
+            }
         }
 
         {
@@ -405,14 +464,8 @@ IDeviceInterface::ePollResult PS3EyeTracker::poll()
             newState.PollSequenceNumber = NextPollSequenceNumber;
             ++NextPollSequenceNumber;
 
-            // Make room for new entry if at the max queue size
-            //###bwalker $TODO Make this a fixed size circular buffer
-            if (TrackerStates.size() >= PS3EYE_STATE_BUFFER_MAX)
-            {
-                TrackerStates.erase(TrackerStates.begin(), TrackerStates.begin() + TrackerStates.size() - PS3EYE_STATE_BUFFER_MAX);
-            }
-
-            TrackerStates.push_back(newState);
+            // Overwrites the oldest entry once the history is full
+            TrackerStates.push(newState.PollSequenceNumber, newState);
         }
     }
 
@@ -446,11 +499,30 @@ CommonDeviceState::eDeviceType PS3EyeTracker::getDeviceType() const
 
 const CommonDeviceState *PS3EyeTracker::getState(int lookBack) const
 {
-    const int queueSize = static_cast<int>(TrackerStates.size());
-    const CommonDeviceState * result =
-        (lookBack < queueSize) ? &TrackerStates.at(queueSize - lookBack - 1) : nullptr;
+    // The ring may be written while we copy out of it, so hand out a copy.
+    // Each lookBack has its own copy, only refreshed by the next getState() with the same lookBack.
+    PS3EyeTrackerState state;
+    if (lookBack < 0 || lookBack >= PS3EYE_STATE_BUFFER_MAX || !TrackerStates.fetchState(lookBack, state))
+    {
+        return nullptr;
+    }
 
-    return result;
+    CachedStates[lookBack] = state;
+    return &CachedStates[lookBack];
+}
+
+bool PS3EyeTracker::fetchState(int lookBack, PS3EyeTrackerState &out_state) const
+{
+    return TrackerStates.fetchState(lookBack, out_state);
+}
+
+int PS3EyeTracker::visitStatesNewerThan(
+    int poll_sequence_number,
+    const std::function<void(const CommonDeviceState *)> &visitor) const
+{
+    return TrackerStates.visitNewerThan(
+        poll_sequence_number,
+        [&visitor](const PS3EyeTrackerState &state) { visitor(&state); });
 }
 
 ITrackerInterface::eDriverType PS3EyeTracker::getDriverType() const
@@ -522,13 +594,18 @@ bool PS3EyeTracker::getVideoFrameDimensions(
     return bSuccess;
 }
 
-const unsigned char *PS3EyeTracker::getVideoFrameBuffer() const
+int PS3EyeTracker::getDroppedFrameCount() const
+{
+    return DroppedFrameCount;
+}
+
+VideoFrameRef PS3EyeTracker::getVideoFrame() const
 {
-    const unsigned char *result = nullptr;
+    VideoFrameRef result;
 
     if (CaptureData != nullptr)
     {
-        return static_cast<const unsigned char *>(CaptureData->frame.data);
+        result = CaptureData->frame;
     }
 
     return result;
@@ -3,11 +3,11 @@
 
 // -- includes -----
 #include "PSMoveConfig.h"
+#include "AtomicPrimitives.h"
 #include "DeviceEnumerator.h"
 #include "DeviceInterface.h"
 #include <string>
 #include <vector>
-#include <deque>
 
 // -- pre-declarations -----
 namespace PSMoveProtocol
@@ -15,6 +15,10 @@ namespace PSMoveProtocol
     class Response_ResultTrackerSettings;
 };
 
+// -- constants -----
+// Number of polled states kept in the tracker's state history
+#define PS3EYE_STATE_BUFFER_MAX 16
+
 // -- definitions -----
 class PS3EyeTrackerConfig : public PSMoveConfig
 {
@@ -33,7 +37,7 @@ public:
     virtual void ptree2config(const boost::property_tree::ptree &pt);
 
 	const CommonHSVColorRangeTable *getColorRangeTable(const std::string &table_name) const;
-	inline CommonHSVColorRangeTable *getOrAddColorRangeTable(const std::string &table_name);
+	CommonHSVColorRangeTable *getOrAddColorRangeTable(const std::string &table_name);
     
     bool is_valid;
     long max_poll_failure_count;
@@ -99,12 +103,16 @@ public:
     { return CommonDeviceState::PS3EYE; }
     CommonDeviceState::eDeviceType getDeviceType() const override;
     const CommonDeviceState *getState(int lookBack = 0) const override;
+    int visitStatesNewerThan(
+        int poll_sequence_number,
+        const std::function<void(const CommonDeviceState *)> &visitor) const override;
     
     // -- ITrackerInterface
     ITrackerInterface::eDriverType getDriverType() const override;
     std::string getUSBDevicePath() const override;
     bool getVideoFrameDimensions(int *out_width, int *out_height, int *out_stride) const override;
-    const unsigned char *getVideoFrameBuffer() const override;
+    VideoFrameRef getVideoFrame() const override;
+    int getDroppedFrameCount() const override;
     void loadSettings() override;
     void saveSettings() override;
 	void setFrameWidth(double value, bool bUpdateConfig) override;
@@ -139,6 +147,9 @@ public:
     void getTrackingColorPreset(const std::string &controller_serial, eCommonTrackingColorID color, CommonHSVColorRange *out_preset) const override;
 
     // -- Getters
+    // Copy out the tracker state at the given sample index.
+    // Unlike getState() the copy belongs to the caller, so prefer this for anything held onto.
+    bool fetchState(int lookBack, PS3EyeTrackerState &out_state) const;
     inline const PS3EyeTrackerConfig &getConfig() const
     { return cfg; }
 
@@ -151,6 +162,8 @@ private:
     
     // Read Controller State
     int NextPollSequenceNumber;
-    std::deque<PS3EyeTrackerState> TrackerStates;
+    int DroppedFrameCount;
+    AtomicStateRing<PS3EyeTrackerState, PS3EYE_STATE_BUFFER_MAX> TrackerStates;
+    mutable PS3EyeTrackerState CachedStates[PS3EYE_STATE_BUFFER_MAX]; // Last state handed out by getState(), per lookBack
 };
 #endif // PS3EYE_TRACKER_H
@@ -0,0 +1,426 @@
+// -- includes -----
+#include "RemoteTracker.h"
+#include "ServerLog.h"
+#include "PSMoveProtocol.pb.h"
+#include "TrackerDeviceEnumerator.h"
+#include "TrackerNodeManager.h"
+#include "VideoFramePool.h"
+
+// -- constants -----
+// The node sends a (possibly empty) projection packet for every video frame,
+// so this is the number of polls without a new frame before the tracker is closed
+static const long k_remote_tracker_max_poll_failure_count = 200;
+
+// -- Remote Tracker
+RemoteTracker::RemoteTracker()
+    : cfg()
+    , m_device_path()
+    , m_bIsOpen(false)
+    , m_latest_frame()
+    , m_dropped_frame_count(0)
+    , m_next_poll_sequence_number(0)
+    , m_tracker_state()
+{
+    m_latest_frame.clear();
+}
+
+RemoteTracker::~RemoteTracker()
+{
+    if (getIsOpen())
+    {
+        SERVER_LOG_ERROR("~RemoteTracker") << "Tracker deleted without calling close() first!";
+    }
+}
+
+// -- IDeviceInterface
+bool RemoteTracker::matchesDeviceEnumerator(const DeviceEnumerator *enumerator) const
+{
+    const TrackerDeviceEnumerator *pEnum = static_cast<const TrackerDeviceEnumerator *>(enumerator);
+
+    return
+        pEnum->get_api_type() == TrackerDeviceEnumerator::CommunicationType_REMOTE &&
+        m_device_path == pEnum->get_path();
+}
+
+bool RemoteTracker::open(const DeviceEnumerator *enumerator)
+{
+    const TrackerDeviceEnumerator *tracker_enumerator = static_cast<const TrackerDeviceEnumerator *>(enumerator);
+    const RemoteTrackerCamera *camera = tracker_enumerator->get_remote_camera();
+
+    bool bSuccess = false;
+
+    if (getIsOpen())
+    {
+        SERVER_LOG_WARNING("RemoteTracker::open") << "RemoteTracker(" << m_device_path << ") already open. Ignoring request.";
+        bSuccess = true;
+    }
+    else if (camera != nullptr && camera->bIsConnected)
+    {
+        SERVER_LOG_INFO("RemoteTracker::open") << "Opening RemoteTracker(" << camera->device_path << ")";
+
+        m_device_path = camera->device_path;
+        m_latest_frame.clear();
+        m_dropped_frame_count = 0;
+
+        // "remote:<node>:<camera>" isn't a valid file name on every platform
+        std::string config_name = "RemoteTrackerConfig_" + camera->node_name + "_" + std::to_string(camera->info.camera_index);
+        cfg = PS3EyeTrackerConfig(config_name);
+
+        // Load the pose and color presets.
+        // Save the config back out again in case defaults changed.
+        cfg.load();
+        cfg.save();
+
+        m_bIsOpen = true;
+        bSuccess = true;
+    }
+    else
+    {
+        SERVER_LOG_ERROR("RemoteTracker::open") << "Failed to open RemoteTracker(" << tracker_enumerator->get_path() << ")";
+    }
+
+    return bSuccess;
+}
+
+bool RemoteTracker::getIsOpen() const
+{
+    return m_bIsOpen;
+}
+
+bool RemoteTracker::getIsReadyToPoll() const
+{
+    return getIsOpen();
+}
+
+IDeviceInterface::ePollResult RemoteTracker::poll()
+{
+    IDeviceInterface::ePollResult result = IDeviceInterface::_PollResultFailure;
+    const RemoteTrackerCamera *camera = findCamera();
+
+    // The tracker goes away with its node
+    if (getIsOpen() && camera != nullptr && camera->bIsConnected)
+    {
+        result = IDeviceInterface::_PollResultSuccessNoData;
+
+        const RemoteTrackerFrame &frame = camera->latest_frame;
+
+        if (frame.frame_sequence_num != m_latest_frame.frame_sequence_num)
+        {
+            // Frames the node processed that never made it here (or arrived out of order)
+            if (m_latest_frame.frame_sequence_num >= 0 &&
+                frame.frame_sequence_num > m_latest_frame.frame_sequence_num + 1)
+            {
+                m_dropped_frame_count += frame.frame_sequence_num - m_latest_frame.frame_sequence_num - 1;
+            }
+
+            m_latest_frame = frame;
+
+            m_tracker_state.PollSequenceNumber = m_next_poll_sequence_number;
+            ++m_next_poll_sequence_number;
+
+            result = IDeviceInterface::_PollResultSuccessNewData;
+        }
+    }
+
+    return result;
+}
+
+void RemoteTracker::close()
+{
+    if (m_bIsOpen)
+    {
+        SERVER_LOG_INFO("RemoteTracker::close") << "Closing RemoteTracker(" << m_device_path << ")";
+        m_bIsOpen = false;
+    }
+}
+
+long RemoteTracker::getMaxPollFailureCount() const
+{
+    return k_remote_tracker_max_poll_failure_count;
+}
+
+CommonDeviceState::eDeviceType RemoteTracker::getDeviceType() const
+{
+    return CommonDeviceState::PS3EYE;
+}
+
+const CommonDeviceState *RemoteTracker::getState(int lookBack) const
+{
+    return (lookBack == 0) ? &m_tracker_state : nullptr;
+}
+
+// -- ITrackerInterface
+ITrackerInterface::eDriverType RemoteTracker::getDriverType() const
+{
+    return ITrackerInterface::Remote;
+}
+
+std::string RemoteTracker::getUSBDevicePath() const
+{
+    return m_device_path;
+}
+
+bool RemoteTracker::getVideoFrameDimensions(
+    int *out_width,
+    int *out_height,
+    int *out_stride) const
+{
+    const RemoteTrackerCamera *camera = findCamera();
+    const int width = (camera != nullptr) ? camera->info.frame_width : static_cast<int>(cfg.frame_width);
+    const int height = (camera != nullptr) ? camera->info.frame_height : static_cast<int>(cfg.frame_height);
+
+    if (out_width != nullptr)
+    {
+        *out_width = width;
+    }
+
+    if (out_height != nullptr)
+    {
+        *out_height = height;
+    }
+
+    if (out_stride != nullptr)
+    {
+        // The frames would be BGR, if we had them
+        *out_stride = 3 * width;
+    }
+
+    return true;
+}
+
+VideoFrameRef RemoteTracker::getVideoFrame() const
+{
+    // The video stays on the node
+    return VideoFrameRef();
+}
+
+int RemoteTracker::getDroppedFrameCount() const
+{
+    return m_dropped_frame_count;
+}
+
+void RemoteTracker::loadSettings()
+{
+    cfg.load();
+}
+
+void RemoteTracker::saveSettings()
+{
+    cfg.save();
+}
+
+// The camera settings belong to the tracker node.
+// Changing them here only updates what the central service remembers about the camera.
+void RemoteTracker::setFrameWidth(double value, bool bUpdateConfig)
+{
+    SERVER_LOG_WARNING("RemoteTracker::setFrameWidth") << "Frame width of " << m_device_path << " must be set on its tracker node";
+}
+
+double RemoteTracker::getFrameWidth() const
+{
+    int width;
+    getVideoFrameDimensions(&width, nullptr, nullptr);
+
+    return static_cast<double>(width);
+}
+
+void RemoteTracker::setFrameHeight(double value, bool bUpdateConfig)
+{
+    SERVER_LOG_WARNING("RemoteTracker::setFrameHeight") << "Frame height of " << m_device_path << " must be set on its tracker node";
+}
+
+double RemoteTracker::getFrameHeight() const
+{
+    int height;
+    getVideoFrameDimensions(nullptr, &height, nullptr);
+
+    return static_cast<double>(height);
+}
+
+void RemoteTracker::setFrameRate(double value, bool bUpdateConfig)
+{
+    SERVER_LOG_WARNING("RemoteTracker::setFrameRate") << "Frame rate of " << m_device_path << " must be set on its tracker node";
+}
+
+double RemoteTracker::getFrameRate() const
+{
+    const RemoteTrackerCamera *camera = findCamera();
+
+    return (camera != nullptr) ? camera->info.frame_rate : cfg.frame_rate;
+}
+
+void RemoteTracker::setExposure(double value, bool bUpdateConfig)
+{
+    SERVER_LOG_WARNING("RemoteTracker::setExposure") << "Exposure of " << m_device_path << " must be set on its tracker node";
+}
+
+double RemoteTracker::getExposure() const
+{
+    return cfg.exposure;
+}
+
+void RemoteTracker::setGain(double value, bool bUpdateConfig)
+{
+    SERVER_LOG_WARNING("RemoteTracker::setGain") << "Gain of " << m_device_path << " must be set on its tracker node";
+}
+
+double RemoteTracker::getGain() const
+{
+    return cfg.gain;
+}
+
+void RemoteTracker::getCameraIntrinsics(
+    float &outFocalLengthX, float &outFocalLengthY,
+    float &outPrincipalX, float &outPrincipalY,
+    float &outDistortionK1, float &outDistortionK2, float &outDistortionK3,
+    float &outDistortionP1, float &outDistortionP2) const
+{
+    const RemoteTrackerCamera *camera = findCamera();
+
+    if (camera != nullptr)
+    {
+        // The lens is calibrated on the node
+        outFocalLengthX = camera->info.focal_length_x;
+        outFocalLengthY = camera->info.focal_length_y;
+        outPrincipalX = camera->info.principal_x;
+        outPrincipalY = camera->info.principal_y;
+        outDistortionK1 = camera->info.distortion_k1;
+        outDistortionK2 = camera->info.distortion_k2;
+        outDistortionK3 = camera->info.distortion_k3;
+        outDistortionP1 = camera->info.distortion_p1;
+        outDistortionP2 = camera->info.distortion_p2;
+    }
+    else
+    {
+        outFocalLengthX = static_cast<float>(cfg.focalLengthX);
+        outFocalLengthY = static_cast<float>(cfg.focalLengthY);
+        outPrincipalX = static_cast<float>(cfg.principalX);
+        outPrincipalY = static_cast<float>(cfg.principalY);
+        outDistortionK1 = static_cast<float>(cfg.distortionK1);
+        outDistortionK2 = static_cast<float>(cfg.distortionK2);
+        outDistortionK3 = static_cast<float>(cfg.distortionK3);
+        outDistortionP1 = static_cast<float>(cfg.distortionP1);
+        outDistortionP2 = static_cast<float>(cfg.distortionP2);
+    }
+}
+
+void RemoteTracker::setCameraIntrinsics(
+    float focalLengthX, float focalLengthY,
+    float principalX, float principalY,
+    float distortionK1, float distortionK2, float distortionK3,
+    float distortionP1, float distortionP2)
+{
+    SERVER_LOG_WARNING("RemoteTracker::setCameraIntrinsics") << "Lens of " << m_device_path << " must be calibrated on its tracker node";
+}
+
+CommonDevicePose RemoteTracker::getTrackerPose() const
+{
+    return cfg.pose;
+}
+
+void RemoteTracker::setTrackerPose(
+    const struct CommonDevicePose *pose)
+{
+    cfg.pose = *pose;
+    cfg.save();
+}
+
+void RemoteTracker::getFOV(float &outHFOV, float &outVFOV) const
+{
+    const RemoteTrackerCamera *camera = findCamera();
+
+    outHFOV = (camera != nullptr) ? camera->info.hfov : static_cast<float>(cfg.hfov);
+    outVFOV = (camera != nullptr) ? camera->info.vfov : static_cast<float>(cfg.vfov);
+}
+
+void RemoteTracker::getZRange(float &outZNear, float &outZFar) const
+{
+    const RemoteTrackerCamera *camera = findCamera();
+
+    outZNear = (camera != nullptr) ? camera->info.znear : static_cast<float>(cfg.zNear);
+    outZFar = (camera != nullptr) ? camera->info.zfar : static_cast<float>(cfg.zFar);
+}
+
+void RemoteTracker::gatherTrackerOptions(
+    PSMoveProtocol::Response_ResultTrackerSettings* settings) const
+{
+    // No options to set remotely
+}
+
+bool RemoteTracker::setOptionIndex(
+    const std::string &option_name,
+    int option_index)
+{
+    return false;
+}
+
+bool RemoteTracker::getOptionIndex(
+    const std::string &option_name,
+    int &out_option_index) const
+{
+    return false;
+}
+
+void RemoteTracker::gatherTrackingColorPresets(
+    const std::string &controller_serial,
+    PSMoveProtocol::Response_ResultTrackerSettings* settings) const
+{
+    const CommonHSVColorRangeTable *table= cfg.getColorRangeTable(controller_serial);
+
+    for (int list_index = 0; list_index < MAX_TRACKING_COLOR_TYPES; ++list_index)
+    {
+        const CommonHSVColorRange &hsvRange = table->color_presets[list_index];
+        const eCommonTrackingColorID colorType = static_cast<eCommonTrackingColorID>(list_index);
+
+        PSMoveProtocol::TrackingColorPreset *colorPreset= settings->add_color_presets();
+        colorPreset->set_color_type(static_cast<PSMoveProtocol::TrackingColorType>(colorType));
+        colorPreset->set_hue_center(hsvRange.hue_range.center);
+        colorPreset->set_hue_range(hsvRange.hue_range.range);
+        colorPreset->set_saturation_center(hsvRange.saturation_range.center);
+        colorPreset->set_saturation_range(hsvRange.saturation_range.range);
+        colorPreset->set_value_center(hsvRange.value_range.center);
+        colorPreset->set_value_range(hsvRange.value_range.range);
+    }
+}
+
+void RemoteTracker::setTrackingColorPreset(
+    const std::string &controller_serial,
+    eCommonTrackingColorID color,
+    const CommonHSVColorRange *preset)
+{
+    CommonHSVColorRangeTable *table= cfg.getOrAddColorRangeTable(controller_serial);
+
+    table->color_presets[color] = *preset;
+    cfg.save();
+}
+
+void RemoteTracker::getTrackingColorPreset(
+    const std::string &controller_serial,
+    eCommonTrackingColorID color,
+    CommonHSVColorRange *out_preset) const
+{
+    const CommonHSVColorRangeTable *table= cfg.getColorRangeTable(controller_serial);
+
+    *out_preset = table->color_presets[color];
+}
+
+// -- Remote Tracker
+void RemoteTracker::sendTargets(const std::vector<RemoteTrackerTarget> &targets)
+{
+    TrackerNodeManager *node_manager = TrackerNodeManager::get_instance();
+
+    if (getIsOpen() && node_manager != nullptr)
+    {
+        node_manager->sendRemoteCameraTargets(m_device_path, targets);
+    }
+}
+
+const RemoteTrackerCamera *RemoteTracker::findCamera() const
+{
+    const TrackerNodeManager *node_manager = TrackerNodeManager::get_instance();
+
+    return
+        (m_bIsOpen && node_manager != nullptr)
+        ? node_manager->findRemoteCamera(m_device_path)
+        : nullptr;
+}
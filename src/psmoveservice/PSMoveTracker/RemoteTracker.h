@@ -0,0 +1,178 @@
+#ifndef REMOTE_TRACKER_H
+#define REMOTE_TRACKER_H
+
+// -- includes -----
+#include "PS3EyeTracker.h"
+#include "DeviceEnumerator.h"
+#include "DeviceInterface.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+// -- pre-declarations -----
+namespace PSMoveProtocol
+{
+    class Response_ResultTrackerSettings;
+};
+
+// -- definitions -----
+/// A device the central service wants a tracker node to find in its video frames
+struct RemoteTrackerTarget
+{
+    int device_category; // PSMoveProtocol::DeviceOutputDataFrame::DeviceCategory (CONTROLLER or HMD)
+    int device_id;
+    CommonHSVColorRange hsv_color_range;
+    CommonDeviceTrackingShape tracking_shape;
+
+    // Region of the frame to search (an empty region means the whole frame)
+    int roi_x;
+    int roi_y;
+    int roi_width;
+    int roi_height;
+
+    // > 1: the region is the whole frame, only search around the biggest blob
+    // found in a copy of the frame decimated by this much (a periodic recovery scan)
+    int scan_decimation;
+};
+
+/// A device projection a tracker node found in one of its video frames
+struct RemoteTrackerProjection
+{
+    int device_category; // PSMoveProtocol::DeviceOutputDataFrame::DeviceCategory (CONTROLLER or HMD)
+    int device_id;
+    CommonDeviceTrackingProjection projection;
+    CommonDevicePosition position_cm; // tracker relative, only valid for sphere projections
+    bool bPositionValid;
+};
+
+/// All of the projections a tracker node found in one video frame
+struct RemoteTrackerFrame
+{
+    int frame_sequence_num;
+    std::chrono::time_point<std::chrono::high_resolution_clock> capture_timestamp; // in the central service clock
+    std::vector<RemoteTrackerProjection> projections;
+
+    inline void clear()
+    {
+        frame_sequence_num = -1;
+        capture_timestamp = std::chrono::time_point<std::chrono::high_resolution_clock>();
+        projections.clear();
+    }
+};
+
+/// Properties of a camera attached to a tracker node, as announced by the node
+struct RemoteTrackerCameraInfo
+{
+    int camera_index;
+    std::string device_path;
+    int frame_width;
+    int frame_height;
+    float frame_rate;
+    float focal_length_x;
+    float focal_length_y;
+    float principal_x;
+    float principal_y;
+    float distortion_k1;
+    float distortion_k2;
+    float distortion_k3;
+    float distortion_p1;
+    float distortion_p2;
+    float hfov;
+    float vfov;
+    float znear;
+    float zfar;
+};
+
+/// A camera attached to a tracker node, as seen by the central service
+struct RemoteTrackerCamera
+{
+    std::string node_name;
+    std::string device_path; // path used by the central service: "remote:<node name>:<camera index>"
+    RemoteTrackerCameraInfo info;
+    RemoteTrackerFrame latest_frame;
+    bool bIsConnected;
+};
+
+/// A camera on a tracker node.
+/// The node does the video capture and blob segmentation, this device only receives the projections.
+/// The tracker pose and color presets are stored on the central service,
+/// the lens intrinsics and camera settings belong to the node.
+class RemoteTracker : public ITrackerInterface {
+public:
+    RemoteTracker();
+    virtual ~RemoteTracker();
+
+    // -- IDeviceInterface
+    bool matchesDeviceEnumerator(const DeviceEnumerator *enumerator) const override;
+    bool open(const DeviceEnumerator *enumerator) override;
+    bool getIsOpen() const override;
+    bool getIsReadyToPoll() const override;
+    IDeviceInterface::ePollResult poll() override;
+    void close() override;
+    long getMaxPollFailureCount() const override;
+    static CommonDeviceState::eDeviceType getDeviceTypeStatic()
+    { return CommonDeviceState::PS3EYE; }
+    CommonDeviceState::eDeviceType getDeviceType() const override;
+    const CommonDeviceState *getState(int lookBack = 0) const override;
+
+    // -- ITrackerInterface
+    ITrackerInterface::eDriverType getDriverType() const override;
+    std::string getUSBDevicePath() const override;
+    bool getVideoFrameDimensions(int *out_width, int *out_height, int *out_stride) const override;
+    VideoFrameRef getVideoFrame() const override;
+    int getDroppedFrameCount() const override;
+    void loadSettings() override;
+    void saveSettings() override;
+    void setFrameWidth(double value, bool bUpdateConfig) override;
+    double getFrameWidth() const override;
+    void setFrameHeight(double value, bool bUpdateConfig) override;
+    double getFrameHeight() const override;
+    void setFrameRate(double value, bool bUpdateConfig) override;
+    double getFrameRate() const override;
+    void setExposure(double value, bool bUpdateConfig) override;
+    double getExposure() const override;
+    void setGain(double value, bool bUpdateConfig) override;
+    double getGain() const override;
+    void getCameraIntrinsics(
+        float &outFocalLengthX, float &outFocalLengthY,
+        float &outPrincipalX, float &outPrincipalY,
+        float &outDistortionK1, float &outDistortionK2, float &outDistortionK3,
+        float &outDistortionP1, float &outDistortionP2) const override;
+    void setCameraIntrinsics(
+        float focalLengthX, float focalLengthY,
+        float principalX, float principalY,
+        float distortionK1, float distortionK2, float distortionK3,
+        float distortionP1, float distortionP2) override;
+    CommonDevicePose getTrackerPose() const override;
+    void setTrackerPose(const struct CommonDevicePose *pose) override;
+    void getFOV(float &outHFOV, float &outVFOV) const override;
+    void getZRange(float &outZNear, float &outZFar) const override;
+    void gatherTrackerOptions(PSMoveProtocol::Response_ResultTrackerSettings* settings) const override;
+    bool setOptionIndex(const std::string &option_name, int option_index) override;
+    bool getOptionIndex(const std::string &option_name, int &out_option_index) const override;
+    void gatherTrackingColorPresets(const std::string &controller_serial, PSMoveProtocol::Response_ResultTrackerSettings* settings) const override;
+    void setTrackingColorPreset(const std::string &controller_serial, eCommonTrackingColorID color, const CommonHSVColorRange *preset) override;
+    void getTrackingColorPreset(const std::string &controller_serial, eCommonTrackingColorID color, CommonHSVColorRange *out_preset) const override;
+
+    // -- Remote Tracker
+    // The projections found in the most recent video frame received from the node
+    inline const RemoteTrackerFrame &getLatestFrame() const
+    { return m_latest_frame; }
+
+    // Tell the node what to look for in its next video frames
+    void sendTargets(const std::vector<RemoteTrackerTarget> &targets);
+
+private:
+    const RemoteTrackerCamera *findCamera() const;
+
+    // Stored under the remote device path: pose, color presets and the last announced camera settings
+    PS3EyeTrackerConfig cfg;
+    std::string m_device_path;
+    bool m_bIsOpen;
+
+    RemoteTrackerFrame m_latest_frame;
+    int m_dropped_frame_count;
+    int m_next_poll_sequence_number;
+    PS3EyeTrackerState m_tracker_state;
+};
+#endif // REMOTE_TRACKER_H
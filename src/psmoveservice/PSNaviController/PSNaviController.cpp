@@ -5,6 +5,7 @@
 #include "ControllerUSBDeviceEnumerator.h"
 #include "ControllerHidDeviceEnumerator.h"
 #include "ControllerGamepadEnumerator.h"
+#include "GamepadPoller.h"
 #include "ServerLog.h"
 #include "ServerUtility.h"
 #include "USBDeviceManager.h"
@@ -12,8 +13,6 @@
 
 #include "hidapi.h"
 
-#include "gamepad/Gamepad.h"
-
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -394,12 +393,13 @@ bool PSNaviController::open(
 
 			if (gamepad_index != -1)
 			{
-				const Gamepad_device * gamepad = Gamepad_deviceAtIndex(static_cast<unsigned int>(gamepad_index));
+				GamepadPoller *gamepad_poller = GamepadPoller::getInstance();
+				GamepadSnapshot gamepad;
 
-				if (gamepad != nullptr)
+				if (gamepad_poller != nullptr && gamepad_poller->fetchGamepadSnapshot(gamepad_index, gamepad))
 				{
 					char device_path[255];
-					ServerUtility::format_string(device_path, sizeof(device_path), "%s #%d", gamepad->description, gamepad_index);
+					ServerUtility::format_string(device_path, sizeof(device_path), "%s #%d", gamepad.description, gamepad_index);
 
 					SERVER_LOG_INFO("PSNaviController::open") << "  Successfully opened gamepad: " << device_path;
 					APIContext->gamepad_index = gamepad_index;
@@ -881,10 +881,12 @@ PSNaviController::pollGamepad()
 {
 	assert(getIsOpen());
 
-	const Gamepad_device * gamepad = Gamepad_deviceAtIndex(static_cast<unsigned int>(APIContext->gamepad_index));
+	// Lock free copy of the state published by the gamepad poller thread
+	GamepadPoller *gamepad_poller = GamepadPoller::getInstance();
+	GamepadSnapshot gamepad;
 	IControllerInterface::ePollResult result= IControllerInterface::_PollResultSuccessNewData;
 
-	if (gamepad != nullptr)
+	if (gamepad_poller != nullptr && gamepad_poller->fetchGamepadSnapshot(APIContext->gamepad_index, gamepad))
 	{
 		PSNaviControllerInputState newState;
 
@@ -893,16 +895,16 @@ PSNaviController::pollGamepad()
 		++NextPollSequenceNumber;
 
 		// New Button State
-		bool bIsDPadUpPressed= gamepad->buttonStates[0];
-		bool bIsDPadDownPressed= gamepad->buttonStates[1];
-		bool bIsDPadLeftPressed= gamepad->buttonStates[2];
-		bool bIsDPadRightPressed= gamepad->buttonStates[3];
-		bool bIsL2Pressed= gamepad->axisStates[4] >= .9f;
-		bool bIsL3Pressed= gamepad->buttonStates[6];
-		bool bIsL1Pressed= gamepad->buttonStates[8];
-		bool bIsCrossPressed= gamepad->buttonStates[10];
-		bool bIsCirclePressed= gamepad->buttonStates[11];
-		bool bIsPSPressed = gamepad->buttonStates[14];
+		bool bIsDPadUpPressed= gamepad.buttonStates[0];
+		bool bIsDPadDownPressed= gamepad.buttonStates[1];
+		bool bIsDPadLeftPressed= gamepad.buttonStates[2];
+		bool bIsDPadRightPressed= gamepad.buttonStates[3];
+		bool bIsL2Pressed= gamepad.axisStates[4] >= .9f;
+		bool bIsL3Pressed= gamepad.buttonStates[6];
+		bool bIsL1Pressed= gamepad.buttonStates[8];
+		bool bIsCrossPressed= gamepad.buttonStates[10];
+		bool bIsCirclePressed= gamepad.buttonStates[11];
+		bool bIsPSPressed = gamepad.buttonStates[14];
 
 		newState.AllButtons = 0;
 		setButtonBit(newState.AllButtons, Btn_UP, bIsDPadUpPressed);
@@ -930,9 +932,9 @@ PSNaviController::pollGamepad()
 		newState.L3 = getButtonState(newState.AllButtons, lastButtons, Btn_L3);
 
 		// Analog triggers
-		newState.Stick_XAxis = static_cast<unsigned char>((gamepad->axisStates[0] + 1.f) * 127.f);
-		newState.Stick_YAxis = static_cast<unsigned char>((gamepad->axisStates[1] + 1.f) * 127.f);
-		newState.Trigger = static_cast<unsigned char>((gamepad->axisStates[4] + 1.f) * 127.f);
+		newState.Stick_XAxis = static_cast<unsigned char>((gamepad.axisStates[0] + 1.f) * 127.f);
+		newState.Stick_YAxis = static_cast<unsigned char>((gamepad.axisStates[1] + 1.f) * 127.f);
+		newState.Trigger = static_cast<unsigned char>((gamepad.axisStates[4] + 1.f) * 127.f);
 
 		// Can't report the true battery state
 		newState.Battery = CommonControllerState::Batt_MAX;
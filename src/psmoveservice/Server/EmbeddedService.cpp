@@ -0,0 +1,215 @@
+//-- includes -----
+#include "EmbeddedService.h"
+#include "DeviceManager.h"
+#include "ServerLog.h"
+#include "ServerNetworkManager.h"
+#include "ServerRequestHandler.h"
+#include "ServiceStatistics.h"
+#include "USBDeviceManager.h"
+
+#include <chrono>
+
+//-- definitions -----
+class EmbeddedServiceImpl
+{
+public:
+    EmbeddedServiceImpl()
+        : m_usb_device_manager()
+        , m_device_manager()
+        , m_request_handler(&m_device_manager)
+        , m_network_manager()
+        , m_tick_timer(ServiceStatistics::registerTimer("service.tick_time_us"))
+        , m_bIsStarted(false)
+    {
+    }
+
+    /// Same startup order as PSMoveService, minus the tracker nodes
+    bool startup(
+        IDataFrameListener *data_frame_listener,
+        INotificationListener *notification_listener,
+        IResponseListener *response_listener)
+    {
+        bool success= true;
+
+        if (!m_usb_device_manager.startup())
+        {
+            SERVER_LOG_FATAL("EmbeddedService") << "Failed to initialize the usb async request manager";
+            success = false;
+        }
+
+        if (success)
+        {
+            if (!m_device_manager.startup())
+            {
+                SERVER_LOG_FATAL("EmbeddedService") << "Failed to initialize the controller manager";
+                success= false;
+            }
+        }
+
+        if (success)
+        {
+            if (!m_network_manager.startup_embedded(
+                    &m_request_handler, data_frame_listener, notification_listener, response_listener))
+            {
+                SERVER_LOG_FATAL("EmbeddedService") << "Failed to initialize the embedded client connection";
+                success= false;
+            }
+        }
+
+        if (success)
+        {
+            if (!m_request_handler.startup())
+            {
+                SERVER_LOG_FATAL("EmbeddedService") << "Failed to initialize the service request handler";
+                success= false;
+            }
+        }
+
+        // Whatever did start gets shut down
+        m_bIsStarted= true;
+
+        return success;
+    }
+
+    /// Same as PSMoveService::update()
+    void update()
+    {
+        const std::chrono::steady_clock::time_point tick_start_time= std::chrono::steady_clock::now();
+
+        m_request_handler.update();
+        m_usb_device_manager.update();
+        m_device_manager.update();
+
+        // Hands the responses and data frames to the client listeners
+        m_network_manager.update();
+
+        const std::chrono::microseconds tick_duration= 
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tick_start_time);
+        m_tick_timer->addSample(tick_duration.count());
+        ServiceStatistics::update();
+    }
+
+    void shutdown()
+    {
+        if (m_bIsStarted)
+        {
+            m_request_handler.shutdown();
+            m_network_manager.shutdown();
+            m_device_manager.shutdown();
+            m_usb_device_manager.shutdown();
+
+            m_bIsStarted= false;
+        }
+    }
+
+    inline ServerNetworkManager &getNetworkManager()
+    { return m_network_manager; }
+
+private:
+    USBDeviceManager m_usb_device_manager;
+    DeviceManager m_device_manager;
+    ServerRequestHandler m_request_handler;
+    ServerNetworkManager m_network_manager;
+    ServiceStatisticTimer *m_tick_timer;
+    bool m_bIsStarted;
+};
+
+//-- public interface -----
+EmbeddedService *EmbeddedService::m_instance = nullptr;
+
+EmbeddedService::EmbeddedService()
+    : implementation_ptr(nullptr)
+{
+}
+
+EmbeddedService::~EmbeddedService()
+{
+    if (m_instance == this)
+    {
+        SERVER_LOG_ERROR("~EmbeddedService()") << "Embedded service deleted without shutdown() getting called first";
+        shutdown();
+    }
+}
+
+bool EmbeddedService::startup(
+    IDataFrameListener *data_frame_listener,
+    INotificationListener *notification_listener,
+    IResponseListener *response_listener)
+{
+    // The device managers are singletons, so only one service can run per process
+    if (m_instance != nullptr || ServerNetworkManager::get_instance() != nullptr)
+    {
+        SERVER_LOG_ERROR("EmbeddedService::startup") << "A service is already running in this process";
+        return false;
+    }
+
+    log_init("info");
+    SERVER_LOG_INFO("EmbeddedService::startup") << "Starting the embedded service";
+
+    m_instance= this;
+    implementation_ptr= new EmbeddedServiceImpl();
+
+    if (!implementation_ptr->startup(data_frame_listener, notification_listener, response_listener))
+    {
+        SERVER_LOG_ERROR("EmbeddedService::startup") << "Failed to start the embedded service";
+        shutdown();
+        return false;
+    }
+
+    return true;
+}
+
+void EmbeddedService::update()
+{
+    if (implementation_ptr != nullptr)
+    {
+        implementation_ptr->update();
+    }
+}
+
+void EmbeddedService::shutdown()
+{
+    if (implementation_ptr != nullptr)
+    {
+        implementation_ptr->shutdown();
+
+        delete implementation_ptr;
+        implementation_ptr= nullptr;
+
+        SERVER_LOG_INFO("EmbeddedService::shutdown") << "Embedded service stopped";
+        log_dispose();
+    }
+
+    if (m_instance == this)
+    {
+        m_instance= nullptr;
+    }
+}
+
+void EmbeddedService::send_request(RequestPtr request)
+{
+    if (implementation_ptr != nullptr)
+    {
+        implementation_ptr->getNetworkManager().send_embedded_request(request);
+    }
+}
+
+void EmbeddedService::send_device_data_frame(DeviceInputDataFramePtr data_frame)
+{
+    if (implementation_ptr != nullptr)
+    {
+        implementation_ptr->getNetworkManager().send_embedded_input_data_frame(data_frame);
+    }
+}
+
+DeviceInputDataFramePtr EmbeddedService::allocate_device_data_frame()
+{
+    return (implementation_ptr != nullptr)
+        ? implementation_ptr->getNetworkManager().allocate_embedded_input_data_frame()
+        : DeviceInputDataFramePtr();
+}
+
+int EmbeddedService::get_allocation_count() const
+{
+    return (implementation_ptr != nullptr) ? implementation_ptr->getNetworkManager().get_allocation_count() : 0;
+}
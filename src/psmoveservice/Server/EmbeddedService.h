@@ -0,0 +1,57 @@
+#ifndef EMBEDDED_SERVICE_H
+#define EMBEDDED_SERVICE_H
+
+//-- includes -----
+#include "PSMoveProtocolInterface.h"
+
+//-- definitions -----
+// -Embedded Service-
+/// Runs the service core (device manager, request handler and the device views)
+/// inside a client process.
+/// Requests go straight to the ServerRequestHandler and responses, notifications and
+/// data frames come back through the given listeners, without sockets or serialization.
+/// The service only runs when update() is called, on the caller's thread.
+/// Tracker nodes and the tracker shared memory are not started in this mode.
+class EmbeddedService
+{
+public:
+    EmbeddedService();
+    virtual ~EmbeddedService();
+
+    static EmbeddedService *get_instance() { return m_instance; }
+
+    /// Starts the usb manager, device manager and request handler.
+    /// Fails if another service is already running in this process.
+    bool startup(
+        IDataFrameListener *data_frame_listener,
+        INotificationListener *notification_listener,
+        IResponseListener *response_listener);
+
+    /// Runs one service tick: polls the devices, handles the queued requests
+    /// and calls the listeners with the results.
+    void update();
+
+    void shutdown();
+
+    /// Queue a request, handled in the next update()
+    void send_request(RequestPtr request);
+
+    /// Queue a data frame, handled in the next update()
+    void send_device_data_frame(DeviceInputDataFramePtr data_frame);
+
+    /// Get a cleared data frame from the input data frame pool
+    DeviceInputDataFramePtr allocate_device_data_frame();
+
+    /// Number of heap allocations made for messages so far
+    int get_allocation_count() const;
+
+private:
+    /// private implementation - same lifetime as the EmbeddedService
+    class EmbeddedServiceImpl *implementation_ptr;
+
+    /// Singleton instance of the class
+    /// Assigned in startup, cleared in shutdown
+    static EmbeddedService *m_instance;
+};
+
+#endif  // EMBEDDED_SERVICE_H
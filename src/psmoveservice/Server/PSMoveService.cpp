@@ -2,13 +2,16 @@
 #define BOOST_LIB_DIAGNOSTIC
 
 #include "PSMoveService.h"
+#include "PSMoveConfig.h"
 #include "ServerNetworkManager.h"
 #include "ServerRequestHandler.h"
 #include "DeviceManager.h"
 #include "ProtocolVersion.h"
 #include "ServerLog.h"
+#include "ServiceStatistics.h"
 #include "SharedTrackerState.h"
 #include "TrackerManager.h"
+#include "TrackerNodeManager.h"
 #include "USBDeviceManager.h"
 
 #include <boost/asio.hpp>
@@ -40,10 +43,12 @@ public:
         : m_io_service()
         , m_signals(m_io_service)
         , m_usb_device_manager()
+        , m_tracker_node_manager()
         , m_device_manager()
         , m_request_handler(&m_device_manager)
         , m_network_manager()
         , m_status()
+        , m_tick_timer(ServiceStatistics::registerTimer("service.tick_time_us"))
     {
         // Register to handle the signals that indicate when the server should exit.
         m_signals.add(SIGINT);
@@ -164,6 +169,19 @@ private:
             }
         }
 
+        /** Setup the tracker node connections before the tracker manager enumerates the cameras */
+        if (success)
+        {
+            const std::string &central_address= 
+                PSMoveService::getInstance()->getProgramSettings()->tracker_node_central_address;
+
+            if (!m_tracker_node_manager.startup(&m_io_service, central_address))
+            {
+                SERVER_LOG_FATAL("PSMoveService") << "Failed to initialize the tracker node manager";
+                success= false;
+            }
+        }
+
         /** Setup the controller manager */
         if (success)
         {
@@ -179,7 +197,11 @@ private:
 		*/
         if (success)
         {
-            if (!m_network_manager.startup(&m_io_service, &m_request_handler))
+            // A tracker node serves its clients on its own port so it can share a host with the central service
+            const int server_port= 
+                m_tracker_node_manager.getIsNodeMode() ? m_tracker_node_manager.getNodeServerPort() : -1;
+
+            if (!m_network_manager.startup(&m_io_service, &m_request_handler, server_port))
             {
                 SERVER_LOG_FATAL("PSMoveService") << "Failed to initialize the service network manager";
                 success= false;
@@ -202,12 +224,17 @@ private:
     /// Called in the application loop.
     void update()
     {
+        const std::chrono::steady_clock::time_point tick_start_time= std::chrono::steady_clock::now();
+
         /** Update an async requests still waiting to complete */
         m_request_handler.update();
 
         /** Process any async results from the USB transfer thread */
         m_usb_device_manager.update();
 
+        /** Receive any projections from the tracker nodes (or targets from the central service) */
+        m_tracker_node_manager.update();
+
         /**
          Update the list of active tracked controllers
          Send controller updates to the client
@@ -216,6 +243,12 @@ private:
 
         /** Process incoming/outgoing networking requests */
         m_network_manager.update();
+
+        /** Record how long this tick took and refresh the counter rates */
+        const std::chrono::microseconds tick_duration= 
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tick_start_time);
+        m_tick_timer->addSample(tick_duration.count());
+        ServiceStatistics::update();
     }
 
     void shutdown()
@@ -230,6 +263,9 @@ private:
         // Disconnect any actively connected controllers
         m_device_manager.shutdown();
 
+        // Stop talking to the tracker nodes once the remote trackers are closed
+        m_tracker_node_manager.shutdown();
+
         // Shutdown the usb async request thread
         // Must be after device manager since devices can have an active usb connection
         m_usb_device_manager.shutdown();
@@ -252,6 +288,9 @@ private:
     // Manages all control and bulk transfer requests in another thread
     USBDeviceManager m_usb_device_manager;
 
+    // Exchanges tracking targets and projections with remote tracker nodes
+    TrackerNodeManager m_tracker_node_manager;
+
     // Keep track of currently connected devices (PSMove controllers, cameras, HMDs)
     DeviceManager m_device_manager;
 
@@ -263,6 +302,9 @@ private:
 
     // Whether the application should keep running or not
     std::shared_ptr<boost::application::status> m_status;
+
+    // Main loop tick durations, reported in the service statistics
+    ServiceStatisticTimer *m_tick_timer;
 };
 
 static void parse_program_settings(
@@ -295,6 +337,24 @@ static void parse_program_settings(
 	{
 		settings.working_directory.clear();
 	}
+
+    if (options_map.count("tracker_node"))
+    {
+        settings.tracker_node_central_address= options_map["tracker_node"].as<std::string>();
+    }
+    else
+    {
+        settings.tracker_node_central_address.clear();
+    }
+
+    if (options_map.count("config_directory"))
+    {
+        settings.config_directory= options_map["config_directory"].as<std::string>();
+    }
+    else
+    {
+        settings.config_directory.clear();
+    }
 }
 
 #if defined(BOOST_WINDOWS_API) 
@@ -330,6 +390,23 @@ bool win32_service_management_action(
 			service_options+= "\"";
         }
 
+        if (options_map.count("tracker_node"))
+        {
+            std::string tracker_node= options_map["tracker_node"].as<std::string>();
+
+            service_options+= " --tracker_node ";
+            service_options+= tracker_node;
+        }
+
+        if (options_map.count("config_directory"))
+        {
+            std::string config_directory= options_map["config_directory"].as<std::string>();
+
+            service_options+= " --config_directory \"";
+            service_options+= config_directory;
+            service_options+= "\"";
+        }
+
         boost::system::error_code ec;
 		boost::application::example::install_windows_service(
             boost::application::setup_arg(options_map["name"].as<std::string>()), 
@@ -507,6 +584,8 @@ int PSMoveService::exec(int argc, char *argv[])
         ("log_level,l", boost::program_options::value<std::string>(), "The level of logging to use: trace, debug, info, warning, error, fatal")
         ("admin_password,p", boost::program_options::value<std::string>(), "Remember the admin password for this machine (optional)")
 		("working_directory", boost::program_options::value<std::string>(), "service working directory (optional)")
+        ("tracker_node,n", boost::program_options::value<std::string>(), "Run as a tracker node sending projections to the central service at host[:port] (optional)")
+        ("config_directory", boost::program_options::value<std::string>(), "Directory to keep the config files in, i.e. one per tracker node on a shared host (optional)")
 #if defined(BOOST_WINDOWS_API)
         (",i", "install service")
         (",u", "uninstall service")
@@ -573,6 +652,13 @@ int PSMoveService::exec(int argc, char *argv[])
     // initialize logging system
     log_init(this->getProgramSettings()->log_level, "PSMoveService.log");
 
+    // The managers load their configs on construction, so this has to happen before the app gets created
+    if (!this->getProgramSettings()->config_directory.empty())
+    {
+        SERVER_LOG_INFO("main") << "Using config directory: " << this->getProgramSettings()->config_directory;
+        PSMoveConfig::setConfigDirectory(this->getProgramSettings()->config_directory);
+    }
+
     // Start the service app
     SERVER_LOG_INFO("main") << "Starting PSMoveService v" << PSM_RELEASE_VERSION_STRING << " (protocol v" << PSM_PROTOCOL_VERSION_STRING << ")";
     try
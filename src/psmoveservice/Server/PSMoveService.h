@@ -13,6 +13,8 @@ public:
         std::string log_level;
         std::string admin_password;
 		std::string working_directory;
+        std::string tracker_node_central_address;
+        std::string config_directory;
     };
 
     PSMoveService();
@@ -13,10 +13,10 @@
 #endif
 
 //-- globals -----
-e_log_severity_level g_min_log_level= _log_severity_level_info;
-std::ostream *g_console_stream= nullptr;
-std::ostream *g_file_stream = nullptr;
-std::mutex *g_logger_mutex = nullptr;
+static e_log_severity_level g_min_log_level= _log_severity_level_info;
+static std::ostream *g_console_stream= nullptr;
+static std::ostream *g_file_stream = nullptr;
+static std::mutex *g_logger_mutex = nullptr;
 
 //-- public implementation -----
 void log_init(const std::string &log_level, const std::string &log_filename)
@@ -81,7 +81,7 @@ void log_dispose()
 	}
 }
 
-bool log_can_emit_level(e_log_severity_level level)
+bool server_log_can_emit_level(e_log_severity_level level)
 {
     return (level >= g_min_log_level);
 }
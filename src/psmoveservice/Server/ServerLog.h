@@ -55,12 +55,12 @@ protected:
 //-- interface -----
 void log_init(const std::string &log_level, const std::string &log_filename="");
 void log_dispose();
-bool log_can_emit_level(e_log_severity_level level);
+bool server_log_can_emit_level(e_log_severity_level level);
 std::string log_get_timestamp_prefix();
 
 //-- macros -----
-#define SELECT_LOG_STREAM(level) LoggerStream(log_can_emit_level(level))
-#define SELECT_MT_LOG_STREAM(level) ThreadSafeLoggerStream(log_can_emit_level(level))
+#define SELECT_LOG_STREAM(level) LoggerStream(server_log_can_emit_level(level))
+#define SELECT_MT_LOG_STREAM(level) ThreadSafeLoggerStream(server_log_can_emit_level(level))
 
 // Non Thread Safe Logger Macros
 // Almost everything is on the main thread, so you almost always want to use these
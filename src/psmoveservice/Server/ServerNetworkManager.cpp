@@ -2,7 +2,9 @@
 #include "ServerNetworkManager.h"
 #include "ServerRequestHandler.h"
 #include "ServerLog.h"
+#include "ServiceStatistics.h"
 #include "PackedMessage.h"
+#include "ProtocolMessagePool.h"
 #include "PSMoveProtocolInterface.h"
 #include "PSMoveProtocol.pb.h"
 #include <cassert>
@@ -34,6 +36,16 @@ typedef std::pair<int, ClientConnectionPtr> t_id_client_connection_pair;
 //-- constants -----
 const int PSMOVE_SERVER_PORT = 9512;
 
+// Initial sizes of the per-connection message pools and buffers.
+// These only grow (and allocate) if a client falls behind.
+const size_t k_initial_pooled_response_count = 4;
+const size_t k_initial_pooled_data_frame_count = 16;
+const size_t k_initial_tcp_buffer_size = 1024;
+
+// The embedded client is the only client of an in-process service
+const int k_embedded_connection_id = 0;
+const size_t k_initial_embedded_request_count = 8;
+
 //-- private implementation -----
 class IServerNetworkEventListener
 {
@@ -94,20 +106,25 @@ public:
         {
             SERVER_LOG_ERROR("~ClientConnection") << "Client connection " << m_connection_id << " deleted without calling stop()";
         }
+
+        ServiceStatistics::releaseStatistic(m_send_queue_depth_statistic);
+        ServiceStatistics::releaseStatistic(m_udp_drop_statistic);
     }
 
     static ClientConnectionPtr create(
         IServerNetworkEventListener* network_event_listener,
         asio::io_service& io_service_ref,
         udp::socket& udp_socket_ref, 
-        ServerRequestHandler &request_handler_ref)
+        ServerRequestHandler &request_handler_ref,
+        int &allocation_count_ref)
     {
         return ClientConnectionPtr(
             new ClientConnection(
                 network_event_listener, 
                 io_service_ref, 
                 udp_socket_ref, 
-                request_handler_ref));
+                request_handler_ref,
+                allocation_count_ref));
     }
 
     int get_connection_id() const
@@ -202,9 +219,20 @@ public:
         return m_connection_started && m_pending_dataframes.size() > 0;
     }
 
+    ResponsePtr allocate_response()
+    {
+        return m_response_pool.allocate();
+    }
+
+    DeviceOutputDataFramePtr allocate_device_data_frame()
+    {
+        return m_dataframe_pool.allocate();
+    }
+
     void add_tcp_response_to_write_queue(ResponsePtr response)
     {
         m_pending_responses.push_back(response);
+        update_send_queue_depth_statistic();
     }
 
     bool start_tcp_write_queued_response()
@@ -220,7 +248,7 @@ public:
                     ResponsePtr response= m_pending_responses.front();
 
                     m_packed_response.set_msg(response);
-                    m_packed_response.pack(m_response_write_buffer);
+                    pack_into_tcp_buffer(m_packed_response, m_response_write_buffer);
 
                     SERVER_LOG_DEBUG("ClientConnection::start_tcp_write_queued_response") << "Sending TCP response";
                     SERVER_LOG_DEBUG("   ") << show_hex(m_response_write_buffer);
@@ -251,6 +279,7 @@ public:
     void add_device_data_frame_to_write_queue(DeviceOutputDataFramePtr data_frame)
     {
         m_pending_dataframes.push_back(data_frame);
+        update_send_queue_depth_statistic();
     }
 
     bool start_udp_write_queued_device_data_frame()
@@ -290,6 +319,11 @@ public:
                     {
                         SERVER_LOG_ERROR("ClientConnection::start_udp_write_queued_device_data_frame") 
                             << "DataFrame too big to fit in packet!";
+
+                        // Drop it rather than stall the queue behind it
+                        m_pending_dataframes.pop_front();
+                        m_udp_drop_statistic->increment();
+                        update_send_queue_depth_statistic();
                     }
                 }
             }
@@ -315,17 +349,26 @@ private:
     udp::endpoint m_udp_remote_endpoint;
     bool m_is_udp_remote_endpoint_bound;
 
+    // Counts every heap allocation made by the connection's pools and buffers
+    int &m_allocation_count_ref;
+
     vector<uint8_t> m_request_read_buffer;
     PackedMessage<PSMoveProtocol::Request> m_packed_request;
 
     vector<uint8_t> m_response_write_buffer;
     PackedMessage<PSMoveProtocol::Response> m_packed_response;
+    ProtocolMessagePool<PSMoveProtocol::Response> m_response_pool;
 
     uint8_t m_output_dataframe_buffer[HEADER_SIZE+MAX_OUTPUT_DATA_FRAME_MESSAGE_SIZE];
     PackedMessage<PSMoveProtocol::DeviceOutputDataFrame> m_packed_output_dataframe;
+    ProtocolMessagePool<PSMoveProtocol::DeviceOutputDataFrame> m_dataframe_pool;
 
     deque<ResponsePtr> m_pending_responses;
-    deque<DeviceOutputDataFramePtr> m_pending_dataframes;
+    ProtocolMessageQueue<DeviceOutputDataFramePtr> m_pending_dataframes;
+
+    // Service statistics for this connection
+    ServiceStatistic *m_send_queue_depth_statistic;
+    ServiceStatistic *m_udp_drop_statistic;
     
     bool m_connection_started;
     bool m_connection_stopped;
@@ -336,7 +379,8 @@ private:
         IServerNetworkEventListener *network_event_listener,
         asio::io_service& io_service_ref,
         udp::socket& udp_socket_ref , 
-        ServerRequestHandler &request_handler_ref)
+        ServerRequestHandler &request_handler_ref,
+        int &allocation_count_ref)
         : m_network_event_listener(network_event_listener)
         , m_connection_id(next_connection_id)
         , m_request_handler_ref(request_handler_ref)
@@ -344,20 +388,61 @@ private:
         , m_udp_socket_ref(udp_socket_ref)
         , m_udp_remote_endpoint()
         , m_is_udp_remote_endpoint_bound(false)
+        , m_allocation_count_ref(allocation_count_ref)
         , m_request_read_buffer()
         , m_packed_request(std::shared_ptr<PSMoveProtocol::Request>(new PSMoveProtocol::Request()))
         , m_response_write_buffer()
         , m_packed_response()
+        , m_response_pool(k_initial_pooled_response_count, allocation_count_ref)
         , m_packed_output_dataframe()
+        , m_dataframe_pool(k_initial_pooled_data_frame_count, allocation_count_ref)
         , m_pending_responses()
-        , m_pending_dataframes()
+        , m_pending_dataframes(k_initial_pooled_data_frame_count, allocation_count_ref)
+        , m_send_queue_depth_statistic(nullptr)
+        , m_udp_drop_statistic(nullptr)
         , m_connection_started(false)
         , m_connection_stopped(false)
         , m_has_pending_tcp_write(false)
         , m_has_pending_udp_write(false)
     {
         memset(m_output_dataframe_buffer, 0, sizeof(m_output_dataframe_buffer));
+        m_request_read_buffer.reserve(k_initial_tcp_buffer_size);
+        m_response_write_buffer.reserve(k_initial_tcp_buffer_size);
+        m_allocation_count_ref+= 2;
         next_connection_id++;
+
+        const std::string statistic_prefix= "connection." + std::to_string(m_connection_id);
+        m_send_queue_depth_statistic= ServiceStatistics::registerGauge(statistic_prefix + ".send_queue_depth");
+        m_udp_drop_statistic= ServiceStatistics::registerCounter(statistic_prefix + ".udp_drops");
+    }
+
+    void update_send_queue_depth_statistic()
+    {
+        m_send_queue_depth_statistic->set(m_pending_responses.size() + m_pending_dataframes.size());
+    }
+
+    // Pack the message into the buffer, counting it as an allocation if the buffer had to grow
+    template <class MessageType>
+    void pack_into_tcp_buffer(const PackedMessage<MessageType> &packed_message, vector<uint8_t> &buffer)
+    {
+        const size_t old_capacity= buffer.capacity();
+
+        packed_message.pack(buffer);
+
+        if (buffer.capacity() != old_capacity)
+        {
+            ++m_allocation_count_ref;
+        }
+    }
+
+    void resize_tcp_buffer(vector<uint8_t> &buffer, size_t size)
+    {
+        if (size > buffer.capacity())
+        {
+            ++m_allocation_count_ref;
+        }
+
+        buffer.resize(size);
     }
 
     void send_connection_info()
@@ -365,7 +450,7 @@ private:
         SERVER_LOG_INFO("ClientConnection::send_connection_info") 
             << "Sending connection id to client " << m_connection_id;
 
-        ResponsePtr response(new PSMoveProtocol::Response);
+        ResponsePtr response= allocate_response();
 
         response->set_type(PSMoveProtocol::Response_ResponseType_CONNECTION_INFO);
         response->set_request_id(-1); // This is a notification (no corresponding request)
@@ -381,7 +466,7 @@ private:
         SERVER_LOG_DEBUG("ClientConnection::start_tcp_read_request_header") 
             << "Start TCP header read on connection id to client " << m_connection_id;
 
-        m_request_read_buffer.resize(HEADER_SIZE);
+        resize_tcp_buffer(m_request_read_buffer, HEADER_SIZE);
         asio::async_read(
             m_tcp_socket, 
             asio::buffer(m_request_read_buffer),
@@ -430,7 +515,7 @@ private:
         // bytes. Expand it to fit in the body as well, and start async
         // read into the body.
         //
-        m_request_read_buffer.resize(HEADER_SIZE + msg_len);
+        resize_tcp_buffer(m_request_read_buffer, HEADER_SIZE + msg_len);
         asio::mutable_buffers_1 buf = asio::buffer(&m_request_read_buffer[HEADER_SIZE], msg_len);
         asio::async_read(
             m_tcp_socket, buf,
@@ -504,6 +589,7 @@ private:
 
             // Remove the response from the pending send queue now that it's sent
             m_pending_responses.pop_front();
+            update_send_queue_depth_statistic();
 
             // If there are more requests waiting to be sent, start sending the next one
             start_tcp_write_queued_response();
@@ -531,11 +617,13 @@ private:
 
             // Remove the dataframe from the pending send queue now that it's sent
             m_pending_dataframes.pop_front();
+            update_send_queue_depth_statistic();
         }
         else
         {
             SERVER_LOG_ERROR("ClientConnection::handle_udp_write_device_data_frame_complete") 
                 << "Error sending data frame on connection " << m_connection_id << ": " << ec.message();
+            m_udp_drop_statistic->increment();
 
             stop();
         }
@@ -558,6 +646,7 @@ public:
         , m_udp_connection_result_write_buffer(false)
         , m_has_pending_udp_read(false)
         , m_connections()
+        , m_allocation_count(0)
     {
         memset(m_input_dataframe_buffer, 0, sizeof(m_input_dataframe_buffer));
     }
@@ -585,7 +674,8 @@ public:
                 this, 
                 m_tcp_acceptor.get_io_service(), 
                 m_udp_socket, 
-                m_request_handler_ref);
+                m_request_handler_ref,
+                m_allocation_count);
 
         // Add the connection to the list
         t_id_client_connection_pair map_entry(new_connection->get_connection_id(), new_connection);
@@ -710,6 +800,41 @@ public:
         }
     }
 
+    ResponsePtr allocate_response(int connection_id)
+    {
+        t_client_connection_map_iter entry = m_connections.find(connection_id);
+
+        if (entry != m_connections.end())
+        {
+            return entry->second->allocate_response();
+        }
+        else
+        {
+            m_allocation_count+= 2;
+            return ResponsePtr(new PSMoveProtocol::Response);
+        }
+    }
+
+    DeviceOutputDataFramePtr allocate_device_data_frame(int connection_id)
+    {
+        t_client_connection_map_iter entry = m_connections.find(connection_id);
+
+        if (entry != m_connections.end())
+        {
+            return entry->second->allocate_device_data_frame();
+        }
+        else
+        {
+            m_allocation_count+= 2;
+            return DeviceOutputDataFramePtr(new PSMoveProtocol::DeviceOutputDataFrame);
+        }
+    }
+
+    int get_allocation_count() const
+    {
+        return m_allocation_count;
+    }
+
     void send_device_data_frame(int connection_id, DeviceOutputDataFramePtr data_frame)
     {
         t_client_connection_map_iter entry = m_connections.find(connection_id);
@@ -775,6 +900,9 @@ private:
     // A mapping from connection_id -> ClientConnectionPtr
     t_client_connection_map m_connections;
 
+    // Heap allocations made by the connection message pools and buffers
+    int m_allocation_count;
+
 protected:
     void handle_tcp_accept(ClientConnectionPtr connection, const boost::system::error_code& error)
     {        
@@ -962,12 +1090,170 @@ protected:
     }
 };
 
+// -EmbeddedClientConnection-
+/// The client of a service running in the client's process (see EmbeddedService).
+/// Requests, responses and data frames are handed over as messages, nothing is serialized.
+/// Everything happens on the thread that ticks the service, so nothing here is locked.
+class EmbeddedClientConnection
+{
+public:
+    EmbeddedClientConnection(
+        ServerRequestHandler &request_handler_ref,
+        IDataFrameListener *data_frame_listener,
+        INotificationListener *notification_listener,
+        IResponseListener *response_listener)
+        : m_request_handler_ref(request_handler_ref)
+        , m_data_frame_listener(data_frame_listener)
+        , m_notification_listener(notification_listener)
+        , m_response_listener(response_listener)
+        , m_allocation_count(0)
+        , m_response_pool(k_initial_pooled_response_count, m_allocation_count)
+        , m_dataframe_pool(k_initial_pooled_data_frame_count, m_allocation_count)
+        , m_input_dataframe_pool(k_initial_pooled_data_frame_count, m_allocation_count)
+        , m_pending_requests(k_initial_embedded_request_count, m_allocation_count)
+        , m_pending_input_dataframes(k_initial_pooled_data_frame_count, m_allocation_count)
+        , m_pending_notifications(k_initial_pooled_response_count, m_allocation_count)
+        , m_pending_dataframes(k_initial_pooled_data_frame_count, m_allocation_count)
+    {
+    }
+
+    int get_connection_id() const
+    {
+        return k_embedded_connection_id;
+    }
+
+    int get_allocation_count() const
+    {
+        return m_allocation_count;
+    }
+
+    // -- Client -> Service ----
+    /// Requests are handled on the next service update, like requests read from a socket.
+    /// This gives the client a chance to register a callback for the request before the response arrives.
+    void add_request_to_queue(RequestPtr request)
+    {
+        m_pending_requests.push_back(request);
+    }
+
+    void add_input_data_frame_to_queue(DeviceInputDataFramePtr data_frame)
+    {
+        // The request handler looks up the connection state by the stamped connection ID
+        data_frame->set_connection_id(k_embedded_connection_id);
+        m_pending_input_dataframes.push_back(data_frame);
+    }
+
+    DeviceInputDataFramePtr allocate_input_data_frame()
+    {
+        return m_input_dataframe_pool.allocate();
+    }
+
+    // -- Service -> Client ----
+    ResponsePtr allocate_response()
+    {
+        return m_response_pool.allocate();
+    }
+
+    DeviceOutputDataFramePtr allocate_device_data_frame()
+    {
+        return m_dataframe_pool.allocate();
+    }
+
+    void add_notification_to_queue(ResponsePtr notification)
+    {
+        m_pending_notifications.push_back(notification);
+    }
+
+    void add_device_data_frame_to_queue(DeviceOutputDataFramePtr data_frame)
+    {
+        m_pending_dataframes.push_back(data_frame);
+    }
+
+    /// Called last in the service update, once the devices have published their data frames
+    void poll()
+    {
+        while (m_pending_input_dataframes.size() > 0)
+        {
+            DeviceInputDataFramePtr data_frame= m_pending_input_dataframes.front();
+            m_pending_input_dataframes.pop_front();
+
+            m_request_handler_ref.handle_input_data_frame(data_frame);
+        }
+
+        while (m_pending_requests.size() > 0)
+        {
+            RequestPtr request= m_pending_requests.front();
+            m_pending_requests.pop_front();
+
+            SERVER_LOG_DEBUG("EmbeddedClientConnection::poll") << "Handling request_type " << request->type();
+
+            ResponsePtr response = m_request_handler_ref.handle_request(k_embedded_connection_id, request);
+            if (response)
+            {
+                m_response_listener->handle_response(response);
+            }
+        }
+
+        while (m_pending_notifications.size() > 0)
+        {
+            ResponsePtr notification= m_pending_notifications.front();
+            m_pending_notifications.pop_front();
+
+            m_notification_listener->handle_notification(notification);
+        }
+
+        while (m_pending_dataframes.size() > 0)
+        {
+            DeviceOutputDataFramePtr data_frame= m_pending_dataframes.front();
+            m_pending_dataframes.pop_front();
+
+            m_data_frame_listener->handle_data_frame(data_frame.get());
+        }
+    }
+
+    void stop()
+    {
+        // Requests that never got handled are canceled, like requests pending on a closed socket
+        while (m_pending_requests.size() > 0)
+        {
+            m_response_listener->handle_request_canceled(m_pending_requests.front());
+            m_pending_requests.pop_front();
+        }
+
+        m_pending_input_dataframes.clear();
+        m_pending_notifications.clear();
+        m_pending_dataframes.clear();
+
+        // Tell the request handler to clean up any state associated with this connection
+        m_request_handler_ref.handle_client_connection_stopped(k_embedded_connection_id);
+    }
+
+private:
+    ServerRequestHandler &m_request_handler_ref;
+
+    IDataFrameListener *m_data_frame_listener;
+    INotificationListener *m_notification_listener;
+    IResponseListener *m_response_listener;
+
+    // Heap allocations made by the message pools and queues
+    int m_allocation_count;
+
+    ProtocolMessagePool<PSMoveProtocol::Response> m_response_pool;
+    ProtocolMessagePool<PSMoveProtocol::DeviceOutputDataFrame> m_dataframe_pool;
+    ProtocolMessagePool<PSMoveProtocol::DeviceInputDataFrame> m_input_dataframe_pool;
+
+    ProtocolMessageQueue<RequestPtr> m_pending_requests;
+    ProtocolMessageQueue<DeviceInputDataFramePtr> m_pending_input_dataframes;
+    ProtocolMessageQueue<ResponsePtr> m_pending_notifications;
+    ProtocolMessageQueue<DeviceOutputDataFramePtr> m_pending_dataframes;
+};
+
 //-- public interface -----
 ServerNetworkManager *ServerNetworkManager::m_instance = NULL;
 
 ServerNetworkManager::ServerNetworkManager()
 	: m_cfg()
 	, implementation_ptr(nullptr)
+	, embedded_connection_ptr(nullptr)
 {
 	m_cfg.load();
 
@@ -987,13 +1273,27 @@ ServerNetworkManager::~ServerNetworkManager()
         delete implementation_ptr;
         implementation_ptr= nullptr;
     }
+
+    if (embedded_connection_ptr != nullptr)
+    {
+        delete embedded_connection_ptr;
+        embedded_connection_ptr= nullptr;
+    }
 }
 
 bool ServerNetworkManager::startup(
 	boost::asio::io_service *io_service,
-    ServerRequestHandler *requestHandler)
+    ServerRequestHandler *requestHandler,
+    int server_port)
 {    
     m_instance= this;
+
+    if (server_port >= 0)
+    {
+        m_cfg.server_port= server_port;
+    }
+
+    SERVER_LOG_INFO("ServerNetworkManager::startup") << "Listening for clients on port " << m_cfg.server_port;
     
 	implementation_ptr= new ServerNetworkManagerImpl(*io_service, m_cfg, *requestHandler);
     implementation_ptr->start_connection_accept();
@@ -1001,20 +1301,75 @@ bool ServerNetworkManager::startup(
     return true;
 }
 
+bool ServerNetworkManager::startup_embedded(
+    ServerRequestHandler *requestHandler,
+    IDataFrameListener *dataFrameListener,
+    INotificationListener *notificationListener,
+    IResponseListener *responseListener)
+{
+    m_instance= this;
+
+    SERVER_LOG_INFO("ServerNetworkManager::startup_embedded") << "Serving an embedded client, no sockets opened";
+
+    embedded_connection_ptr= 
+        new EmbeddedClientConnection(*requestHandler, dataFrameListener, notificationListener, responseListener);
+
+    return true;
+}
+
+void ServerNetworkManager::send_embedded_request(RequestPtr request)
+{
+    if (embedded_connection_ptr != nullptr)
+    {
+        embedded_connection_ptr->add_request_to_queue(request);
+    }
+}
+
+void ServerNetworkManager::send_embedded_input_data_frame(DeviceInputDataFramePtr data_frame)
+{
+    if (embedded_connection_ptr != nullptr)
+    {
+        embedded_connection_ptr->add_input_data_frame_to_queue(data_frame);
+    }
+}
+
+DeviceInputDataFramePtr ServerNetworkManager::allocate_embedded_input_data_frame()
+{
+    return (embedded_connection_ptr != nullptr)
+        ? embedded_connection_ptr->allocate_input_data_frame()
+        : DeviceInputDataFramePtr(new PSMoveProtocol::DeviceInputDataFrame);
+}
+
 void ServerNetworkManager::update()
 {
 	if (implementation_ptr != nullptr)
 	{
 	    implementation_ptr->poll();
 	}
+
+    if (embedded_connection_ptr != nullptr)
+    {
+        embedded_connection_ptr->poll();
+    }
 }
 
 void ServerNetworkManager::shutdown()
 {
 	if (implementation_ptr != nullptr)
 	{    
+		SERVER_LOG_INFO("ServerNetworkManager::shutdown") 
+			<< "Network message allocations: " << implementation_ptr->get_allocation_count();
+
 	    implementation_ptr->close_all_connections();
 	}
+
+    if (embedded_connection_ptr != nullptr)
+    {
+		SERVER_LOG_INFO("ServerNetworkManager::shutdown") 
+			<< "Embedded message allocations: " << embedded_connection_ptr->get_allocation_count();
+
+        embedded_connection_ptr->stop();
+    }
     
     m_instance= nullptr;
 }
@@ -1025,6 +1380,12 @@ void ServerNetworkManager::send_notification(int connection_id, ResponsePtr resp
 	{    
 	    implementation_ptr->send_notification(connection_id, response);
 	}
+    else if (embedded_connection_ptr != nullptr && embedded_connection_ptr->get_connection_id() == connection_id)
+    {
+        // Notifications have an invalid response ID
+        response->set_request_id(-1);
+        embedded_connection_ptr->add_notification_to_queue(response);
+    }
 }
 
 void ServerNetworkManager::send_notification_to_all_clients(ResponsePtr response)
@@ -1033,6 +1394,60 @@ void ServerNetworkManager::send_notification_to_all_clients(ResponsePtr response
 	{    
 		implementation_ptr->send_notification_to_all_clients(response);
 	}
+    else if (embedded_connection_ptr != nullptr)
+    {
+        // Notifications have an invalid response ID
+        response->set_request_id(-1);
+        embedded_connection_ptr->add_notification_to_queue(response);
+    }
+}
+
+ResponsePtr ServerNetworkManager::allocate_response(int connection_id)
+{
+    if (implementation_ptr != nullptr)
+    {
+        return implementation_ptr->allocate_response(connection_id);
+    }
+    else if (embedded_connection_ptr != nullptr && embedded_connection_ptr->get_connection_id() == connection_id)
+    {
+        return embedded_connection_ptr->allocate_response();
+    }
+    else
+    {
+        return ResponsePtr(new PSMoveProtocol::Response);
+    }
+}
+
+DeviceOutputDataFramePtr ServerNetworkManager::allocate_device_data_frame(int connection_id)
+{
+    if (implementation_ptr != nullptr)
+    {
+        return implementation_ptr->allocate_device_data_frame(connection_id);
+    }
+    else if (embedded_connection_ptr != nullptr && embedded_connection_ptr->get_connection_id() == connection_id)
+    {
+        return embedded_connection_ptr->allocate_device_data_frame();
+    }
+    else
+    {
+        return DeviceOutputDataFramePtr(new PSMoveProtocol::DeviceOutputDataFrame);
+    }
+}
+
+int ServerNetworkManager::get_allocation_count() const
+{
+    if (implementation_ptr != nullptr)
+    {
+        return implementation_ptr->get_allocation_count();
+    }
+    else if (embedded_connection_ptr != nullptr)
+    {
+        return embedded_connection_ptr->get_allocation_count();
+    }
+    else
+    {
+        return 0;
+    }
 }
 
 void ServerNetworkManager::send_device_data_frame(int connection_id, DeviceOutputDataFramePtr data_frame)
@@ -1041,4 +1456,8 @@ void ServerNetworkManager::send_device_data_frame(int connection_id, DeviceOutpu
 	{    
 		implementation_ptr->send_device_data_frame(connection_id, data_frame);
 	}
+    else if (embedded_connection_ptr != nullptr && embedded_connection_ptr->get_connection_id() == connection_id)
+    {
+        embedded_connection_ptr->add_device_data_frame_to_queue(data_frame);
+    }
 }
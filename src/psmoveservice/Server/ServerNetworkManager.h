@@ -48,8 +48,30 @@ public:
     /// Called first by PSMoveService::startup()
     /**
      Calls ServerNetworkManagerImpl::start_connection_accept()
+     \param server_port Port to listen on for clients, or -1 for the configured server_port
      */
-    bool startup(boost::asio::io_service *io_service, ServerRequestHandler *request_handler);
+    bool startup(boost::asio::io_service *io_service, ServerRequestHandler *request_handler, int server_port= -1);
+
+    /// Called by EmbeddedService::startup() instead of startup()
+    /**
+     Serves a single client in the same process without opening any sockets.
+     Responses, notifications and data frames go straight to the given listeners
+     during update().
+     */
+    bool startup_embedded(
+        ServerRequestHandler *request_handler,
+        IDataFrameListener *data_frame_listener,
+        INotificationListener *notification_listener,
+        IResponseListener *response_listener);
+
+    /// Queue a request from the embedded client, handled in the next update()
+    void send_embedded_request(RequestPtr request);
+
+    /// Queue a data frame from the embedded client, handled in the next update()
+    void send_embedded_input_data_frame(DeviceInputDataFramePtr data_frame);
+
+    /// Get a cleared data frame from the embedded client's input data frame pool
+    DeviceInputDataFramePtr allocate_embedded_input_data_frame();
     
     /// Called last by PSMoveService::update()
     /**
@@ -69,6 +91,16 @@ public:
     
     void send_device_data_frame(int connection_id, DeviceOutputDataFramePtr data_frame);
 
+    /// Get a cleared response from the connection's response pool
+    ResponsePtr allocate_response(int connection_id);
+
+    /// Get a cleared data frame from the connection's data frame pool
+    DeviceOutputDataFramePtr allocate_device_data_frame(int connection_id);
+
+    /// Number of heap allocations made for network messages and buffers so far.
+    /// This stops increasing once streaming reaches a steady state.
+    int get_allocation_count() const;
+
 private:   
 	/// Configuration settings used by the network manager
 	NetworkManagerConfig m_cfg;
@@ -76,6 +108,9 @@ private:
     /// private implementation - same lifetime as the NetworkManager
     class ServerNetworkManagerImpl *implementation_ptr;
 
+    /// the in-process client when started with startup_embedded(), otherwise null
+    class EmbeddedClientConnection *embedded_connection_ptr;
+
     /// Singleton instance of the class
     /// Assigned in startup, cleared in teardown
     static ServerNetworkManager *m_instance;
@@ -25,14 +25,22 @@
 #include "ServerHMDView.h"
 #include "ServerLog.h"
 #include "ServerUtility.h"
+#include "ServiceStatistics.h"
 #include "TrackerManager.h"
+#include "TrackerPoseCalibrator.h"
 #include "VirtualController.h"
 
+#include <algorithm>
 #include <cassert>
 #include <bitset>
+#include <chrono>
 #include <map>
 #include <boost/shared_ptr.hpp>
 
+//-- constants -----
+static const int k_default_network_video_jpeg_quality = 75;
+static const std::chrono::milliseconds k_tracker_pose_calibration_progress_interval(100);
+
 //-- pre-declarations -----
 class ServerRequestHandlerImpl;
 typedef boost::shared_ptr<ServerRequestHandlerImpl> ServerRequestHandlerImplPtr;
@@ -48,6 +56,12 @@ struct RequestConnectionState
     ControllerStreamInfo active_controller_stream_info[ControllerManager::k_max_devices];
     TrackerStreamInfo active_tracker_stream_info[TrackerManager::k_max_devices];
     HMDStreamInfo active_hmd_stream_info[HMDManager::k_max_devices];
+    int service_statistics_stream_interval_ms; // 0 if no statistics stream is active
+    std::chrono::steady_clock::time_point last_service_statistics_publish_time;
+    bool owns_tracker_pose_calibration; // this connection started the running tracker pose calibration
+    int last_tracker_pose_calibration_revision;
+    eTrackerPoseCalibrationPhase last_tracker_pose_calibration_phase;
+    std::chrono::steady_clock::time_point last_tracker_pose_calibration_publish_time;
 
     RequestConnectionState()
         : connection_id(-1)
@@ -55,6 +69,12 @@ struct RequestConnectionState
         , active_tracker_streams()
         , active_hmd_streams()
         , pending_bluetooth_request(nullptr)
+        , service_statistics_stream_interval_ms(0)
+        , last_service_statistics_publish_time()
+        , owns_tracker_pose_calibration(false)
+        , last_tracker_pose_calibration_revision(-1)
+        , last_tracker_pose_calibration_phase(TrackerPoseCalibration_Idle)
+        , last_tracker_pose_calibration_publish_time()
     {
         for (int index = 0; index < ControllerManager::k_max_devices; ++index)
         {
@@ -91,6 +111,7 @@ public:
     ServerRequestHandlerImpl(DeviceManager &deviceManager)
         : m_device_manager(deviceManager)
         , m_connection_state_map()
+        , m_statistics_samples()
     {
     }
 
@@ -165,6 +186,30 @@ public:
                     connection_state->pending_bluetooth_request= nullptr;
                 }
             }
+
+            // Publish the service statistics to connections streaming them
+            if (connection_state->service_statistics_stream_interval_ms > 0)
+            {
+                const std::chrono::steady_clock::time_point now= std::chrono::steady_clock::now();
+
+                if (now - connection_state->last_service_statistics_publish_time >= 
+                    std::chrono::milliseconds(connection_state->service_statistics_stream_interval_ms))
+                {
+                    ResponsePtr notification= ServerNetworkManager::get_instance()->allocate_response(connection_id);
+
+                    notification->set_request_id(-1);
+                    build_service_statistics_response(notification.get());
+
+                    ServerNetworkManager::get_instance()->send_notification(connection_id, notification);
+                    connection_state->last_service_statistics_publish_time= now;
+                }
+            }
+
+            // Stream tracker pose calibration progress to the connection that started it
+            if (connection_state->owns_tracker_pose_calibration)
+            {
+                publish_tracker_pose_calibration_progress(connection_id, connection_state);
+            }
         }
     }
 
@@ -175,213 +220,184 @@ public:
         context.request= request;
         context.connection_state= FindOrCreateConnectionState(connection_id);
 
-        // All responses track which request they came from
-        PSMoveProtocol::Response *response= nullptr;
+        // All responses track which request they came from.
+        // Responses come from the connection's message pool rather than the heap.
+        ResponsePtr pooled_response= ServerNetworkManager::get_instance()->allocate_response(connection_id);
+        PSMoveProtocol::Response *response= pooled_response.get();
 
         switch (request->type())
         {
             // Controller Requests
             case PSMoveProtocol::Request_RequestType_GET_CONTROLLER_LIST:
-                response = new PSMoveProtocol::Response;
                 handle_request__get_controller_list(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_START_CONTROLLER_DATA_STREAM:
-                response = new PSMoveProtocol::Response;
                 handle_request__start_controller_data_stream(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_STOP_CONTROLLER_DATA_STREAM:
-                response = new PSMoveProtocol::Response;
                 handle_request__stop_controller_data_stream(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_RESET_ORIENTATION:
-                response = new PSMoveProtocol::Response;
                 handle_request__reset_orientation(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_UNPAIR_CONTROLLER:
-                response = new PSMoveProtocol::Response;
                 handle_request__unpair_controller(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_PAIR_CONTROLLER:
-                response = new PSMoveProtocol::Response;
                 handle_request__pair_controller(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_CANCEL_BLUETOOTH_REQUEST:
-                response = new PSMoveProtocol::Response;
                 handle_request__cancel_bluetooth_request(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_LED_TRACKING_COLOR:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_led_tracking_color(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_CONTROLLER_MAGNETOMETER_CALIBRATION:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_controller_magnetometer_calibration(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_CONTROLLER_ACCELEROMETER_CALIBRATION:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_controller_accelerometer_calibration(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_CONTROLLER_GYROSCOPE_CALIBRATION:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_controller_gyroscope_calibration(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_OPTICAL_NOISE_CALIBRATION:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_optical_noise_calibration(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_ORIENTATION_FILTER:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_orientation_filter(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_POSITION_FILTER:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_position_filter(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_CONTROLLER_PREDICTION_TIME:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_controller_prediction_time(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_ATTACHED_CONTROLLER:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_attached_controller(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_GAMEPAD_INDEX:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_gamepad_index(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_CONTROLLER_DATA_STREAM_TRACKER_INDEX:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_controller_data_stream_tracker_index(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_CONTROLLER_HAND:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_controller_hand(context, response);
                 break;
 
             // Tracker Requests
             case PSMoveProtocol::Request_RequestType_GET_TRACKER_LIST:
-                response = new PSMoveProtocol::Response;
                 handle_request__get_tracker_list(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_START_TRACKER_DATA_STREAM:
-                response = new PSMoveProtocol::Response;
                 handle_request__start_tracker_data_stream(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_STOP_TRACKER_DATA_STREAM:
-                response = new PSMoveProtocol::Response;
                 handle_request__stop_tracker_data_stream(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_GET_TRACKER_SETTINGS:
-                response = new PSMoveProtocol::Response;
                 handle_request__get_tracker_settings(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_FRAME_WIDTH:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_frame_width(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_FRAME_HEIGHT:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_frame_height(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_FRAME_RATE:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_frame_rate(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_EXPOSURE:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_exposure(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_GAIN:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_gain(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_OPTION:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_option(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_COLOR_PRESET:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_color_preset(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_POSE:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_pose(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_TRACKER_INTRINSICS:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_tracker_intrinsics(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SAVE_TRACKER_PROFILE:
-                response = new PSMoveProtocol::Response;
                 handle_request__save_tracker_profile(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_RELOAD_TRACKER_SETTINGS:
-                response = new PSMoveProtocol::Response;
                 handle_request__reload_tracker_settings(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_APPLY_TRACKER_PROFILE:
-                response = new PSMoveProtocol::Response;
                 handle_request__apply_tracker_profile(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SEARCH_FOR_NEW_TRACKERS:
-                response = new PSMoveProtocol::Response;
                 handle_request__search_for_new_trackers(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_GET_TRACKING_SPACE_SETTINGS:
-                response = new PSMoveProtocol::Response;
                 handle_request__get_tracking_space_settings(context, response);
                 break;
 
             // HMD Requests
             case PSMoveProtocol::Request_RequestType_GET_HMD_LIST:
-                response = new PSMoveProtocol::Response;
                 handle_request__get_hmd_list(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_START_HMD_DATA_STREAM:
-                response = new PSMoveProtocol::Response;
                 handle_request__start_hmd_data_stream(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_STOP_HMD_DATA_STREAM:
-                response = new PSMoveProtocol::Response;
                 handle_request__stop_hmd_data_stream(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_HMD_LED_TRACKING_COLOR:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_hmd_led_tracking_color(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_HMD_ACCELEROMETER_CALIBRATION:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_hmd_accelerometer_calibration(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_HMD_GYROSCOPE_CALIBRATION:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_hmd_gyroscope_calibration(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_HMD_ORIENTATION_FILTER:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_hmd_orientation_filter(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_HMD_POSITION_FILTER:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_hmd_position_filter(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_HMD_PREDICTION_TIME:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_hmd_prediction_time(context, response);
                 break;
             case PSMoveProtocol::Request_RequestType_SET_HMD_DATA_STREAM_TRACKER_INDEX:
-                response = new PSMoveProtocol::Response;
                 handle_request__set_hmd_data_stream_tracker_index(context, response);
                 break;
 
             // General Service Requests
             case PSMoveProtocol::Request_RequestType_GET_SERVICE_VERSION:
-                response = new PSMoveProtocol::Response;
                 handle_request__get_service_version(context, response);
                 break;
+            case PSMoveProtocol::Request_RequestType_GET_SERVICE_STATISTICS:
+                handle_request__get_service_statistics(context, response);
+                break;
+            case PSMoveProtocol::Request_RequestType_START_SERVICE_STATISTICS_STREAM:
+                handle_request__start_service_statistics_stream(context, response);
+                break;
+            case PSMoveProtocol::Request_RequestType_STOP_SERVICE_STATISTICS_STREAM:
+                handle_request__stop_service_statistics_stream(context, response);
+                break;
+            case PSMoveProtocol::Request_RequestType_START_TRACKER_POSE_CALIBRATION:
+                handle_request__start_tracker_pose_calibration(context, response);
+                break;
+            case PSMoveProtocol::Request_RequestType_STOP_TRACKER_POSE_CALIBRATION:
+                handle_request__stop_tracker_pose_calibration(context, response);
+                break;
 
             default:
                 assert(0 && "Whoops, bad request!");
+                pooled_response.reset();
+                response= nullptr;
         }
 
         if (response != nullptr)
@@ -389,7 +405,7 @@ public:
             response->set_request_id(request->request_id());
         }
 
-        return ResponsePtr(response);
+        return pooled_response;
     }
 
     void handle_input_data_frame(DeviceInputDataFramePtr data_frame)
@@ -426,8 +442,15 @@ public:
                 connection_state->pending_bluetooth_request= nullptr;
             }
 
+            // Nobody is left to hear about a tracker pose calibration this connection started
+            if (connection_state->owns_tracker_pose_calibration)
+            {
+                m_device_manager.m_tracker_manager->getTrackerPoseCalibrator()->cancel();
+                connection_state->owns_tracker_pose_calibration= false;
+            }
+
             // Clean up any controller state related to this connection
-            for (int controller_id = 0; controller_id < ControllerManager::k_max_devices; ++controller_id)
+            for (int controller_id = 0; controller_id < m_device_manager.getControllerViewMaxCount(); ++controller_id)
             {
                 const ControllerStreamInfo &streamInfo = connection_state->active_controller_stream_info[controller_id];
                 ServerControllerViewPtr controller_view = m_device_manager.getControllerViewPtr(controller_id);
@@ -459,7 +482,7 @@ public:
             }
 
             
-            for (int tracker_id = 0; tracker_id < TrackerManager::k_max_devices; ++tracker_id)
+            for (int tracker_id = 0; tracker_id < m_device_manager.getTrackerViewMaxCount(); ++tracker_id)
             {
                 // Restore any overridden camera settings from the config
                 if (connection_state->active_tracker_stream_info[tracker_id].has_temp_settings_override)
@@ -472,10 +495,16 @@ public:
                 {
                     m_device_manager.getTrackerViewPtr(tracker_id)->stopSharedMemoryVideoStream();
                 }
+
+                // Halt any network video streams this connection has going
+                if (connection_state->active_tracker_stream_info[tracker_id].streaming_network_video)
+                {
+                    m_device_manager.getTrackerViewPtr(tracker_id)->stopNetworkVideoStream(connection_id);
+                }
             }
 
             // Clean up any hmd state related to this connection
-            for (int hmd_id = 0; hmd_id < HMDManager::k_max_devices; ++hmd_id)
+            for (int hmd_id = 0; hmd_id < m_device_manager.getHMDViewMaxCount(); ++hmd_id)
             {
                 const HMDStreamInfo &streamInfo = connection_state->active_hmd_stream_info[hmd_id];
                 ServerHMDViewPtr hmd_view = m_device_manager.getHMDViewPtr(hmd_id);
@@ -516,7 +545,8 @@ public:
                     connection_state->active_controller_stream_info[controller_id];
 
                 // Fill out a data frame specific to this stream using the given callback
-                DeviceOutputDataFramePtr data_frame(new PSMoveProtocol::DeviceOutputDataFrame);
+                DeviceOutputDataFramePtr data_frame=
+                    ServerNetworkManager::get_instance()->allocate_device_data_frame(connection_id);
                 callback(controller_view, &streamInfo, data_frame.get());
 
                 // Send the controller data frame over the network
@@ -543,7 +573,8 @@ public:
                     connection_state->active_tracker_stream_info[tracker_id];
 
                 // Fill out a data frame specific to this stream using the given callback
-                DeviceOutputDataFramePtr data_frame(new PSMoveProtocol::DeviceOutputDataFrame);
+                DeviceOutputDataFramePtr data_frame=
+                    ServerNetworkManager::get_instance()->allocate_device_data_frame(connection_id);
                 callback(tracker_view, &streamInfo, data_frame);
 
                 // Send the tracker data frame over the network
@@ -570,7 +601,8 @@ public:
                     connection_state->active_hmd_stream_info[hmd_id];
 
                 // Fill out a data frame specific to this stream using the given callback
-                DeviceOutputDataFramePtr data_frame(new PSMoveProtocol::DeviceOutputDataFrame);
+                DeviceOutputDataFramePtr data_frame=
+                    ServerNetworkManager::get_instance()->allocate_device_data_frame(connection_id);
                 callback(hmd_view, &streamInfo, data_frame);
 
                 // Send the hmd data frame over the network
@@ -1838,6 +1870,9 @@ protected:
                 case ITrackerInterface::Generic_Webcam:
                     tracker_info->set_tracker_driver(PSMoveProtocol::GENERIC_WEBCAM);
                     break;
+                case ITrackerInterface::Remote:
+                    tracker_info->set_tracker_driver(PSMoveProtocol::REMOTE);
+                    break;
                 default:
                     assert(0 && "Unhandled tracker type");
                 }
@@ -1924,11 +1959,41 @@ protected:
                 // All we have to do is keep track of which connections care about the updates.
                 context.connection_state->active_tracker_streams.set(tracker_id, true);
 
-                // Set control flags for the stream
-                streamInfo.streaming_video_data = true;
+                if (request.network_video_mode() != PSMoveProtocol::Request_RequestStartTrackerDataStream_NetworkVideoMode_NO_NETWORK_VIDEO)
+                {
+                    TrackerVideoStreamSettings settings;
 
-                // Increment the number of stream listeners
-                tracker_view->startSharedMemoryVideoStream();
+                    switch (request.network_video_mode())
+                    {
+                    case PSMoveProtocol::Request_RequestStartTrackerDataStream_NetworkVideoMode_JPEG_ROI:
+                        settings.mode = _TrackerVideoStreamMode_JPEGROI;
+                        break;
+                    case PSMoveProtocol::Request_RequestStartTrackerDataStream_NetworkVideoMode_MASK:
+                        settings.mode = _TrackerVideoStreamMode_Mask;
+                        break;
+                    default:
+                        settings.mode = _TrackerVideoStreamMode_JPEGFrame;
+                        break;
+                    }
+                    settings.max_fps = request.network_video_max_fps();
+                    settings.max_kbps = request.network_video_max_kbps();
+                    settings.jpeg_quality = 
+                        (request.network_video_jpeg_quality() > 0)
+                        ? std::min(request.network_video_jpeg_quality(), 100)
+                        : k_default_network_video_jpeg_quality;
+
+                    // Send the video frames compressed to this connection
+                    streamInfo.streaming_network_video = true;
+                    tracker_view->startNetworkVideoStream(context.connection_state->connection_id, settings);
+                }
+                else if (!streamInfo.streaming_video_data)
+                {
+                    // Set control flags for the stream
+                    streamInfo.streaming_video_data = true;
+
+                    // Increment the number of stream listeners
+                    tracker_view->startSharedMemoryVideoStream();
+                }
 
                 // Return the name of the shared memory block the video frames will be written to
                 response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
@@ -1957,17 +2022,27 @@ protected:
 
             if (tracker_view->getIsOpen())
             {
+                const TrackerStreamInfo streamInfo = context.connection_state->active_tracker_stream_info[tracker_id];
+
                 context.connection_state->active_tracker_streams.set(tracker_id, false);
                 context.connection_state->active_tracker_stream_info[tracker_id].Clear();
 
                 // Restore any overridden camera settings from the config
-                if (context.connection_state->active_tracker_stream_info[tracker_id].has_temp_settings_override)
+                if (streamInfo.has_temp_settings_override)
                 {
                     tracker_view->loadSettings();
                 }
 
                 // Decrement the number of stream listeners
-                tracker_view->stopSharedMemoryVideoStream();
+                if (streamInfo.streaming_video_data)
+                {
+                    tracker_view->stopSharedMemoryVideoStream();
+                }
+
+                if (streamInfo.streaming_network_video)
+                {
+                    tracker_view->stopNetworkVideoStream(context.connection_state->connection_id);
+                }
 
                 response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
             }
@@ -3116,6 +3191,194 @@ protected:
         response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
     }
 
+    void handle_request__get_service_statistics(
+        const RequestContext &context,
+        PSMoveProtocol::Response *response)
+    {
+        build_service_statistics_response(response);
+    }
+
+    void handle_request__start_service_statistics_stream(
+        const RequestContext &context,
+        PSMoveProtocol::Response *response)
+    {
+        const int interval_ms= context.request->request_start_service_statistics_stream().interval_ms();
+
+        response->set_type(PSMoveProtocol::Response_ResponseType_GENERAL_RESULT);
+
+        if (interval_ms > 0)
+        {
+            SERVER_LOG_INFO("ServerRequestHandler") << "Start service statistics stream every " << interval_ms << "ms";
+
+            context.connection_state->service_statistics_stream_interval_ms= interval_ms;
+            context.connection_state->last_service_statistics_publish_time= std::chrono::steady_clock::time_point();
+
+            response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
+        }
+        else
+        {
+            response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_ERROR);
+        }
+    }
+
+    void handle_request__stop_service_statistics_stream(
+        const RequestContext &context,
+        PSMoveProtocol::Response *response)
+    {
+        SERVER_LOG_INFO("ServerRequestHandler") << "Stop service statistics stream";
+
+        context.connection_state->service_statistics_stream_interval_ms= 0;
+
+        response->set_type(PSMoveProtocol::Response_ResponseType_GENERAL_RESULT);
+        response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
+    }
+
+    void build_service_statistics_response(PSMoveProtocol::Response *response)
+    {
+        PSMoveProtocol::Response_ResultServiceStatistics* statistics_result= response->mutable_result_service_statistics();
+
+        response->set_type(PSMoveProtocol::Response_ResponseType_SERVICE_STATISTICS);
+
+        ServiceStatistics::fetchSamples(m_statistics_samples);
+
+        statistics_result->set_uptime_seconds(ServiceStatistics::getUptimeSeconds());
+        for (const ServiceStatisticSample &sample : m_statistics_samples)
+        {
+            PSMoveProtocol::Response_ResultServiceStatistics_Statistic *statistic= statistics_result->add_statistics();
+
+            statistic->set_name(sample.name);
+            statistic->set_value(sample.value);
+        }
+
+        response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
+    }
+
+    void handle_request__start_tracker_pose_calibration(
+        const RequestContext &context,
+        PSMoveProtocol::Response *response)
+    {
+        const auto &request= context.request->request_start_tracker_pose_calibration();
+        TrackerPoseCalibrator *calibrator= m_device_manager.m_tracker_manager->getTrackerPoseCalibrator();
+
+        response->set_type(PSMoveProtocol::Response_ResponseType_GENERAL_RESULT);
+
+        if (calibrator != nullptr &&
+            calibrator->start(
+                m_device_manager.m_tracker_manager, m_device_manager.m_controller_manager,
+                request.controller_id(), request.sample_count()))
+        {
+            context.connection_state->owns_tracker_pose_calibration= true;
+            context.connection_state->last_tracker_pose_calibration_revision= -1;
+            context.connection_state->last_tracker_pose_calibration_phase= TrackerPoseCalibration_Idle;
+
+            response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
+        }
+        else
+        {
+            response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_ERROR);
+        }
+    }
+
+    void handle_request__stop_tracker_pose_calibration(
+        const RequestContext &context,
+        PSMoveProtocol::Response *response)
+    {
+        response->set_type(PSMoveProtocol::Response_ResponseType_GENERAL_RESULT);
+
+        if (context.connection_state->owns_tracker_pose_calibration)
+        {
+            // The CANCELED progress notification goes out on the next update
+            m_device_manager.m_tracker_manager->getTrackerPoseCalibrator()->cancel();
+
+            response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
+        }
+        else
+        {
+            response->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_ERROR);
+        }
+    }
+
+    void publish_tracker_pose_calibration_progress(
+        int connection_id,
+        RequestConnectionStatePtr connection_state)
+    {
+        const TrackerPoseCalibrator *calibrator= m_device_manager.m_tracker_manager->getTrackerPoseCalibrator();
+
+        TrackerPoseCalibrationProgress progress;
+        calibrator->getProgress(progress);
+
+        if (progress.revision == connection_state->last_tracker_pose_calibration_revision)
+        {
+            return;
+        }
+
+        // Phase changes go out right away, sample and iteration updates are throttled
+        const std::chrono::steady_clock::time_point now= std::chrono::steady_clock::now();
+        if (progress.phase == connection_state->last_tracker_pose_calibration_phase &&
+            now - connection_state->last_tracker_pose_calibration_publish_time < k_tracker_pose_calibration_progress_interval)
+        {
+            return;
+        }
+
+        ResponsePtr notification= ServerNetworkManager::get_instance()->allocate_response(connection_id);
+        PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress *progress_result= 
+            notification->mutable_result_tracker_pose_calibration_progress();
+
+        notification->set_request_id(-1);
+        notification->set_type(PSMoveProtocol::Response_ResponseType_TRACKER_POSE_CALIBRATION_PROGRESS);
+        notification->set_result_code(PSMoveProtocol::Response_ResultCode_RESULT_OK);
+
+        switch (progress.phase)
+        {
+        case TrackerPoseCalibration_Idle:
+        case TrackerPoseCalibration_Recording:
+            progress_result->set_phase(PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_RECORDING);
+            break;
+        case TrackerPoseCalibration_Solving:
+            progress_result->set_phase(PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_SOLVING);
+            break;
+        case TrackerPoseCalibration_Succeeded:
+            progress_result->set_phase(PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_SUCCEEDED);
+            break;
+        case TrackerPoseCalibration_Failed:
+            progress_result->set_phase(PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_FAILED);
+            break;
+        case TrackerPoseCalibration_Canceled:
+            progress_result->set_phase(PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_Phase_CANCELED);
+            break;
+        default:
+            assert(0 && "unreachable");
+        }
+
+        progress_result->set_controller_id(progress.controller_id);
+        progress_result->set_sample_count(progress.sample_count);
+        progress_result->set_target_sample_count(progress.target_sample_count);
+        progress_result->set_iteration(progress.iteration);
+        progress_result->set_rms_reprojection_error(progress.rms_reprojection_error);
+
+        for (int tracker_index = 0; tracker_index < progress.tracker_count; ++tracker_index)
+        {
+            PSMoveProtocol::Response_ResultTrackerPoseCalibrationProgress_TrackerResult *tracker_result=
+                progress_result->add_trackers();
+
+            tracker_result->set_tracker_id(progress.tracker_ids[tracker_index]);
+            tracker_result->set_sample_count(progress.tracker_sample_counts[tracker_index]);
+            common_device_pose_to_protocol_pose(progress.tracker_poses[tracker_index], tracker_result->mutable_pose());
+        }
+
+        ServerNetworkManager::get_instance()->send_notification(connection_id, notification);
+
+        connection_state->last_tracker_pose_calibration_revision= progress.revision;
+        connection_state->last_tracker_pose_calibration_phase= progress.phase;
+        connection_state->last_tracker_pose_calibration_publish_time= now;
+
+        // The final state was sent
+        if (!calibrator->getIsActive())
+        {
+            connection_state->owns_tracker_pose_calibration= false;
+        }
+    }
+
     // -- Data Frame Updates -----
     void handle_data_frame__controller_packet(
         RequestConnectionStatePtr connection_state,
@@ -3227,6 +3490,7 @@ protected:
 private:
     DeviceManager &m_device_manager;
     t_connection_state_map m_connection_state_map;
+    std::vector<ServiceStatisticSample> m_statistics_samples; // reused for every statistics response
 };
 
 //-- public interface -----
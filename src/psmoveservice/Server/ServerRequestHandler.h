@@ -41,11 +41,13 @@ struct ControllerStreamInfo
 struct TrackerStreamInfo
 {
     bool streaming_video_data;
+    bool streaming_network_video;
 	bool has_temp_settings_override;
 
     inline void Clear()
     {
         streaming_video_data = false;
+        streaming_network_video = false;
 		has_temp_settings_override = false;
     }
 };
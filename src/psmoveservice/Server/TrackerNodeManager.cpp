@@ -0,0 +1,1056 @@
+//-- includes -----
+#include "TrackerNodeManager.h"
+#include "ServerLog.h"
+#include "ServerTrackerView.h"
+#include "ServiceStatistics.h"
+#include "TrackerManager.h"
+#include "PSMoveProtocol.pb.h"
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <assert.h>
+#include <chrono>
+#include <cstring>
+
+//-- pre-declarations -----
+namespace asio = boost::asio;
+using asio::ip::udp;
+
+typedef std::chrono::time_point<std::chrono::high_resolution_clock> t_high_resolution_timepoint;
+
+//-- constants -----
+static const int k_default_tracker_node_port = 9513;
+
+// A tracker node serves its own clients (i.e. the ConfigTool) next to the central service's ports,
+// so that a node can run on the same host as the central service
+static const int k_default_tracker_node_server_port = 9514;
+
+// Packets are kept under a typical MTU so that they never get fragmented
+static const size_t k_max_tracker_node_packet_size = 1400;
+static const size_t k_tracker_node_receive_buffer_size = 2048;
+
+// Don't let a flood of packets stall the main loop
+static const int k_max_packets_per_update = 256;
+
+// UDP never reorders frames this far apart, so a bigger step back means the node restarted its count
+static const int k_max_reordered_frame_count = 64;
+
+//-- Tracker Node Config -----
+const int TrackerNodeConfig::CONFIG_VERSION = 1;
+
+TrackerNodeConfig::TrackerNodeConfig(const std::string &fnamebase)
+    : PSMoveConfig(fnamebase)
+    , version(CONFIG_VERSION)
+    , remote_trackers_enabled(false)
+    , central_port(k_default_tracker_node_port)
+    , node_name("tracker_node")
+    , node_server_port(k_default_tracker_node_server_port)
+    , announce_interval_ms(1000)
+    , connection_timeout_ms(3000)
+{
+}
+
+const boost::property_tree::ptree
+TrackerNodeConfig::config2ptree()
+{
+    boost::property_tree::ptree pt;
+
+    pt.put("version", TrackerNodeConfig::CONFIG_VERSION);
+    pt.put("remote_trackers_enabled", remote_trackers_enabled);
+    pt.put("central_port", central_port);
+    pt.put("node_name", node_name);
+    pt.put("node_server_port", node_server_port);
+    pt.put("announce_interval_ms", announce_interval_ms);
+    pt.put("connection_timeout_ms", connection_timeout_ms);
+
+    return pt;
+}
+
+void
+TrackerNodeConfig::ptree2config(const boost::property_tree::ptree &pt)
+{
+    version = pt.get<int>("version", 0);
+
+    if (version == TrackerNodeConfig::CONFIG_VERSION)
+    {
+        remote_trackers_enabled = pt.get<bool>("remote_trackers_enabled", remote_trackers_enabled);
+        central_port = pt.get<int>("central_port", central_port);
+        node_name = pt.get<std::string>("node_name", node_name);
+        node_server_port = pt.get<int>("node_server_port", node_server_port);
+        announce_interval_ms = pt.get<int>("announce_interval_ms", announce_interval_ms);
+        connection_timeout_ms = pt.get<int>("connection_timeout_ms", connection_timeout_ms);
+    }
+    else
+    {
+        SERVER_LOG_WARNING("TrackerNodeConfig") <<
+            "Config version " << version << " does not match expected version " <<
+            TrackerNodeConfig::CONFIG_VERSION << ", Using defaults.";
+    }
+}
+
+//-- private methods -----
+static long long time_point_to_microseconds(const t_high_resolution_timepoint &time_point);
+static void write_camera_info(const RemoteTrackerCameraInfo &info, PSMoveProtocol::TrackerNodePacket_Camera *camera);
+static void read_camera_info(const PSMoveProtocol::TrackerNodePacket_Camera &camera, RemoteTrackerCameraInfo &out_info);
+static void write_target(const RemoteTrackerTarget &target, PSMoveProtocol::TrackerNodePacket_Target *target_packet);
+static bool read_target(const PSMoveProtocol::TrackerNodePacket_Target &target_packet, RemoteTrackerTarget &out_target);
+static void write_projection(const RemoteTrackerProjection &projection, PSMoveProtocol::TrackerNodePacket_Projection *projection_packet);
+static bool read_projection(const PSMoveProtocol::TrackerNodePacket_Projection &projection_packet, RemoteTrackerProjection &out_projection);
+
+//-- private implementation -----
+// -TrackerNodeConnection-
+/// A tracker node as seen by the central service
+struct TrackerNodeConnection
+{
+    std::string node_name;
+    udp::endpoint endpoint;
+    t_high_resolution_timepoint last_packet_time;
+    bool bIsConnected;
+};
+
+// -TrackerNodeManagerImpl-
+/// Internal implementation of the tracker node manager.
+class TrackerNodeManagerImpl
+{
+public:
+    TrackerNodeManagerImpl(asio::io_service &io_service, const TrackerNodeConfig &cfg, bool bIsNodeMode)
+        : m_cfg(cfg)
+        , m_io_service(io_service)
+        , m_socket(io_service)
+        , m_bIsNodeMode(bIsNodeMode)
+        , m_central_endpoint()
+        , m_nodes()
+        , m_cameras()
+        , m_camera_list_revision(0)
+        , m_last_announce_time()
+        , m_packet()
+        , m_projections()
+        , m_packets_sent_statistic(ServiceStatistics::registerCounter("tracker_node.packets_sent"))
+        , m_packets_received_statistic(ServiceStatistics::registerCounter("tracker_node.packets_received"))
+        , m_bad_packets_statistic(ServiceStatistics::registerCounter("tracker_node.bad_packets"))
+    {
+        for (int tracker_id = 0; tracker_id < TrackerManager::k_max_devices; ++tracker_id)
+        {
+            m_node_frame_sequence_nums[tracker_id] = 0;
+        }
+    }
+
+    virtual ~TrackerNodeManagerImpl()
+    {
+        close();
+
+        ServiceStatistics::releaseStatistic(m_packets_sent_statistic);
+        ServiceStatistics::releaseStatistic(m_packets_received_statistic);
+        ServiceStatistics::releaseStatistic(m_bad_packets_statistic);
+    }
+
+    inline bool getIsNodeMode() const
+    {
+        return m_bIsNodeMode;
+    }
+
+    bool startCentral()
+    {
+        boost::system::error_code ec;
+
+        m_socket.open(udp::v4(), ec);
+        if (!ec) m_socket.bind(udp::endpoint(udp::v4(), static_cast<unsigned short>(m_cfg.central_port)), ec);
+        if (!ec) m_socket.non_blocking(true, ec);
+
+        if (ec)
+        {
+            SERVER_LOG_ERROR("TrackerNodeManager::startup") <<
+                "Failed to listen for tracker nodes on port " << m_cfg.central_port << ": " << ec.message();
+            return false;
+        }
+
+        SERVER_LOG_INFO("TrackerNodeManager::startup") << "Listening for tracker nodes on port " << m_cfg.central_port;
+        return true;
+    }
+
+    bool startNode(const std::string &central_address)
+    {
+        boost::system::error_code ec;
+
+        // "host" or "host:port"
+        std::string host = central_address;
+        std::string port = std::to_string(m_cfg.central_port);
+        const size_t port_separator = central_address.rfind(':');
+        if (port_separator != std::string::npos)
+        {
+            host = central_address.substr(0, port_separator);
+            port = central_address.substr(port_separator + 1);
+        }
+
+        udp::resolver resolver(m_io_service);
+        udp::resolver::iterator endpoint_iter = resolver.resolve(udp::resolver::query(udp::v4(), host, port), ec);
+
+        if (ec || endpoint_iter == udp::resolver::iterator())
+        {
+            SERVER_LOG_ERROR("TrackerNodeManager::startup") <<
+                "Failed to resolve the central service address " << central_address << ": " << ec.message();
+            return false;
+        }
+        m_central_endpoint = *endpoint_iter;
+
+        m_socket.open(udp::v4(), ec);
+        if (!ec) m_socket.non_blocking(true, ec);
+
+        if (ec)
+        {
+            SERVER_LOG_ERROR("TrackerNodeManager::startup") << "Failed to open the tracker node socket: " << ec.message();
+            return false;
+        }
+
+        SERVER_LOG_INFO("TrackerNodeManager::startup") <<
+            "Running as tracker node \"" << m_cfg.node_name << "\" for central service " << m_central_endpoint;
+        return true;
+    }
+
+    void close()
+    {
+        if (m_socket.is_open())
+        {
+            boost::system::error_code ec;
+            m_socket.close(ec);
+        }
+    }
+
+    void update()
+    {
+        receivePackets();
+
+        if (!m_bIsNodeMode)
+        {
+            disconnectQuietNodes();
+        }
+    }
+
+    // -- Tracker Node -----
+    void sendNodeProjections(TrackerManager *tracker_manager)
+    {
+        const t_high_resolution_timepoint now = std::chrono::high_resolution_clock::now();
+
+        // Announce the cameras now and then, which also lets the central service know we're alive
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(now - m_last_announce_time).count() >= m_cfg.announce_interval_ms)
+        {
+            sendNodeAnnounce(tracker_manager);
+            m_last_announce_time = now;
+        }
+
+        // Search every new video frame for the targets the central service asked for
+        for (int tracker_id : tracker_manager->getOpenDeviceIds())
+        {
+            ServerTrackerViewPtr tracker_view = tracker_manager->getTrackerViewPtr(tracker_id);
+
+            if (!tracker_view->getHasUnpublishedState())
+            {
+                continue;
+            }
+
+            // Stop searching once the central service went quiet
+            std::vector<RemoteTrackerTarget> &targets = m_node_targets[tracker_id];
+            if (!targets.empty() &&
+                std::chrono::duration_cast<std::chrono::milliseconds>(now - m_node_target_times[tracker_id]).count() > m_cfg.connection_timeout_ms)
+            {
+                targets.clear();
+            }
+
+            tracker_view->computeProjectionsForRemoteTargets(targets, m_projections);
+
+            // Every frame gets a packet, even without projections, so that the central service sees the frame rate
+            m_packet.Clear();
+            m_packet.set_type(PSMoveProtocol::TrackerNodePacket_PacketType_NODE_PROJECTIONS);
+            m_packet.set_node_name(m_cfg.node_name);
+            m_packet.set_camera_index(tracker_id);
+            m_packet.set_frame_sequence_num(m_node_frame_sequence_nums[tracker_id]);
+            m_packet.set_capture_timestamp_us(time_point_to_microseconds(tracker_view->getLastNewDataTimestamp()));
+            m_packet.set_send_timestamp_us(time_point_to_microseconds(std::chrono::high_resolution_clock::now()));
+
+            for (const RemoteTrackerProjection &projection : m_projections)
+            {
+                write_projection(projection, m_packet.add_projections());
+            }
+
+            sendPacket(m_central_endpoint);
+            ++m_node_frame_sequence_nums[tracker_id];
+        }
+    }
+
+    // -- Central Service -----
+    inline int getRemoteCameraCount() const
+    {
+        return static_cast<int>(m_cameras.size());
+    }
+
+    inline const RemoteTrackerCamera *getRemoteCamera(int camera_list_index) const
+    {
+        return &m_cameras[camera_list_index];
+    }
+
+    const RemoteTrackerCamera *findRemoteCamera(const std::string &device_path) const
+    {
+        for (const RemoteTrackerCamera &camera : m_cameras)
+        {
+            if (camera.device_path == device_path)
+            {
+                return &camera;
+            }
+        }
+
+        return nullptr;
+    }
+
+    inline int getRemoteCameraListRevision() const
+    {
+        return m_camera_list_revision;
+    }
+
+    void sendRemoteCameraTargets(const std::string &device_path, const std::vector<RemoteTrackerTarget> &targets)
+    {
+        const RemoteTrackerCamera *camera = findRemoteCameraMutable(device_path);
+        const TrackerNodeConnection *node = (camera != nullptr) ? findNode(camera->node_name) : nullptr;
+
+        if (node != nullptr && node->bIsConnected)
+        {
+            m_packet.Clear();
+            m_packet.set_type(PSMoveProtocol::TrackerNodePacket_PacketType_CENTRAL_TARGETS);
+            m_packet.set_node_name(node->node_name);
+            m_packet.set_camera_index(camera->info.camera_index);
+
+            for (const RemoteTrackerTarget &target : targets)
+            {
+                write_target(target, m_packet.add_targets());
+            }
+
+            sendPacket(node->endpoint);
+        }
+    }
+
+private:
+    void receivePackets()
+    {
+        for (int packet_count = 0; packet_count < k_max_packets_per_update; ++packet_count)
+        {
+            boost::system::error_code ec;
+            udp::endpoint sender_endpoint;
+
+            const size_t bytes_received =
+                m_socket.receive_from(asio::buffer(m_receive_buffer, sizeof(m_receive_buffer)), sender_endpoint, 0, ec);
+
+            if (ec == asio::error::would_block || ec == asio::error::try_again)
+            {
+                // No more pending packets
+                break;
+            }
+            else if (ec)
+            {
+                // i.e. a node we sent targets to just went away (ICMP port unreachable)
+                SERVER_LOG_DEBUG("TrackerNodeManager::receivePackets") << "Receive failed: " << ec.message();
+                continue;
+            }
+
+            if (!m_packet.ParseFromArray(m_receive_buffer, static_cast<int>(bytes_received)))
+            {
+                m_bad_packets_statistic->increment();
+                continue;
+            }
+
+            m_packets_received_statistic->increment();
+
+            if (m_bIsNodeMode)
+            {
+                handleCentralPacket();
+            }
+            else
+            {
+                handleNodePacket(sender_endpoint);
+            }
+        }
+    }
+
+    void sendPacket(const udp::endpoint &endpoint)
+    {
+        const int packet_size = m_packet.ByteSize();
+
+        if (packet_size <= static_cast<int>(sizeof(m_send_buffer)))
+        {
+            boost::system::error_code ec;
+
+            m_packet.SerializeToArray(m_send_buffer, packet_size);
+            m_socket.send_to(asio::buffer(m_send_buffer, packet_size), endpoint, 0, ec);
+
+            if (!ec)
+            {
+                m_packets_sent_statistic->increment();
+            }
+            else
+            {
+                SERVER_LOG_DEBUG("TrackerNodeManager::sendPacket") << "Send to " << endpoint << " failed: " << ec.message();
+            }
+        }
+        else
+        {
+            SERVER_LOG_WARNING("TrackerNodeManager::sendPacket") <<
+                "Dropping " << packet_size << " byte tracker node packet (max " << sizeof(m_send_buffer) << " bytes)";
+            m_bad_packets_statistic->increment();
+        }
+    }
+
+    // -- Tracker Node -----
+    void handleCentralPacket()
+    {
+        const int camera_index = m_packet.camera_index();
+
+        if (m_packet.type() == PSMoveProtocol::TrackerNodePacket_PacketType_CENTRAL_TARGETS &&
+            m_packet.node_name() == m_cfg.node_name &&
+            camera_index >= 0 && camera_index < TrackerManager::k_max_devices)
+        {
+            std::vector<RemoteTrackerTarget> &targets = m_node_targets[camera_index];
+
+            targets.clear();
+            for (const PSMoveProtocol::TrackerNodePacket_Target &target_packet : m_packet.targets())
+            {
+                RemoteTrackerTarget target;
+
+                if (read_target(target_packet, target))
+                {
+                    targets.push_back(target);
+                }
+            }
+
+            m_node_target_times[camera_index] = std::chrono::high_resolution_clock::now();
+        }
+    }
+
+    void sendNodeAnnounce(TrackerManager *tracker_manager)
+    {
+        m_packet.Clear();
+        m_packet.set_type(PSMoveProtocol::TrackerNodePacket_PacketType_NODE_ANNOUNCE);
+        m_packet.set_node_name(m_cfg.node_name);
+
+        for (int tracker_id : tracker_manager->getOpenDeviceIds())
+        {
+            ServerTrackerViewPtr tracker_view = tracker_manager->getTrackerViewPtr(tracker_id);
+            RemoteTrackerCameraInfo info;
+            float pixel_width, pixel_height;
+
+            info.camera_index = tracker_id;
+            info.device_path = tracker_view->getUSBDevicePath();
+            tracker_view->getPixelDimensions(pixel_width, pixel_height);
+            info.frame_width = static_cast<int>(pixel_width);
+            info.frame_height = static_cast<int>(pixel_height);
+            info.frame_rate = static_cast<float>(tracker_view->getFrameRate());
+            tracker_view->getCameraIntrinsics(
+                info.focal_length_x, info.focal_length_y,
+                info.principal_x, info.principal_y,
+                info.distortion_k1, info.distortion_k2, info.distortion_k3,
+                info.distortion_p1, info.distortion_p2);
+            tracker_view->getFOV(info.hfov, info.vfov);
+            tracker_view->getZRange(info.znear, info.zfar);
+
+            write_camera_info(info, m_packet.add_cameras());
+        }
+
+        sendPacket(m_central_endpoint);
+    }
+
+    // -- Central Service -----
+    void handleNodePacket(const udp::endpoint &sender_endpoint)
+    {
+        const t_high_resolution_timepoint now = std::chrono::high_resolution_clock::now();
+
+        switch (m_packet.type())
+        {
+        case PSMoveProtocol::TrackerNodePacket_PacketType_NODE_ANNOUNCE:
+            {
+                TrackerNodeConnection *node = findNode(m_packet.node_name());
+
+                if (node == nullptr)
+                {
+                    TrackerNodeConnection new_node;
+                    new_node.node_name = m_packet.node_name();
+                    new_node.bIsConnected = false;
+
+                    m_nodes.push_back(new_node);
+                    node = &m_nodes.back();
+                }
+
+                if (!node->bIsConnected)
+                {
+                    SERVER_LOG_INFO("TrackerNodeManager") <<
+                        "Tracker node \"" << node->node_name << "\" connected from " << sender_endpoint;
+                }
+
+                node->endpoint = sender_endpoint;
+                node->last_packet_time = now;
+                node->bIsConnected = true;
+
+                for (const PSMoveProtocol::TrackerNodePacket_Camera &camera_packet : m_packet.cameras())
+                {
+                    const std::string device_path =
+                        "remote:" + node->node_name + ":" + std::to_string(camera_packet.camera_index());
+                    RemoteTrackerCamera *camera = findRemoteCameraMutable(device_path);
+
+                    if (camera == nullptr)
+                    {
+                        RemoteTrackerCamera new_camera;
+                        new_camera.node_name = node->node_name;
+                        new_camera.device_path = device_path;
+                        new_camera.latest_frame.clear();
+                        new_camera.bIsConnected = false;
+
+                        m_cameras.push_back(new_camera);
+                        camera = &m_cameras.back();
+                    }
+
+                    read_camera_info(camera_packet, camera->info);
+
+                    if (!camera->bIsConnected)
+                    {
+                        SERVER_LOG_INFO("TrackerNodeManager") <<
+                            "Remote camera " << device_path << " (" << camera->info.device_path << ") available";
+
+                        camera->latest_frame.clear();
+                        camera->bIsConnected = true;
+                        ++m_camera_list_revision;
+                    }
+                }
+            } break;
+        case PSMoveProtocol::TrackerNodePacket_PacketType_NODE_PROJECTIONS:
+            {
+                TrackerNodeConnection *node = findNode(m_packet.node_name());
+                const std::string device_path =
+                    "remote:" + m_packet.node_name() + ":" + std::to_string(m_packet.camera_index());
+                RemoteTrackerCamera *camera = findRemoteCameraMutable(device_path);
+
+                // Ignore the cameras of nodes that haven't (re)announced themselves yet
+                if (node != nullptr && node->bIsConnected && camera != nullptr && camera->bIsConnected)
+                {
+                    node->endpoint = sender_endpoint;
+                    node->last_packet_time = now;
+
+                    RemoteTrackerFrame &frame = camera->latest_frame;
+
+                    // A node that restarts before it times out starts counting frames from zero again
+                    if (frame.frame_sequence_num - m_packet.frame_sequence_num() > k_max_reordered_frame_count)
+                    {
+                        SERVER_LOG_INFO("TrackerNodeManager") <<
+                            "Remote camera " << device_path << " restarted its frame count";
+
+                        frame.clear();
+                    }
+
+                    // Drop frames that arrive out of order
+                    if (m_packet.frame_sequence_num() > frame.frame_sequence_num)
+                    {
+                        // The node and central clocks aren't synced,
+                        // but the age of the frame when it was sent is good for both
+                        const long long frame_age_us =
+                            std::max<long long>(m_packet.send_timestamp_us() - m_packet.capture_timestamp_us(), 0);
+
+                        frame.frame_sequence_num = m_packet.frame_sequence_num();
+                        frame.capture_timestamp = now - std::chrono::microseconds(frame_age_us);
+                        frame.projections.clear();
+
+                        for (const PSMoveProtocol::TrackerNodePacket_Projection &projection_packet : m_packet.projections())
+                        {
+                            RemoteTrackerProjection projection;
+
+                            if (read_projection(projection_packet, projection))
+                            {
+                                frame.projections.push_back(projection);
+                            }
+                        }
+                    }
+                }
+            } break;
+        default:
+            m_bad_packets_statistic->increment();
+            break;
+        }
+    }
+
+    void disconnectQuietNodes()
+    {
+        const t_high_resolution_timepoint now = std::chrono::high_resolution_clock::now();
+
+        for (TrackerNodeConnection &node : m_nodes)
+        {
+            if (node.bIsConnected &&
+                std::chrono::duration_cast<std::chrono::milliseconds>(now - node.last_packet_time).count() > m_cfg.connection_timeout_ms)
+            {
+                SERVER_LOG_WARNING("TrackerNodeManager") << "Tracker node \"" << node.node_name << "\" timed out";
+
+                node.bIsConnected = false;
+
+                for (RemoteTrackerCamera &camera : m_cameras)
+                {
+                    if (camera.node_name == node.node_name && camera.bIsConnected)
+                    {
+                        camera.bIsConnected = false;
+                        ++m_camera_list_revision;
+                    }
+                }
+            }
+        }
+    }
+
+    TrackerNodeConnection *findNode(const std::string &node_name)
+    {
+        for (TrackerNodeConnection &node : m_nodes)
+        {
+            if (node.node_name == node_name)
+            {
+                return &node;
+            }
+        }
+
+        return nullptr;
+    }
+
+    RemoteTrackerCamera *findRemoteCameraMutable(const std::string &device_path)
+    {
+        for (RemoteTrackerCamera &camera : m_cameras)
+        {
+            if (camera.device_path == device_path)
+            {
+                return &camera;
+            }
+        }
+
+        return nullptr;
+    }
+
+    const TrackerNodeConfig &m_cfg;
+    asio::io_service &m_io_service;
+    udp::socket m_socket;
+    bool m_bIsNodeMode;
+
+    // Tracker node state
+    udp::endpoint m_central_endpoint;
+    std::vector<RemoteTrackerTarget> m_node_targets[TrackerManager::k_max_devices];
+    t_high_resolution_timepoint m_node_target_times[TrackerManager::k_max_devices];
+    int m_node_frame_sequence_nums[TrackerManager::k_max_devices];
+
+    // Central service state.
+    // Entries are never removed so that enumerator indices stay valid,
+    // disconnected nodes and cameras are flagged instead.
+    std::vector<TrackerNodeConnection> m_nodes;
+    std::vector<RemoteTrackerCamera> m_cameras;
+    int m_camera_list_revision;
+
+    t_high_resolution_timepoint m_last_announce_time;
+    PSMoveProtocol::TrackerNodePacket m_packet;
+    std::vector<RemoteTrackerProjection> m_projections;
+    unsigned char m_send_buffer[k_max_tracker_node_packet_size];
+    unsigned char m_receive_buffer[k_tracker_node_receive_buffer_size];
+
+    ServiceStatistic *m_packets_sent_statistic;
+    ServiceStatistic *m_packets_received_statistic;
+    ServiceStatistic *m_bad_packets_statistic;
+};
+
+//-- public interface -----
+TrackerNodeManager *TrackerNodeManager::m_instance = NULL;
+
+TrackerNodeManager::TrackerNodeManager()
+    : m_cfg()
+    , implementation_ptr(nullptr)
+{
+}
+
+TrackerNodeManager::~TrackerNodeManager()
+{
+    if (m_instance != NULL)
+    {
+        SERVER_LOG_ERROR("~TrackerNodeManager") << "Tracker node manager deleted without shutdown() getting called first";
+    }
+
+    if (implementation_ptr != nullptr)
+    {
+        delete implementation_ptr;
+        implementation_ptr = nullptr;
+    }
+}
+
+bool TrackerNodeManager::startup(boost::asio::io_service *io_service, const std::string &central_address)
+{
+    bool bSuccess = true;
+
+    m_cfg.load();
+    m_cfg.save();
+
+    const bool bIsNodeMode = !central_address.empty();
+
+    // The central service only listens for nodes when asked to
+    if (bIsNodeMode || m_cfg.remote_trackers_enabled)
+    {
+        implementation_ptr = new TrackerNodeManagerImpl(*io_service, m_cfg, bIsNodeMode);
+
+        bSuccess = bIsNodeMode ? implementation_ptr->startNode(central_address) : implementation_ptr->startCentral();
+    }
+
+    m_instance = this;
+
+    return bSuccess;
+}
+
+void TrackerNodeManager::update()
+{
+    if (implementation_ptr != nullptr)
+    {
+        implementation_ptr->update();
+    }
+}
+
+void TrackerNodeManager::shutdown()
+{
+    if (implementation_ptr != nullptr)
+    {
+        implementation_ptr->close();
+    }
+
+    m_instance = NULL;
+}
+
+bool TrackerNodeManager::getIsNodeMode() const
+{
+    return implementation_ptr != nullptr && implementation_ptr->getIsNodeMode();
+}
+
+const std::string &TrackerNodeManager::getNodeName() const
+{
+    return m_cfg.node_name;
+}
+
+int TrackerNodeManager::getNodeServerPort() const
+{
+    return m_cfg.node_server_port;
+}
+
+void TrackerNodeManager::sendNodeProjections(TrackerManager *tracker_manager)
+{
+    if (getIsNodeMode())
+    {
+        implementation_ptr->sendNodeProjections(tracker_manager);
+    }
+}
+
+int TrackerNodeManager::getRemoteCameraCount() const
+{
+    return (implementation_ptr != nullptr) ? implementation_ptr->getRemoteCameraCount() : 0;
+}
+
+const RemoteTrackerCamera *TrackerNodeManager::getRemoteCamera(int camera_list_index) const
+{
+    assert(camera_list_index >= 0 && camera_list_index < getRemoteCameraCount());
+
+    return implementation_ptr->getRemoteCamera(camera_list_index);
+}
+
+const RemoteTrackerCamera *TrackerNodeManager::findRemoteCamera(const std::string &device_path) const
+{
+    return (implementation_ptr != nullptr) ? implementation_ptr->findRemoteCamera(device_path) : nullptr;
+}
+
+int TrackerNodeManager::getRemoteCameraListRevision() const
+{
+    return (implementation_ptr != nullptr) ? implementation_ptr->getRemoteCameraListRevision() : 0;
+}
+
+void TrackerNodeManager::sendRemoteCameraTargets(
+    const std::string &device_path,
+    const std::vector<RemoteTrackerTarget> &targets)
+{
+    if (implementation_ptr != nullptr && !implementation_ptr->getIsNodeMode())
+    {
+        implementation_ptr->sendRemoteCameraTargets(device_path, targets);
+    }
+}
+
+//-- private methods -----
+static long long time_point_to_microseconds(const t_high_resolution_timepoint &time_point)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time_point.time_since_epoch()).count();
+}
+
+static void write_camera_info(
+    const RemoteTrackerCameraInfo &info,
+    PSMoveProtocol::TrackerNodePacket_Camera *camera)
+{
+    camera->set_camera_index(info.camera_index);
+    camera->set_device_path(info.device_path);
+    camera->set_frame_width(info.frame_width);
+    camera->set_frame_height(info.frame_height);
+    camera->set_frame_rate(info.frame_rate);
+    camera->mutable_focal_lengths()->set_x(info.focal_length_x);
+    camera->mutable_focal_lengths()->set_y(info.focal_length_y);
+    camera->mutable_principal_point()->set_x(info.principal_x);
+    camera->mutable_principal_point()->set_y(info.principal_y);
+    camera->set_distortion_k1(info.distortion_k1);
+    camera->set_distortion_k2(info.distortion_k2);
+    camera->set_distortion_k3(info.distortion_k3);
+    camera->set_distortion_p1(info.distortion_p1);
+    camera->set_distortion_p2(info.distortion_p2);
+    camera->set_hfov(info.hfov);
+    camera->set_vfov(info.vfov);
+    camera->set_znear(info.znear);
+    camera->set_zfar(info.zfar);
+}
+
+static void read_camera_info(
+    const PSMoveProtocol::TrackerNodePacket_Camera &camera,
+    RemoteTrackerCameraInfo &out_info)
+{
+    out_info.camera_index = camera.camera_index();
+    out_info.device_path = camera.device_path();
+    out_info.frame_width = camera.frame_width();
+    out_info.frame_height = camera.frame_height();
+    out_info.frame_rate = camera.frame_rate();
+    out_info.focal_length_x = camera.focal_lengths().x();
+    out_info.focal_length_y = camera.focal_lengths().y();
+    out_info.principal_x = camera.principal_point().x();
+    out_info.principal_y = camera.principal_point().y();
+    out_info.distortion_k1 = camera.distortion_k1();
+    out_info.distortion_k2 = camera.distortion_k2();
+    out_info.distortion_k3 = camera.distortion_k3();
+    out_info.distortion_p1 = camera.distortion_p1();
+    out_info.distortion_p2 = camera.distortion_p2();
+    out_info.hfov = camera.hfov();
+    out_info.vfov = camera.vfov();
+    out_info.znear = camera.znear();
+    out_info.zfar = camera.zfar();
+}
+
+static void write_target(
+    const RemoteTrackerTarget &target,
+    PSMoveProtocol::TrackerNodePacket_Target *target_packet)
+{
+    const CommonDeviceTrackingShape &shape = target.tracking_shape;
+
+    target_packet->set_device_category(static_cast<PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory>(target.device_category));
+    target_packet->set_device_id(target.device_id);
+
+    PSMoveProtocol::TrackingColorPreset *color_range = target_packet->mutable_color_range();
+    color_range->set_hue_center(target.hsv_color_range.hue_range.center);
+    color_range->set_hue_range(target.hsv_color_range.hue_range.range);
+    color_range->set_saturation_center(target.hsv_color_range.saturation_range.center);
+    color_range->set_saturation_range(target.hsv_color_range.saturation_range.range);
+    color_range->set_value_center(target.hsv_color_range.value_range.center);
+    color_range->set_value_range(target.hsv_color_range.value_range.range);
+
+    target_packet->set_shape_type(static_cast<int>(shape.shape_type));
+    switch (shape.shape_type)
+    {
+    case eCommonTrackingShapeType::Sphere:
+        target_packet->set_sphere_radius_cm(shape.shape.sphere.radius_cm);
+        break;
+    case eCommonTrackingShapeType::LightBar:
+        for (int point_index = 0; point_index < CommonDeviceTrackingShape::TRIANGLE_POINT_COUNT; ++point_index)
+        {
+            const CommonDevicePosition &point = shape.shape.light_bar.triangle[point_index];
+            PSMoveProtocol::Position *position = target_packet->add_lightbar_points_cm();
+
+            position->set_x(point.x);
+            position->set_y(point.y);
+            position->set_z(point.z);
+        }
+        for (int point_index = 0; point_index < CommonDeviceTrackingShape::QUAD_POINT_COUNT; ++point_index)
+        {
+            const CommonDevicePosition &point = shape.shape.light_bar.quad[point_index];
+            PSMoveProtocol::Position *position = target_packet->add_lightbar_points_cm();
+
+            position->set_x(point.x);
+            position->set_y(point.y);
+            position->set_z(point.z);
+        }
+        break;
+    default:
+        break;
+    }
+
+    target_packet->set_roi_x(target.roi_x);
+    target_packet->set_roi_y(target.roi_y);
+    target_packet->set_roi_width(target.roi_width);
+    target_packet->set_roi_height(target.roi_height);
+    target_packet->set_scan_decimation(target.scan_decimation);
+}
+
+static bool read_target(
+    const PSMoveProtocol::TrackerNodePacket_Target &target_packet,
+    RemoteTrackerTarget &out_target)
+{
+    CommonDeviceTrackingShape &shape = out_target.tracking_shape;
+    bool bSuccess = true;
+
+    out_target.device_category = static_cast<int>(target_packet.device_category());
+    out_target.device_id = target_packet.device_id();
+
+    const PSMoveProtocol::TrackingColorPreset &color_range = target_packet.color_range();
+    out_target.hsv_color_range.hue_range.center = color_range.hue_center();
+    out_target.hsv_color_range.hue_range.range = color_range.hue_range();
+    out_target.hsv_color_range.saturation_range.center = color_range.saturation_center();
+    out_target.hsv_color_range.saturation_range.range = color_range.saturation_range();
+    out_target.hsv_color_range.value_range.center = color_range.value_center();
+    out_target.hsv_color_range.value_range.range = color_range.value_range();
+
+    memset(&shape, 0, sizeof(CommonDeviceTrackingShape));
+    shape.shape_type = static_cast<eCommonTrackingShapeType>(target_packet.shape_type());
+    switch (shape.shape_type)
+    {
+    case eCommonTrackingShapeType::Sphere:
+        shape.shape.sphere.radius_cm = target_packet.sphere_radius_cm();
+        break;
+    case eCommonTrackingShapeType::LightBar:
+        if (target_packet.lightbar_points_cm_size() ==
+                CommonDeviceTrackingShape::TRIANGLE_POINT_COUNT + CommonDeviceTrackingShape::QUAD_POINT_COUNT)
+        {
+            for (int point_index = 0; point_index < target_packet.lightbar_points_cm_size(); ++point_index)
+            {
+                const PSMoveProtocol::Position &position = target_packet.lightbar_points_cm(point_index);
+                CommonDevicePosition &point =
+                    (point_index < CommonDeviceTrackingShape::TRIANGLE_POINT_COUNT)
+                    ? shape.shape.light_bar.triangle[point_index]
+                    : shape.shape.light_bar.quad[point_index - CommonDeviceTrackingShape::TRIANGLE_POINT_COUNT];
+
+                point.set(position.x(), position.y(), position.z());
+            }
+        }
+        else
+        {
+            bSuccess = false;
+        }
+        break;
+    default:
+        // Point clouds need the prior pose of the device, which the node doesn't have
+        bSuccess = false;
+        break;
+    }
+
+    out_target.roi_x = target_packet.roi_x();
+    out_target.roi_y = target_packet.roi_y();
+    out_target.roi_width = target_packet.roi_width();
+    out_target.roi_height = target_packet.roi_height();
+    out_target.scan_decimation = target_packet.scan_decimation();
+
+    return bSuccess;
+}
+
+static void write_projection(
+    const RemoteTrackerProjection &projection,
+    PSMoveProtocol::TrackerNodePacket_Projection *projection_packet)
+{
+    const CommonDeviceTrackingProjection &shape_projection = projection.projection;
+
+    projection_packet->set_device_category(static_cast<PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory>(projection.device_category));
+    projection_packet->set_device_id(projection.device_id);
+    projection_packet->set_shape_type(static_cast<int>(shape_projection.shape_type));
+    projection_packet->set_screen_area(shape_projection.screen_area);
+
+    switch (shape_projection.shape_type)
+    {
+    case eCommonTrackingProjectionType::ProjectionType_Ellipse:
+        {
+            PSMoveProtocol::Ellipse *ellipse = projection_packet->mutable_ellipse();
+
+            ellipse->mutable_center()->set_x(shape_projection.shape.ellipse.center.x);
+            ellipse->mutable_center()->set_y(shape_projection.shape.ellipse.center.y);
+            ellipse->set_half_x_extent(shape_projection.shape.ellipse.half_x_extent);
+            ellipse->set_half_y_extent(shape_projection.shape.ellipse.half_y_extent);
+            ellipse->set_angle(shape_projection.shape.ellipse.angle);
+        } break;
+    case eCommonTrackingProjectionType::ProjectionType_LightBar:
+        {
+            for (int point_index = 0; point_index < CommonDeviceTrackingProjection::TRIANGLE_POINT_COUNT; ++point_index)
+            {
+                PSMoveProtocol::Pixel *pixel = projection_packet->add_lightbar_points();
+
+                pixel->set_x(shape_projection.shape.lightbar.triangle[point_index].x);
+                pixel->set_y(shape_projection.shape.lightbar.triangle[point_index].y);
+            }
+            for (int point_index = 0; point_index < CommonDeviceTrackingProjection::QUAD_POINT_COUNT; ++point_index)
+            {
+                PSMoveProtocol::Pixel *pixel = projection_packet->add_lightbar_points();
+
+                pixel->set_x(shape_projection.shape.lightbar.quad[point_index].x);
+                pixel->set_y(shape_projection.shape.lightbar.quad[point_index].y);
+            }
+        } break;
+    default:
+        break;
+    }
+
+    if (projection.bPositionValid)
+    {
+        projection_packet->mutable_position_cm()->set_x(projection.position_cm.x);
+        projection_packet->mutable_position_cm()->set_y(projection.position_cm.y);
+        projection_packet->mutable_position_cm()->set_z(projection.position_cm.z);
+        projection_packet->set_position_valid(true);
+    }
+}
+
+static bool read_projection(
+    const PSMoveProtocol::TrackerNodePacket_Projection &projection_packet,
+    RemoteTrackerProjection &out_projection)
+{
+    CommonDeviceTrackingProjection &shape_projection = out_projection.projection;
+    bool bSuccess = true;
+
+    out_projection.device_category = static_cast<int>(projection_packet.device_category());
+    out_projection.device_id = projection_packet.device_id();
+
+    memset(&shape_projection, 0, sizeof(CommonDeviceTrackingProjection));
+    shape_projection.shape_type = static_cast<eCommonTrackingProjectionType>(projection_packet.shape_type());
+    shape_projection.screen_area = projection_packet.screen_area();
+
+    switch (shape_projection.shape_type)
+    {
+    case eCommonTrackingProjectionType::ProjectionType_Ellipse:
+        {
+            const PSMoveProtocol::Ellipse &ellipse = projection_packet.ellipse();
+
+            shape_projection.shape.ellipse.center.set(ellipse.center().x(), ellipse.center().y());
+            shape_projection.shape.ellipse.half_x_extent = ellipse.half_x_extent();
+            shape_projection.shape.ellipse.half_y_extent = ellipse.half_y_extent();
+            shape_projection.shape.ellipse.angle = ellipse.angle();
+        } break;
+    case eCommonTrackingProjectionType::ProjectionType_LightBar:
+        if (projection_packet.lightbar_points_size() ==
+                CommonDeviceTrackingProjection::TRIANGLE_POINT_COUNT + CommonDeviceTrackingProjection::QUAD_POINT_COUNT)
+        {
+            for (int point_index = 0; point_index < projection_packet.lightbar_points_size(); ++point_index)
+            {
+                const PSMoveProtocol::Pixel &pixel = projection_packet.lightbar_points(point_index);
+                CommonDeviceScreenLocation &point =
+                    (point_index < CommonDeviceTrackingProjection::TRIANGLE_POINT_COUNT)
+                    ? shape_projection.shape.lightbar.triangle[point_index]
+                    : shape_projection.shape.lightbar.quad[point_index - CommonDeviceTrackingProjection::TRIANGLE_POINT_COUNT];
+
+                point.set(pixel.x(), pixel.y());
+            }
+        }
+        else
+        {
+            bSuccess = false;
+        }
+        break;
+    default:
+        bSuccess = false;
+        break;
+    }
+
+    out_projection.bPositionValid = projection_packet.position_valid();
+    if (out_projection.bPositionValid)
+    {
+        out_projection.position_cm.set(
+            projection_packet.position_cm().x(),
+            projection_packet.position_cm().y(),
+            projection_packet.position_cm().z());
+    }
+    else
+    {
+        out_projection.position_cm.clear();
+    }
+
+    return bSuccess;
+}
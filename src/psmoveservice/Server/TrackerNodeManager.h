@@ -0,0 +1,108 @@
+#ifndef TRACKER_NODE_MANAGER_H
+#define TRACKER_NODE_MANAGER_H
+
+//-- includes -----
+#include "PSMoveConfig.h"
+#include "RemoteTracker.h"
+#include <string>
+#include <vector>
+
+//-- pre-declarations -----
+namespace boost {
+    namespace asio {
+        class io_service;
+    }
+}
+
+//-- definitions -----
+class TrackerNodeConfig : public PSMoveConfig
+{
+public:
+    static const int CONFIG_VERSION;
+
+    TrackerNodeConfig(const std::string &fnamebase = "TrackerNodeConfig");
+
+    virtual const boost::property_tree::ptree config2ptree();
+    virtual void ptree2config(const boost::property_tree::ptree &pt);
+
+    long version;
+    // Central service: accept cameras from tracker nodes
+    bool remote_trackers_enabled;
+    // Central service: UDP port the tracker nodes send to
+    int central_port;
+    // Tracker node: name the node's cameras are announced under (must be unique per node)
+    std::string node_name;
+    // Tracker node: port the node serves its own clients on, instead of the central service's port
+    int node_server_port;
+    // Tracker node: how often the cameras are re-announced
+    int announce_interval_ms;
+    // How long without a packet before the other side is considered gone
+    int connection_timeout_ms;
+};
+
+// -Tracker Node Manager-
+/// Exchanges TrackerNodePackets over UDP.
+/// On the central service it collects the cameras and projections that the tracker nodes send
+/// and forwards the search targets to them.
+/// In tracker node mode it announces the local cameras, finds the targets the central service
+/// asked for in each new video frame and sends back the projections instead of the video.
+class TrackerNodeManager
+{
+public:
+    TrackerNodeManager();
+    virtual ~TrackerNodeManager();
+
+    static TrackerNodeManager *get_instance() { return m_instance; }
+
+    /// Called by PSMoveService::startup() before the device manager starts.
+    /**
+     \param central_address Run as a tracker node sending to this host ("host" or "host:port").
+                            Empty to run as the central service.
+     */
+    bool startup(boost::asio::io_service *io_service, const std::string &central_address);
+
+    /// Called by PSMoveService::update() before the device manager update.
+    /// Receives any pending packets and drops nodes that went quiet.
+    void update();
+
+    void shutdown();
+
+    /// True if this service runs as a tracker node
+    bool getIsNodeMode() const;
+
+    /// Tracker node: name the node's cameras are announced under
+    const std::string &getNodeName() const;
+
+    /// Tracker node: port the node's ServerNetworkManager listens on for clients
+    int getNodeServerPort() const;
+
+    // -- Tracker Node
+    /// Called by the device manager in node mode once the trackers have been polled.
+    /// Finds the targets in every new video frame and sends the projections to the central service.
+    void sendNodeProjections(class TrackerManager *tracker_manager);
+
+    // -- Central Service
+    /// Every camera any tracker node announced since startup (connected or not)
+    int getRemoteCameraCount() const;
+    const RemoteTrackerCamera *getRemoteCamera(int camera_list_index) const;
+    const RemoteTrackerCamera *findRemoteCamera(const std::string &device_path) const;
+
+    /// Incremented whenever a remote camera connects or disconnects
+    int getRemoteCameraListRevision() const;
+
+    /// Forward the search targets for a remote camera to its node
+    void sendRemoteCameraTargets(const std::string &device_path, const std::vector<RemoteTrackerTarget> &targets);
+
+private:
+    /// Configuration settings used by the tracker node manager
+    TrackerNodeConfig m_cfg;
+
+    /// private implementation - same lifetime as the TrackerNodeManager
+    class TrackerNodeManagerImpl *implementation_ptr;
+
+    /// Singleton instance of the class
+    /// Assigned in startup, cleared in teardown
+    static TrackerNodeManager *m_instance;
+};
+
+#endif  // TRACKER_NODE_MANAGER_H
@@ -89,4 +89,124 @@ private:
     AtomicObject &operator=(const AtomicObject &copy) = delete;
 };
 
+// Fixed capacity history of device states, indexed by poll sequence number.
+// The newest k_capacity states are kept, pushing a new one overwrites the oldest.
+// Written by a single thread (the one polling the device) and read from any other thread without locks.
+// Each slot records the sequence number of the state it holds. Readers copy the state out and then
+// check that the slot still holds the same sequence number, so a state overwritten mid-copy is skipped.
+template<typename t_state_type, int k_capacity>
+class AtomicStateRing
+{
+public:
+    AtomicStateRing()
+        : m_newestSequence(k_invalid_sequence)
+    {
+        clear();
+    }
+
+    // Forget all states.
+    // Only safe while no other thread is reading or writing the ring (e.g. when the device is opened).
+    void clear()
+    {
+        for (int slot_index = 0; slot_index < k_capacity; ++slot_index)
+        {
+            m_slots[slot_index].sequence.store(k_invalid_sequence);
+        }
+        m_newestSequence.store(k_invalid_sequence);
+    }
+
+    // Add the state with the next sequence number (one more than the last pushed, starting at zero).
+    // Only call from the writing thread.
+    void push(int sequence, const t_state_type &state)
+    {
+        assert(sequence >= 0);
+        assert(m_newestSequence.load(std::memory_order_relaxed) == k_invalid_sequence ||
+               sequence == m_newestSequence.load(std::memory_order_relaxed) + 1);
+        Slot &slot = m_slots[sequence % k_capacity];
+
+        // Mark the slot as being written before touching the state
+        slot.sequence.store(k_invalid_sequence, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.state = state;
+
+        slot.sequence.store(sequence, std::memory_order_release);
+        m_newestSequence.store(sequence, std::memory_order_release);
+    }
+
+    // Sequence number of the newest state, or -1 if the ring is empty
+    int getNewestSequence() const
+    {
+        return m_newestSequence.load(std::memory_order_acquire);
+    }
+
+    // Copy out the state at the given sample index.
+    // A lookBack of 0 corresponds to the most recent state.
+    bool fetchState(int lookBack, t_state_type &out_state) const
+    {
+        const int newest_sequence = getNewestSequence();
+
+        return 
+            lookBack >= 0 && lookBack < k_capacity && newest_sequence - lookBack >= 0 &&
+            readSlot(newest_sequence - lookBack, out_state);
+    }
+
+    // Call visitor(const t_state_type &) on every state with a sequence number newer than the given one,
+    // oldest first. States that were overwritten before they could be read are skipped
+    // (the caller can spot the gap in the sequence numbers).
+    // Returns the number of states visited.
+    template<typename t_visitor>
+    int visitNewerThan(int sequence, t_visitor visitor) const
+    {
+        const int newest_sequence = getNewestSequence();
+        const int oldest_kept_sequence = newest_sequence - k_capacity + 1;
+        int visit_count = 0;
+
+        t_state_type state;
+        for (int visit_sequence = (sequence + 1 > oldest_kept_sequence) ? sequence + 1 : oldest_kept_sequence;
+             visit_sequence <= newest_sequence;
+             ++visit_sequence)
+        {
+            if (visit_sequence >= 0 && readSlot(visit_sequence, state))
+            {
+                visitor(static_cast<const t_state_type &>(state));
+                ++visit_count;
+            }
+        }
+
+        return visit_count;
+    }
+
+private:
+    static const int k_invalid_sequence = -1;
+
+    struct Slot
+    {
+        std::atomic_int sequence;
+        t_state_type state;
+    };
+
+    bool readSlot(int sequence, t_state_type &out_state) const
+    {
+        const Slot &slot = m_slots[sequence % k_capacity];
+
+        if (slot.sequence.load(std::memory_order_acquire) != sequence)
+        {
+            return false;
+        }
+
+        out_state = slot.state;
+
+        // If the writer got to the slot while we were copying, the copy may be torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == sequence;
+    }
+
+    Slot m_slots[k_capacity];
+    std::atomic_int m_newestSequence;
+
+    AtomicStateRing(const AtomicStateRing &copy) = delete;
+    AtomicStateRing &operator=(const AtomicStateRing &copy) = delete;
+};
+
 #endif // ATOMIC_PRIMITIVES_H
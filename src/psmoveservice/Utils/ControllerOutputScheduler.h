@@ -0,0 +1,244 @@
+#ifndef CONTROLLER_OUTPUT_SCHEDULER_H
+#define CONTROLLER_OUTPUT_SCHEDULER_H
+
+//-- includes -----
+#include "ServerLog.h"
+#include "ServiceStatistics.h"
+#include "WorkerThread.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+//-- definitions -----
+/// Writes a controller's LED/rumble output state on its own thread.
+/// A changed state posted from the main thread wakes the writer immediately,
+/// rather than waiting on the next input packet read. States posted faster than the device's
+/// minimum write interval are coalesced into the latest one. States the device forgets unless
+/// they are refreshed (see needsKeepAlive) are rewritten every keep alive interval.
+///
+/// The request->write latency is published as the "<prefix>.output_latency_us" gauges
+/// and summarized in the log when the scheduler stops.
+template<typename t_output_state>
+class ControllerOutputScheduler : public WorkerThread
+{
+public:
+	typedef std::chrono::high_resolution_clock t_clock;
+
+	ControllerOutputScheduler(
+		const std::string &thread_name,
+		int min_write_interval_ms,
+		int keep_alive_interval_ms)
+		: WorkerThread(thread_name)
+		, m_minWriteInterval(min_write_interval_ms)
+		, m_keepAliveInterval(keep_alive_interval_ms)
+		, m_bHasPendingState(false)
+		, m_bHasWrittenState(false)
+		, m_pendingRequestTime()
+		, m_lastWriteTime()
+		, m_latencyStatistic(nullptr)
+		, m_maxLatencyStatistic(nullptr)
+		, m_writeStatistic(nullptr)
+		, m_coalescedStatistic(nullptr)
+		, m_requestWriteCount(0)
+		, m_totalLatencyUs(0)
+		, m_maxLatencyUs(0)
+	{
+	}
+
+	virtual ~ControllerOutputScheduler()
+	{
+		releaseStatistics();
+	}
+
+	void start(const std::string &statistic_prefix)
+	{
+		if (!hasThreadStarted())
+		{
+			m_latencyStatistic = ServiceStatistics::registerGauge(statistic_prefix + ".output_latency_us");
+			m_maxLatencyStatistic = ServiceStatistics::registerGauge(statistic_prefix + ".output_latency_max_us");
+			m_writeStatistic = ServiceStatistics::registerCounter(statistic_prefix + ".output_writes");
+			m_coalescedStatistic = ServiceStatistics::registerCounter(statistic_prefix + ".output_coalesced");
+
+			WorkerThread::startThread();
+		}
+	}
+
+	void stop()
+	{
+		if (hasThreadStarted())
+		{
+			WorkerThread::stopThread();
+
+			if (m_requestWriteCount > 0)
+			{
+				SERVER_LOG_INFO("ControllerOutputScheduler::stop") << m_threadName
+					<< " request->write latency: avg " << (m_totalLatencyUs / m_requestWriteCount)
+					<< "us, max " << m_maxLatencyUs << "us over " << m_requestWriteCount << " writes";
+			}
+		}
+
+		releaseStatistics();
+	}
+
+	/// Queue a new output state. Returns immediately; the write happens on the scheduler thread.
+	void postOutputState(const t_output_state &output_state)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_stateMutex);
+
+			const t_output_state *latest_state =
+				m_bHasPendingState ? &m_pendingState : (m_bHasWrittenState ? &m_writtenState : nullptr);
+			if (latest_state != nullptr && isSameOutputState(*latest_state, output_state))
+			{
+				return;
+			}
+
+			if (m_bHasPendingState)
+			{
+				// Folded into the write that is already waiting on the minimum interval
+				if (m_coalescedStatistic != nullptr)
+				{
+					m_coalescedStatistic->increment();
+				}
+			}
+			else
+			{
+				m_pendingRequestTime = t_clock::now();
+				m_bHasPendingState = true;
+			}
+
+			m_pendingState = output_state;
+		}
+
+		m_wakeCondition.notify_one();
+	}
+
+protected:
+	/// Send the output state to the device. Called on the scheduler thread.
+	virtual bool writeOutputState(const t_output_state &output_state) = 0;
+
+	/// True if the two states would produce the same device output
+	virtual bool isSameOutputState(const t_output_state &a, const t_output_state &b) const = 0;
+
+	/// True if the device stops showing this state unless it is periodically rewritten
+	virtual bool needsKeepAlive(const t_output_state &output_state) const { return false; }
+
+	virtual void onThreadHaltBegin() override
+	{
+		std::lock_guard<std::mutex> lock(m_stateMutex);
+		m_wakeCondition.notify_all();
+	}
+
+	virtual bool doWork() override
+	{
+		std::unique_lock<std::mutex> lock(m_stateMutex);
+
+		const bool bHadPendingState = m_bHasPendingState;
+		const bool bWantsKeepAlive =
+			!bHadPendingState && m_bHasWrittenState && m_keepAliveInterval.count() > 0 &&
+			needsKeepAlive(m_writtenState);
+
+		if (!bHadPendingState && !bWantsKeepAlive)
+		{
+			// Nothing to do until the next change
+			m_wakeCondition.wait(lock, [this] { return m_bHasPendingState || m_exitSignaled.load(); });
+			return true;
+		}
+
+		const t_clock::time_point write_time =
+			bHadPendingState ? m_lastWriteTime + m_minWriteInterval : m_lastWriteTime + m_keepAliveInterval;
+
+		if (t_clock::now() < write_time)
+		{
+			// Wait out the interval, unless a change shows up while waiting on a keep alive
+			m_wakeCondition.wait_until(lock, write_time, [this, bHadPendingState] {
+				return m_bHasPendingState != bHadPendingState || m_exitSignaled.load();
+			});
+			return true;
+		}
+
+		const t_output_state output_state = bHadPendingState ? m_pendingState : m_writtenState;
+		const t_clock::time_point request_time = m_pendingRequestTime;
+		m_bHasPendingState = false;
+
+		lock.unlock();
+		const bool bWriteSucceeded = writeOutputState(output_state);
+		const t_clock::time_point now = t_clock::now();
+		lock.lock();
+
+		// Failed writes also wait out the minimum interval before trying again
+		m_lastWriteTime = now;
+
+		if (bWriteSucceeded)
+		{
+			m_writtenState = output_state;
+			m_bHasWrittenState = true;
+			m_writeStatistic->increment();
+
+			if (bHadPendingState)
+			{
+				const long long latency_us =
+					std::chrono::duration_cast<std::chrono::microseconds>(now - request_time).count();
+
+				++m_requestWriteCount;
+				m_totalLatencyUs += latency_us;
+				if (latency_us > m_maxLatencyUs)
+				{
+					m_maxLatencyUs = latency_us;
+					m_maxLatencyStatistic->set(latency_us);
+				}
+				m_latencyStatistic->set(latency_us);
+			}
+		}
+		else if (bHadPendingState && !m_bHasPendingState)
+		{
+			// Retry the request, keeping its original request time
+			m_pendingState = output_state;
+			m_pendingRequestTime = request_time;
+			m_bHasPendingState = true;
+		}
+
+		return true;
+	}
+
+private:
+	void releaseStatistics()
+	{
+		ServiceStatistic **statistics[] = { &m_latencyStatistic, &m_maxLatencyStatistic, &m_writeStatistic, &m_coalescedStatistic };
+
+		for (ServiceStatistic **statistic : statistics)
+		{
+			if (*statistic != nullptr)
+			{
+				ServiceStatistics::releaseStatistic(*statistic);
+				*statistic = nullptr;
+			}
+		}
+	}
+
+	const std::chrono::milliseconds m_minWriteInterval;
+	const std::chrono::milliseconds m_keepAliveInterval;
+
+	// Multi-threaded state
+	std::mutex m_stateMutex;
+	std::condition_variable m_wakeCondition;
+	t_output_state m_pendingState;
+	t_output_state m_writtenState;
+	bool m_bHasPendingState;
+	bool m_bHasWrittenState;
+	t_clock::time_point m_pendingRequestTime;
+
+	// Worker thread state
+	t_clock::time_point m_lastWriteTime;
+	ServiceStatistic *m_latencyStatistic;
+	ServiceStatistic *m_maxLatencyStatistic;
+	ServiceStatistic *m_writeStatistic;
+	ServiceStatistic *m_coalescedStatistic;
+	long long m_requestWriteCount;
+	long long m_totalLatencyUs;
+	long long m_maxLatencyUs;
+};
+
+#endif // CONTROLLER_OUTPUT_SCHEDULER_H
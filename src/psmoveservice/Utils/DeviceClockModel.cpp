@@ -0,0 +1,191 @@
+//-- includes -----
+#include "DeviceClockModel.h"
+
+#include <algorithm>
+#include <math.h>
+
+//-- constants -----
+// Shortest stretch of readings the tick period is measured over before the counter is trusted
+static const double k_min_rate_window_seconds = 2.0;
+
+// Once the first window has grown this long, later windows of this length only nudge the period
+static const double k_full_rate_window_seconds = 30.0;
+
+// How far the measured period may be from the documented one before the counter is ignored
+static const double k_max_nominal_rate_error = 0.05;
+
+// Fraction of a late arrival the offset moves toward per reading.
+// Early arrivals move it all the way, late ones only slowly pull it along.
+static const double k_offset_relax_factor = 0.002;
+
+// A gap in the readings longer than this fraction of the counter's wrap period
+// may have hidden a wrap, so the counter gets resynchronized
+static const double k_max_unseen_wrap_fraction = 0.5;
+
+//-- public methods -----
+DeviceClockModel::DeviceClockModel()
+    : m_counterBits(0)
+    , m_counterMask(0)
+    , m_nominalTickSeconds(0.0)
+{
+    reset();
+}
+
+void DeviceClockModel::reset(int counter_bits, double nominal_tick_seconds)
+{
+    m_counterBits = std::min(std::max(counter_bits, 0), 32);
+    m_counterMask = (m_counterBits > 0) ? ((uint64_t(1) << m_counterBits) - 1) : 0;
+    m_nominalTickSeconds = std::max(nominal_tick_seconds, 0.0);
+
+    reset();
+}
+
+void DeviceClockModel::reset()
+{
+    m_bHasReading = false;
+    m_lastRawCounter = 0;
+    m_ticks = 0;
+
+    m_epoch = t_timepoint();
+    m_lastArrivalSeconds = 0.0;
+    m_lastMappedSeconds = 0.0;
+
+    m_bIsLocked = false;
+    m_bHasFullRateWindow = false;
+    m_tickSeconds = m_nominalTickSeconds;
+    m_offsetSeconds = 0.0;
+    m_rateWindowStartTicks = 0;
+    m_rateWindowStartSeconds = 0.0;
+    m_resyncCount = 0;
+}
+
+DeviceClockModel::t_timepoint
+DeviceClockModel::update(uint32_t raw_counter, const t_timepoint &host_arrival_time)
+{
+    if (m_counterBits == 0)
+    {
+        return host_arrival_time;
+    }
+
+    const uint32_t counter = static_cast<uint32_t>(raw_counter & m_counterMask);
+
+    if (!m_bHasReading)
+    {
+        // Everything is measured relative to the first reading
+        m_bHasReading = true;
+        m_lastRawCounter = counter;
+        m_ticks = 0;
+        m_epoch = host_arrival_time;
+        m_lastArrivalSeconds = 0.0;
+        m_lastMappedSeconds = 0.0;
+        m_offsetSeconds = 0.0;
+        startRateWindow(0.0);
+
+        return host_arrival_time;
+    }
+
+    const double arrival_seconds = std::chrono::duration<double>(host_arrival_time - m_epoch).count();
+    const double host_gap_seconds = arrival_seconds - m_lastArrivalSeconds;
+    const int64_t delta_ticks = static_cast<int64_t>((uint64_t(counter) - uint64_t(m_lastRawCounter)) & m_counterMask);
+
+    m_lastRawCounter = counter;
+    m_lastArrivalSeconds = arrival_seconds;
+    m_ticks += delta_ticks;
+
+    const double wrap_seconds = static_cast<double>(m_counterMask + 1) * m_tickSeconds;
+    if (m_tickSeconds > 0.0 && host_gap_seconds > k_max_unseen_wrap_fraction*wrap_seconds)
+    {
+        // The device went quiet long enough that the tick count can't be trusted.
+        // Keep the period but start the timeline over at this reading.
+        m_offsetSeconds = arrival_seconds - static_cast<double>(m_ticks)*m_tickSeconds;
+        startRateWindow(arrival_seconds);
+        ++m_resyncCount;
+    }
+    else
+    {
+        const double window_seconds = arrival_seconds - m_rateWindowStartSeconds;
+        const int64_t window_ticks = m_ticks - m_rateWindowStartTicks;
+
+        if (window_seconds >= k_min_rate_window_seconds && window_ticks > 0)
+        {
+            const double measured_tick_seconds = window_seconds / static_cast<double>(window_ticks);
+            const bool bIsPlausible =
+                m_nominalTickSeconds <= 0.0 ||
+                fabs(measured_tick_seconds / m_nominalTickSeconds - 1.0) <= k_max_nominal_rate_error;
+
+            if (!bIsPlausible)
+            {
+                // Not the counter we expected (or it's misbehaving), fall back to the arrival times
+                m_bIsLocked = false;
+                m_bHasFullRateWindow = false;
+                m_tickSeconds = m_nominalTickSeconds;
+                startRateWindow(arrival_seconds);
+            }
+            else if (!m_bHasFullRateWindow)
+            {
+                // The first window keeps growing, so each measurement beats the last
+                setTickSeconds(measured_tick_seconds);
+
+                if (!m_bIsLocked)
+                {
+                    m_offsetSeconds = arrival_seconds - static_cast<double>(m_ticks)*m_tickSeconds;
+                    m_bIsLocked = true;
+                }
+
+                if (window_seconds >= k_full_rate_window_seconds)
+                {
+                    m_bHasFullRateWindow = true;
+                    startRateWindow(arrival_seconds);
+                }
+            }
+            else if (window_seconds >= k_full_rate_window_seconds)
+            {
+                // Follow slow drift (e.g. the device warming up) without jumping on one window
+                setTickSeconds(0.5*(m_tickSeconds + measured_tick_seconds));
+                startRateWindow(arrival_seconds);
+            }
+        }
+    }
+
+    if (!m_bIsLocked && arrival_seconds >= m_lastMappedSeconds)
+    {
+        m_lastMappedSeconds = arrival_seconds;
+
+        return host_arrival_time;
+    }
+
+    double result_seconds = arrival_seconds;
+    if (m_bIsLocked)
+    {
+        const double residual_seconds = arrival_seconds - getMappedSeconds();
+
+        m_offsetSeconds += (residual_seconds < 0.0) ? residual_seconds : k_offset_relax_factor*residual_seconds;
+        result_seconds = std::min(getMappedSeconds(), arrival_seconds);
+    }
+
+    result_seconds = std::max(result_seconds, m_lastMappedSeconds);
+    m_lastMappedSeconds = result_seconds;
+
+    return m_epoch + std::chrono::duration_cast<t_timepoint::duration>(std::chrono::duration<double>(result_seconds));
+}
+
+//-- private methods -----
+void DeviceClockModel::startRateWindow(double host_seconds)
+{
+    m_rateWindowStartTicks = m_ticks;
+    m_rateWindowStartSeconds = host_seconds;
+}
+
+void DeviceClockModel::setTickSeconds(double tick_seconds)
+{
+    // Keep the current reading where it is on the timeline
+    const double mapped_seconds = getMappedSeconds();
+
+    m_tickSeconds = tick_seconds;
+    m_offsetSeconds = mapped_seconds - static_cast<double>(m_ticks)*m_tickSeconds;
+}
+
+double DeviceClockModel::getMappedSeconds() const
+{
+    return m_offsetSeconds + static_cast<double>(m_ticks)*m_tickSeconds;
+}
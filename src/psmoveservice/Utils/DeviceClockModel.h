@@ -0,0 +1,81 @@
+#ifndef DEVICE_CLOCK_MODEL_H
+#define DEVICE_CLOCK_MODEL_H
+
+//-- includes -----
+#include <chrono>
+#include <stdint.h>
+
+//-- definitions -----
+/// Maps the free running timestamp counter in a device's input reports onto the host clock.
+///
+/// The counter is unwrapped into a 64-bit tick count. The tick period is measured against the
+/// host arrival times over a long window, which also absorbs the drift between the two clocks.
+/// The offset follows the earliest arrivals, since a report can only ever arrive late
+/// (by the transport latency and scheduling), never early.
+/// The result is a sample time with the device's own spacing between samples,
+/// rather than the jitter of when the host got around to reading them.
+///
+/// Until the tick period has been measured, or if the counter isn't advancing at a plausible rate,
+/// the host arrival time is returned unchanged.
+/// Not thread safe: owned by whichever thread reads the device's reports.
+class DeviceClockModel
+{
+public:
+    typedef std::chrono::time_point<std::chrono::high_resolution_clock> t_timepoint;
+
+    DeviceClockModel();
+
+    /// Forget all readings and set up for a counter of the given width.
+    /// nominal_tick_seconds is the period the counter is documented to run at,
+    /// or zero if it's unknown (the period is then only measured).
+    /// A counter_bits of zero disables the model (readings keep their arrival time).
+    void reset(int counter_bits, double nominal_tick_seconds);
+
+    /// Forget all readings, keeping the counter description
+    void reset();
+
+    /// Add a counter reading that arrived at the given host time.
+    /// Returns the time the reading was taken, on the host clock.
+    /// Returned times never go backwards and are never later than the arrival time.
+    t_timepoint update(uint32_t raw_counter, const t_timepoint &host_arrival_time);
+
+    /// True once readings are timed by the device counter rather than their arrival
+    inline bool getIsLocked() const { return m_bIsLocked; }
+
+    /// Measured seconds per counter tick (the nominal period until locked)
+    inline double getTickSeconds() const { return m_tickSeconds; }
+
+    /// Number of times the counter had to be resynchronized after a gap in the readings
+    inline int getResyncCount() const { return m_resyncCount; }
+
+private:
+    void startRateWindow(double host_seconds);
+    void setTickSeconds(double tick_seconds);
+    double getMappedSeconds() const;
+
+    // Counter description
+    int m_counterBits;
+    uint64_t m_counterMask;
+    double m_nominalTickSeconds;
+
+    // Unwrapped counter
+    bool m_bHasReading;
+    uint32_t m_lastRawCounter;
+    int64_t m_ticks;
+
+    // Host clock, in seconds since the first reading
+    t_timepoint m_epoch;
+    double m_lastArrivalSeconds;
+    double m_lastMappedSeconds;
+
+    // host_seconds = m_offsetSeconds + m_ticks*m_tickSeconds
+    bool m_bIsLocked;
+    bool m_bHasFullRateWindow;
+    double m_tickSeconds;
+    double m_offsetSeconds;
+    int64_t m_rateWindowStartTicks;
+    double m_rateWindowStartSeconds;
+    int m_resyncCount;
+};
+
+#endif // DEVICE_CLOCK_MODEL_H
@@ -0,0 +1,398 @@
+#include "ServiceStatistics.h"
+#include "ServerLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+//-- constants -----
+// Number of counter and gauge slots in the registry
+static const int k_max_statistics = 64;
+
+// Number of timer slots in the registry
+static const int k_max_timers = 8;
+
+// A timer publishes its percentiles after this many samples
+static const int k_timer_window_sample_count = 500;
+
+// Largest duration a timer can tell apart from the ones above it (~16 seconds)
+static const long long k_max_timer_sample = (1LL << 24) - 1;
+
+// How often the counter rates are refreshed
+static const std::chrono::milliseconds k_rate_update_interval(1000);
+
+//-- globals -----
+static ServiceStatistic g_statistics[k_max_statistics];
+static ServiceStatisticTimer g_timers[k_max_timers];
+static std::atomic_int g_timer_count(0);
+
+// Handed out when the registry is full, so callers never have to check for null
+static ServiceStatistic g_overflow_statistic;
+static ServiceStatisticTimer g_overflow_timer;
+
+static std::mutex g_registration_mutex;
+static const std::chrono::steady_clock::time_point g_registry_start_time = std::chrono::steady_clock::now();
+static std::chrono::steady_clock::time_point g_rate_window_start_time = g_registry_start_time;
+
+//-- private methods -----
+static void copy_statistic_name(const std::string &name, char *out_name)
+{
+    // Truncated names can collide, and would then share a slot
+    if (name.length() >= PSMOVESERVICE_MAX_STATISTIC_NAME_LEN)
+    {
+        SERVER_LOG_WARNING("ServiceStatistics") << "Statistic name too long, truncated: " << name;
+    }
+
+    strncpy(out_name, name.c_str(), PSMOVESERVICE_MAX_STATISTIC_NAME_LEN - 1);
+    out_name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN - 1] = '\0';
+}
+
+// Writers bracket changes to a slot's identity with these so lock-free readers can detect them
+static void begin_slot_write(std::atomic_uint &generation)
+{
+    generation.store(generation.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void end_slot_write(std::atomic_uint &generation)
+{
+    generation.store(generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+//-- ServiceStatistic -----
+ServiceStatistic::ServiceStatistic()
+    : m_generation(0)
+    , m_type(ServiceStatistic_Unused)
+    , m_value(0)
+    , m_rate(0.0)
+    , m_rate_window_start_value(0)
+{
+    m_name[0] = '\0';
+}
+
+//-- ServiceStatisticTimer -----
+ServiceStatisticTimer::ServiceStatisticTimer()
+    : m_publishedWindow(0)
+    , m_generation(0)
+    , m_windowSampleCount(0)
+{
+    m_name[0] = '\0';
+
+    for (int window_index = 0; window_index < 2; ++window_index)
+    {
+        for (int bucket_index = 0; bucket_index < SERVICE_STATISTIC_TIMER_BUCKET_COUNT; ++bucket_index)
+        {
+            m_bucketCounts[window_index][bucket_index].store(0);
+        }
+
+        m_maxSample[window_index].store(0);
+    }
+}
+
+void ServiceStatisticTimer::addSample(long long microseconds)
+{
+    // The window the readers aren't looking at
+    const int window_index = 1 - m_publishedWindow.load(std::memory_order_relaxed);
+    const int bucket_index = computeBucketIndex(microseconds);
+
+    m_bucketCounts[window_index][bucket_index].fetch_add(1, std::memory_order_relaxed);
+
+    if (microseconds > m_maxSample[window_index].load(std::memory_order_relaxed))
+    {
+        m_maxSample[window_index].store(microseconds, std::memory_order_relaxed);
+    }
+
+    ++m_windowSampleCount;
+    if (m_windowSampleCount >= k_timer_window_sample_count)
+    {
+        // Publish the full window and start gathering into the previously published one
+        const int next_window_index = 1 - window_index;
+
+        begin_slot_write(m_generation);
+
+        m_publishedWindow.store(window_index, std::memory_order_relaxed);
+        for (int index = 0; index < SERVICE_STATISTIC_TIMER_BUCKET_COUNT; ++index)
+        {
+            m_bucketCounts[next_window_index][index].store(0, std::memory_order_relaxed);
+        }
+        m_maxSample[next_window_index].store(0, std::memory_order_relaxed);
+
+        end_slot_write(m_generation);
+
+        m_windowSampleCount = 0;
+    }
+}
+
+// Buckets 0-3 hold exact values, every power of two above that is split into 4 buckets
+int ServiceStatisticTimer::computeBucketIndex(long long microseconds)
+{
+    const long long value = std::max(std::min(microseconds, k_max_timer_sample), 0LL);
+
+    if (value < 4)
+    {
+        return static_cast<int>(value);
+    }
+
+    int msb = 2;
+    while ((value >> (msb + 1)) != 0)
+    {
+        ++msb;
+    }
+
+    const int sub_bucket = static_cast<int>((value >> (msb - 2)) & 3);
+
+    return 4 * (msb - 1) + sub_bucket;
+}
+
+long long ServiceStatisticTimer::computeBucketUpperBound(int bucket_index)
+{
+    if (bucket_index < 4)
+    {
+        return bucket_index;
+    }
+
+    const int msb = bucket_index / 4 + 1;
+    const int sub_bucket = bucket_index % 4;
+
+    return (static_cast<long long>(5 + sub_bucket) << (msb - 2)) - 1;
+}
+
+//-- ServiceStatistics -----
+ServiceStatistic *ServiceStatistics::registerCounter(const std::string &name)
+{
+    return registerStatistic(name, ServiceStatistic_Counter);
+}
+
+ServiceStatistic *ServiceStatistics::registerGauge(const std::string &name)
+{
+    return registerStatistic(name, ServiceStatistic_Gauge);
+}
+
+ServiceStatistic *ServiceStatistics::registerStatistic(const std::string &name, eServiceStatisticType type)
+{
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+
+    char slot_name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN];
+    copy_statistic_name(name, slot_name);
+
+    ServiceStatistic *unused_slot = nullptr;
+    for (int slot_index = 0; slot_index < k_max_statistics; ++slot_index)
+    {
+        ServiceStatistic *slot = &g_statistics[slot_index];
+
+        if (slot->m_type.load(std::memory_order_relaxed) == ServiceStatistic_Unused)
+        {
+            if (unused_slot == nullptr)
+            {
+                unused_slot = slot;
+            }
+        }
+        else if (strcmp(slot->m_name, slot_name) == 0)
+        {
+            return slot;
+        }
+    }
+
+    if (unused_slot == nullptr)
+    {
+        SERVER_LOG_WARNING("ServiceStatistics::registerStatistic") << "Registry full. Not reporting: " << name;
+        return &g_overflow_statistic;
+    }
+
+    begin_slot_write(unused_slot->m_generation);
+
+    strcpy(unused_slot->m_name, slot_name);
+    unused_slot->m_type.store(type, std::memory_order_relaxed);
+    unused_slot->m_value.store(0, std::memory_order_relaxed);
+    unused_slot->m_rate.store(0.0, std::memory_order_relaxed);
+    unused_slot->m_rate_window_start_value = 0;
+
+    end_slot_write(unused_slot->m_generation);
+
+    return unused_slot;
+}
+
+void ServiceStatistics::releaseStatistic(ServiceStatistic *statistic)
+{
+    if (statistic == nullptr || statistic == &g_overflow_statistic)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+
+    begin_slot_write(statistic->m_generation);
+
+    statistic->m_type.store(ServiceStatistic_Unused, std::memory_order_relaxed);
+    statistic->m_name[0] = '\0';
+
+    end_slot_write(statistic->m_generation);
+}
+
+ServiceStatisticTimer *ServiceStatistics::registerTimer(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+
+    char timer_name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN];
+    copy_statistic_name(name, timer_name);
+
+    const int timer_count = g_timer_count.load(std::memory_order_relaxed);
+    for (int timer_index = 0; timer_index < timer_count; ++timer_index)
+    {
+        if (strcmp(g_timers[timer_index].m_name, timer_name) == 0)
+        {
+            return &g_timers[timer_index];
+        }
+    }
+
+    if (timer_count >= k_max_timers)
+    {
+        SERVER_LOG_WARNING("ServiceStatistics::registerTimer") << "Registry full. Not reporting: " << name;
+        return &g_overflow_timer;
+    }
+
+    // Timers are never released, so readers only need to see the new count after the name
+    strcpy(g_timers[timer_count].m_name, timer_name);
+    g_timer_count.store(timer_count + 1, std::memory_order_release);
+
+    return &g_timers[timer_count];
+}
+
+void ServiceStatistics::update()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const std::chrono::duration<double> elapsed = now - g_rate_window_start_time;
+
+    if (elapsed < k_rate_update_interval)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g_registration_mutex);
+
+    for (int slot_index = 0; slot_index < k_max_statistics; ++slot_index)
+    {
+        ServiceStatistic &slot = g_statistics[slot_index];
+
+        if (slot.m_type.load(std::memory_order_relaxed) == ServiceStatistic_Counter)
+        {
+            const long long value = slot.getValue();
+
+            slot.m_rate.store(
+                static_cast<double>(value - slot.m_rate_window_start_value) / elapsed.count(),
+                std::memory_order_relaxed);
+            slot.m_rate_window_start_value = value;
+        }
+    }
+
+    g_rate_window_start_time = now;
+}
+
+double ServiceStatistics::getUptimeSeconds()
+{
+    const std::chrono::duration<double> uptime = std::chrono::steady_clock::now() - g_registry_start_time;
+
+    return uptime.count();
+}
+
+void ServiceStatistics::fetchSamples(std::vector<ServiceStatisticSample> &out_samples)
+{
+    out_samples.clear();
+
+    for (int slot_index = 0; slot_index < k_max_statistics; ++slot_index)
+    {
+        const ServiceStatistic &slot = g_statistics[slot_index];
+        const unsigned int generation = slot.m_generation.load(std::memory_order_acquire);
+
+        if ((generation & 1) != 0)
+        {
+            continue;
+        }
+
+        const int type = slot.m_type.load(std::memory_order_relaxed);
+        if (type == ServiceStatistic_Unused)
+        {
+            continue;
+        }
+
+        char name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN];
+        memcpy(name, slot.m_name, sizeof(name));
+        name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN - 1] = '\0';
+
+        const long long value = slot.getValue();
+        const double rate = slot.m_rate.load(std::memory_order_relaxed);
+
+        // Skip the slot if it was re-registered or released while we copied it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.m_generation.load(std::memory_order_relaxed) != generation)
+        {
+            continue;
+        }
+
+        out_samples.push_back({ name, static_cast<double>(value) });
+
+        if (type == ServiceStatistic_Counter)
+        {
+            out_samples.push_back({ std::string(name) + ".rate", rate });
+        }
+    }
+
+    const int timer_count = g_timer_count.load(std::memory_order_acquire);
+    for (int timer_index = 0; timer_index < timer_count; ++timer_index)
+    {
+        const ServiceStatisticTimer &timer = g_timers[timer_index];
+        const unsigned int generation = timer.m_generation.load(std::memory_order_acquire);
+
+        if ((generation & 1) != 0)
+        {
+            continue;
+        }
+
+        const int window_index = timer.m_publishedWindow.load(std::memory_order_relaxed);
+
+        int bucket_counts[SERVICE_STATISTIC_TIMER_BUCKET_COUNT];
+        int sample_count = 0;
+        for (int bucket_index = 0; bucket_index < SERVICE_STATISTIC_TIMER_BUCKET_COUNT; ++bucket_index)
+        {
+            bucket_counts[bucket_index] = timer.m_bucketCounts[window_index][bucket_index].load(std::memory_order_relaxed);
+            sample_count += bucket_counts[bucket_index];
+        }
+        const long long max_sample = timer.m_maxSample[window_index].load(std::memory_order_relaxed);
+
+        // Skip the timer if it published a new window while we copied this one
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (timer.m_generation.load(std::memory_order_relaxed) != generation || sample_count == 0)
+        {
+            continue;
+        }
+
+        const std::string name(timer.m_name);
+        const double percentiles[3] = { 0.5, 0.9, 0.99 };
+        const char *percentile_suffixes[3] = { ".p50", ".p90", ".p99" };
+
+        for (int percentile_index = 0; percentile_index < 3; ++percentile_index)
+        {
+            const int target_count = std::max(static_cast<int>(percentiles[percentile_index] * sample_count + 0.5), 1);
+            int cumulative_count = 0;
+            int bucket_index = 0;
+
+            while (bucket_index < SERVICE_STATISTIC_TIMER_BUCKET_COUNT - 1)
+            {
+                cumulative_count += bucket_counts[bucket_index];
+                if (cumulative_count >= target_count)
+                {
+                    break;
+                }
+                ++bucket_index;
+            }
+
+            // Report the top of the bucket, but never more than the largest sample seen
+            const long long percentile_value =
+                std::min(ServiceStatisticTimer::computeBucketUpperBound(bucket_index), max_sample);
+
+            out_samples.push_back({ name + percentile_suffixes[percentile_index], static_cast<double>(percentile_value) });
+        }
+
+        out_samples.push_back({ name + ".max", static_cast<double>(max_sample) });
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef SERVICE_STATISTICS_H
+#define SERVICE_STATISTICS_H
+
+//-- includes -----
+#include "SharedConstants.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+//-- constants -----
+// Number of log-linear buckets a ServiceStatisticTimer sorts its samples into
+#define SERVICE_STATISTIC_TIMER_BUCKET_COUNT 96
+
+//-- declarations -----
+enum eServiceStatisticType
+{
+    ServiceStatistic_Unused,
+    ServiceStatistic_Counter,   ///< Monotonic count, also reported as a per-second rate
+    ServiceStatistic_Gauge,     ///< Current level, e.g. a queue depth
+};
+
+/// A named value in the service statistics registry.
+/// Any thread can update it without locking.
+class ServiceStatistic
+{
+public:
+    ServiceStatistic();
+
+    inline void increment(long long amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    inline void set(long long value) { m_value.store(value, std::memory_order_relaxed); }
+    inline long long getValue() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    friend class ServiceStatistics;
+
+    // Odd while the slot is being registered or released.
+    // Readers discard anything they copied while this changed.
+    std::atomic_uint m_generation;
+    std::atomic_int m_type;
+    char m_name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN];
+
+    std::atomic_llong m_value;
+    std::atomic<double> m_rate;
+    long long m_rate_window_start_value;
+
+    ServiceStatistic(const ServiceStatistic &copy) = delete;
+    ServiceStatistic &operator=(const ServiceStatistic &copy) = delete;
+};
+
+/// A named distribution of durations in the service statistics registry.
+/// Reported as percentiles over the last completed window of samples.
+/// Samples must all come from the same thread, any thread can read.
+class ServiceStatisticTimer
+{
+public:
+    ServiceStatisticTimer();
+
+    void addSample(long long microseconds);
+
+private:
+    friend class ServiceStatistics;
+
+    static int computeBucketIndex(long long microseconds);
+    static long long computeBucketUpperBound(int bucket_index);
+
+    char m_name[PSMOVESERVICE_MAX_STATISTIC_NAME_LEN];
+
+    // Samples are gathered into one window while readers look at the other
+    std::atomic_int m_bucketCounts[2][SERVICE_STATISTIC_TIMER_BUCKET_COUNT];
+    std::atomic_llong m_maxSample[2];
+    std::atomic_int m_publishedWindow;
+    std::atomic_uint m_generation;
+    int m_windowSampleCount;
+
+    ServiceStatisticTimer(const ServiceStatisticTimer &copy) = delete;
+    ServiceStatisticTimer &operator=(const ServiceStatisticTimer &copy) = delete;
+};
+
+/// A single entry of a statistics snapshot
+struct ServiceStatisticSample
+{
+    std::string name;
+    double value;
+};
+
+/// Registry of the counters, gauges and timers that the service subsystems register into.
+/// Registering, releasing and update() are meant for the main thread.
+/// Updating a statistic and fetching a snapshot never lock.
+class ServiceStatistics
+{
+public:
+    /// Register a monotonic counter (or get the existing one with the same name).
+    /// Never returns null: if the registry is full the counter isn't reported.
+    static ServiceStatistic *registerCounter(const std::string &name);
+
+    /// Register a gauge (or get the existing one with the same name).
+    /// Never returns null: if the registry is full the gauge isn't reported.
+    static ServiceStatistic *registerGauge(const std::string &name);
+
+    /// Stop reporting a counter or gauge. The slot is reused by later registrations,
+    /// so the caller must not touch the statistic afterwards.
+    static void releaseStatistic(ServiceStatistic *statistic);
+
+    /// Register a timer (or get the existing one with the same name).
+    /// Timers are never released.
+    static ServiceStatisticTimer *registerTimer(const std::string &name);
+
+    /// Refresh the per-second counter rates. Called once per main loop tick.
+    static void update();
+
+    /// Seconds since the registry was created
+    static double getUptimeSeconds();
+
+    /// Copy out the current value of every registered statistic.
+    /// Counters add a "<name>.rate" entry, timers add "<name>.p50", ".p90", ".p99" and ".max" entries.
+    static void fetchSamples(std::vector<ServiceStatisticSample> &out_samples);
+
+private:
+    static ServiceStatistic *registerStatistic(const std::string &name, eServiceStatisticType type);
+};
+
+#endif // SERVICE_STATISTICS_H
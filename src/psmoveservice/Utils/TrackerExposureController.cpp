@@ -0,0 +1,208 @@
+//-- includes -----
+#include "TrackerExposureController.h"
+
+#include <algorithm>
+#include <math.h>
+
+//-- constants -----
+// Brightness changes closer to 1 than this are left alone (the camera settings are integers)
+static const double k_min_brightness_change = 0.01;
+
+//-- prototypes -----
+static double scaleExposureSetting(
+    double &in_out_value, double scale, double min_step, double min_value, double max_value);
+
+//-- public methods -----
+TrackerExposureController::TrackerExposureController()
+{
+    TrackerExposureSettings settings;
+
+    settings.min_exposure = 0.0;
+    settings.max_exposure = 0.0;
+    settings.min_gain = 0.0;
+    settings.max_gain = 0.0;
+    settings.target_bulb_value = 0.f;
+    settings.bulb_value_tolerance = 0.f;
+    settings.max_bulb_clipped_fraction = 1.f;
+    settings.max_background_value = 255.f;
+    settings.max_step_fraction = 0.f;
+    settings.min_setting_step = 1.0;
+    settings.adjust_interval_seconds = 0.f;
+    settings.min_sample_count = 1;
+
+    reset(settings);
+}
+
+void TrackerExposureController::reset(const TrackerExposureSettings &settings)
+{
+    m_settings = settings;
+    m_settings.max_exposure = std::max(m_settings.max_exposure, m_settings.min_exposure);
+    m_settings.max_gain = std::max(m_settings.max_gain, m_settings.min_gain);
+    m_settings.max_step_fraction = std::min(std::max(m_settings.max_step_fraction, 0.f), 0.9f);
+    m_settings.min_setting_step = std::max(m_settings.min_setting_step, 0.0);
+    m_settings.min_sample_count = std::max(m_settings.min_sample_count, 1);
+
+    m_sampleCount = 0;
+    m_bulbValueSum = 0.0;
+    m_bulbClippedFractionSum = 0.0;
+    m_backgroundValueSum = 0.0;
+
+    m_bHasUpdated = false;
+    m_lastUpdateTime = t_timepoint();
+    m_decision = _TrackerExposureDecision_Waiting;
+    m_exposure = m_settings.min_exposure;
+    m_gain = m_settings.min_gain;
+    m_adjustmentCount = 0;
+}
+
+void TrackerExposureController::addSample(const TrackerExposureSample &sample)
+{
+    m_bulbValueSum += sample.bulb_value;
+    m_bulbClippedFractionSum += sample.bulb_clipped_fraction;
+    m_backgroundValueSum += sample.background_value;
+    ++m_sampleCount;
+}
+
+bool TrackerExposureController::update(const t_timepoint &now, double current_exposure, double current_gain)
+{
+    m_exposure = current_exposure;
+    m_gain = current_gain;
+
+    // Give the camera time to settle on the last adjustment
+    if (m_bHasUpdated)
+    {
+        const std::chrono::duration<float> time_since_update = now - m_lastUpdateTime;
+
+        if (time_since_update.count() < m_settings.adjust_interval_seconds)
+        {
+            return false;
+        }
+    }
+
+    // Keep collecting until enough of the devices have been seen.
+    // With nothing in view there is nothing to expose for, so the settings stay as they are.
+    if (m_sampleCount < m_settings.min_sample_count)
+    {
+        return false;
+    }
+
+    const float bulb_value = static_cast<float>(m_bulbValueSum / m_sampleCount);
+    const float bulb_clipped_fraction = static_cast<float>(m_bulbClippedFractionSum / m_sampleCount);
+    const float background_value = static_cast<float>(m_backgroundValueSum / m_sampleCount);
+
+    m_sampleCount = 0;
+    m_bulbValueSum = 0.0;
+    m_bulbClippedFractionSum = 0.0;
+    m_backgroundValueSum = 0.0;
+    m_bHasUpdated = true;
+    m_lastUpdateTime = now;
+
+    // How much brighter (> 1) or darker (< 1) the image should get
+    const double min_scale = 1.0 - m_settings.max_step_fraction;
+    const double max_scale = 1.0 + m_settings.max_step_fraction;
+    double brightness_scale = 1.0;
+
+    if (bulb_clipped_fraction > m_settings.max_bulb_clipped_fraction ||
+        background_value > m_settings.max_background_value)
+    {
+        // A blown out bulb reads as 255 however far over it is, so just take the biggest step down
+        brightness_scale = min_scale;
+    }
+    else if (fabsf(bulb_value - m_settings.target_bulb_value) > m_settings.bulb_value_tolerance)
+    {
+        brightness_scale =
+            std::min(std::max(
+                static_cast<double>(m_settings.target_bulb_value) / std::max(bulb_value, 1.f),
+                min_scale), max_scale);
+
+        // Don't light the background up past its limit to get there
+        if (brightness_scale > 1.0 && background_value > 0.f)
+        {
+            brightness_scale =
+                std::min(brightness_scale, static_cast<double>(m_settings.max_background_value) / background_value);
+        }
+    }
+
+    // Settings outside of the bounds (e.g. set by hand) are brought back in even when holding
+    const double old_exposure = m_exposure;
+    const double old_gain = m_gain;
+    m_exposure = std::min(std::max(m_exposure, m_settings.min_exposure), m_settings.max_exposure);
+    m_gain = std::min(std::max(m_gain, m_settings.min_gain), m_settings.max_gain);
+
+    if (fabs(brightness_scale - 1.0) < k_min_brightness_change)
+    {
+        m_decision = _TrackerExposureDecision_Hold;
+    }
+    else if (brightness_scale < 1.0)
+    {
+        // Gain only adds noise, so give it up first
+        const double remaining_scale =
+            brightness_scale / 
+            scaleExposureSetting(
+                m_gain, brightness_scale, m_settings.min_setting_step, m_settings.min_gain, m_settings.max_gain);
+        if (remaining_scale < 1.0 - k_min_brightness_change)
+        {
+            scaleExposureSetting(
+                m_exposure, remaining_scale, m_settings.min_setting_step, m_settings.min_exposure, m_settings.max_exposure);
+        }
+
+        m_decision = _TrackerExposureDecision_Darken;
+    }
+    else
+    {
+        // Longer exposures before more gain
+        const double remaining_scale =
+            brightness_scale / 
+            scaleExposureSetting(
+                m_exposure, brightness_scale, m_settings.min_setting_step, m_settings.min_exposure, m_settings.max_exposure);
+        if (remaining_scale > 1.0 + k_min_brightness_change)
+        {
+            scaleExposureSetting(
+                m_gain, remaining_scale, m_settings.min_setting_step, m_settings.min_gain, m_settings.max_gain);
+        }
+
+        m_decision = _TrackerExposureDecision_Brighten;
+    }
+
+    const bool bChanged = m_exposure != old_exposure || m_gain != old_gain;
+    if (bChanged)
+    {
+        ++m_adjustmentCount;
+    }
+    else if (m_decision != _TrackerExposureDecision_Hold)
+    {
+        m_decision = _TrackerExposureDecision_AtLimit;
+    }
+
+    return bChanged;
+}
+
+//-- private functions -----
+// Scale a camera setting by the given brightness change, within its bounds.
+// Returns the change actually made, for the next setting to make up the rest.
+static double scaleExposureSetting(
+    double &in_out_value, double scale, double min_step, double min_value, double max_value)
+{
+    const double old_value = in_out_value;
+    double new_value = old_value*scale;
+
+    // Close to zero a proportional change rounds away to nothing, so move by at least one step
+    if (scale > 1.0)
+    {
+        new_value = std::max(new_value, old_value + min_step);
+    }
+    else
+    {
+        new_value = std::min(new_value, old_value - min_step);
+    }
+
+    in_out_value = std::min(std::max(new_value, min_value), max_value);
+
+    if (in_out_value == old_value)
+    {
+        return 1.0;
+    }
+
+    // Moving to or from zero is taken as the whole change
+    return (old_value > 0.0 && in_out_value > 0.0) ? (in_out_value / old_value) : scale;
+}
@@ -0,0 +1,98 @@
+#ifndef TRACKER_EXPOSURE_CONTROLLER_H
+#define TRACKER_EXPOSURE_CONTROLLER_H
+
+//-- includes -----
+#include <chrono>
+
+//-- definitions -----
+/// What the exposure control decided the last time it looked at its measurements
+enum eTrackerExposureDecision
+{
+    _TrackerExposureDecision_Disabled, // no exposure control on this tracker
+    _TrackerExposureDecision_Waiting,  // not enough measurements yet
+    _TrackerExposureDecision_Hold,     // the devices are exposed well
+    _TrackerExposureDecision_Darken,   // lowered the gain and/or exposure
+    _TrackerExposureDecision_Brighten, // raised the exposure and/or gain
+    _TrackerExposureDecision_AtLimit,  // wanted to adjust but the settings are at their bounds
+};
+
+/// Brightness of a tracked device and its surroundings in one video frame (HSV value channel, 0-255)
+struct TrackerExposureSample
+{
+    float bulb_value;            // mean value of the pixels in the device's color range
+    float bulb_clipped_fraction; // fraction of the device's bounding box at full brightness
+    float background_value;      // mean value of the rest of the ROI the device was found in
+};
+
+/// Bounds and goals of the exposure control. Exposure and gain are in the tracker's own units.
+struct TrackerExposureSettings
+{
+    double min_exposure, max_exposure;
+    double min_gain, max_gain;
+    float target_bulb_value;         // mean bulb value to aim for
+    float bulb_value_tolerance;      // how far the bulb value may stray from the target before adjusting
+    float max_bulb_clipped_fraction; // darken once more of the bulb than this is blown out
+    float max_background_value;      // darken once the background is brighter than this, never brighten past it
+    float max_step_fraction;         // biggest brightness change per adjustment (0.25 = +/-25%)
+    double min_setting_step;         // smallest change to the exposure or gain the tracker doesn't round away
+    float adjust_interval_seconds;   // least time between adjustments, so the camera settles first
+    int min_sample_count;            // measurements needed before adjusting
+};
+
+/// Adapts a tracker's exposure and gain to the brightness of the devices it tracks.
+///
+/// Measurements of the devices found in each video frame are averaged over an interval,
+/// then the brightness is scaled toward the target by at most max_step_fraction.
+/// Darkening lowers the gain before the exposure (less sensor noise),
+/// brightening raises the exposure before the gain.
+/// A blown out bulb or a bright background always darkens,
+/// since either one makes the color range mask pick up the wrong pixels.
+///
+/// Pure logic: the caller measures the frames and applies the settings to the camera.
+/// Not thread safe: owned by whichever thread updates the tracker.
+class TrackerExposureController
+{
+public:
+    typedef std::chrono::time_point<std::chrono::high_resolution_clock> t_timepoint;
+
+    TrackerExposureController();
+
+    /// Forget all measurements and use the given bounds and goals
+    void reset(const TrackerExposureSettings &settings);
+
+    /// Add the measurement of one device in one video frame
+    void addSample(const TrackerExposureSample &sample);
+
+    /// Look at the measurements if the adjust interval has passed since the last look.
+    /// The current settings are read back from the camera each time, so manual changes are respected
+    /// (and settings outside of the bounds are brought back in).
+    /// Returns true if the camera should be set to getExposure()/getGain().
+    bool update(const t_timepoint &now, double current_exposure, double current_gain);
+
+    inline eTrackerExposureDecision getDecision() const { return m_decision; }
+
+    /// Settings chosen by the last update
+    inline double getExposure() const { return m_exposure; }
+    inline double getGain() const { return m_gain; }
+
+    /// Number of times update() changed the settings since the last reset
+    inline int getAdjustmentCount() const { return m_adjustmentCount; }
+
+private:
+    TrackerExposureSettings m_settings;
+
+    // Measurements since the last look
+    int m_sampleCount;
+    double m_bulbValueSum;
+    double m_bulbClippedFractionSum;
+    double m_backgroundValueSum;
+
+    bool m_bHasUpdated;
+    t_timepoint m_lastUpdateTime;
+    eTrackerExposureDecision m_decision;
+    double m_exposure;
+    double m_gain;
+    int m_adjustmentCount;
+};
+
+#endif // TRACKER_EXPOSURE_CONTROLLER_H
@@ -0,0 +1,116 @@
+#include "VideoFramePool.h"
+#include <assert.h>
+
+// -- VideoFrameBuffer -----
+VideoFrameBuffer::VideoFrameBuffer(VideoFramePool *pool, size_t size)
+    : m_pool(pool)
+    , m_data(new unsigned char[size])
+    , m_size(size)
+    , m_refCount(0)
+{
+}
+
+VideoFrameBuffer::~VideoFrameBuffer()
+{
+    assert(m_refCount.load() == 0);
+    delete[] m_data;
+}
+
+void VideoFrameBuffer::addRef()
+{
+    m_refCount.fetch_add(1);
+}
+
+void VideoFrameBuffer::release()
+{
+    const int old_ref_count = m_refCount.fetch_sub(1);
+    assert(old_ref_count > 0);
+
+    if (old_ref_count == 1)
+    {
+        m_pool->recycleBuffer(this);
+    }
+}
+
+// -- VideoFramePool -----
+VideoFramePool *VideoFramePool::allocate(size_t buffer_size, int buffer_count)
+{
+    return new VideoFramePool(buffer_size, buffer_count);
+}
+
+void VideoFramePool::dispose(VideoFramePool *pool)
+{
+    bool bDeletePool;
+
+    {
+        std::lock_guard<std::mutex> lock(pool->m_freeBuffersMutex);
+
+        pool->m_bDisposed = true;
+        bDeletePool = pool->m_freeBuffers.size() == pool->m_allBuffers.size();
+    }
+
+    // Otherwise the last buffer released deletes the pool
+    if (bDeletePool)
+    {
+        delete pool;
+    }
+}
+
+VideoFramePool::VideoFramePool(size_t buffer_size, int buffer_count)
+    : m_bufferSize(buffer_size)
+    , m_bDisposed(false)
+{
+    m_allBuffers.reserve(buffer_count);
+    m_freeBuffers.reserve(buffer_count);
+
+    for (int buffer_index = 0; buffer_index < buffer_count; ++buffer_index)
+    {
+        VideoFrameBuffer *buffer = new VideoFrameBuffer(this, buffer_size);
+
+        m_allBuffers.push_back(buffer);
+        m_freeBuffers.push_back(buffer);
+    }
+}
+
+VideoFramePool::~VideoFramePool()
+{
+    for (VideoFrameBuffer *buffer : m_allBuffers)
+    {
+        delete buffer;
+    }
+}
+
+VideoFrameRef VideoFramePool::acquireBuffer()
+{
+    VideoFrameBuffer *buffer = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_freeBuffersMutex);
+
+        if (!m_bDisposed && m_freeBuffers.size() > 0)
+        {
+            buffer = m_freeBuffers.back();
+            m_freeBuffers.pop_back();
+        }
+    }
+
+    return VideoFrameRef(buffer);
+}
+
+void VideoFramePool::recycleBuffer(VideoFrameBuffer *buffer)
+{
+    bool bDeletePool;
+
+    {
+        std::lock_guard<std::mutex> lock(m_freeBuffersMutex);
+
+        // m_freeBuffers has capacity for every buffer, so this never allocates
+        m_freeBuffers.push_back(buffer);
+        bDeletePool = m_bDisposed && m_freeBuffers.size() == m_allBuffers.size();
+    }
+
+    if (bDeletePool)
+    {
+        delete this;
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef VIDEO_FRAME_POOL_H
+#define VIDEO_FRAME_POOL_H
+
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <vector>
+
+// -- pre-declarations -----
+class VideoFramePool;
+
+// -- declarations -----
+/// A reference counted video frame buffer owned by a VideoFramePool.
+/// The buffer returns to its pool when the last reference is released.
+class VideoFrameBuffer
+{
+public:
+    inline unsigned char *getData() { return m_data; }
+    inline const unsigned char *getData() const { return m_data; }
+    inline size_t getSize() const { return m_size; }
+
+    void addRef();
+    void release();
+
+private:
+    friend class VideoFramePool;
+
+    VideoFrameBuffer(VideoFramePool *pool, size_t size);
+    ~VideoFrameBuffer();
+
+    VideoFramePool *m_pool;
+    unsigned char *m_data;
+    size_t m_size;
+    std::atomic_int m_refCount;
+};
+
+/// Holds a reference to a VideoFrameBuffer for as long as it's in scope.
+class VideoFrameRef
+{
+public:
+    VideoFrameRef() : m_buffer(nullptr) {}
+    explicit VideoFrameRef(VideoFrameBuffer *buffer) : m_buffer(buffer) { if (m_buffer != nullptr) m_buffer->addRef(); }
+    VideoFrameRef(const VideoFrameRef &other) : VideoFrameRef(other.m_buffer) {}
+    ~VideoFrameRef() { reset(); }
+
+    VideoFrameRef &operator=(const VideoFrameRef &other)
+    {
+        if (other.m_buffer != m_buffer)
+        {
+            VideoFrameBuffer *old_buffer = m_buffer;
+
+            m_buffer = other.m_buffer;
+            if (m_buffer != nullptr) m_buffer->addRef();
+            if (old_buffer != nullptr) old_buffer->release();
+        }
+
+        return *this;
+    }
+
+    void reset()
+    {
+        if (m_buffer != nullptr)
+        {
+            m_buffer->release();
+            m_buffer = nullptr;
+        }
+    }
+
+    inline VideoFrameBuffer *get() const { return m_buffer; }
+    inline VideoFrameBuffer *operator->() const { return m_buffer; }
+    inline bool isValid() const { return m_buffer != nullptr; }
+
+private:
+    VideoFrameBuffer *m_buffer;
+};
+
+/// A fixed size pool of equally sized video frame buffers.
+/// All buffers are allocated up front so that steady state capture does no allocation.
+/// Use allocate()/dispose() rather than new/delete: a disposed pool stays alive
+/// until the last of its outstanding buffers has been released.
+class VideoFramePool
+{
+public:
+    static VideoFramePool *allocate(size_t buffer_size, int buffer_count);
+    static void dispose(VideoFramePool *pool);
+
+    /// Take a free buffer from the pool.
+    /// Returns an invalid reference if every buffer is still referenced.
+    VideoFrameRef acquireBuffer();
+
+    inline size_t getBufferSize() const { return m_bufferSize; }
+
+private:
+    friend class VideoFrameBuffer;
+
+    VideoFramePool(size_t buffer_size, int buffer_count);
+    ~VideoFramePool();
+
+    void recycleBuffer(VideoFrameBuffer *buffer);
+
+    const size_t m_bufferSize;
+    std::vector<VideoFrameBuffer *> m_allBuffers;
+    std::vector<VideoFrameBuffer *> m_freeBuffers;
+    std::mutex m_freeBuffersMutex;
+    bool m_bDisposed;
+
+    VideoFramePool(const VideoFramePool &copy) = delete;
+    VideoFramePool &operator=(const VideoFramePool &copy) = delete;
+};
+
+#endif // VIDEO_FRAME_POOL_H
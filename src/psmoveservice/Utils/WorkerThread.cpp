@@ -19,7 +19,6 @@ void WorkerThread::startThread()
 		m_exitSignaled= false;
 
         SERVER_LOG_INFO("WorkerThread::start") << "Starting worker thread: " << m_threadName;
-		onThreadStarted();
 
         m_workerThread = std::thread(&WorkerThread::threadFunc, this);
         m_threadStarted = true;
@@ -43,7 +42,6 @@ void WorkerThread::stopThread()
             m_workerThread.join();
 
             SERVER_LOG_INFO("WorkerThread::stop") << "Worker thread stopped: " << m_threadName;
-			onThreadHaltComplete();
         }
         else
         {
@@ -60,6 +58,8 @@ void WorkerThread::threadFunc()
 {
     ServerUtility::set_current_thread_name(m_threadName.c_str());
 
+	onThreadStarted();
+
     // Stay in the poll loop until asked to exit by the main thread
 	// Or the worker thread can no longer do work
     while (!m_exitSignaled)
@@ -70,5 +70,7 @@ void WorkerThread::threadFunc()
 		}
     }
 
+	onThreadHaltComplete();
+
 	m_threadEnded.store(true);
 }
\ No newline at end of file
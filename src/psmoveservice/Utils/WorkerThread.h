@@ -24,8 +24,11 @@ public:
     void stopThread();
 
 protected:
+	// Called on the worker thread before the first doWork()
 	virtual void onThreadStarted() { }
+	// Called on the main thread once the exit flag is set, before joining the worker thread
 	virtual void onThreadHaltBegin() { }
+	// Called on the worker thread after the last doWork()
 	virtual void onThreadHaltComplete() { }
 	virtual bool doWork() = 0;
 
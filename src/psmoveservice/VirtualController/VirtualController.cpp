@@ -1,12 +1,11 @@
 //-- includes -----
 #include "VirtualController.h"
 #include "ControllerDeviceEnumerator.h"
+#include "GamepadPoller.h"
 #include "ServerLog.h"
 #include "ServerUtility.h"
 #include <vector>
 
-#include "gamepad/Gamepad.h"
-
 // -- public methods
 
 // -- Virtual Controller Config
@@ -320,25 +319,28 @@ VirtualController::pollGamepad(VirtualControllerState &newState)
 
     newState.clear_gamepad_data();
 
-    if (cfg.gamepad_index >= 0)
+    GamepadPoller *gamepad_poller = GamepadPoller::getInstance();
+
+    if (cfg.gamepad_index >= 0 && gamepad_poller != nullptr)
     {
-	    const Gamepad_device * gamepad = Gamepad_deviceAtIndex(static_cast<unsigned int>(cfg.gamepad_index));
+	    // Lock free copy of the state published by the gamepad poller thread
+	    GamepadSnapshot gamepad;
 
-	    if (gamepad != nullptr)
+	    if (gamepad_poller->fetchGamepadSnapshot(cfg.gamepad_index, gamepad))
 	    {
 		    unsigned int lastButtons = ControllerState.AllButtons;
 
-            newState.vendorID= gamepad->vendorID;
-            newState.productID= gamepad->productID;
+            newState.vendorID= gamepad.vendorID;
+            newState.productID= gamepad.productID;
 
             // Button states
-            newState.numButtons= std::min(gamepad->numButtons, (unsigned int)MAX_VIRTUAL_CONTROLLER_BUTTONS);
+            newState.numButtons= std::min(gamepad.numButtons, (unsigned int)MAX_VIRTUAL_CONTROLLER_BUTTONS);
             for (int buttonIndex = 0; buttonIndex < newState.numButtons; ++buttonIndex)
             {
                 unsigned int button_mask= 1 << buttonIndex;
 
                 // Set button bit
-                setButtonBit(newState.AllButtons, button_mask, gamepad->buttonStates[buttonIndex]);
+                setButtonBit(newState.AllButtons, button_mask, gamepad.buttonStates[buttonIndex]);
 
                 // Button de-bounce
                 newState.buttonStates[buttonIndex]= getButtonState(newState.AllButtons, lastButtons, button_mask);
@@ -346,10 +348,10 @@ VirtualController::pollGamepad(VirtualControllerState &newState)
 		    
 
 		    // Analog axis states
-            newState.numAxes= std::min(gamepad->numAxes, (unsigned int)MAX_VIRTUAL_CONTROLLER_AXES);
+            newState.numAxes= std::min(gamepad.numAxes, (unsigned int)MAX_VIRTUAL_CONTROLLER_AXES);
             for (int axisIndex = 0; axisIndex < newState.numAxes; ++axisIndex)
             {
-                newState.axisStates[axisIndex] = static_cast<unsigned char>((gamepad->axisStates[axisIndex] + 1.f) * 127.f);
+                newState.axisStates[axisIndex] = static_cast<unsigned char>((gamepad.axisStates[axisIndex] + 1.f) * 127.f);
             }
 	    }
     }
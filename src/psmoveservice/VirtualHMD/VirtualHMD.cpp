@@ -15,7 +15,6 @@
 #include <math.h>
 
 // -- constants -----
-#define VIRTUAL_HMD_STATE_BUFFER_MAX 4
 
 // -- private methods
 
@@ -84,6 +83,7 @@ VirtualHMD::VirtualHMD()
     , NextPollSequenceNumber(0)
     , bIsOpen(false)
     , HMDStates()
+    , CachedStates()
     , bIsTracking(false)
 {
     HMDStates.clear();
@@ -139,6 +139,7 @@ bool VirtualHMD::open(
 
         // Reset the polling sequence counter
         NextPollSequenceNumber = 0;
+        HMDStates.clear();
 
         success = true;
     }
@@ -217,13 +218,8 @@ VirtualHMD::poll()
         newState.PollSequenceNumber = NextPollSequenceNumber;
         ++NextPollSequenceNumber;
 
-        // Make room for new entry if at the max queue size
-        if (HMDStates.size() >= VIRTUAL_HMD_STATE_BUFFER_MAX)
-        {
-            HMDStates.erase(HMDStates.begin(), HMDStates.begin() + HMDStates.size() - VIRTUAL_HMD_STATE_BUFFER_MAX);
-        }
-
-        HMDStates.push_back(newState);
+        // Overwrites the oldest entry once the history is full
+        HMDStates.push(newState.PollSequenceNumber, newState);
     }
 
     return result;
@@ -269,11 +265,34 @@ const CommonDeviceState *
 VirtualHMD::getState(
     int lookBack) const
 {
-    const int queueSize = static_cast<int>(HMDStates.size());
-    const CommonDeviceState * result =
-        (lookBack < queueSize) ? &HMDStates.at(queueSize - lookBack - 1) : nullptr;
+    // The ring may be written while we copy out of it, so hand out a copy.
+    // Each lookBack has its own copy, only refreshed by the next getState() with the same lookBack.
+    VirtualHMDState state;
+    if (lookBack < 0 || lookBack >= VIRTUAL_HMD_STATE_BUFFER_MAX || !HMDStates.fetchState(lookBack, state))
+    {
+        return nullptr;
+    }
 
-    return result;
+    CachedStates[lookBack] = state;
+    return &CachedStates[lookBack];
+}
+
+bool
+VirtualHMD::fetchState(
+    int lookBack,
+    VirtualHMDState &out_state) const
+{
+    return HMDStates.fetchState(lookBack, out_state);
+}
+
+int
+VirtualHMD::visitStatesNewerThan(
+    int poll_sequence_number,
+    const std::function<void(const CommonDeviceState *)> &visitor) const
+{
+    return HMDStates.visitNewerThan(
+        poll_sequence_number,
+        [&visitor](const VirtualHMDState &state) { visitor(&state); });
 }
 
 long VirtualHMD::getMaxPollFailureCount() const
@@ -2,14 +2,16 @@
 #define VIRTUAL_HMD_H
 
 #include "PSMoveConfig.h"
+#include "AtomicPrimitives.h"
 #include "DeviceEnumerator.h"
 #include "DeviceInterface.h"
 #include "MathUtility.h"
 #include <string>
 #include <vector>
-#include <deque>
 #include <array>
 
+// Number of polled states kept until the HMD view gets to them
+#define VIRTUAL_HMD_STATE_BUFFER_MAX 4
 
 class VirtualHMDConfig : public PSMoveConfig
 {
@@ -100,6 +102,9 @@ public:
         return CommonDeviceState::VirtualHMD;
     }
     const CommonDeviceState * getState(int lookBack = 0) const override;
+    int visitStatesNewerThan(
+        int poll_sequence_number,
+        const std::function<void(const CommonDeviceState *)> &visitor) const override;
 
     // -- IHMDInterface
     std::string getUSBDevicePath() const override;
@@ -109,6 +114,9 @@ public:
 	float getPredictionTime() const override;
 
     // -- Getters
+    // Copy out the HMD state at the given sample index.
+    // Unlike getState() the copy belongs to the caller, so prefer this for anything held onto.
+    bool fetchState(int lookBack, VirtualHMDState &out_state) const;
     inline const VirtualHMDConfig *getConfig() const
     {
         return &cfg;
@@ -129,7 +137,8 @@ private:
 
     // Read HMD State
     int NextPollSequenceNumber;
-    std::deque<VirtualHMDState> HMDStates;
+    AtomicStateRing<VirtualHMDState, VIRTUAL_HMD_STATE_BUFFER_MAX> HMDStates;
+    mutable VirtualHMDState CachedStates[VIRTUAL_HMD_STATE_BUFFER_MAX]; // Last state handed out by getState(), per lookBack
 
 	bool bIsTracking;
 };
@@ -0,0 +1,171 @@
+//-- includes -----
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <atomic>
+#include <thread>
+
+#include "AtomicPrimitives.h"
+#include "unit_test.h"
+
+//-- constants -----
+static const int k_test_ring_capacity = 4;
+static const int k_test_state_value_count = 16;
+
+//-- definitions -----
+/// Every value is derived from the sequence number, so a torn copy is easy to spot
+struct TestRingState
+{
+	int sequence;
+	int values[k_test_state_value_count];
+
+	TestRingState()
+	{
+		set(-1);
+	}
+
+	void set(int new_sequence)
+	{
+		sequence = new_sequence;
+		for (int value_index = 0; value_index < k_test_state_value_count; ++value_index)
+		{
+			values[value_index] = new_sequence * k_test_state_value_count + value_index;
+		}
+	}
+
+	bool isConsistent() const
+	{
+		for (int value_index = 0; value_index < k_test_state_value_count; ++value_index)
+		{
+			if (values[value_index] != sequence * k_test_state_value_count + value_index)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+};
+
+typedef AtomicStateRing<TestRingState, k_test_ring_capacity> t_test_ring;
+
+//-- prototypes -----
+static void push_test_states(t_test_ring &ring, int first_sequence, int count);
+
+//-- public interface -----
+bool run_atomic_state_ring_unit_tests()
+{
+	UNIT_TEST_MODULE_BEGIN("atomic_state_ring")
+		UNIT_TEST_MODULE_CALL_TEST(atomic_state_ring_test_newer_than);
+		UNIT_TEST_MODULE_CALL_TEST(atomic_state_ring_test_concurrent_reader);
+	UNIT_TEST_MODULE_END()
+}
+
+//-- private functions -----
+bool
+atomic_state_ring_test_newer_than()
+{
+	UNIT_TEST_BEGIN("newer than")
+
+	t_test_ring ring;
+	TestRingState state;
+
+	// Empty ring
+	success = ring.getNewestSequence() == -1 && !ring.fetchState(0, state);
+	assert(success);
+	success = ring.visitNewerThan(-1, [](const TestRingState &) {}) == 0;
+	assert(success);
+
+	// Partially filled
+	push_test_states(ring, 0, 3);
+	int expected_sequence = 1;
+	success = ring.visitNewerThan(0, [&](const TestRingState &visited_state) {
+		success &= visited_state.sequence == expected_sequence && visited_state.isConsistent();
+		++expected_sequence;
+	}) == 2;
+	success &= expected_sequence == 3;
+	assert(success);
+
+	// After wrapping only the newest k_test_ring_capacity are left, oldest first
+	push_test_states(ring, 3, 7);
+	expected_sequence = 10 - k_test_ring_capacity;
+	success = ring.visitNewerThan(0, [&](const TestRingState &visited_state) {
+		success &= visited_state.sequence == expected_sequence && visited_state.isConsistent();
+		++expected_sequence;
+	}) == k_test_ring_capacity;
+	success &= expected_sequence == 10;
+	assert(success);
+
+	// Look back from the newest
+	success = ring.fetchState(0, state) && state.sequence == 9;
+	assert(success);
+	success = ring.fetchState(k_test_ring_capacity - 1, state) && state.sequence == 10 - k_test_ring_capacity;
+	assert(success);
+	success = !ring.fetchState(k_test_ring_capacity, state);
+	assert(success);
+
+	// Nothing newer than the newest
+	success = ring.visitNewerThan(9, [](const TestRingState &) {}) == 0;
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+bool
+atomic_state_ring_test_concurrent_reader()
+{
+	UNIT_TEST_BEGIN("concurrent reader")
+
+	static const int k_pushed_state_count = 200000;
+
+	t_test_ring ring;
+	std::atomic_bool bWriterDone(false);
+	std::atomic_int read_count(0);
+
+	// Hand off half way through, so the writer can't finish before the reader has got going
+	std::thread writer([&ring, &bWriterDone, &read_count]() {
+		push_test_states(ring, 0, k_pushed_state_count / 2);
+		while (read_count.load() == 0)
+		{
+			std::this_thread::yield();
+		}
+		push_test_states(ring, k_pushed_state_count / 2, k_pushed_state_count - k_pushed_state_count / 2);
+		bWriterDone = true;
+	});
+
+	// Read while the writer laps the ring, the states seen must be whole and in order
+	int last_sequence = -1;
+	bool bIsConsistent = true;
+	while (bIsConsistent && !bWriterDone)
+	{
+		ring.visitNewerThan(last_sequence, [&](const TestRingState &visited_state) {
+			bIsConsistent &= visited_state.isConsistent() && visited_state.sequence > last_sequence;
+			last_sequence = visited_state.sequence;
+			++read_count;
+		});
+	}
+	writer.join();
+
+	success = bIsConsistent && read_count > 0;
+	assert(success);
+
+	// Once the writer stops the newest state is always readable
+	ring.visitNewerThan(last_sequence, [&](const TestRingState &visited_state) {
+		last_sequence = visited_state.sequence;
+	});
+	success &= last_sequence == k_pushed_state_count - 1;
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+static void push_test_states(t_test_ring &ring, int first_sequence, int count)
+{
+	TestRingState state;
+
+	for (int sequence = first_sequence; sequence < first_sequence + count; ++sequence)
+	{
+		state.set(sequence);
+		ring.push(sequence, state);
+	}
+}
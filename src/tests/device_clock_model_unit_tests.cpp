@@ -0,0 +1,196 @@
+//-- includes -----
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+
+#include "DeviceClockModel.h"
+#include "unit_test.h"
+
+//-- constants -----
+// A DualShock4 style counter: 16 bits of 16/3 microsecond ticks, wrapping every ~350ms
+static const int k_test_counter_bits = 16;
+static const double k_test_nominal_tick_seconds = 16.0 / 3.0 * 1e-6;
+static const double k_test_report_interval_seconds = 0.004;
+static const double k_test_min_latency_seconds = 0.001;
+static const double k_test_max_jitter_seconds = 0.004;
+
+//-- definitions -----
+typedef DeviceClockModel::t_timepoint t_timepoint;
+
+/// Reports from a device whose clock runs at (1 + drift) of real time,
+/// arriving after a fixed latency plus scheduling jitter
+struct SimulatedDeviceClock
+{
+	double drift;
+	double true_seconds;
+	t_timepoint host_epoch;
+	unsigned int random_state;
+
+	SimulatedDeviceClock(double clock_drift)
+		: drift(clock_drift)
+		, true_seconds(0.0)
+		, host_epoch(std::chrono::high_resolution_clock::now())
+		, random_state(12345)
+	{
+	}
+
+	uint32_t getRawCounter() const
+	{
+		const double device_seconds = true_seconds * (1.0 + drift);
+
+		return static_cast<uint32_t>(static_cast<uint64_t>(device_seconds / k_test_nominal_tick_seconds));
+	}
+
+	t_timepoint getArrivalTime()
+	{
+		random_state = random_state * 1103515245 + 12345;
+		const double jitter = k_test_max_jitter_seconds * static_cast<double>((random_state >> 16) & 0x7fff) / 32767.0;
+
+		return toHostTime(true_seconds + k_test_min_latency_seconds + jitter);
+	}
+
+	t_timepoint toHostTime(double seconds) const
+	{
+		return host_epoch + std::chrono::duration_cast<t_timepoint::duration>(std::chrono::duration<double>(seconds));
+	}
+
+	double toSeconds(const t_timepoint &time) const
+	{
+		return std::chrono::duration<double>(time - host_epoch).count();
+	}
+};
+
+//-- public interface -----
+bool run_device_clock_model_unit_tests()
+{
+	UNIT_TEST_MODULE_BEGIN("device_clock_model")
+		UNIT_TEST_MODULE_CALL_TEST(device_clock_model_test_locks_to_device_clock);
+		UNIT_TEST_MODULE_CALL_TEST(device_clock_model_test_implausible_counter);
+		UNIT_TEST_MODULE_CALL_TEST(device_clock_model_test_resync_after_gap);
+	UNIT_TEST_MODULE_END()
+}
+
+//-- private functions -----
+bool
+device_clock_model_test_locks_to_device_clock()
+{
+	UNIT_TEST_BEGIN("locks to device clock")
+
+	DeviceClockModel clock_model;
+	clock_model.reset(k_test_counter_bits, k_test_nominal_tick_seconds);
+
+	// 200ppm is well past what a crystal drifts, the model still has to follow it
+	SimulatedDeviceClock device(200e-6);
+
+	double max_interval_error = 0.0;
+	double max_latency_error = 0.0;
+	double last_mapped_seconds = 0.0;
+
+	for (int report_index = 0; success && report_index < 15000; ++report_index)
+	{
+		device.true_seconds = report_index * k_test_report_interval_seconds;
+
+		const t_timepoint arrival_time = device.getArrivalTime();
+		const t_timepoint mapped_time = clock_model.update(device.getRawCounter(), arrival_time);
+		const double mapped_seconds = device.toSeconds(mapped_time);
+
+		// Never in the future, never backwards
+		success = mapped_time <= arrival_time && (report_index == 0 || mapped_seconds >= last_mapped_seconds);
+		assert(success);
+
+		// Once the first rate window is in, samples are spaced by the device and not by the arrivals
+		if (report_index > 1000)
+		{
+			success = clock_model.getIsLocked();
+			assert(success);
+
+			max_interval_error =
+				std::max(max_interval_error, fabs((mapped_seconds - last_mapped_seconds) - k_test_report_interval_seconds));
+			max_latency_error =
+				std::max(max_latency_error, fabs(mapped_seconds - device.true_seconds - k_test_min_latency_seconds));
+		}
+
+		last_mapped_seconds = mapped_seconds;
+	}
+
+	// The arrivals alone are spread over 4ms
+	success &= max_interval_error < 0.0005;
+	assert(success);
+	success &= max_latency_error < 0.002;
+	assert(success);
+	// The period is measured from arrivals, so it's only as good as the jitter over the rate window
+	success &= fabs(clock_model.getTickSeconds() / k_test_nominal_tick_seconds - 1.0 / (1.0 + 200e-6)) < 100e-6;
+	assert(success);
+	success &= clock_model.getResyncCount() == 0;
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+bool
+device_clock_model_test_implausible_counter()
+{
+	UNIT_TEST_BEGIN("implausible counter")
+
+	// Documented at twice the period the counter actually runs at
+	DeviceClockModel clock_model;
+	clock_model.reset(k_test_counter_bits, 2.0*k_test_nominal_tick_seconds);
+
+	SimulatedDeviceClock device(0.0);
+
+	for (int report_index = 0; success && report_index < 2000; ++report_index)
+	{
+		device.true_seconds = report_index * k_test_report_interval_seconds;
+
+		const t_timepoint arrival_time = device.getArrivalTime();
+		const t_timepoint mapped_time = clock_model.update(device.getRawCounter(), arrival_time);
+
+		// Falls back to the arrival times
+		success = !clock_model.getIsLocked() && mapped_time == arrival_time;
+		assert(success);
+	}
+
+	UNIT_TEST_COMPLETE()
+}
+
+bool
+device_clock_model_test_resync_after_gap()
+{
+	UNIT_TEST_BEGIN("resync after gap")
+
+	DeviceClockModel clock_model;
+	clock_model.reset(k_test_counter_bits, k_test_nominal_tick_seconds);
+
+	SimulatedDeviceClock device(0.0);
+
+	int report_index = 0;
+	for (; report_index < 1000; ++report_index)
+	{
+		device.true_seconds = report_index * k_test_report_interval_seconds;
+		clock_model.update(device.getRawCounter(), device.getArrivalTime());
+	}
+	success = clock_model.getIsLocked();
+	assert(success);
+
+	// Drop a second of reports, the 16-bit counter wraps unseen in the meantime
+	report_index += 250;
+
+	for (int resumed_count = 0; success && resumed_count < 10; ++resumed_count, ++report_index)
+	{
+		device.true_seconds = report_index * k_test_report_interval_seconds;
+
+		const t_timepoint arrival_time = device.getArrivalTime();
+		const double mapped_seconds = device.toSeconds(clock_model.update(device.getRawCounter(), arrival_time));
+
+		// Picks up at the arrival time rather than wherever the wrapped tick count lands
+		success = fabs(mapped_seconds - device.true_seconds) < 0.01;
+		assert(success);
+	}
+
+	success &= clock_model.getResyncCount() == 1 && clock_model.getIsLocked();
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
@@ -0,0 +1,195 @@
+//-- includes -----
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <vector>
+
+#include "MathBundleAdjustment.h"
+#include "MathUtility.h"
+#include "unit_test.h"
+
+//-- constants -----
+static const int k_camera_count = 4;
+static const int k_point_count = 300;
+static const float k_focal_length = 554.f;
+static const float k_principal_x = 320.f;
+static const float k_principal_y = 240.f;
+
+//-- private definitions -----
+struct SyntheticCalibration
+{
+    EigenBundleAdjustmentCamera true_cameras[k_camera_count];
+    EigenBundleAdjustmentCamera cameras[k_camera_count];
+    std::vector<Eigen::Vector3f> true_points;
+    std::vector<Eigen::Vector3f> points;
+    std::vector<EigenBundleAdjustmentObservation> observations;
+};
+
+//-- prototypes -----
+static void build_synthetic_calibration(SyntheticCalibration &calibration);
+
+//-- public interface -----
+bool run_math_bundle_adjustment_unit_tests()
+{
+	UNIT_TEST_MODULE_BEGIN("math_bundle_adjustment")
+		UNIT_TEST_MODULE_CALL_TEST(math_bundle_adjustment_test_recover_camera_poses);
+		UNIT_TEST_MODULE_CALL_TEST(math_bundle_adjustment_test_cancel);
+	UNIT_TEST_MODULE_END()
+}
+
+//-- private functions -----
+bool
+math_bundle_adjustment_test_recover_camera_poses()
+{
+	UNIT_TEST_BEGIN("recover_camera_poses")
+
+	SyntheticCalibration calibration;
+	build_synthetic_calibration(calibration);
+
+	success = eigen_bundle_adjustment_initialize(
+		calibration.cameras, k_camera_count,
+		calibration.observations.data(), static_cast<int>(calibration.observations.size()),
+		calibration.points.data(), k_point_count,
+		20);
+	assert(success);
+
+	EigenBundleAdjustmentSettings settings;
+	settings.distance_weight = 0.25f;
+
+	EigenBundleAdjustmentResult result;
+	success = eigen_bundle_adjustment_solve(
+		calibration.cameras, k_camera_count,
+		calibration.points.data(), k_point_count,
+		calibration.observations.data(), static_cast<int>(calibration.observations.size()),
+		settings, &result);
+	assert(success);
+
+	// The initial alignment only uses the noisy camera relative positions
+	success = result.final_rms_reprojection_error < result.initial_rms_reprojection_error;
+	assert(success);
+	success = result.final_rms_reprojection_error < 1.f;
+	assert(success);
+
+	for (int camera_index = 0; success && camera_index < k_camera_count; ++camera_index)
+	{
+		const EigenBundleAdjustmentCamera &camera = calibration.cameras[camera_index];
+		const EigenBundleAdjustmentCamera &true_camera = calibration.true_cameras[camera_index];
+
+		success = (camera.position - true_camera.position).norm() < 1.f;
+		assert(success);
+		success = camera.orientation.angularDistance(true_camera.orientation) < 0.5f*k_degrees_to_radians;
+		assert(success);
+	}
+
+	UNIT_TEST_COMPLETE()
+}
+
+bool
+math_bundle_adjustment_test_cancel()
+{
+	UNIT_TEST_BEGIN("cancel")
+
+	SyntheticCalibration calibration;
+	build_synthetic_calibration(calibration);
+
+	success = eigen_bundle_adjustment_initialize(
+		calibration.cameras, k_camera_count,
+		calibration.observations.data(), static_cast<int>(calibration.observations.size()),
+		calibration.points.data(), k_point_count,
+		20);
+	assert(success);
+
+	int callback_count = 0;
+	EigenBundleAdjustmentSettings settings;
+	settings.progress_callback = [&callback_count](int iteration, float rms_reprojection_error) {
+		++callback_count;
+		return iteration < 2;
+	};
+
+	EigenBundleAdjustmentResult result;
+	success = !eigen_bundle_adjustment_solve(
+		calibration.cameras, k_camera_count,
+		calibration.points.data(), k_point_count,
+		calibration.observations.data(), static_cast<int>(calibration.observations.size()),
+		settings, &result);
+	assert(success);
+	success = result.bCanceled && result.iterations == 2 && callback_count == 2;
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+static float next_noise(unsigned int &seed)
+{
+	// Deterministic noise in [-1, 1]
+	seed = seed * 1664525u + 1013904223u;
+	return static_cast<float>((seed >> 8) & 0xFFFF) / 32767.5f - 1.f;
+}
+
+static void build_synthetic_calibration(SyntheticCalibration &calibration)
+{
+	unsigned int seed = 12345;
+
+	// Cameras on a ring around the tracking volume, looking at its center
+	for (int camera_index = 0; camera_index < k_camera_count; ++camera_index)
+	{
+		const float angle = k_real_two_pi * static_cast<float>(camera_index) / static_cast<float>(k_camera_count) + 0.3f;
+		const Eigen::Vector3f position(200.f * cosf(angle), 120.f + 20.f*static_cast<float>(camera_index), 200.f * sinf(angle));
+		const Eigen::Vector3f forward = (Eigen::Vector3f(0.f, 100.f, 0.f) - position).normalized();
+		const Eigen::Vector3f right = Eigen::Vector3f(0.f, 1.f, 0.f).cross(forward).normalized();
+		const Eigen::Vector3f up = forward.cross(right);
+
+		Eigen::Matrix3f rotation;
+		rotation.col(0) = right;
+		rotation.col(1) = up;
+		rotation.col(2) = forward;
+
+		EigenBundleAdjustmentCamera &camera = calibration.true_cameras[camera_index];
+		camera.orientation = Eigen::Quaternionf(rotation).normalized();
+		camera.position = position;
+		camera.focal_length_x = k_focal_length;
+		camera.focal_length_y = k_focal_length;
+		camera.principal_x = k_principal_x;
+		camera.principal_y = k_principal_y;
+		camera.bFixed = (camera_index == 0);
+
+		// Only the reference camera's pose is known up front
+		calibration.cameras[camera_index] = camera;
+		if (!camera.bFixed)
+		{
+			calibration.cameras[camera_index].orientation = Eigen::Quaternionf::Identity();
+			calibration.cameras[camera_index].position = Eigen::Vector3f::Zero();
+		}
+	}
+
+	// A bulb waved through the volume, seen by every camera whose image it lands in
+	for (int point_index = 0; point_index < k_point_count; ++point_index)
+	{
+		const Eigen::Vector3f point(
+			60.f * next_noise(seed), 100.f + 50.f * next_noise(seed), 60.f * next_noise(seed));
+
+		calibration.true_points.push_back(point);
+		calibration.points.push_back(Eigen::Vector3f::Zero());
+
+		for (int camera_index = 0; camera_index < k_camera_count; ++camera_index)
+		{
+			const EigenBundleAdjustmentCamera &camera = calibration.true_cameras[camera_index];
+			const Eigen::Vector3f camera_point = camera.orientation.conjugate() * (point - camera.position);
+			const Eigen::Vector2f pixel(
+				k_focal_length * camera_point.x() / camera_point.z() + k_principal_x,
+				-k_focal_length * camera_point.y() / camera_point.z() + k_principal_y);
+
+			if (camera_point.z() > 0.f && pixel.x() >= 0.f && pixel.x() < 640.f && pixel.y() >= 0.f && pixel.y() < 480.f)
+			{
+				EigenBundleAdjustmentObservation observation;
+				observation.camera_index = camera_index;
+				observation.point_index = point_index;
+				observation.pixel = pixel + 0.3f * Eigen::Vector2f(next_noise(seed), next_noise(seed));
+				// Sphere fit distances are only good to a few percent
+				observation.camera_relative_position = camera_point * (1.f + 0.03f * next_noise(seed));
+
+				calibration.observations.push_back(observation);
+			}
+		}
+	}
+}
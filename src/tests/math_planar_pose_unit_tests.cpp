@@ -0,0 +1,157 @@
+//-- includes -----
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <algorithm>
+
+#include "MathPlanarPose.h"
+#include "MathUtility.h"
+#include "unit_test.h"
+
+//-- constants -----
+// The DualShock4 lightbar quad (cm)
+static const int k_model_point_count = 4;
+static const Eigen::Vector2f k_model_points[k_model_point_count] = {
+	Eigen::Vector2f(2.5f, 0.5f),
+	Eigen::Vector2f(-2.5f, 0.5f),
+	Eigen::Vector2f(-2.5f, -0.5f),
+	Eigen::Vector2f(2.5f, -0.5f)
+};
+
+//-- prototypes -----
+static void project_model_points(
+	const Eigen::Matrix3f &rotation, const Eigen::Vector3f &translation, Eigen::Vector2f *out_image_points);
+static float rotation_angle_between(const Eigen::Matrix3f &a, const Eigen::Matrix3f &b);
+
+//-- public interface -----
+bool run_math_planar_pose_unit_tests()
+{
+	UNIT_TEST_MODULE_BEGIN("math_planar_pose")
+		UNIT_TEST_MODULE_CALL_TEST(math_planar_pose_test_exact_projection);
+		UNIT_TEST_MODULE_CALL_TEST(math_planar_pose_test_noisy_projection);
+		UNIT_TEST_MODULE_CALL_TEST(math_planar_pose_test_degenerate_input);
+	UNIT_TEST_MODULE_END()
+}
+
+//-- private functions -----
+bool
+math_planar_pose_test_exact_projection()
+{
+	UNIT_TEST_BEGIN("exact_projection")
+
+	const float angles[3][3] = {
+		{ 0.f, 0.f, 0.f },
+		{ 20.f, -15.f, 40.f },
+		{ -35.f, 25.f, -120.f }
+	};
+
+	for (int test_index = 0; success && test_index < 3; ++test_index)
+	{
+		const Eigen::Matrix3f rotation =
+			(Eigen::AngleAxisf(angles[test_index][0]*k_degrees_to_radians, Eigen::Vector3f::UnitX())
+			* Eigen::AngleAxisf(angles[test_index][1]*k_degrees_to_radians, Eigen::Vector3f::UnitY())
+			* Eigen::AngleAxisf(angles[test_index][2]*k_degrees_to_radians, Eigen::Vector3f::UnitZ())).toRotationMatrix();
+		const Eigen::Vector3f translation(10.f*test_index - 5.f, 3.f, 60.f + 40.f*test_index);
+
+		Eigen::Vector2f image_points[k_model_point_count];
+		project_model_points(rotation, translation, image_points);
+
+		EigenPlanarPoseSolution solutions[2];
+		success = eigen_planar_pose_solve_ippe(k_model_points, image_points, k_model_point_count, solutions);
+		assert(success);
+
+		// Without noise the true pose reprojects exactly
+		success = solutions[0].reprojection_error < 1e-4f;
+		assert(success);
+		success = (solutions[0].translation - translation).norm() < 0.01f * translation.norm();
+		assert(success);
+		success = rotation_angle_between(solutions[0].rotation, rotation) < 0.5f*k_degrees_to_radians;
+		assert(success);
+	}
+
+	UNIT_TEST_COMPLETE()
+}
+
+bool
+math_planar_pose_test_noisy_projection()
+{
+	UNIT_TEST_BEGIN("noisy_projection")
+
+	const Eigen::Matrix3f rotation =
+		(Eigen::AngleAxisf(15.f*k_degrees_to_radians, Eigen::Vector3f::UnitX())
+		* Eigen::AngleAxisf(10.f*k_degrees_to_radians, Eigen::Vector3f::UnitY())).toRotationMatrix();
+	const Eigen::Vector3f translation(-8.f, 4.f, 50.f);
+
+	Eigen::Vector2f image_points[k_model_point_count];
+	project_model_points(rotation, translation, image_points);
+
+	// A tenth of a pixel of corner noise at a 550 pixel focal length.
+	// The tilt of a target this small is very sensitive to corner noise,
+	// which is why the tracker prefers the solution closest to its prediction.
+	const float noise = 0.1f / 550.f;
+	image_points[0] += Eigen::Vector2f(noise, -noise);
+	image_points[1] += Eigen::Vector2f(-noise, -noise);
+	image_points[2] += Eigen::Vector2f(noise, noise);
+	image_points[3] += Eigen::Vector2f(-noise, noise);
+
+	EigenPlanarPoseSolution solutions[2];
+	success = eigen_planar_pose_solve_ippe(k_model_points, image_points, k_model_point_count, solutions);
+	assert(success);
+
+	// Either of the two ambiguous poses is within a few degrees, the position is close for both
+	const float best_angle_error = std::min(
+		rotation_angle_between(solutions[0].rotation, rotation),
+		rotation_angle_between(solutions[1].rotation, rotation));
+	success = best_angle_error < 5.f*k_degrees_to_radians;
+	assert(success);
+	success = (solutions[0].translation - translation).norm() < 2.f;
+	assert(success);
+	success = solutions[0].reprojection_error <= solutions[1].reprojection_error;
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+bool
+math_planar_pose_test_degenerate_input()
+{
+	UNIT_TEST_BEGIN("degenerate_input")
+
+	Eigen::Vector2f image_points[k_model_point_count];
+	project_model_points(Eigen::Matrix3f::Identity(), Eigen::Vector3f(0.f, 0.f, 50.f), image_points);
+
+	EigenPlanarPoseSolution solutions[2];
+
+	// Too few points
+	success = !eigen_planar_pose_solve_ippe(k_model_points, image_points, 3, solutions);
+	assert(success);
+
+	// Every image point on top of each other
+	for (int point_index = 0; point_index < k_model_point_count; ++point_index)
+	{
+		image_points[point_index] = Eigen::Vector2f(0.1f, 0.1f);
+	}
+	success = !eigen_planar_pose_solve_ippe(k_model_points, image_points, k_model_point_count, solutions);
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+static void project_model_points(
+	const Eigen::Matrix3f &rotation, const Eigen::Vector3f &translation, Eigen::Vector2f *out_image_points)
+{
+	for (int point_index = 0; point_index < k_model_point_count; ++point_index)
+	{
+		const Eigen::Vector2f &model_point = k_model_points[point_index];
+		const Eigen::Vector3f camera_point =
+			rotation.col(0)*model_point.x() + rotation.col(1)*model_point.y() + translation;
+
+		out_image_points[point_index] =
+			Eigen::Vector2f(camera_point.x() / camera_point.z(), camera_point.y() / camera_point.z());
+	}
+}
+
+static float rotation_angle_between(const Eigen::Matrix3f &a, const Eigen::Matrix3f &b)
+{
+	return Eigen::AngleAxisf(a.transpose() * b).angle();
+}
@@ -0,0 +1,439 @@
+#include "LightBarContourFit.h"
+#include "MathPlanarPose.h"
+#include "MathUtility.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+//-- constants -----
+static const int k_image_width = 640;
+static const int k_image_height = 480;
+static const float k_focal_length_px = 554.2563f; // PS3Eye at the 75 degree FOV setting
+static const int k_frame_count = 600;
+static const int k_benchmark_passes = 5;
+static const int k_subpixel_bits = 4;
+
+// The DualShock4 lightbar tracking shape (cm), see PSDualShock4Controller::getTrackingShape()
+static const float k_quad_half_x = 5.2f / 2.f;
+static const float k_quad_half_y = 1.1f / 2.f;
+static const float k_tri_half_x = .9386f / 2.f;
+static const float k_tri_lower_half_y = .6548f - k_quad_half_y;
+
+// triangle - lower right, lower left, upper middle
+// quad - upper right, upper left, lower left, lower right
+static const cv::Point3f k_model_points[7] = {
+	cv::Point3f(k_tri_half_x, -k_tri_lower_half_y, 0.f),
+	cv::Point3f(-k_tri_half_x, -k_tri_lower_half_y, 0.f),
+	cv::Point3f(0.f, k_quad_half_y, 0.f),
+	cv::Point3f(k_quad_half_x, k_quad_half_y, 0.f),
+	cv::Point3f(-k_quad_half_x, k_quad_half_y, 0.f),
+	cv::Point3f(-k_quad_half_x, -k_quad_half_y, 0.f),
+	cv::Point3f(k_quad_half_x, -k_quad_half_y, 0.f),
+};
+static const int k_quad_model_offset = 3;
+
+// The bar's ends slant inward, so its lower edge is shorter than the bounding quad.
+// A plain rectangle has no up or down for the best fit triangle, which then flips the bar between frames.
+static const float k_bar_lower_edge_scale = 0.8f;
+
+struct SyntheticFrame
+{
+	std::vector<cv::Point2f> contour;
+	Eigen::Matrix3f rotation; // model -> camera
+	Eigen::Vector3f translation; // cm
+};
+
+struct LightBarPose
+{
+	Eigen::Matrix3f rotation;
+	Eigen::Vector3f translation;
+	cv::Point2f quad[4]; // upper right, upper left, lower left, lower right
+};
+
+struct BenchmarkResult
+{
+	double seconds;
+	double position_error_sum;
+	double angle_error_sum;
+	int solved_count;
+	int fallback_count;
+};
+
+//-- prototypes -----
+static cv::Matx33f make_camera_matrix();
+static void generate_frames(const cv::Matx33f &camera_matrix, std::vector<SyntheticFrame> &frames);
+static bool solve_full_path(
+	const cv::Matx33f &camera_matrix, const std::vector<cv::Point2f> &contour,
+	const LightBarPose *guess, LightBarPose &out_pose);
+static bool solve_fast_path(
+	const cv::Matx33f &camera_matrix, const std::vector<cv::Point2f> &contour,
+	const LightBarPose &guess, LightBarPose &out_pose);
+static bool fit_triangle(
+	const std::vector<cv::Point2f> &contour,
+	cv::Point2f &out_top, cv::Point2f &out_bottom_left, cv::Point2f &out_bottom_right);
+static void run_benchmark(
+	const cv::Matx33f &camera_matrix, const std::vector<SyntheticFrame> &frames, bool bUseFastPath,
+	BenchmarkResult &result);
+
+//-- entry point -----
+int main(int argc, char *argv[])
+{
+	const cv::Matx33f camera_matrix = make_camera_matrix();
+
+	std::vector<SyntheticFrame> frames;
+	generate_frames(camera_matrix, frames);
+
+	if (frames.size() < 2)
+	{
+		printf("Failed to generate synthetic lightbar frames!\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Lightbar pose benchmark: %d frames per pass, %d passes\n",
+		(int)frames.size(), k_benchmark_passes);
+
+	BenchmarkResult full_result, fast_result;
+	run_benchmark(camera_matrix, frames, false, full_result);
+	run_benchmark(camera_matrix, frames, true, fast_result);
+
+	const double frame_count = static_cast<double>(frames.size() * k_benchmark_passes);
+	const double full_us_per_frame = (full_result.seconds * 1e6) / frame_count;
+	const double fast_us_per_frame = (fast_result.seconds * 1e6) / frame_count;
+
+	printf("  Full fit (minEnclosingTriangle + quad + solvePnP ITERATIVE)\n");
+	printf("    %8.1f us/frame, %d/%d solved, mean error %.3f cm %.2f deg\n",
+		full_us_per_frame, full_result.solved_count, (int)frame_count,
+		full_result.position_error_sum / std::max(full_result.solved_count, 1),
+		full_result.angle_error_sum / std::max(full_result.solved_count, 1));
+	printf("  Warm started fit (quad from prior + IPPE)\n");
+	printf("    %8.1f us/frame (%.2fx), %d/%d solved, %d fell back, mean error %.3f cm %.2f deg\n",
+		fast_us_per_frame,
+		(fast_us_per_frame > 0.0) ? full_us_per_frame / fast_us_per_frame : 0.0,
+		fast_result.solved_count, (int)frame_count, fast_result.fallback_count,
+		fast_result.position_error_sum / std::max(fast_result.solved_count, 1),
+		fast_result.angle_error_sum / std::max(fast_result.solved_count, 1));
+
+	return (fast_result.solved_count > 0 && full_result.solved_count > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//-- private functions -----
+static cv::Matx33f
+make_camera_matrix()
+{
+	return cv::Matx33f(
+		k_focal_length_px, 0.f, k_image_width / 2.f,
+		0.f, k_focal_length_px, k_image_height / 2.f,
+		0.f, 0.f, 1.f);
+}
+
+// A controller held in front of the camera, drifting around while it rolls and tilts
+static void
+generate_frames(
+	const cv::Matx33f &camera_matrix,
+	std::vector<SyntheticFrame> &frames)
+{
+	const float subpixel_scale = static_cast<float>(1 << k_subpixel_bits);
+	cv::RNG rng(0x5053);
+
+	for (int frame_index = 0; frame_index < k_frame_count; ++frame_index)
+	{
+		const float time = static_cast<float>(frame_index) / 60.f;
+
+		// Lightbar facing the camera (model +y is image up) with a moderate tilt
+		const Eigen::Matrix3f rotation =
+			(Eigen::AngleAxisf(k_real_pi, Eigen::Vector3f::UnitX())
+			* Eigen::AngleAxisf(20.f*k_degrees_to_radians*sinf(0.7f*time), Eigen::Vector3f::UnitY())
+			* Eigen::AngleAxisf(15.f*k_degrees_to_radians*sinf(1.1f*time), Eigen::Vector3f::UnitX())
+			* Eigen::AngleAxisf(45.f*k_degrees_to_radians*sinf(0.5f*time), Eigen::Vector3f::UnitZ())).toRotationMatrix();
+		const Eigen::Vector3f translation(
+			15.f*sinf(0.3f*time), 8.f*cosf(0.4f*time), 70.f + 30.f*sinf(0.2f*time));
+
+		// Rasterize the bar with subpixel precision and soften it like a real exposure
+		std::vector<cv::Point> image_quad;
+		for (int corner_index = 0; corner_index < 4; ++corner_index)
+		{
+			const cv::Point3f &model_point = k_model_points[k_quad_model_offset + corner_index];
+			const float bar_x = (model_point.y < 0.f) ? model_point.x*k_bar_lower_edge_scale : model_point.x;
+			const Eigen::Vector3f camera_point =
+				rotation * Eigen::Vector3f(bar_x, model_point.y, model_point.z) + translation;
+			const float pixel_x = camera_matrix(0, 0) * camera_point.x() / camera_point.z() + camera_matrix(0, 2);
+			const float pixel_y = camera_matrix(1, 1) * camera_point.y() / camera_point.z() + camera_matrix(1, 2);
+
+			image_quad.push_back(cv::Point(
+				cvRound(pixel_x * subpixel_scale), cvRound(pixel_y * subpixel_scale)));
+		}
+
+		cv::Mat image(k_image_height, k_image_width, CV_8UC1, cv::Scalar(0));
+		cv::fillConvexPoly(image, image_quad, cv::Scalar(255), cv::LINE_AA, k_subpixel_bits);
+		cv::GaussianBlur(image, image, cv::Size(3, 3), 0.8);
+
+		cv::Mat noise(image.size(), CV_8UC1);
+		rng.fill(noise, cv::RNG::UNIFORM, 0, 24);
+		image += noise;
+
+		cv::threshold(image, image, 127, 255, cv::THRESH_BINARY);
+
+		std::vector<std::vector<cv::Point> > contours;
+		cv::findContours(image, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+		// Keep the biggest blob, same as the tracker
+		int best_contour_index = -1;
+		double best_contour_area = 0.0;
+		for (int contour_index = 0; contour_index < (int)contours.size(); ++contour_index)
+		{
+			const double area = cv::contourArea(contours[contour_index]);
+
+			if (area > best_contour_area)
+			{
+				best_contour_index = contour_index;
+				best_contour_area = area;
+			}
+		}
+
+		if (best_contour_index != -1 && contours[best_contour_index].size() >= 4)
+		{
+			SyntheticFrame frame;
+
+			std::vector<cv::Point> convex_contour;
+			cv::convexHull(contours[best_contour_index], convex_contour);
+			cv::Mat(convex_contour).convertTo(frame.contour, CV_32F);
+
+			frame.rotation = rotation;
+			frame.translation = translation;
+			frames.push_back(frame);
+		}
+	}
+}
+
+static void
+run_benchmark(
+	const cv::Matx33f &camera_matrix,
+	const std::vector<SyntheticFrame> &frames,
+	bool bUseFastPath,
+	BenchmarkResult &result)
+{
+	result.seconds = 0.0;
+	result.position_error_sum = 0.0;
+	result.angle_error_sum = 0.0;
+	result.solved_count = 0;
+	result.fallback_count = 0;
+
+	for (int pass = 0; pass < k_benchmark_passes; ++pass)
+	{
+		LightBarPose previous_pose;
+		bool bHasPreviousPose = false;
+
+		for (const SyntheticFrame &frame : frames)
+		{
+			LightBarPose pose;
+
+			const auto start_time = std::chrono::high_resolution_clock::now();
+
+			bool bSolved = false;
+			if (bUseFastPath && bHasPreviousPose)
+			{
+				bSolved = solve_fast_path(camera_matrix, frame.contour, previous_pose, pose);
+
+				if (!bSolved)
+				{
+					++result.fallback_count;
+				}
+			}
+
+			if (!bSolved)
+			{
+				bSolved = solve_full_path(
+					camera_matrix, frame.contour, bHasPreviousPose ? &previous_pose : nullptr, pose);
+			}
+
+			const auto end_time = std::chrono::high_resolution_clock::now();
+			result.seconds += std::chrono::duration<double>(end_time - start_time).count();
+
+			if (bSolved)
+			{
+				result.position_error_sum += (pose.translation - frame.translation).norm();
+				result.angle_error_sum +=
+					Eigen::AngleAxisf(pose.rotation.transpose() * frame.rotation).angle() * k_radians_to_degreees;
+				++result.solved_count;
+
+				previous_pose = pose;
+				bHasPreviousPose = true;
+			}
+			else
+			{
+				bHasPreviousPose = false;
+			}
+		}
+	}
+}
+
+// Mirrors computeTrackerRelativeLightBarProjection + computeTrackerRelativeLightBarPose without a prior
+static bool
+solve_full_path(
+	const cv::Matx33f &camera_matrix,
+	const std::vector<cv::Point2f> &contour,
+	const LightBarPose *guess,
+	LightBarPose &out_pose)
+{
+	cv::Point2f tri_top, tri_bottom_left, tri_bottom_right;
+	if (!fit_triangle(contour, tri_top, tri_bottom_left, tri_bottom_right))
+	{
+		return false;
+	}
+
+	if (!computeBestFitQuadForContour(
+			contour,
+			tri_top - 0.5f*(tri_bottom_left + tri_bottom_right), tri_bottom_right - tri_bottom_left,
+			out_pose.quad[0], out_pose.quad[1], out_pose.quad[2], out_pose.quad[3]))
+	{
+		return false;
+	}
+
+	tri_top = 0.5f*(out_pose.quad[0] + out_pose.quad[1]);
+
+	std::vector<cv::Point3f> object_points(k_model_points, k_model_points + 7);
+	std::vector<cv::Point2f> image_points;
+	image_points.push_back(tri_bottom_right);
+	image_points.push_back(tri_bottom_left);
+	image_points.push_back(tri_top);
+	image_points.insert(image_points.end(), out_pose.quad, out_pose.quad + 4);
+
+	cv::Mat rvec(3, 1, cv::DataType<double>::type);
+	cv::Mat tvec(3, 1, cv::DataType<double>::type);
+	if (guess != nullptr)
+	{
+		const Eigen::AngleAxisf angle_axis(guess->rotation);
+		const Eigen::Vector3f rodrigues = angle_axis.axis() * angle_axis.angle();
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			rvec.at<double>(axis) = rodrigues[axis];
+			tvec.at<double>(axis) = guess->translation[axis];
+		}
+	}
+
+	if (!cv::solvePnP(
+			object_points, image_points,
+			camera_matrix, cv::noArray(),
+			rvec, tvec,
+			guess != nullptr, cv::SOLVEPNP_ITERATIVE))
+	{
+		return false;
+	}
+
+	const Eigen::Vector3f rodrigues(
+		static_cast<float>(rvec.at<double>(0)),
+		static_cast<float>(rvec.at<double>(1)),
+		static_cast<float>(rvec.at<double>(2)));
+	const float angle = rodrigues.norm();
+
+	out_pose.rotation =
+		(angle > k_real_epsilon)
+		? Eigen::AngleAxisf(angle, rodrigues / angle).toRotationMatrix()
+		: Eigen::Matrix3f::Identity();
+	out_pose.translation = Eigen::Vector3f(
+		static_cast<float>(tvec.at<double>(0)),
+		static_cast<float>(tvec.at<double>(1)),
+		static_cast<float>(tvec.at<double>(2)));
+
+	return true;
+}
+
+// Same shared fits as computeBestFitLightBarForContourFromPrior + computeTrackerRelativeLightBarPoseFromGuess
+static bool
+solve_fast_path(
+	const cv::Matx33f &camera_matrix,
+	const std::vector<cv::Point2f> &contour,
+	const LightBarPose &guess,
+	LightBarPose &out_pose)
+{
+	if (!computeBestFitQuadForContourFromPrior(
+			contour,
+			guess.quad[0], guess.quad[1], guess.quad[2], guess.quad[3],
+			out_pose.quad[0], out_pose.quad[1], out_pose.quad[2], out_pose.quad[3]))
+	{
+		return false;
+	}
+
+	cv::Point2f model_quad[4];
+	for (int corner_index = 0; corner_index < 4; ++corner_index)
+	{
+		const cv::Point3f &model_point = k_model_points[k_quad_model_offset + corner_index];
+
+		model_quad[corner_index] = cv::Point2f(model_point.x, model_point.y);
+	}
+
+	EigenPlanarPoseSolution solution;
+	if (!computeLightBarPoseFromGuess(camera_matrix, model_quad, out_pose.quad, guess.rotation, solution))
+	{
+		return false;
+	}
+
+	out_pose.rotation = solution.rotation;
+	out_pose.translation = solution.translation;
+
+	return true;
+}
+
+// Same as computeBestFitTriangleForContour
+static bool
+fit_triangle(
+	const std::vector<cv::Point2f> &contour,
+	cv::Point2f &out_top,
+	cv::Point2f &out_bottom_left,
+	cv::Point2f &out_bottom_right)
+{
+	std::vector<cv::Point2f> min_triangle;
+	try
+	{
+		cv::minEnclosingTriangle(contour, min_triangle);
+	}
+	catch (cv::Exception &)
+	{
+		return false;
+	}
+
+	if (min_triangle.size() != 3)
+	{
+		return false;
+	}
+
+	cv::Point2f midpoints[3] = {
+		(min_triangle[0] + min_triangle[1]) / 2.f,
+		(min_triangle[1] + min_triangle[2]) / 2.f,
+		(min_triangle[2] + min_triangle[0]) / 2.f
+	};
+
+	const cv::Moments moments = cv::moments(contour);
+	const cv::Point2f mass_center =
+		(moments.m00 > k_real_epsilon)
+		? cv::Point2f(static_cast<float>(moments.m10 / moments.m00), static_cast<float>(moments.m01 / moments.m00))
+		: contour[0];
+
+	int top_index = 0;
+	for (int corner_index = 1; corner_index < 3; ++corner_index)
+	{
+		if (cv::norm(midpoints[corner_index] - mass_center) < cv::norm(midpoints[top_index] - mass_center))
+		{
+			top_index = corner_index;
+		}
+	}
+
+	out_top = midpoints[top_index];
+	out_bottom_left = midpoints[(top_index + 1) % 3];
+	out_bottom_right = midpoints[(top_index + 2) % 3];
+
+	if ((out_bottom_right - out_top).cross(out_bottom_left - out_top) < 0)
+	{
+		std::swap(out_bottom_left, out_bottom_right);
+	}
+
+	return true;
+}
@@ -0,0 +1,170 @@
+#include "PSMoveProtocol.pb.h"
+#include "RemoteTracker.h"
+#include "ServerLog.h"
+#include "TrackerOpticalPipeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+//-- constants -----
+static const int k_test_tracker_id = 0;
+static const int k_test_controller_id = 3;
+static const int k_test_queue_depth = 2;
+static const int k_test_frame_count = 100;
+
+// How long the process stage spends on a frame, so its result lands a few updates after the frame was queued
+static const std::chrono::milliseconds k_process_time(3);
+static const std::chrono::milliseconds k_update_interval(1);
+
+// How long to wait for the process stage to finish a frame
+static const std::chrono::milliseconds k_result_timeout(1000);
+
+//-- definitions -----
+/// The optical side of a tracked controller, with the same projection hand-over as ServerControllerView:
+/// the fuse stage hands projections over with setTrackerProjection(),
+/// the next updateOpticalPoseEstimation() applies them to the pose filter.
+struct TestTrackedDevice
+{
+	RemoteTrackerProjection tracker_projection;
+	unsigned int new_tracker_projection_bitmask;
+	int filter_update_count;
+	int last_filter_frame_sequence_num;
+
+	TestTrackedDevice()
+		: new_tracker_projection_bitmask(0)
+		, filter_update_count(0)
+		, last_filter_frame_sequence_num(-1)
+	{
+	}
+
+	void setTrackerProjection(int tracker_id, const RemoteTrackerProjection &projection)
+	{
+		tracker_projection = projection;
+		new_tracker_projection_bitmask |= (1 << tracker_id);
+	}
+
+	void updateOpticalPoseEstimation(int tracker_id)
+	{
+		if ((new_tracker_projection_bitmask & (1 << tracker_id)) != 0)
+		{
+			// The test process stage stashes the frame it searched in the screen area
+			++filter_update_count;
+			last_filter_frame_sequence_num = static_cast<int>(tracker_projection.projection.screen_area);
+		}
+
+		new_tracker_projection_bitmask = 0;
+	}
+};
+
+//-- prototypes -----
+static void process_test_frame(const TrackerPipelineJob &job, TrackerPipelineResult &out_result);
+static bool check(bool condition, const char *description);
+
+//-- entry point -----
+int main(int argc, char *argv[])
+{
+	log_init("info");
+
+	std::atomic_int processed_frame_count(0);
+	TrackerOpticalPipeline pipeline(
+		k_test_tracker_id,
+		k_test_queue_depth,
+		[&processed_frame_count](const TrackerPipelineJob &job, TrackerPipelineResult &out_result) {
+			process_test_frame(job, out_result);
+			++processed_frame_count;
+		});
+
+	TestTrackedDevice device;
+	int fused_result_count = 0;
+	int next_frame_sequence_num = 0;
+	bool bHasFrameInFlight = false;
+	bool bHasNewVideoFrame = true;
+	bool bTimedOut = false;
+	std::chrono::steady_clock::time_point submit_time;
+
+	// Same order as DeviceManager::update(): poll the tracker, find projections (fuse then process), update the devices
+	while (!bTimedOut && (next_frame_sequence_num < k_test_frame_count || bHasFrameInFlight))
+	{
+		// Fuse
+		TrackerPipelineResult result;
+		if (pipeline.fetchLatestResult(result))
+		{
+			for (const RemoteTrackerProjection &projection : result.projections)
+			{
+				device.setTrackerProjection(k_test_tracker_id, projection);
+			}
+
+			pipeline.notifyResultFused(result);
+			++fused_result_count;
+
+			// The camera only delivers its next frame on a later update,
+			// so every result is fused on an update without a new video frame
+			bHasFrameInFlight = false;
+			bHasNewVideoFrame = false;
+		}
+		else if (bHasNewVideoFrame && next_frame_sequence_num < k_test_frame_count)
+		{
+			// Process
+			TrackerPipelineJob job;
+			job.frame_sequence_num = next_frame_sequence_num++;
+			job.frame_width = 640;
+			job.frame_height = 480;
+			job.targets.resize(1);
+			job.targets[0].device_category = PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_CONTROLLER;
+			job.targets[0].device_id = k_test_controller_id;
+
+			pipeline.submitJob(job);
+			bHasFrameInFlight = true;
+			bHasNewVideoFrame = false;
+			submit_time = std::chrono::steady_clock::now();
+		}
+		else
+		{
+			bHasNewVideoFrame = !bHasFrameInFlight;
+		}
+
+		device.updateOpticalPoseEstimation(k_test_tracker_id);
+
+		bTimedOut = bHasFrameInFlight && std::chrono::steady_clock::now() - submit_time > k_result_timeout;
+		std::this_thread::sleep_for(k_update_interval);
+	}
+
+	bool success = true;
+	success &= check(!bTimedOut, "process stage finished every frame");
+	success &= check(processed_frame_count == k_test_frame_count && fused_result_count == k_test_frame_count, "every processed frame fused");
+	success &= check(device.filter_update_count == k_test_frame_count, "every fused projection reached the pose filter");
+	success &= check(device.last_filter_frame_sequence_num == k_test_frame_count - 1, "pose filter saw the last frame");
+
+	printf(success ? "Optical pipeline test passed\n" : "Optical pipeline test FAILED\n");
+	log_dispose();
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//-- private functions -----
+static void process_test_frame(const TrackerPipelineJob &job, TrackerPipelineResult &out_result)
+{
+	std::this_thread::sleep_for(k_process_time);
+
+	for (const RemoteTrackerTarget &target : job.targets)
+	{
+		RemoteTrackerProjection projection;
+		memset(&projection, 0, sizeof(RemoteTrackerProjection));
+		projection.device_category = target.device_category;
+		projection.device_id = target.device_id;
+		projection.projection.screen_area = static_cast<float>(job.frame_sequence_num);
+
+		out_result.projections.push_back(projection);
+	}
+}
+
+static bool check(bool condition, const char *description)
+{
+	printf("%s: %s\n", condition ? "PASS" : "FAIL", description);
+
+	return condition;
+}
@@ -0,0 +1,194 @@
+#include "CompoundPoseFilter.h"
+#include "MathEigen.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+//-- constants -----
+static const int k_imu_rate_hz = 1000;
+static const int k_optical_rate_hz = 60;
+static const int k_stream_duration_seconds = 10;
+static const size_t k_packets_per_batch = 16;
+static const int k_benchmark_passes = 5;
+static const float k_min_time_delta_seconds = 1 / 2500.f;
+
+struct FilterCombination
+{
+	const char *name;
+	OrientationFilterType orientation_filter;
+	PositionFilterType position_filter;
+};
+
+static const FilterCombination k_filter_combinations[] = {
+	{"ComplementaryMARG + LowPassExponential", OrientationFilterTypeComplementaryMARG, PositionFilterTypeLowPassExponential},
+	{"MadgwickMARG + LowPassExponential", OrientationFilterTypeMadgwickMARG, PositionFilterTypeLowPassExponential},
+	{"ComplementaryOpticalARG + ComplimentaryOpticalIMU", OrientationFilterTypeComplementaryOpticalARG, PositionFilterTypeComplimentaryOpticalIMU},
+	{"MadgwickARG + LowPassOptical", OrientationFilterTypeMadgwickARG, PositionFilterTypeLowPassOptical},
+};
+
+//-- prototypes -----
+static void init_filter_space_and_constants(PoseFilterSpace &pose_filter_space, PoseFilterConstants &constants);
+static void generate_sensor_stream(std::vector<PoseSensorPacket> &packets, std::vector<float> &time_deltas);
+static double run_filter(
+	IPoseFilter *filter, const PoseFilterSpace &filter_space,
+	const std::vector<PoseSensorPacket> &packets, const std::vector<float> &time_deltas);
+
+//-- entry point -----
+int main(int argc, char *argv[])
+{
+	PoseFilterSpace pose_filter_space;
+	PoseFilterConstants constants;
+	init_filter_space_and_constants(pose_filter_space, constants);
+
+	std::vector<PoseSensorPacket> packets;
+	std::vector<float> time_deltas;
+	generate_sensor_stream(packets, time_deltas);
+
+	bool success = true;
+
+	printf("Pose filter benchmark: %d packets per pass, %d passes, %d packets per batch\n",
+		(int)packets.size(), k_benchmark_passes, (int)k_packets_per_batch);
+
+	for (const FilterCombination &combination : k_filter_combinations)
+	{
+		double elapsed_seconds = 0.0;
+		bool bOutputValid = true;
+
+		for (int pass = 0; pass < k_benchmark_passes; ++pass)
+		{
+			CompoundPoseFilter *filter = new CompoundPoseFilter();
+			filter->init(
+				CommonDeviceState::PSMove,
+				combination.orientation_filter, combination.position_filter,
+				constants);
+
+			elapsed_seconds += run_filter(filter, pose_filter_space, packets, time_deltas);
+
+			// The filter has to end up tracking the stream, not just run fast
+			const Eigen::Quaternionf orientation = filter->getOrientation();
+			const Eigen::Vector3f position = filter->getPositionCm();
+
+			bOutputValid &= filter->getIsStateValid();
+			bOutputValid &= orientation.coeffs().allFinite() && position.allFinite();
+
+			delete filter;
+		}
+
+		const double packet_count = static_cast<double>(packets.size() * k_benchmark_passes);
+		const double ns_per_packet = (elapsed_seconds * 1e9) / packet_count;
+
+		printf("  %s\n", combination.name);
+		printf("    CompoundPoseFilter: %8.1f ns/packet\n", ns_per_packet);
+		printf("    Output - %s\n", bOutputValid ? "VALID" : "INVALID");
+
+		success &= bOutputValid;
+	}
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//-- private functions -----
+static void
+init_filter_space_and_constants(
+	PoseFilterSpace &pose_filter_space,
+	PoseFilterConstants &constants)
+{
+	pose_filter_space.setIdentityGravity(Eigen::Vector3f(0.f, 0.f, -1.f));
+	pose_filter_space.setIdentityMagnetometer(Eigen::Vector3f(0.234017432f, 0.873125494f, 0.42765367f));
+	pose_filter_space.setCalibrationTransform(*k_eigen_identity_pose_upright);
+	pose_filter_space.setSensorTransform(*k_eigen_sensor_transform_identity);
+
+	constants.clear();
+
+	constants.orientation_constants.mean_update_time_delta = 1.f / static_cast<float>(k_imu_rate_hz);
+	constants.orientation_constants.gravity_calibration_direction = pose_filter_space.getGravityCalibrationDirection();
+	constants.orientation_constants.magnetometer_calibration_direction = pose_filter_space.getMagnetometerCalibrationDirection();
+	constants.orientation_constants.gyro_variance = Eigen::Vector3f::Constant(1e-4f);
+	constants.orientation_constants.gyro_drift = Eigen::Vector3f::Zero();
+	constants.orientation_constants.magnetometer_variance = Eigen::Vector3f::Constant(1e-3f);
+	constants.orientation_constants.orientation_variance_curve.A = 0.44888f;
+	constants.orientation_constants.orientation_variance_curve.B = -0.00402f;
+	constants.orientation_constants.orientation_variance_curve.MaxValue = 1.0f;
+
+	constants.position_constants.gravity_calibration_direction = pose_filter_space.getGravityCalibrationDirection();
+	constants.position_constants.accelerometer_variance = Eigen::Vector3f::Constant(1e-4f);
+	constants.position_constants.accelerometer_noise_radius = 0.0139137721f;
+	constants.position_constants.max_velocity = 1.0f;
+	constants.position_constants.mean_update_time_delta = 1.f / static_cast<float>(k_optical_rate_hz);
+	constants.position_constants.position_variance_curve.A = 0.44888f;
+	constants.position_constants.position_variance_curve.B = -0.00402f;
+	constants.position_constants.position_variance_curve.MaxValue = 1.0f;
+}
+
+// A controller slowly spinning about the vertical axis while moving in a circle
+static void
+generate_sensor_stream(
+	std::vector<PoseSensorPacket> &packets,
+	std::vector<float> &time_deltas)
+{
+	const int imu_sample_count = k_imu_rate_hz * k_stream_duration_seconds;
+	const int imu_samples_per_optical_sample = k_imu_rate_hz / k_optical_rate_hz;
+	const float imu_time_delta = 1.f / static_cast<float>(k_imu_rate_hz);
+	const float angular_rate = 0.5f; // rad/s
+
+	for (int sample_index = 0; sample_index < imu_sample_count; ++sample_index)
+	{
+		const float time = static_cast<float>(sample_index) * imu_time_delta;
+		const float angle = angular_rate * time;
+		const Eigen::Quaternionf orientation(Eigen::AngleAxisf(angle, Eigen::Vector3f::UnitZ()));
+
+		PoseSensorPacket packet;
+		packet.clear();
+
+		packet.imu_gyroscope_rad_per_sec = Eigen::Vector3f(0.f, 0.f, angular_rate);
+		packet.imu_accelerometer_g_units = Eigen::Vector3f(0.f, 0.f, -1.f);
+		packet.imu_magnetometer_unit =
+			eigen_vector3f_clockwise_rotate(orientation, Eigen::Vector3f(0.234017432f, 0.873125494f, 0.42765367f));
+		packet.has_gyroscope_measurement = true;
+		packet.has_accelerometer_measurement = true;
+		packet.has_magnetometer_measurement = true;
+
+		packets.push_back(packet);
+		time_deltas.push_back(imu_time_delta);
+
+		if ((sample_index % imu_samples_per_optical_sample) == 0)
+		{
+			PoseSensorPacket optical_packet;
+			optical_packet.clear();
+
+			optical_packet.optical_position_cm = Eigen::Vector3f(10.f*cosf(angle), 10.f*sinf(angle), 50.f);
+			optical_packet.optical_orientation = orientation;
+			optical_packet.tracking_projection_area_px_sqr = 400.f;
+
+			packets.push_back(optical_packet);
+			time_deltas.push_back(k_min_time_delta_seconds);
+		}
+	}
+}
+
+static double
+run_filter(
+	IPoseFilter *filter,
+	const PoseFilterSpace &filter_space,
+	const std::vector<PoseSensorPacket> &packets,
+	const std::vector<float> &time_deltas)
+{
+	const std::chrono::time_point<std::chrono::high_resolution_clock> start_time = std::chrono::high_resolution_clock::now();
+
+	for (size_t packet_index = 0; packet_index < packets.size(); packet_index += k_packets_per_batch)
+	{
+		PoseSensorPacketSpan batch;
+		batch.packets = &packets[packet_index];
+		batch.time_deltas = &time_deltas[packet_index];
+		batch.count = std::min(k_packets_per_batch, packets.size() - packet_index);
+
+		filter->updateBatch(&filter_space, batch);
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+
+	return elapsed.count();
+}
@@ -0,0 +1,328 @@
+#include "PSMoveConfig.h"
+#include "PSMoveProtocol.pb.h"
+#include "RemoteTracker.h"
+#include "ServerLog.h"
+#include "ServerNetworkManager.h"
+#include "TrackerNodeManager.h"
+
+#include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+//-- pre-declarations -----
+namespace asio = boost::asio;
+using asio::ip::tcp;
+using asio::ip::udp;
+
+//-- constants -----
+// Away from the default ports so the test can run next to a real service
+static const int k_test_central_server_port = 19512;
+static const int k_test_central_node_port = 19513;
+static const int k_test_node_server_port = 19514;
+
+static const char *k_test_node_name = "test_node";
+static const int k_test_camera_index = 0;
+
+// How long to wait for a packet to make it across localhost
+static const int k_packet_timeout_ms = 1000;
+
+//-- definitions -----
+/// The network side of a tracker node: its client port and the socket it talks to the central service on
+struct TestTrackerNode
+{
+	tcp::acceptor client_acceptor;
+	udp::socket client_socket;
+	udp::socket central_socket;
+	udp::endpoint central_endpoint;
+	char receive_buffer[2048];
+
+	TestTrackerNode(asio::io_service &io_service)
+		: client_acceptor(io_service)
+		, client_socket(io_service)
+		, central_socket(io_service)
+		, central_endpoint(asio::ip::address_v4::loopback(), k_test_central_node_port)
+	{
+	}
+};
+
+//-- prototypes -----
+static void write_test_configs(const boost::filesystem::path &central_directory, const boost::filesystem::path &node_directory);
+static bool open_test_node(const boost::filesystem::path &node_directory, TestTrackerNode &node);
+static void send_packet(TestTrackerNode &node, const PSMoveProtocol::TrackerNodePacket &packet);
+static void send_announce(TestTrackerNode &node);
+static void send_projections(TestTrackerNode &node, int frame_sequence_num);
+static bool receive_targets(TestTrackerNode &node, PSMoveProtocol::TrackerNodePacket &out_packet);
+static const RemoteTrackerCamera *pump_central(TrackerNodeManager &central, int frame_sequence_num);
+static bool check(bool condition, const char *description);
+
+//-- entry point -----
+int main(int argc, char *argv[])
+{
+	log_init("info");
+
+	// The default ports of the central service and of a tracker node on the same host must not overlap
+	bool success = true;
+	{
+		NetworkManagerConfig network_cfg;
+		TrackerNodeConfig node_cfg;
+
+		success &= check(
+			network_cfg.server_port != node_cfg.central_port &&
+			network_cfg.server_port != node_cfg.node_server_port &&
+			node_cfg.central_port != node_cfg.node_server_port,
+			"default central and node ports are distinct");
+	}
+
+	// One config directory for the central service and one for the node
+	const boost::filesystem::path test_directory =
+		boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("psmove_test_tracker_node_%%%%%%");
+	const boost::filesystem::path central_directory = test_directory / "central";
+	const boost::filesystem::path node_directory = test_directory / "node";
+	write_test_configs(central_directory, node_directory);
+
+	asio::io_service io_service;
+
+	// Central service: listens for tracker nodes
+	PSMoveConfig::setConfigDirectory(central_directory.string());
+	TrackerNodeManager central;
+	success &= check(central.startup(&io_service, "") && !central.getIsNodeMode(), "central service listening for nodes");
+
+	// The central service's client ports stay taken for the whole test
+	tcp::acceptor central_client_acceptor(io_service, tcp::endpoint(tcp::v4(), k_test_central_server_port));
+	udp::socket central_client_socket(io_service, udp::endpoint(udp::v4(), k_test_central_server_port));
+
+	// Tracker node: binds its own client port next to the central service's
+	TestTrackerNode node(io_service);
+	success &= check(open_test_node(node_directory, node), "node client port bound next to the central service");
+
+	const std::string device_path = std::string("remote:") + k_test_node_name + ":" + std::to_string(k_test_camera_index);
+	const RemoteTrackerCamera *camera = nullptr;
+
+	if (success)
+	{
+		send_announce(node);
+		camera = pump_central(central, -2);
+		success &= check(camera != nullptr && camera->bIsConnected, "central service sees the node's camera");
+	}
+
+	if (success)
+	{
+		for (int frame_sequence_num = 0; frame_sequence_num < 100; ++frame_sequence_num)
+		{
+			send_projections(node, frame_sequence_num);
+		}
+
+		camera = pump_central(central, 99);
+		success &= check(
+			camera != nullptr && camera->latest_frame.frame_sequence_num == 99 && camera->latest_frame.projections.size() == 1,
+			"central service receives the node's projections");
+	}
+
+	if (success)
+	{
+		RemoteTrackerTarget target;
+		memset(&target, 0, sizeof(RemoteTrackerTarget));
+		target.device_category = PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_CONTROLLER;
+		target.device_id = 3;
+		target.tracking_shape.shape_type = eCommonTrackingShapeType::Sphere;
+		target.tracking_shape.shape.sphere.radius_cm = 2.25f;
+
+		central.sendRemoteCameraTargets(device_path, std::vector<RemoteTrackerTarget>(1, target));
+
+		PSMoveProtocol::TrackerNodePacket packet;
+		success &= check(
+			receive_targets(node, packet) &&
+			packet.node_name() == k_test_node_name && packet.targets_size() == 1 && packet.targets(0).device_id() == 3,
+			"node receives the central service's targets");
+	}
+
+	if (success)
+	{
+		// Reordered frames are dropped
+		send_projections(node, 97);
+		send_projections(node, 100);
+		camera = pump_central(central, 100);
+		success &= check(camera != nullptr && camera->latest_frame.frame_sequence_num == 100, "out of order frames dropped");
+	}
+
+	if (success)
+	{
+		// A node restarted before it timed out counts from zero again
+		send_announce(node);
+		send_projections(node, 0);
+		camera = pump_central(central, 0);
+		success &= check(camera != nullptr && camera->latest_frame.frame_sequence_num == 0, "frames accepted after a node restart");
+	}
+
+	central.shutdown();
+
+	boost::system::error_code ec;
+	boost::filesystem::remove_all(test_directory, ec);
+
+	printf(success ? "Tracker node test passed\n" : "Tracker node test FAILED\n");
+	log_dispose();
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//-- private functions -----
+static void write_test_configs(
+	const boost::filesystem::path &central_directory,
+	const boost::filesystem::path &node_directory)
+{
+	PSMoveConfig::setConfigDirectory(central_directory.string());
+	{
+		TrackerNodeConfig central_cfg;
+		central_cfg.remote_trackers_enabled = true;
+		central_cfg.central_port = k_test_central_node_port;
+		central_cfg.save();
+	}
+
+	PSMoveConfig::setConfigDirectory(node_directory.string());
+	{
+		TrackerNodeConfig node_cfg;
+		node_cfg.central_port = k_test_central_node_port;
+		node_cfg.node_name = k_test_node_name;
+		node_cfg.node_server_port = k_test_node_server_port;
+		node_cfg.save();
+	}
+}
+
+static bool open_test_node(const boost::filesystem::path &node_directory, TestTrackerNode &node)
+{
+	// Read back the node's own config, not the central service's
+	PSMoveConfig::setConfigDirectory(node_directory.string());
+	TrackerNodeConfig node_cfg;
+	node_cfg.load();
+
+	if (node_cfg.node_name != k_test_node_name || node_cfg.node_server_port != k_test_node_server_port)
+	{
+		return false;
+	}
+
+	// Same sockets the node's ServerNetworkManager opens on its client port
+	boost::system::error_code ec;
+	const unsigned short port = static_cast<unsigned short>(node_cfg.node_server_port);
+
+	node.client_acceptor.open(tcp::v4(), ec);
+	if (!ec) node.client_acceptor.bind(tcp::endpoint(tcp::v4(), port), ec);
+	if (!ec) node.client_acceptor.listen(asio::socket_base::max_connections, ec);
+	if (!ec) node.client_socket.open(udp::v4(), ec);
+	if (!ec) node.client_socket.bind(udp::endpoint(udp::v4(), port), ec);
+	if (!ec) node.central_socket.open(udp::v4(), ec);
+
+	if (ec)
+	{
+		printf("  %s\n", ec.message().c_str());
+	}
+
+	return !ec;
+}
+
+static void send_packet(TestTrackerNode &node, const PSMoveProtocol::TrackerNodePacket &packet)
+{
+	const std::string bytes = packet.SerializeAsString();
+
+	node.central_socket.send_to(asio::buffer(bytes.data(), bytes.size()), node.central_endpoint);
+}
+
+static void send_announce(TestTrackerNode &node)
+{
+	PSMoveProtocol::TrackerNodePacket packet;
+	packet.set_type(PSMoveProtocol::TrackerNodePacket_PacketType_NODE_ANNOUNCE);
+	packet.set_node_name(k_test_node_name);
+
+	PSMoveProtocol::TrackerNodePacket_Camera *camera = packet.add_cameras();
+	camera->set_camera_index(k_test_camera_index);
+	camera->set_device_path("test_camera");
+	camera->set_frame_width(640);
+	camera->set_frame_height(480);
+	camera->set_frame_rate(60.f);
+
+	send_packet(node, packet);
+}
+
+static void send_projections(TestTrackerNode &node, int frame_sequence_num)
+{
+	PSMoveProtocol::TrackerNodePacket packet;
+	packet.set_type(PSMoveProtocol::TrackerNodePacket_PacketType_NODE_PROJECTIONS);
+	packet.set_node_name(k_test_node_name);
+	packet.set_camera_index(k_test_camera_index);
+	packet.set_frame_sequence_num(frame_sequence_num);
+
+	PSMoveProtocol::TrackerNodePacket_Projection *projection = packet.add_projections();
+	projection->set_device_category(PSMoveProtocol::DeviceOutputDataFrame_DeviceCategory_CONTROLLER);
+	projection->set_device_id(3);
+	projection->set_shape_type(static_cast<int>(eCommonTrackingProjectionType::ProjectionType_Ellipse));
+	projection->mutable_ellipse()->mutable_center()->set_x(320.f);
+	projection->mutable_ellipse()->mutable_center()->set_y(240.f);
+	projection->mutable_ellipse()->set_half_x_extent(10.f);
+	projection->mutable_ellipse()->set_half_y_extent(10.f);
+	projection->set_screen_area(314.f);
+
+	send_packet(node, packet);
+}
+
+static bool receive_targets(TestTrackerNode &node, PSMoveProtocol::TrackerNodePacket &out_packet)
+{
+	boost::system::error_code ec;
+	node.central_socket.non_blocking(true, ec);
+
+	const std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(k_packet_timeout_ms);
+
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		udp::endpoint sender_endpoint;
+		const size_t bytes_received =
+			node.central_socket.receive_from(asio::buffer(node.receive_buffer, sizeof(node.receive_buffer)), sender_endpoint, 0, ec);
+
+		if (!ec &&
+			out_packet.ParseFromArray(node.receive_buffer, static_cast<int>(bytes_received)) &&
+			out_packet.type() == PSMoveProtocol::TrackerNodePacket_PacketType_CENTRAL_TARGETS)
+		{
+			return true;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	return false;
+}
+
+// Update the central service until the node's camera shows the given frame (-2 for any frame)
+static const RemoteTrackerCamera *pump_central(TrackerNodeManager &central, int frame_sequence_num)
+{
+	const std::string device_path = std::string("remote:") + k_test_node_name + ":" + std::to_string(k_test_camera_index);
+	const std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(k_packet_timeout_ms);
+	const RemoteTrackerCamera *camera = nullptr;
+
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		central.update();
+		camera = central.findRemoteCamera(device_path);
+
+		if (camera != nullptr &&
+			(frame_sequence_num == -2 || camera->latest_frame.frame_sequence_num == frame_sequence_num))
+		{
+			break;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	return camera;
+}
+
+static bool check(bool condition, const char *description)
+{
+	printf("%s: %s\n", condition ? "PASS" : "FAIL", description);
+
+	return condition;
+}
@@ -0,0 +1,341 @@
+#include "ServerLog.h"
+#include "ServerUtility.h"
+#include "SimulatedUSBApi.h"
+#include "USBDeviceManager.h"
+#include "USBDeviceRequest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+//-- constants -----
+static const int k_latency_request_count = 100;
+static const int k_bulk_stream_duration_seconds = 5;
+static const int k_bulk_stream_request_interval_ms = 20;
+static const int k_bulk_transfer_packet_size = 65536;
+static const int k_bulk_in_flight_transfer_count = 5;
+
+// A PS3Eye streaming 640x480 Bayer frames at 60fps and a PSMove controller
+static const int k_simulated_ps3eye_index = 0;
+static const int k_simulated_psmove_index = 1;
+
+//-- definitions -----
+typedef std::chrono::high_resolution_clock t_benchmark_clock;
+
+struct LatencySamples
+{
+	std::vector<double> submit_us; // time spent in usb_device_submit_transfer_request_async
+	std::vector<double> result_us; // submit -> result callback on the main thread
+	int failed_count;
+
+	LatencySamples() : failed_count(0) {}
+};
+
+struct BulkStreamStats
+{
+	std::atomic<long long> byte_count;
+	std::atomic_int packet_count;
+	std::atomic_int sequence_gap_count;
+	unsigned int next_sequence; // only touched on the USB thread
+
+	BulkStreamStats() : byte_count(0), packet_count(0), sequence_gap_count(0), next_sequence(0) {}
+};
+
+//-- prototypes -----
+static std::vector<SimulatedUSBDeviceDesc> make_device_table();
+static bool open_devices(std::vector<t_usb_device_handle> &out_handles);
+static USBTransferRequest make_interrupt_read_request(t_usb_device_handle handle);
+static USBTransferRequest make_control_read_request(t_usb_device_handle handle);
+static void submit_and_wait(USBDeviceManager &usb_manager, const USBTransferRequest &request, LatencySamples &samples);
+static void on_bulk_transfer_data(unsigned char *packet_data, int packet_length, void *userdata);
+static void print_latency(const char *label, std::vector<double> &samples_us);
+
+//-- entry point -----
+int main(int argc, char *argv[])
+{
+	log_init("info");
+
+	const std::vector<SimulatedUSBDeviceDesc> device_table = make_device_table();
+	USBDeviceManager usb_manager(new SimulatedUSBApi(device_table));
+	bool success = true;
+
+	if (!usb_manager.startup())
+	{
+		printf("Failed to start the USB device manager\n");
+		return EXIT_FAILURE;
+	}
+
+	std::vector<t_usb_device_handle> handles;
+	if (!open_devices(handles) || handles.size() != device_table.size())
+	{
+		printf("Failed to open the simulated devices\n");
+		usb_manager.shutdown();
+		return EXIT_FAILURE;
+	}
+
+	const t_usb_device_handle ps3eye_handle = handles[k_simulated_ps3eye_index];
+	const t_usb_device_handle psmove_handle = handles[k_simulated_psmove_index];
+
+	// Requests handled on the main thread (no bulk transfers, so no worker thread)
+	{
+		LatencySamples interrupt_samples;
+		LatencySamples control_samples;
+
+		for (int request_index = 0; request_index < k_latency_request_count; ++request_index)
+		{
+			submit_and_wait(usb_manager, make_interrupt_read_request(psmove_handle), interrupt_samples);
+			submit_and_wait(usb_manager, make_control_read_request(ps3eye_handle), control_samples);
+		}
+
+		printf("Idle bus, %d requests each (requests processed by USBDeviceManager::update)\n", k_latency_request_count);
+		print_latency("interrupt submit", interrupt_samples.submit_us);
+		print_latency("interrupt result", interrupt_samples.result_us);
+		print_latency("control submit", control_samples.submit_us);
+		print_latency("control result", control_samples.result_us);
+
+		success &= interrupt_samples.failed_count == 0 && control_samples.failed_count == 0;
+	}
+
+	// Requests handled by the worker thread while it streams bulk data
+	{
+		BulkStreamStats bulk_stats;
+		LatencySamples interrupt_samples;
+		LatencySamples bulk_control_samples;
+
+		USBTransferRequest start_request;
+		start_request.request_type = _USBRequestType_StartBulkTransfer;
+		start_request.payload.start_bulk_transfer.usb_device_handle = ps3eye_handle;
+		start_request.payload.start_bulk_transfer.transfer_packet_size = k_bulk_transfer_packet_size;
+		start_request.payload.start_bulk_transfer.in_flight_transfer_packet_count = k_bulk_in_flight_transfer_count;
+		start_request.payload.start_bulk_transfer.on_data_callback = on_bulk_transfer_data;
+		start_request.payload.start_bulk_transfer.transfer_callback_userdata = &bulk_stats;
+		start_request.payload.start_bulk_transfer.bAutoResubmit = true;
+		submit_and_wait(usb_manager, start_request, bulk_control_samples);
+
+		const t_benchmark_clock::time_point stream_start = t_benchmark_clock::now();
+		const t_benchmark_clock::time_point stream_end = stream_start + std::chrono::seconds(k_bulk_stream_duration_seconds);
+
+		while (t_benchmark_clock::now() < stream_end)
+		{
+			submit_and_wait(usb_manager, make_interrupt_read_request(psmove_handle), interrupt_samples);
+
+			ServerUtility::sleep_ms(k_bulk_stream_request_interval_ms);
+			usb_manager.update();
+		}
+
+		USBTransferRequest cancel_request;
+		cancel_request.request_type = _USBRequestType_CancelBulkTransfer;
+		cancel_request.payload.cancel_bulk_transfer.usb_device_handle = ps3eye_handle;
+		submit_and_wait(usb_manager, cancel_request, bulk_control_samples);
+
+		const std::chrono::duration<double> stream_seconds = t_benchmark_clock::now() - stream_start;
+		const double megabytes_per_second = static_cast<double>(bulk_stats.byte_count.load()) / (1024.0*1024.0) / stream_seconds.count();
+		const double packets_per_second = static_cast<double>(bulk_stats.packet_count.load()) / stream_seconds.count();
+		const int expected_packets_per_second = device_table[k_simulated_ps3eye_index].bulk_transfer_rate;
+
+		printf("Streaming %dKB bulk transfers for %.1fs (requests processed by the worker thread)\n",
+			k_bulk_transfer_packet_size / 1024, stream_seconds.count());
+		printf("  bulk throughput: %8.2f MB/s, %8.1f transfers/s (device rate %d/s), %d sequence gaps\n",
+			megabytes_per_second, packets_per_second, expected_packets_per_second, bulk_stats.sequence_gap_count.load());
+		print_latency("interrupt submit", interrupt_samples.submit_us);
+		print_latency("interrupt result", interrupt_samples.result_us);
+		print_latency("bulk start/cancel", bulk_control_samples.result_us);
+
+		success &= interrupt_samples.failed_count == 0;
+		success &= bulk_stats.packet_count.load() > 0 && bulk_stats.sequence_gap_count.load() == 0;
+	}
+
+	// Stops the worker thread before closing the devices
+	usb_manager.shutdown();
+
+	printf("USB transfer benchmark - %s\n", success ? "PASSED" : "FAILED");
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//-- private functions -----
+static std::vector<SimulatedUSBDeviceDesc>
+make_device_table()
+{
+	std::vector<SimulatedUSBDeviceDesc> device_table;
+
+	SimulatedUSBDeviceDesc ps3eye;
+	ps3eye.filter.vendor_id = 0x1415;
+	ps3eye.filter.product_id = 0x2000;
+	ps3eye.path = "benchmark_ps3eye";
+	ps3eye.control_latency_us = 250;
+	ps3eye.bulk_latency_us = 1000;
+	ps3eye.bulk_transfer_rate = (640 * 480 * 60) / k_bulk_transfer_packet_size;
+	device_table.push_back(ps3eye);
+
+	SimulatedUSBDeviceDesc psmove;
+	psmove.filter.vendor_id = 0x054c;
+	psmove.filter.product_id = 0x03d5;
+	psmove.path = "benchmark_psmove";
+	psmove.interrupt_latency_us = 1000;
+	device_table.push_back(psmove);
+
+	return device_table;
+}
+
+static bool
+open_devices(std::vector<t_usb_device_handle> &out_handles)
+{
+	USBDeviceEnumerator *enumerator = usb_device_enumerator_allocate();
+	bool bSuccess = true;
+
+	while (usb_device_enumerator_is_valid(enumerator))
+	{
+		const t_usb_device_handle handle = usb_device_open(enumerator);
+
+		if (handle != k_invalid_usb_device_handle)
+		{
+			out_handles.push_back(handle);
+		}
+		else
+		{
+			bSuccess = false;
+		}
+
+		usb_device_enumerator_next(enumerator);
+	}
+	usb_device_enumerator_free(enumerator);
+
+	return bSuccess;
+}
+
+static USBTransferRequest
+make_interrupt_read_request(t_usb_device_handle handle)
+{
+	USBTransferRequest request;
+	memset(&request, 0, sizeof(USBTransferRequest));
+
+	request.request_type = _USBRequestType_InterruptTransfer;
+	request.payload.interrupt_transfer.usb_device_handle = handle;
+	request.payload.interrupt_transfer.endpoint = 0x81; // IN
+	request.payload.interrupt_transfer.length = 49; // PSMove input report
+	request.payload.interrupt_transfer.timeout = 100;
+
+	return request;
+}
+
+static USBTransferRequest
+make_control_read_request(t_usb_device_handle handle)
+{
+	USBTransferRequest request;
+	memset(&request, 0, sizeof(USBTransferRequest));
+
+	request.request_type = _USBRequestType_ControlTransfer;
+	request.payload.control_transfer.usb_device_handle = handle;
+	request.payload.control_transfer.bmRequestType = 0xC0; // vendor, device to host
+	request.payload.control_transfer.bRequest = 0x01;
+	request.payload.control_transfer.wLength = 1;
+	request.payload.control_transfer.timeout = 100;
+
+	return request;
+}
+
+static void
+submit_and_wait(USBDeviceManager &usb_manager, const USBTransferRequest &request, LatencySamples &samples)
+{
+	const t_benchmark_clock::time_point submit_time = t_benchmark_clock::now();
+	t_benchmark_clock::time_point result_time;
+	eUSBResultCode result_code = _USBResultCode_GeneralError;
+	bool bIsPending = true;
+
+	const bool bSubmitted = usb_device_submit_transfer_request_async(
+		request,
+		[&result_time, &result_code, &bIsPending](USBTransferResult &result)
+		{
+			result_time = t_benchmark_clock::now();
+
+			switch (result.result_type)
+			{
+			case _USBResultType_InterrupTransfer:
+				result_code = result.payload.interrupt_transfer.result_code;
+				break;
+			case _USBResultType_ControlTransfer:
+				result_code = result.payload.control_transfer.result_code;
+				break;
+			case _USBResultType_BulkTransfer:
+				result_code = result.payload.bulk_transfer.result_code;
+				break;
+			}
+
+			bIsPending = false;
+		});
+	const t_benchmark_clock::time_point submitted_time = t_benchmark_clock::now();
+
+	// Spin on the main thread update like the service loop does, just without the frame delay
+	while (bSubmitted && bIsPending)
+	{
+		usb_manager.update();
+	}
+
+	const bool bSucceeded =
+		result_code == _USBResultCode_Completed ||
+		result_code == _USBResultCode_Started ||
+		result_code == _USBResultCode_Canceled;
+
+	if (bSubmitted && bSucceeded)
+	{
+		samples.submit_us.push_back(std::chrono::duration<double, std::micro>(submitted_time - submit_time).count());
+		samples.result_us.push_back(std::chrono::duration<double, std::micro>(result_time - submit_time).count());
+	}
+	else
+	{
+		++samples.failed_count;
+	}
+}
+
+static void
+on_bulk_transfer_data(unsigned char *packet_data, int packet_length, void *userdata)
+{
+	// NOTE: Runs on the USB worker thread
+	BulkStreamStats *stats = reinterpret_cast<BulkStreamStats *>(userdata);
+
+	// The simulated device stamps each transfer with a sequence number
+	unsigned int sequence = 0;
+	memcpy(&sequence, packet_data, std::min(sizeof(sequence), static_cast<size_t>(packet_length)));
+
+	if (sequence != stats->next_sequence)
+	{
+		++stats->sequence_gap_count;
+	}
+	stats->next_sequence = sequence + 1;
+
+	stats->byte_count += packet_length;
+	++stats->packet_count;
+}
+
+static void
+print_latency(const char *label, std::vector<double> &samples_us)
+{
+	if (samples_us.empty())
+	{
+		printf("  %-18s: no samples\n", label);
+		return;
+	}
+
+	std::sort(samples_us.begin(), samples_us.end());
+
+	double total_us = 0.0;
+	for (double sample_us : samples_us)
+	{
+		total_us += sample_us;
+	}
+
+	const size_t p99_index = std::min(samples_us.size() - 1, (samples_us.size() * 99) / 100);
+
+	printf("  %-18s: mean %9.1f us, median %9.1f us, p99 %9.1f us, max %9.1f us (%d samples)\n",
+		label,
+		total_us / static_cast<double>(samples_us.size()),
+		samples_us[samples_us.size() / 2],
+		samples_us[p99_index],
+		samples_us.back(),
+		static_cast<int>(samples_us.size()));
+}
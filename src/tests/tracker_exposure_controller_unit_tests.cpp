@@ -0,0 +1,182 @@
+//-- includes -----
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <chrono>
+
+#include "TrackerExposureController.h"
+#include "unit_test.h"
+
+//-- definitions -----
+typedef TrackerExposureController::t_timepoint t_timepoint;
+
+//-- prototypes -----
+static TrackerExposureSettings make_test_settings();
+static t_timepoint make_test_time(double seconds);
+static void add_test_samples(
+	TrackerExposureController &controller,
+	int count,
+	float bulb_value, float bulb_clipped_fraction, float background_value);
+
+//-- public interface -----
+bool run_tracker_exposure_controller_unit_tests()
+{
+	UNIT_TEST_MODULE_BEGIN("tracker_exposure_controller")
+		UNIT_TEST_MODULE_CALL_TEST(tracker_exposure_controller_test_darken);
+		UNIT_TEST_MODULE_CALL_TEST(tracker_exposure_controller_test_brighten);
+		UNIT_TEST_MODULE_CALL_TEST(tracker_exposure_controller_test_rate_limit);
+	UNIT_TEST_MODULE_END()
+}
+
+//-- private functions -----
+bool
+tracker_exposure_controller_test_darken()
+{
+	UNIT_TEST_BEGIN("darken")
+
+	TrackerExposureController controller;
+	controller.reset(make_test_settings());
+
+	// No measurements, no decision
+	success = !controller.update(make_test_time(0.0), 64.0, 32.0);
+	success &= controller.getDecision() == _TrackerExposureDecision_Waiting;
+	assert(success);
+
+	// Well exposed bulb on a dark background
+	add_test_samples(controller, 5, 200.f, 0.f, 20.f);
+	success = !controller.update(make_test_time(1.0), 64.0, 32.0);
+	success &= controller.getDecision() == _TrackerExposureDecision_Hold;
+	assert(success);
+
+	// A blown out bulb takes the biggest step down, all of it from the gain
+	add_test_samples(controller, 5, 255.f, 0.5f, 20.f);
+	success = controller.update(make_test_time(2.0), 64.0, 32.0);
+	success &= controller.getDecision() == _TrackerExposureDecision_Darken;
+	success &= controller.getExposure() == 64.0 && controller.getGain() == 24.0;
+	assert(success);
+
+	// Once the gain bottoms out the exposure makes up the rest
+	add_test_samples(controller, 5, 200.f, 0.f, 120.f);
+	success = controller.update(make_test_time(3.0), 64.0, 0.0);
+	success &= controller.getDecision() == _TrackerExposureDecision_Darken;
+	success &= controller.getExposure() == 48.0 && controller.getGain() == 0.0;
+	assert(success);
+
+	// Nothing left to give
+	add_test_samples(controller, 5, 255.f, 0.5f, 20.f);
+	success = !controller.update(make_test_time(4.0), 8.0, 0.0);
+	success &= controller.getDecision() == _TrackerExposureDecision_AtLimit;
+	assert(success);
+
+	success = controller.getAdjustmentCount() == 2;
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+bool
+tracker_exposure_controller_test_brighten()
+{
+	UNIT_TEST_BEGIN("brighten")
+
+	TrackerExposureController controller;
+	controller.reset(make_test_settings());
+
+	// A dim bulb raises the exposure first, by no more than the step limit
+	add_test_samples(controller, 5, 100.f, 0.f, 20.f);
+	success = controller.update(make_test_time(0.0), 64.0, 16.0);
+	success &= controller.getDecision() == _TrackerExposureDecision_Brighten;
+	success &= controller.getExposure() == 80.0 && controller.getGain() == 16.0;
+	assert(success);
+
+	// With the exposure maxed out the gain goes up instead
+	add_test_samples(controller, 5, 100.f, 0.f, 20.f);
+	success = controller.update(make_test_time(1.0), 128.0, 16.0);
+	success &= controller.getExposure() == 128.0 && controller.getGain() == 20.0;
+	assert(success);
+
+	// Never brighten the background past its limit
+	add_test_samples(controller, 5, 100.f, 0.f, 79.f);
+	success = controller.update(make_test_time(2.0), 64.0, 16.0);
+	success &= controller.getExposure() > 64.0 && controller.getExposure() <= 64.0*80.0/79.0 + 1.0;
+	assert(success);
+
+	// Settings set by hand outside of the bounds are brought back in
+	add_test_samples(controller, 5, 200.f, 0.f, 20.f);
+	success = controller.update(make_test_time(3.0), 200.0, 16.0);
+	success &= controller.getDecision() == _TrackerExposureDecision_Hold;
+	success &= controller.getExposure() == 128.0;
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+bool
+tracker_exposure_controller_test_rate_limit()
+{
+	UNIT_TEST_BEGIN("rate limit")
+
+	TrackerExposureController controller;
+	controller.reset(make_test_settings());
+
+	add_test_samples(controller, 5, 255.f, 0.5f, 20.f);
+	success = controller.update(make_test_time(0.0), 64.0, 32.0);
+	assert(success);
+
+	// Within the adjust interval the measurements only pile up
+	add_test_samples(controller, 5, 255.f, 0.5f, 20.f);
+	success = !controller.update(make_test_time(0.25), 64.0, 24.0);
+	success &= controller.getExposure() == 64.0 && controller.getGain() == 24.0;
+	assert(success);
+
+	// Too few measurements to go on
+	controller.reset(make_test_settings());
+	add_test_samples(controller, 4, 255.f, 0.5f, 20.f);
+	success = !controller.update(make_test_time(1.0), 64.0, 32.0);
+	success &= controller.getDecision() == _TrackerExposureDecision_Waiting;
+	assert(success);
+
+	UNIT_TEST_COMPLETE()
+}
+
+static TrackerExposureSettings make_test_settings()
+{
+	TrackerExposureSettings settings;
+
+	settings.min_exposure = 8.0;
+	settings.max_exposure = 128.0;
+	settings.min_gain = 0.0;
+	settings.max_gain = 64.0;
+	settings.target_bulb_value = 200.f;
+	settings.bulb_value_tolerance = 20.f;
+	settings.max_bulb_clipped_fraction = 0.25f;
+	settings.max_background_value = 80.f;
+	settings.max_step_fraction = 0.25f;
+	settings.min_setting_step = 1.0;
+	settings.adjust_interval_seconds = 0.5f;
+	settings.min_sample_count = 5;
+
+	return settings;
+}
+
+static t_timepoint make_test_time(double seconds)
+{
+	return t_timepoint(
+		std::chrono::duration_cast<t_timepoint::duration>(std::chrono::duration<double>(seconds)));
+}
+
+static void add_test_samples(
+	TrackerExposureController &controller,
+	int count,
+	float bulb_value, float bulb_clipped_fraction, float background_value)
+{
+	TrackerExposureSample sample;
+	sample.bulb_value = bulb_value;
+	sample.bulb_clipped_fraction = bulb_clipped_fraction;
+	sample.background_value = background_value;
+
+	for (int sample_index = 0; sample_index < count; ++sample_index)
+	{
+		controller.addSample(sample);
+	}
+}
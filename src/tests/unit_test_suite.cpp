@@ -10,9 +10,14 @@ int
 main(int argc, char* argv[])
 {
 	UNIT_TEST_SUITE_BEGIN()
+		UNIT_TEST_SUITE_CALL_CPP_MODULE(run_atomic_state_ring_unit_tests);
+		UNIT_TEST_SUITE_CALL_CPP_MODULE(run_device_clock_model_unit_tests);
 		UNIT_TEST_SUITE_CALL_CPP_MODULE(run_math_alignment_unit_tests);
+		UNIT_TEST_SUITE_CALL_CPP_MODULE(run_math_bundle_adjustment_unit_tests);
 		UNIT_TEST_SUITE_CALL_CPP_MODULE(run_math_eigen_unit_tests);
+		UNIT_TEST_SUITE_CALL_CPP_MODULE(run_math_planar_pose_unit_tests);
 		UNIT_TEST_SUITE_CALL_CPP_MODULE(run_math_utility_unit_tests);
+		UNIT_TEST_SUITE_CALL_CPP_MODULE(run_tracker_exposure_controller_unit_tests);
 	UNIT_TEST_SUITE_END()
 
 	return success ? EXIT_SUCCESS : EXIT_FAILURE;